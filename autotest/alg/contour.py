@@ -29,6 +29,7 @@
 ###############################################################################
 
 import array
+import math
 import os
 import sys
 
@@ -196,6 +197,198 @@ def contour_2():
 
     return 'success'
 
+###############################################################################
+# Test that contouring by strips with several threads gives the same lines
+
+def contour_3():
+
+    ds = gdal.GetDriverByName('MEM').Create('', 100, 120, 1, gdal.GDT_Float32)
+    raw_data = array.array('f')
+    for j in range(120):
+        for i in range(100):
+            raw_data.append( math.sqrt( (i - 40) * (i - 40) + (j - 65) * (j - 65) ) +
+                             5 * math.sin(i / 7.0) * math.cos(j / 5.0) )
+    ds.GetRasterBand(1).WriteRaster(0, 0, 100, 120, raw_data.tostring())
+
+    results = []
+    for num_threads in [ None, '4' ]:
+        ogr_ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+        ogr_lyr = ogr_ds.CreateLayer('contour')
+        ogr_lyr.CreateField(ogr.FieldDefn('ID', ogr.OFTInteger))
+        ogr_lyr.CreateField(ogr.FieldDefn('elev', ogr.OFTReal))
+
+        gdal.SetConfigOption('GDAL_NUM_THREADS', num_threads)
+        ret = gdal.ContourGenerate(ds.GetRasterBand(1), 5, 0, [], 0, 0, ogr_lyr, 0, 1)
+        gdal.SetConfigOption('GDAL_NUM_THREADS', None)
+        if ret != 0:
+            gdaltest.post_reason('fail')
+            return 'fail'
+
+        # Features may come in a different order, so compare sorted
+        # elevations, lengths and envelopes.
+        lines = []
+        for feat in ogr_lyr:
+            geom = feat.GetGeometryRef()
+            env = geom.GetEnvelope()
+            lines.append( ( feat.GetField('elev'), round(geom.Length(), 6),
+                            round(env[0], 6), round(env[1], 6),
+                            round(env[2], 6), round(env[3], 6) ) )
+        lines.sort()
+        results.append(lines)
+
+    if len(results[0]) == 0 or results[0] != results[1]:
+        gdaltest.post_reason('fail')
+        print(results[0])
+        print(results[1])
+        return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test that contouring with several threads does not leave slivers at the
+# seams between strips when the DEM values are on or very near the levels.
+
+def contour_4():
+
+    ds = gdal.GetDriverByName('MEM').Create('', 100, 120, 1, gdal.GDT_Float64)
+    raw_data = array.array('d')
+    for j in range(120):
+        for i in range(100):
+            val = math.sqrt( (i - 40) * (i - 40) + (j - 65) * (j - 65) ) + \
+                  5 * math.sin(i / 7.0) * math.cos(j / 5.0)
+            raw_data.append( math.floor(val * 2 + 0.5) / 2 +
+                             ((i * 7 + j * 13) % 3 - 1) * 1e-9 )
+    ds.GetRasterBand(1).WriteRaster(0, 0, 100, 120, raw_data.tostring())
+
+    results = []
+    for num_threads in [ None, '4', '6' ]:
+        ogr_ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+        ogr_lyr = ogr_ds.CreateLayer('contour')
+        ogr_lyr.CreateField(ogr.FieldDefn('ID', ogr.OFTInteger))
+        ogr_lyr.CreateField(ogr.FieldDefn('elev', ogr.OFTReal))
+
+        gdal.SetConfigOption('GDAL_NUM_THREADS', num_threads)
+        ret = gdal.ContourGenerate(ds.GetRasterBand(1), 1, 0, [], 0, 0, ogr_lyr, 0, 1)
+        gdal.SetConfigOption('GDAL_NUM_THREADS', None)
+        if ret != 0:
+            gdaltest.post_reason('fail')
+            return 'fail'
+
+        # Pieces shorter than the join distance are also output by the
+        # single threaded computation, but whether they are joined to the
+        # neighbouring lines, or left apart, depends on the processing
+        # order, so they are only checked to lie on the single threaded
+        # output.  Lines may be joined at points a bit apart.
+        lines = []
+        slivers = []
+        envelopes = []
+        for feat in ogr_lyr:
+            geom = feat.GetGeometryRef()
+            env = geom.GetEnvelope()
+            envelopes.append( ( feat.GetField('elev'), env ) )
+            if geom.Length() < 1e-4:
+                slivers.append( ( feat.GetField('elev'), env ) )
+            else:
+                lines.append( ( feat.GetField('elev'), round(geom.Length(), 3),
+                                round(env[0], 3), round(env[1], 3),
+                                round(env[2], 3), round(env[3], 3) ) )
+        lines.sort()
+        results.append( (lines, slivers, envelopes) )
+
+    if len(results[0][0]) == 0:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    def contains(env, other):
+        return other[0] >= env[0] - 1e-3 and other[1] <= env[1] + 1e-3 and \
+               other[2] >= env[2] - 1e-3 and other[3] <= env[3] + 1e-3
+
+    for (lines, slivers, envelopes) in results[1:]:
+        if lines != results[0][0]:
+            gdaltest.post_reason('fail')
+            print(results[0][0])
+            print(lines)
+            return 'fail'
+        for (elev, sliver_env) in slivers:
+            found = False
+            for (ref_elev, ref_env) in results[0][2]:
+                if ref_elev == elev and contains(ref_env, sliver_env):
+                    found = True
+                    break
+            if not found:
+                gdaltest.post_reason('fail')
+                print(elev, sliver_env)
+                return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test that the joining of the pieces of lines gives the same result as
+# before the end index was introduced.
+
+def contour_5():
+
+    ds = gdal.Open('../gdrivers/data/n43.dt0')
+    ogr_ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    ogr_lyr = ogr_ds.CreateLayer('contour')
+    ogr_lyr.CreateField(ogr.FieldDefn('ID', ogr.OFTInteger))
+    ogr_lyr.CreateField(ogr.FieldDefn('elev', ogr.OFTReal))
+
+    ret = gdal.ContourGenerate(ds.GetRasterBand(1), 10, 0, [], 0, 0, ogr_lyr, 0, 1)
+    if ret != 0:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    point_count = 0
+    for feat in ogr_lyr:
+        point_count += feat.GetGeometryRef().GetPointCount()
+    if ogr_lyr.GetFeatureCount() != 618 or point_count != 16203:
+        gdaltest.post_reason('fail')
+        print(ogr_lyr.GetFeatureCount(), point_count)
+        return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test the orientation of a line cutting the lower left corner of a cell
+# at a saddle point.
+
+def contour_6():
+
+    ds = gdal.GetDriverByName('MEM').Create('', 5, 5, 1, gdal.GDT_Float32)
+    ds.SetGeoTransform([0, 1, 0, 0, 0, 1])
+    raw_data = array.array('f', [ 8, 7, 1, 7, 2,
+                                  6, 2, 0, 2, 3,
+                                  2, 7, 4, 9, 5,
+                                  6, 2, 2, 1, 4,
+                                  2, 8, 3, 2, 4 ])
+    ds.GetRasterBand(1).WriteRaster(0, 0, 5, 5, raw_data.tostring())
+
+    ogr_ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    ogr_lyr = ogr_ds.CreateLayer('contour')
+    ogr_lyr.CreateField(ogr.FieldDefn('ID', ogr.OFTInteger))
+    ogr_lyr.CreateField(ogr.FieldDefn('elev', ogr.OFTReal))
+
+    ret = gdal.ContourGenerate(ds.GetRasterBand(1), 10, 5, [], 0, 0, ogr_lyr, 0, 1)
+    if ret != 0:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    # The line around the lower left pixel crosses the saddle cell formed
+    # by the four lower left pixels.
+    for feat in ogr_lyr:
+        geom = feat.GetGeometryRef()
+        ends = [ geom.GetPoint_2D(0), geom.GetPoint_2D(geom.GetPointCount() - 1) ]
+        if (0, 3.75) in ends:
+            if ends != [ (1, 5), (0, 3.75) ]:
+                gdaltest.post_reason('fail')
+                print(geom.ExportToWkt())
+                return 'fail'
+            return 'success'
+
+    gdaltest.post_reason('fail')
+    return 'fail'
+
 ###############################################################################
 # Cleanup
 
@@ -213,6 +406,10 @@ def contour_cleanup():
 gdaltest_list = [
     contour_1,
     contour_2,
+    contour_3,
+    contour_4,
+    contour_5,
+    contour_6,
     contour_cleanup
     ]
 
@@ -217,12 +217,58 @@ def polygonize_4():
     else:
         return 'fail'
 
+###############################################################################
+# Test that the tiled mode produces the same polygons as the default one.
+
+def polygonize_5():
+
+    src_ds = gdal.Open('data/polygonize_in.grd')
+    src_band = src_ds.GetRasterBand(1)
+
+    for connectedness in [ [], ['8CONNECTED=8'] ]:
+        ref_polys = None
+        for tiling in [ [], ['TILE_SIZE=3'], ['TILE_SIZE=5', 'NUM_THREADS=4'] ]:
+
+            mem_drv = ogr.GetDriverByName( 'Memory' )
+            mem_ds = mem_drv.CreateDataSource( 'out' )
+            mem_layer = mem_ds.CreateLayer( 'poly', None, ogr.wkbPolygon )
+            mem_layer.CreateField( ogr.FieldDefn( 'DN', ogr.OFTInteger ) )
+
+            result = gdal.Polygonize( src_band, src_band.GetMaskBand(),
+                                      mem_layer, 0, connectedness + tiling )
+            if result != 0:
+                gdaltest.post_reason( 'Polygonize failed' )
+                return 'fail'
+
+            # Features may come in a different order, and rings may start at
+            # a different vertex, so compare values, areas and perimeters.
+            polys = []
+            for feat in mem_layer:
+                geom = feat.GetGeometryRef()
+                length = 0
+                for i in range(geom.GetGeometryCount()):
+                    length += geom.GetGeometryRef(i).Length()
+                polys.append( (feat.GetField('DN'), geom.GetArea(), length) )
+            polys.sort()
+
+            if ref_polys is None:
+                ref_polys = polys
+            elif polys != ref_polys:
+                gdaltest.post_reason( 'fail' )
+                print(connectedness + tiling)
+                print(polys)
+                print(ref_polys)
+                return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     polygonize_1,
     polygonize_1_float,
     polygonize_2,
     polygonize_3,
-    polygonize_4
+    polygonize_4,
+    polygonize_5
     ]
 
 if __name__ == '__main__':
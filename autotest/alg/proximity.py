@@ -28,6 +28,8 @@
 # DEALINGS IN THE SOFTWARE.
 ###############################################################################
 
+import math
+import struct
 import sys
 
 sys.path.append( '../pymod' )
@@ -137,10 +139,116 @@ def proximity_3():
     else:
         return 'success'
 
+###############################################################################
+# Check that the exact method gives the same results on the above cases,
+# where the default method is exact.
+
+def proximity_4():
+
+    src_ds = gdal.Open('data/pat.tif')
+    src_band = src_ds.GetRasterBand(1)
+
+    tests = [ ( gdal.GDT_Byte, [], 1941 ),
+              ( gdal.GDT_Float32, [ 'VALUES=65,64',
+                                    'MAXDIST=12',
+                                    'NODATA=-1',
+                                    'FIXED_BUF_VAL=255' ], 3256 ),
+              ( gdal.GDT_Byte, [ 'VALUES=65,64',
+                                 'MAXDIST=12',
+                                 'USE_INPUT_NODATA=YES',
+                                 'NODATA=0' ], 1465 ) ]
+
+    for (dt, options, cs_expected) in tests:
+        for threads in [ [], [ 'NUM_THREADS=3' ] ]:
+            dst_ds = gdal.GetDriverByName('MEM').Create('', 25, 25, 1, dt)
+            dst_band = dst_ds.GetRasterBand(1)
+
+            ret = gdal.ComputeProximity( src_band, dst_band,
+                                         options = [ 'DISTMETHOD=EXACT' ] +
+                                                   options + threads )
+            if ret != 0:
+                gdaltest.post_reason( 'ComputeProximity failed' )
+                return 'fail'
+
+            cs = dst_band.Checksum()
+            if cs != cs_expected:
+                print(options + threads)
+                print('Got: ', cs)
+                gdaltest.post_reason( 'got wrong checksum' )
+                return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Compare the exact method against brute force, with non square pixels.
+
+def proximity_5():
+
+    xsize = 37
+    ysize = 29
+    values = []
+    for i in range(xsize * ysize):
+        r = (i * 7919) % 61
+        if r == 0:
+            values.append(1)
+        elif r == 1:
+            values.append(2)
+        else:
+            values.append(0)
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize, 1,
+                                                 gdal.GDT_Int32)
+    src_ds.SetGeoTransform([ 0, 2, 0, 0, 0, -3 ])
+    src_band = src_ds.GetRasterBand(1)
+    src_band.WriteRaster(0, 0, xsize, ysize,
+                         struct.pack('i' * (xsize * ysize), *values))
+    src_band.SetNoDataValue(2)
+
+    dst_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize, 1,
+                                                 gdal.GDT_Float32)
+    dst_band = dst_ds.GetRasterBand(1)
+    ret = gdal.ComputeProximity( src_band, dst_band,
+                                 options = [ 'DISTMETHOD=EXACT',
+                                             'DISTUNITS=GEO',
+                                             'VALUES=1',
+                                             'MAXDIST=30',
+                                             'USE_INPUT_NODATA=YES',
+                                             'NODATA=-1',
+                                             'NUM_THREADS=2' ] )
+    if ret != 0:
+        gdaltest.post_reason( 'ComputeProximity failed' )
+        return 'fail'
+
+    got = struct.unpack('f' * (xsize * ysize),
+                        dst_band.ReadRaster(0, 0, xsize, ysize))
+
+    targets = [ (i % xsize, i // xsize)
+                for i in range(xsize * ysize) if values[i] == 1 ]
+    for y in range(ysize):
+        for x in range(xsize):
+            i = y * xsize + x
+            expected = -1
+            if values[i] == 1:
+                expected = 0
+            elif values[i] == 0:
+                dist = min([ math.sqrt(((tx - x) * 2) ** 2 +
+                                       ((ty - y) * 3) ** 2)
+                             for (tx, ty) in targets ])
+                if dist <= 30:
+                    expected = dist
+            if abs(got[i] - expected) > 1e-4:
+                print(x, y, got[i], expected)
+                gdaltest.post_reason( 'fail' )
+                return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     proximity_1,
     proximity_2,
-    proximity_3
+    proximity_3,
+    proximity_4,
+    proximity_5
     ]
 
 if __name__ == '__main__':
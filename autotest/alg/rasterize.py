@@ -328,12 +328,117 @@ def rasterize_5():
 
     return 'success'
 
+###############################################################################
+# Rasterization by several chunks and with several threads.
+
+def rasterize_6():
+
+    # Setup working spatial reference
+    sr_wkt = 'LOCAL_CS["arbitrary"]'
+    sr = osr.SpatialReference( sr_wkt )
+
+    # Create a memory layer to rasterize from.
+
+    rast_ogr_ds = \
+              ogr.GetDriverByName('Memory').CreateDataSource( 'wrk' )
+    rast_mem_lyr = rast_ogr_ds.CreateLayer( 'poly', srs=sr )
+
+    for wkt_geom in [ 'POLYGON((1020 1030,1020 1045,1050 1045,1050 1030,1020 1030))',
+                      'POLYGON((1045 1050,1055 1050,1055 1020,1045 1020,1045 1050))',
+                      'LINESTRING(1000 1000, 1100 1050)',
+                      'LINESTRING(1005 1000, 1000 1050)' ]:
+        feat = ogr.Feature( rast_mem_lyr.GetLayerDefn() )
+        feat.SetGeometryDirectly( ogr.Geometry(wkt = wkt_geom) )
+        rast_mem_lyr.CreateFeature( feat )
+
+    # Same result as rasterize_5 whatever the chunking and number of threads.
+
+    for options in [ ['CHUNKYSIZE=7'], ['NUM_THREADS=3'],
+                     ['CHUNKYSIZE=7', 'NUM_THREADS=3'] ]:
+
+        target_ds = gdal.GetDriverByName('MEM').Create( '', 100, 100, 3,
+                                                        gdal.GDT_Byte )
+        target_ds.SetGeoTransform( (1000,1,0,1100,0,-1) )
+        target_ds.SetProjection( sr_wkt )
+
+        err = gdal.RasterizeLayer( target_ds, [1, 2, 3], rast_mem_lyr,
+                                   burn_values = [100,110,120],
+                                   options = ["MERGE_ALG=ADD"] + options)
+
+        if err != 0:
+            print(err)
+            gdaltest.post_reason( 'got non-zero result code from RasterizeLayer' )
+            return 'fail'
+
+        expected = 13022
+        checksum = target_ds.GetRasterBand(2).Checksum()
+        if checksum != expected:
+            print(options)
+            print(checksum)
+            gdaltest.post_reason( 'Did not get expected image checksum' )
+            return 'fail'
+
+    return 'success'
+
+###############################################################################
+# ALL_TOUCHED lines crossing chunk boundaries are burnt the same way whatever
+# the number of threads.
+
+def rasterize_7():
+
+    sr_wkt = 'LOCAL_CS["arbitrary"]'
+    sr = osr.SpatialReference( sr_wkt )
+
+    rast_ogr_ds = \
+              ogr.GetDriverByName('Memory').CreateDataSource( 'wrk' )
+    rast_mem_lyr = rast_ogr_ds.CreateLayer( 'poly', srs=sr )
+
+    for wkt_geom in [ 'POLYGON((1020 1030,1020 1045,1050 1045,1050 1030,1020 1030))',
+                      'POLYGON((1045 1050,1055 1050,1055 1020,1045 1020,1045 1050))',
+                      'LINESTRING(1000 1000, 1100 1050)',
+                      'LINESTRING(1005 1000, 1000 1050)',
+                      'LINESTRING(1000 1093, 1100 1093)' ]:
+        feat = ogr.Feature( rast_mem_lyr.GetLayerDefn() )
+        feat.SetGeometryDirectly( ogr.Geometry(wkt = wkt_geom) )
+        rast_mem_lyr.CreateFeature( feat )
+
+    for chunk_options in [ [], ['CHUNKYSIZE=7'] ]:
+
+        data = []
+        for thread_options in [ ['NUM_THREADS=1'], ['NUM_THREADS=4'] ]:
+
+            target_ds = gdal.GetDriverByName('MEM').Create( '', 100, 100, 1,
+                                                            gdal.GDT_Byte )
+            target_ds.SetGeoTransform( (1000,1,0,1100,0,-1) )
+            target_ds.SetProjection( sr_wkt )
+
+            err = gdal.RasterizeLayer( target_ds, [1], rast_mem_lyr,
+                                       burn_values = [10],
+                                       options = ["ALL_TOUCHED=TRUE",
+                                                  "MERGE_ALG=ADD"] +
+                                                 chunk_options + thread_options)
+            if err != 0:
+                print(err)
+                gdaltest.post_reason( 'got non-zero result code from RasterizeLayer' )
+                return 'fail'
+
+            data.append( target_ds.GetRasterBand(1).ReadRaster() )
+
+        if data[0] != data[1]:
+            print(chunk_options)
+            gdaltest.post_reason( 'Did not get the same image with 4 threads' )
+            return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     rasterize_1,
     rasterize_2,
     rasterize_3,
     rasterize_4,
     rasterize_5,
+    rasterize_6,
+    rasterize_7,
     ]
 
 if __name__ == '__main__':
@@ -1790,6 +1790,27 @@ def warp_54():
 
     return 'success'
 
+###############################################################################
+# Test warping several chunks concurrently with -multi and NUM_THREADS
+
+def warp_55():
+
+    src_ds = gdal.Translate('', '../gcore/data/byte.tif',
+                                options = '-of MEM -outsize 400 400')
+    ref_ds = gdal.Warp('', src_ds, options = '-of MEM -t_srs EPSG:4326 -wm 0.1 -r bilinear')
+    for num_threads in [ '2', 'ALL_CPUS' ]:
+        dst_ds = gdal.Warp('', src_ds, options = '-of MEM -t_srs EPSG:4326 -wm 0.1 -r bilinear -multi -wo NUM_THREADS=' + num_threads)
+        expected_cs = ref_ds.GetRasterBand(1).Checksum()
+        got_cs = dst_ds.GetRasterBand(1).Checksum()
+        if expected_cs != got_cs:
+            gdaltest.post_reason('fail')
+            print(num_threads)
+            print(got_cs)
+            print(expected_cs)
+            return 'fail'
+
+    return 'success'
+
 
 gdaltest_list = [
     warp_1,
@@ -1862,7 +1883,8 @@ gdaltest_list = [
     warp_51,
     warp_52,
     warp_53,
-    warp_54
+    warp_54,
+    warp_55
     ]
 #gdaltest_list = [ warp_54 ]
 
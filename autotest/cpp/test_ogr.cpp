@@ -32,7 +32,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include <tut.h>
 #include <ogrsf_frmts.h>
+#include <gdal_utils.h>
 #include <string>
+#include <vector>
 
 namespace tut
 {
@@ -485,4 +487,167 @@ namespace tut
       OGR_SM_Destroy(hSM);
     }
 
+    // Compare the features returned by GetNextFeatureBatch() with the ones
+    // of GetNextFeature()
+    static void checkFeatureBatch(OGRLayer* poLayer, int nBatchSize)
+    {
+        std::vector<OGRFeature*> apoFeatures;
+        poLayer->ResetReading();
+        OGRFeature* poFeature;
+        while( (poFeature = poLayer->GetNextFeature()) != NULL )
+            apoFeatures.push_back(poFeature);
+
+        poLayer->ResetReading();
+        OGRFeatureBatch oBatch;
+        size_t iFeature = 0;
+        int nCount;
+        while( (nCount = poLayer->GetNextFeatureBatch(&oBatch, nBatchSize)) > 0 )
+        {
+            ensure( nCount <= nBatchSize );
+            ensure_equals( oBatch.GetFeatureCount(), nCount );
+            OGRFeatureDefn* poDefn = oBatch.GetDefnRef();
+            for( int i = 0; i < nCount; i++, iFeature++ )
+            {
+                ensure( iFeature < apoFeatures.size() );
+                poFeature = apoFeatures[iFeature];
+                ensure_equals( oBatch.GetFIDs()[i], poFeature->GetFID() );
+
+                for( int iField = 0; iField < poDefn->GetFieldCount(); iField++ )
+                {
+                    const bool bSet = poFeature->IsFieldSet(iField) != FALSE;
+                    ensure_equals( oBatch.IsFieldSet(i, iField), bSet );
+                    if( !bSet )
+                        continue;
+                    const void* pValues = oBatch.GetFieldValues(iField);
+                    const size_t* panOffsets = oBatch.GetFieldOffsets(iField);
+                    switch( poDefn->GetFieldDefn(iField)->GetType() )
+                    {
+                        case OFTInteger:
+                            ensure_equals( static_cast<const int*>(pValues)[i],
+                                           poFeature->GetFieldAsInteger(iField) );
+                            break;
+                        case OFTInteger64:
+                            ensure_equals( static_cast<const GIntBig*>(pValues)[i],
+                                           poFeature->GetFieldAsInteger64(iField) );
+                            break;
+                        case OFTReal:
+                            ensure_equals( static_cast<const double*>(pValues)[i],
+                                           poFeature->GetFieldAsDouble(iField) );
+                            break;
+                        case OFTString:
+                            ensure_equals( std::string(
+                                static_cast<const char*>(pValues) + panOffsets[i],
+                                panOffsets[i+1] - panOffsets[i]),
+                                std::string(poFeature->GetFieldAsString(iField)) );
+                            break;
+                        case OFTDate:
+                        case OFTDateTime:
+                        {
+                            const OGRField* psField =
+                                static_cast<const OGRField*>(pValues) + i;
+                            const OGRField* psRefField =
+                                poFeature->GetRawFieldRef(iField);
+                            ensure_equals( psField->Date.Year, psRefField->Date.Year );
+                            ensure_equals( psField->Date.Month, psRefField->Date.Month );
+                            ensure_equals( psField->Date.Day, psRefField->Date.Day );
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                }
+
+                for( int iGeom = 0; iGeom < poDefn->GetGeomFieldCount(); iGeom++ )
+                {
+                    OGRGeometry* poGeom = poFeature->GetGeomFieldRef(iGeom);
+                    const GByte* pabyValidity = oBatch.GetGeomFieldValidity(iGeom);
+                    ensure_equals( (pabyValidity[i >> 3] & (1 << (i & 7))) != 0,
+                                   poGeom != NULL );
+                    if( poGeom == NULL )
+                        continue;
+                    const size_t* panOffsets = oBatch.GetGeomFieldOffsets(iGeom);
+                    std::vector<GByte> abyWkb(poGeom->WkbSize());
+                    poGeom->exportToWkb(wkbNDR, &abyWkb[0], wkbVariantIso);
+                    ensure_equals( panOffsets[i+1] - panOffsets[i], abyWkb.size() );
+                    ensure( memcmp(oBatch.GetGeomFieldWkb(iGeom) + panOffsets[i],
+                                   &abyWkb[0], abyWkb.size()) == 0 );
+                }
+            }
+        }
+        ensure_equals( iFeature, apoFeatures.size() );
+
+        for( size_t i = 0; i < apoFeatures.size(); i++ )
+            delete apoFeatures[i];
+    }
+
+    // Test OGRLayer::GetNextFeatureBatch()
+    template<>
+    template<>
+    void object::test<8>()
+    {
+        GDALDataset* poDS = static_cast<GDALDataset*>(
+            GDALOpenEx("data/poly.shp", GDAL_OF_VECTOR, NULL, NULL, NULL));
+        ensure( poDS != NULL );
+        OGRLayer* poLayer = poDS->GetLayer(0);
+        checkFeatureBatch(poLayer, 7);
+        checkFeatureBatch(poLayer, 1000);
+
+        // Generic implementation when a filter is set
+        poLayer->SetAttributeFilter("EAS_ID < 170");
+        checkFeatureBatch(poLayer, 7);
+        poLayer->SetAttributeFilter(NULL);
+
+        GDALDriver* poGPKGDriver = GetGDALDriverManager()->GetDriverByName("GPKG");
+        if( poGPKGDriver != NULL )
+        {
+            GDALDatasetH hSrcDS = static_cast<GDALDatasetH>(poDS);
+            char** papszArgv = NULL;
+            papszArgv = CSLAddString(papszArgv, "-f");
+            papszArgv = CSLAddString(papszArgv, "GPKG");
+            GDALVectorTranslateOptions* psOptions =
+                GDALVectorTranslateOptionsNew(papszArgv, NULL);
+            CSLDestroy(papszArgv);
+            GDALDatasetH hGPKGDS = GDALVectorTranslate(
+                "/vsimem/test_ogr_feature_batch.gpkg", NULL, 1, &hSrcDS,
+                psOptions, NULL);
+            GDALVectorTranslateOptionsFree(psOptions);
+            ensure( hGPKGDS != NULL );
+            checkFeatureBatch(static_cast<GDALDataset*>(hGPKGDS)->GetLayer(0), 7);
+            GDALClose(hGPKGDS);
+            poGPKGDriver->Delete("/vsimem/test_ogr_feature_batch.gpkg");
+        }
+        GDALClose(poDS);
+
+        // Shapefile geometries written directly from the shapes
+        const char* const apszShapefiles[] = {
+            "../ogr/data/testpointzm.shp",
+            "../ogr/data/pointz_without_m.shp",
+            "../ogr/data/multipointz_without_m.shp",
+            "../ogr/data/gjmultiline.shp",
+            "../ogr/data/arcm_with_m.shp",
+            "../ogr/data/polygonm_with_m.shp",
+            "../ogr/data/buggymultipoly.shp",
+            "../ogr/data/multipatch.shp" };
+        for( size_t i = 0;
+             i < sizeof(apszShapefiles) / sizeof(apszShapefiles[0]); i++ )
+        {
+            poDS = static_cast<GDALDataset*>(GDALOpenEx(
+                apszShapefiles[i], GDAL_OF_VECTOR, NULL, NULL, NULL));
+            ensure( poDS != NULL );
+            checkFeatureBatch(poDS->GetLayer(0), 7);
+            GDALClose(poDS);
+        }
+
+        if( GetGDALDriverManager()->GetDriverByName("OpenFileGDB") != NULL )
+        {
+            poDS = static_cast<GDALDataset*>(GDALOpenEx(
+                "/vsizip/../ogr/data/testopenfilegdb.gdb.zip/testopenfilegdb.gdb",
+                GDAL_OF_VECTOR, NULL, NULL, NULL));
+            ensure( poDS != NULL );
+            for( int i = 0; i < poDS->GetLayerCount(); i++ )
+                checkFeatureBatch(poDS->GetLayer(i), 7);
+            GDALClose(poDS);
+        }
+    }
+
 } // namespace tut
@@ -417,6 +417,59 @@ namespace tut
         OGR_G_DestroyGeometry(expect);
     }
 
+    // Test OGR_G_SetGEOSCacheEnabled function
+    template<>
+    template<>
+    void object::test<15>()
+    {
+        char* wkt1 = "POLYGON((0 0, 10 0, 10 10, 0 10, 0 0))";
+        err_ = OGR_G_CreateFromWkt(&wkt1, NULL, &g1_);
+        ensure_equals("Can't import geometry from WKT", OGRERR_NONE, err_);
+        ensure("Can't create geometry", NULL != g1_);
+
+        char* wkt2 = "POINT(5 5)";
+        err_ = OGR_G_CreateFromWkt(&wkt2, NULL, &g2_);
+        ensure_equals("Can't import geometry from WKT", OGRERR_NONE, err_);
+        ensure("Can't create geometry", NULL != g2_);
+
+        OGR_G_SetGEOSCacheEnabled(g1_, TRUE, TRUE);
+        for( int i = 0; i < 2; i++ )
+        {
+            ensure_equals("OGR_G_Contains() failed with FALSE",
+                OGR_G_Contains(g1_, g2_), TRUE);
+            ensure_equals("OGR_G_Within() failed with FALSE",
+                OGR_G_Within(g2_, g1_), TRUE);
+            ensure_equals("OGR_G_Intersects() failed with FALSE",
+                OGR_G_Intersects(g2_, g1_), TRUE);
+            ensure_equals("OGR_G_Disjoint() failed with TRUE",
+                OGR_G_Disjoint(g1_, g2_), FALSE);
+            ensure_equals("OGR_G_IsValid() failed with FALSE",
+                OGR_G_IsValid(g1_), TRUE);
+        }
+
+        // Modify the polygon through its exterior ring: the cached GEOS
+        // geometry must not be used anymore.
+        OGRGeometryH hRing = OGR_G_GetGeometryRef(g1_, 0);
+        ensure("Can't get exterior ring", NULL != hRing);
+        OGR_G_SetPoint_2D(hRing, 2, 4, 4);
+
+        ensure_equals("OGR_G_Contains() failed with TRUE",
+            OGR_G_Contains(g1_, g2_), FALSE);
+        ensure_equals("OGR_G_Within() failed with TRUE",
+            OGR_G_Within(g2_, g1_), FALSE);
+        ensure_equals("OGR_G_Disjoint() failed with FALSE",
+            OGR_G_Disjoint(g1_, g2_), TRUE);
+
+        g3_ = OGR_G_Intersection(g1_, g1_);
+        ensure("OGR_G_Intersection failed with NULL", NULL != g3_);
+        ensure_distance("OGR_G_Area() of intersection",
+            OGR_G_Area(g3_), OGR_G_Area(g1_), 1e-10);
+
+        OGR_G_SetGEOSCacheEnabled(g1_, FALSE, FALSE);
+        ensure_equals("OGR_G_Contains() failed with TRUE",
+            OGR_G_Contains(g1_, g2_), FALSE);
+    }
+
 #else // HAVE_GEOS
 
     // Test GEOS support is disabled and shout about it
@@ -925,6 +925,57 @@ def pixfun_dB2pow():
     return 'success'
 
 
+###############################################################################
+# Verify the typed pixel functions with non packed and integer buffers.
+
+def pixfun_sum_r_buf_types():
+
+    if not numpy_available:
+        return 'skip'
+
+    filename = 'data/pixfun_sum_r.vrt'
+    ds = gdal.Open(filename)
+    if ds is None:
+        gdaltest.post_reason('Unable to open "%s" dataset.' % filename)
+        return 'fail'
+
+    refdata = numpy.zeros((20, 20), 'float')
+    for reffilename in ('data/uint16.tif', 'data/int32.tif',
+                        'data/float32.tif'):
+        refds = gdal.Open(reffilename)
+        refdata += refds.GetRasterBand(1).ReadAsArray()
+
+    # Float64 buffer, written directly by the typed function.
+    data = ds.GetRasterBand(1).ReadAsArray(buf_type=gdal.GDT_Float64)
+    if not numpy.alltrue(data == refdata):
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    # Non packed Float64 buffer.
+    buf = ds.GetRasterBand(1).ReadRaster(0, 0, 20, 20,
+                                         buf_type=gdal.GDT_Float64,
+                                         buf_pixel_space=16)
+    data = numpy.frombuffer(buf, dtype='float64',
+                            count=20 * 20 * 2 - 1)[::2].reshape(20, 20)
+    if not numpy.alltrue(data == refdata):
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    # Integer buffer: sources are read as Int32 too, since there is no
+    # SourceTransferType.
+    data = ds.GetRasterBand(1).ReadAsArray(buf_type=gdal.GDT_Int32)
+    expected = numpy.zeros((20, 20), 'int32')
+    for reffilename in ('data/uint16.tif', 'data/int32.tif',
+                        'data/float32.tif'):
+        refds = gdal.Open(reffilename)
+        expected += refds.GetRasterBand(1).ReadAsArray(buf_type=gdal.GDT_Int32)
+    if not numpy.alltrue(data == expected):
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    return 'success'
+
+
 ###############################################################################
 
 gdaltest_list = [
@@ -958,6 +1009,7 @@ gdaltest_list = [
     pixfun_dB_c,
     pixfun_dB2amp,
     pixfun_dB2pow,
+    pixfun_sum_r_buf_types,
 ]
 
 
@@ -2186,6 +2186,47 @@ def tiff_ovr_54():
 
     return 'success'
 
+###############################################################################
+# Test that multi-threaded overview computation gives the same result as
+# single-threaded computation
+
+def tiff_ovr_55():
+
+    src_ds = gdal.Open('../gdrivers/data/small_world.tif')
+
+    for (interleave, compress) in [ ('BAND', None), ('PIXEL', 'DEFLATE') ]:
+        for resampling in [ 'NEAR', 'AVERAGE', 'GAUSS', 'CUBIC', 'MODE' ]:
+            if resampling == 'MODE' and interleave == 'PIXEL':
+                continue
+            cs_ref = None
+            for num_threads in [ None, '4' ]:
+                gdal.GetDriverByName('GTiff').CreateCopy(
+                    '/vsimem/tiff_ovr_55.tif', src_ds)
+                gdal.SetConfigOption('GDAL_NUM_THREADS', num_threads)
+                gdal.SetConfigOption('INTERLEAVE_OVERVIEW', interleave)
+                gdal.SetConfigOption('COMPRESS_OVERVIEW', compress)
+                ds = gdal.Open('/vsimem/tiff_ovr_55.tif')
+                ds.BuildOverviews(resampling, [2, 4, 8])
+                ds = None
+                gdal.SetConfigOption('GDAL_NUM_THREADS', None)
+                gdal.SetConfigOption('INTERLEAVE_OVERVIEW', None)
+                gdal.SetConfigOption('COMPRESS_OVERVIEW', None)
+
+                ds = gdal.Open('/vsimem/tiff_ovr_55.tif')
+                cs = [ ds.GetRasterBand(i+1).GetOverview(j).Checksum()
+                       for i in range(3) for j in range(3) ]
+                ds = None
+                gdal.GetDriverByName('GTiff').Delete('/vsimem/tiff_ovr_55.tif')
+
+                if cs_ref is None:
+                    cs_ref = cs
+                elif cs != cs_ref:
+                    gdaltest.post_reason('fail')
+                    print(interleave, resampling, cs, cs_ref)
+                    return 'fail'
+
+    return 'success'
+
 ###############################################################################
 # Cleanup
 
@@ -2304,7 +2345,8 @@ gdaltest_list.append(tiff_ovr_restore_endianness)
 gdaltest_list += [ tiff_ovr_51,
                    tiff_ovr_52,
                    tiff_ovr_53,
-                   tiff_ovr_54 ]
+                   tiff_ovr_54,
+                   tiff_ovr_55 ]
 
 if __name__ == '__main__':
 
@@ -2848,6 +2848,51 @@ def tiff_read_arcgis93_geodataxform_gcp():
         return 'fail'
     return 'success'
 
+###############################################################################
+# Test multi-threaded decoding of compressed strips and tiles (NUM_THREADS
+# open option and GDAL_NUM_THREADS configuration option)
+
+def tiff_read_multithreaded_decoding():
+
+    src_ds = gdal.Open('data/rgbsmall.tif')
+    for options in [ ['TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16', 'COMPRESS=DEFLATE'],
+                     ['TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16', 'COMPRESS=LZW', 'PREDICTOR=2', 'INTERLEAVE=BAND'],
+                     ['BLOCKYSIZE=7', 'COMPRESS=DEFLATE'],
+                     ['BLOCKYSIZE=7', 'COMPRESS=PACKBITS', 'INTERLEAVE=BAND'] ]:
+        gdal.GetDriverByName('GTiff').CreateCopy('/vsimem/tiff_read_multithreaded_decoding.tif', src_ds, options = options)
+
+        ds = gdal.Open('/vsimem/tiff_read_multithreaded_decoding.tif')
+        ref_data = ds.ReadRaster(0, 0, ds.RasterXSize, ds.RasterYSize)
+        ref_sub_data = ds.GetRasterBand(2).ReadRaster(5, 3, 31, 29)
+        ds = None
+
+        ds = gdal.OpenEx('/vsimem/tiff_read_multithreaded_decoding.tif', open_options = ['NUM_THREADS=4'])
+        sub_data = ds.GetRasterBand(2).ReadRaster(5, 3, 31, 29)
+        data = ds.ReadRaster(0, 0, ds.RasterXSize, ds.RasterYSize)
+        ds = None
+        if data != ref_data or sub_data != ref_sub_data:
+            gdaltest.post_reason('fail')
+            print(options)
+            return 'fail'
+
+        # Force the request to be split in chunks
+        old_cache_max = gdal.GetCacheMax()
+        gdal.SetCacheMax(10000)
+        gdal.SetConfigOption('GDAL_NUM_THREADS', '4')
+        ds = gdal.Open('/vsimem/tiff_read_multithreaded_decoding.tif')
+        data = ds.ReadRaster(0, 0, ds.RasterXSize, ds.RasterYSize)
+        ds = None
+        gdal.SetConfigOption('GDAL_NUM_THREADS', None)
+        gdal.SetCacheMax(old_cache_max)
+        if data != ref_data:
+            gdaltest.post_reason('fail')
+            print(options)
+            return 'fail'
+
+    gdal.Unlink('/vsimem/tiff_read_multithreaded_decoding.tif')
+
+    return 'success'
+
 ###############################################################################
 
 for item in init_list:
@@ -2941,6 +2986,7 @@ gdaltest_list.append( (tiff_read_ycbcr_lzw) )
 
 gdaltest_list.append( (tiff_read_unit_from_srs) )
 gdaltest_list.append( (tiff_read_arcgis93_geodataxform_gcp) )
+gdaltest_list.append( (tiff_read_multithreaded_decoding) )
 
 # gdaltest_list = [ tiff_read_ycbcr_lzw ]
 
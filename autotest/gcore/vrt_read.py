@@ -1191,6 +1191,131 @@ def vrt_read_26():
     return 'success'
 
 
+###############################################################################
+# Test a mosaic with enough sources for the spatial index of the sources to
+# be used
+
+def vrt_read_27():
+
+    src_ds = gdal.Open('data/byte.tif')
+    sources = ''
+    # 100 tiles of 2x2 pixels, added in reverse order, and a last source
+    # overlapping with the others that must be composited over them.
+    for j in range(9, -1, -1):
+        for i in range(9, -1, -1):
+            sources += """<SimpleSource>
+      <SourceFilename relativeToVRT="0">data/byte.tif</SourceFilename>
+      <SourceBand>1</SourceBand>
+      <SrcRect xOff="%d" yOff="%d" xSize="2" ySize="2" />
+      <DstRect xOff="%d" yOff="%d" xSize="2" ySize="2" />
+    </SimpleSource>""" % (i * 2, j * 2, i * 2, j * 2)
+    sources += """<SimpleSource>
+      <SourceFilename relativeToVRT="0">data/byte.tif</SourceFilename>
+      <SourceBand>1</SourceBand>
+      <SrcRect xOff="0" yOff="0" xSize="4" ySize="4" />
+      <DstRect xOff="5" yOff="5" xSize="4" ySize="4" />
+    </SimpleSource>"""
+    vrt_ds = gdal.Open("""<VRTDataset rasterXSize="20" rasterYSize="20">
+  <VRTRasterBand dataType="Byte" band="1">%s
+  </VRTRasterBand>
+</VRTDataset>""" % sources)
+
+    ref_ds = gdal.GetDriverByName('MEM').CreateCopy('', src_ds)
+    ref_ds.GetRasterBand(1).WriteRaster(5, 5, 4, 4,
+        src_ds.GetRasterBand(1).ReadRaster(0, 0, 4, 4))
+
+    for (xoff, yoff, xsize, ysize) in [ (0, 0, 20, 20), (3, 3, 1, 1),
+                                        (4, 5, 7, 3), (18, 0, 2, 20) ]:
+        got = vrt_ds.GetRasterBand(1).ReadRaster(xoff, yoff, xsize, ysize)
+        expected = ref_ds.GetRasterBand(1).ReadRaster(xoff, yoff, xsize, ysize)
+        if got != expected:
+            gdaltest.post_reason('fail')
+            print(xoff, yoff, xsize, ysize)
+            return 'fail'
+
+    got = vrt_ds.ReadRaster(2, 3, 10, 11)
+    expected = ref_ds.ReadRaster(2, 3, 10, 11)
+    if got != expected:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    import ogrtest
+    if ogrtest.have_geos():
+        (flags, pct) = vrt_ds.GetRasterBand(1).GetDataCoverageStatus(3, 3, 10, 10)
+        if flags != gdal.GDAL_DATA_COVERAGE_STATUS_DATA or pct != 100.0:
+            gdaltest.post_reason('failure')
+            print(flags)
+            print(pct)
+            return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test reading sources with a thread pool (NUM_THREADS / VRT_NUM_THREADS)
+
+def vrt_read_28():
+
+    src_ds = gdal.Open('data/byte.tif')
+    sources = ''
+    # 4 different files, each one referenced by 2 non overlapping sources,
+    # and a last source overlapping the others.
+    for i in range(4):
+        filename = '/vsimem/vrt_read_28_%d.tif' % i
+        gdal.Translate(filename, src_ds,
+                       srcWin = [i * 5, 0, 5, 20])
+        for j in range(2):
+            sources += """<SimpleSource>
+      <SourceFilename relativeToVRT="0">%s</SourceFilename>
+      <SourceBand>1</SourceBand>
+      <SrcRect xOff="0" yOff="%d" xSize="5" ySize="10" />
+      <DstRect xOff="%d" yOff="%d" xSize="5" ySize="10" />
+    </SimpleSource>""" % (filename, j * 10, i * 5, j * 10)
+    sources += """<SimpleSource>
+      <SourceFilename relativeToVRT="0">/vsimem/vrt_read_28_0.tif</SourceFilename>
+      <SourceBand>1</SourceBand>
+      <SrcRect xOff="0" yOff="0" xSize="5" ySize="5" />
+      <DstRect xOff="8" yOff="8" xSize="5" ySize="5" />
+    </SimpleSource>"""
+    vrt_xml = """<VRTDataset rasterXSize="20" rasterYSize="20">
+  <VRTRasterBand dataType="Byte" band="1">%s
+  </VRTRasterBand>
+</VRTDataset>""" % sources
+
+    ref_ds = gdal.Open(vrt_xml)
+    expected = ref_ds.GetRasterBand(1).ReadRaster(0, 0, 20, 20)
+    expected_subsampled = ref_ds.GetRasterBand(1).ReadRaster(0, 0, 20, 20, 7, 7)
+    expected_ds = ref_ds.ReadRaster(3, 2, 15, 16)
+    ref_ds = None
+
+    ret = 'success'
+    for (open_options, config_value) in [ (['NUM_THREADS=4'], None),
+                                          ([], 'ALL_CPUS') ]:
+        gdal.SetConfigOption('VRT_NUM_THREADS', config_value)
+        vrt_ds = gdal.OpenEx(vrt_xml, open_options = open_options)
+        got = vrt_ds.GetRasterBand(1).ReadRaster(0, 0, 20, 20)
+        got_subsampled = vrt_ds.GetRasterBand(1).ReadRaster(0, 0, 20, 20, 7, 7)
+        got_ds = vrt_ds.ReadRaster(3, 2, 15, 16)
+        vrt_ds = None
+        gdal.SetConfigOption('VRT_NUM_THREADS', None)
+        if got != expected or got_subsampled != expected_subsampled or \
+           got_ds != expected_ds:
+            gdaltest.post_reason('fail')
+            print(open_options, config_value)
+            ret = 'fail'
+            break
+
+    # Make sure the overlapping source was taken into account
+    if ret == 'success' and \
+       expected == src_ds.GetRasterBand(1).ReadRaster(0, 0, 20, 20):
+        gdaltest.post_reason('fail')
+        ret = 'fail'
+
+    for i in range(4):
+        gdal.Unlink('/vsimem/vrt_read_28_%d.tif' % i)
+
+    return ret
+
+
 for item in init_list:
     ut = gdaltest.GDALTest( 'VRT', item[0], item[1], item[2] )
     if ut is None:
@@ -1224,6 +1349,8 @@ gdaltest_list.append( vrt_read_23 )
 gdaltest_list.append( vrt_read_24 )
 gdaltest_list.append( vrt_read_25 )
 gdaltest_list.append( vrt_read_26 )
+gdaltest_list.append( vrt_read_27 )
+gdaltest_list.append( vrt_read_28 )
 
 if __name__ == '__main__':
 
@@ -345,6 +345,50 @@ def vsicurl_test_redirect():
 
     return 'success'
 
+###############################################################################
+# Test reads with a region cache much smaller than the data read, so that
+# regions are evicted while reading
+
+def vsicurl_test_small_cache():
+
+    if gdaltest.webserver_port == 0:
+        return 'skip'
+
+    content = webserver.get_vsicurl_ranges_content()
+    url = '/vsicurl/http://localhost:%d/vsicurl_ranges/test.bin' % gdaltest.webserver_port
+
+    # Rounded up to 4 regions
+    gdal.SetConfigOption('CPL_VSIL_CURL_CACHE_SIZE', '0')
+    f1 = gdal.VSIFOpenL(url, 'rb')
+    f2 = gdal.VSIFOpenL(url, 'rb')
+    if f1 is None or f2 is None:
+        gdal.SetConfigOption('CPL_VSIL_CURL_CACHE_SIZE', None)
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    ret = 'success'
+    # Sequential reads, a read larger than the cache, random reads, reads
+    # crossing region boundaries and a read past the end of the file.
+    # The two handles are interleaved.
+    for (f, offset, size) in [ (f1, 0, 1000), (f1, 1000, 20000),
+                               (f2, 5000, 150000), (f1, 21000, 40000),
+                               (f2, 250000, 100), (f1, 16380, 10),
+                               (f2, 16380, 10), (f1, 100, 100),
+                               (f2, 290000, 20000), (f1, 0, 300000) ]:
+        gdal.VSIFSeekL(f, offset, 0)
+        data = gdal.VSIFReadL(1, size, f)
+        if data != content[offset:offset+size]:
+            gdaltest.post_reason('fail')
+            print(offset, size, len(data))
+            ret = 'fail'
+            break
+
+    gdal.VSIFCloseL(f1)
+    gdal.VSIFCloseL(f2)
+    gdal.SetConfigOption('CPL_VSIL_CURL_CACHE_SIZE', None)
+
+    return ret
+
 ###############################################################################
 def vsicurl_stop_webserver():
 
@@ -368,6 +412,7 @@ gdaltest_list = [ vsicurl_1,
                   vsicurl_11,
                   vsicurl_start_webserver,
                   vsicurl_test_redirect,
+                  vsicurl_test_small_cache,
                   vsicurl_stop_webserver ]
 
 if __name__ == '__main__':
@@ -538,26 +538,37 @@ def vsis3_6():
             gdaltest.post_reason('fail')
             return 'fail'
 
-    for filename in [ '/vsis3/s3_fake_bucket4/large_file_upload_part_403_error.bin',
-                      '/vsis3/s3_fake_bucket4/large_file_upload_part_no_etag.bin']:
-        gdal.SetConfigOption('VSIS3_CHUNK_SIZE', '1') # 1 MB
-        f = gdal.VSIFOpenL(filename, 'wb')
-        gdal.SetConfigOption('VSIS3_CHUNK_SIZE', None)
-        if f is None:
-            gdaltest.post_reason('fail')
-            return 'fail'
-        size = 1024*1024+1
-        with gdaltest.error_handler():
-            ret = gdal.VSIFWriteL(''.join('a' for i in range(size)), 1,size, f)
-        if ret != 0:
-            gdaltest.post_reason('fail')
-            print(ret)
-            return 'fail'
-        gdal.ErrorReset()
-        gdal.VSIFCloseL(f)
-        if gdal.GetLastErrorMsg() != '':
-            gdaltest.post_reason('fail')
-            return 'fail'
+    # With sequential uploads, the error of a part is reported by the
+    # VSIFWriteL() that uploads it. With concurrent ones, by VSIFCloseL()
+    for concurrent_uploads in [ '1', None ]:
+        for filename in [ '/vsis3/s3_fake_bucket4/large_file_upload_part_403_error.bin',
+                          '/vsis3/s3_fake_bucket4/large_file_upload_part_no_etag.bin']:
+            gdal.SetConfigOption('VSIS3_CHUNK_SIZE', '1') # 1 MB
+            gdal.SetConfigOption('VSIS3_MAX_CONCURRENT_UPLOADS', concurrent_uploads)
+            f = gdal.VSIFOpenL(filename, 'wb')
+            gdal.SetConfigOption('VSIS3_CHUNK_SIZE', None)
+            gdal.SetConfigOption('VSIS3_MAX_CONCURRENT_UPLOADS', None)
+            if f is None:
+                gdaltest.post_reason('fail')
+                return 'fail'
+            size = 1024*1024+1
+            with gdaltest.error_handler():
+                ret = gdal.VSIFWriteL(''.join('a' for i in range(size)), 1,size, f)
+            if ret != (0 if concurrent_uploads == '1' else size):
+                gdaltest.post_reason('fail')
+                print(ret)
+                return 'fail'
+            gdal.ErrorReset()
+            with gdaltest.error_handler():
+                ret = gdal.VSIFCloseL(f)
+            if concurrent_uploads == '1':
+                if gdal.GetLastErrorMsg() != '':
+                    gdaltest.post_reason('fail')
+                    return 'fail'
+            elif ret == 0 or gdal.GetLastErrorMsg() == '':
+                gdaltest.post_reason('fail')
+                print(ret)
+                return 'fail'
 
     return 'success'
 
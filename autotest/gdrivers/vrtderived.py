@@ -32,6 +32,7 @@
 import os
 import shutil
 import sys
+import struct
 import threading
 from osgeo import gdal
 
@@ -947,6 +948,132 @@ def vrtderived_15():
     return ret
 
 
+###############################################################################
+# Test expressions (PixelFunctionLanguage=Expression)
+
+def vrtderived_16():
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 4, 1, 2, gdal.GDT_Float32)
+    src_ds.GetRasterBand(1).WriteRaster(0, 0, 4, 1,
+                                        struct.pack('f' * 4, 10, 20, 0, 5))
+    src_ds.GetRasterBand(2).WriteRaster(0, 0, 4, 1,
+                                        struct.pack('f' * 4, 30, 20, 0, -1))
+    gdal.GetDriverByName('GTiff').CreateCopy('/vsimem/vrtderived_16.tif',
+                                             src_ds)
+    src_ds = None
+
+    template = """<VRTDataset rasterXSize="4" rasterYSize="1">
+  <VRTRasterBand dataType="Float64" band="1" subClass="VRTDerivedRasterBand">
+    %s
+    <PixelFunctionLanguage>Expression</PixelFunctionLanguage>
+    <PixelFunctionCode><![CDATA[%s]]></PixelFunctionCode>
+    %s
+    <SimpleSource>
+      <SourceFilename>/vsimem/vrtderived_16.tif</SourceFilename>
+      <SourceBand>1</SourceBand>
+    </SimpleSource>
+    <SimpleSource>
+      <SourceFilename>/vsimem/vrtderived_16.tif</SourceFilename>
+      <SourceBand>2</SourceBand>
+    </SimpleSource>
+  </VRTRasterBand>
+</VRTDataset>"""
+
+    tests = [ ('(B2 - B1) / (B2 + B1)', '', '', [0.5, 0, float('nan'), -6.0 / 4]),
+              ('B1 > B2 ? B1 : -B2 + 1', '', '', [-29, -19, 1, 5]),
+              ('if(B1 >= 10 && !(B2 == 20), 1, 2) * 2 ^ 2', '', '',
+               [4, 8, 8, 8]),
+              ('min(B1, B2, 7) + max(B1, 3) % 4', '', '', [9, 7, 3, 0]),
+              ('abs(B2) + sqrt(4) + floor(1.5) + ceil(1.5) + round(-2.5)',
+               '', '', [32, 22, 2, 3]),
+              ('isnodata(B1) ? 100 : B1', '<NoDataValue>0</NoDataValue>', '',
+               [10, 20, 100, 5]),
+              ('B1 + B2', '<NoDataValue>0</NoDataValue>',
+               '<PixelFunctionArguments propagateNoData="true"/>',
+               [40, 40, 0, 4]) ]
+    for (expr, nodata, args, expected) in tests:
+        ds = gdal.Open(template % (nodata, expr, args))
+        if ds is None:
+            gdaltest.post_reason('fail')
+            print(expr)
+            return 'fail'
+        got = struct.unpack('d' * 4, ds.GetRasterBand(1).ReadRaster())
+        for i in range(4):
+            if expected[i] != expected[i]:
+                ok = got[i] != got[i]
+            else:
+                ok = abs(got[i] - expected[i]) < 1e-10
+            if not ok:
+                gdaltest.post_reason('fail')
+                print(expr, got, expected)
+                return 'fail'
+
+    # Integer buffer type, non packed
+    ds = gdal.Open(template % ('', 'B1 * 2.6', ''))
+    got = struct.unpack('h' * 7, ds.GetRasterBand(1).ReadRaster(
+        buf_type=gdal.GDT_Int16, buf_pixel_space=4))[::2]
+    if got != (26, 52, 0, 13):
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    # Serialization round trip
+    ds = gdal.GetDriverByName('VRT').CreateCopy('', ds)
+    if ds.GetRasterBand(1).Checksum() != \
+       gdal.Open(template % ('', 'B1 * 2.6', '')).GetRasterBand(1).Checksum():
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    # Invalid expressions and references
+    for expr in [ 'B1 +', '(B1', 'foo(B1)', 'B0', 'min(B1)', 'B1 ? 2',
+                  'B1 B2' ]:
+        gdal.ErrorReset()
+        with gdaltest.error_handler():
+            ds = gdal.Open(template % ('', expr, ''))
+            if ds is not None:
+                ds.GetRasterBand(1).Checksum()
+        if ds is not None and gdal.GetLastErrorMsg() == '':
+            gdaltest.post_reason('fail')
+            print(expr)
+            return 'fail'
+
+    # Reference to a missing source is rejected at open time
+    gdal.ErrorReset()
+    with gdaltest.error_handler():
+        ds = gdal.Open(template % ('', 'B1 + B3', ''))
+    if ds is not None or gdal.GetLastErrorMsg().find('references B3') < 0:
+        gdaltest.post_reason('fail')
+        print(gdal.GetLastErrorMsg())
+        return 'fail'
+
+    # Deep nesting is rejected rather than overflowing the stack
+    ds = gdal.Open(template % ('', '(' * 50 + '-B1' + ')' * 50, ''))
+    if ds is None or ds.GetRasterBand(1).Checksum() != \
+       gdal.Open(template % ('', '-B1', '')).GetRasterBand(1).Checksum():
+        gdaltest.post_reason('fail')
+        return 'fail'
+    for expr in [ '(' * 100000 + 'B1' + ')' * 100000, '-' * 100000 + 'B1',
+                  'B1' + '^B1' * 100000, 'B1?B1:' * 100000 + 'B1' ]:
+        gdal.ErrorReset()
+        with gdaltest.error_handler():
+            ds = gdal.Open(template % ('', expr, ''))
+        if ds is not None or gdal.GetLastErrorMsg().find('nested too deeply') < 0:
+            gdaltest.post_reason('fail')
+            print(expr[0:20])
+            return 'fail'
+
+    # Missing PixelFunctionCode
+    with gdaltest.error_handler():
+        ds = gdal.Open(template % ('', '', '').replace(
+            '<PixelFunctionCode><![CDATA[]]></PixelFunctionCode>', ''))
+    if ds is not None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    gdal.Unlink('/vsimem/vrtderived_16.tif')
+
+    return 'success'
+
 ###############################################################################
 # Cleanup.
 
@@ -973,6 +1100,7 @@ gdaltest_list = [
     vrtderived_13,
     vrtderived_14,
     vrtderived_15,
+    vrtderived_16,
     vrtderived_cleanup,
 ]
 
@@ -3382,6 +3382,151 @@ def ogr_geojson_59():
 
     return 'success'
 
+###############################################################################
+# Test reading a FeatureCollection in streaming mode
+
+def ogr_geojson_60():
+    if gdaltest.geojson_drv is None:
+        return 'skip'
+
+    gdal.FileFromMemBuffer('/vsimem/ogr_geojson_60.json',
+"""{ "type": "FeatureCollection",
+  "features": [
+    { "type": "Feature", "id": 3, "properties": { "a": 1, "s": "x]},\\"y" }, "geometry": { "type": "Point", "coordinates": [1,2] } },
+    { "type": "Feature", "properties": { "a": 2.5, "b": null }, "geometry": { "type": "Point", "coordinates": [3,4] } },
+    { "type": "Feature", "properties": { "a": 3 }, "geometry": null }
+  ],
+  "name": "my_layer",
+  "description": "my_description",
+  "crs": { "type": "name", "properties": { "name": "urn:ogc:def:crs:EPSG::32631" } }
+}""")
+
+    gdal.SetConfigOption('OGR_GEOJSON_STREAMING_MIN_SIZE', '0')
+    ds = ogr.Open('/vsimem/ogr_geojson_60.json')
+    gdal.SetConfigOption('OGR_GEOJSON_STREAMING_MIN_SIZE', None)
+    if ds is None:
+        gdaltest.post_reason('Failed to open datasource')
+        return 'fail'
+
+    lyr = ds.GetLayerByName('my_layer')
+    if lyr is None:
+        gdaltest.post_reason('Missing layer called my_layer')
+        return 'fail'
+    if lyr.TestCapability(ogr.OLCRandomRead) != 0:
+        gdaltest.post_reason('layer not in streaming mode')
+        return 'fail'
+    if lyr.GetMetadataItem('DESCRIPTION') != 'my_description':
+        gdaltest.post_reason('Did not get DESCRIPTION')
+        return 'fail'
+    if lyr.GetSpatialRef().GetAuthorityCode(None) != '32631':
+        gdaltest.post_reason('Did not get expected SRS')
+        return 'fail'
+    if lyr.GetGeomType() != ogr.wkbPoint:
+        gdaltest.post_reason('Did not get expected geometry type')
+        return 'fail'
+    if lyr.GetLayerDefn().GetFieldCount() != 3:
+        gdaltest.post_reason('Did not get expected field count')
+        return 'fail'
+    if lyr.GetFeatureCount() != 3:
+        gdaltest.post_reason('Did not get expected feature count')
+        return 'fail'
+
+    for i in range(2):
+        f = lyr.GetNextFeature()
+        if f.GetFID() != 3 or f['a'] != 1 or f['s'] != 'x]},"y' or \
+           f.GetGeometryRef().ExportToWkt() != 'POINT (1 2)':
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            return 'fail'
+        f = lyr.GetNextFeature()
+        if f['a'] != 2.5 or f.GetGeometryRef().ExportToWkt() != 'POINT (3 4)':
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            return 'fail'
+        f = lyr.GetNextFeature()
+        if f['a'] != 3 or f.GetGeometryRef() is not None:
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            return 'fail'
+        f = lyr.GetNextFeature()
+        if f is not None:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        lyr.ResetReading()
+
+    lyr.SetAttributeFilter('a > 1')
+    if lyr.GetFeatureCount() != 2:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    lyr.SetAttributeFilter(None)
+
+    lyr.SetSpatialFilterRect(2.5, 3.5, 3.5, 4.5)
+    f = lyr.GetNextFeature()
+    if f['a'] != 2.5:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    lyr.SetSpatialFilter(None)
+
+    f = lyr.GetFeature(3)
+    if f is None or f['a'] != 1:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    ds = None
+    gdal.Unlink('/vsimem/ogr_geojson_60.json')
+
+    return 'success'
+
+###############################################################################
+# Test that errors on invalid geometries are reported once in streaming mode
+
+class OGRGeoJSONErrorHandler:
+    def __init__(self):
+        self.error_list = []
+
+    def error_handler(self, err_type, err_no, err_msg):
+        if err_type != 1 and err_msg.find('Invalid') == 0: # 1 == Debug
+            self.error_list.append(err_msg)
+
+def ogr_geojson_61():
+    if gdaltest.geojson_drv is None:
+        return 'skip'
+
+    myhandler = OGRGeoJSONErrorHandler()
+    gdal.PushErrorHandler(myhandler.error_handler)
+    gdal.SetConfigOption('OGR_GEOJSON_STREAMING_MIN_SIZE', '0')
+    ds = ogr.Open('data/ogr_geojson_14.geojson')
+    gdal.SetConfigOption('OGR_GEOJSON_STREAMING_MIN_SIZE', None)
+    gdal.PopErrorHandler()
+    if ds is None:
+        gdaltest.post_reason('Failed to open datasource')
+        return 'fail'
+    lyr = ds.GetLayer(0)
+    if lyr.TestCapability(ogr.OLCRandomRead) != 0:
+        gdaltest.post_reason('layer not in streaming mode')
+        return 'fail'
+    # The scan of the file at opening is silent.
+    if len(myhandler.error_list) != 0:
+        gdaltest.post_reason('fail')
+        print(myhandler.error_list)
+        return 'fail'
+
+    for expected_count in [ 7, 0 ]:
+        myhandler = OGRGeoJSONErrorHandler()
+        gdal.PushErrorHandler(myhandler.error_handler)
+        lyr.ResetReading()
+        f = lyr.GetNextFeature()
+        while f is not None:
+            f = lyr.GetNextFeature()
+        gdal.PopErrorHandler()
+        if len(myhandler.error_list) != expected_count or \
+           len(set(myhandler.error_list)) != expected_count:
+            gdaltest.post_reason('fail')
+            print(myhandler.error_list)
+            return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     ogr_geojson_1,
     ogr_geojson_2,
@@ -3442,6 +3587,8 @@ gdaltest_list = [
     ogr_geojson_57,
     ogr_geojson_58,
     ogr_geojson_59,
+    ogr_geojson_60,
+    ogr_geojson_61,
     ogr_geojson_cleanup ]
 
 if __name__ == '__main__':
@@ -2919,6 +2919,70 @@ def ogr_gpkg_41():
 
     return 'success'
 
+###############################################################################
+# Test bulk loading of the spatial index of a newly created layer
+
+def ogr_gpkg_42():
+
+    if gdaltest.gpkg_dr is None:
+        return 'skip'
+
+    for delete_feature in [False, True]:
+        ds = gdaltest.gpkg_dr.CreateDataSource('/vsimem/ogr_gpkg_42.gpkg')
+        lyr = ds.CreateLayer('test')
+        lyr.StartTransaction()
+        for i in range(1000):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            if i % 100 == 1:
+                f.SetGeometry(ogr.CreateGeometryFromWkt('POINT EMPTY'))
+            elif i % 100 != 2:
+                f.SetGeometry(ogr.CreateGeometryFromWkt(
+                    'LINESTRING(%d %d,%d %d)' % ((i * 37) % 1000, (i * 91) % 1000, (i * 37) % 1000 + 5, (i * 91) % 1000 + 3)))
+            lyr.CreateFeature(f)
+        lyr.CommitTransaction()
+        if delete_feature:
+            lyr.DeleteFeature(4)
+        ds = None
+
+        ds = ogr.Open('/vsimem/ogr_gpkg_42.gpkg')
+        sql_lyr = ds.ExecuteSQL('SELECT COUNT(*) FROM rtree_test_geom')
+        f = sql_lyr.GetNextFeature()
+        got_count = f.GetField(0)
+        ds.ReleaseResultSet(sql_lyr)
+        expected_count = 980
+        if delete_feature:
+            expected_count -= 1
+        if got_count != expected_count:
+            gdaltest.post_reason('fail')
+            print(delete_feature)
+            print(got_count)
+            return 'fail'
+
+        sql_lyr = ds.ExecuteSQL('SELECT COUNT(*) FROM test t JOIN rtree_test_geom r ON t.fid = r.id WHERE ' +
+                                'r.minx > st_minx(t.geom) OR r.maxx < st_maxx(t.geom) OR ' +
+                                'r.miny > st_miny(t.geom) OR r.maxy < st_maxy(t.geom)')
+        f = sql_lyr.GetNextFeature()
+        got_count = f.GetField(0)
+        ds.ReleaseResultSet(sql_lyr)
+        if got_count != 0:
+            gdaltest.post_reason('fail')
+            print(delete_feature)
+            return 'fail'
+
+        lyr = ds.GetLayer(0)
+        lyr.SetSpatialFilterRect(100, 100, 200, 200)
+        got_count = lyr.GetFeatureCount()
+        lyr.SetSpatialFilterRect(-1, -1, 2000, 2000)
+        if got_count == 0 or lyr.GetFeatureCount() != expected_count:
+            gdaltest.post_reason('fail')
+            print(delete_feature)
+            return 'fail'
+        ds = None
+
+        gdaltest.gpkg_dr.DeleteDataSource('/vsimem/ogr_gpkg_42.gpkg')
+
+    return 'success'
+
 ###############################################################################
 # Remove the test db from the tmp directory
 
@@ -2985,6 +3049,7 @@ gdaltest_list = [
     ogr_gpkg_39,
     ogr_gpkg_40,
     ogr_gpkg_41,
+    ogr_gpkg_42,
     ogr_gpkg_test_ogrsf,
     ogr_gpkg_cleanup,
 ]
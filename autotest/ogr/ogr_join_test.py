@@ -516,6 +516,127 @@ def ogr_join_22():
 
     return 'success'
 
+###############################################################################
+# Test that the hash join gives the same results as per-feature lookups,
+# including when only FIDs are kept in the join index
+
+class ogr_join_23_handler:
+    def __init__(self):
+        self.msgs = []
+
+    def handler(self, eErrClass, err_no, msg):
+        if msg.find('Join index on') >= 0:
+            self.msgs.append(msg)
+
+def ogr_join_23():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('first')
+    lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('str', ogr.OFTString))
+    for (i, r, s) in [ (1, 1.5, 'a'), (2, 2.5, 'B'), (3, None, 'c'),
+                       (None, 4.5, None), (1, 5, 'A'),
+                       (6, 0.1 + 0.2, '2017/01/01 00:00:00') ]:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i is not None:
+            f.SetField('int', i)
+        if r is not None:
+            f.SetField('real', r)
+        if s is not None:
+            f.SetField('str', s)
+        lyr.CreateFeature(f)
+
+    for name in [ 'second', 'second_indexed', 'third' ]:
+        lyr = ds.CreateLayer(name)
+        lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger64))
+        lyr.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+        lyr.CreateField(ogr.FieldDefn('str', ogr.OFTString))
+        lyr.CreateField(ogr.FieldDefn('val', ogr.OFTString))
+        rows = [ (1, 1.5, 'A', 'one'), (1, 2.5, 'b', 'one_bis'),
+                 (2, 2.5, 'b', 'two'), (None, 5, None, 'five'),
+                 (4, None, 'a', 'four'), (6, 0.3, None, 'six') ]
+        if name == 'third':
+            rows.append( (7, 7, '2017/01/01 00:00:00+00', 'seven') )
+        for (i, r, s, v) in rows:
+            f = ogr.Feature(lyr.GetLayerDefn())
+            if i is not None:
+                f.SetField('int', i)
+            if r is not None:
+                f.SetField('real', r)
+            if s is not None:
+                f.SetField('str', s)
+            f.SetField('val', v)
+            lyr.CreateFeature(f)
+    ds.ExecuteSQL('CREATE INDEX ON second_indexed USING str')
+
+    # SQL request, and whether the hash join can be used
+    sqls = [ ('SELECT val FROM first LEFT JOIN second ON first.int = second.int', True),
+             ('SELECT val FROM first LEFT JOIN second ON first.real = second.real', True),
+             ('SELECT val FROM first LEFT JOIN second ON first.int = second.real', True),
+             ('SELECT val FROM first LEFT JOIN second ON first.str = second.str', True),
+             ('SELECT val FROM first LEFT JOIN second ON second.str = first.str AND first.real = second.real', True),
+             ('SELECT val FROM first LEFT JOIN second_indexed ON first.str = second_indexed.str', False),
+             ('SELECT val FROM first LEFT JOIN third ON first.str = third.str', False) ]
+    for (sql, hash_join_possible) in sqls:
+        res = []
+        for (hash_join, max_memory) in [ ('NO', None), ('YES', None),
+                                         ('YES', '0') ]:
+            gdal.SetConfigOption('OGR_SQL_HASH_JOIN', hash_join)
+            gdal.SetConfigOption('OGR_SQL_HASH_JOIN_MAX_MEMORY', max_memory)
+            sql_lyr = ds.ExecuteSQL(sql)
+            gdal.SetConfigOption('OGR_SQL_HASH_JOIN', None)
+            gdal.SetConfigOption('OGR_SQL_HASH_JOIN_MAX_MEMORY', None)
+
+            # The options are taken into account by ExecuteSQL(), not when
+            # reading the features
+            handler = ogr_join_23_handler()
+            old_debug = gdal.GetConfigOption('CPL_DEBUG')
+            gdal.SetConfigOption('CPL_DEBUG', 'ON')
+            gdal.PushErrorHandler(handler.handler)
+            res.append([ f.GetField('val') for f in sql_lyr ])
+            gdal.PopErrorHandler()
+            gdal.SetConfigOption('CPL_DEBUG', old_debug)
+            ds.ReleaseResultSet(sql_lyr)
+
+            if hash_join == 'NO' or not hash_join_possible:
+                expected_msgs = []
+            elif max_memory == '0':
+                expected_msgs = [ 'FIDs only' ]
+            else:
+                expected_msgs = [ 'keys.' ]
+            if len(handler.msgs) != len(expected_msgs) or \
+               (expected_msgs and handler.msgs[0].find(expected_msgs[0]) < 0):
+                gdaltest.post_reason('fail')
+                print(sql, hash_join, max_memory)
+                print(handler.msgs)
+                return 'fail'
+
+        if res[1] != res[0] or res[2] != res[0]:
+            gdaltest.post_reason('fail')
+            print(sql)
+            print(res)
+            return 'fail'
+
+    # Values rounded by the filter, and timestamps with implicit timezone
+    # are matched as with per-feature lookups
+    sql_lyr = ds.ExecuteSQL('SELECT val FROM first LEFT JOIN second ON first.real = second.real')
+    res = [ f.GetField('val') for f in sql_lyr ]
+    ds.ReleaseResultSet(sql_lyr)
+    if res[5] != 'six':
+        gdaltest.post_reason('fail')
+        print(res)
+        return 'fail'
+    sql_lyr = ds.ExecuteSQL('SELECT val FROM first LEFT JOIN third ON first.str = third.str')
+    res = [ f.GetField('val') for f in sql_lyr ]
+    ds.ReleaseResultSet(sql_lyr)
+    if res[5] != 'seven':
+        gdaltest.post_reason('fail')
+        print(res)
+        return 'fail'
+
+    return 'success'
+
 ###############################################################################
 
 def ogr_join_cleanup():
@@ -547,6 +668,7 @@ gdaltest_list = [
     ogr_join_20,
     ogr_join_21,
     ogr_join_22,
+    ogr_join_23,
     ogr_join_cleanup ]
 
 if __name__ == '__main__':
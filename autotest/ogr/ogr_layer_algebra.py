@@ -677,6 +677,76 @@ def algebra_erase():
 
     return 'success'
 
+###############################################################################
+# Test that the result does not depend on the number of threads.
+
+def algebra_num_threads():
+    if not ogrtest.have_geos():
+        return 'skip'
+
+    mem_ds = ogr.GetDriverByName('Memory').CreateDataSource( 'wrk_threads' )
+    lyr_input = mem_ds.CreateLayer( 'input' )
+    lyr_input.CreateField( ogr.FieldDefn("A", ogr.OFTInteger) )
+    lyr_method = mem_ds.CreateLayer( 'method' )
+    lyr_method.CreateField( ogr.FieldDefn("B", ogr.OFTInteger) )
+
+    for i in range(200):
+        x = (i * 7) % 50
+        y = (i * 13) % 50
+        feat = ogr.Feature( lyr_input.GetLayerDefn() )
+        feat.SetField('A', i)
+        feat.SetGeometryDirectly( ogr.CreateGeometryFromWkt(
+            'POLYGON((%d %d,%d %d,%d %d,%d %d,%d %d))' % (x, y, x, y+3, x+3, y+3, x+3, y, x, y)) )
+        lyr_input.CreateFeature( feat )
+
+    for i in range(25):
+        x = (i % 5) * 10
+        y = (i / 5) * 10
+        feat = ogr.Feature( lyr_method.GetLayerDefn() )
+        feat.SetField('B', i)
+        feat.SetGeometryDirectly( ogr.CreateGeometryFromWkt(
+            'POLYGON((%d %d,%d %d,%d %d,%d %d,%d %d))' % (x, y, x, y+12, x+12, y+12, x+12, y, x, y)) )
+        lyr_method.CreateFeature( feat )
+
+    for method in [ 'Intersection', 'Union', 'SymDifference', 'Identity',
+                    'Update', 'Clip', 'Erase' ]:
+        lyr_res1 = mem_ds.CreateLayer( 'res1' )
+        lyr_res4 = mem_ds.CreateLayer( 'res4' )
+        err = getattr(lyr_input, method)( lyr_method, lyr_res1, options = ['NUM_THREADS=1'] )
+        if err != 0:
+            gdaltest.post_reason( 'got non-zero result code '+str(err)+' from Layer.' + method )
+            return 'fail'
+        err = getattr(lyr_input, method)( lyr_method, lyr_res4, options = ['NUM_THREADS=4'] )
+        if err != 0:
+            gdaltest.post_reason( 'got non-zero result code '+str(err)+' from Layer.' + method )
+            return 'fail'
+        if lyr_res1.GetFeatureCount() == 0 or \
+           lyr_res1.GetFeatureCount() != lyr_res4.GetFeatureCount():
+            gdaltest.post_reason( 'Layer.' + method + ' result depends on NUM_THREADS' )
+            return 'fail'
+        # Compare the features in order. is_same() cannot be used, as
+        # Feature.Equal() requires the same layer definition and FID.
+        lyr_res1.ResetReading()
+        lyr_res4.ResetReading()
+        for f1 in lyr_res1:
+            f4 = lyr_res4.GetNextFeature()
+            if f1.GetFieldCount() != f4.GetFieldCount() or \
+               [ f1.GetField(i) for i in range(f1.GetFieldCount()) ] != \
+               [ f4.GetField(i) for i in range(f4.GetFieldCount()) ] or \
+               f1.GetGeometryRef().ExportToWkt() != f4.GetGeometryRef().ExportToWkt():
+                gdaltest.post_reason( 'Layer.' + method + ' result depends on NUM_THREADS' )
+                f1.DumpReadable()
+                f4.DumpReadable()
+                return 'fail'
+        lyr_res1 = None
+        lyr_res4 = None
+        mem_ds.DeleteLayer( 'res4' )
+        mem_ds.DeleteLayer( 'res1' )
+
+    mem_ds = None
+
+    return 'success'
+
 def algebra_cleanup():
     if not ogrtest.have_geos():
         return 'skip'
@@ -705,6 +775,7 @@ gdaltest_list = [
     algebra_update,
     algebra_clip,
     algebra_erase,
+    algebra_num_threads,
     algebra_cleanup,
     ]
 
@@ -29,6 +29,7 @@
 # DEALINGS IN THE SOFTWARE.
 ###############################################################################
 
+import random
 import sys
 
 sys.path.append( '../pymod' )
@@ -838,6 +839,247 @@ def ogr_mem_17():
 
     return 'success'
 
+###############################################################################
+# Test the optional spatial index
+
+def ogr_mem_18():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('ogr_mem_18', options = ['SPATIAL_INDEX=YES'])
+    if lyr.TestCapability(ogr.OLCFastSpatialFilter) != 1:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    lyr_ref = ds.CreateLayer('ogr_mem_18_ref')
+    for l in [lyr, lyr_ref]:
+        for j in range(30):
+            for i in range(30):
+                f = ogr.Feature(l.GetLayerDefn())
+                f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i, j)))
+                l.CreateFeature(f)
+        f = ogr.Feature(l.GetLayerDefn())
+        l.CreateFeature(f)
+
+    def get_fids(l):
+        l.ResetReading()
+        return [f.GetFID() for f in l]
+
+    for (minx, miny, maxx, maxy) in [(2.5, 3.5, 7.5, 8.5), (-10, -10, -5, -5),
+                                     (-1, -1, 100, 100), (29, 29, 29, 29)]:
+        for l in [lyr, lyr_ref]:
+            l.SetSpatialFilterRect(minx, miny, maxx, maxy)
+        if get_fids(lyr) != get_fids(lyr_ref):
+            gdaltest.post_reason('fail')
+            print(minx, miny, maxx, maxy)
+            print(get_fids(lyr))
+            print(get_fids(lyr_ref))
+            return 'fail'
+
+    # Modify the layers and check the index is kept up to date
+    for l in [lyr, lyr_ref]:
+        l.SetSpatialFilterRect(2.5, 3.5, 7.5, 8.5)
+        l.ResetReading()
+        f = l.GetNextFeature()
+        l.DeleteFeature(f.GetFID() + 1)
+        f = l.GetFeature(0)
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(5 5)'))
+        l.SetFeature(f)
+        f = ogr.Feature(l.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(3 4)'))
+        l.CreateFeature(f)
+        f = l.GetFeature(5 * 30 + 5)
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(50 50)'))
+        l.SetFeature(f)
+        for i in range(2000):
+            f = ogr.Feature(l.GetLayerDefn())
+            f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d 100)' % i))
+            l.CreateFeature(f)
+
+    for (minx, miny, maxx, maxy) in [(2.5, 3.5, 7.5, 8.5), (49, 49, 51, 51),
+                                     (10, 99, 20, 101)]:
+        for l in [lyr, lyr_ref]:
+            l.SetSpatialFilterRect(minx, miny, maxx, maxy)
+        if get_fids(lyr) != get_fids(lyr_ref):
+            gdaltest.post_reason('fail')
+            print(minx, miny, maxx, maxy)
+            print(get_fids(lyr))
+            print(get_fids(lyr_ref))
+            return 'fail'
+
+    if lyr.GetFeatureCount() != 11:
+        gdaltest.post_reason('fail')
+        print(lyr.GetFeatureCount())
+        return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test attribute indexes
+
+def ogr_mem_19():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('ogr_mem_19')
+    lyr_ref = ds.CreateLayer('ogr_mem_19_ref')
+    for l in [lyr, lyr_ref]:
+        l.CreateField(ogr.FieldDefn('int', ogr.OFTInteger))
+        l.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+        l.CreateField(ogr.FieldDefn('str', ogr.OFTString))
+        for i in range(100):
+            f = ogr.Feature(l.GetLayerDefn())
+            f.SetField('int', i % 10)
+            f.SetField('real', (i % 7) + 0.5)
+            if i % 3 != 0:
+                f.SetField('str', 'val%d' % (i % 5))
+            l.CreateFeature(f)
+
+    if ds.ExecuteSQL('CREATE INDEX ON ogr_mem_19 USING int') is not None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    ds.ExecuteSQL('CREATE INDEX ON ogr_mem_19 USING real')
+    ds.ExecuteSQL('CREATE INDEX ON ogr_mem_19 USING str')
+
+    def get_fids(l):
+        l.ResetReading()
+        return [f.GetFID() for f in l]
+
+    filters = [ 'int = 3', 'int = 3.5', 'int IN (1, 4)', 'real = 2.5',
+                "str = 'VAL2'", "str = 'val2' AND int = 2",
+                "str = 'val2' OR int = 3", 'int = 3 AND real > 3',
+                'int = 100' ]
+
+    for step in range(2):
+        for filter in filters:
+            for l in [lyr, lyr_ref]:
+                l.SetAttributeFilter(filter)
+            if get_fids(lyr) != get_fids(lyr_ref):
+                gdaltest.post_reason('fail')
+                print(step, filter)
+                print(get_fids(lyr))
+                print(get_fids(lyr_ref))
+                return 'fail'
+
+        # Modify the layers and check the indexes are kept up to date
+        for l in [lyr, lyr_ref]:
+            l.SetAttributeFilter(None)
+            l.DeleteFeature(13)
+            f = l.GetFeature(23)
+            f.SetField('int', 4)
+            f.SetField('str', 'val2')
+            l.SetFeature(f)
+            f = ogr.Feature(l.GetLayerDefn())
+            f.SetField('int', 3)
+            f.SetField('real', 2.5)
+            l.CreateFeature(f)
+            l.DeleteField(1)
+            l.ReorderFields([1, 0])
+        filters = [ 'int = 3', 'int IN (3, 4)', "str = 'val2'",
+                    "str = 'val2' OR int = 3" ]
+
+    ds.ExecuteSQL('DROP INDEX ON ogr_mem_19 USING int')
+    lyr.SetAttributeFilter('int = 3')
+    lyr_ref.SetAttributeFilter('int = 3')
+    if get_fids(lyr) != get_fids(lyr_ref):
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    # Unsupported field type
+    lyr.CreateField(ogr.FieldDefn('date', ogr.OFTDate))
+    gdal.ErrorReset()
+    gdal.PushErrorHandler()
+    ds.ExecuteSQL('CREATE INDEX ON ogr_mem_19 USING date')
+    gdal.PopErrorHandler()
+    if gdal.GetLastErrorMsg() == '':
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test that the spatial index returns the same features as a sequential scan
+# for features without geometry and after random modifications
+
+def ogr_mem_20():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('ogr_mem_20', options = ['SPATIAL_INDEX=YES'])
+    lyr_ref = ds.CreateLayer('ogr_mem_20_ref')
+
+    def get_fids(l):
+        l.ResetReading()
+        return [f.GetFID() for f in l]
+
+    def check(minx, miny, maxx, maxy):
+        for l in [lyr, lyr_ref]:
+            l.SetSpatialFilterRect(minx, miny, maxx, maxy)
+        ret = get_fids(lyr) == get_fids(lyr_ref)
+        if not ret:
+            print(minx, miny, maxx, maxy)
+            print(get_fids(lyr))
+            print(get_fids(lyr_ref))
+        for l in [lyr, lyr_ref]:
+            l.SetSpatialFilter(None)
+        return ret
+
+    # Features without geometry or with an empty geometry
+    for l in [lyr, lyr_ref]:
+        f = ogr.Feature(l.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(1 1)'))
+        l.CreateFeature(f)
+        f = ogr.Feature(l.GetLayerDefn())
+        l.CreateFeature(f)
+        f = ogr.Feature(l.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT EMPTY'))
+        l.CreateFeature(f)
+    if not check(10, 10, 20, 20) or not check(0, 0, 2, 2):
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    # Random creations, updates and deletions
+    rnd = random.Random(1)
+
+    def random_geom():
+        if rnd.randint(0, 9) == 0:
+            return None
+        x = rnd.randint(-500, 1500)
+        y = rnd.randint(-500, 1500)
+        return ogr.CreateGeometryFromWkt('LINESTRING (%d %d,%d %d)' %
+            (x, y, x + rnd.randint(0, 50), y + rnd.randint(0, 50)))
+
+    fids = [0, 1, 2]
+    for it in range(3000):
+        op = rnd.randint(0, 9)
+        if op < 5 or len(fids) == 0:
+            g = random_geom()
+            for l in [lyr, lyr_ref]:
+                f = ogr.Feature(l.GetLayerDefn())
+                f.SetGeometry(g)
+                l.CreateFeature(f)
+            fids.append(f.GetFID())
+        elif op < 8:
+            fid = rnd.choice(fids)
+            g = random_geom()
+            for l in [lyr, lyr_ref]:
+                f = ogr.Feature(l.GetLayerDefn())
+                f.SetFID(fid)
+                f.SetGeometry(g)
+                l.SetFeature(f)
+        else:
+            fid = rnd.choice(fids)
+            fids.remove(fid)
+            for l in [lyr, lyr_ref]:
+                l.DeleteFeature(fid)
+
+        if it % 50 == 0:
+            x = rnd.randint(-500, 1500)
+            y = rnd.randint(-500, 1500)
+            s = rnd.randint(0, 300)
+            if not check(x, y, x + s, y + s):
+                gdaltest.post_reason('fail')
+                print(it)
+                return 'fail'
+
+    return 'success'
+
 def ogr_mem_cleanup():
 
     if gdaltest.mem_ds is None:
@@ -866,6 +1108,9 @@ gdaltest_list = [
     ogr_mem_15,
     ogr_mem_16,
     ogr_mem_17,
+    ogr_mem_18,
+    ogr_mem_19,
+    ogr_mem_20,
     ogr_mem_cleanup ]
 
 if __name__ == '__main__':
@@ -939,6 +939,38 @@ def ogr_osm_17():
 
     return 'success'
 
+###############################################################################
+# Test multi-threaded decoding of PBF blobs (NUM_THREADS open option)
+
+def ogr_osm_18():
+
+    if ogrtest.osm_drv is None:
+        return 'skip'
+
+    for filename in [ 'data/test.pbf', 'data/base-64.osm.pbf',
+                      'data/test_uncompressed_dense_false.pbf' ]:
+        ref_ds = gdal.OpenEx(filename, gdal.OF_VECTOR)
+        ds = gdal.OpenEx(filename, gdal.OF_VECTOR, open_options = ['NUM_THREADS=4'])
+        for i in range(ref_ds.GetLayerCount()):
+            ref_lyr = ref_ds.GetLayer(i)
+            lyr = ds.GetLayer(i)
+            while True:
+                ref_f = ref_lyr.GetNextFeature()
+                f = lyr.GetNextFeature()
+                if ref_f is None and f is None:
+                    break
+                if ref_f is None or f is None or not ref_f.Equal(f):
+                    gdaltest.post_reason('fail')
+                    print(filename)
+                    print(ref_lyr.GetName())
+                    if ref_f is not None:
+                        ref_f.DumpReadable()
+                    if f is not None:
+                        f.DumpReadable()
+                    return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     ogr_osm_1,
     ogr_osm_2,
@@ -962,6 +994,7 @@ gdaltest_list = [
     ogr_osm_15,
     ogr_osm_16,
     ogr_osm_17,
+    ogr_osm_18,
     ]
 
 if __name__ == '__main__':
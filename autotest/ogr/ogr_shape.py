@@ -5121,6 +5121,102 @@ def ogr_shape_106():
 
     return 'success'
 
+###############################################################################
+# Test organizePolygons() with many inner rings, and islands in some of them
+# (uses the spatial index of rings)
+
+def ogr_shape_107():
+
+    geom = ogr.Geometry(ogr.wkbMultiPolygon)
+
+    # A large polygon with 20x20 lakes
+    poly = ogr.Geometry(ogr.wkbPolygon)
+    ring = ogr.Geometry(ogr.wkbLinearRing)
+    for i in range(200):
+        ring.AddPoint_2D(i, 0)
+    for i in range(200):
+        ring.AddPoint_2D(200, i)
+    for i in range(200):
+        ring.AddPoint_2D(200 - i, 200)
+    for i in range(200):
+        ring.AddPoint_2D(0, 200 - i)
+    ring.AddPoint_2D(0, 0)
+    poly.AddGeometry(ring)
+    for j in range(20):
+        for i in range(20):
+            x = 10 * i + 2
+            y = 10 * j + 2
+            poly.AddGeometry(ogr.CreateGeometryFromWkt(
+                'LINEARRING (%d %d,%d %d,%d %d,%d %d,%d %d)' %
+                (x, y, x + 6, y, x + 6, y + 6, x, y + 6, x, y)))
+    geom.AddGeometry(poly)
+
+    # Islands in the lakes of the first row
+    for i in range(20):
+        x = 10 * i + 4
+        geom.AddGeometry(ogr.CreateGeometryFromWkt(
+            'POLYGON ((%d 4,%d 6,%d 6,%d 4,%d 4))' % (x, x, x + 2, x + 2, x)))
+
+    # Another polygon, far away
+    geom.AddGeometry(ogr.CreateGeometryFromWkt(
+        'POLYGON ((300 0,300 10,310 10,310 0,300 0))'))
+
+    ds = ogr.GetDriverByName('ESRI Shapefile').CreateDataSource('/vsimem/ogr_shape_107.shp')
+    lyr = ds.CreateLayer('ogr_shape_107', geom_type = ogr.wkbPolygon)
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    feat.SetGeometry(geom)
+    lyr.CreateFeature(feat)
+    feat = None
+    ds = None
+
+    ds = ogr.Open('/vsimem/ogr_shape_107.shp')
+    lyr = ds.GetLayer(0)
+    for method in [ 'DEFAULT', 'ONLY_CCW' ]:
+        lyr.ResetReading()
+        gdal.SetConfigOption('OGR_ORGANIZE_POLYGONS', method)
+        feat = lyr.GetNextFeature()
+        gdal.SetConfigOption('OGR_ORGANIZE_POLYGONS', None)
+        got_geom = feat.GetGeometryRef()
+        if got_geom.GetGeometryCount() != 22 or \
+           got_geom.GetGeometryRef(0).GetGeometryCount() != 401 or \
+           abs(got_geom.GetArea() - geom.GetArea()) > 1e-5:
+            gdaltest.post_reason('fail')
+            print(method)
+            print(got_geom.GetGeometryCount())
+            print(got_geom.GetArea())
+            return 'fail'
+    ds = None
+
+    ogr.GetDriverByName('ESRI Shapefile').DeleteDataSource('/vsimem/ogr_shape_107.shp')
+
+    # A ring whose points are all aligned with edges of the outer ring
+    # (but not on them) is not considered as inside it.
+    geom = ogr.CreateGeometryFromWkt('MULTIPOLYGON (((0 0,0 2,1 2,1 4,0 4,0 10,10 10,10 0,4 0,4 1,2 1,2 0,0 0)),((2 2,2 4,4 4,4 2,2 2)))')
+    ds = ogr.GetDriverByName('ESRI Shapefile').CreateDataSource('/vsimem/ogr_shape_107.shp')
+    lyr = ds.CreateLayer('ogr_shape_107', geom_type = ogr.wkbPolygon)
+    feat = ogr.Feature(lyr.GetLayerDefn())
+    feat.SetGeometry(geom)
+    lyr.CreateFeature(feat)
+    feat = None
+    ds = None
+
+    ds = ogr.Open('/vsimem/ogr_shape_107.shp')
+    lyr = ds.GetLayer(0)
+    gdal.SetConfigOption('OGR_ORGANIZE_POLYGONS', 'DEFAULT')
+    feat = lyr.GetNextFeature()
+    gdal.SetConfigOption('OGR_ORGANIZE_POLYGONS', None)
+    got_geom = feat.GetGeometryRef()
+    if got_geom.GetGeometryType() != ogr.wkbMultiPolygon or \
+       got_geom.GetGeometryCount() != 2:
+        gdaltest.post_reason('fail')
+        print(got_geom.ExportToWkt())
+        return 'fail'
+    ds = None
+
+    ogr.GetDriverByName('ESRI Shapefile').DeleteDataSource('/vsimem/ogr_shape_107.shp')
+
+    return 'success'
+
 ###############################################################################
 def ogr_shape_cleanup():
 
@@ -5271,6 +5367,7 @@ gdaltest_list = [
     ogr_shape_104,
     ogr_shape_105,
     ogr_shape_106,
+    ogr_shape_107,
     ogr_shape_cleanup ]
 
 # gdaltest_list = [ ogr_shape_106 ]
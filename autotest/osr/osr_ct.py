@@ -322,6 +322,63 @@ def osr_ct_8():
 
     return 'success'
 
+###############################################################################
+# Test the transformations between geographic coordinates and WebMercator / UTM
+# that are done without PROJ.4, and check that they are consistent with PROJ.4
+
+def osr_ct_9():
+
+    tests = [ (4326, 3857, (2, 49), (222638.981586547, 6274861.39400658)),
+              (4326, 32631, (3, 0), (500000, 0)),
+              (4326, 32731, (3, -33.5), (500000, 6293280.77949566)),
+              (4269, 26915, (-93, 45), (500000, 4982950.40010686)) ]
+
+    for (src_epsg, dst_epsg, src_pnt, expected_pnt) in tests:
+        src_srs = osr.SpatialReference()
+        src_srs.ImportFromEPSG( src_epsg )
+        dst_srs = osr.SpatialReference()
+        dst_srs.ImportFromEPSG( dst_epsg )
+
+        ct = osr.CoordinateTransformation( src_srs, dst_srs )
+        (x, y, z) = ct.TransformPoint( src_pnt[0], src_pnt[1] )
+        if abs(x - expected_pnt[0]) > 1e-3 or abs(y - expected_pnt[1]) > 1e-3:
+            gdaltest.post_reason( 'fail' )
+            print(src_epsg, dst_epsg, x, y)
+            return 'fail'
+
+        ct = osr.CoordinateTransformation( dst_srs, src_srs )
+        (x, y, z) = ct.TransformPoint( x, y )
+        if abs(x - src_pnt[0]) > 1e-10 or abs(y - src_pnt[1]) > 1e-10:
+            gdaltest.post_reason( 'fail' )
+            print(dst_epsg, src_epsg, x, y)
+            return 'fail'
+
+        if gdaltest.have_proj4 == 0:
+            continue
+
+        # Compare with PROJ.4 on a few points, up to far from the central
+        # meridian of UTM zones, and in both directions
+        pnts = [ (src_pnt[0] + i * 1.5, src_pnt[1] + i * 0.3) for i in range(-6, 7) ]
+        for (srs1, srs2, eps) in [ (src_srs, dst_srs, 1e-6),
+                                   (dst_srs, src_srs, 1e-11) ]:
+            ct = osr.CoordinateTransformation( srs1, srs2 )
+            result = ct.TransformPoints( pnts )
+            gdal.SetConfigOption( 'OGR_CT_USE_FAST_PATHS', 'NO' )
+            ct = osr.CoordinateTransformation( srs1, srs2 )
+            gdal.SetConfigOption( 'OGR_CT_USE_FAST_PATHS', None )
+            expected_result = ct.TransformPoints( pnts )
+            for i in range(len(pnts)):
+                for j in range(2):
+                    if abs(result[i][j] - expected_result[i][j]) > eps:
+                        gdaltest.post_reason( 'fail' )
+                        print(src_epsg, dst_epsg)
+                        print('Got:      %s' % str(result))
+                        print('Expected: %s' % str(expected_result))
+                        return 'fail'
+            pnts = result
+
+    return 'success'
+
 ###############################################################################
 # Cleanup
 
@@ -343,6 +400,7 @@ gdaltest_list = [
     osr_ct_6,
     osr_ct_7,
     osr_ct_8,
+    osr_ct_9,
     osr_ct_cleanup,
     None ]
 
@@ -44,6 +44,16 @@ do_log = False
 
 TIME_SKEW = 30 * 60
 
+# Content of /vsicurl_ranges/test.bin, whose bytes depend on their offset
+vsicurl_ranges_content = None
+
+def get_vsicurl_ranges_content():
+    global vsicurl_ranges_content
+    if vsicurl_ranges_content is None:
+        vsicurl_ranges_content = bytes(bytearray(
+            [ (i * 37 + i // 1000) % 256 for i in range(300000) ]))
+    return vsicurl_ranges_content
+
 class GDAL_Handler(BaseHTTPRequestHandler):
 
     def log_request(self, code='-', size='-'):
@@ -62,6 +72,13 @@ class GDAL_Handler(BaseHTTPRequestHandler):
             self.end_headers()
             return
 
+        if self.path == '/vsicurl_ranges/test.bin':
+            self.send_response(200)
+            self.send_header('Content-type', 'application/octet-stream')
+            self.send_header('Content-Length', len(get_vsicurl_ranges_content()))
+            self.end_headers()
+            return
+
         # Simulate a redirect to a S3 signed URL
         if self.path == '/test_redirect/test.bin':
             import time
@@ -339,6 +356,28 @@ class GDAL_Handler(BaseHTTPRequestHandler):
                     self.wfile.write(content)
                 return
 
+            # Any range of a 300000 byte file
+            if self.path == '/vsicurl_ranges/test.bin':
+                content = get_vsicurl_ranges_content()
+                self.protocol_version = 'HTTP/1.1'
+                if 'Range' in self.headers:
+                    (start, end) = self.headers['Range'][len('bytes='):].split('-')
+                    start = int(start)
+                    end = min(int(end), len(content) - 1)
+                    self.send_response(206)
+                    self.send_header('Content-type', 'application/octet-stream')
+                    self.send_header('Content-Range', 'bytes %d-%d/%d' % (start, end, len(content)))
+                    self.send_header('Content-Length', end - start + 1)
+                    self.end_headers()
+                    self.wfile.write(content[start:end+1])
+                else:
+                    self.send_response(200)
+                    self.send_header('Content-type', 'application/octet-stream')
+                    self.send_header('Content-Length', len(content))
+                    self.end_headers()
+                    self.wfile.write(content)
+                return
+
             # First signed URL
             if self.path.startswith('/foo.s3.amazonaws.com/test_redirected/test.bin?Signature=foo&Expires='):
                 if 'Range' in self.headers:
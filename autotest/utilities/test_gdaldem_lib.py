@@ -587,6 +587,39 @@ def test_gdaldem_lib_nodata():
 
     return 'success'
 
+###############################################################################
+# Test that multi-threaded processing gives the same result
+
+def test_gdaldem_lib_num_threads():
+
+    src_ds = gdal.Open('../gdrivers/data/n43.dt0')
+    src_ds_float = gdal.Translate('', src_ds, format = 'MEM',
+                                  outputType = gdal.GDT_Float32,
+                                  noData = 0)
+
+    for src in [ src_ds, src_ds_float ]:
+        for (processing, options) in [ ('hillshade', {}),
+                                       ('hillshade', { 'computeEdges': True }),
+                                       ('slope', {}),
+                                       ('roughness', {}),
+                                       ('color-relief', { 'colorFilename': 'data/color_file.txt' }) ]:
+            ref_ds = gdal.DEMProcessing('', src, processing, format = 'MEM',
+                                        **options)
+            ref_cs = [ ref_ds.GetRasterBand(i+1).Checksum() for i in range(ref_ds.RasterCount) ]
+            ref_data = ref_ds.ReadRaster()
+
+            gdal.SetConfigOption('GDAL_NUM_THREADS', '3')
+            ds = gdal.DEMProcessing('', src, processing, format = 'MEM',
+                                    **options)
+            gdal.SetConfigOption('GDAL_NUM_THREADS', None)
+            cs = [ ds.GetRasterBand(i+1).Checksum() for i in range(ds.RasterCount) ]
+            if cs != ref_cs or ds.ReadRaster() != ref_data:
+                gdaltest.post_reason('fail')
+                print(processing, options, cs, ref_cs)
+                return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     test_gdaldem_lib_hillshade,
     test_gdaldem_lib_hillshade_float,
@@ -605,7 +638,8 @@ gdaltest_list = [
     test_gdaldem_lib_roughness,
     test_gdaldem_lib_slope_ZevenbergenThorne,
     test_gdaldem_lib_aspect_ZevenbergenThorne,
-    test_gdaldem_lib_nodata
+    test_gdaldem_lib_nodata,
+    test_gdaldem_lib_num_threads
     ]
 
 
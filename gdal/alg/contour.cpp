@@ -35,11 +35,14 @@
 #include <cstring>
 
 #include <algorithm>
+#include <new>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_priv.h"
 #include "ogr_api.h"
@@ -57,6 +60,13 @@ static const double FUDGE_EXACT = 0.001;
 
 static const double JOIN_DIST = 0.0001;
 
+// The size, in pixels, of the cells on which line ends are hashed.  It must
+// be larger than twice JOIN_DIST.
+
+static const double JOIN_CELL = 1.0 / 64;
+
+class GDALContourItem;
+
 /************************************************************************/
 /*                           GDALContourItem                            */
 /************************************************************************/
@@ -73,7 +83,12 @@ public:
 
     bool bLeftIsHigh;
 
+    // Position in the level, and ends as known to the level end index.
+    int nIndex;
+    double dfHeadX;
+    double dfHeadY;
     double dfTailX;
+    double dfTailY;
 
     explicit GDALContourItem( double dfLevel );
     ~GDALContourItem();
@@ -88,6 +103,43 @@ public:
     void   PrepareEjection();
 };
 
+/************************************************************************/
+/*                         GDALContourEndIndex                          */
+/*                                                                      */
+/*      Hash table of the ends of the contours of a level, keyed on     */
+/*      their coordinates snapped to cells of JOIN_CELL pixels.         */
+/************************************************************************/
+class GDALContourEndIndex
+{
+    struct Node
+    {
+        double           dfX;
+        double           dfY;
+        GDALContourItem *poItem;
+        bool             bTail;
+        int              nNext;
+    };
+
+    std::vector<int>  anBuckets;
+    std::vector<Node> asNodes;
+    int               nFreeNode;
+    int               nCount;
+
+    static GIntBig Cell( double dfVal )
+        { return static_cast<GIntBig>(floor(dfVal / JOIN_CELL)); }
+    int    Bucket( GIntBig nCellX, GIntBig nCellY ) const;
+    void   Rehash();
+
+public:
+    GDALContourEndIndex();
+
+    void   Insert( double dfX, double dfY, GDALContourItem *poItem,
+                   bool bTail );
+    void   Remove( double dfX, double dfY, GDALContourItem *poItem,
+                   bool bTail );
+    GDALContourItem *Find( double dfX, double dfY ) const;
+};
+
 /************************************************************************/
 /*                           GDALContourLevel                           */
 /************************************************************************/
@@ -99,6 +151,8 @@ class GDALContourLevel
     int nEntryCount;
     GDALContourItem **papoEntries;
 
+    GDALContourEndIndex oEnds;
+
 public:
     explicit GDALContourLevel( double );
     ~GDALContourLevel();
@@ -106,9 +160,11 @@ public:
     double GetLevel() const { return dfLevel; }
     int    GetContourCount() const { return nEntryCount; }
     GDALContourItem *GetContour( int i) { return papoEntries[i]; }
+    void   UpdateContourEnds( int );
     void   AdjustContour( int );
     void   RemoveContour( int );
     int    FindContour( double dfX, double dfY );
+    int    FindMergeContour( GDALContourItem *poItem );
     int    InsertContour( GDALContourItem * );
 };
 
@@ -154,6 +210,8 @@ class GDALContourGenerator
 
     GDALContourLevel *FindLevel( double dfLevel );
 
+    void   LoadLine( double *padfScanline );
+
 public:
     GDALContourWriter pfnWriter;
     void   *pWriterCBData;
@@ -171,8 +229,15 @@ public:
           dfContourOffset = dfContourOffsetIn; }
 
     void                SetFixedLevels( int, double * );
+    void                PrimeLine( int iPrevLine, double *padfScanline );
     CPLErr              FeedLine( double *padfScanline );
     CPLErr              EjectContours( int bOnlyUnused = FALSE );
+    CPLErr              WriteContour( GDALContourItem *poItem );
+
+    CPLErr              StitchContour( GDALContourItem *poItem,
+                                       double dfTopSeamY,
+                                       double dfBottomSeamY );
+    CPLErr              EjectStitchedContours( double dfSeamY );
 };
 
 template<> inline bool GDALContourGenerator::IsNoData<true>(double dfVal) const
@@ -597,9 +662,11 @@ CPLErr GDALContourGenerator::ProcessRect(
         {
             if( nPoints1 == 1 && nPoints2 == 2 ) // left + bottom
             {
+                // Compare with the upper left corner rather than the upper
+                // right one, which is on the wrong side at saddle points.
                 eErr = AddSegment( dfLevel,
                                    adfX[0], adfY[0], adfX[1], adfY[1],
-                                   dfUpRight > dfLoLeft );
+                                   dfUpLeft > dfLoLeft );
             }
             else if( nPoints1 == 1 && nPoints3 == 2 ) // left + right
             {
@@ -718,9 +785,8 @@ CPLErr GDALContourGenerator::AddSegment( double dfLevel,
     GDALContourItem *poTarget = NULL;
 
 /* -------------------------------------------------------------------- */
-/*      Check all active contours for any that this might attach        */
-/*      to. Eventually this should be recoded to find the contours      */
-/*      of the correct level more efficiently.                          */
+/*      Check the active contours of that level for one that this       */
+/*      might attach to.                                                */
 /* -------------------------------------------------------------------- */
 
     const int iTarget =
@@ -751,6 +817,48 @@ CPLErr GDALContourGenerator::AddSegment( double dfLevel,
     return CE_None;
 }
 
+/************************************************************************/
+/*                              LoadLine()                              */
+/*                                                                      */
+/*      Copy a scanline into the "this line" slot, perturbing any       */
+/*      values that occur exactly on level boundaries.                  */
+/************************************************************************/
+
+void GDALContourGenerator::LoadLine( double *padfScanline )
+
+{
+    memcpy( padfThisLine, padfScanline, sizeof(double) * nWidth );
+
+    for( int iPixel = 0; iPixel < nWidth; iPixel++ )
+    {
+        if( bNoDataActive && padfThisLine[iPixel] == dfNoDataValue )
+            continue;
+
+        const double dfLevel =
+            (padfThisLine[iPixel] - dfContourOffset) / dfContourInterval;
+
+        if( dfLevel - static_cast<int>(dfLevel) == 0.0 )
+        {
+            padfThisLine[iPixel] += dfContourInterval * FUDGE_EXACT;
+        }
+    }
+}
+
+/************************************************************************/
+/*                             PrimeLine()                              */
+/*                                                                      */
+/*      Load the line preceding the first line that will be fed, so     */
+/*      that a generator can process a strip of lines starting in the   */
+/*      middle of the raster.                                           */
+/************************************************************************/
+
+void GDALContourGenerator::PrimeLine( int iPrevLine, double *padfScanline )
+
+{
+    LoadLine( padfScanline );
+    iLine = iPrevLine + 1;
+}
+
 /************************************************************************/
 /*                              FeedLine()                              */
 /************************************************************************/
@@ -776,26 +884,7 @@ CPLErr GDALContourGenerator::FeedLine( double *padfScanline )
     }
     else
     {
-        memcpy( padfThisLine, padfScanline, sizeof(double) * nWidth );
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Perturb any values that occur exactly on level boundaries.      */
-/* -------------------------------------------------------------------- */
-    int iPixel = 0;  // Used after for.
-
-    for( ; iPixel < nWidth; iPixel++ )
-    {
-        if( bNoDataActive && padfThisLine[iPixel] == dfNoDataValue )
-            continue;
-
-        const double dfLevel =
-            (padfThisLine[iPixel] - dfContourOffset) / dfContourInterval;
-
-        if( dfLevel - static_cast<int>(dfLevel) == 0.0 )
-        {
-            padfThisLine[iPixel] += dfContourInterval * FUDGE_EXACT;
-        }
+        LoadLine( padfScanline );
     }
 
 /* -------------------------------------------------------------------- */
@@ -826,7 +915,7 @@ CPLErr GDALContourGenerator::FeedLine( double *padfScanline )
 /*      Process each pixel.                                             */
 /* -------------------------------------------------------------------- */
     const bool bNoDataIsNan = CPL_TO_BOOL(CPLIsNan(dfNoDataValue));
-    for( iPixel = 0; iPixel < nWidth + 1; iPixel++ )
+    for( int iPixel = 0; iPixel < nWidth + 1; iPixel++ )
     {
         const CPLErr eErr = bNoDataIsNan ? ProcessPixel<true>( iPixel ) :
                                            ProcessPixel<false>( iPixel );
@@ -878,30 +967,171 @@ CPLErr GDALContourGenerator::EjectContours( int bOnlyUnused )
             poLevel->RemoveContour( iContour );
 
             // Try to find another contour we can merge with in this level.
-
-            int iC2 = 0;  // Used after for.
-            for( ; iC2 < poLevel->GetContourCount(); iC2++ )
+            const int iC2 = poLevel->FindMergeContour( poTarget );
+            if( iC2 >= 0 && poLevel->GetContour( iC2 )->Merge( poTarget ) )
             {
-                GDALContourItem *poOther = poLevel->GetContour( iC2 );
-
-                if( poOther->Merge( poTarget ) )
-                    break;
+                poLevel->UpdateContourEnds( iC2 );
             }
-
             // If we didn't merge it, then eject (write) it out.
-            if( iC2 == poLevel->GetContourCount() )
+            else
             {
-                if( pfnWriter != NULL )
-                {
-                    // If direction is wrong, then reverse before ejecting.
-                    poTarget->PrepareEjection();
+                eErr = WriteContour( poTarget );
+            }
 
-                    eErr = pfnWriter( poTarget->dfLevel, poTarget->nPoints,
-                                      poTarget->padfX, poTarget->padfY,
-                                      pWriterCBData );
-                }
+            delete poTarget;
+        }
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                            WriteContour()                            */
+/************************************************************************/
+
+CPLErr GDALContourGenerator::WriteContour( GDALContourItem *poItem )
+
+{
+    if( pfnWriter == NULL )
+        return CE_None;
+
+    // If direction is wrong, then reverse before ejecting.
+    poItem->PrepareEjection();
+
+    return pfnWriter( poItem->dfLevel, poItem->nPoints,
+                      poItem->padfX, poItem->padfY, pWriterCBData );
+}
+
+/************************************************************************/
+/*                         ContourEndsOnLine()                          */
+/************************************************************************/
+
+static bool ContourEndsOnLine( const GDALContourItem *poItem, double dfY )
+
+{
+    return fabs(poItem->padfY[0] - dfY) < JOIN_DIST ||
+           fabs(poItem->padfY[poItem->nPoints-1] - dfY) < JOIN_DIST;
+}
+
+/************************************************************************/
+/*                            IsSeamSliver()                            */
+/*                                                                      */
+/*      Whether a contour is a sliver shorter than JOIN_DIST whose      */
+/*      two ends are on the passed seam.  Such pieces come from DEM     */
+/*      values on or very near a level along the seam, and have no      */
+/*      counterpart in the output computed in a single pass.            */
+/************************************************************************/
+
+static bool IsSeamSliver( const GDALContourItem *poItem, double dfSeamY )
+
+{
+    if( dfSeamY < 0 ||
+        fabs(poItem->padfY[0] - dfSeamY) >= JOIN_DIST ||
+        fabs(poItem->padfY[poItem->nPoints-1] - dfSeamY) >= JOIN_DIST )
+        return false;
+
+    double dfLength = 0.0;
+    for( int i = 1; i < poItem->nPoints && dfLength < JOIN_DIST; i++ )
+        dfLength += sqrt( GDALContourItem::DistanceSqr(
+            poItem->padfX[i-1], poItem->padfY[i-1],
+            poItem->padfX[i], poItem->padfY[i] ) );
+
+    return dfLength < JOIN_DIST;
+}
+
+/************************************************************************/
+/*                           StitchContour()                            */
+/*                                                                      */
+/*      Add a contour computed on a strip of lines, whose top and       */
+/*      bottom seams are at the passed Y (or negative for raster        */
+/*      edges), and join it to the contours of the previous strips it   */
+/*      connects to.  Contours not reaching any seam are written right  */
+/*      away, and slivers lying on a seam are absorbed by the contour   */
+/*      they touch or dropped.  Takes ownership of the contour.         */
+/************************************************************************/
+
+CPLErr GDALContourGenerator::StitchContour( GDALContourItem *poItem,
+                                            double dfTopSeamY,
+                                            double dfBottomSeamY )
+
+{
+    if( IsSeamSliver( poItem, dfTopSeamY ) ||
+        IsSeamSliver( poItem, dfBottomSeamY ) )
+    {
+        GDALContourLevel *poLevel = FindLevel( poItem->dfLevel );
+        const int iOther = poLevel->FindMergeContour( poItem );
+        if( iOther >= 0 && poLevel->GetContour( iOther )->Merge( poItem ) )
+            poLevel->AdjustContour( iOther );
+        delete poItem;
+        return CE_None;
+    }
+
+    if( (dfTopSeamY < 0 || !ContourEndsOnLine( poItem, dfTopSeamY )) &&
+        (dfBottomSeamY < 0 || !ContourEndsOnLine( poItem, dfBottomSeamY )) )
+    {
+        const CPLErr eErr = WriteContour( poItem );
+        delete poItem;
+        return eErr;
+    }
+
+    GDALContourLevel *poLevel = FindLevel( poItem->dfLevel );
+
+    while( true )
+    {
+        const int iOther = poLevel->FindMergeContour( poItem );
+        if( iOther < 0 )
+            break;
+
+        GDALContourItem *poOther = poLevel->GetContour( iOther );
+        poLevel->RemoveContour( iOther );
+
+        // Merge the shortest contour into the longest one.
+        if( poOther->nPoints > poItem->nPoints )
+            std::swap( poItem, poOther );
+        if( !poItem->Merge( poOther ) )
+        {
+            poLevel->InsertContour( poOther );
+            break;
+        }
+        delete poOther;
+    }
+
+    poLevel->InsertContour( poItem );
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                       EjectStitchedContours()                        */
+/*                                                                      */
+/*      Write the stitched contours which do not end on the passed      */
+/*      seam, and thus cannot be joined any longer.  All of them are    */
+/*      written if the seam is negative.                                */
+/************************************************************************/
+
+CPLErr GDALContourGenerator::EjectStitchedContours( double dfSeamY )
+
+{
+    CPLErr eErr = CE_None;
+
+    for( int iLevel = 0; iLevel < nLevelCount && eErr == CE_None; iLevel++ )
+    {
+        GDALContourLevel *poLevel = papoLevels[iLevel];
+
+        for( int iContour = 0;
+             iContour < poLevel->GetContourCount() && eErr == CE_None;
+             /* increment in loop if we don't consume it. */ )
+        {
+            GDALContourItem *poTarget = poLevel->GetContour( iContour );
+
+            if( dfSeamY >= 0 && ContourEndsOnLine( poTarget, dfSeamY ) )
+            {
+                iContour++;
+                continue;
             }
 
+            poLevel->RemoveContour( iContour );
+            eErr = WriteContour( poTarget );
             delete poTarget;
         }
     }
@@ -986,6 +1216,30 @@ GDALContourLevel::~GDALContourLevel()
     CPLFree( papoEntries );
 }
 
+/************************************************************************/
+/*                         UpdateContourEnds()                          */
+/*                                                                      */
+/*      Assume the indicated contour's ends may have changed, and       */
+/*      update the end index accordingly.                               */
+/************************************************************************/
+
+void GDALContourLevel::UpdateContourEnds( int iChanged )
+
+{
+    GDALContourItem *poItem = papoEntries[iChanged];
+
+    oEnds.Remove( poItem->dfHeadX, poItem->dfHeadY, poItem, false );
+    oEnds.Remove( poItem->dfTailX, poItem->dfTailY, poItem, true );
+
+    poItem->dfHeadX = poItem->padfX[0];
+    poItem->dfHeadY = poItem->padfY[0];
+    poItem->dfTailX = poItem->padfX[poItem->nPoints-1];
+    poItem->dfTailY = poItem->padfY[poItem->nPoints-1];
+
+    oEnds.Insert( poItem->dfHeadX, poItem->dfHeadY, poItem, false );
+    oEnds.Insert( poItem->dfTailX, poItem->dfTailY, poItem, true );
+}
+
 /************************************************************************/
 /*                           AdjustContour()                            */
 /*                                                                      */
@@ -997,12 +1251,16 @@ GDALContourLevel::~GDALContourLevel()
 void GDALContourLevel::AdjustContour( int iChanged )
 
 {
+    UpdateContourEnds( iChanged );
+
     while( iChanged > 0
          && papoEntries[iChanged]->dfTailX < papoEntries[iChanged-1]->dfTailX )
     {
         GDALContourItem *poTemp = papoEntries[iChanged];
         papoEntries[iChanged] = papoEntries[iChanged-1];
         papoEntries[iChanged-1] = poTemp;
+        papoEntries[iChanged]->nIndex = iChanged;
+        papoEntries[iChanged-1]->nIndex = iChanged-1;
         iChanged--;
     }
 
@@ -1012,6 +1270,8 @@ void GDALContourLevel::AdjustContour( int iChanged )
         GDALContourItem *poTemp = papoEntries[iChanged];
         papoEntries[iChanged] = papoEntries[iChanged+1];
         papoEntries[iChanged+1] = poTemp;
+        papoEntries[iChanged]->nIndex = iChanged;
+        papoEntries[iChanged+1]->nIndex = iChanged+1;
         iChanged++;
     }
 }
@@ -1023,10 +1283,18 @@ void GDALContourLevel::AdjustContour( int iChanged )
 void GDALContourLevel::RemoveContour( int iTarget )
 
 {
+    GDALContourItem *poItem = papoEntries[iTarget];
+
+    oEnds.Remove( poItem->dfHeadX, poItem->dfHeadY, poItem, false );
+    oEnds.Remove( poItem->dfTailX, poItem->dfTailY, poItem, true );
+
     if( iTarget < nEntryCount )
         memmove( papoEntries + iTarget, papoEntries + iTarget + 1,
                  (nEntryCount - iTarget - 1) * sizeof(void*) );
     nEntryCount--;
+
+    for( int i = iTarget; i < nEntryCount; i++ )
+        papoEntries[i]->nIndex = i;
 }
 
 /************************************************************************/
@@ -1077,6 +1345,31 @@ int GDALContourLevel::FindContour( double dfX, double dfY )
     return -1;
 }
 
+/************************************************************************/
+/*                          FindMergeContour()                          */
+/*                                                                      */
+/*      Find the first contour that the passed contour, which must      */
+/*      not be part of this level, can be merged with.  This is the     */
+/*      same contour as the first one of the list for which             */
+/*      GDALContourItem::Merge() succeeds.  If not available return     */
+/*      -1.                                                             */
+/************************************************************************/
+
+int GDALContourLevel::FindMergeContour( GDALContourItem *poOther )
+
+{
+    GDALContourItem *poItem =
+        oEnds.Find( poOther->padfX[0], poOther->padfY[0] );
+    GDALContourItem *poItem2 =
+        oEnds.Find( poOther->padfX[poOther->nPoints-1],
+                    poOther->padfY[poOther->nPoints-1] );
+    if( poItem == NULL ||
+        (poItem2 != NULL && poItem2->nIndex < poItem->nIndex) )
+        poItem = poItem2;
+
+    return poItem != NULL ? poItem->nIndex : -1;
+}
+
 /************************************************************************/
 /*                           InsertContour()                            */
 /*                                                                      */
@@ -1121,7 +1414,8 @@ int GDALContourLevel::InsertContour( GDALContourItem *poNewContour )
     }
 
 /* -------------------------------------------------------------------- */
-/*      Insert the new contour at the appropriate location.             */
+/*      Insert the new contour at the appropriate location, and index   */
+/*      its ends.                                                       */
 /* -------------------------------------------------------------------- */
     if( nEntryCount - nEnd - 1 > 0 )
         memmove( papoEntries + nEnd + 2, papoEntries + nEnd + 1,
@@ -1129,9 +1423,178 @@ int GDALContourLevel::InsertContour( GDALContourItem *poNewContour )
     papoEntries[nEnd+1] = poNewContour;
     nEntryCount++;
 
+    for( int i = nEnd + 1; i < nEntryCount; i++ )
+        papoEntries[i]->nIndex = i;
+
+    poNewContour->dfHeadX = poNewContour->padfX[0];
+    poNewContour->dfHeadY = poNewContour->padfY[0];
+    poNewContour->dfTailX = poNewContour->padfX[poNewContour->nPoints-1];
+    poNewContour->dfTailY = poNewContour->padfY[poNewContour->nPoints-1];
+
+    oEnds.Insert( poNewContour->dfHeadX, poNewContour->dfHeadY,
+                  poNewContour, false );
+    oEnds.Insert( poNewContour->dfTailX, poNewContour->dfTailY,
+                  poNewContour, true );
+
     return nEnd+1;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*                         GDALContourEndIndex                          */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                        GDALContourEndIndex()                         */
+/************************************************************************/
+
+GDALContourEndIndex::GDALContourEndIndex() :
+    anBuckets(64, -1),
+    nFreeNode(-1),
+    nCount(0)
+{}
+
+/************************************************************************/
+/*                               Bucket()                               */
+/************************************************************************/
+
+int GDALContourEndIndex::Bucket( GIntBig nCellX, GIntBig nCellY ) const
+
+{
+    const GUIntBig nHash =
+        static_cast<GUIntBig>(nCellX) * 73856093U ^
+        static_cast<GUIntBig>(nCellY) * 19349663U;
+
+    // The bucket count is a power of two.
+    return static_cast<int>(nHash & (anBuckets.size() - 1));
+}
+
+/************************************************************************/
+/*                               Rehash()                               */
+/************************************************************************/
+
+void GDALContourEndIndex::Rehash()
+
+{
+    anBuckets.assign( anBuckets.size() * 2, -1 );
+
+    for( int i = 0; i < static_cast<int>(asNodes.size()); i++ )
+    {
+        Node &sNode = asNodes[i];
+        if( sNode.poItem == NULL )
+            continue;
+
+        const int iBucket = Bucket( Cell(sNode.dfX), Cell(sNode.dfY) );
+        sNode.nNext = anBuckets[iBucket];
+        anBuckets[iBucket] = i;
+    }
+}
+
+/************************************************************************/
+/*                               Insert()                               */
+/************************************************************************/
+
+void GDALContourEndIndex::Insert( double dfX, double dfY,
+                                  GDALContourItem *poItem, bool bTail )
+
+{
+    if( nCount >= static_cast<int>(anBuckets.size()) )
+        Rehash();
+
+    int iNode = nFreeNode;
+    if( iNode >= 0 )
+    {
+        nFreeNode = asNodes[iNode].nNext;
+    }
+    else
+    {
+        iNode = static_cast<int>(asNodes.size());
+        asNodes.resize( asNodes.size() + 1 );
+    }
+
+    const int iBucket = Bucket( Cell(dfX), Cell(dfY) );
+    Node &sNode = asNodes[iNode];
+    sNode.dfX = dfX;
+    sNode.dfY = dfY;
+    sNode.poItem = poItem;
+    sNode.bTail = bTail;
+    sNode.nNext = anBuckets[iBucket];
+    anBuckets[iBucket] = iNode;
+    nCount++;
+}
+
+/************************************************************************/
+/*                               Remove()                               */
+/************************************************************************/
+
+void GDALContourEndIndex::Remove( double dfX, double dfY,
+                                  GDALContourItem *poItem, bool bTail )
+
+{
+    int *pnLink = &anBuckets[Bucket( Cell(dfX), Cell(dfY) )];
+
+    while( *pnLink >= 0 )
+    {
+        Node &sNode = asNodes[*pnLink];
+        if( sNode.poItem == poItem && sNode.bTail == bTail )
+        {
+            const int iNode = *pnLink;
+            *pnLink = sNode.nNext;
+            sNode.poItem = NULL;
+            sNode.nNext = nFreeNode;
+            nFreeNode = iNode;
+            nCount--;
+            return;
+        }
+        pnLink = &sNode.nNext;
+    }
+
+    CPLAssert( false );
+}
+
+/************************************************************************/
+/*                                Find()                                */
+/*                                                                      */
+/*      Find the first contour of the level, in list order, with an     */
+/*      end within JOIN_DIST of the passed location, as tested by       */
+/*      GDALContourItem::MergeCase().                                   */
+/************************************************************************/
+
+GDALContourItem *GDALContourEndIndex::Find( double dfX, double dfY ) const
+
+{
+    // Look a bit further than JOIN_DIST, so that rounding in Cell() does
+    // not miss ends at exactly JOIN_DIST.
+    const GIntBig nMinCellX = Cell(dfX - 2 * JOIN_DIST);
+    const GIntBig nMaxCellX = Cell(dfX + 2 * JOIN_DIST);
+    const GIntBig nMinCellY = Cell(dfY - 2 * JOIN_DIST);
+    const GIntBig nMaxCellY = Cell(dfY + 2 * JOIN_DIST);
+
+    GDALContourItem *poFound = NULL;
+    for( GIntBig nCellY = nMinCellY; nCellY <= nMaxCellY; nCellY++ )
+    {
+        for( GIntBig nCellX = nMinCellX; nCellX <= nMaxCellX; nCellX++ )
+        {
+            for( int iNode = anBuckets[Bucket( nCellX, nCellY )];
+                 iNode >= 0;
+                 iNode = asNodes[iNode].nNext )
+            {
+                const Node &sNode = asNodes[iNode];
+                if( (poFound == NULL || sNode.poItem->nIndex < poFound->nIndex)
+                    && GDALContourItem::DistanceSqr(
+                           sNode.dfX, sNode.dfY, dfX, dfY ) <=
+                       JOIN_DIST * JOIN_DIST )
+                {
+                    poFound = sNode.poItem;
+                }
+            }
+        }
+    }
+
+    return poFound;
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                           GDALContourItem                            */
@@ -1150,7 +1613,11 @@ GDALContourItem::GDALContourItem( double dfLevelIn ) :
     padfX(NULL),
     padfY(NULL),
     bLeftIsHigh(false),
-    dfTailX(0.0)
+    nIndex(-1),
+    dfHeadX(0.0),
+    dfHeadY(0.0),
+    dfTailX(0.0),
+    dfTailY(0.0)
 {}
 
 /************************************************************************/
@@ -1188,8 +1655,6 @@ int GDALContourItem::AddSegment( double dfXStart, double dfYStart,
         padfY[1] = dfYEnd;
         bRecentlyAccessed = true;
 
-        dfTailX = padfX[1];
-
         // Here we know that the left of this vector is the high side.
         bLeftIsHigh = CPL_TO_BOOL(bLeftHigh);
 
@@ -1208,8 +1673,6 @@ int GDALContourItem::AddSegment( double dfXStart, double dfYStart,
 
         bRecentlyAccessed = true;
 
-        dfTailX = dfXEnd;
-
         return TRUE;
     }
     else if( fabs(padfX[nPoints-1]-dfXEnd) < JOIN_DIST
@@ -1221,8 +1684,6 @@ int GDALContourItem::AddSegment( double dfXStart, double dfYStart,
 
         bRecentlyAccessed = true;
 
-        dfTailX = dfXStart;
-
         return TRUE;
     }
 
@@ -1336,8 +1797,6 @@ int GDALContourItem::Merge( GDALContourItem *poOther )
 
             bRecentlyAccessed = true;
 
-            dfTailX = padfX[nPoints-1];
-
             rc = true;
             break;
 
@@ -1356,8 +1815,6 @@ int GDALContourItem::Merge( GDALContourItem *poOther )
 
             bRecentlyAccessed = true;
 
-            dfTailX = padfX[nPoints-1];
-
             rc = true;
             break;
 
@@ -1374,8 +1831,6 @@ int GDALContourItem::Merge( GDALContourItem *poOther )
 
             bRecentlyAccessed = true;
 
-            dfTailX = padfX[nPoints-1];
-
             rc = true;
             break;
 
@@ -1397,8 +1852,6 @@ int GDALContourItem::Merge( GDALContourItem *poOther )
 
             bRecentlyAccessed = true;
 
-            dfTailX = padfX[nPoints-1];
-
             rc = true;
             break;
 
@@ -1493,6 +1946,273 @@ CPLErr OGRContourWriter( double dfLevel,
     return eErr == OGRERR_NONE ? CE_None : CE_Failure;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*                     Contouring by strips of lines                    */
+/*                                                                      */
+/*      The raster is split in strips of lines, contoured in parallel   */
+/*      by separate generators.  Contours reaching the seams between    */
+/*      strips are then joined by the generator of the calling thread,  */
+/*      through the same end point hashing as single strip contouring.  */
+/* ==================================================================== */
+/************************************************************************/
+
+struct GDALContourStripJob
+{
+    int     nWidth;
+    int     nHeight;
+    int     iStartLine;
+    int     nLines;
+    // The line before iStartLine if not the first one, then the strip.
+    double *padfLines;
+
+    double  dfContourInterval;
+    double  dfContourBase;
+    int     nFixedLevelCount;
+    double *padfFixedLevels;
+    int     bUseNoData;
+    double  dfNoDataValue;
+
+    CPLErr  eErr;
+    std::vector<GDALContourItem *> apoContours;
+};
+
+/************************************************************************/
+/*                       GDALContourStripWriter()                       */
+/*                                                                      */
+/*      Collect the contours of a strip, already oriented.              */
+/************************************************************************/
+
+static CPLErr GDALContourStripWriter( double dfLevel, int nPoints,
+                                      double *padfX, double *padfY,
+                                      void *pInfo )
+
+{
+    GDALContourStripJob *psJob = static_cast<GDALContourStripJob *>(pInfo);
+
+    GDALContourItem *poItem = new GDALContourItem( dfLevel );
+    poItem->MakeRoomFor( nPoints );
+    memcpy( poItem->padfX, padfX, sizeof(double) * nPoints );
+    memcpy( poItem->padfY, padfY, sizeof(double) * nPoints );
+    poItem->nPoints = nPoints;
+
+    psJob->apoContours.push_back( poItem );
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                      GDALContourStripJobFunc()                       */
+/************************************************************************/
+
+static void GDALContourStripJobFunc( void *pData )
+
+{
+    GDALContourStripJob *psJob = static_cast<GDALContourStripJob *>(pData);
+
+    GDALContourGenerator oCG( psJob->nWidth, psJob->nHeight,
+                              GDALContourStripWriter, psJob );
+    if( !oCG.Init() )
+    {
+        psJob->eErr = CE_Failure;
+        return;
+    }
+
+    if( psJob->nFixedLevelCount > 0 )
+        oCG.SetFixedLevels( psJob->nFixedLevelCount, psJob->padfFixedLevels );
+    else
+        oCG.SetContourLevels( psJob->dfContourInterval,
+                              psJob->dfContourBase );
+
+    if( psJob->bUseNoData )
+        oCG.SetNoData( psJob->dfNoDataValue );
+
+    double *padfLine = psJob->padfLines;
+    if( psJob->iStartLine > 0 )
+    {
+        oCG.PrimeLine( psJob->iStartLine - 1, padfLine );
+        padfLine += psJob->nWidth;
+    }
+
+    CPLErr eErr = CE_None;
+    for( int iLine = 0; iLine < psJob->nLines && eErr == CE_None; iLine++ )
+        eErr = oCG.FeedLine( padfLine +
+                             static_cast<size_t>(iLine) * psJob->nWidth );
+
+    // Strips but the last one end with contours still open.
+    if( eErr == CE_None &&
+        psJob->iStartLine + psJob->nLines < psJob->nHeight )
+        eErr = oCG.EjectContours( FALSE );
+
+    psJob->eErr = eErr;
+}
+
+/************************************************************************/
+/*                      GDALContourGenerateStrips()                     */
+/************************************************************************/
+
+static CPLErr
+GDALContourGenerateStrips( GDALRasterBandH hBand, GDALContourGenerator &oCG,
+                           double dfContourInterval, double dfContourBase,
+                           int nFixedLevelCount, double *padfFixedLevels,
+                           int bUseNoData, double dfNoDataValue,
+                           int nThreads,
+                           GDALProgressFunc pfnProgress, void *pProgressArg )
+
+{
+    const int nXSize = GDALGetRasterBandXSize( hBand );
+    const int nYSize = GDALGetRasterBandYSize( hBand );
+
+/* -------------------------------------------------------------------- */
+/*      Strips of a group are processed concurrently.  Keep the buffers */
+/*      of a group within 64 MB, but make strips long enough to keep    */
+/*      the number of contours cut at the seams low.                    */
+/* -------------------------------------------------------------------- */
+    const GIntBig nMaxBufferLines =
+        static_cast<GIntBig>(64 * 1024 * 1024 / sizeof(double)) /
+        (static_cast<GIntBig>(nThreads) * nXSize);
+    const int nStripLines =
+        std::max(16, std::min(static_cast<int>(
+                                  std::min(nMaxBufferLines,
+                                           static_cast<GIntBig>(1024))),
+                              (nYSize + nThreads - 1) / nThreads));
+    const int nStrips = (nYSize + nStripLines - 1) / nStripLines;
+    const int nGroupStrips = std::min(nThreads, nStrips);
+
+    CPLDebug( "CONTOUR", "Contouring %d strips of %d lines with %d threads",
+              nStrips, nStripLines, nGroupStrips );
+
+    CPLErr eErr = CE_None;
+    std::vector<GDALContourStripJob> asJobs( nGroupStrips );
+    for( int i = 0; i < nGroupStrips; i++ )
+    {
+        GDALContourStripJob &sJob = asJobs[i];
+        sJob.nWidth = nXSize;
+        sJob.nHeight = nYSize;
+        sJob.dfContourInterval = dfContourInterval;
+        sJob.dfContourBase = dfContourBase;
+        sJob.nFixedLevelCount = nFixedLevelCount;
+        sJob.padfFixedLevels = padfFixedLevels;
+        sJob.bUseNoData = bUseNoData;
+        sJob.dfNoDataValue = dfNoDataValue;
+        sJob.padfLines = static_cast<double *>(
+            VSI_MALLOC3_VERBOSE(sizeof(double), nXSize, nStripLines + 1));
+        if( sJob.padfLines == NULL )
+            eErr = CE_Failure;
+    }
+
+    CPLWorkerThreadPool *poThreadPool = NULL;
+    if( eErr == CE_None )
+    {
+        poThreadPool = new (std::nothrow) CPLWorkerThreadPool();
+        if( poThreadPool == NULL ||
+            !poThreadPool->Setup(nGroupStrips, NULL, NULL) )
+        {
+            // Strips will be contoured sequentially.
+            delete poThreadPool;
+            poThreadPool = NULL;
+        }
+    }
+
+    for( int iFirstStrip = 0; iFirstStrip < nStrips && eErr == CE_None;
+         iFirstStrip += nGroupStrips )
+    {
+        const int nJobs = std::min(nGroupStrips, nStrips - iFirstStrip);
+
+/* -------------------------------------------------------------------- */
+/*      Read the lines of the strips, each with the line before.        */
+/* -------------------------------------------------------------------- */
+        for( int i = 0; i < nJobs && eErr == CE_None; i++ )
+        {
+            GDALContourStripJob &sJob = asJobs[i];
+            sJob.iStartLine = (iFirstStrip + i) * nStripLines;
+            sJob.nLines = std::min(nStripLines, nYSize - sJob.iStartLine);
+            sJob.eErr = CE_None;
+
+            const int iReadLine = std::max(0, sJob.iStartLine - 1);
+            const int nReadLines =
+                sJob.iStartLine + sJob.nLines - iReadLine;
+            eErr = GDALRasterIO( hBand, GF_Read, 0, iReadLine,
+                                 nXSize, nReadLines, sJob.padfLines,
+                                 nXSize, nReadLines, GDT_Float64, 0, 0 );
+        }
+        if( eErr != CE_None )
+            break;
+
+/* -------------------------------------------------------------------- */
+/*      Contour them.                                                   */
+/* -------------------------------------------------------------------- */
+        if( poThreadPool != NULL && nJobs > 1 )
+        {
+            for( int i = 0; i < nJobs; i++ )
+                poThreadPool->SubmitJob( GDALContourStripJobFunc, &asJobs[i] );
+            poThreadPool->WaitCompletion();
+        }
+        else
+        {
+            for( int i = 0; i < nJobs; i++ )
+                GDALContourStripJobFunc( &asJobs[i] );
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Join and write their contours in order.  The seams are at the   */
+/*      center of the last line of each strip.                          */
+/* -------------------------------------------------------------------- */
+        for( int i = 0; i < nJobs; i++ )
+        {
+            GDALContourStripJob &sJob = asJobs[i];
+            if( eErr == CE_None )
+                eErr = sJob.eErr;
+
+            const double dfTopSeamY =
+                sJob.iStartLine > 0 ? sJob.iStartLine - 0.5 : -1.0;
+            const int iEndLine = sJob.iStartLine + sJob.nLines;
+            const double dfBottomSeamY =
+                iEndLine < nYSize ? iEndLine - 0.5 : -1.0;
+
+            for( size_t j = 0; j < sJob.apoContours.size(); j++ )
+            {
+                if( eErr == CE_None )
+                    eErr = oCG.StitchContour( sJob.apoContours[j],
+                                              dfTopSeamY, dfBottomSeamY );
+                else
+                    delete sJob.apoContours[j];
+            }
+            sJob.apoContours.clear();
+
+            if( eErr == CE_None )
+                eErr = oCG.EjectStitchedContours( dfBottomSeamY );
+        }
+
+        if( eErr == CE_None &&
+            !pfnProgress( (iFirstStrip + nJobs) / static_cast<double>(nStrips),
+                          "", pProgressArg ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Cleanup.  Stitched contours left after an error are dropped.    */
+/* -------------------------------------------------------------------- */
+    if( eErr != CE_None )
+    {
+        oCG.pfnWriter = NULL;
+        oCG.EjectStitchedContours( -1.0 );
+    }
+
+    delete poThreadPool;
+    for( int i = 0; i < nGroupStrips; i++ )
+    {
+        for( size_t j = 0; j < asJobs[i].apoContours.size(); j++ )
+            delete asJobs[i].apoContours[j];
+        CPLFree( asJobs[i].padfLines );
+    }
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                        GDALContourGenerate()                         */
 /************************************************************************/
@@ -1587,6 +2307,16 @@ an averaged value from the two nearby points (in this case (12+3+5)/3).
 
 \endverbatim
 
+PARALLEL PROCESSING
+
+Starting with GDAL 2.3, if the GDAL_NUM_THREADS configuration option is set
+to a value greater than 1 (or ALL_CPUS), the raster is split into horizontal
+strips that are contoured concurrently by that number of worker threads, and
+the contour pieces ending on the strip borders are then joined.  The
+resulting lines are the same as with a single thread, but features may be
+written in a different order, and closed rings may start at a different
+vertex.
+
  *
  * @param hBand The band to read raster data from.  The whole band will be
  * processed.
@@ -1690,6 +2420,23 @@ CPLErr GDALContourGenerate( GDALRasterBandH hBand,
     if( bUseNoData )
         oCG.SetNoData( dfNoDataValue );
 
+/* -------------------------------------------------------------------- */
+/*      Contour strips of the raster in parallel if several threads     */
+/*      are requested.                                                  */
+/* -------------------------------------------------------------------- */
+    const char *pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    const int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                                CPLGetNumCPUs() : atoi(pszNumThreads);
+    if( nThreads > 1 && nYSize > 1 )
+    {
+        return GDALContourGenerateStrips( hBand, oCG,
+                                          dfContourInterval, dfContourBase,
+                                          nFixedLevelCount, padfFixedLevels,
+                                          bUseNoData, dfNoDataValue,
+                                          nThreads, pfnProgress,
+                                          pProgressArg );
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Feed the data into the contour generator.                       */
 /* -------------------------------------------------------------------- */
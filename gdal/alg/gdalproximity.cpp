@@ -30,16 +30,20 @@
 #include "cpl_port.h"
 #include "gdal_alg.h"
 
+#include <cfloat>
 #include <cmath>
 #include <cstdlib>
 
 #include <algorithm>
+#include <new>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 
 CPL_CVSID("$Id$");
@@ -50,6 +54,17 @@ ProcessProximityLine( GInt32 *panSrcScanline, int *panNearX, int *panNearY,
                       float *pafProximity, double *pdfSrcNoDataValue,
                       int nTargetValues, int *panTargetValues );
 
+static CPLErr
+ComputeProximityExact( GDALRasterBandH hSrcBand,
+                       GDALRasterBandH hProximityBand,
+                       int nTargetValues, int *panTargetValues,
+                       double *pdfSrcNoDataValue,
+                       double dfPixelXSize, double dfPixelYSize,
+                       double dfMaxDist, float fNoDataValue,
+                       bool bFixedBufVal, double dfFixedBufVal,
+                       int nThreads,
+                       GDALProgressFunc pfnProgress, void * pProgressArg );
+
 /************************************************************************/
 /*                        GDALComputeProximity()                        */
 /************************************************************************/
@@ -106,6 +121,22 @@ the proximity output.
 
 If this option is set, all pixels within the MAXDIST threadhold are
 set to this fixed value instead of to a proximity distance.
+
+  DISTMETHOD=[APPROX]/EXACT
+
+(GDAL &gt;= 2.3) Selects how distances are computed.  APPROX, the default,
+propagates the nearest target along scanlines in two passes, which is fast
+but may overestimate some distances.  EXACT computes the exact Euclidean
+distance transform in a row pass followed by a column pass, reading the
+source once.  Intermediate values are kept in a tiled temporary file so
+that rasters larger than memory can be processed.  With DISTUNITS=GEO,
+non square pixels are accounted for.
+
+  NUM_THREADS=n/ALL_CPUS
+
+(GDAL &gt;= 2.3) Number of threads used by DISTMETHOD=EXACT to process
+rows and columns in parallel.  Defaults to the GDAL_NUM_THREADS
+configuration option, or 1.
 */
 
 CPLErr CPL_STDCALL
@@ -122,11 +153,33 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
     if( pfnProgress == NULL )
         pfnProgress = GDALDummyProgress;
 
+/* -------------------------------------------------------------------- */
+/*      Which method do we use to compute distances?                    */
+/* -------------------------------------------------------------------- */
+    bool bExact = false;
+    const char *pszOpt = CSLFetchNameValue( papszOptions, "DISTMETHOD" );
+    if( pszOpt )
+    {
+        if( EQUAL(pszOpt, "EXACT") )
+            bExact = true;
+        else if( !EQUAL(pszOpt, "APPROX") )
+        {
+            CPLError(
+                CE_Failure, CPLE_AppDefined,
+                "Unrecognized DISTMETHOD value '%s', should be APPROX or "
+                "EXACT.",
+                pszOpt );
+            return CE_Failure;
+        }
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Are we using pixels or georeferenced coordinates for distances? */
 /* -------------------------------------------------------------------- */
     double dfDistMult = 1.0;
-    const char *pszOpt = CSLFetchNameValue( papszOptions, "DISTUNITS" );
+    double dfPixelXSize = 1.0;
+    double dfPixelYSize = 1.0;
+    pszOpt = CSLFetchNameValue( papszOptions, "DISTUNITS" );
     if( pszOpt )
     {
         if( EQUAL(pszOpt, "GEO") )
@@ -137,12 +190,25 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
                 double adfGeoTransform[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
 
                 GDALGetGeoTransform( hSrcDS, adfGeoTransform );
-                if( std::abs(adfGeoTransform[1]) !=
+                if( !bExact &&
+                    std::abs(adfGeoTransform[1]) !=
                     std::abs(adfGeoTransform[5]) )
                     CPLError(
                         CE_Warning, CPLE_AppDefined,
                         "Pixels not square, distances will be inaccurate." );
                 dfDistMult = std::abs(adfGeoTransform[1]);
+                dfPixelXSize = std::abs(adfGeoTransform[1]);
+                dfPixelYSize = std::abs(adfGeoTransform[5]);
+                // Rotated geotransforms: fall back to square pixels.
+                if( dfPixelXSize == 0.0 )
+                    dfPixelXSize = dfPixelYSize;
+                if( dfPixelYSize == 0.0 )
+                    dfPixelYSize = dfPixelXSize;
+                if( dfPixelXSize == 0.0 )
+                {
+                    dfPixelXSize = 1.0;
+                    dfPixelYSize = 1.0;
+                }
             }
         }
         else if( !EQUAL(pszOpt, "PIXEL") )
@@ -253,6 +319,33 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
         return CE_Failure;
     }
 
+/* -------------------------------------------------------------------- */
+/*      The exact distance transform has its own processing, with a     */
+/*      MAXDIST kept in distance units.                                 */
+/* -------------------------------------------------------------------- */
+    if( bExact )
+    {
+        pszOpt = CSLFetchNameValue( papszOptions, "NUM_THREADS" );
+        if( pszOpt == NULL )
+            pszOpt = CPLGetConfigOption( "GDAL_NUM_THREADS", "1" );
+        const int nThreads = EQUAL(pszOpt, "ALL_CPUS") ?
+                                CPLGetNumCPUs() : atoi(pszOpt);
+
+        pszOpt = CSLFetchNameValue( papszOptions, "MAXDIST" );
+        const CPLErr eErr =
+            ComputeProximityExact( hSrcBand, hProximityBand,
+                                   nTargetValues, panTargetValues,
+                                   pdfSrcNoData,
+                                   dfPixelXSize, dfPixelYSize,
+                                   pszOpt ? CPLAtof(pszOpt) : -1.0,
+                                   fNoDataValue,
+                                   bFixedBufVal, dfFixedBufVal,
+                                   std::max(1, nThreads),
+                                   pfnProgress, pProgressArg );
+        CPLFree(panTargetValues);
+        return eErr;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      We need a signed type for the working proximity values kept     */
 /*      on disk.  If our proximity band is not signed, then create a    */
@@ -573,3 +666,473 @@ ProcessProximityLine( GInt32 *panSrcScanline, int *panNearX, int *panNearY,
 
     return CE_None;
 }
+
+/************************************************************************/
+/* ==================================================================== */
+/*      Exact Euclidean distance transform.                             */
+/*                                                                      */
+/*      The transform is separable (Meijster et al., Felzenszwalb and   */
+/*      Huttenlocher): a first pass computes for each pixel the         */
+/*      distance to the nearest target pixel of its row, and a second   */
+/*      pass computes for each column the lower envelope of the         */
+/*      parabolas rooted at those row distances.  The row pass goes     */
+/*      through strips of lines and the column pass through strips of   */
+/*      columns of a tiled temporary file, each strip being split       */
+/*      between the worker threads.                                     */
+/* ==================================================================== */
+/************************************************************************/
+
+// Row distances of pixels without any target pixel within reach.
+static const float PROX_EXACT_FAR = FLT_MAX;
+
+typedef struct
+{
+    const GInt32 *panSrc;
+    float        *pafRowDist;
+    int           nXSize;
+    int           nLines;
+    int           nTargetValues;
+    const int    *panTargetValues;
+    const double *pdfSrcNoDataValue;
+    double        dfMaxRowDist;
+} ProximityRowJob;
+
+typedef struct
+{
+    float        *pafColumns;
+    int           nColumns;
+    int           nYSize;
+    double        dfRatio;
+    double        dfPixelYSize;
+    double        dfMaxDist;
+    double       *padfF;
+    int          *panV;
+    double       *padfZ;
+} ProximityColumnJob;
+
+/************************************************************************/
+/*                         IsProximityTarget()                          */
+/************************************************************************/
+
+static bool IsProximityTarget( GInt32 nValue, int nTargetValues,
+                               const int *panTargetValues )
+{
+    if( nTargetValues == 0 )
+        return nValue != 0;
+
+    for( int i = 0; i < nTargetValues; i++ )
+    {
+        if( nValue == panTargetValues[i] )
+            return true;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                       ProximityRowJobFunc()                          */
+/*                                                                      */
+/*      Compute the distance, in pixels, from each pixel to the         */
+/*      nearest target pixel of the same line.  Pixels which are        */
+/*      nodata in the source are flagged by storing -1-distance.        */
+/************************************************************************/
+
+static void ProximityRowJobFunc( void *pData )
+{
+    const ProximityRowJob *psJob = static_cast<ProximityRowJob *>(pData);
+    const int nXSize = psJob->nXSize;
+
+    for( int iLine = 0; iLine < psJob->nLines; iLine++ )
+    {
+        const GInt32 *panSrc =
+            psJob->panSrc + static_cast<size_t>(iLine) * nXSize;
+        float *pafDist =
+            psJob->pafRowDist + static_cast<size_t>(iLine) * nXSize;
+
+        // Left to right: distance to the previous target.
+        int iLastTarget = -1;
+        for( int i = 0; i < nXSize; i++ )
+        {
+            if( IsProximityTarget( panSrc[i], psJob->nTargetValues,
+                                   psJob->panTargetValues ) )
+                iLastTarget = i;
+            pafDist[i] = iLastTarget < 0 ?
+                PROX_EXACT_FAR : static_cast<float>(i - iLastTarget);
+        }
+
+        // Right to left: distance to the next target, and flags.
+        iLastTarget = -1;
+        for( int i = nXSize - 1; i >= 0; i-- )
+        {
+            if( pafDist[i] == 0.0f )
+            {
+                iLastTarget = i;
+                continue;
+            }
+            if( iLastTarget >= 0 && iLastTarget - i < pafDist[i] )
+                pafDist[i] = static_cast<float>(iLastTarget - i);
+            if( pafDist[i] > psJob->dfMaxRowDist )
+                pafDist[i] = PROX_EXACT_FAR;
+            if( psJob->pdfSrcNoDataValue != NULL &&
+                panSrc[i] == *(psJob->pdfSrcNoDataValue) )
+                pafDist[i] = pafDist[i] == PROX_EXACT_FAR ?
+                    -PROX_EXACT_FAR : -1.0f - pafDist[i];
+        }
+    }
+}
+
+/************************************************************************/
+/*                      ProximityColumnJobFunc()                        */
+/*                                                                      */
+/*      Turn the row distances of each column (stored contiguously)     */
+/*      into final distances, or -1 for pixels beyond MAXDIST or        */
+/*      nodata in the source.                                           */
+/************************************************************************/
+
+static void ProximityColumnJobFunc( void *pData )
+{
+    const ProximityColumnJob *psJob =
+        static_cast<ProximityColumnJob *>(pData);
+    const int nYSize = psJob->nYSize;
+    double *padfF = psJob->padfF;
+    int *panV = psJob->panV;
+    double *padfZ = psJob->padfZ;
+
+    for( int iCol = 0; iCol < psJob->nColumns; iCol++ )
+    {
+        float *pafCol = psJob->pafColumns + static_cast<size_t>(iCol) * nYSize;
+
+/* -------------------------------------------------------------------- */
+/*      Squared row distances, in units of the pixel height.            */
+/* -------------------------------------------------------------------- */
+        for( int q = 0; q < nYSize; q++ )
+        {
+            double dfRowDist = pafCol[q];
+            if( dfRowDist < 0.0 )
+                dfRowDist = pafCol[q] == -PROX_EXACT_FAR ?
+                    PROX_EXACT_FAR : -1.0 - dfRowDist;
+            if( dfRowDist == PROX_EXACT_FAR )
+                padfF[q] = HUGE_VAL;
+            else
+                padfF[q] = (dfRowDist * psJob->dfRatio) *
+                           (dfRowDist * psJob->dfRatio);
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Lower envelope of the parabolas y = F(q) + (x - q)^2.  Parabola */
+/*      panV[k] is the lowest between padfZ[k] and padfZ[k+1].          */
+/* -------------------------------------------------------------------- */
+        int k = -1;
+        for( int q = 0; q < nYSize; q++ )
+        {
+            if( padfF[q] == HUGE_VAL )
+                continue;
+
+            double dfS = -HUGE_VAL;
+            while( k >= 0 )
+            {
+                const int r = panV[k];
+                dfS = ((padfF[q] + static_cast<double>(q) * q) -
+                       (padfF[r] + static_cast<double>(r) * r)) /
+                      (2.0 * (q - r));
+                if( dfS > padfZ[k] )
+                    break;
+                k--;
+            }
+            k++;
+            panV[k] = q;
+            padfZ[k] = k == 0 ? -HUGE_VAL : dfS;
+            padfZ[k+1] = HUGE_VAL;
+        }
+
+        if( k < 0 )
+        {
+            for( int p = 0; p < nYSize; p++ )
+                pafCol[p] = -1.0f;
+            continue;
+        }
+
+        k = 0;
+        for( int p = 0; p < nYSize; p++ )
+        {
+            while( padfZ[k+1] < p )
+                k++;
+
+            const bool bSrcNoData = pafCol[p] < 0.0f;
+            const double dfDY = static_cast<double>(p - panV[k]);
+            const double dfDist =
+                psJob->dfPixelYSize * sqrt(dfDY * dfDY + padfF[panV[k]]);
+
+            if( bSrcNoData ||
+                (psJob->dfMaxDist >= 0.0 && dfDist > psJob->dfMaxDist) )
+                pafCol[p] = -1.0f;
+            else
+                pafCol[p] = static_cast<float>(dfDist);
+        }
+    }
+}
+
+/************************************************************************/
+/*                       ComputeProximityExact()                        */
+/************************************************************************/
+
+static CPLErr
+ComputeProximityExact( GDALRasterBandH hSrcBand,
+                       GDALRasterBandH hProximityBand,
+                       int nTargetValues, int *panTargetValues,
+                       double *pdfSrcNoDataValue,
+                       double dfPixelXSize, double dfPixelYSize,
+                       double dfMaxDist, float fNoDataValue,
+                       bool bFixedBufVal, double dfFixedBufVal,
+                       int nThreads,
+                       GDALProgressFunc pfnProgress, void * pProgressArg )
+
+{
+    const int nXSize = GDALGetRasterBandXSize( hSrcBand );
+    const int nYSize = GDALGetRasterBandYSize( hSrcBand );
+
+/* -------------------------------------------------------------------- */
+/*      Create the tiled temporary file holding the row distances,      */
+/*      and then the final distances.                                   */
+/* -------------------------------------------------------------------- */
+    GDALDriverH hDriver = GDALGetDriverByName("GTiff");
+    if( hDriver == NULL )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "GDALComputeProximity needs GTiff driver" );
+        return CE_Failure;
+    }
+
+    const int nTileSize = 256;
+    char **papszCreateOptions = NULL;
+    papszCreateOptions =
+        CSLSetNameValue( papszCreateOptions, "TILED", "YES" );
+    papszCreateOptions =
+        CSLSetNameValue( papszCreateOptions, "BLOCKXSIZE",
+                         CPLSPrintf("%d", nTileSize) );
+    papszCreateOptions =
+        CSLSetNameValue( papszCreateOptions, "BLOCKYSIZE",
+                         CPLSPrintf("%d", nTileSize) );
+    papszCreateOptions =
+        CSLSetNameValue( papszCreateOptions, "BIGTIFF", "IF_SAFER" );
+
+    CPLString osTmpFile = CPLGenerateTempFilename( "proximity" );
+    GDALDatasetH hWorkDS =
+        GDALCreate( hDriver, osTmpFile, nXSize, nYSize, 1, GDT_Float32,
+                    papszCreateOptions );
+    CSLDestroy( papszCreateOptions );
+    if( hWorkDS == NULL )
+        return CE_Failure;
+    GDALRasterBandH hWorkBand = GDALGetRasterBand( hWorkDS, 1 );
+
+    CPLDebug( "GDAL",
+              "Exact proximity: MAXDIST=%g, pixel size=%gx%g, %d thread(s)",
+              dfMaxDist, dfPixelXSize, dfPixelYSize, nThreads );
+
+/* -------------------------------------------------------------------- */
+/*      Allocate strip buffers, per thread workspaces and the pool.     */
+/* -------------------------------------------------------------------- */
+    const int nStripLines = std::min(nTileSize, nYSize);
+    const int nStripColumns = std::min(nTileSize, nXSize);
+    const int nJobs = std::max(1, std::min(nThreads, nTileSize));
+
+    CPLErr eErr = CE_None;
+    GInt32 *panSrc = static_cast<GInt32 *>(
+        VSI_MALLOC3_VERBOSE(sizeof(GInt32), nXSize, nStripLines));
+    float *pafStrip = static_cast<float *>(
+        VSI_MALLOC3_VERBOSE(sizeof(float), nXSize, nStripLines));
+    float *pafColumns = static_cast<float *>(
+        VSI_MALLOC3_VERBOSE(sizeof(float), nYSize, nStripColumns));
+    std::vector<ProximityColumnJob> asColumnJobs(nJobs);
+    for( int i = 0; i < nJobs; i++ )
+    {
+        asColumnJobs[i].padfF = static_cast<double *>(
+            VSI_MALLOC2_VERBOSE(sizeof(double), nYSize));
+        asColumnJobs[i].panV = static_cast<int *>(
+            VSI_MALLOC2_VERBOSE(sizeof(int), nYSize));
+        asColumnJobs[i].padfZ = static_cast<double *>(
+            VSI_MALLOC2_VERBOSE(sizeof(double), nYSize + 1));
+        if( asColumnJobs[i].padfF == NULL || asColumnJobs[i].panV == NULL ||
+            asColumnJobs[i].padfZ == NULL )
+            eErr = CE_Failure;
+    }
+    if( panSrc == NULL || pafStrip == NULL || pafColumns == NULL )
+        eErr = CE_Failure;
+
+    CPLWorkerThreadPool *poThreadPool = NULL;
+    if( eErr == CE_None && nJobs > 1 )
+    {
+        poThreadPool = new (std::nothrow) CPLWorkerThreadPool();
+        if( poThreadPool == NULL || !poThreadPool->Setup(nJobs, NULL, NULL) )
+        {
+            // Strips will be processed by the calling thread only.
+            delete poThreadPool;
+            poThreadPool = NULL;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Row pass: read the source once, strip by strip.                 */
+/* -------------------------------------------------------------------- */
+    // Beyond that distance in a row, no pixel can be within MAXDIST.
+    const double dfMaxRowDist =
+        dfMaxDist >= 0.0 ? dfMaxDist / dfPixelXSize : HUGE_VAL;
+
+    for( int iStart = 0; eErr == CE_None && iStart < nYSize;
+         iStart += nStripLines )
+    {
+        const int nLines = std::min(nStripLines, nYSize - iStart);
+        eErr = GDALRasterIO( hSrcBand, GF_Read, 0, iStart, nXSize, nLines,
+                             panSrc, nXSize, nLines, GDT_Int32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        std::vector<ProximityRowJob> asJobs;
+        const int nJobLines = (nLines + nJobs - 1) / nJobs;
+        for( int iLine = 0; iLine < nLines; iLine += nJobLines )
+        {
+            ProximityRowJob sJob;
+            sJob.panSrc = panSrc + static_cast<size_t>(iLine) * nXSize;
+            sJob.pafRowDist = pafStrip + static_cast<size_t>(iLine) * nXSize;
+            sJob.nXSize = nXSize;
+            sJob.nLines = std::min(nJobLines, nLines - iLine);
+            sJob.nTargetValues = nTargetValues;
+            sJob.panTargetValues = panTargetValues;
+            sJob.pdfSrcNoDataValue = pdfSrcNoDataValue;
+            sJob.dfMaxRowDist = dfMaxRowDist;
+            asJobs.push_back(sJob);
+        }
+
+        if( poThreadPool != NULL && asJobs.size() > 1 )
+        {
+            for( size_t i = 0; i < asJobs.size(); i++ )
+                poThreadPool->SubmitJob( ProximityRowJobFunc, &asJobs[i] );
+            poThreadPool->WaitCompletion();
+        }
+        else
+        {
+            for( size_t i = 0; i < asJobs.size(); i++ )
+                ProximityRowJobFunc( &asJobs[i] );
+        }
+
+        eErr = GDALRasterIO( hWorkBand, GF_Write, 0, iStart, nXSize, nLines,
+                             pafStrip, nXSize, nLines, GDT_Float32, 0, 0 );
+
+        if( eErr == CE_None &&
+            !pfnProgress( 0.4 * (iStart + nLines) / nYSize,
+                          "", pProgressArg ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Column pass: load strips of whole columns, each column being    */
+/*      contiguous in memory, and write back the final distances.       */
+/* -------------------------------------------------------------------- */
+    const GSpacing nPixelSpace =
+        static_cast<GSpacing>(sizeof(float)) * nYSize;
+    const GSpacing nLineSpace = sizeof(float);
+
+    for( int iStart = 0; eErr == CE_None && iStart < nXSize;
+         iStart += nStripColumns )
+    {
+        const int nColumns = std::min(nStripColumns, nXSize - iStart);
+        eErr = GDALRasterIOEx( hWorkBand, GF_Read, iStart, 0, nColumns, nYSize,
+                               pafColumns, nColumns, nYSize, GDT_Float32,
+                               nPixelSpace, nLineSpace, NULL );
+        if( eErr != CE_None )
+            break;
+
+        const int nJobColumns = (nColumns + nJobs - 1) / nJobs;
+        int nColumnJobs = 0;
+        for( int iCol = 0; iCol < nColumns; iCol += nJobColumns )
+        {
+            ProximityColumnJob &sJob = asColumnJobs[nColumnJobs++];
+            sJob.pafColumns = pafColumns + static_cast<size_t>(iCol) * nYSize;
+            sJob.nColumns = std::min(nJobColumns, nColumns - iCol);
+            sJob.nYSize = nYSize;
+            sJob.dfRatio = dfPixelXSize / dfPixelYSize;
+            sJob.dfPixelYSize = dfPixelYSize;
+            sJob.dfMaxDist = dfMaxDist;
+        }
+
+        if( poThreadPool != NULL && nColumnJobs > 1 )
+        {
+            for( int i = 0; i < nColumnJobs; i++ )
+                poThreadPool->SubmitJob( ProximityColumnJobFunc,
+                                         &asColumnJobs[i] );
+            poThreadPool->WaitCompletion();
+        }
+        else
+        {
+            for( int i = 0; i < nColumnJobs; i++ )
+                ProximityColumnJobFunc( &asColumnJobs[i] );
+        }
+
+        eErr = GDALRasterIOEx( hWorkBand, GF_Write, iStart, 0, nColumns,
+                               nYSize, pafColumns, nColumns, nYSize,
+                               GDT_Float32, nPixelSpace, nLineSpace, NULL );
+
+        if( eErr == CE_None &&
+            !pfnProgress( 0.4 + 0.4 * (iStart + nColumns) / nXSize,
+                          "", pProgressArg ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Final pass: post process the distances into the output band.    */
+/* -------------------------------------------------------------------- */
+    for( int iStart = 0; eErr == CE_None && iStart < nYSize;
+         iStart += nStripLines )
+    {
+        const int nLines = std::min(nStripLines, nYSize - iStart);
+        eErr = GDALRasterIO( hWorkBand, GF_Read, 0, iStart, nXSize, nLines,
+                             pafStrip, nXSize, nLines, GDT_Float32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        const size_t nValues = static_cast<size_t>(nXSize) * nLines;
+        for( size_t i = 0; i < nValues; i++ )
+        {
+            if( pafStrip[i] < 0.0f )
+                pafStrip[i] = fNoDataValue;
+            else if( pafStrip[i] > 0.0f && bFixedBufVal )
+                pafStrip[i] = static_cast<float>( dfFixedBufVal );
+        }
+
+        eErr = GDALRasterIO( hProximityBand, GF_Write, 0, iStart, nXSize,
+                             nLines, pafStrip, nXSize, nLines, GDT_Float32,
+                             0, 0 );
+
+        if( eErr == CE_None &&
+            !pfnProgress( 0.8 + 0.2 * (iStart + nLines) / nYSize,
+                          "", pProgressArg ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Cleanup                                                         */
+/* -------------------------------------------------------------------- */
+    delete poThreadPool;
+    for( int i = 0; i < nJobs; i++ )
+    {
+        CPLFree( asColumnJobs[i].padfF );
+        CPLFree( asColumnJobs[i].panV );
+        CPLFree( asColumnJobs[i].padfZ );
+    }
+    CPLFree( panSrc );
+    CPLFree( pafStrip );
+    CPLFree( pafColumns );
+
+    GDALClose( hWorkDS );
+    GDALDeleteDataset( hDriver, osTmpFile );
+
+    return eErr;
+}
@@ -31,10 +31,13 @@
 #include "gdal_alg.h"
 #include "gdal_alg_priv.h"
 
+#include <algorithm>
 #include <climits>
+#include <cmath>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <new>
 #include <vector>
 
 #include "cpl_conv.h"
@@ -42,6 +45,7 @@
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_priv.h"
 #include "ogr_api.h"
@@ -318,43 +322,51 @@ static void GDALCollectRingsFromGeometry(
 }
 
 /************************************************************************/
-/*                       gv_rasterize_one_shape()                       */
+/*                          GDALRasterizeShape                          */
+/*                                                                      */
+/*      A geometry collected into a set of parts, and transformed to    */
+/*      pixel/line coordinates, so that it can be burnt in any chunk    */
+/*      of the target without being transformed again.                 */
+/************************************************************************/
+
+struct GDALRasterizeShape
+{
+    OGRwkbGeometryType  eFlatType;
+    std::vector<double> aPointX;
+    std::vector<double> aPointY;
+    std::vector<double> aPointVariant;
+    std::vector<int>    aPartSize;
+    std::vector<double> adfBurnValue;
+    int                 nYMin;
+    int                 nYMax;
+
+    GDALRasterizeShape() : eFlatType(wkbUnknown), nYMin(0), nYMax(0) {}
+};
+
+/************************************************************************/
+/*                      GDALRasterizePrepareShape()                     */
 /************************************************************************/
-static void
-gv_rasterize_one_shape( unsigned char *pabyChunkBuf, int nYOff,
-                        int nXSize, int nYSize,
-                        int nBands, GDALDataType eType, int bAllTouched,
-                        OGRGeometry *poShape, double *padfBurnValue,
-                        GDALBurnValueSrc eBurnValueSrc,
-                        GDALRasterMergeAlg eMergeAlg,
-                        GDALTransformerFunc pfnTransformer,
-                        void *pTransformArg )
 
+static bool GDALRasterizePrepareShape( OGRGeometry *poShape,
+                                       GDALBurnValueSrc eBurnValueSrc,
+                                       GDALTransformerFunc pfnTransformer,
+                                       void *pTransformArg,
+                                       GDALRasterizeShape &oShape )
 {
     if( poShape == NULL )
-        return;
+        return false;
 
-    GDALRasterizeInfo sInfo;
-    sInfo.nXSize = nXSize;
-    sInfo.nYSize = nYSize;
-    sInfo.nBands = nBands;
-    sInfo.pabyChunkBuf = pabyChunkBuf;
-    sInfo.eType = eType;
-    sInfo.padfBurnValue = padfBurnValue;
-    sInfo.eBurnValueSource = eBurnValueSrc;
-    sInfo.eMergeAlg = eMergeAlg;
+    oShape.eFlatType = wkbFlatten(poShape->getGeometryType());
 
 /* -------------------------------------------------------------------- */
 /*      Transform polygon geometries into a set of rings and a part     */
 /*      size list.                                                      */
 /* -------------------------------------------------------------------- */
-    std::vector<double> aPointX;
-    std::vector<double> aPointY;
-    std::vector<double> aPointVariant;
-    std::vector<int> aPartSize;
-
-    GDALCollectRingsFromGeometry( poShape, aPointX, aPointY, aPointVariant,
-                                  aPartSize, eBurnValueSrc );
+    GDALCollectRingsFromGeometry( poShape, oShape.aPointX, oShape.aPointY,
+                                  oShape.aPointVariant, oShape.aPartSize,
+                                  eBurnValueSrc );
+    if( oShape.aPartSize.empty() || oShape.aPointX.empty() )
+        return false;
 
 /* -------------------------------------------------------------------- */
 /*      Transform points if needed.                                     */
@@ -362,18 +374,52 @@ gv_rasterize_one_shape( unsigned char *pabyChunkBuf, int nYOff,
     if( pfnTransformer != NULL )
     {
         int *panSuccess =
-            static_cast<int *>(CPLCalloc(sizeof(int), aPointX.size()));
+            static_cast<int *>(CPLCalloc(sizeof(int), oShape.aPointX.size()));
 
         // TODO: We need to add all appropriate error checking at some point.
-        pfnTransformer( pTransformArg, FALSE, static_cast<int>(aPointX.size()),
-                        &(aPointX[0]), &(aPointY[0]), NULL, panSuccess );
+        pfnTransformer( pTransformArg, FALSE,
+                        static_cast<int>(oShape.aPointX.size()),
+                        &(oShape.aPointX[0]), &(oShape.aPointY[0]),
+                        NULL, panSuccess );
         CPLFree( panSuccess );
     }
 
+    return true;
+}
+
+/************************************************************************/
+/*                       GDALRasterizeBurnShape()                       */
+/*                                                                      */
+/*      Burn a prepared shape into a chunk buffer whose first line is   */
+/*      nYOff.  The shape itself is left untouched, so that it can be   */
+/*      burnt concurrently into several chunks.                         */
+/************************************************************************/
+
+static void
+GDALRasterizeBurnShape( unsigned char *pabyChunkBuf, int nYOff,
+                        int nXSize, int nYSize,
+                        int nBands, GDALDataType eType, int bAllTouched,
+                        const GDALRasterizeShape &oShape,
+                        const double *padfBurnValue,
+                        GDALBurnValueSrc eBurnValueSrc,
+                        GDALRasterMergeAlg eMergeAlg )
+
+{
+    GDALRasterizeInfo sInfo;
+    sInfo.nXSize = nXSize;
+    sInfo.nYSize = nYSize;
+    sInfo.nBands = nBands;
+    sInfo.pabyChunkBuf = pabyChunkBuf;
+    sInfo.eType = eType;
+    sInfo.padfBurnValue = const_cast<double *>(padfBurnValue);
+    sInfo.eBurnValueSource = eBurnValueSrc;
+    sInfo.eMergeAlg = eMergeAlg;
+
 /* -------------------------------------------------------------------- */
 /*      Shift to account for the buffer offset of this buffer.          */
 /* -------------------------------------------------------------------- */
-    for( unsigned int i = 0; i < aPointY.size(); i++ )
+    std::vector<double> aPointY( oShape.aPointY );
+    for( size_t i = 0; i < aPointY.size(); i++ )
         aPointY[i] -= nYOff;
 
 /* -------------------------------------------------------------------- */
@@ -381,22 +427,19 @@ gv_rasterize_one_shape( unsigned char *pabyChunkBuf, int nYOff,
 /*      According to the C++ Standard/23.2.4, elements of a vector are  */
 /*      stored in continuous memory block.                              */
 /* -------------------------------------------------------------------- */
+    int *panPartSize = const_cast<int *>(&(oShape.aPartSize[0]));
+    const int nPartCount = static_cast<int>(oShape.aPartSize.size());
+    double *padfX = const_cast<double *>(&(oShape.aPointX[0]));
+    double *padfVariant = (eBurnValueSrc == GBV_UserBurnValue) ?
+        NULL : const_cast<double *>(&(oShape.aPointVariant[0]));
 
-    // TODO - mloskot: Check if vectors are empty, otherwise it may
-    // lead to undefined behavior by returning non-referencable pointer.
-    // if( !aPointX.empty() )
-    //    // Fill polygon.
-    // else
-    //    // How to report this problem?
-    switch( wkbFlatten(poShape->getGeometryType()) )
+    switch( oShape.eFlatType )
     {
       case wkbPoint:
       case wkbMultiPoint:
         GDALdllImagePoint( sInfo.nXSize, nYSize,
-                           static_cast<int>(aPartSize.size()), &(aPartSize[0]),
-                           &(aPointX[0]), &(aPointY[0]),
-                           (eBurnValueSrc == GBV_UserBurnValue)?
-                           NULL : &(aPointVariant[0]),
+                           nPartCount, panPartSize,
+                           padfX, &(aPointY[0]), padfVariant,
                            gvBurnPoint, &sInfo );
         break;
       case wkbLineString:
@@ -404,19 +447,13 @@ gv_rasterize_one_shape( unsigned char *pabyChunkBuf, int nYOff,
       {
           if( bAllTouched )
               GDALdllImageLineAllTouched( sInfo.nXSize, nYSize,
-                                          static_cast<int>(aPartSize.size()),
-                                          &(aPartSize[0]),
-                                          &(aPointX[0]), &(aPointY[0]),
-                                          (eBurnValueSrc == GBV_UserBurnValue)?
-                                          NULL : &(aPointVariant[0]),
+                                          nPartCount, panPartSize,
+                                          padfX, &(aPointY[0]), padfVariant,
                                           gvBurnPoint, &sInfo );
           else
               GDALdllImageLine( sInfo.nXSize, nYSize,
-                                static_cast<int>(aPartSize.size()),
-                                &(aPartSize[0]),
-                                &(aPointX[0]), &(aPointY[0]),
-                                (eBurnValueSrc == GBV_UserBurnValue)?
-                                NULL : &(aPointVariant[0]),
+                                nPartCount, panPartSize,
+                                padfX, &(aPointY[0]), padfVariant,
                                 gvBurnPoint, &sInfo );
       }
       break;
@@ -425,10 +462,8 @@ gv_rasterize_one_shape( unsigned char *pabyChunkBuf, int nYOff,
       {
           GDALdllImageFilledPolygon(
               sInfo.nXSize, nYSize,
-              static_cast<int>(aPartSize.size()), &(aPartSize[0]),
-              &(aPointX[0]), &(aPointY[0]),
-              (eBurnValueSrc == GBV_UserBurnValue)?
-              NULL : &(aPointVariant[0]),
+              nPartCount, panPartSize,
+              padfX, &(aPointY[0]), padfVariant,
               gvBurnScanline, &sInfo );
           if( bAllTouched )
           {
@@ -440,25 +475,20 @@ gv_rasterize_one_shape( unsigned char *pabyChunkBuf, int nYOff,
               {
                   GDALdllImageLineAllTouched(
                       sInfo.nXSize, nYSize,
-                      static_cast<int>(aPartSize.size()), &(aPartSize[0]),
-                      &(aPointX[0]), &(aPointY[0]),
+                      nPartCount, panPartSize,
+                      padfX, &(aPointY[0]),
                       NULL,
                       gvBurnPoint, &sInfo );
               }
               else
               {
-                  for( unsigned int i = 0, n = 0;
-                       i < static_cast<unsigned int>(aPartSize.size());
-                       i++ )
-                  {
-                      for( int j = 0; j < aPartSize[i]; j++ )
-                          aPointVariant[n++] = aPointVariant[0];
-                  }
+                  std::vector<double> aPointVariant(
+                      oShape.aPointVariant.size(), oShape.aPointVariant[0] );
 
                   GDALdllImageLineAllTouched(
                       sInfo.nXSize, nYSize,
-                      static_cast<int>(aPartSize.size()), &(aPartSize[0]),
-                      &(aPointX[0]), &(aPointY[0]),
+                      nPartCount, panPartSize,
+                      padfX, &(aPointY[0]),
                       &(aPointVariant[0]),
                       gvBurnPoint, &sInfo );
               }
@@ -468,6 +498,30 @@ gv_rasterize_one_shape( unsigned char *pabyChunkBuf, int nYOff,
     }
 }
 
+/************************************************************************/
+/*                       gv_rasterize_one_shape()                       */
+/************************************************************************/
+static void
+gv_rasterize_one_shape( unsigned char *pabyChunkBuf, int nYOff,
+                        int nXSize, int nYSize,
+                        int nBands, GDALDataType eType, int bAllTouched,
+                        OGRGeometry *poShape, double *padfBurnValue,
+                        GDALBurnValueSrc eBurnValueSrc,
+                        GDALRasterMergeAlg eMergeAlg,
+                        GDALTransformerFunc pfnTransformer,
+                        void *pTransformArg )
+
+{
+    GDALRasterizeShape oShape;
+    if( !GDALRasterizePrepareShape( poShape, eBurnValueSrc,
+                                    pfnTransformer, pTransformArg, oShape ) )
+        return;
+
+    GDALRasterizeBurnShape( pabyChunkBuf, nYOff, nXSize, nYSize,
+                            nBands, eType, bAllTouched, oShape,
+                            padfBurnValue, eBurnValueSrc, eMergeAlg );
+}
+
 /************************************************************************/
 /*                        GDALRasterizeOptions()                        */
 /*                                                                      */
@@ -528,6 +582,380 @@ static CPLErr GDALRasterizeOptions( char **papszOptions,
     return CE_None;
 }
 
+/************************************************************************/
+/*                         GDALRasterizeContext                         */
+/*                                                                      */
+/*      State of the rasterization: the target is split into            */
+/*      horizontal strips, each with its own buffer, and prepared       */
+/*      shapes are bucketed by the strips they may touch.  Groups of    */
+/*      strips are burnt concurrently, with shapes burnt in the order   */
+/*      they were read within each strip, so that the result is         */
+/*      reproducible.                                                   */
+/************************************************************************/
+
+struct GDALRasterizeContext
+{
+    GDALDataset        *poDS;
+    int                 nBandCount;
+    int                *panBandList;
+    GDALDataType        eType;
+    int                 bAllTouched;
+    GDALBurnValueSrc    eBurnValueSource;
+    GDALRasterMergeAlg  eMergeAlg;
+
+    int                 nStripLines;
+    int                 nStrips;
+    int                 nGroupStrips;
+    // Whether all strips fit in the buffers at once, in which case the
+    // target is read once before, and written once after, all layers.
+    bool                bResident;
+    std::vector<unsigned char *> apabyStripBuf;
+    CPLWorkerThreadPool *poThreadPool;
+
+    std::vector<GDALRasterizeShape *> apoShapes;
+    std::vector< std::vector<int> > aanStripShapes;
+    GIntBig             nShapesMemory;
+    GIntBig             nMaxShapesMemory;
+};
+
+/************************************************************************/
+/*                        GDALRasterizeStripJob                         */
+/************************************************************************/
+
+struct GDALRasterizeStripJob
+{
+    const GDALRasterizeContext *psCtxt;
+    int                 iStrip;
+    unsigned char      *pabyBuf;
+};
+
+/************************************************************************/
+/*                       GDALRasterizeStripLines()                      */
+/************************************************************************/
+
+static int GDALRasterizeStripLines( const GDALRasterizeContext &sCtxt,
+                                    int iStrip )
+{
+    const int nYOff = iStrip * sCtxt.nStripLines;
+    return std::min( sCtxt.nStripLines,
+                     sCtxt.poDS->GetRasterYSize() - nYOff );
+}
+
+/************************************************************************/
+/*                      GDALRasterizeStripJobFunc()                     */
+/************************************************************************/
+
+static void GDALRasterizeStripJobFunc( void *pData )
+{
+    const GDALRasterizeStripJob *psJob =
+        static_cast<const GDALRasterizeStripJob *>(pData);
+    const GDALRasterizeContext &sCtxt = *(psJob->psCtxt);
+    const std::vector<int> &anShapes = sCtxt.aanStripShapes[psJob->iStrip];
+
+    for( size_t i = 0; i < anShapes.size(); i++ )
+    {
+        const GDALRasterizeShape *poShape = sCtxt.apoShapes[anShapes[i]];
+        GDALRasterizeBurnShape( psJob->pabyBuf,
+                                psJob->iStrip * sCtxt.nStripLines,
+                                sCtxt.poDS->GetRasterXSize(),
+                                GDALRasterizeStripLines(sCtxt, psJob->iStrip),
+                                sCtxt.nBandCount, sCtxt.eType,
+                                sCtxt.bAllTouched, *poShape,
+                                &(poShape->adfBurnValue[0]),
+                                sCtxt.eBurnValueSource, sCtxt.eMergeAlg );
+    }
+}
+
+/************************************************************************/
+/*                        GDALRasterizeStripIO()                        */
+/************************************************************************/
+
+static CPLErr GDALRasterizeStripIO( GDALRasterizeContext &sCtxt,
+                                    GDALRWFlag eRWFlag, int iStrip,
+                                    unsigned char *pabyBuf )
+{
+    const int nThisStripLines = GDALRasterizeStripLines(sCtxt, iStrip);
+    return sCtxt.poDS->RasterIO( eRWFlag, 0, iStrip * sCtxt.nStripLines,
+                                 sCtxt.poDS->GetRasterXSize(), nThisStripLines,
+                                 pabyBuf,
+                                 sCtxt.poDS->GetRasterXSize(), nThisStripLines,
+                                 sCtxt.eType, sCtxt.nBandCount,
+                                 sCtxt.panBandList, 0, 0, 0, NULL );
+}
+
+/************************************************************************/
+/*                      GDALRasterizeFlushShapes()                      */
+/*                                                                      */
+/*      Burn the pending shapes into the strips they touch, and         */
+/*      release them.                                                   */
+/************************************************************************/
+
+static CPLErr GDALRasterizeFlushShapes( GDALRasterizeContext &sCtxt )
+{
+    CPLErr eErr = CE_None;
+
+    for( int iGroupStart = 0;
+         iGroupStart < sCtxt.nStrips && eErr == CE_None;
+         iGroupStart += sCtxt.nGroupStrips )
+    {
+        const int nGroupCount =
+            std::min(sCtxt.nGroupStrips, sCtxt.nStrips - iGroupStart);
+
+        std::vector<GDALRasterizeStripJob> asJobs;
+        for( int i = 0; i < nGroupCount; i++ )
+        {
+            const int iStrip = iGroupStart + i;
+            if( sCtxt.aanStripShapes[iStrip].empty() )
+                continue;
+
+            GDALRasterizeStripJob sJob;
+            sJob.psCtxt = &sCtxt;
+            sJob.iStrip = iStrip;
+            sJob.pabyBuf = sCtxt.apabyStripBuf[i];
+            asJobs.push_back(sJob);
+        }
+        if( asJobs.empty() )
+            continue;
+
+        for( size_t i = 0; i < asJobs.size() && !sCtxt.bResident; i++ )
+        {
+            eErr = GDALRasterizeStripIO( sCtxt, GF_Read, asJobs[i].iStrip,
+                                         asJobs[i].pabyBuf );
+            if( eErr != CE_None )
+                break;
+        }
+        if( eErr != CE_None )
+            break;
+
+        if( sCtxt.poThreadPool != NULL && asJobs.size() > 1 )
+        {
+            for( size_t i = 0; i < asJobs.size(); i++ )
+                sCtxt.poThreadPool->SubmitJob( GDALRasterizeStripJobFunc,
+                                               &asJobs[i] );
+            sCtxt.poThreadPool->WaitCompletion();
+        }
+        else
+        {
+            for( size_t i = 0; i < asJobs.size(); i++ )
+                GDALRasterizeStripJobFunc( &asJobs[i] );
+        }
+
+        for( size_t i = 0; i < asJobs.size() && !sCtxt.bResident; i++ )
+        {
+            eErr = GDALRasterizeStripIO( sCtxt, GF_Write, asJobs[i].iStrip,
+                                         asJobs[i].pabyBuf );
+            if( eErr != CE_None )
+                break;
+        }
+    }
+
+    for( size_t i = 0; i < sCtxt.apoShapes.size(); i++ )
+        delete sCtxt.apoShapes[i];
+    sCtxt.apoShapes.clear();
+    for( size_t i = 0; i < sCtxt.aanStripShapes.size(); i++ )
+        sCtxt.aanStripShapes[i].clear();
+    sCtxt.nShapesMemory = 0;
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                        GDALRasterizeAddShape()                       */
+/*                                                                      */
+/*      Take ownership of a prepared shape, and queue it in the         */
+/*      buckets of the strips it may touch.                             */
+/************************************************************************/
+
+static CPLErr GDALRasterizeAddShape( GDALRasterizeContext &sCtxt,
+                                     GDALRasterizeShape *poShape )
+{
+    const int nYSize = sCtxt.poDS->GetRasterYSize();
+
+    // Lines possibly touched, with a margin of one line for the rounding
+    // done by the low level rasterizers.
+    double dfYMin = poShape->aPointY[0];
+    double dfYMax = poShape->aPointY[0];
+    bool bValid = true;
+    for( size_t i = 0; i < poShape->aPointY.size(); i++ )
+    {
+        const double dfY = poShape->aPointY[i];
+        if( CPLIsNan(dfY) || CPLIsInf(dfY) )
+        {
+            bValid = false;
+            break;
+        }
+        dfYMin = std::min(dfYMin, dfY);
+        dfYMax = std::max(dfYMax, dfY);
+    }
+    if( bValid )
+    {
+        dfYMin = floor(dfYMin) - 1;
+        dfYMax = floor(dfYMax) + 1;
+        if( dfYMax < 0 || dfYMin >= nYSize )
+        {
+            delete poShape;
+            return CE_None;
+        }
+        poShape->nYMin = static_cast<int>(std::max(0.0, dfYMin));
+        poShape->nYMax = static_cast<int>(std::min(nYSize - 1.0, dfYMax));
+    }
+    else
+    {
+        poShape->nYMin = 0;
+        poShape->nYMax = nYSize - 1;
+    }
+
+    const int iShape = static_cast<int>(sCtxt.apoShapes.size());
+    sCtxt.apoShapes.push_back(poShape);
+    for( int iStrip = poShape->nYMin / sCtxt.nStripLines;
+         iStrip <= poShape->nYMax / sCtxt.nStripLines; iStrip++ )
+    {
+        sCtxt.aanStripShapes[iStrip].push_back(iShape);
+    }
+
+    sCtxt.nShapesMemory += sizeof(GDALRasterizeShape) +
+        sizeof(double) * (poShape->aPointX.size() + poShape->aPointY.size() +
+                          poShape->aPointVariant.size() +
+                          poShape->adfBurnValue.size()) +
+        sizeof(int) * (poShape->aPartSize.size() +
+                       poShape->nYMax / sCtxt.nStripLines -
+                       poShape->nYMin / sCtxt.nStripLines + 1);
+    if( sCtxt.nShapesMemory > sCtxt.nMaxShapesMemory )
+        return GDALRasterizeFlushShapes( sCtxt );
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                       GDALRasterizeContextInit()                     */
+/*                                                                      */
+/*      Split the target in strips of nYChunkSize lines, burnt          */
+/*      concurrently when several threads are requested with the        */
+/*      NUM_THREADS option or the GDAL_NUM_THREADS configuration        */
+/*      option.                                                         */
+/************************************************************************/
+
+static CPLErr GDALRasterizeContextInit( GDALRasterizeContext &sCtxt,
+                                        GDALDataset *poDS,
+                                        int nBandCount, int *panBandList,
+                                        GDALDataType eType, int bAllTouched,
+                                        GDALBurnValueSrc eBurnValueSource,
+                                        GDALRasterMergeAlg eMergeAlg,
+                                        int nYChunkSize,
+                                        char **papszOptions )
+{
+    const int nYSize = poDS->GetRasterYSize();
+    const int nScanlineBytes =
+        nBandCount * poDS->GetRasterXSize() * GDALGetDataTypeSizeBytes(eType);
+
+    const char *pszNumThreads = CSLFetchNameValue(papszOptions, "NUM_THREADS");
+    if( pszNumThreads == NULL )
+        pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                        CPLGetNumCPUs() : atoi(pszNumThreads);
+    nThreads = std::max(1, std::min(nThreads, nYSize));
+
+    sCtxt.poDS = poDS;
+    sCtxt.nBandCount = nBandCount;
+    sCtxt.panBandList = panBandList;
+    sCtxt.eType = eType;
+    sCtxt.bAllTouched = bAllTouched;
+    sCtxt.eBurnValueSource = eBurnValueSource;
+    sCtxt.eMergeAlg = eMergeAlg;
+    // Strips are chunks whatever the number of threads, so that ALL_TOUCHED
+    // lines crossing strip boundaries are burnt the same way.
+    sCtxt.nStripLines = nYChunkSize;
+    sCtxt.nStrips = (nYSize + sCtxt.nStripLines - 1) / sCtxt.nStripLines;
+    sCtxt.nGroupStrips = std::min(nThreads, sCtxt.nStrips);
+    sCtxt.bResident = sCtxt.nStrips <= sCtxt.nGroupStrips;
+    sCtxt.poThreadPool = NULL;
+    sCtxt.aanStripShapes.resize(sCtxt.nStrips);
+    sCtxt.nShapesMemory = 0;
+    // Prepared shapes are buffered up to the same budget as the chunk.
+    sCtxt.nMaxShapesMemory =
+        std::max(static_cast<GIntBig>(nYChunkSize) * nScanlineBytes,
+                 static_cast<GIntBig>(1024 * 1024));
+
+    CPLDebug( "GDAL", "Rasterizer operating on %d swaths of %d scanlines.",
+              sCtxt.nStrips, sCtxt.nStripLines );
+
+    CPLErr eErr = CE_None;
+    for( int i = 0; i < sCtxt.nGroupStrips; i++ )
+    {
+        unsigned char *pabyBuf = static_cast<unsigned char *>(
+            VSI_MALLOC2_VERBOSE(sCtxt.nStripLines, nScanlineBytes));
+        if( pabyBuf == NULL )
+        {
+            eErr = CE_Failure;
+            break;
+        }
+        sCtxt.apabyStripBuf.push_back(pabyBuf);
+    }
+
+    if( eErr == CE_None && sCtxt.nGroupStrips > 1 )
+    {
+        sCtxt.poThreadPool = new (std::nothrow) CPLWorkerThreadPool();
+        if( sCtxt.poThreadPool == NULL ||
+            !sCtxt.poThreadPool->Setup(sCtxt.nGroupStrips, NULL, NULL) )
+        {
+            // Strips will be burnt sequentially.
+            delete sCtxt.poThreadPool;
+            sCtxt.poThreadPool = NULL;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Read the image once for all shapes if all strips fit in the     */
+/*      buffers at once.                                                */
+/* -------------------------------------------------------------------- */
+    for( int iStrip = 0;
+         eErr == CE_None && sCtxt.bResident && iStrip < sCtxt.nStrips;
+         iStrip++ )
+    {
+        eErr = GDALRasterizeStripIO( sCtxt, GF_Read, iStrip,
+                                     sCtxt.apabyStripBuf[iStrip] );
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                      GDALRasterizeContextFinish()                    */
+/************************************************************************/
+
+static CPLErr GDALRasterizeContextFinish( GDALRasterizeContext &sCtxt,
+                                          CPLErr eErr )
+{
+/* -------------------------------------------------------------------- */
+/*      Burn the remaining shapes, and write out the image once for     */
+/*      all shapes if it was read at once.                              */
+/* -------------------------------------------------------------------- */
+    if( eErr == CE_None )
+        eErr = GDALRasterizeFlushShapes( sCtxt );
+
+    for( int iStrip = 0;
+         eErr == CE_None && sCtxt.bResident && iStrip < sCtxt.nStrips;
+         iStrip++ )
+    {
+        eErr = GDALRasterizeStripIO( sCtxt, GF_Write, iStrip,
+                                     sCtxt.apabyStripBuf[iStrip] );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      cleanup                                                         */
+/* -------------------------------------------------------------------- */
+    delete sCtxt.poThreadPool;
+    sCtxt.poThreadPool = NULL;
+    for( size_t i = 0; i < sCtxt.apabyStripBuf.size(); i++ )
+        VSIFree( sCtxt.apabyStripBuf[i] );
+    sCtxt.apabyStripBuf.clear();
+    for( size_t i = 0; i < sCtxt.apoShapes.size(); i++ )
+        delete sCtxt.apoShapes[i];
+    sCtxt.apoShapes.clear();
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                      GDALRasterizeGeometries()                       */
 /************************************************************************/
@@ -576,6 +1004,11 @@ static CPLErr GDALRasterizeOptions( char **papszOptions,
  * <li>"MERGE_ALG": May be REPLACE (the default) or ADD.  REPLACE results in
  * overwriting of value, while ADD adds the new value to the existing raster,
  * suitable for heatmaps for instance.</li>
+ * <li>"NUM_THREADS": (GDAL &gt;= 2.3) Number of threads, or ALL_CPUS, used to
+ * burn the chunks of the raster concurrently, each in its own buffer of
+ * CHUNKYSIZE lines. Defaults to the value of the GDAL_NUM_THREADS
+ * configuration option, or 1. The result does not depend on the number of
+ * threads, which only helps when the raster spans several chunks.</li>
  * </ul>
  * @param pfnProgress the progress function to report completion.
  * @param pProgressArg callback data for progress function.
@@ -664,9 +1097,8 @@ CPLErr GDALRasterizeGeometries( GDALDatasetH hDS,
     }
 
 /* -------------------------------------------------------------------- */
-/*      Establish a chunksize to operate on.  The larger the chunk      */
-/*      size the less times we need to make a pass through all the      */
-/*      shapes.                                                         */
+/*      Establish a chunksize to operate on.  Geometries are            */
+/*      transformed once, and burnt in the chunks they touch.           */
 /* -------------------------------------------------------------------- */
     const GDALDataType eType =
         poBand->GetRasterDataType() == GDT_Byte ? GDT_Byte : GDT_Float64;
@@ -681,80 +1113,59 @@ CPLErr GDALRasterizeGeometries( GDALDatasetH hDS,
         nYChunkSize = 10000000 / nScanlineBytes;
     }
 
+    if( nYChunkSize < 1 )
+        nYChunkSize = 1;
     if( nYChunkSize > poDS->GetRasterYSize() )
         nYChunkSize = poDS->GetRasterYSize();
 
-    CPLDebug( "GDAL", "Rasterizer operating on %d swaths of %d scanlines.",
-              (poDS->GetRasterYSize() + nYChunkSize - 1) / nYChunkSize,
-              nYChunkSize );
-
-    unsigned char *pabyChunkBuf = static_cast<unsigned char *>(
-        VSI_MALLOC2_VERBOSE(nYChunkSize, nScanlineBytes));
-    if( pabyChunkBuf == NULL )
-    {
-        if( bNeedToFreeTransformer )
-            GDALDestroyTransformer( pTransformArg );
-        return CE_Failure;
-    }
-
-/* ==================================================================== */
-/*      Loop over image in designated chunks.                           */
-/* ==================================================================== */
-    CPLErr eErr = CE_None;
+    GDALRasterizeContext sCtxt;
+    CPLErr eErr =
+        GDALRasterizeContextInit( sCtxt, poDS, nBandCount, panBandList, eType,
+                                  bAllTouched, eBurnValueSource, eMergeAlg,
+                                  nYChunkSize, papszOptions );
 
-    pfnProgress( 0.0, NULL, pProgressArg );
+    if( eErr == CE_None )
+        pfnProgress( 0.0, NULL, pProgressArg );
 
-    for( int iY = 0;
-         iY < poDS->GetRasterYSize() && eErr == CE_None;
-         iY += nYChunkSize )
+    for( int iShape = 0; eErr == CE_None && iShape < nGeomCount; iShape++ )
     {
-        int nThisYChunkSize = nYChunkSize;
-        if( nThisYChunkSize + iY > poDS->GetRasterYSize() )
-            nThisYChunkSize = poDS->GetRasterYSize() - iY;
-
-        eErr =
-            poDS->RasterIO(GF_Read,
-                           0, iY, poDS->GetRasterXSize(), nThisYChunkSize,
-                           pabyChunkBuf,
-                           poDS->GetRasterXSize(), nThisYChunkSize,
-                           eType, nBandCount, panBandList,
-                           0, 0, 0, NULL);
-        if( eErr != CE_None )
-            break;
-
-        for( int iShape = 0; iShape < nGeomCount; iShape++ )
+        GDALRasterizeShape *poShape = new GDALRasterizeShape();
+        if( GDALRasterizePrepareShape( reinterpret_cast<OGRGeometry *>(
+                                                    pahGeometries[iShape]),
+                                       eBurnValueSource,
+                                       pfnTransformer, pTransformArg,
+                                       *poShape ) )
         {
-            gv_rasterize_one_shape( pabyChunkBuf, iY,
-                                    poDS->GetRasterXSize(), nThisYChunkSize,
-                                    nBandCount, eType, bAllTouched,
-                                    reinterpret_cast<OGRGeometry *>(
-                                                        pahGeometries[iShape]),
-                                    padfGeomBurnValue + iShape*nBandCount,
-                                    eBurnValueSource, eMergeAlg,
-                                    pfnTransformer, pTransformArg );
+            poShape->adfBurnValue.assign(
+                padfGeomBurnValue + iShape * nBandCount,
+                padfGeomBurnValue + (iShape + 1) * nBandCount );
+            eErr = GDALRasterizeAddShape( sCtxt, poShape );
+        }
+        else
+        {
+            delete poShape;
         }
 
-        eErr =
-            poDS->RasterIO( GF_Write, 0, iY,
-                            poDS->GetRasterXSize(), nThisYChunkSize,
-                            pabyChunkBuf,
-                            poDS->GetRasterXSize(), nThisYChunkSize,
-                            eType, nBandCount, panBandList, 0, 0, 0, NULL);
-
-        if( !pfnProgress((iY + nThisYChunkSize) /
-                         static_cast<double>(poDS->GetRasterYSize()),
-                         "", pProgressArg ) )
+        if( eErr == CE_None && ((iShape + 1) % 1000) == 0 &&
+            !pfnProgress( (iShape + 1) / static_cast<double>(nGeomCount),
+                          "", pProgressArg ) )
         {
             CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
             eErr = CE_Failure;
         }
     }
 
+    eErr = GDALRasterizeContextFinish( sCtxt, eErr );
+
+    if( eErr == CE_None && !pfnProgress( 1.0, "", pProgressArg ) )
+    {
+        CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        eErr = CE_Failure;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      cleanup                                                         */
 /* -------------------------------------------------------------------- */
-    VSIFree( pabyChunkBuf );
-
     if( bNeedToFreeTransformer )
         GDALDestroyTransformer( pTransformArg );
 
@@ -800,8 +1211,9 @@ CPLErr GDALRasterizeGeometries( GDALDatasetH hDS,
  * bands. If specified, padfLayerBurnValues will not be used and can be a NULL
  * pointer.</li>
  * <li>"CHUNKYSIZE": The height in lines of the chunk to operate on.
- * The larger the chunk size the less times we need to make a pass through all
- * the shapes. If it is not set or set to zero the default chunk size will be
+ * Features are read and transformed once, and burnt in the chunks they touch.
+ * The larger the chunk size the less times chunks need to be read and written
+ * when the features do not fit in the same budget. If it is not set or set to zero the default chunk size will be
  * used. Default size will be estimated based on the GDAL cache buffer size
  * using formula: cache_size_bytes/scanline_size_bytes, so the chunk will
  * not exceed the cache.</li>
@@ -817,6 +1229,11 @@ CPLErr GDALRasterizeGeometries( GDALDatasetH hDS,
  * <li>"MERGE_ALG": May be REPLACE (the default) or ADD.  REPLACE results in
  * overwriting of value, while ADD adds the new value to the existing raster,
  * suitable for heatmaps for instance.</li>
+ * <li>"NUM_THREADS": (GDAL &gt;= 2.3) Number of threads, or ALL_CPUS, used to
+ * burn the chunks of the raster concurrently, each in its own buffer of
+ * CHUNKYSIZE lines. Defaults to the value of the GDAL_NUM_THREADS
+ * configuration option, or 1. The result does not depend on the number of
+ * threads, which only helps when the raster spans several chunks.</li>
  * </ul>
  * @param pfnProgress the progress function to report completion.
  * @param pProgressArg callback data for progress function.
@@ -866,9 +1283,8 @@ CPLErr GDALRasterizeLayers( GDALDatasetH hDS,
     }
 
 /* -------------------------------------------------------------------- */
-/*      Establish a chunksize to operate on.  The larger the chunk      */
-/*      size the less times we need to make a pass through all the      */
-/*      shapes.                                                         */
+/*      Establish a chunksize to operate on.  Features are read and     */
+/*      transformed once, and burnt in the chunks they touch.           */
 /* -------------------------------------------------------------------- */
     const char  *pszYChunkSize =
         CSLFetchNameValue( papszOptions, "CHUNKYSIZE" );
@@ -895,43 +1311,22 @@ CPLErr GDALRasterizeLayers( GDALDatasetH hDS,
     if( nYChunkSize > poDS->GetRasterYSize() )
         nYChunkSize = poDS->GetRasterYSize();
 
-    CPLDebug( "GDAL", "Rasterizer operating on %d swaths of %d scanlines.",
-              (poDS->GetRasterYSize() + nYChunkSize - 1) / nYChunkSize,
-              nYChunkSize );
-    unsigned char *pabyChunkBuf = static_cast<unsigned char *>(
-        VSI_MALLOC2_VERBOSE(nYChunkSize, nScanlineBytes));
-    if( pabyChunkBuf == NULL )
-    {
-        return CE_Failure;
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Read the image once for all layers if user requested to render  */
-/*      the whole raster in single chunk.                               */
-/* -------------------------------------------------------------------- */
-    if( nYChunkSize == poDS->GetRasterYSize() )
-    {
-        if( poDS->RasterIO( GF_Read, 0, 0, poDS->GetRasterXSize(),
-                            nYChunkSize, pabyChunkBuf,
-                            poDS->GetRasterXSize(), nYChunkSize,
-                            eType, nBandCount, panBandList, 0, 0, 0, NULL )
-             != CE_None )
-        {
-            CPLFree( pabyChunkBuf );
-            return CE_Failure;
-        }
-    }
+    GDALRasterizeContext sCtxt;
+    CPLErr eErr =
+        GDALRasterizeContextInit( sCtxt, poDS, nBandCount, panBandList, eType,
+                                  bAllTouched, eBurnValueSource, eMergeAlg,
+                                  nYChunkSize, papszOptions );
 
 /* ==================================================================== */
-/*      Read the specified layers transforming and rasterizing          */
-/*      geometries.                                                     */
+/*      Read the specified layers transforming geometries once, and     */
+/*      rasterizing them by batches.                                    */
 /* ==================================================================== */
-    CPLErr eErr = CE_None;
     const char *pszBurnAttribute = CSLFetchNameValue(papszOptions, "ATTRIBUTE");
 
-    pfnProgress( 0.0, NULL, pProgressArg );
+    if( eErr == CE_None )
+        pfnProgress( 0.0, NULL, pProgressArg );
 
-    for( int iLayer = 0; iLayer < nLayerCount; iLayer++ )
+    for( int iLayer = 0; eErr == CE_None && iLayer < nLayerCount; iLayer++ )
     {
         OGRLayer *poLayer = reinterpret_cast<OGRLayer *>(pahLayers[iLayer]);
 
@@ -947,7 +1342,8 @@ CPLErr GDALRasterizeLayers( GDALDatasetH hDS,
 /*      Do not force the feature count, so if driver doesn't know       */
 /*      exact number of features, go down the normal way.               */
 /* -------------------------------------------------------------------- */
-        if( poLayer->GetFeatureCount(FALSE) == 0 )
+        const GIntBig nFeatureCount = poLayer->GetFeatureCount(FALSE);
+        if( nFeatureCount == 0 )
             continue;
 
         int iBurnField = -1;
@@ -1019,122 +1415,73 @@ CPLErr GDALRasterizeLayers( GDALDatasetH hDS,
             CSLDestroy( papszTransformerOptions );
             if( pTransformArg == NULL )
             {
-                CPLFree( pabyChunkBuf );
-                return CE_Failure;
+                eErr = CE_Failure;
+                break;
             }
         }
 
         poLayer->ResetReading();
 
 /* -------------------------------------------------------------------- */
-/*      Loop over image in designated chunks.                           */
+/*      Read the features once, queuing their transformed geometries    */
+/*      in the strips they touch.                                       */
 /* -------------------------------------------------------------------- */
-
-        double *padfAttrValues = static_cast<double *>(
-            VSI_MALLOC_VERBOSE(sizeof(double) * nBandCount));
-        if( padfAttrValues == NULL )
-            eErr = CE_Failure;
-
-        for( int iY = 0;
-             iY < poDS->GetRasterYSize() && eErr == CE_None;
-             iY += nYChunkSize )
+        GIntBig nFeaturesRead = 0;
+        OGRFeature *poFeat = NULL;
+        while( eErr == CE_None &&
+               (poFeat = poLayer->GetNextFeature()) != NULL )
         {
-            int nThisYChunkSize = nYChunkSize;
-            if( nThisYChunkSize + iY > poDS->GetRasterYSize() )
-                nThisYChunkSize = poDS->GetRasterYSize() - iY;
-
-            // Only re-read image if not a single chunk is being rendered.
-            if( nYChunkSize < poDS->GetRasterYSize() )
+            GDALRasterizeShape *poShape = new GDALRasterizeShape();
+            if( GDALRasterizePrepareShape( poFeat->GetGeometryRef(),
+                                           eBurnValueSource,
+                                           pfnTransformer, pTransformArg,
+                                           *poShape ) )
             {
-                eErr =
-                    poDS->RasterIO( GF_Read, 0, iY,
-                                    poDS->GetRasterXSize(), nThisYChunkSize,
-                                    pabyChunkBuf,
-                                    poDS->GetRasterXSize(), nThisYChunkSize,
-                                    eType, nBandCount, panBandList,
-                                    0, 0, 0, NULL );
-                if( eErr != CE_None )
-                    break;
-            }
-
-            OGRFeature *poFeat = NULL;
-            while( (poFeat = poLayer->GetNextFeature()) != NULL )
-            {
-                OGRGeometry *poGeom = poFeat->GetGeometryRef();
-
                 if( pszBurnAttribute )
-                {
-                    const double dfAttrValue =
-                        poFeat->GetFieldAsDouble( iBurnField );
-                    for( int iBand = 0 ; iBand < nBandCount ; iBand++)
-                        padfAttrValues[iBand] = dfAttrValue;
-
-                    padfBurnValues = padfAttrValues;
-                }
-
-                gv_rasterize_one_shape( pabyChunkBuf, iY,
-                                        poDS->GetRasterXSize(),
-                                        nThisYChunkSize,
-                                        nBandCount, eType, bAllTouched, poGeom,
-                                        padfBurnValues, eBurnValueSource,
-                                        eMergeAlg,
-                                        pfnTransformer, pTransformArg );
+                    poShape->adfBurnValue.resize(
+                        nBandCount, poFeat->GetFieldAsDouble( iBurnField ));
+                else
+                    poShape->adfBurnValue.assign(
+                        padfBurnValues, padfBurnValues + nBandCount );
 
-                delete poFeat;
+                eErr = GDALRasterizeAddShape( sCtxt, poShape );
             }
-
-            // Only write image if not a single chunk is being rendered.
-            if( nYChunkSize < poDS->GetRasterYSize() )
+            else
             {
-                eErr =
-                    poDS->RasterIO( GF_Write, 0, iY,
-                                    poDS->GetRasterXSize(), nThisYChunkSize,
-                                    pabyChunkBuf,
-                                    poDS->GetRasterXSize(), nThisYChunkSize,
-                                    eType, nBandCount, panBandList,
-                                    0, 0, 0, NULL );
+                delete poShape;
             }
 
-            poLayer->ResetReading();
+            delete poFeat;
 
-            if( !pfnProgress((iY + nThisYChunkSize) /
-                             static_cast<double>(poDS->GetRasterYSize()),
-                             "", pProgressArg) )
+            nFeaturesRead++;
+            if( eErr == CE_None && nFeatureCount > 0 &&
+                (nFeaturesRead % 1000) == 0 &&
+                !pfnProgress( (iLayer + std::min(1.0,
+                                 static_cast<double>(nFeaturesRead) /
+                                 nFeatureCount)) / nLayerCount,
+                              "", pProgressArg ) )
             {
                 CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
                 eErr = CE_Failure;
             }
         }
 
-        VSIFree( padfAttrValues );
-
         if( bNeedToFreeTransformer )
         {
             GDALDestroyTransformer( pTransformArg );
             pTransformArg = NULL;
             pfnTransformer = NULL;
         }
-    }
 
-/* -------------------------------------------------------------------- */
-/*      Write out the image once for all layers if user requested       */
-/*      to render the whole raster in single chunk.                     */
-/* -------------------------------------------------------------------- */
-    if( eErr == CE_None && nYChunkSize == poDS->GetRasterYSize() )
-    {
-        eErr = poDS->RasterIO( GF_Write, 0, 0,
-                                poDS->GetRasterXSize(), nYChunkSize,
-                                pabyChunkBuf,
-                                poDS->GetRasterXSize(), nYChunkSize,
-                                eType, nBandCount, panBandList, 0, 0, 0, NULL );
+        if( eErr == CE_None &&
+            !pfnProgress( (iLayer + 1.0) / nLayerCount, "", pProgressArg ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
     }
 
-/* -------------------------------------------------------------------- */
-/*      cleanup                                                         */
-/* -------------------------------------------------------------------- */
-    VSIFree( pabyChunkBuf );
-
-    return eErr;
+    return GDALRasterizeContextFinish( sCtxt, eErr );
 }
 
 /************************************************************************/
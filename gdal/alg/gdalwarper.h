@@ -443,7 +443,12 @@ private:
 
     void           *psThreadData;
 
+    // Per thread transformers and kernel thread data, set while
+    // ChunkAndWarpMulti() warps several chunks concurrently.
+    void           *psConcurrentChunksData;
+
     void            WipeChunkList();
+    bool            ChunkAndWarpConcurrent( int nThreads, CPLErr* peErr );
     CPLErr          CollectChunkList( int nDstXOff, int nDstYOff,
                                       int nDstXSize, int nDstYSize );
     void            ReportTiming( const char * );
@@ -37,6 +37,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <vector>
 
 #include "cpl_config.h"
 #include "cpl_conv.h"
@@ -45,6 +46,7 @@
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
+#include "gdal_alg_priv.h"
 #include "gdal_priv.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
@@ -143,7 +145,8 @@ GDALWarpOperation::GDALWarpOperation() :
     pasChunkList(NULL),
     bReportTimings(FALSE),
     nLastTimeReported(0),
-    psThreadData(NULL)
+    psThreadData(NULL),
+    psConcurrentChunksData(NULL)
 {}
 
 /************************************************************************/
@@ -885,6 +888,277 @@ static void ChunkThreadMain( void *pThreadData )
     }
 }
 
+/************************************************************************/
+/*                     GDALWarpConcurrentChunks                         */
+/************************************************************************/
+
+typedef struct
+{
+    void    *pTransformerArg;
+    void    *psThreadData;
+} GDALWarpChunkThreadContext;
+
+struct GDALWarpConcurrentChunks
+{
+    GDALWarpOperation  *poOperation;
+    GDALWarpChunk      *pasChunkList;
+    int                 nChunkListCount;
+    std::vector<double> adfProgressBase;
+    std::vector<double> adfProgressScale;
+    CPLMutex           *hIOMutex;
+
+    // Protects all the members below.
+    CPLMutex           *hMutex;
+    int                 iNextChunk;
+    CPLErr              eErr;
+    std::vector<GDALWarpChunkThreadContext> asContexts;
+
+    GDALProgressFunc    pfnProgress;
+    void               *pProgressArg;
+    double              dfLastProgress;
+    bool                bStop;
+};
+
+typedef struct
+{
+    GDALWarpConcurrentChunks *psChunks;
+    int                       iContext;
+} GDALWarpConcurrentChunksJob;
+
+/************************************************************************/
+/*                      ConcurrentChunksProgress()                      */
+/*                                                                      */
+/*      Serialize progress reports of the chunk threads, and only       */
+/*      forward those that make progress.                               */
+/************************************************************************/
+
+static int CPL_STDCALL ConcurrentChunksProgress( double dfComplete,
+                                                 const char *pszMessage,
+                                                 void *pProgressArg )
+{
+    GDALWarpConcurrentChunks* psChunks =
+        static_cast<GDALWarpConcurrentChunks*>(pProgressArg);
+    CPLMutexHolderD( &psChunks->hMutex );
+    if( !psChunks->bStop && dfComplete > psChunks->dfLastProgress )
+    {
+        psChunks->dfLastProgress = dfComplete;
+        if( !psChunks->pfnProgress( dfComplete, pszMessage,
+                                    psChunks->pProgressArg ) )
+            psChunks->bStop = true;
+    }
+    return !psChunks->bStop;
+}
+
+/************************************************************************/
+/*                      ConcurrentChunkThreadMain()                     */
+/************************************************************************/
+
+static void ConcurrentChunkThreadMain( void *pThreadData )
+
+{
+    GDALWarpConcurrentChunksJob* psJob =
+        static_cast<GDALWarpConcurrentChunksJob*>(pThreadData);
+    GDALWarpConcurrentChunks* psChunks = psJob->psChunks;
+
+    // The context is owned by ChunkAndWarpConcurrent(), so the slot does
+    // not free it, and is cleared before the thread exits.
+    CPLSetTLS( CTLS_WARPCHUNKCONTEXT,
+               &psChunks->asContexts[psJob->iContext], FALSE );
+
+    while( true )
+    {
+        int iChunk = 0;
+        {
+            CPLMutexHolderD( &psChunks->hMutex );
+            if( psChunks->eErr != CE_None ||
+                psChunks->iNextChunk == psChunks->nChunkListCount )
+                break;
+            iChunk = psChunks->iNextChunk++;
+        }
+
+        GDALWarpChunk *pasChunkInfo = psChunks->pasChunkList + iChunk;
+        CPLErr eErr = CE_None;
+
+        if( !CPLAcquireMutex( psChunks->hIOMutex, 600.0 ) )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Failed to acquire IOMutex in WarpRegion()." );
+            eErr = CE_Failure;
+        }
+        else
+        {
+            eErr = psChunks->poOperation->WarpRegion(
+                                    pasChunkInfo->dx, pasChunkInfo->dy,
+                                    pasChunkInfo->dsx, pasChunkInfo->dsy,
+                                    pasChunkInfo->sx, pasChunkInfo->sy,
+                                    pasChunkInfo->ssx, pasChunkInfo->ssy,
+                                    pasChunkInfo->sExtraSx,
+                                    pasChunkInfo->sExtraSy,
+                                    psChunks->adfProgressBase[iChunk],
+                                    psChunks->adfProgressScale[iChunk]);
+            CPLReleaseMutex( psChunks->hIOMutex );
+        }
+
+        if( eErr != CE_None )
+        {
+            CPLMutexHolderD( &psChunks->hMutex );
+            psChunks->eErr = eErr;
+            break;
+        }
+    }
+
+    CPLSetTLS( CTLS_WARPCHUNKCONTEXT, NULL, FALSE );
+}
+
+/************************************************************************/
+/*                 SetupKernelForConcurrentChunks()                     */
+/*                                                                      */
+/*      Make the kernel use the transformer and kernel threads of the   */
+/*      chunk thread running it.                                        */
+/************************************************************************/
+
+static void SetupKernelForConcurrentChunks( void* psConcurrentChunksData,
+                                            GDALWarpKernel* poWK )
+{
+    GDALWarpConcurrentChunks* psChunks =
+        static_cast<GDALWarpConcurrentChunks*>(psConcurrentChunksData);
+    const GDALWarpChunkThreadContext* psContext =
+        static_cast<const GDALWarpChunkThreadContext*>(
+            CPLGetTLS(CTLS_WARPCHUNKCONTEXT));
+    CPLAssert( psContext != NULL );
+    poWK->pTransformerArg = psContext->pTransformerArg;
+    poWK->psThreadData = psContext->psThreadData;
+    poWK->pfnProgress = ConcurrentChunksProgress;
+    poWK->pProgress = psChunks;
+}
+
+/************************************************************************/
+/*                       ChunkAndWarpConcurrent()                       */
+/*                                                                      */
+/*      Warp the chunks of the chunk list with several threads, each    */
+/*      with its own transformer. Returns false if that can't be set    */
+/*      up, in which case nothing has been done.                        */
+/************************************************************************/
+
+bool GDALWarpOperation::ChunkAndWarpConcurrent( int nThreads, CPLErr* peErr )
+
+{
+    const int nChunkThreads = std::min(nThreads, nChunkListCount);
+    // Remaining threads are given to the kernel of each chunk thread.
+    const int nKernelThreads = nThreads / nChunkThreads;
+
+    GDALWarpConcurrentChunks sChunks;
+    sChunks.poOperation = this;
+    sChunks.pasChunkList = pasChunkList;
+    sChunks.nChunkListCount = nChunkListCount;
+    sChunks.hIOMutex = hIOMutex;
+    sChunks.hMutex = NULL;
+    sChunks.iNextChunk = 0;
+    sChunks.eErr = CE_None;
+    sChunks.pfnProgress = psOptions->pfnProgress;
+    sChunks.pProgressArg = psOptions->pProgressArg;
+    sChunks.dfLastProgress = -1.0;
+    sChunks.bStop = false;
+
+    double dfTotalPixels = 0.0;
+    for( int iChunk = 0; iChunk < nChunkListCount; iChunk++ )
+    {
+        dfTotalPixels +=
+            pasChunkList[iChunk].dsx *
+            static_cast<double>(pasChunkList[iChunk].dsy);
+    }
+    double dfPixelsProcessed = 0.0;
+    for( int iChunk = 0; iChunk < nChunkListCount; iChunk++ )
+    {
+        const double dfChunkPixels =
+            pasChunkList[iChunk].dsx *
+            static_cast<double>(pasChunkList[iChunk].dsy);
+        sChunks.adfProgressBase.push_back(dfPixelsProcessed / dfTotalPixels);
+        sChunks.adfProgressScale.push_back(dfChunkPixels / dfTotalPixels);
+        dfPixelsProcessed += dfChunkPixels;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Duplicate the transformer and create kernel threads for each    */
+/*      chunk thread.                                                   */
+/* -------------------------------------------------------------------- */
+    char** papszKernelOptions = CSLSetNameValue(
+        CSLDuplicate(psOptions->papszWarpOptions), "NUM_THREADS",
+        CPLSPrintf("%d", nKernelThreads));
+    bool bSetupOK = true;
+    for( int i = 0; i < nChunkThreads; i++ )
+    {
+        GDALWarpChunkThreadContext sContext;
+        sContext.pTransformerArg =
+            GDALCloneTransformer(psOptions->pTransformerArg);
+        if( sContext.pTransformerArg == NULL )
+        {
+            bSetupOK = false;
+            break;
+        }
+        sContext.psThreadData = GWKThreadsCreate(papszKernelOptions,
+                                                 psOptions->pfnTransformer,
+                                                 sContext.pTransformerArg);
+        sChunks.asContexts.push_back(sContext);
+        if( sContext.psThreadData == NULL )
+        {
+            bSetupOK = false;
+            break;
+        }
+    }
+    CSLDestroy(papszKernelOptions);
+
+    if( bSetupOK )
+    {
+        CPLDebug( "WARP", "Warping %d chunks with %d threads (%d per chunk)",
+                  nChunkListCount, nChunkThreads, nKernelThreads );
+
+        sChunks.hMutex = CPLCreateMutex();
+        CPLReleaseMutex(sChunks.hMutex);
+
+        psConcurrentChunksData = &sChunks;
+
+        std::vector<GDALWarpConcurrentChunksJob> asJobs(nChunkThreads);
+        std::vector<CPLJoinableThread*> ahThreads;
+        for( int i = 0; i < nChunkThreads; i++ )
+        {
+            asJobs[i].psChunks = &sChunks;
+            asJobs[i].iContext = i;
+            CPLJoinableThread* hThread = CPLCreateJoinableThread(
+                ConcurrentChunkThreadMain, &asJobs[i]);
+            if( hThread == NULL )
+            {
+                CPLError(
+                    CE_Failure, CPLE_AppDefined,
+                    "CPLCreateJoinableThread() failed in ChunkAndWarpMulti()");
+                CPLMutexHolderD( &sChunks.hMutex );
+                sChunks.eErr = CE_Failure;
+                break;
+            }
+            ahThreads.push_back(hThread);
+        }
+        for( size_t i = 0; i < ahThreads.size(); i++ )
+            CPLJoinThread(ahThreads[i]);
+
+        psConcurrentChunksData = NULL;
+        CPLDestroyMutex(sChunks.hMutex);
+        *peErr = sChunks.eErr;
+    }
+    else
+    {
+        CPLDebug( "WARP", "Cannot duplicate transformer function. "
+                  "Falling back to warping one chunk at a time" );
+    }
+
+    for( size_t i = 0; i < sChunks.asContexts.size(); i++ )
+    {
+        GWKThreadsEnd(sChunks.asContexts[i].psThreadData);
+        GDALDestroyTransformer(sChunks.asContexts[i].pTransformerArg);
+    }
+
+    return bSetupOK;
+}
+
 /************************************************************************/
 /*                         ChunkAndWarpMulti()                          */
 /************************************************************************/
@@ -901,6 +1175,14 @@ static void ChunkThreadMain( void *pThreadData )
  * internally this method uses multiple threads to interleave input/output
  * for one region while the processing is being done for another.
  *
+ * Starting with GDAL 2.3, when the NUM_THREADS warp option (or the
+ * GDAL_NUM_THREADS configuration option) is greater than 1, the
+ * destination region is split in chunks that are warped concurrently by
+ * that number of threads, with the memory limit shared between them.
+ * Reads from the source dataset and reads and writes to the destination
+ * dataset are serialized, so this scales with the number of cores as long as
+ * the warping computation dominates the I/O.
+ *
  * @param nDstXOff X offset to window of destination data to be produced.
  * @param nDstYOff Y offset to window of destination data to be produced.
  * @param nDstXSize Width of output window on destination file to be produced.
@@ -913,21 +1195,41 @@ CPLErr GDALWarpOperation::ChunkAndWarpMulti(
     int nDstXOff, int nDstYOff,  int nDstXSize, int nDstYSize )
 
 {
-    hIOMutex = CPLCreateMutex();
-    hWarpMutex = CPLCreateMutex();
+    if( hIOMutex == NULL )
+    {
+        hIOMutex = CPLCreateMutex();
+        hWarpMutex = CPLCreateMutex();
 
-    CPLReleaseMutex( hIOMutex );
-    CPLReleaseMutex( hWarpMutex );
+        CPLReleaseMutex( hIOMutex );
+        CPLReleaseMutex( hWarpMutex );
+    }
 
-    CPLCond* hCond = CPLCreateCond();
-    CPLMutex* hCondMutex = CPLCreateMutex();
-    CPLReleaseMutex(hCondMutex);
+/* -------------------------------------------------------------------- */
+/*      When several warping threads are requested, split the memory    */
+/*      budget between them so that they can work on different          */
+/*      chunks at the same time.                                        */
+/* -------------------------------------------------------------------- */
+    const char* pszWarpThreads =
+        CSLFetchNameValue(psOptions->papszWarpOptions, "NUM_THREADS");
+    if( pszWarpThreads == NULL )
+        pszWarpThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+
+    int nThreads = EQUAL(pszWarpThreads, "ALL_CPUS") ?
+        CPLGetNumCPUs() : atoi(pszWarpThreads);
+    nThreads = std::max(1, std::min(128, nThreads));
+    // Application provided chunk processors might not be reentrant.
+    if( psOptions->pfnPreWarpChunkProcessor != NULL ||
+        psOptions->pfnPostWarpChunkProcessor != NULL )
+        nThreads = 1;
 
 /* -------------------------------------------------------------------- */
 /*      Collect the list of chunks to operate on.                       */
 /* -------------------------------------------------------------------- */
     WipeChunkList();
+    const double dfWarpMemoryLimit = psOptions->dfWarpMemoryLimit;
+    psOptions->dfWarpMemoryLimit /= nThreads;
     CollectChunkList( nDstXOff, nDstYOff, nDstXSize, nDstYSize );
+    psOptions->dfWarpMemoryLimit = dfWarpMemoryLimit;
 
     // Sort chucks from top to bottom, and for equal y, from left to right.
     // TODO(schwehr): Use std::sort.
@@ -935,6 +1237,18 @@ CPLErr GDALWarpOperation::ChunkAndWarpMulti(
         qsort(pasChunkList, nChunkListCount, sizeof(GDALWarpChunk),
               OrderWarpChunk);
 
+    CPLErr eErr = CE_None;
+    if( nThreads > 1 && nChunkListCount > 1 &&
+        ChunkAndWarpConcurrent( nThreads, &eErr ) )
+    {
+        WipeChunkList();
+        return eErr;
+    }
+
+    CPLCond* hCond = CPLCreateCond();
+    CPLMutex* hCondMutex = CPLCreateMutex();
+    CPLReleaseMutex(hCondMutex);
+
 /* -------------------------------------------------------------------- */
 /*      Process them one at a time, updating the progress               */
 /*      information for each region.                                    */
@@ -949,7 +1263,6 @@ CPLErr GDALWarpOperation::ChunkAndWarpMulti(
     double dfPixelsProcessed = 0.0;
     double dfTotalPixels = nDstXSize*(double)nDstYSize;
 
-    CPLErr eErr = CE_None;
     for( int iChunk = 0; iChunk < nChunkListCount+1; iChunk++ )
     {
         int iThread = iChunk % 2;
@@ -1719,6 +2032,9 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
     oWK.papszWarpOptions = psOptions->papszWarpOptions;
     oWK.psThreadData = psThreadData;
 
+    if( psConcurrentChunksData != NULL )
+        SetupKernelForConcurrentChunks( psConcurrentChunksData, &oWK );
+
     oWK.padfDstNoDataReal = psOptions->padfDstNoDataReal;
 
 /* -------------------------------------------------------------------- */
@@ -2085,7 +2401,9 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
     if( hIOMutex != NULL )
     {
         CPLReleaseMutex( hIOMutex );
-        if( !CPLAcquireMutex( hWarpMutex, 600.0 ) )
+        // Concurrent chunks are warped in parallel.
+        if( psConcurrentChunksData == NULL &&
+            !CPLAcquireMutex( hWarpMutex, 600.0 ) )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
                       "Failed to acquire WarpMutex in WarpRegion()." );
@@ -2121,7 +2439,8 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
 /* -------------------------------------------------------------------- */
     if( hIOMutex != NULL )
     {
-        CPLReleaseMutex( hWarpMutex );
+        if( psConcurrentChunksData == NULL )
+            CPLReleaseMutex( hWarpMutex );
         if( !CPLAcquireMutex( hIOMutex, 600.0 ) )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
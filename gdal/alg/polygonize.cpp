@@ -35,7 +35,10 @@
 #include <string.h>
 
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <new>
+#include <utility>
 #include <vector>
 
 #include "gdal_alg_priv.h"
@@ -47,6 +50,7 @@
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 
 CPL_CVSID("$Id$");
 
@@ -74,6 +78,9 @@ public:
     void             Dump() const;
     void             Coalesce();
     void             Merge( int iBaseString, int iSrcString, int iDirection );
+    void             AddDirectedSegment( int x1, int y1, int x2, int y2,
+                                         bool bNewString );
+    void             Stitch();
 };
 
 /************************************************************************/
@@ -190,6 +197,203 @@ void RPolygon::Merge( int iBaseString, int iSrcString, int iDirection )
     aanXY.resize(nSize - 1);
 }
 
+/************************************************************************/
+/*                       GPDropCollinearVertices()                      */
+/*                                                                      */
+/*      Remove the vertices of a closed ring that lie in the middle     */
+/*      of a straight edge.                                             */
+/************************************************************************/
+
+static bool GPCollinear( const std::vector<int> &anXY,
+                         size_t iA, size_t iB, size_t iC )
+{
+    return (anXY[iA*2] == anXY[iB*2] && anXY[iB*2] == anXY[iC*2]) ||
+           (anXY[iA*2+1] == anXY[iB*2+1] && anXY[iB*2+1] == anXY[iC*2+1]);
+}
+
+static void GPDropCollinearVertices( std::vector<int> &anRing )
+
+{
+    // The closing vertex is dropped while filtering, and put back after.
+    const size_t nVertices = anRing.size() / 2 - 1;
+    std::vector<int> anOut;
+    anOut.reserve( anRing.size() );
+
+    for( size_t iVert = 0; iVert < nVertices; iVert++ )
+    {
+        anOut.push_back( anRing[iVert*2] );
+        anOut.push_back( anRing[iVert*2+1] );
+
+        size_t nOut = anOut.size() / 2;
+        while( nOut >= 3 && GPCollinear( anOut, nOut-3, nOut-2, nOut-1 ) )
+        {
+            anOut.erase( anOut.end() - 4, anOut.end() - 2 );
+            nOut--;
+        }
+    }
+
+    // Then around the start of the ring.
+    bool bChanged = true;
+    while( bChanged && anOut.size() > 6 )
+    {
+        const size_t nOut = anOut.size() / 2;
+        bChanged = true;
+        if( GPCollinear( anOut, nOut-2, nOut-1, 0 ) )
+            anOut.resize( anOut.size() - 2 );
+        else if( GPCollinear( anOut, nOut-1, 0, 1 ) )
+            anOut.erase( anOut.begin(), anOut.begin() + 2 );
+        else
+            bChanged = false;
+    }
+
+    anOut.push_back( anOut[0] );
+    anOut.push_back( anOut[1] );
+    anRing.swap( anOut );
+}
+
+/************************************************************************/
+/*                               Stitch()                               */
+/*                                                                      */
+/*      Variant of Coalesce() used in tiled mode, where a polygon is    */
+/*      made of the strings of all the tiles it spans.  Strings are     */
+/*      directed (see AddDirectedSegment()) and chained through a       */
+/*      sorted index of their start points instead of being compared    */
+/*      to each other.  Where the polygon touches itself diagonally,    */
+/*      rings turn left, that is around the pixels outside the          */
+/*      polygon, so that there is one ring for the exterior and one     */
+/*      per hole.                                                       */
+/*      Vertices left in the middle of straight edges where strings     */
+/*      were joined are dropped, and the exterior ring is put first.    */
+/************************************************************************/
+
+static int GPSign( int nVal )
+{
+    return nVal > 0 ? 1 : nVal < 0 ? -1 : 0;
+}
+
+void RPolygon::Stitch()
+
+{
+    typedef std::pair<int,int> XY;
+
+    std::vector< std::pair<XY, int> > aoStarts;
+    aoStarts.reserve( aanXY.size() );
+
+    for( size_t iString = 0; iString < aanXY.size(); iString++ )
+    {
+        aoStarts.push_back( std::make_pair(
+            XY(aanXY[iString][0], aanXY[iString][1]),
+            static_cast<int>(iString) ) );
+    }
+    std::sort( aoStarts.begin(), aoStarts.end() );
+
+/* -------------------------------------------------------------------- */
+/*      Follow each string till we are back to its start.               */
+/* -------------------------------------------------------------------- */
+    std::vector<bool> abUsed( aanXY.size(), false );
+    std::vector< std::vector<int> > aanRings;
+
+    for( size_t iBaseString = 0; iBaseString < aanXY.size(); iBaseString++ )
+    {
+        if( abUsed[iBaseString] )
+            continue;
+        abUsed[iBaseString] = true;
+
+        std::vector<int> anRing;
+        anRing.swap( aanXY[iBaseString] );
+        const int nFirstDX = GPSign( anRing[2] - anRing[0] );
+        const int nFirstDY = GPSign( anRing[3] - anRing[1] );
+
+        while( true )
+        {
+            const size_t nRSize = anRing.size();
+            const int nX = anRing[nRSize-2];
+            const int nY = anRing[nRSize-1];
+            const int nDX = GPSign( nX - anRing[nRSize-4] );
+            const int nDY = GPSign( nY - anRing[nRSize-3] );
+
+            // Close the ring if we are back to its start, or go on with
+            // a string starting here.  If there are several choices, take
+            // the left turn.
+            int iChosen = -1;
+            bool bLeftTurn = false;
+            if( nX == anRing[0] && nY == anRing[1] )
+            {
+                iChosen = -2;
+                bLeftTurn = nFirstDX == nDY && nFirstDY == -nDX;
+            }
+
+            for( size_t i = std::lower_bound(
+                     aoStarts.begin(), aoStarts.end(),
+                     std::make_pair(XY(nX, nY), -1)) - aoStarts.begin();
+                 !bLeftTurn && i < aoStarts.size() &&
+                 aoStarts[i].first == XY(nX, nY);
+                 i++ )
+            {
+                const int iString = aoStarts[i].second;
+                if( abUsed[iString] )
+                    continue;
+
+                const std::vector<int> &anString = aanXY[iString];
+                bLeftTurn = GPSign( anString[2] - nX ) == nDY &&
+                            GPSign( anString[3] - nY ) == -nDX;
+                if( iChosen == -1 || bLeftTurn )
+                    iChosen = iString;
+            }
+
+            if( iChosen == -2 )
+                break;
+
+            if( iChosen == -1 )
+            {
+                // Should not happen with a consistent set of edges.
+                CPLDebug( "GDALPolygonize",
+                          "Could not close ring of polygon of value %g.",
+                          dfPolyValue );
+                anRing.push_back( anRing[0] );
+                anRing.push_back( anRing[1] );
+                break;
+            }
+
+            abUsed[iChosen] = true;
+            std::vector<int> &anString = aanXY[iChosen];
+            anRing.insert( anRing.end(), anString.begin() + 2,
+                           anString.end() );
+            std::vector<int>().swap( anString );
+        }
+
+        GPDropCollinearVertices( anRing );
+
+        aanRings.resize( aanRings.size() + 1 );
+        aanRings.back().swap( anRing );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      The top left vertex of the polygon is on its exterior ring.     */
+/* -------------------------------------------------------------------- */
+    size_t iExterior = 0;
+    int nMinX = aanRings[0][0];
+    int nMinY = aanRings[0][1];
+    for( size_t iRing = 0; iRing < aanRings.size(); iRing++ )
+    {
+        const std::vector<int> &anRing = aanRings[iRing];
+        for( size_t i = 0; i < anRing.size(); i += 2 )
+        {
+            if( anRing[i+1] < nMinY ||
+                (anRing[i+1] == nMinY && anRing[i] < nMinX) )
+            {
+                iExterior = iRing;
+                nMinX = anRing[i];
+                nMinY = anRing[i+1];
+            }
+        }
+    }
+    if( iExterior != 0 )
+        aanRings[0].swap( aanRings[iExterior] );
+
+    aanXY.swap( aanRings );
+}
+
 /************************************************************************/
 /*                             AddSegment()                             */
 /************************************************************************/
@@ -255,6 +459,76 @@ void RPolygon::AddSegment( int x1, int y1, int x2, int y2 )
     return;
 }
 
+/************************************************************************/
+/*                         AddDirectedSegment()                         */
+/*                                                                      */
+/*      Used in tiled mode, where segments go with the polygon on       */
+/*      their right (in pixel/line space), and strings are only         */
+/*      extended forward.  The caller asks for a new string when the    */
+/*      segment starts where the polygon may touch itself diagonally,   */
+/*      so that Stitch() decides how rings go through such vertices.    */
+/************************************************************************/
+
+void RPolygon::AddDirectedSegment( int x1, int y1, int x2, int y2,
+                                   bool bNewString )
+
+{
+    nLastLineUpdated = std::max(y1, y2);
+
+    // Recent strings are the most likely to continue.
+    for( size_t iString = aanXY.size(); !bNewString && iString > 0;
+         iString-- )
+    {
+        std::vector<int> &anString = aanXY[iString - 1];
+        const size_t nSSize = anString.size();
+
+        if( anString[nSSize-2] != x1 || anString[nSSize-1] != y1 )
+            continue;
+
+        // Extend the last segment if it goes in the same direction.
+        if( (anString[nSSize-4] == x1 && x1 == x2) ||
+            (anString[nSSize-3] == y1 && y1 == y2) )
+        {
+            anString[nSSize-2] = x2;
+            anString[nSSize-1] = y2;
+        }
+        else
+        {
+            anString.push_back( x2 );
+            anString.push_back( y2 );
+        }
+        return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Or is there one it extends backwards in a straight line, as     */
+/*      happens on the left side of polygons?                           */
+/* -------------------------------------------------------------------- */
+    for( size_t iString = aanXY.size(); !bNewString && iString > 0;
+         iString-- )
+    {
+        std::vector<int> &anString = aanXY[iString - 1];
+
+        if( anString[0] == x2 && anString[1] == y2 &&
+            ((anString[2] == x2 && x1 == x2) ||
+             (anString[3] == y2 && y1 == y2)) )
+        {
+            anString[0] = x1;
+            anString[1] = y1;
+            return;
+        }
+    }
+
+    const size_t nSize = aanXY.size();
+    aanXY.resize(nSize + 1);
+    std::vector<int> &anString = aanXY[nSize];
+
+    anString.push_back( x1 );
+    anString.push_back( y1 );
+    anString.push_back( x2 );
+    anString.push_back( y2 );
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*     End of RPolygon                                                  */
@@ -328,27 +602,21 @@ static void AddEdges( GInt32 *panThisLineId, GInt32 *panLastLineId,
 }
 
 /************************************************************************/
-/*                         EmitPolygonToLayer()                         */
+/*                          GPCreatePolygon()                           */
+/*                                                                      */
+/*      Create the polygon geometry of coalesced rings, in              */
+/*      georeferenced coordinates.                                      */
 /************************************************************************/
 
-static CPLErr
-EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
-                    RPolygon *poRPoly, double *padfGeoTransform )
+static OGRGeometryH
+GPCreatePolygon( const RPolygon *poRPoly, const double *padfGeoTransform )
 
 {
-/* -------------------------------------------------------------------- */
-/*      Turn bits of lines into coherent rings.                         */
-/* -------------------------------------------------------------------- */
-    poRPoly->Coalesce();
-
-/* -------------------------------------------------------------------- */
-/*      Create the polygon geometry.                                    */
-/* -------------------------------------------------------------------- */
     OGRGeometryH hPolygon = OGR_G_CreateGeometry( wkbPolygon );
 
     for( size_t iString = 0; iString < poRPoly->aanXY.size(); iString++ )
     {
-        std::vector<int> &anString = poRPoly->aanXY[iString];
+        const std::vector<int> &anString = poRPoly->aanXY[iString];
         OGRGeometryH hRing = OGR_G_CreateGeometry( wkbLinearRing );
 
         // We go last to first to ensure the linestring is allocated to
@@ -375,6 +643,20 @@ EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
         OGR_G_AddGeometryDirectly( hPolygon, hRing );
     }
 
+    return hPolygon;
+}
+
+/************************************************************************/
+/*                           GPWritePolygon()                           */
+/*                                                                      */
+/*      Write a polygon geometry to the layer, taking ownership of it.  */
+/************************************************************************/
+
+static CPLErr
+GPWritePolygon( OGRLayerH hOutLayer, int iPixValField,
+                OGRGeometryH hPolygon, double dfPolyValue )
+
+{
 /* -------------------------------------------------------------------- */
 /*      Create the feature object.                                      */
 /* -------------------------------------------------------------------- */
@@ -383,7 +665,7 @@ EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
     OGR_F_SetGeometryDirectly( hFeat, hPolygon );
 
     if( iPixValField >= 0 )
-        OGR_F_SetFieldDouble( hFeat, iPixValField, poRPoly->dfPolyValue );
+        OGR_F_SetFieldDouble( hFeat, iPixValField, dfPolyValue );
 
 /* -------------------------------------------------------------------- */
 /*      Write the to the layer.                                         */
@@ -398,6 +680,25 @@ EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
     return eErr;
 }
 
+/************************************************************************/
+/*                         EmitPolygonToLayer()                         */
+/************************************************************************/
+
+static CPLErr
+EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
+                    RPolygon *poRPoly, double *padfGeoTransform )
+
+{
+/* -------------------------------------------------------------------- */
+/*      Turn bits of lines into coherent rings.                         */
+/* -------------------------------------------------------------------- */
+    poRPoly->Coalesce();
+
+    return GPWritePolygon( hOutLayer, iPixValField,
+                           GPCreatePolygon( poRPoly, padfGeoTransform ),
+                           poRPoly->dfPolyValue );
+}
+
 /************************************************************************/
 /*                          GPMaskImageData()                           */
 /*                                                                      */
@@ -427,6 +728,716 @@ GPMaskImageData( GDALRasterBandH hMaskBand, GByte* pabyMaskLine,
     return CE_None;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*      Tiled mode.                                                     */
+/*                                                                      */
+/*      The raster is processed by horizontal strips of square tiles.   */
+/*      Each tile is polygonized on its own, possibly in a worker       */
+/*      thread, looking one pixel beyond its border to decide where     */
+/*      edges lie.  Polygons entirely inside a tile are complete.       */
+/*      The pieces touching a tile border are then merged, in strip     */
+/*      order, with the pieces of the neighbouring tiles they connect   */
+/*      to, and the polygons that do not reach the bottom of the        */
+/*      strip are written out.                                          */
+/* ==================================================================== */
+/************************************************************************/
+
+template<class DataType>
+struct GPTileJob
+{
+    // Values of the strip, with one line above and below it, and one
+    // nodata column on each side of the raster.
+    DataType     *panStripVal;
+    int           nStride;
+
+    int           nXOff;
+    int           nYOff;
+    int           nXSize;
+    int           nYSize;
+    int           nConnectedness;
+    const double *padfGeoTransform;
+
+    CPLErr        eErr;
+
+    // Complete polygons, not touching the tile border.
+    std::vector<OGRGeometryH> ahPolygons;
+    std::vector<double>       adfPolygonValue;
+
+    // Pieces of polygons touching the tile border, and the index of the
+    // piece each border pixel belongs to, or -1 for nodata.
+    std::vector<RPolygon *>   apoBorderPoly;
+    std::vector<GInt32>       anTopId;
+    std::vector<GInt32>       anBottomId;
+    std::vector<GInt32>       anLeftId;
+    std::vector<GInt32>       anRightId;
+};
+
+/************************************************************************/
+/*                         GPTileBorderIndex()                          */
+/************************************************************************/
+
+template<class DataType>
+static GInt32 GPTileBorderIndex( GPTileJob<DataType> *psJob,
+                                 const DataType *panPolyValue,
+                                 std::vector<RPolygon *> &apoPoly,
+                                 std::vector<GInt32> &anBorderIndex,
+                                 GInt32 nId )
+{
+    if( nId == -1 )
+        return -1;
+
+    if( anBorderIndex[nId] == -1 )
+    {
+        anBorderIndex[nId] =
+            static_cast<GInt32>(psJob->apoBorderPoly.size());
+        apoPoly[nId] = new RPolygon( panPolyValue[nId] );
+        psJob->apoBorderPoly.push_back( apoPoly[nId] );
+    }
+
+    return anBorderIndex[nId];
+}
+
+/************************************************************************/
+/*                         GPIsDiagonalVertex()                         */
+/*                                                                      */
+/*      Whether the pixels of value nPolyVal around tile vertex         */
+/*      (iX,iY) are only on one of its diagonals, in which case a       */
+/*      polygon may touch itself there.                                 */
+/************************************************************************/
+
+template<class DataType, class EqualityTest>
+static bool GPIsDiagonalVertex( const DataType *panVal, int nStride,
+                                int iX, int iY, DataType nPolyVal )
+
+{
+    EqualityTest eq;
+    bool abSame[4];
+    for( int i = 0; i < 4; i++ )
+    {
+        const DataType nVal =
+            panVal[(iY - 1 + i / 2) * nStride + iX - 1 + i % 2];
+        abSame[i] = nVal != GP_NODATA_MARKER && eq.operator()(nVal, nPolyVal);
+    }
+
+    return abSame[0] == abSame[3] && abSame[1] == abSame[2] &&
+           abSame[0] != abSame[1];
+}
+
+/************************************************************************/
+/*                           GPAddTileEdge()                            */
+/*                                                                      */
+/*      Add the edge (nX1,nY1)-(nX2,nY2) between tile pixels            */
+/*      (iXA,iYA) and (iXB,iYB) to the polygons on each side of it,     */
+/*      if they differ.  Pixel A is on the right of the edge going      */
+/*      from (nX1,nY1) to (nX2,nY2).  One of the pixels may be          */
+/*      outside the tile, in which case only its value is known.        */
+/************************************************************************/
+
+template<class DataType, class EqualityTest>
+static void GPAddTileEdge( const GPTileJob<DataType> *psJob,
+                           const DataType *panVal, const GInt32 *panId,
+                           std::vector<RPolygon *> &apoPoly,
+                           int iXA, int iYA, int iXB, int iYB,
+                           int nX1, int nY1, int nX2, int nY2 )
+
+{
+    const int nXSize = psJob->nXSize;
+    const int nYSize = psJob->nYSize;
+    const int nStride = psJob->nStride;
+    const bool bAIn = iXA >= 0 && iXA < nXSize && iYA >= 0 && iYA < nYSize;
+    const bool bBIn = iXB >= 0 && iXB < nXSize && iYB >= 0 && iYB < nYSize;
+
+    const GInt32 nIdA = bAIn ? panId[iYA * nXSize + iXA] : -1;
+    const GInt32 nIdB = bBIn ? panId[iYB * nXSize + iXB] : -1;
+    const DataType nValA = panVal[iYA * nStride + iXA];
+    const DataType nValB = panVal[iYB * nStride + iXB];
+
+    if( bAIn && bBIn )
+    {
+        if( nIdA == nIdB )
+            return;
+    }
+    else
+    {
+        // Across the tile border, pixels of the same value are in the
+        // same polygon.
+        EqualityTest eq;
+        if( nValA != GP_NODATA_MARKER && nValB != GP_NODATA_MARKER &&
+            eq.operator()(nValA, nValB) )
+            return;
+    }
+
+    if( nIdA != -1 )
+    {
+        apoPoly[nIdA]->AddDirectedSegment(
+            nX1, nY1, nX2, nY2,
+            GPIsDiagonalVertex<DataType, EqualityTest>(
+                panVal, nStride,
+                nX1 - psJob->nXOff, nY1 - psJob->nYOff, nValA) );
+    }
+    if( nIdB != -1 )
+    {
+        apoPoly[nIdB]->AddDirectedSegment(
+            nX2, nY2, nX1, nY1,
+            GPIsDiagonalVertex<DataType, EqualityTest>(
+                panVal, nStride,
+                nX2 - psJob->nXOff, nY2 - psJob->nYOff, nValB) );
+    }
+}
+
+/************************************************************************/
+/*                          GPTileJobFunc()                             */
+/************************************************************************/
+
+template<class DataType, class EqualityTest>
+static void GPTileJobFunc( void *pData )
+
+{
+    GPTileJob<DataType> *psJob = static_cast<GPTileJob<DataType> *>(pData);
+    const int nXSize = psJob->nXSize;
+    const int nYSize = psJob->nYSize;
+    const int nStride = psJob->nStride;
+
+    // Value of tile pixel (0,0).
+    DataType *panVal = psJob->panStripVal + nStride + psJob->nXOff + 1;
+
+    GInt32 *panId = static_cast<GInt32 *>(
+        VSI_MALLOC3_VERBOSE(sizeof(GInt32), nXSize, nYSize));
+    if( panId == NULL )
+    {
+        psJob->eErr = CE_Failure;
+        return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Identify the polygons of the tile.                              */
+/* -------------------------------------------------------------------- */
+    GDALRasterPolygonEnumeratorT<DataType,
+                                 EqualityTest> oEnum(psJob->nConnectedness);
+
+    for( int iY = 0; iY < nYSize; iY++ )
+    {
+        if( iY == 0 )
+            oEnum.ProcessLine( NULL, panVal, NULL, panId, nXSize );
+        else
+            oEnum.ProcessLine( panVal + (iY-1) * nStride,
+                               panVal + iY * nStride,
+                               panId + (iY-1) * nXSize,
+                               panId + iY * nXSize,
+                               nXSize );
+    }
+
+    oEnum.CompleteMerges();
+
+    for( size_t i = 0; i < static_cast<size_t>(nXSize) * nYSize; i++ )
+    {
+        if( panId[i] != -1 )
+            panId[i] = oEnum.panPolyIdMap[panId[i]];
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Number the polygons touching the tile border, which are         */
+/*      handed back to the caller for merging.                          */
+/* -------------------------------------------------------------------- */
+    std::vector<RPolygon *> apoPoly( oEnum.nNextPolygonId,
+                                     static_cast<RPolygon *>(NULL) );
+    std::vector<GInt32> anBorderIndex( oEnum.nNextPolygonId, -1 );
+
+    psJob->anTopId.resize( nXSize );
+    psJob->anBottomId.resize( nXSize );
+    for( int iX = 0; iX < nXSize; iX++ )
+    {
+        psJob->anTopId[iX] = GPTileBorderIndex(
+            psJob, oEnum.panPolyValue, apoPoly, anBorderIndex, panId[iX] );
+        psJob->anBottomId[iX] = GPTileBorderIndex(
+            psJob, oEnum.panPolyValue, apoPoly, anBorderIndex,
+            panId[(nYSize-1) * nXSize + iX] );
+    }
+
+    psJob->anLeftId.resize( nYSize );
+    psJob->anRightId.resize( nYSize );
+    for( int iY = 0; iY < nYSize; iY++ )
+    {
+        psJob->anLeftId[iY] = GPTileBorderIndex(
+            psJob, oEnum.panPolyValue, apoPoly, anBorderIndex,
+            panId[iY * nXSize] );
+        psJob->anRightId[iY] = GPTileBorderIndex(
+            psJob, oEnum.panPolyValue, apoPoly, anBorderIndex,
+            panId[iY * nXSize + nXSize - 1] );
+    }
+
+    for( int iPoly = 0; iPoly < oEnum.nNextPolygonId; iPoly++ )
+    {
+        if( oEnum.panPolyIdMap[iPoly] == iPoly && apoPoly[iPoly] == NULL )
+            apoPoly[iPoly] = new RPolygon( oEnum.panPolyValue[iPoly] );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Collect the edges in the same order as the untiled second       */
+/*      pass: the edge above each pixel, and the one on its right.      */
+/* -------------------------------------------------------------------- */
+    for( int iY = 0; iY <= nYSize; iY++ )
+    {
+        const int nY = psJob->nYOff + iY;
+
+        const GInt32 *panThisId = panId + iY * nXSize;
+
+        for( int iX = -1; iX < nXSize; iX++ )
+        {
+            const int nX = psJob->nXOff + iX;
+
+            // Skip quickly the many edges inside polygons.
+            if( iX >= 0 &&
+                (iY == 0 || iY == nYSize ||
+                 panThisId[iX] != panThisId[iX - nXSize]) )
+                GPAddTileEdge<DataType, EqualityTest>(
+                    psJob, panVal, panId, apoPoly,
+                    iX, iY, iX, iY - 1, nX, nY, nX + 1, nY );
+
+            if( iY < nYSize &&
+                (iX < 0 || iX == nXSize - 1 ||
+                 panThisId[iX] != panThisId[iX + 1]) )
+                GPAddTileEdge<DataType, EqualityTest>(
+                    psJob, panVal, panId, apoPoly,
+                    iX, iY, iX + 1, iY, nX + 1, nY, nX + 1, nY + 1 );
+        }
+    }
+
+    CPLFree( panId );
+
+/* -------------------------------------------------------------------- */
+/*      Polygons inside the tile are complete.                          */
+/* -------------------------------------------------------------------- */
+    for( int iPoly = 0; iPoly < oEnum.nNextPolygonId; iPoly++ )
+    {
+        if( apoPoly[iPoly] == NULL || anBorderIndex[iPoly] != -1 )
+            continue;
+
+        apoPoly[iPoly]->Stitch();
+        psJob->ahPolygons.push_back(
+            GPCreatePolygon( apoPoly[iPoly], psJob->padfGeoTransform ) );
+        psJob->adfPolygonValue.push_back( apoPoly[iPoly]->dfPolyValue );
+        delete apoPoly[iPoly];
+    }
+}
+
+/************************************************************************/
+/*                             GPFindRoot()                             */
+/************************************************************************/
+
+static int GPFindRoot( std::vector<int> &anParent, int i )
+{
+    while( anParent[i] != i )
+    {
+        anParent[i] = anParent[anParent[i]];
+        i = anParent[i];
+    }
+    return i;
+}
+
+/************************************************************************/
+/*                             GPUnion()                                */
+/************************************************************************/
+
+static void GPUnion( std::vector<int> &anParent, int i, int j )
+{
+    i = GPFindRoot( anParent, i );
+    j = GPFindRoot( anParent, j );
+
+    // Keep the oldest piece as the root.
+    if( i < j )
+        anParent[j] = i;
+    else if( j < i )
+        anParent[i] = j;
+}
+
+/************************************************************************/
+/*                           GPMergeStrip()                             */
+/*                                                                      */
+/*      Write the polygons of the tiles of a strip, merging the         */
+/*      pieces that connect across tile borders, and across the top     */
+/*      of the strip with the pieces carried over from the previous     */
+/*      strip.  Pieces reaching the bottom of the strip are carried     */
+/*      over to the next one, unless this is the last strip.            */
+/************************************************************************/
+
+template<class DataType, class EqualityTest>
+static CPLErr
+GPMergeStrip( GPTileJob<DataType> *pasJobs, int nTilesX, bool bLastStrip,
+              std::vector<GInt32> &anCarryId,
+              std::vector<RPolygon *> &apoCarryPoly,
+              OGRLayerH hOutLayer, int iPixValField,
+              const double *padfGeoTransform )
+
+{
+    CPLErr eErr = CE_None;
+    EqualityTest eq;
+    const int nXSize = static_cast<int>(anCarryId.size());
+    const int nStride = pasJobs[0].nStride;
+    const int nLines = pasJobs[0].nYSize;
+    const int nConnectedness = pasJobs[0].nConnectedness;
+    // Value of pixel (0,0) of the strip.
+    const DataType *panVal = pasJobs[0].panStripVal + nStride + 1;
+
+/* -------------------------------------------------------------------- */
+/*      Write the polygons that were complete within their tile.        */
+/* -------------------------------------------------------------------- */
+    for( int iTile = 0; iTile < nTilesX; iTile++ )
+    {
+        GPTileJob<DataType> &sJob = pasJobs[iTile];
+        for( size_t i = 0; i < sJob.ahPolygons.size(); i++ )
+        {
+            if( eErr == CE_None )
+                eErr = GPWritePolygon( hOutLayer, iPixValField,
+                                       sJob.ahPolygons[i],
+                                       sJob.adfPolygonValue[i] );
+            else
+                OGR_G_DestroyGeometry( sJob.ahPolygons[i] );
+        }
+        sJob.ahPolygons.clear();
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Gather the pieces carried over from the previous strip and the  */
+/*      border pieces of the tiles.                                     */
+/* -------------------------------------------------------------------- */
+    std::vector<RPolygon *> apoPiece;
+    apoPiece.swap( apoCarryPoly );
+
+    std::vector<int> anTileBase( nTilesX );
+    for( int iTile = 0; iTile < nTilesX; iTile++ )
+    {
+        anTileBase[iTile] = static_cast<int>(apoPiece.size());
+        apoPiece.insert( apoPiece.end(),
+                         pasJobs[iTile].apoBorderPoly.begin(),
+                         pasJobs[iTile].apoBorderPoly.end() );
+        pasJobs[iTile].apoBorderPoly.clear();
+    }
+
+    std::vector<int> anParent( apoPiece.size() );
+    for( size_t i = 0; i < anParent.size(); i++ )
+        anParent[i] = static_cast<int>(i);
+
+    const int nDelta = nConnectedness == 8 ? 1 : 0;
+
+/* -------------------------------------------------------------------- */
+/*      Connect pieces across the top of the strip.                     */
+/* -------------------------------------------------------------------- */
+    for( int iTile = 0; iTile < nTilesX; iTile++ )
+    {
+        const GPTileJob<DataType> &sJob = pasJobs[iTile];
+        for( int iX = 0; iX < sJob.nXSize; iX++ )
+        {
+            if( sJob.anTopId[iX] == -1 )
+                continue;
+
+            const int nX = sJob.nXOff + iX;
+            const int iPiece = anTileBase[iTile] + sJob.anTopId[iX];
+            for( int nXAbove = std::max(0, nX - nDelta);
+                 nXAbove <= std::min(nXSize - 1, nX + nDelta);
+                 nXAbove++ )
+            {
+                if( anCarryId[nXAbove] != -1 &&
+                    eq.operator()(panVal[nXAbove - nStride], panVal[nX]) )
+                    GPUnion( anParent, iPiece, anCarryId[nXAbove] );
+            }
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Connect pieces across the tile borders within the strip.        */
+/* -------------------------------------------------------------------- */
+    for( int iTile = 1; iTile < nTilesX; iTile++ )
+    {
+        const GPTileJob<DataType> &sJob = pasJobs[iTile];
+        const GPTileJob<DataType> &sLeftJob = pasJobs[iTile - 1];
+        const int nX = sJob.nXOff;
+
+        for( int iY = 0; iY < nLines; iY++ )
+        {
+            if( sJob.anLeftId[iY] == -1 )
+                continue;
+
+            const int iPiece = anTileBase[iTile] + sJob.anLeftId[iY];
+            for( int iYLeft = std::max(0, iY - nDelta);
+                 iYLeft <= std::min(nLines - 1, iY + nDelta);
+                 iYLeft++ )
+            {
+                if( sLeftJob.anRightId[iYLeft] != -1 &&
+                    eq.operator()(panVal[iYLeft * nStride + nX - 1],
+                                  panVal[iY * nStride + nX]) )
+                    GPUnion( anParent, iPiece,
+                             anTileBase[iTile - 1] +
+                             sLeftJob.anRightId[iYLeft] );
+            }
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Move the strings of each piece to the root of its polygon.      */
+/* -------------------------------------------------------------------- */
+    for( size_t i = 0; i < apoPiece.size(); i++ )
+    {
+        const int iRoot = GPFindRoot( anParent, static_cast<int>(i) );
+        if( iRoot == static_cast<int>(i) )
+            continue;
+
+        std::vector< std::vector<int> > &aanRootXY = apoPiece[iRoot]->aanXY;
+        std::vector< std::vector<int> > &aanXY = apoPiece[i]->aanXY;
+        for( size_t iString = 0; iString < aanXY.size(); iString++ )
+        {
+            aanRootXY.resize( aanRootXY.size() + 1 );
+            aanRootXY.back().swap( aanXY[iString] );
+        }
+        delete apoPiece[i];
+        apoPiece[i] = NULL;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Carry over the polygons reaching the bottom of the strip.       */
+/* -------------------------------------------------------------------- */
+    std::vector<int> anCarryIndex( apoPiece.size(), -1 );
+
+    for( int iTile = 0; iTile < nTilesX; iTile++ )
+    {
+        const GPTileJob<DataType> &sJob = pasJobs[iTile];
+        for( int iX = 0; iX < sJob.nXSize; iX++ )
+        {
+            const int nX = sJob.nXOff + iX;
+            anCarryId[nX] = -1;
+            if( bLastStrip || sJob.anBottomId[iX] == -1 )
+                continue;
+
+            const int iRoot = GPFindRoot(
+                anParent, anTileBase[iTile] + sJob.anBottomId[iX] );
+            if( anCarryIndex[iRoot] == -1 )
+            {
+                anCarryIndex[iRoot] = static_cast<int>(apoCarryPoly.size());
+                apoCarryPoly.push_back( apoPiece[iRoot] );
+            }
+            anCarryId[nX] = anCarryIndex[iRoot];
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      And write the others.                                           */
+/* -------------------------------------------------------------------- */
+    for( size_t i = 0; i < apoPiece.size(); i++ )
+    {
+        if( apoPiece[i] == NULL || anCarryIndex[i] != -1 )
+            continue;
+
+        if( eErr == CE_None )
+        {
+            apoPiece[i]->Stitch();
+            eErr = GPWritePolygon( hOutLayer, iPixValField,
+                                   GPCreatePolygon( apoPiece[i],
+                                                    padfGeoTransform ),
+                                   apoPiece[i]->dfPolyValue );
+        }
+        delete apoPiece[i];
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                         GDALPolygonizeTiledT()                       */
+/************************************************************************/
+
+template<class DataType, class EqualityTest>
+static CPLErr
+GDALPolygonizeTiledT( GDALRasterBandH hSrcBand,
+                      GDALRasterBandH hMaskBand,
+                      OGRLayerH hOutLayer, int iPixValField,
+                      int nConnectedness, int nTileSize, int nThreads,
+                      const double *padfGeoTransform,
+                      GDALProgressFunc pfnProgress,
+                      void * pProgressArg,
+                      GDALDataType eDT )
+
+{
+    const int nXSize = GDALGetRasterBandXSize( hSrcBand );
+    const int nYSize = GDALGetRasterBandYSize( hSrcBand );
+    const int nStride = nXSize + 2;
+
+    nTileSize = std::min(nTileSize, std::max(nXSize, nYSize));
+    const int nTilesX = (nXSize + nTileSize - 1) / nTileSize;
+    const int nStrips = (nYSize + nTileSize - 1) / nTileSize;
+
+    // Process as many strips at once as needed to give each thread a tile.
+    const int nGroupStrips =
+        std::max(1, std::min(nStrips, (nThreads + nTilesX - 1) / nTilesX));
+
+    CPLDebug( "GDALPolygonize",
+              "Processing %d strips of %d tiles of %d pixels, %d thread(s).",
+              nStrips, nTilesX, nTileSize, nThreads );
+
+/* -------------------------------------------------------------------- */
+/*      Allocate working buffers.                                       */
+/* -------------------------------------------------------------------- */
+    CPLErr eErr = CE_None;
+    std::vector<DataType *> apanStripVal;
+    for( int i = 0; eErr == CE_None && i < nGroupStrips; i++ )
+    {
+        DataType *panStripVal = static_cast<DataType *>(
+            VSI_MALLOC3_VERBOSE(sizeof(DataType), nStride, nTileSize + 2));
+        if( panStripVal == NULL )
+            eErr = CE_Failure;
+        else
+            apanStripVal.push_back( panStripVal );
+    }
+
+    GByte *pabyMaskLine =
+        hMaskBand != NULL
+        ? static_cast<GByte *>(VSI_MALLOC_VERBOSE(nXSize))
+        : NULL;
+    if( hMaskBand != NULL && pabyMaskLine == NULL )
+        eErr = CE_Failure;
+
+    CPLWorkerThreadPool *poThreadPool = NULL;
+    if( eErr == CE_None && nThreads > 1 && nGroupStrips * nTilesX > 1 )
+    {
+        poThreadPool = new (std::nothrow) CPLWorkerThreadPool();
+        if( poThreadPool == NULL ||
+            !poThreadPool->Setup(std::min(nThreads, nGroupStrips * nTilesX),
+                                 NULL, NULL) )
+        {
+            // Tiles will be processed sequentially.
+            delete poThreadPool;
+            poThreadPool = NULL;
+        }
+    }
+
+    // Pieces of polygons reaching the bottom of the previous strip, and
+    // the piece each pixel of its last line belongs to.
+    std::vector<GInt32> anCarryId( nXSize, -1 );
+    std::vector<RPolygon *> apoCarryPoly;
+
+    for( int iGroupStart = 0;
+         eErr == CE_None && iGroupStart < nStrips;
+         iGroupStart += nGroupStrips )
+    {
+        const int nGroupCount = std::min(nGroupStrips, nStrips - iGroupStart);
+        std::vector< GPTileJob<DataType> > asJobs( nGroupCount * nTilesX );
+
+/* -------------------------------------------------------------------- */
+/*      Read the strips, with the line above and below each of them.    */
+/* -------------------------------------------------------------------- */
+        for( int i = 0; eErr == CE_None && i < nGroupCount; i++ )
+        {
+            const int nYOff = (iGroupStart + i) * nTileSize;
+            const int nLines = std::min(nTileSize, nYSize - nYOff);
+            DataType *panStripVal = apanStripVal[i];
+
+            for( int iLine = 0; eErr == CE_None && iLine < nLines + 2; iLine++ )
+            {
+                DataType *panLineVal = panStripVal + iLine * nStride;
+                const int iY = nYOff + iLine - 1;
+
+                panLineVal[0] = GP_NODATA_MARKER;
+                panLineVal[nXSize + 1] = GP_NODATA_MARKER;
+                if( iY < 0 || iY >= nYSize )
+                {
+                    for( int iX = 1; iX <= nXSize; iX++ )
+                        panLineVal[iX] = GP_NODATA_MARKER;
+                    continue;
+                }
+
+                eErr = GDALRasterIO( hSrcBand, GF_Read, 0, iY, nXSize, 1,
+                                     panLineVal + 1, nXSize, 1, eDT, 0, 0 );
+
+                if( eErr == CE_None && hMaskBand != NULL )
+                    eErr = GPMaskImageData( hMaskBand, pabyMaskLine, iY,
+                                            nXSize, panLineVal + 1 );
+            }
+
+            for( int iTile = 0; iTile < nTilesX; iTile++ )
+            {
+                GPTileJob<DataType> &sJob = asJobs[i * nTilesX + iTile];
+                sJob.panStripVal = panStripVal;
+                sJob.nStride = nStride;
+                sJob.nXOff = iTile * nTileSize;
+                sJob.nYOff = nYOff;
+                sJob.nXSize = std::min(nTileSize, nXSize - sJob.nXOff);
+                sJob.nYSize = nLines;
+                sJob.nConnectedness = nConnectedness;
+                sJob.padfGeoTransform = padfGeoTransform;
+                sJob.eErr = CE_None;
+            }
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Polygonize the tiles.                                           */
+/* -------------------------------------------------------------------- */
+        if( eErr == CE_None )
+        {
+            if( poThreadPool != NULL )
+            {
+                for( size_t i = 0; i < asJobs.size(); i++ )
+                    poThreadPool->SubmitJob(
+                        GPTileJobFunc<DataType, EqualityTest>, &asJobs[i] );
+                poThreadPool->WaitCompletion();
+            }
+            else
+            {
+                for( size_t i = 0; i < asJobs.size(); i++ )
+                    GPTileJobFunc<DataType, EqualityTest>( &asJobs[i] );
+            }
+
+            for( size_t i = 0; i < asJobs.size(); i++ )
+            {
+                if( asJobs[i].eErr != CE_None )
+                    eErr = CE_Failure;
+            }
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Merge them, strip after strip.                                  */
+/* -------------------------------------------------------------------- */
+        for( int i = 0; eErr == CE_None && i < nGroupCount; i++ )
+        {
+            const int iStrip = iGroupStart + i;
+            eErr = GPMergeStrip<DataType, EqualityTest>(
+                &asJobs[i * nTilesX], nTilesX, iStrip == nStrips - 1,
+                anCarryId, apoCarryPoly,
+                hOutLayer, iPixValField, padfGeoTransform );
+
+            if( eErr == CE_None
+                && !pfnProgress( (iStrip + 1) / static_cast<double>(nStrips),
+                                 "", pProgressArg ) )
+            {
+                CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+                eErr = CE_Failure;
+            }
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Release what was not consumed if we stopped on an error.        */
+/* -------------------------------------------------------------------- */
+        for( size_t i = 0; i < asJobs.size(); i++ )
+        {
+            for( size_t j = 0; j < asJobs[i].ahPolygons.size(); j++ )
+                OGR_G_DestroyGeometry( asJobs[i].ahPolygons[j] );
+            for( size_t j = 0; j < asJobs[i].apoBorderPoly.size(); j++ )
+                delete asJobs[i].apoBorderPoly[j];
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Cleanup                                                         */
+/* -------------------------------------------------------------------- */
+    for( size_t i = 0; i < apoCarryPoly.size(); i++ )
+        delete apoCarryPoly[i];
+    for( size_t i = 0; i < apanStripVal.size(); i++ )
+        CPLFree( apanStripVal[i] );
+    CPLFree( pabyMaskLine );
+    delete poThreadPool;
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                           GDALPolygonizeT()                          */
 /************************************************************************/
@@ -462,6 +1473,58 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
         return CE_Failure;
     }
 
+/* -------------------------------------------------------------------- */
+/*      Get the geotransform, if there is one, so we can convert the    */
+/*      vectors into georeferenced coordinates.                         */
+/* -------------------------------------------------------------------- */
+    double adfGeoTransform[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+
+    const char* pszDatasetForGeoRef = CSLFetchNameValue(papszOptions,
+                                                        "DATASET_FOR_GEOREF");
+    if( pszDatasetForGeoRef )
+    {
+        GDALDatasetH hSrcDS = GDALOpen(pszDatasetForGeoRef, GA_ReadOnly);
+        if( hSrcDS )
+        {
+            GDALGetGeoTransform( hSrcDS, adfGeoTransform );
+            GDALClose(hSrcDS);
+        }
+    }
+    else
+    {
+        GDALDatasetH hSrcDS = GDALGetBandDataset( hSrcBand );
+        if( hSrcDS )
+            GDALGetGeoTransform( hSrcDS, adfGeoTransform );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Use the tiled mode if a tile size or a number of threads was    */
+/*      requested.                                                      */
+/* -------------------------------------------------------------------- */
+    const char *pszTileSize = CSLFetchNameValue( papszOptions, "TILE_SIZE" );
+    const char *pszNumThreads =
+        CSLFetchNameValue( papszOptions, "NUM_THREADS" );
+    if( pszTileSize != NULL || pszNumThreads != NULL )
+    {
+        const int nTileSize = pszTileSize ? atoi(pszTileSize) : 1024;
+        if( nTileSize <= 0 )
+        {
+            CPLError( CE_Failure, CPLE_IllegalArg,
+                      "Invalid value for TILE_SIZE: %s", pszTileSize );
+            return CE_Failure;
+        }
+
+        if( pszNumThreads == NULL )
+            pszNumThreads = CPLGetConfigOption( "GDAL_NUM_THREADS", "1" );
+        const int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                                CPLGetNumCPUs() : atoi(pszNumThreads);
+
+        return GDALPolygonizeTiledT<DataType, EqualityTest>(
+            hSrcBand, hMaskBand, hOutLayer, iPixValField, nConnectedness,
+            nTileSize, std::max(1, nThreads), adfGeoTransform,
+            pfnProgress, pProgressArg, eDT );
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Allocate working buffers.                                       */
 /* -------------------------------------------------------------------- */
@@ -494,30 +1557,6 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
         return CE_Failure;
     }
 
-/* -------------------------------------------------------------------- */
-/*      Get the geotransform, if there is one, so we can convert the    */
-/*      vectors into georeferenced coordinates.                         */
-/* -------------------------------------------------------------------- */
-    double adfGeoTransform[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
-
-    const char* pszDatasetForGeoRef = CSLFetchNameValue(papszOptions,
-                                                        "DATASET_FOR_GEOREF");
-    if( pszDatasetForGeoRef )
-    {
-        GDALDatasetH hSrcDS = GDALOpen(pszDatasetForGeoRef, GA_ReadOnly);
-        if( hSrcDS )
-        {
-            GDALGetGeoTransform( hSrcDS, adfGeoTransform );
-            GDALClose(hSrcDS);
-        }
-    }
-    else
-    {
-        GDALDatasetH hSrcDS = GDALGetBandDataset( hSrcBand );
-        if( hSrcDS )
-            GDALGetGeoTransform( hSrcDS, adfGeoTransform );
-    }
-
 /* -------------------------------------------------------------------- */
 /*      The first pass over the raster is only used to build up the     */
 /*      polygon id map so we will know in advance what polygons are     */
@@ -815,6 +1854,19 @@ GBool GDALFloatEquals( float A, float B )
  * <dl>
  * <dt>"8CONNECTED":</dt> May be set to "8" to use 8 connectedness.
  * Otherwise 4 connectedness will be applied to the algorithm
+ * <dt>"TILE_SIZE":</dt> (GDAL &gt;= 2.3) Size in pixels of the square tiles
+ * processed in tiled mode. Defaults to 1024. Setting this option, or
+ * NUM_THREADS, selects the tiled mode, in which tiles are polygonized
+ * independently and the polygons crossing tile borders are then merged. Its
+ * memory use depends on the tile size and on the polygons crossing tile
+ * borders, rather than on the number of polygons in the raster. Polygons
+ * cover the same pixels as in the default mode, but they may be written in a
+ * different order, with rings starting at a different vertex, and without
+ * vertices in the middle of straight edges.
+ * <dt>"NUM_THREADS":</dt> (GDAL &gt;= 2.3) Number of threads, or ALL_CPUS,
+ * used to polygonize tiles concurrently in tiled mode. Defaults to the value
+ * of the GDAL_NUM_THREADS configuration option, or 1. Setting this option
+ * selects the tiled mode.
  * </dl>
  * @param pfnProgress callback for reporting algorithm progress matching the
  * GDALProgressFunc() semantics.  May be NULL.
@@ -891,6 +1943,19 @@ GDALPolygonize( GDALRasterBandH hSrcBand,
  * <dl>
  * <dt>"8CONNECTED":</dt> May be set to "8" to use 8 connectedness.
  * Otherwise 4 connectedness will be applied to the algorithm
+ * <dt>"TILE_SIZE":</dt> (GDAL &gt;= 2.3) Size in pixels of the square tiles
+ * processed in tiled mode. Defaults to 1024. Setting this option, or
+ * NUM_THREADS, selects the tiled mode, in which tiles are polygonized
+ * independently and the polygons crossing tile borders are then merged. Its
+ * memory use depends on the tile size and on the polygons crossing tile
+ * borders, rather than on the number of polygons in the raster. Polygons
+ * cover the same pixels as in the default mode, but they may be written in a
+ * different order, with rings starting at a different vertex, and without
+ * vertices in the middle of straight edges.
+ * <dt>"NUM_THREADS":</dt> (GDAL &gt;= 2.3) Number of threads, or ALL_CPUS,
+ * used to polygonize tiles concurrently in tiled mode. Defaults to the value
+ * of the GDAL_NUM_THREADS configuration option, or 1. Setting this option
+ * selects the tiled mode.
  * </dl>
  * @param pfnProgress callback for reporting algorithm progress matching the
  * GDALProgressFunc() semantics.  May be NULL.
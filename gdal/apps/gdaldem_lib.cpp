@@ -101,11 +101,14 @@
 
 #include <algorithm>
 #include <limits>
+#include <new>
+#include <vector>
 
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_priv.h"
 
@@ -273,6 +276,362 @@ GInt32 INTERPOL(GInt32 a, GInt32 b, int bSrcHasNoData, GInt32 fSrcNoDataValue)
     return nVal;
 }
 
+/************************************************************************/
+/*                   GDALGeneric3x3LineHasNoData()                      */
+/************************************************************************/
+
+template<class T>
+static bool GDALGeneric3x3LineHasNoData( const T* pafLine, int nXSize,
+                                         T fSrcNoDataValue )
+{
+    int iX = 0;
+    for( ; iX + 3 < nXSize; iX +=4 )
+    {
+        if( pafLine[iX] == fSrcNoDataValue ||
+            pafLine[iX + 1] == fSrcNoDataValue ||
+            pafLine[iX + 2] == fSrcNoDataValue ||
+            pafLine[iX + 3] == fSrcNoDataValue )
+        {
+            return true;
+        }
+    }
+    for( ; iX < nXSize; iX++ )
+    {
+        if( pafLine[iX] == fSrcNoDataValue )
+            return true;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                    GDALGeneric3x3ProcessLine()                       */
+/*                                                                      */
+/*      Compute one output line that is neither the first nor the       */
+/*      last one of the raster, from its source line and the two        */
+/*      surrounding ones.                                               */
+/************************************************************************/
+
+template<class T>
+static void GDALGeneric3x3ProcessLine(
+    const T* pafThreeLineWin,
+    int nLine1Off,
+    int nLine2Off,
+    int nLine3Off,
+    int nXSize,
+    bool bOneOfThreeLinesHasNoData,
+    bool bSrcHasNoData,
+    T fSrcNoDataValue,
+    bool bIsSrcNoDataNan,
+    float fDstNoDataValue,
+    typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlg,
+    typename GDALGeneric3x3ProcessingAlg_multisample<T>::type pfnAlg_multisample,
+    void *pData,
+    bool bComputeAtEdges,
+    float* pafOutputBuf )
+{
+    if( bComputeAtEdges && nXSize >= 2 )
+    {
+        int j = 0;
+        T afWin[9] = {
+            INTERPOL(pafThreeLineWin[nLine1Off + j],
+                     pafThreeLineWin[nLine1Off + j+1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafThreeLineWin[nLine1Off + j],
+            pafThreeLineWin[nLine1Off + j+1],
+            INTERPOL(pafThreeLineWin[nLine2Off + j],
+                     pafThreeLineWin[nLine2Off + j+1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafThreeLineWin[nLine2Off + j],
+            pafThreeLineWin[nLine2Off + j+1],
+            INTERPOL(pafThreeLineWin[nLine3Off + j],
+                     pafThreeLineWin[nLine3Off + j+1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafThreeLineWin[nLine3Off + j],
+            pafThreeLineWin[nLine3Off + j+1]
+        };
+
+        pafOutputBuf[j] =
+            ComputeVal(
+                CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
+                fSrcNoDataValue,
+                CPL_TO_BOOL(bIsSrcNoDataNan),
+                afWin, fDstNoDataValue,
+                pfnAlg, pData, bComputeAtEdges);
+    }
+    else
+    {
+        // Exclude the edges
+        pafOutputBuf[0] = fDstNoDataValue;
+    }
+
+    int j = 1;
+    if( pfnAlg_multisample && !bOneOfThreeLinesHasNoData )
+    {
+        j = pfnAlg_multisample(pafThreeLineWin,
+                               nLine1Off,
+                               nLine2Off,
+                               nLine3Off,
+                               nXSize,
+                               pData,
+                               pafOutputBuf);
+    }
+
+    for( ; j < nXSize - 1; j++ )
+    {
+        T afWin[9] = {
+            pafThreeLineWin[nLine1Off + j-1],
+            pafThreeLineWin[nLine1Off + j],
+            pafThreeLineWin[nLine1Off + j+1],
+            pafThreeLineWin[nLine2Off + j-1],
+            pafThreeLineWin[nLine2Off + j],
+            pafThreeLineWin[nLine2Off + j+1],
+            pafThreeLineWin[nLine3Off + j-1],
+            pafThreeLineWin[nLine3Off + j],
+            pafThreeLineWin[nLine3Off + j+1]
+        };
+
+        pafOutputBuf[j] =
+            ComputeVal(
+                CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
+                fSrcNoDataValue,
+                CPL_TO_BOOL(bIsSrcNoDataNan),
+                afWin, fDstNoDataValue,
+                pfnAlg, pData, bComputeAtEdges);
+    }
+
+    if( bComputeAtEdges && nXSize >= 2 )
+    {
+        j = nXSize - 1;
+
+        T afWin[9] = {
+            pafThreeLineWin[nLine1Off + j-1],
+            pafThreeLineWin[nLine1Off + j],
+            INTERPOL(pafThreeLineWin[nLine1Off + j],
+                     pafThreeLineWin[nLine1Off + j-1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafThreeLineWin[nLine2Off + j-1],
+            pafThreeLineWin[nLine2Off + j],
+            INTERPOL(pafThreeLineWin[nLine2Off + j],
+                     pafThreeLineWin[nLine2Off + j-1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafThreeLineWin[nLine3Off + j-1],
+            pafThreeLineWin[nLine3Off + j],
+            INTERPOL(pafThreeLineWin[nLine3Off + j],
+                     pafThreeLineWin[nLine3Off + j-1],
+                     bSrcHasNoData, fSrcNoDataValue)
+        };
+
+        pafOutputBuf[j] =
+            ComputeVal(
+                CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
+                fSrcNoDataValue,
+                CPL_TO_BOOL(bIsSrcNoDataNan),
+                afWin, fDstNoDataValue,
+                pfnAlg, pData, bComputeAtEdges);
+    }
+    else
+    {
+        // Exclude the edges
+        if( nXSize > 1 )
+            pafOutputBuf[nXSize - 1] = fDstNoDataValue;
+    }
+}
+
+/************************************************************************/
+/*                   GDALGeneric3x3ProcessStrips()                      */
+/************************************************************************/
+
+template<class T>
+struct GDALGeneric3x3StripJob
+{
+    // nLines + 2 source lines: the output lines plus one line above and
+    // one line below.
+    const T* pafSrcLines;
+    int nLines;
+    int nXSize;
+    bool bSrcHasNoData;
+    T fSrcNoDataValue;
+    bool bIsSrcNoDataNan;
+    float fDstNoDataValue;
+    typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlg;
+    typename GDALGeneric3x3ProcessingAlg_multisample<T>::type pfnAlg_multisample;
+    void *pData;
+    bool bComputeAtEdges;
+    float* pafOutputBuf;
+};
+
+template<class T>
+static void GDALGeneric3x3StripJobFunc( void* pJob )
+{
+    const GDALGeneric3x3StripJob<T>* psJob =
+        static_cast<const GDALGeneric3x3StripJob<T>*>(pJob);
+    const int nXSize = psJob->nXSize;
+
+    // Same logic as in GDALGeneric3x3Processing() so that the result
+    // does not depend on the number of threads.
+    bool abLineHasNoDataValue[3] = {
+        psJob->bSrcHasNoData, psJob->bSrcHasNoData, psJob->bSrcHasNoData };
+    const bool bCheckLines =
+        std::numeric_limits<T>::is_integer && psJob->bSrcHasNoData;
+    if( bCheckLines )
+    {
+        for( int i = 0; i < 2; i++ )
+        {
+            abLineHasNoDataValue[i] =
+                GDALGeneric3x3LineHasNoData(psJob->pafSrcLines + i * nXSize,
+                                            nXSize, psJob->fSrcNoDataValue);
+        }
+    }
+
+    for( int iLine = 0; iLine < psJob->nLines; iLine++ )
+    {
+        bool bOneOfThreeLinesHasNoData = psJob->bSrcHasNoData;
+        if( bCheckLines )
+        {
+            abLineHasNoDataValue[(iLine + 2) % 3] =
+                GDALGeneric3x3LineHasNoData(
+                    psJob->pafSrcLines + (iLine + 2) * nXSize,
+                    nXSize, psJob->fSrcNoDataValue);
+            bOneOfThreeLinesHasNoData = abLineHasNoDataValue[0] ||
+                                        abLineHasNoDataValue[1] ||
+                                        abLineHasNoDataValue[2];
+        }
+
+        GDALGeneric3x3ProcessLine(psJob->pafSrcLines,
+                                  iLine * nXSize,
+                                  (iLine + 1) * nXSize,
+                                  (iLine + 2) * nXSize,
+                                  nXSize,
+                                  bOneOfThreeLinesHasNoData,
+                                  psJob->bSrcHasNoData,
+                                  psJob->fSrcNoDataValue,
+                                  psJob->bIsSrcNoDataNan,
+                                  psJob->fDstNoDataValue,
+                                  psJob->pfnAlg,
+                                  psJob->pfnAlg_multisample,
+                                  psJob->pData,
+                                  psJob->bComputeAtEdges,
+                                  psJob->pafOutputBuf +
+                                        static_cast<size_t>(iLine) * nXSize);
+    }
+}
+
+// Computes lines 1 to nYSize - 2 by horizontal strips processed in
+// parallel. The source lines of the next group of strips are read while
+// the current one is computed, and output lines are written in order.
+// On success, the last two source lines of the raster are left in
+// pafTwoLastLines.
+template<class T>
+static CPLErr GDALGeneric3x3ProcessStrips(
+    GDALRasterBandH hSrcBand,
+    GDALRasterBandH hDstBand,
+    GDALDataType eReadDT,
+    CPLWorkerThreadPool* poThreadPool,
+    const GDALGeneric3x3StripJob<T>& sJobTemplate,
+    T* pafTwoLastLines,
+    GDALProgressFunc pfnProgress,
+    void *pProgressData )
+{
+    const int nXSize = GDALGetRasterBandXSize(hSrcBand);
+    const int nYSize = GDALGetRasterBandYSize(hSrcBand);
+    const int nThreads = poThreadPool->GetThreadCount();
+
+    // Strips of at most a few MB each, and at least one per thread.
+    const int nStripLines =
+        std::max(1, std::min(std::min(256, (4 * 1024 * 1024) / nXSize),
+                             (nYSize - 2 + nThreads - 1) / nThreads));
+    const int nMaxWaveLines = std::min(nYSize - 2, nStripLines * nThreads);
+
+    T* apafSrcBuf[2] = { NULL, NULL };
+    apafSrcBuf[0] = static_cast<T*>(
+        VSI_MALLOC3_VERBOSE(sizeof(T), nMaxWaveLines + 2, nXSize));
+    apafSrcBuf[1] = static_cast<T*>(
+        VSI_MALLOC3_VERBOSE(sizeof(T), nMaxWaveLines + 2, nXSize));
+    float* pafOutputBuf = static_cast<float*>(
+        VSI_MALLOC3_VERBOSE(sizeof(float), nMaxWaveLines, nXSize));
+    std::vector<GDALGeneric3x3StripJob<T> > asJobs(nThreads, sJobTemplate);
+    if( apafSrcBuf[0] == NULL || apafSrcBuf[1] == NULL ||
+        pafOutputBuf == NULL )
+    {
+        VSIFree(apafSrcBuf[0]);
+        VSIFree(apafSrcBuf[1]);
+        VSIFree(pafOutputBuf);
+        return CE_Failure;
+    }
+
+    int iYStart = 1;
+    int nWaveLines = nMaxWaveLines;
+    int iBuf = 0;
+    CPLErr eErr = GDALRasterIO(hSrcBand, GF_Read,
+                               0, iYStart - 1, nXSize, nWaveLines + 2,
+                               apafSrcBuf[iBuf], nXSize, nWaveLines + 2,
+                               eReadDT, 0, 0);
+    while( eErr == CE_None )
+    {
+        int nJobs = 0;
+        for( int iLine = 0; iLine < nWaveLines; iLine += nStripLines )
+        {
+            GDALGeneric3x3StripJob<T>& sJob = asJobs[nJobs];
+            sJob.pafSrcLines =
+                apafSrcBuf[iBuf] + static_cast<size_t>(iLine) * nXSize;
+            sJob.nLines = std::min(nStripLines, nWaveLines - iLine);
+            sJob.pafOutputBuf =
+                pafOutputBuf + static_cast<size_t>(iLine) * nXSize;
+            poThreadPool->SubmitJob(GDALGeneric3x3StripJobFunc<T>, &sJob);
+            nJobs++;
+        }
+
+        const int iYNextStart = iYStart + nWaveLines;
+        const int nNextWaveLines =
+            std::min(nMaxWaveLines, nYSize - 1 - iYNextStart);
+        if( nNextWaveLines > 0 )
+        {
+            eErr = GDALRasterIO(hSrcBand, GF_Read,
+                                0, iYNextStart - 1,
+                                nXSize, nNextWaveLines + 2,
+                                apafSrcBuf[1 - iBuf],
+                                nXSize, nNextWaveLines + 2,
+                                eReadDT, 0, 0);
+        }
+
+        poThreadPool->WaitCompletion();
+        if( eErr != CE_None )
+            break;
+
+        eErr = GDALRasterIO(hDstBand, GF_Write,
+                            0, iYStart, nXSize, nWaveLines,
+                            pafOutputBuf, nXSize, nWaveLines,
+                            GDT_Float32, 0, 0);
+        if( eErr != CE_None )
+            break;
+
+        if( !pfnProgress( 1.0 * (iYNextStart + 1) / nYSize, NULL,
+                          pProgressData ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+            break;
+        }
+
+        if( nNextWaveLines <= 0 )
+        {
+            memcpy(pafTwoLastLines,
+                   apafSrcBuf[iBuf] + static_cast<size_t>(nWaveLines) * nXSize,
+                   2 * nXSize * sizeof(T));
+            break;
+        }
+
+        iYStart = iYNextStart;
+        nWaveLines = nNextWaveLines;
+        iBuf = 1 - iBuf;
+    }
+
+    VSIFree(apafSrcBuf[0]);
+    VSIFree(apafSrcBuf[1]);
+    VSIFree(pafOutputBuf);
+    return eErr;
+}
+
 /************************************************************************/
 /*                  GDALGeneric3x3Processing()                          */
 /************************************************************************/
@@ -286,6 +645,7 @@ CPLErr GDALGeneric3x3Processing(
     typename GDALGeneric3x3ProcessingAlg_multisample<T>::type pfnAlg_multisample,
     void *pData,
     bool bComputeAtEdges,
+    int nNumThreads,
     GDALProgressFunc pfnProgress,
     void *pProgressData )
 {
@@ -401,15 +761,9 @@ CPLErr GDALGeneric3x3Processing(
         }
         if( std::numeric_limits<T>::is_integer && bSrcHasNoData )
         {
-            abLineHasNoDataValue[i] = false;
-            for( int iX = 0; iX < nXSize; iX++ )
-            {
-                if( pafThreeLineWin[i * nXSize + iX] == fSrcNoDataValue )
-                {
-                    abLineHasNoDataValue[i] = true;
-                    break;
-                }
-            }
+            abLineHasNoDataValue[i] =
+                GDALGeneric3x3LineHasNoData(pafThreeLineWin + i * nXSize,
+                                            nXSize, fSrcNoDataValue);
         }
       }
     }  // End extra scope for VC12
@@ -474,6 +828,56 @@ CPLErr GDALGeneric3x3Processing(
     }
 
     int i = 1;  // Used after for.
+
+    CPLWorkerThreadPool* poThreadPool = NULL;
+    if( nNumThreads > 1 && nYSize > 3 )
+    {
+        poThreadPool = new (std::nothrow) CPLWorkerThreadPool();
+        if( poThreadPool == NULL ||
+            !poThreadPool->Setup(std::min(nNumThreads, nYSize - 2),
+                                 NULL, NULL) )
+        {
+            delete poThreadPool;
+            poThreadPool = NULL;
+        }
+    }
+    if( poThreadPool != NULL )
+    {
+        CPLDebug("GDALDEM", "Using %d threads",
+                 poThreadPool->GetThreadCount());
+
+        GDALGeneric3x3StripJob<T> sJobTemplate;
+        sJobTemplate.pafSrcLines = NULL;
+        sJobTemplate.nLines = 0;
+        sJobTemplate.nXSize = nXSize;
+        sJobTemplate.bSrcHasNoData = CPL_TO_BOOL(bSrcHasNoData);
+        sJobTemplate.fSrcNoDataValue = fSrcNoDataValue;
+        sJobTemplate.bIsSrcNoDataNan = CPL_TO_BOOL(bIsSrcNoDataNan);
+        sJobTemplate.fDstNoDataValue = fDstNoDataValue;
+        sJobTemplate.pfnAlg = pfnAlg;
+        sJobTemplate.pfnAlg_multisample = pfnAlg_multisample;
+        sJobTemplate.pData = pData;
+        sJobTemplate.bComputeAtEdges = bComputeAtEdges;
+        sJobTemplate.pafOutputBuf = NULL;
+
+        eErr = GDALGeneric3x3ProcessStrips(hSrcBand, hDstBand, eReadDT,
+                                           poThreadPool, sJobTemplate,
+                                           pafThreeLineWin,
+                                           pfnProgress, pProgressData);
+        delete poThreadPool;
+        if( eErr != CE_None )
+        {
+            CPLFree(pafOutputBuf);
+            CPLFree(pafThreeLineWin);
+
+            return eErr;
+        }
+
+        i = nYSize - 1;
+        nLine1Off = 0;
+        nLine2Off = nXSize;
+    }
+
     for( ; i < nYSize-1; i++ )
     {
         /* Read third line of the line buffer */
@@ -498,29 +902,9 @@ CPLErr GDALGeneric3x3Processing(
         bool bOneOfThreeLinesHasNoData = CPL_TO_BOOL(bSrcHasNoData);
         if( std::numeric_limits<T>::is_integer && bSrcHasNoData )
         {
-            bool bLastLineHasNoDataValue = false;
-            int iX = 0;
-            for( ; iX + 3 < nXSize; iX +=4 )
-            {
-                if( pafThreeLineWin[nLine3Off + iX] == fSrcNoDataValue ||
-                    pafThreeLineWin[nLine3Off + iX + 1] == fSrcNoDataValue ||
-                    pafThreeLineWin[nLine3Off + iX + 2] == fSrcNoDataValue ||
-                    pafThreeLineWin[nLine3Off + iX + 3] == fSrcNoDataValue )
-                {
-                    bLastLineHasNoDataValue = true;
-                    break;
-                }
-            }
-            if( !bLastLineHasNoDataValue )
-            {
-                for( ; iX < nXSize; iX++ )
-                {
-                    if( pafThreeLineWin[nLine3Off + iX] == fSrcNoDataValue )
-                    {
-                        bLastLineHasNoDataValue = true;
-                    }
-                }
-            }
+            const bool bLastLineHasNoDataValue =
+                GDALGeneric3x3LineHasNoData(pafThreeLineWin + nLine3Off,
+                                            nXSize, fSrcNoDataValue);
             abLineHasNoDataValue[nLine3Off / nXSize] = bLastLineHasNoDataValue;
 
             bOneOfThreeLinesHasNoData = abLineHasNoDataValue[0] ||
@@ -528,112 +912,14 @@ CPLErr GDALGeneric3x3Processing(
                                 abLineHasNoDataValue[2];
         }
 
-        if( bComputeAtEdges && nXSize >= 2 )
-        {
-            int j = 0;
-            T afWin[9] = {
-                INTERPOL(pafThreeLineWin[nLine1Off + j],
-                         pafThreeLineWin[nLine1Off + j+1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine1Off + j],
-                pafThreeLineWin[nLine1Off + j+1],
-                INTERPOL(pafThreeLineWin[nLine2Off + j],
-                         pafThreeLineWin[nLine2Off + j+1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine2Off + j],
-                pafThreeLineWin[nLine2Off + j+1],
-                INTERPOL(pafThreeLineWin[nLine3Off + j],
-                         pafThreeLineWin[nLine3Off + j+1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine3Off + j],
-                pafThreeLineWin[nLine3Off + j+1]
-            };
-
-            pafOutputBuf[j] =
-                ComputeVal(
-                    CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
-                    fSrcNoDataValue,
-                    CPL_TO_BOOL(bIsSrcNoDataNan),
-                    afWin, fDstNoDataValue,
-                    pfnAlg, pData, bComputeAtEdges);
-        }
-        else
-        {
-            // Exclude the edges
-            pafOutputBuf[0] = fDstNoDataValue;
-        }
-
-        int j = 1;
-        if( pfnAlg_multisample && !bOneOfThreeLinesHasNoData )
-        {
-            j = pfnAlg_multisample(pafThreeLineWin,
-                                   nLine1Off,
-                                   nLine2Off,
-                                   nLine3Off,
-                                   nXSize,
-                                   pData,
-                                   pafOutputBuf);
-        }
-
-        for( ; j < nXSize - 1; j++ )
-        {
-            T afWin[9] = {
-                pafThreeLineWin[nLine1Off + j-1],
-                pafThreeLineWin[nLine1Off + j],
-                pafThreeLineWin[nLine1Off + j+1],
-                pafThreeLineWin[nLine2Off + j-1],
-                pafThreeLineWin[nLine2Off + j],
-                pafThreeLineWin[nLine2Off + j+1],
-                pafThreeLineWin[nLine3Off + j-1],
-                pafThreeLineWin[nLine3Off + j],
-                pafThreeLineWin[nLine3Off + j+1]
-            };
-
-            pafOutputBuf[j] =
-                ComputeVal(
-                    CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
-                    fSrcNoDataValue,
-                    CPL_TO_BOOL(bIsSrcNoDataNan),
-                    afWin, fDstNoDataValue,
-                    pfnAlg, pData, bComputeAtEdges);
-        }
-
-        if( bComputeAtEdges && nXSize >= 2 )
-        {
-            j = nXSize - 1;
-
-            T afWin[9] = {
-                pafThreeLineWin[nLine1Off + j-1],
-                pafThreeLineWin[nLine1Off + j],
-                INTERPOL(pafThreeLineWin[nLine1Off + j],
-                         pafThreeLineWin[nLine1Off + j-1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine2Off + j-1],
-                pafThreeLineWin[nLine2Off + j],
-                INTERPOL(pafThreeLineWin[nLine2Off + j],
-                         pafThreeLineWin[nLine2Off + j-1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine3Off + j-1],
-                pafThreeLineWin[nLine3Off + j],
-                INTERPOL(pafThreeLineWin[nLine3Off + j],
-                         pafThreeLineWin[nLine3Off + j-1],
-                         bSrcHasNoData, fSrcNoDataValue)
-            };
-
-            pafOutputBuf[j] =
-                ComputeVal(
-                    CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
-                    fSrcNoDataValue,
-                    CPL_TO_BOOL(bIsSrcNoDataNan),
-                    afWin, fDstNoDataValue,
-                    pfnAlg, pData, bComputeAtEdges);
-        }
-        else
-        {
-            // Exclude the edges
-            if( nXSize > 1 )
-                pafOutputBuf[nXSize - 1] = fDstNoDataValue;
-        }
+        GDALGeneric3x3ProcessLine(pafThreeLineWin,
+                                  nLine1Off, nLine2Off, nLine3Off, nXSize,
+                                  bOneOfThreeLinesHasNoData,
+                                  CPL_TO_BOOL(bSrcHasNoData), fSrcNoDataValue,
+                                  CPL_TO_BOOL(bIsSrcNoDataNan),
+                                  fDstNoDataValue,
+                                  pfnAlg, pfnAlg_multisample, pData,
+                                  bComputeAtEdges, pafOutputBuf);
 
         /* -----------------------------------------
          * Write Line to Raster
@@ -2162,6 +2448,76 @@ GDALColorInterp GDALColorReliefRasterBand::GetColorInterpretation()
     return (GDALColorInterp)(GCI_RedBand + nBand - 1);
 }
 
+/************************************************************************/
+/*                       GDALColorReliefStripJob                        */
+/************************************************************************/
+
+typedef struct
+{
+    const int* panSourceBuf;
+    const float* pafSourceBuf;
+    size_t nValues;
+    GByte* pabyDestBuf1;
+    GByte* pabyDestBuf2;
+    GByte* pabyDestBuf3;
+    GByte* pabyDestBuf4;
+    const GByte* pabyPrecomputed;
+    int nIndexOffset;
+    ColorAssociation* pasColorAssociation;
+    int nColorAssociation;
+    ColorSelectionMode eColorSelectionMode;
+} GDALColorReliefStripJob;
+
+static void GDALColorReliefStripJobFunc( void* pJob )
+{
+    const GDALColorReliefStripJob* psJob =
+        static_cast<const GDALColorReliefStripJob*>(pJob);
+    GByte* pabyDestBuf1 = psJob->pabyDestBuf1;
+    GByte* pabyDestBuf2 = psJob->pabyDestBuf2;
+    GByte* pabyDestBuf3 = psJob->pabyDestBuf3;
+    GByte* pabyDestBuf4 = psJob->pabyDestBuf4;
+
+    if( psJob->pabyPrecomputed )
+    {
+        const GByte* pabyPrecomputed = psJob->pabyPrecomputed;
+        for( size_t j = 0; j < psJob->nValues; j++ )
+        {
+            int nIndex = psJob->panSourceBuf[j] + psJob->nIndexOffset;
+            pabyDestBuf1[j] = pabyPrecomputed[4 * nIndex];
+            pabyDestBuf2[j] = pabyPrecomputed[4 * nIndex + 1];
+            pabyDestBuf3[j] = pabyPrecomputed[4 * nIndex + 2];
+            pabyDestBuf4[j] = pabyPrecomputed[4 * nIndex + 3];
+        }
+    }
+    else
+    {
+        int nR = 0;
+        int nG = 0;
+        int nB = 0;
+        int nA = 0;
+
+        for( size_t j = 0; j < psJob->nValues; j++ )
+        {
+            GDALColorReliefGetRGBA  (psJob->pasColorAssociation,
+                                     psJob->nColorAssociation,
+                                     psJob->pafSourceBuf[j],
+                                     psJob->eColorSelectionMode,
+                                     &nR,
+                                     &nG,
+                                     &nB,
+                                     &nA);
+            pabyDestBuf1[j] = static_cast<GByte>(nR);
+            pabyDestBuf2[j] = static_cast<GByte>(nG);
+            pabyDestBuf3[j] = static_cast<GByte>(nB);
+            pabyDestBuf4[j] = static_cast<GByte>(nA);
+        }
+    }
+}
+
+/************************************************************************/
+/*                         GDALColorRelief()                            */
+/************************************************************************/
+
 static
 CPLErr GDALColorRelief( GDALRasterBandH hSrcBand,
                         GDALRasterBandH hDstBand1,
@@ -2170,6 +2526,7 @@ CPLErr GDALColorRelief( GDALRasterBandH hSrcBand,
                         GDALRasterBandH hDstBand4,
                         const char* pszColorFilename,
                         ColorSelectionMode eColorSelectionMode,
+                        int nNumThreads,
                         GDALProgressFunc pfnProgress,
                         void * pProgressData )
 {
@@ -2200,197 +2557,169 @@ CPLErr GDALColorRelief( GDALRasterBandH hSrcBand,
                                   &nIndexOffset);
 
 /* -------------------------------------------------------------------- */
-/*      Initialize progress counter.                                    */
+/*      Lines are processed one at a time, or, if several threads are   */
+/*      used, by chunks of several lines split in one strip per thread. */
 /* -------------------------------------------------------------------- */
-
     const int nXSize = GDALGetRasterBandXSize(hSrcBand);
     const int nYSize = GDALGetRasterBandYSize(hSrcBand);
 
+    CPLWorkerThreadPool* poThreadPool = NULL;
+    if( nNumThreads > 1 && nYSize > 1 )
+    {
+        poThreadPool = new (std::nothrow) CPLWorkerThreadPool();
+        if( poThreadPool == NULL ||
+            !poThreadPool->Setup(std::min(nNumThreads, nYSize), NULL, NULL) )
+        {
+            delete poThreadPool;
+            poThreadPool = NULL;
+        }
+    }
+    int nStripLines = 1;
+    int nChunkLines = 1;
+    if( poThreadPool != NULL )
+    {
+        CPLDebug("GDALDEM", "Using %d threads",
+                 poThreadPool->GetThreadCount());
+        const int nThreads = poThreadPool->GetThreadCount();
+        nStripLines =
+            std::max(1, std::min(std::min(256, (4 * 1024 * 1024) / nXSize),
+                                 (nYSize + nThreads - 1) / nThreads));
+        nChunkLines = std::min(nYSize, nStripLines * nThreads);
+    }
+    const size_t nChunkValues = static_cast<size_t>(nChunkLines) * nXSize;
+
+/* -------------------------------------------------------------------- */
+/*      Initialize progress counter.                                    */
+/* -------------------------------------------------------------------- */
     float* pafSourceBuf = NULL;
     int* panSourceBuf = NULL;
     if( pabyPrecomputed )
         panSourceBuf = static_cast<int *>(
-            VSI_MALLOC2_VERBOSE(sizeof(int), nXSize));
+            VSI_MALLOC2_VERBOSE(sizeof(int), nChunkValues));
     else
         pafSourceBuf = static_cast<float *>(
-            VSI_MALLOC2_VERBOSE(sizeof(float), nXSize));
-    GByte* pabyDestBuf1 = static_cast<GByte *>(VSI_MALLOC2_VERBOSE(4, nXSize));
-    GByte* pabyDestBuf2 =  pabyDestBuf1 + nXSize;
-    GByte* pabyDestBuf3 =  pabyDestBuf2 + nXSize;
-    GByte* pabyDestBuf4 =  pabyDestBuf3 + nXSize;
+            VSI_MALLOC2_VERBOSE(sizeof(float), nChunkValues));
+    GByte* pabyDestBuf1 =
+        static_cast<GByte *>(VSI_MALLOC2_VERBOSE(4, nChunkValues));
+    GByte* pabyDestBuf2 =  pabyDestBuf1 + nChunkValues;
+    GByte* pabyDestBuf3 =  pabyDestBuf2 + nChunkValues;
+    GByte* pabyDestBuf4 =  pabyDestBuf3 + nChunkValues;
 
+    CPLErr eErr = CE_None;
     if( (pabyPrecomputed != NULL && panSourceBuf == NULL) ||
         (pabyPrecomputed == NULL && pafSourceBuf == NULL) ||
         pabyDestBuf1 == NULL )
     {
-        VSIFree(pabyPrecomputed);
-        CPLFree(pafSourceBuf);
-        CPLFree(panSourceBuf);
-        CPLFree(pabyDestBuf1);
-        CPLFree(pasColorAssociation);
-
-        return CE_Failure;
+        eErr = CE_Failure;
     }
-
-    if( !pfnProgress( 0.0, NULL, pProgressData ) )
+    else if( !pfnProgress( 0.0, NULL, pProgressData ) )
     {
         CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-        VSIFree(pabyPrecomputed);
-        CPLFree(pafSourceBuf);
-        CPLFree(panSourceBuf);
-        CPLFree(pabyDestBuf1);
-        CPLFree(pasColorAssociation);
-
-        return CE_Failure;
+        eErr = CE_Failure;
     }
 
-    int nR = 0;
-    int nG = 0;
-    int nB = 0;
-    int nA = 0;
+    std::vector<GDALColorReliefStripJob> asJobs;
+    if( poThreadPool != NULL )
+        asJobs.resize(poThreadPool->GetThreadCount());
 
-    for( int i = 0; i < nYSize; i++ )
+    for( int i = 0; eErr == CE_None && i < nYSize; i += nChunkLines )
     {
+        const int nLines = std::min(nChunkLines, nYSize - i);
+
         /* Read source buffer */
-        CPLErr eErr = GDALRasterIO( hSrcBand,
-                                    GF_Read,
-                                    0, i,
-                                    nXSize, 1,
-                                    panSourceBuf
-                                    ? (void*) panSourceBuf
-                                    : (void*) pafSourceBuf,
-                                    nXSize, 1,
-                                    panSourceBuf ? GDT_Int32 : GDT_Float32,
-                                    0, 0);
+        eErr = GDALRasterIO( hSrcBand,
+                             GF_Read,
+                             0, i,
+                             nXSize, nLines,
+                             panSourceBuf
+                             ? (void*) panSourceBuf
+                             : (void*) pafSourceBuf,
+                             nXSize, nLines,
+                             panSourceBuf ? GDT_Int32 : GDT_Float32,
+                             0, 0);
         if( eErr != CE_None )
-        {
-            VSIFree(pabyPrecomputed);
-            CPLFree(pafSourceBuf);
-            CPLFree(panSourceBuf);
-            CPLFree(pabyDestBuf1);
-            CPLFree(pasColorAssociation);
-            return eErr;
-        }
+            break;
 
-        if( pabyPrecomputed )
+        GDALColorReliefStripJob sJob;
+        sJob.panSourceBuf = panSourceBuf;
+        sJob.pafSourceBuf = pafSourceBuf;
+        sJob.nValues = static_cast<size_t>(nLines) * nXSize;
+        sJob.pabyDestBuf1 = pabyDestBuf1;
+        sJob.pabyDestBuf2 = pabyDestBuf2;
+        sJob.pabyDestBuf3 = pabyDestBuf3;
+        sJob.pabyDestBuf4 = pabyDestBuf4;
+        sJob.pabyPrecomputed = pabyPrecomputed;
+        sJob.nIndexOffset = nIndexOffset;
+        sJob.pasColorAssociation = pasColorAssociation;
+        sJob.nColorAssociation = nColorAssociation;
+        sJob.eColorSelectionMode = eColorSelectionMode;
+
+        if( poThreadPool == NULL )
         {
-            for( int j = 0; j < nXSize; j++ )
-            {
-                int nIndex = panSourceBuf[j] + nIndexOffset;
-                pabyDestBuf1[j] = pabyPrecomputed[4 * nIndex];
-                pabyDestBuf2[j] = pabyPrecomputed[4 * nIndex + 1];
-                pabyDestBuf3[j] = pabyPrecomputed[4 * nIndex + 2];
-                pabyDestBuf4[j] = pabyPrecomputed[4 * nIndex + 3];
-            }
+            GDALColorReliefStripJobFunc(&sJob);
         }
         else
         {
-            for( int j = 0; j < nXSize; j++ )
+            int nJobs = 0;
+            for( int iLine = 0; iLine < nLines; iLine += nStripLines )
             {
-                GDALColorReliefGetRGBA  (pasColorAssociation,
-                                         nColorAssociation,
-                                         pafSourceBuf[j],
-                                         eColorSelectionMode,
-                                         &nR,
-                                         &nG,
-                                         &nB,
-                                         &nA);
-                pabyDestBuf1[j] = static_cast<GByte>(nR);
-                pabyDestBuf2[j] = static_cast<GByte>(nG);
-                pabyDestBuf3[j] = static_cast<GByte>(nB);
-                pabyDestBuf4[j] = static_cast<GByte>(nA);
+                const size_t nOffset = static_cast<size_t>(iLine) * nXSize;
+                asJobs[nJobs] = sJob;
+                asJobs[nJobs].panSourceBuf =
+                    panSourceBuf ? panSourceBuf + nOffset : NULL;
+                asJobs[nJobs].pafSourceBuf =
+                    pafSourceBuf ? pafSourceBuf + nOffset : NULL;
+                asJobs[nJobs].nValues = static_cast<size_t>(
+                    std::min(nStripLines, nLines - iLine)) * nXSize;
+                asJobs[nJobs].pabyDestBuf1 = pabyDestBuf1 + nOffset;
+                asJobs[nJobs].pabyDestBuf2 = pabyDestBuf2 + nOffset;
+                asJobs[nJobs].pabyDestBuf3 = pabyDestBuf3 + nOffset;
+                asJobs[nJobs].pabyDestBuf4 = pabyDestBuf4 + nOffset;
+                poThreadPool->SubmitJob(GDALColorReliefStripJobFunc,
+                                        &asJobs[nJobs]);
+                nJobs++;
             }
+            poThreadPool->WaitCompletion();
         }
 
         /* -----------------------------------------
-         * Write Line to Raster
+         * Write Lines to Raster
          */
-        eErr = GDALRasterIO(hDstBand1,
-                            GF_Write,
-                            0, i, nXSize,
-                            1, pabyDestBuf1, nXSize, 1, GDT_Byte, 0, 0);
-        if( eErr != CE_None )
-        {
-            VSIFree(pabyPrecomputed);
-            CPLFree(pafSourceBuf);
-            CPLFree(panSourceBuf);
-            CPLFree(pabyDestBuf1);
-            CPLFree(pasColorAssociation);
-
-            return eErr;
-        }
-
-        eErr = GDALRasterIO(hDstBand2,
-                            GF_Write,
-                            0, i, nXSize,
-                            1, pabyDestBuf2, nXSize, 1, GDT_Byte, 0, 0);
-        if( eErr != CE_None )
+        GDALRasterBandH ahDstBand[4] =
+            { hDstBand1, hDstBand2, hDstBand3, hDstBand4 };
+        GByte* apabyDestBuf[4] =
+            { pabyDestBuf1, pabyDestBuf2, pabyDestBuf3, pabyDestBuf4 };
+        for( int iBand = 0; eErr == CE_None && iBand < 4; iBand++ )
         {
-            VSIFree(pabyPrecomputed);
-            CPLFree(pafSourceBuf);
-            CPLFree(panSourceBuf);
-            CPLFree(pabyDestBuf1);
-            CPLFree(pasColorAssociation);
-
-            return eErr;
+            if( ahDstBand[iBand] == NULL )
+                continue;
+            eErr = GDALRasterIO(ahDstBand[iBand],
+                                GF_Write,
+                                0, i, nXSize, nLines,
+                                apabyDestBuf[iBand], nXSize, nLines,
+                                GDT_Byte, 0, 0);
         }
-
-        eErr = GDALRasterIO(hDstBand3,
-                            GF_Write,
-                            0, i, nXSize,
-                            1, pabyDestBuf3, nXSize, 1, GDT_Byte, 0, 0);
         if( eErr != CE_None )
-        {
-            VSIFree(pabyPrecomputed);
-            CPLFree(pafSourceBuf);
-            CPLFree(panSourceBuf);
-            CPLFree(pabyDestBuf1);
-            CPLFree(pasColorAssociation);
-
-            return eErr;
-        }
-
-        if( hDstBand4 )
-        {
-            eErr = GDALRasterIO(hDstBand4,
-                        GF_Write,
-                        0, i, nXSize,
-                        1, pabyDestBuf4, nXSize, 1, GDT_Byte, 0, 0);
-            if( eErr != CE_None )
-            {
-                VSIFree(pabyPrecomputed);
-                CPLFree(pafSourceBuf);
-                CPLFree(panSourceBuf);
-                CPLFree(pabyDestBuf1);
-                CPLFree(pasColorAssociation);
-
-                return eErr;
-            }
-        }
+            break;
 
-        if( !pfnProgress( 1.0 * (i+1) / nYSize, NULL, pProgressData ) )
+        if( !pfnProgress( 1.0 * (i + nLines) / nYSize, NULL, pProgressData ) )
         {
             CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-
-            VSIFree(pabyPrecomputed);
-            CPLFree(pafSourceBuf);
-            CPLFree(panSourceBuf);
-            CPLFree(pabyDestBuf1);
-            CPLFree(pasColorAssociation);
-
-            return CE_Failure;
+            eErr = CE_Failure;
         }
     }
 
-    pfnProgress( 1.0, NULL, pProgressData );
+    if( eErr == CE_None )
+        pfnProgress( 1.0, NULL, pProgressData );
 
+    delete poThreadPool;
     VSIFree(pabyPrecomputed);
     CPLFree(pafSourceBuf);
     CPLFree(panSourceBuf);
     CPLFree(pabyDestBuf1);
     CPLFree(pasColorAssociation);
 
-    return CE_None;
+    return eErr;
 }
 
 /************************************************************************/
@@ -3204,6 +3533,31 @@ static Algorithm GetAlgorithm(const char* pszProcessing)
     }
 }
 
+/************************************************************************/
+/*                        GDALDEMGetNumThreads()                        */
+/************************************************************************/
+
+// Number of threads for the computation: NUM_THREADS creation option
+// (also understood by some drivers), or GDAL_NUM_THREADS.
+static int GDALDEMGetNumThreads( char** papszCreateOptions )
+{
+    const char* pszNumThreads =
+        CSLFetchNameValue(papszCreateOptions, "NUM_THREADS");
+    if( pszNumThreads == NULL )
+        pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+
+    int nThreads = 0;
+    if( EQUAL(pszNumThreads, "ALL_CPUS") )
+        nThreads = CPLGetNumCPUs();
+    else
+        nThreads = atoi(pszNumThreads);
+    if( nThreads < 1 )
+        nThreads = 1;
+    if( nThreads > 128 )
+        nThreads = 128;
+    return nThreads;
+}
+
 /************************************************************************/
 /*                            GDALDEMProcessing()                       */
 /************************************************************************/
@@ -3679,6 +4033,9 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
     GDALSetGeoTransform(hDstDataset, adfGeoTransform);
     GDALSetProjection(hDstDataset, GDALGetProjectionRef(hSrcDataset));
 
+    const int nNumThreads =
+        GDALDEMGetNumThreads(psOptions->papszCreateOptions);
+
     if( eUtilityMode == COLOR_RELIEF )
     {
         GDALColorRelief (hSrcBand,
@@ -3688,6 +4045,7 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
                          psOptions->bAddAlpha ? GDALGetRasterBand(hDstDataset, 4) : NULL,
                          pszColorFilename,
                          psOptions->eColorSelectionMode,
+                         nNumThreads,
                          pfnProgress, pProgressData);
     }
     else
@@ -3702,6 +4060,7 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
                                              pfnAlgInt32_multisample,
                                              pData,
                                              psOptions->bComputeAtEdges,
+                                             nNumThreads,
                                              pfnProgress, pProgressData);
         }
         else
@@ -3711,6 +4070,7 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
                                             NULL,
                                             pData,
                                             psOptions->bComputeAtEdges,
+                                            nNumThreads,
                                             pfnProgress, pProgressData);
         }
     }
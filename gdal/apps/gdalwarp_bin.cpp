@@ -178,7 +178,11 @@ nodata (unset/transparent) pixels. </dd>
 megabytes) that the warp API is allowed to use for caching.</dd>
 <dt> <b>-multi</b>:</dt><dd> Use multithreaded warping implementation.
 Multiple threads will be used to process chunks of image and perform
-input/output operation simultaneously.</dd>
+input/output operation simultaneously. Starting with GDAL 2.3, when
+combined with <b>-wo NUM_THREADS=</b><em>val</em> (or the GDAL_NUM_THREADS
+configuration option), several output chunks are warped concurrently by that
+number of threads, the memory set with <b>-wm</b> being shared between them,
+and reads and writes remain serialized.</dd>
 <dt> <b>-q</b>:</dt><dd> Be quiet.</dd>
 <dt> <b>-of</b> <em>format</em>:</dt><dd> Select the output format. The default is GeoTIFF (GTiff). Use the short format name. </dd>
 <dt> <b>-co</b> <em>"NAME=VALUE"</em>:</dt><dd> passes a creation option to
@@ -31,6 +31,12 @@
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
 CPL_CVSID("$Id$");
 
 static int nThreadCount = 4, nIterations = 1, bLockOnOpen = TRUE;
@@ -38,10 +44,12 @@ static int nOpenIterations = 1;
 static volatile int nPendingThreads = 0;
 static const char *pszFilename = NULL;
 static int nChecksum = 0;
+static int bBenchmark = FALSE;
 
 static CPLMutex *pGlobalMutex = NULL;
 
 static void WorkerFunc( void * );
+static void Benchmark();
 
 /************************************************************************/
 /*                               Usage()                                */
@@ -49,9 +57,14 @@ static void WorkerFunc( void * );
 
 static void Usage()
 {
-    printf( "multireadtest [-nlo] [-t <thread#>]\n"
+    printf( "multireadtest [-nlo] [-t <thread#>] [-bench]\n"
             "              [-i <iterations>] [-oi <iterations>\n"
-            "              filename\n" );
+            "              filename\n"
+            "\n"
+            "  -bench: time the reading of the file with 1, 2, 4, ... up to\n"
+            "          <thread#> threads, each one using its own dataset.\n"
+            "          Use --config GDAL_RB_LRU_SHARDS <n> to compare the\n"
+            "          exact global block cache LRU (n=1) with a sharded one.\n" );
     exit( 1 );
 }
 
@@ -81,6 +94,8 @@ int main( int argc, char ** argv )
             nThreadCount = atoi(argv[++iArg]);
         else if( EQUAL(argv[iArg],"-nlo") )
             bLockOnOpen = FALSE;
+        else if( EQUAL(argv[iArg],"-bench") )
+            bBenchmark = TRUE;
         else if( pszFilename == NULL )
             pszFilename = argv[iArg];
         else
@@ -120,6 +135,17 @@ int main( int argc, char ** argv )
     GDALClose( hDS );
     }
 
+    if( bBenchmark )
+    {
+        printf( "Got checksum %d, benchmarking up to %d threads on %s, "
+                "%d iterations.\n",
+                nChecksum, nThreadCount, pszFilename, nIterations );
+        Benchmark();
+        CSLDestroy( argv );
+        GDALDestroyDriverManager();
+        return 0;
+    }
+
     printf( "Got checksum %d, launching %d worker threads on %s, %d iterations.\n",
             nChecksum, nThreadCount, pszFilename, nIterations );
 
@@ -206,3 +232,121 @@ static void WorkerFunc( void * )
     nPendingThreads--;
     CPLReleaseMutex( pGlobalMutex );
 }
+
+/************************************************************************/
+/*                              GetTime()                               */
+/************************************************************************/
+
+static double GetTime()
+{
+#ifdef _WIN32
+    return GetTickCount() / 1000.0;
+#else
+    struct timeval tv;
+    gettimeofday( &tv, NULL );
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+}
+
+/************************************************************************/
+/*                           BenchmarkFunc()                            */
+/************************************************************************/
+
+static void BenchmarkFunc( void *pbError )
+
+{
+    GDALDatasetH hDS = GDALOpen( pszFilename, GA_ReadOnly );
+    if( hDS == NULL )
+    {
+        *static_cast<int*>(pbError) = TRUE;
+        return;
+    }
+
+    for( int iIter = 0; iIter < nIterations; iIter++ )
+    {
+        for( int iBand = 1; iBand <= GDALGetRasterCount( hDS ); iBand++ )
+        {
+            const int nMyChecksum =
+                GDALChecksumImage( GDALGetRasterBand( hDS, iBand ),
+                                   0, 0,
+                                   GDALGetRasterXSize( hDS ),
+                                   GDALGetRasterYSize( hDS ) );
+            if( iBand == 1 && nMyChecksum != nChecksum )
+            {
+                printf( "Checksum ERROR in worker thread!\n" );
+                *static_cast<int*>(pbError) = TRUE;
+            }
+        }
+    }
+
+    GDALClose( hDS );
+}
+
+/************************************************************************/
+/*                             Benchmark()                              */
+/*                                                                      */
+/*      Read the file with an increasing number of threads, each one    */
+/*      with its own dataset, and report the throughput. This mostly    */
+/*      stresses the global block cache when the file is in the OS      */
+/*      cache.                                                          */
+/************************************************************************/
+
+static void Benchmark()
+
+{
+    printf( "GDAL_RB_LRU_SHARDS = %s, GDAL_CACHEMAX = " CPL_FRMT_GIB " MB\n",
+            CPLGetConfigOption( "GDAL_RB_LRU_SHARDS", "1" ),
+            GDALGetCacheMax64() / (1024 * 1024) );
+
+    double dfRefDuration = 0.0;
+    for( int nThreads = 1; nThreads <= nThreadCount; )
+    {
+        CPLJoinableThread **pahThreads = static_cast<CPLJoinableThread**>(
+            CPLCalloc( nThreads, sizeof(CPLJoinableThread*) ) );
+        int *pabError = static_cast<int*>( CPLCalloc( nThreads, sizeof(int) ) );
+
+        const double dfStart = GetTime();
+        for( int iThread = 0; iThread < nThreads; iThread++ )
+        {
+            pahThreads[iThread] =
+                CPLCreateJoinableThread( BenchmarkFunc, pabError + iThread );
+            if( pahThreads[iThread] == NULL )
+            {
+                printf( "CPLCreateJoinableThread() failed.\n" );
+                exit( 1 );
+            }
+        }
+        bool bError = false;
+        for( int iThread = 0; iThread < nThreads; iThread++ )
+        {
+            CPLJoinThread( pahThreads[iThread] );
+            if( pabError[iThread] )
+                bError = true;
+        }
+        const double dfDuration = GetTime() - dfStart;
+
+        CPLFree( pahThreads );
+        CPLFree( pabError );
+
+        if( bError )
+        {
+            printf( "Errors occurred with %d threads.\n", nThreads );
+            exit( 1 );
+        }
+
+        // Each thread does the same amount of work, so with perfect scaling
+        // the duration would remain constant.
+        if( nThreads == 1 )
+            dfRefDuration = dfDuration;
+        printf( "%3d threads: %.3f s, speed-up %.2f (efficiency %.0f %%)\n",
+                nThreads, dfDuration,
+                dfDuration > 0 ? nThreads * dfRefDuration / dfDuration : 0.0,
+                dfDuration > 0 ? 100.0 * dfRefDuration / dfDuration : 0.0 );
+
+        if( nThreads == nThreadCount )
+            break;
+        nThreads *= 2;
+        if( nThreads > nThreadCount )
+            nThreads = nThreadCount;
+    }
+}
@@ -214,6 +214,26 @@ typedef struct
     int           nCompressedBufferSize;
     bool          bReady;
 } GTiffCompressionJob;
+
+typedef struct
+{
+    GTiffDataset *poDS;
+    bool          bTIFFIsBigEndian;
+    uint16        nPredictor;
+    uint16        nFillOrder;
+    int           nStripOrTile;
+    int           nBlockXOff;
+    int           nBlockYOff;
+    int           nBand;  // 0 for all bands of pixel-interleaved files.
+    int           nHeight;
+    vsi_l_offset  nOffset;
+
+    GByte        *pabyCompressedBuffer;
+    int           nCompressedBufferSize;
+    GByte        *pabyBuffer;
+    int           nBufferSize;
+    bool          bSuccess;
+} GTiffDecompressionJob;
 #if !defined(__MINGW32__)
 }
 #endif
@@ -426,6 +446,7 @@ class GTiffDataset CPL_FINAL : public GDALPamDataset
     CPLWorkerThreadPool *poCompressThreadPool;
     std::vector<GTiffCompressionJob> asCompressionJobs;
     CPLMutex      *hCompressThreadPoolMutex;
+    bool           bReadThreadPoolInitialized;
     void           InitCompressionThreads( char** papszOptions );
     void           InitCreationOrOpenOptions( char** papszOptions );
     static void    ThreadCompressionFunc( void* pData );
@@ -435,6 +456,12 @@ class GTiffDataset CPL_FINAL : public GDALPamDataset
                                         int nCompressedBufferSize );
     bool           SubmitCompressionJob( int nStripOrTile, GByte* pabyData,
                                          int cc, int nHeight) ;
+    static void    ThreadDecompressionFunc( void* pData );
+    int            GetMultiThreadedReadMaxBlockRows( int nXOff, int nXSize,
+                                                     int nBandCount );
+    void           MultiThreadedRead( int nXOff, int nYOff,
+                                      int nXSize, int nYSize,
+                                      int nBandCount, const int *panBandMap );
 
     int            GuessJPEGQuality( bool& bOutHasQuantizationTable,
                                      bool& bOutHasHuffmanTable );
@@ -2052,6 +2079,53 @@ CPLErr GTiffDataset::IRasterIO( GDALRWFlag eRWFlag,
             return static_cast<CPLErr>(nErr);
     }
 
+/* -------------------------------------------------------------------- */
+/*      Decode the blocks needed by the request in worker threads,      */
+/*      processing the window in chunks of block rows if it is too      */
+/*      large for the block cache.                                      */
+/* -------------------------------------------------------------------- */
+    const int nMTMaxBlockRows = eRWFlag == GF_Read ?
+        GetMultiThreadedReadMaxBlockRows(nXOff, nXSize, nBandCount) : 0;
+    if( nMTMaxBlockRows > 0 )
+    {
+        const int nBlockY1 = nYOff / nBlockYSize;
+        const int nBlockY2 = (nYOff + nYSize - 1) / nBlockYSize;
+        if( nBlockY2 - nBlockY1 + 1 <= nMTMaxBlockRows )
+        {
+            MultiThreadedRead(nXOff, nYOff, nXSize, nYSize,
+                              nBandCount, panBandMap);
+        }
+        else if( nXSize == nBufXSize && nYSize == nBufYSize &&
+                 !psExtraArg->bFloatingPointWindowValidity )
+        {
+            CPLErr eErr = CE_None;
+            for( int nChunkYOff = nYOff;
+                 eErr == CE_None && nChunkYOff < nYOff + nYSize; )
+            {
+                const int nChunkYEnd = std::min(nYOff + nYSize,
+                    static_cast<int>((nChunkYOff / nBlockYSize +
+                                      nMTMaxBlockRows) * nBlockYSize));
+                GDALRasterIOExtraArg sExtraArg;
+                INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+                sExtraArg.pfnProgress = GDALScaledProgress;
+                sExtraArg.pProgressData = GDALCreateScaledProgress(
+                    static_cast<double>(nChunkYOff - nYOff) / nYSize,
+                    static_cast<double>(nChunkYEnd - nYOff) / nYSize,
+                    psExtraArg->pfnProgress, psExtraArg->pProgressData );
+                eErr = IRasterIO(
+                    eRWFlag, nXOff, nChunkYOff, nXSize, nChunkYEnd - nChunkYOff,
+                    static_cast<GByte*>(pData) +
+                        (nChunkYOff - nYOff) * nLineSpace,
+                    nXSize, nChunkYEnd - nChunkYOff, eBufType,
+                    nBandCount, panBandMap, nPixelSpace, nLineSpace,
+                    nBandSpace, &sExtraArg );
+                GDALDestroyScaledProgress(sExtraArg.pProgressData);
+                nChunkYOff = nChunkYEnd;
+            }
+            return eErr;
+        }
+    }
+
     ++nJPEGOverviewVisibilityCounter;
     const CPLErr eErr =
         GDALPamDataset::IRasterIO(
@@ -3934,6 +4008,51 @@ CPLErr GTiffRasterBand::IRasterIO( GDALRWFlag eRWFlag,
             return static_cast<CPLErr>(nErr);
     }
 
+/* -------------------------------------------------------------------- */
+/*      Decode the blocks needed by the request in worker threads,      */
+/*      processing the window in chunks of block rows if it is too      */
+/*      large for the block cache.                                      */
+/* -------------------------------------------------------------------- */
+    const int nMTMaxBlockRows = eRWFlag == GF_Read ?
+        poGDS->GetMultiThreadedReadMaxBlockRows(nXOff, nXSize, 1) : 0;
+    if( nMTMaxBlockRows > 0 )
+    {
+        const int nBlockY1 = nYOff / nBlockYSize;
+        const int nBlockY2 = (nYOff + nYSize - 1) / nBlockYSize;
+        if( nBlockY2 - nBlockY1 + 1 <= nMTMaxBlockRows )
+        {
+            poGDS->MultiThreadedRead(nXOff, nYOff, nXSize, nYSize,
+                                     1, &nBand);
+        }
+        else if( nXSize == nBufXSize && nYSize == nBufYSize &&
+                 !psExtraArg->bFloatingPointWindowValidity )
+        {
+            CPLErr eErr = CE_None;
+            for( int nChunkYOff = nYOff;
+                 eErr == CE_None && nChunkYOff < nYOff + nYSize; )
+            {
+                const int nChunkYEnd = std::min(nYOff + nYSize,
+                    (nChunkYOff / nBlockYSize + nMTMaxBlockRows) * nBlockYSize);
+                GDALRasterIOExtraArg sExtraArg;
+                INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+                sExtraArg.pfnProgress = GDALScaledProgress;
+                sExtraArg.pProgressData = GDALCreateScaledProgress(
+                    static_cast<double>(nChunkYOff - nYOff) / nYSize,
+                    static_cast<double>(nChunkYEnd - nYOff) / nYSize,
+                    psExtraArg->pfnProgress, psExtraArg->pProgressData );
+                eErr = IRasterIO(
+                    eRWFlag, nXOff, nChunkYOff, nXSize, nChunkYEnd - nChunkYOff,
+                    static_cast<GByte*>(pData) +
+                        (nChunkYOff - nYOff) * nLineSpace,
+                    nXSize, nChunkYEnd - nChunkYOff, eBufType,
+                    nPixelSpace, nLineSpace, &sExtraArg );
+                GDALDestroyScaledProgress(sExtraArg.pProgressData);
+                nChunkYOff = nChunkYEnd;
+            }
+            return eErr;
+        }
+    }
+
     if( poGDS->nBands != 1 &&
         poGDS->nPlanarConfig == PLANARCONFIG_CONTIG &&
         eRWFlag == GF_Read &&
@@ -6873,6 +6992,7 @@ GTiffDataset::GTiffDataset() :
     bHasDiscardedLsb(false),
     poCompressThreadPool(NULL),
     hCompressThreadPoolMutex(NULL),
+    bReadThreadPoolInitialized(false),
     m_pTempBufferForCommonDirectIO(NULL),
     m_nTempBufferForCommonDirectIOSize(0),
     m_bReadGeoTransform(false),
@@ -7927,7 +8047,9 @@ void GTiffDataset::InitCompressionThreads( char** papszOptions )
             }
             else
             {
-                CPLDebug("GTiff", "Using %d threads for compression", nThreads);
+                CPLDebug("GTiff", "Using %d threads for %s",
+                         nThreads, eAccess == GA_Update ? "compression" :
+                                                          "decompression");
                 poCompressThreadPool = new CPLWorkerThreadPool();
                 if( !poCompressThreadPool->Setup(nThreads, NULL, NULL) )
                 {
@@ -7962,7 +8084,8 @@ void GTiffDataset::InitCompressionThreads( char** papszOptions )
                     // (if using TIFFWriteEncodedStrip/Tile first,
                     // TIFFWriteBufferSetup() is automatically called).
                     // This should likely rather fixed in libtiff itself.
-                    TIFFWriteBufferSetup(hTIFF, NULL, -1);
+                    if( eAccess == GA_Update )
+                        TIFFWriteBufferSetup(hTIFF, NULL, -1);
                 }
             }
         }
@@ -8085,6 +8208,306 @@ void GTiffDataset::ThreadCompressionFunc( void* pData )
     CPLReleaseMutex(poDS->hCompressThreadPoolMutex);
 }
 
+/************************************************************************/
+/*                      ThreadDecompressionFunc()                       */
+/************************************************************************/
+
+void GTiffDataset::ThreadDecompressionFunc( void* pData )
+{
+    GTiffDecompressionJob* psJob = static_cast<GTiffDecompressionJob *>(pData);
+    GTiffDataset* poDS = psJob->poDS;
+
+    // libtiff handles cannot be shared between threads, so decode the
+    // compressed bytes through a temporary single-strip TIFF file using the
+    // same encoding parameters as the source strip or tile.
+    CPLString osTmpFilename;
+    osTmpFilename.Printf("/vsimem/gtiff/thread/decompress/%p", psJob);
+
+    // Errors are silently ignored: the block will be read again
+    // (and errors reported) by IReadBlock().
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+
+    bool bOK = false;
+    VSILFILE* fpTmp = VSIFOpenL(osTmpFilename, "wb+");
+    TIFF* hTIFFTmp = fpTmp == NULL ? NULL :
+        VSI_TIFFOpen(osTmpFilename,
+                     psJob->bTIFFIsBigEndian ? "wb+" : "wl+", fpTmp);
+    if( hTIFFTmp != NULL )
+    {
+        TIFFSetField(hTIFFTmp, TIFFTAG_IMAGEWIDTH, poDS->nBlockXSize);
+        TIFFSetField(hTIFFTmp, TIFFTAG_IMAGELENGTH, psJob->nHeight);
+        TIFFSetField(hTIFFTmp, TIFFTAG_BITSPERSAMPLE, poDS->nBitsPerSample);
+        TIFFSetField(hTIFFTmp, TIFFTAG_COMPRESSION, poDS->nCompression);
+        if( psJob->nPredictor != PREDICTOR_NONE )
+            TIFFSetField(hTIFFTmp, TIFFTAG_PREDICTOR, psJob->nPredictor);
+        if( psJob->nFillOrder != FILLORDER_MSB2LSB )
+            TIFFSetField(hTIFFTmp, TIFFTAG_FILLORDER, psJob->nFillOrder);
+        TIFFSetField(hTIFFTmp, TIFFTAG_PHOTOMETRIC, poDS->nPhotometric);
+        TIFFSetField(hTIFFTmp, TIFFTAG_SAMPLEFORMAT, poDS->nSampleFormat);
+        TIFFSetField(hTIFFTmp, TIFFTAG_SAMPLESPERPIXEL,
+                     poDS->nSamplesPerPixel);
+        TIFFSetField(hTIFFTmp, TIFFTAG_ROWSPERSTRIP, psJob->nHeight);
+        TIFFSetField(hTIFFTmp, TIFFTAG_PLANARCONFIG, poDS->nPlanarConfig);
+
+        // See comment in InitCompressionThreads() about reading back a
+        // strip written with TIFFWriteRawStrip().
+        TIFFWriteBufferSetup(hTIFFTmp, NULL, -1);
+
+        bOK =
+            TIFFWriteRawStrip(hTIFFTmp, 0, psJob->pabyCompressedBuffer,
+                              psJob->nCompressedBufferSize) ==
+                                        psJob->nCompressedBufferSize &&
+            TIFFReadEncodedStrip(hTIFFTmp, 0, psJob->pabyBuffer,
+                                 psJob->nBufferSize) == psJob->nBufferSize;
+
+        XTIFFClose(hTIFFTmp);
+    }
+    if( fpTmp != NULL )
+        VSIFCloseL(fpTmp);
+    VSIUnlink(osTmpFilename);
+
+    CPLPopErrorHandler();
+
+    psJob->bSuccess = bOK;
+}
+
+/************************************************************************/
+/*                  GetMultiThreadedReadMaxBlockRows()                  */
+/*                                                                      */
+/*      Return the number of block rows of a window that can be         */
+/*      decoded in one go by MultiThreadedRead(), or 0 if               */
+/*      multi-threaded decoding cannot be used.                         */
+/************************************************************************/
+
+int GTiffDataset::GetMultiThreadedReadMaxBlockRows( int nXOff, int nXSize,
+                                                    int nBandCount )
+{
+    if( eAccess != GA_ReadOnly || bStreamingIn ||
+        bTreatAsRGBA || bTreatAsSplit || bTreatAsSplitBitmap ||
+        nCompression == COMPRESSION_NONE ||
+        nCompression == COMPRESSION_JPEG ||
+        nPhotometric == PHOTOMETRIC_YCBCR ||
+        (nPlanarConfig == PLANARCONFIG_CONTIG &&
+         nSamplesPerPixel != nBands) )
+    {
+        return 0;
+    }
+
+    // Only for bands handled by GTiffRasterBand itself, that is whose
+    // sample size matches the size of their data type.
+    const int nDTSizeBits =
+        GDALGetDataTypeSizeBits(GetRasterBand(1)->GetRasterDataType());
+    if( nBitsPerSample != nDTSizeBits || (nBitsPerSample % 8) != 0 )
+        return 0;
+
+    if( !bReadThreadPoolInitialized )
+    {
+        // Create the worker threads at the first opportunity, since most
+        // datasets never get a read request spanning several blocks.
+        bReadThreadPoolInitialized = true;
+        if( poCompressThreadPool == NULL && poBaseDS == NULL )
+            InitCompressionThreads(papszOpenOptions);
+    }
+    if( poCompressThreadPool == NULL )
+        return 0;
+
+    const int nBlockX1 = nXOff / nBlockXSize;
+    const int nBlockX2 = (nXOff + nXSize - 1) / nBlockXSize;
+    const GIntBig nBlockRowSize =
+        static_cast<GIntBig>(nBlockX2 - nBlockX1 + 1) *
+        nBlockXSize * nBlockYSize * (nBitsPerSample / 8) *
+        (nPlanarConfig == PLANARCONFIG_CONTIG ? nBands : nBandCount);
+
+    // Only use half of the block cache, so that the decoded blocks are not
+    // evicted before being used.
+    const GIntBig nMaxBlockRows = GDALGetCacheMax64() / 2 / nBlockRowSize;
+    return static_cast<int>(std::min(nMaxBlockRows,
+                                     static_cast<GIntBig>(INT_MAX)));
+}
+
+/************************************************************************/
+/*                         MultiThreadedRead()                          */
+/*                                                                      */
+/*      Decode in worker threads the strips or tiles intersecting the   */
+/*      window that are not yet in the block cache, and put them in     */
+/*      it. This is only an optimization, so errors are not reported    */
+/*      here: blocks that could not be decoded will go through          */
+/*      IReadBlock() as usual.                                          */
+/************************************************************************/
+
+void GTiffDataset::MultiThreadedRead( int nXOff, int nYOff,
+                                      int nXSize, int nYSize,
+                                      int nBandCount, const int *panBandMap )
+{
+    if( !SetDirectory() )
+        return;
+
+    const int nBlockX1 = nXOff / nBlockXSize;
+    const int nBlockY1 = nYOff / nBlockYSize;
+    const int nBlockX2 = (nXOff + nXSize - 1) / nBlockXSize;
+    const int nBlockY2 = (nYOff + nYSize - 1) / nBlockYSize;
+    const int nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, nBlockXSize);
+    const bool bInterleaved =
+        nPlanarConfig == PLANARCONFIG_CONTIG && nBands > 1;
+    const int nWordBytes = nBitsPerSample / 8;
+    const bool bIsTiled = CPL_TO_BOOL(TIFFIsTiled(hTIFF));
+
+    uint16 nPredictor = PREDICTOR_NONE;
+    if( !TIFFGetField(hTIFF, TIFFTAG_PREDICTOR, &nPredictor) )
+        nPredictor = PREDICTOR_NONE;
+    uint16 nFillOrder = FILLORDER_MSB2LSB;
+    if( !TIFFGetField(hTIFF, TIFFTAG_FILLORDER, &nFillOrder) )
+        nFillOrder = FILLORDER_MSB2LSB;
+
+/* -------------------------------------------------------------------- */
+/*      Collect the blocks that must be decoded.                        */
+/* -------------------------------------------------------------------- */
+    std::vector<GTiffDecompressionJob> asJobs;
+    for( int iY = nBlockY1; iY <= nBlockY2; ++iY )
+    {
+        for( int iX = nBlockX1; iX <= nBlockX2; ++iX )
+        {
+            for( int i = 0; i < (bInterleaved ? 1 : nBandCount); ++i )
+            {
+                const int nBand = bInterleaved ? 0 : panBandMap[i];
+
+                // Skip blocks already cached for all the bands they hold.
+                bool bNeeded = false;
+                for( int iBand = (bInterleaved ? 1 : nBand);
+                     iBand <= (bInterleaved ? nBands : nBand) && !bNeeded;
+                     ++iBand )
+                {
+                    GTiffRasterBand* poBand =
+                        static_cast<GTiffRasterBand*>(GetRasterBand(iBand));
+                    GDALRasterBlock* poBlock =
+                        poBand->TryGetLockedBlockRef(iX, iY);
+                    if( poBlock != NULL )
+                        poBlock->DropLock();
+                    else
+                        bNeeded = true;
+                }
+                if( !bNeeded )
+                    continue;
+
+                int nBlockId = iX + iY * nBlocksPerRow;
+                if( nPlanarConfig == PLANARCONFIG_SEPARATE )
+                    nBlockId += (nBand - 1) * nBlocksPerBand;
+
+                vsi_l_offset nOffset = 0;
+                vsi_l_offset nSize = 0;
+                if( nBlockId == nLoadedBlock ||
+                    !IsBlockAvailable(nBlockId, &nOffset, &nSize) ||
+                    nSize == 0 || nSize > static_cast<vsi_l_offset>(INT_MAX) )
+                {
+                    continue;
+                }
+
+                GTiffDecompressionJob sJob;
+                memset(&sJob, 0, sizeof(sJob));
+                sJob.poDS = this;
+                sJob.bTIFFIsBigEndian = CPL_TO_BOOL(TIFFIsBigEndian(hTIFF));
+                sJob.nPredictor = nPredictor;
+                sJob.nFillOrder = nFillOrder;
+                sJob.nStripOrTile = nBlockId;
+                sJob.nBlockXOff = iX;
+                sJob.nBlockYOff = iY;
+                sJob.nBand = nBand;
+                // The last strip only contains the remaining lines.
+                sJob.nHeight = bIsTiled ? static_cast<int>(nBlockYSize) :
+                    std::min(static_cast<int>(nBlockYSize),
+                             nRasterYSize - iY * static_cast<int>(nBlockYSize));
+                sJob.nOffset = nOffset;
+                sJob.nCompressedBufferSize = static_cast<int>(nSize);
+                sJob.nBufferSize = nBlockXSize * sJob.nHeight * nWordBytes *
+                                   (bInterleaved ? nBands : 1);
+                asJobs.push_back(sJob);
+            }
+        }
+    }
+    if( asJobs.size() < 2 )
+        return;
+
+/* -------------------------------------------------------------------- */
+/*      Read the compressed data in file order and submit the           */
+/*      decoding jobs as soon as their data is available.               */
+/* -------------------------------------------------------------------- */
+    std::vector< std::pair<vsi_l_offset, size_t> > aoOrder;
+    for( size_t i = 0; i < asJobs.size(); ++i )
+        aoOrder.push_back(std::pair<vsi_l_offset, size_t>(asJobs[i].nOffset, i));
+    std::sort(aoOrder.begin(), aoOrder.end());
+
+    VSILFILE* fp = VSI_TIFFGetVSILFile(TIFFClientdata( hTIFF ));
+    for( size_t i = 0; i < aoOrder.size(); ++i )
+    {
+        GTiffDecompressionJob& sJob = asJobs[aoOrder[i].second];
+        sJob.pabyCompressedBuffer = static_cast<GByte*>(
+            VSI_MALLOC_VERBOSE(sJob.nCompressedBufferSize));
+        sJob.pabyBuffer = static_cast<GByte*>(
+            VSI_MALLOC_VERBOSE(sJob.nBufferSize));
+        if( sJob.pabyCompressedBuffer == NULL || sJob.pabyBuffer == NULL ||
+            VSIFSeekL(fp, sJob.nOffset, SEEK_SET) != 0 ||
+            VSIFReadL(sJob.pabyCompressedBuffer, 1,
+                      sJob.nCompressedBufferSize, fp) !=
+                static_cast<size_t>(sJob.nCompressedBufferSize) )
+        {
+            continue;
+        }
+        poCompressThreadPool->SubmitJob(ThreadDecompressionFunc, &sJob);
+    }
+    poCompressThreadPool->WaitCompletion();
+
+/* -------------------------------------------------------------------- */
+/*      Put the decoded blocks in the block cache.                      */
+/* -------------------------------------------------------------------- */
+    const GDALDataType eDT = GetRasterBand(1)->GetRasterDataType();
+    const int nBlockPixels = nBlockXSize * nBlockYSize;
+    for( size_t i = 0; i < asJobs.size(); ++i )
+    {
+        GTiffDecompressionJob& sJob = asJobs[i];
+        for( int iBand = (bInterleaved ? 1 : sJob.nBand);
+             sJob.bSuccess && iBand <= (bInterleaved ? nBands : sJob.nBand);
+             ++iBand )
+        {
+            GTiffRasterBand* poBand =
+                static_cast<GTiffRasterBand*>(GetRasterBand(iBand));
+            GDALRasterBlock* poBlock =
+                poBand->TryGetLockedBlockRef(sJob.nBlockXOff, sJob.nBlockYOff);
+            if( poBlock != NULL )
+            {
+                poBlock->DropLock();
+                continue;
+            }
+            poBlock = poBand->GetLockedBlockRef(sJob.nBlockXOff,
+                                                sJob.nBlockYOff, TRUE);
+            if( poBlock == NULL )
+                break;
+
+            GByte* pabyDest = static_cast<GByte*>(poBlock->GetDataRef());
+            const int nPixels = nBlockXSize * sJob.nHeight;
+            if( bInterleaved )
+            {
+                GDALCopyWords(sJob.pabyBuffer + (iBand - 1) * nWordBytes,
+                              eDT, nBands * nWordBytes,
+                              pabyDest, eDT, nWordBytes,
+                              nPixels);
+            }
+            else
+            {
+                memcpy(pabyDest, sJob.pabyBuffer, nPixels * nWordBytes);
+            }
+            if( nPixels < nBlockPixels )
+            {
+                memset(pabyDest + nPixels * nWordBytes, 0,
+                       (nBlockPixels - nPixels) * nWordBytes);
+            }
+            poBlock->DropLock();
+        }
+
+        VSIFree(sJob.pabyCompressedBuffer);
+        VSIFree(sJob.pabyBuffer);
+    }
+}
+
 /************************************************************************/
 /*                        WriteRawStripOrTile()                         */
 /************************************************************************/
@@ -17832,7 +18255,7 @@ void GDALRegister_GTiff()
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST, szCreateOptions );
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
 "<OpenOptionList>"
-"   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression. Can be set to ALL_CPUS' default='1'/>"
+"   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression and decompression. Can be set to ALL_CPUS' default='1'/>"
 "   <Option name='GEOTIFF_KEYS_FLAVOR' type='string-select' default='STANDARD' description='Which flavor of GeoTIFF keys must be used (for writing)'>"
 "       <Value>STANDARD</Value>"
 "       <Value>ESRI_PE</Value>"
@@ -29,8 +29,11 @@
 
 #include <cmath>
 #include "gdal.h"
+#include "gdalsse_priv.h"
 #include "vrtdataset.h"
 
+#include <algorithm>
+
 CPL_CVSID("$Id$");
 
 static CPLErr RealPixelFunc( void **papoSources, int nSources, void *pData,
@@ -873,6 +876,428 @@ static CPLErr dB2PowPixelFunc( void **papoSources, int nSources, void *pData,
                               nPixelSpace, nLineSpace, 10.0, 10.0);
 }  // dB2PowPixelFunc
 
+/************************************************************************/
+/* ==================================================================== */
+/*                        Typed pixel functions                         */
+/* ==================================================================== */
+/*                                                                      */
+/*      Implementations of the GDALDerivedPixelFuncTyped interface for  */
+/*      real (non-complex) sources and Float32/Float64 outputs. Values   */
+/*      are processed by chunks: sources are loaded/combined into a     */
+/*      double accumulator with SSE2 where available, then transformed  */
+/*      and stored. Other cases are left to the GDALDerivedPixelFunc    */
+/*      registered under the same name.                                 */
+/* ==================================================================== */
+/************************************************************************/
+
+// Number of values processed at once, so that the accumulator stays in
+// the L1 cache.
+static const size_t TYPED_CHUNK_SIZE = 1024;
+
+typedef enum
+{
+    TPO_SET,
+    TPO_ADD,
+    TPO_SUB,
+    TPO_MUL
+} TypedPixelOp;
+
+typedef enum
+{
+    TPT_IDENTITY,
+    TPT_ZERO,
+    TPT_ABS,
+    TPT_PHASE,
+    TPT_INV,
+    TPT_SQUARE,
+    TPT_SQRT,
+    TPT_LOG10,
+    TPT_POW
+} TypedPixelTransform;
+
+/************************************************************************/
+/*                          CombineChunk()                              */
+/************************************************************************/
+
+template<class T> static inline void CombineScalar( const T* pSrc,
+                                                    size_t i, size_t nCount,
+                                                    double* padfAcc,
+                                                    TypedPixelOp eOp )
+{
+    switch( eOp )
+    {
+        case TPO_SET:
+            for( ; i < nCount; ++i ) padfAcc[i] = pSrc[i];
+            break;
+        case TPO_ADD:
+            for( ; i < nCount; ++i ) padfAcc[i] += pSrc[i];
+            break;
+        case TPO_SUB:
+            for( ; i < nCount; ++i ) padfAcc[i] -= pSrc[i];
+            break;
+        case TPO_MUL:
+            for( ; i < nCount; ++i ) padfAcc[i] *= pSrc[i];
+            break;
+    }
+}
+
+template<class T> static void CombineChunk( const T* pSrc, size_t nCount,
+                                            double* padfAcc, TypedPixelOp eOp )
+{
+    CombineScalar( pSrc, 0, nCount, padfAcc, eOp );
+}
+
+// Types that XMMReg4Double can load directly.
+template<class T> static void CombineChunkSSE( const T* pSrc, size_t nCount,
+                                               double* padfAcc,
+                                               TypedPixelOp eOp )
+{
+    size_t i = 0;
+    for( ; i + 3 < nCount; i += 4 )
+    {
+        XMMReg4Double oVal = XMMReg4Double::Load4Val(pSrc + i);
+        if( eOp != TPO_SET )
+        {
+            const XMMReg4Double oAcc = XMMReg4Double::Load4Val(padfAcc + i);
+            if( eOp == TPO_ADD )
+                oVal = oAcc + oVal;
+            else if( eOp == TPO_SUB )
+                oVal = oAcc - oVal;
+            else
+                oVal = oAcc * oVal;
+        }
+        oVal.GetLow().Store2Double(padfAcc + i);
+        oVal.GetHigh().Store2Double(padfAcc + i + 2);
+    }
+    CombineScalar( pSrc, i, nCount, padfAcc, eOp );
+}
+
+template<> void CombineChunk<GByte>( const GByte* pSrc, size_t nCount,
+                                     double* padfAcc, TypedPixelOp eOp )
+{
+    CombineChunkSSE( pSrc, nCount, padfAcc, eOp );
+}
+
+template<> void CombineChunk<GUInt16>( const GUInt16* pSrc, size_t nCount,
+                                       double* padfAcc, TypedPixelOp eOp )
+{
+    CombineChunkSSE( pSrc, nCount, padfAcc, eOp );
+}
+
+template<> void CombineChunk<GInt16>( const GInt16* pSrc, size_t nCount,
+                                      double* padfAcc, TypedPixelOp eOp )
+{
+    CombineChunkSSE( pSrc, nCount, padfAcc, eOp );
+}
+
+template<> void CombineChunk<float>( const float* pSrc, size_t nCount,
+                                     double* padfAcc, TypedPixelOp eOp )
+{
+    CombineChunkSSE( pSrc, nCount, padfAcc, eOp );
+}
+
+template<> void CombineChunk<double>( const double* pSrc, size_t nCount,
+                                      double* padfAcc, TypedPixelOp eOp )
+{
+    CombineChunkSSE( pSrc, nCount, padfAcc, eOp );
+}
+
+static bool CombineChunk( GDALDataType eSrcType, const void* pSrc,
+                          size_t nOffset, size_t nCount,
+                          double* padfAcc, TypedPixelOp eOp )
+{
+    switch( eSrcType )
+    {
+        case GDT_Byte:
+            CombineChunk( static_cast<const GByte*>(pSrc) + nOffset,
+                          nCount, padfAcc, eOp );
+            return true;
+        case GDT_UInt16:
+            CombineChunk( static_cast<const GUInt16*>(pSrc) + nOffset,
+                          nCount, padfAcc, eOp );
+            return true;
+        case GDT_Int16:
+            CombineChunk( static_cast<const GInt16*>(pSrc) + nOffset,
+                          nCount, padfAcc, eOp );
+            return true;
+        case GDT_UInt32:
+            CombineChunk( static_cast<const GUInt32*>(pSrc) + nOffset,
+                          nCount, padfAcc, eOp );
+            return true;
+        case GDT_Int32:
+            CombineChunk( static_cast<const GInt32*>(pSrc) + nOffset,
+                          nCount, padfAcc, eOp );
+            return true;
+        case GDT_Float32:
+            CombineChunk( static_cast<const float*>(pSrc) + nOffset,
+                          nCount, padfAcc, eOp );
+            return true;
+        case GDT_Float64:
+            CombineChunk( static_cast<const double*>(pSrc) + nOffset,
+                          nCount, padfAcc, eOp );
+            return true;
+        default:
+            return false;
+    }
+}
+
+/************************************************************************/
+/*                         TransformChunk()                             */
+/************************************************************************/
+
+static void TransformChunk( double* padfAcc, size_t nCount,
+                            TypedPixelTransform eTransform,
+                            double dfParam1, double dfParam2 )
+{
+    switch( eTransform )
+    {
+        case TPT_IDENTITY:
+            break;
+        case TPT_ZERO:
+            for( size_t i = 0; i < nCount; ++i ) padfAcc[i] = 0.0;
+            break;
+        case TPT_ABS:
+            for( size_t i = 0; i < nCount; ++i )
+                padfAcc[i] = fabs(padfAcc[i]);
+            break;
+        case TPT_PHASE:
+            for( size_t i = 0; i < nCount; ++i )
+                padfAcc[i] = (padfAcc[i] < 0) ? M_PI : 0.0;
+            break;
+        case TPT_INV:
+            for( size_t i = 0; i < nCount; ++i )
+                padfAcc[i] = 1.0 / padfAcc[i];
+            break;
+        case TPT_SQUARE:
+            for( size_t i = 0; i < nCount; ++i )
+                padfAcc[i] *= padfAcc[i];
+            break;
+        case TPT_SQRT:
+            for( size_t i = 0; i < nCount; ++i )
+                padfAcc[i] = sqrt(padfAcc[i]);
+            break;
+        case TPT_LOG10:
+            for( size_t i = 0; i < nCount; ++i )
+                padfAcc[i] = dfParam1 * log10(fabs(padfAcc[i]));
+            break;
+        case TPT_POW:
+            for( size_t i = 0; i < nCount; ++i )
+                padfAcc[i] = pow(dfParam1, padfAcc[i] / dfParam2);
+            break;
+    }
+}
+
+/************************************************************************/
+/*                       TypedPixelFuncHelper()                         */
+/*                                                                      */
+/*      nExpectedSources < 0 means "at least -nExpectedSources".        */
+/************************************************************************/
+
+static int TypedPixelFuncHelper( const void * const *papSources,
+                                 int nSources, GDALDataType eSrcType,
+                                 void *pDst, GDALDataType eDstType,
+                                 size_t nValues,
+                                 int nExpectedSources,
+                                 TypedPixelOp eOp,
+                                 TypedPixelTransform eTransform,
+                                 double dfParam1 = 0.0,
+                                 double dfParam2 = 0.0 )
+{
+    /* ---- Init ---- */
+    if( nExpectedSources >= 0 ? nSources != nExpectedSources
+                              : nSources < -nExpectedSources )
+        return FALSE;
+    if( eDstType != GDT_Float32 && eDstType != GDT_Float64 )
+        return FALSE;
+    if( GDALDataTypeIsComplex( eSrcType ) )
+        return FALSE;
+
+    double adfAcc[TYPED_CHUNK_SIZE];
+
+    /* ---- Set pixels ---- */
+    for( size_t nOffset = 0; nOffset < nValues; nOffset += TYPED_CHUNK_SIZE )
+    {
+        const size_t nCount = std::min(TYPED_CHUNK_SIZE, nValues - nOffset);
+
+        if( !CombineChunk( eSrcType, papSources[0], nOffset, nCount,
+                           adfAcc, TPO_SET ) )
+            return FALSE;
+        for( int iSrc = 1; iSrc < nSources; ++iSrc )
+        {
+            CombineChunk( eSrcType, papSources[iSrc], nOffset, nCount,
+                          adfAcc, eOp );
+        }
+
+        TransformChunk( adfAcc, nCount, eTransform, dfParam1, dfParam2 );
+
+        if( eDstType == GDT_Float32 )
+        {
+            float* pafDst = static_cast<float*>(pDst) + nOffset;
+            for( size_t i = 0; i < nCount; ++i )
+                pafDst[i] = static_cast<float>(adfAcc[i]);
+        }
+        else
+        {
+            memcpy( static_cast<double*>(pDst) + nOffset, adfAcc,
+                    nCount * sizeof(double) );
+        }
+    }
+
+    /* ---- Return success ---- */
+    return TRUE;
+}  // TypedPixelFuncHelper
+
+static int RealPixelFuncTyped( const void * const *papSources, int nSources,
+                               GDALDataType eSrcType,
+                               void *pDst, GDALDataType eDstType,
+                               size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 1, TPO_SET, TPT_IDENTITY );
+}  // RealPixelFuncTyped
+
+static int ImagPixelFuncTyped( const void * const *papSources, int nSources,
+                               GDALDataType eSrcType,
+                               void *pDst, GDALDataType eDstType,
+                               size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 1, TPO_SET, TPT_ZERO );
+}  // ImagPixelFuncTyped
+
+static int ModulePixelFuncTyped( const void * const *papSources, int nSources,
+                                 GDALDataType eSrcType,
+                                 void *pDst, GDALDataType eDstType,
+                                 size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 1, TPO_SET, TPT_ABS );
+}  // ModulePixelFuncTyped
+
+static int PhasePixelFuncTyped( const void * const *papSources, int nSources,
+                                GDALDataType eSrcType,
+                                void *pDst, GDALDataType eDstType,
+                                size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 1, TPO_SET, TPT_PHASE );
+}  // PhasePixelFuncTyped
+
+static int SumPixelFuncTyped( const void * const *papSources, int nSources,
+                              GDALDataType eSrcType,
+                              void *pDst, GDALDataType eDstType,
+                              size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 -2, TPO_ADD, TPT_IDENTITY );
+}  // SumPixelFuncTyped
+
+static int DiffPixelFuncTyped( const void * const *papSources, int nSources,
+                               GDALDataType eSrcType,
+                               void *pDst, GDALDataType eDstType,
+                               size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 2, TPO_SUB, TPT_IDENTITY );
+}  // DiffPixelFuncTyped
+
+static int MulPixelFuncTyped( const void * const *papSources, int nSources,
+                              GDALDataType eSrcType,
+                              void *pDst, GDALDataType eDstType,
+                              size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 -2, TPO_MUL, TPT_IDENTITY );
+}  // MulPixelFuncTyped
+
+static int CMulPixelFuncTyped( const void * const *papSources, int nSources,
+                               GDALDataType eSrcType,
+                               void *pDst, GDALDataType eDstType,
+                               size_t nValues )
+{
+    // For real sources and a real output, this is a plain product.
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 2, TPO_MUL, TPT_IDENTITY );
+}  // CMulPixelFuncTyped
+
+static int InvPixelFuncTyped( const void * const *papSources, int nSources,
+                              GDALDataType eSrcType,
+                              void *pDst, GDALDataType eDstType,
+                              size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 1, TPO_SET, TPT_INV );
+}  // InvPixelFuncTyped
+
+static int IntensityPixelFuncTyped( const void * const *papSources,
+                                    int nSources, GDALDataType eSrcType,
+                                    void *pDst, GDALDataType eDstType,
+                                    size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 1, TPO_SET, TPT_SQUARE );
+}  // IntensityPixelFuncTyped
+
+static int SqrtPixelFuncTyped( const void * const *papSources, int nSources,
+                               GDALDataType eSrcType,
+                               void *pDst, GDALDataType eDstType,
+                               size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 1, TPO_SET, TPT_SQRT );
+}  // SqrtPixelFuncTyped
+
+static int Log10PixelFuncTyped( const void * const *papSources, int nSources,
+                                GDALDataType eSrcType,
+                                void *pDst, GDALDataType eDstType,
+                                size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 1, TPO_SET, TPT_LOG10, 1.0 );
+}  // Log10PixelFuncTyped
+
+static int DBPixelFuncTyped( const void * const *papSources, int nSources,
+                             GDALDataType eSrcType,
+                             void *pDst, GDALDataType eDstType,
+                             size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 1, TPO_SET, TPT_LOG10, 20.0 );
+}  // DBPixelFuncTyped
+
+static int dB2AmpPixelFuncTyped( const void * const *papSources, int nSources,
+                                 GDALDataType eSrcType,
+                                 void *pDst, GDALDataType eDstType,
+                                 size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 1, TPO_SET, TPT_POW, 10.0, 20.0 );
+}  // dB2AmpPixelFuncTyped
+
+static int dB2PowPixelFuncTyped( const void * const *papSources, int nSources,
+                                 GDALDataType eSrcType,
+                                 void *pDst, GDALDataType eDstType,
+                                 size_t nValues )
+{
+    return TypedPixelFuncHelper( papSources, nSources, eSrcType,
+                                 pDst, eDstType, nValues,
+                                 1, TPO_SET, TPT_POW, 10.0, 10.0 );
+}  // dB2PowPixelFuncTyped
+
 /************************************************************************/
 /*                     GDALRegisterDefaultPixelFunc()                   */
 /************************************************************************/
@@ -911,7 +1336,12 @@ static CPLErr dB2PowPixelFunc( void **papoSources, int nSources, void *pData,
  *             (power) (i.e. 10 ^ ( x / 10 ) ) of a single raster
  *             band (real only)
  *
+ * Starting with GDAL 2.3, all those functions but "complex" are also
+ * registered with GDALAddDerivedBandPixelFuncTyped(), to process real
+ * sources into a Float32 or Float64 buffer without per-pixel conversions.
+ *
  * @see GDALAddDerivedBandPixelFunc
+ * @see GDALAddDerivedBandPixelFuncTyped
  *
  * @return CE_None
  */
@@ -935,5 +1365,22 @@ CPLErr GDALRegisterDefaultPixelFunc()
     GDALAddDerivedBandPixelFunc("dB2amp", dB2AmpPixelFunc);
     GDALAddDerivedBandPixelFunc("dB2pow", dB2PowPixelFunc);
 
+    GDALAddDerivedBandPixelFuncTyped("real", RealPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("imag", ImagPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("mod", ModulePixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("phase", PhasePixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("conj", RealPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("sum", SumPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("diff", DiffPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("mul", MulPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("cmul", CMulPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("inv", InvPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("intensity", IntensityPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("sqrt", SqrtPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("log10", Log10PixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("dB", DBPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("dB2amp", dB2AmpPixelFuncTyped);
+    GDALAddDerivedBandPixelFuncTyped("dB2pow", dB2PowPixelFuncTyped);
+
     return CE_None;
 }
@@ -31,6 +31,7 @@
 
 #include "cpl_minixml.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal_frmts.h"
 #include "ogr_spatialref.h"
 
@@ -56,7 +57,9 @@ VRTDataset::VRTDataset( int nXSize, int nYSize ) :
     m_pszVRTPath(NULL),
     m_poMaskBand(NULL),
     m_bCompatibleForDatasetIO(-1),
-    m_papszXMLVRTMetadata(NULL)
+    m_papszXMLVRTMetadata(NULL),
+    m_nNumThreads(-1),
+    m_poThreadPool(NULL)
 {
     nRasterXSize = nXSize;
     nRasterYSize = nYSize;
@@ -116,6 +119,47 @@ VRTDataset::~VRTDataset()
     for(size_t i=0;i<m_apoOverviewsBak.size();i++)
         delete m_apoOverviewsBak[i];
     CSLDestroy( m_papszXMLVRTMetadata );
+    delete m_poThreadPool;
+}
+
+/************************************************************************/
+/*                           GetThreadPool()                            */
+/*                                                                      */
+/*      Return the pool of threads used to read sources concurrently,   */
+/*      or NULL if NUM_THREADS / VRT_NUM_THREADS is not set.            */
+/************************************************************************/
+
+CPLWorkerThreadPool *VRTDataset::GetThreadPool()
+{
+    if( m_nNumThreads >= 0 )
+        return m_poThreadPool;
+
+    const char* pszNumThreads =
+        CSLFetchNameValue( papszOpenOptions, "NUM_THREADS" );
+    if( pszNumThreads == NULL )
+        pszNumThreads = CPLGetConfigOption( "VRT_NUM_THREADS", NULL );
+
+    m_nNumThreads = 1;
+    if( pszNumThreads != NULL )
+    {
+        if( EQUAL(pszNumThreads, "ALL_CPUS") )
+            m_nNumThreads = CPLGetNumCPUs();
+        else
+            m_nNumThreads = atoi(pszNumThreads);
+        m_nNumThreads = std::max(1, std::min(128, m_nNumThreads));
+    }
+
+    if( m_nNumThreads > 1 )
+    {
+        m_poThreadPool = new CPLWorkerThreadPool();
+        if( !m_poThreadPool->Setup( m_nNumThreads, NULL, NULL ) )
+        {
+            delete m_poThreadPool;
+            m_poThreadPool = NULL;
+        }
+    }
+
+    return m_poThreadPool;
 }
 
 /************************************************************************/
@@ -1540,44 +1584,19 @@ CPLErr VRTDataset::IRasterIO( GDALRWFlag eRWFlag,
             poBand->nSources = nSavedSources;
         }
 
-        CPLErr eErr = CE_None;
-        GDALProgressFunc  pfnProgressGlobal = psExtraArg->pfnProgress;
-        void *pProgressDataGlobal = psExtraArg->pProgressData;
-
         // Use the last band, because when sources reference a GDALProxyDataset,
         // they don't necessary instantiate all underlying rasterbands.
         VRTSourcedRasterBand* poBand = reinterpret_cast<VRTSourcedRasterBand *>(
             papoBands[nBands - 1] );
-        for( int iSource = 0;
-             eErr == CE_None && iSource < poBand->nSources;
-             iSource++ )
-        {
-            psExtraArg->pfnProgress = GDALScaledProgress;
-            psExtraArg->pProgressData =
-                GDALCreateScaledProgress(
-                    1.0 * iSource / poBand->nSources,
-                    1.0 * (iSource + 1) / poBand->nSources,
-                    pfnProgressGlobal,
-                    pProgressDataGlobal );
-
-            VRTSimpleSource* poSource = reinterpret_cast<VRTSimpleSource *>(
-                poBand->papoSources[iSource] );
-
-            eErr = poSource->DatasetRasterIO( nXOff, nYOff, nXSize, nYSize,
-                                              pData, nBufXSize, nBufYSize,
-                                              eBufType,
-                                              nBandCount, panBandMap,
-                                              nPixelSpace, nLineSpace,
-                                              nBandSpace,
-                                              psExtraArg );
-
-            GDALDestroyScaledProgress( psExtraArg->pProgressData );
-        }
-
-        psExtraArg->pfnProgress = pfnProgressGlobal;
-        psExtraArg->pProgressData = pProgressDataGlobal;
-
-        return eErr;
+        std::vector<int> anSources;
+        poBand->GetSourcesIntersecting( nXOff, nYOff, nXSize, nYSize,
+                                        anSources );
+        return poBand->ReadSources( anSources,
+                                    nXOff, nYOff, nXSize, nYSize,
+                                    pData, nBufXSize, nBufYSize, eBufType,
+                                    nBandCount, panBandMap,
+                                    nPixelSpace, nLineSpace, nBandSpace,
+                                    psExtraArg );
     }
 
     return GDALDataset::IRasterIO( eRWFlag, nXOff, nYOff, nXSize, nYSize,
@@ -34,6 +34,7 @@
 #ifndef DOXYGEN_SKIP
 
 #include "cpl_hash_set.h"
+#include "cpl_quad_tree.h"
 #include "gdal_pam.h"
 #include "gdal_priv.h"
 #include "gdal_vrt.h"
@@ -53,6 +54,8 @@ int VRTWarpedOverviewTransform( void *pTransformArg, int bDstToSrc,
 void* VRTDeserializeWarpedOverviewTransformer( CPLXMLNode *psTree );
 #endif
 
+class CPLWorkerThreadPool;
+
 /************************************************************************/
 /*                          VRTOverviewInfo()                           */
 /************************************************************************/
@@ -153,6 +156,9 @@ class CPL_DLL VRTDataset : public GDALDataset
     std::vector<GDALDataset*> m_apoOverviewsBak;
     char         **m_papszXMLVRTMetadata;
 
+    int            m_nNumThreads;
+    CPLWorkerThreadPool *m_poThreadPool;
+
   protected:
     virtual int         CloseDependentDatasets() CPL_OVERRIDE;
 
@@ -165,6 +171,8 @@ class CPL_DLL VRTDataset : public GDALDataset
 
     void SetWritable(int bWritableIn) { m_bWritable = bWritableIn; }
 
+    CPLWorkerThreadPool *GetThreadPool();
+
     virtual CPLErr          CreateMaskBand( int nFlags ) CPL_OVERRIDE;
     void SetMaskBand(VRTRasterBand* poMaskBand);
 
@@ -465,8 +473,16 @@ class CPL_DLL VRTSourcedRasterBand : public VRTRasterBand
     CPLString      m_osLastLocationInfo;
     char         **m_papszSourceList;
 
+    // Spatial index of the destination windows of the simple sources,
+    // lazily built for bands with many sources.
+    CPLQuadTree   *m_hSourceIndex;
+    int            m_nIndexedSources;
+    std::vector<int> m_anUnindexedSources;
+
     bool           CanUseSourcesMinMaxImplementations();
     void           CheckSource( VRTSimpleSource *poSS );
+    void           BuildSourceIndex();
+    void           InvalidateSourceIndex();
 
   public:
     int            nSources;
@@ -519,6 +535,17 @@ class CPL_DLL VRTSourcedRasterBand : public VRTRasterBand
                                   void *pProgressData ) CPL_OVERRIDE;
 
     CPLErr         AddSource( VRTSource * );
+    void           GetSourcesIntersecting( int nXOff, int nYOff,
+                                           int nXSize, int nYSize,
+                                           std::vector<int>& anSources );
+    CPLErr         ReadSources( const std::vector<int>& anSources,
+                                int nXOff, int nYOff, int nXSize, int nYSize,
+                                void *pData, int nBufXSize, int nBufYSize,
+                                GDALDataType eBufType,
+                                int nBandCount, int *panBandMap,
+                                GSpacing nPixelSpace, GSpacing nLineSpace,
+                                GSpacing nBandSpace,
+                                GDALRasterIOExtraArg* psExtraArg );
     CPLErr         AddSimpleSource( GDALRasterBand *poSrcBand,
                                     double dfSrcXOff=-1, double dfSrcYOff=-1,
                                     double dfSrcXSize=-1, double dfSrcYSize=-1,
@@ -654,7 +681,11 @@ class CPL_DLL VRTDerivedRasterBand : public VRTSourcedRasterBand
 
     static CPLErr AddPixelFunction( const char *pszFuncName,
                                     GDALDerivedPixelFunc pfnPixelFunc );
+    static CPLErr AddPixelFunction( const char *pszFuncName,
+                                    GDALDerivedPixelFuncTyped pfnPixelFunc );
     static GDALDerivedPixelFunc GetPixelFunction( const char *pszFuncName );
+    static GDALDerivedPixelFuncTyped
+                         GetPixelFunctionTyped( const char *pszFuncName );
 
     void SetPixelFunctionName( const char *pszFuncName );
     void SetSourceTransferType( GDALDataType eDataType );
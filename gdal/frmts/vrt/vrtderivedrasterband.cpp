@@ -31,6 +31,7 @@
 #include "cpl_minixml.h"
 #include "cpl_string.h"
 #include "vrtdataset.h"
+#include "vrtexpression.h"
 #include "cpl_multiproc.h"
 #include "cpl_spawn.h"
 
@@ -60,6 +61,7 @@ CPL_CVSID("$Id$");
 #endif
 
 static std::map<CPLString, GDALDerivedPixelFunc> osMapPixelFunction;
+static std::map<CPLString, GDALDerivedPixelFuncTyped> osMapPixelFunctionTyped;
 static bool gbHasInitializedPython = false;
 static int gnPythonInstanceCounter = 0;
 static CPLMutex* ghMutex = NULL;
@@ -854,6 +856,8 @@ class VRTDerivedRasterBandPrivateData
         bool      m_bExclusiveLock;
         bool      m_bFirstTime;
         std::vector< std::pair<CPLString,CPLString> > m_oFunctionArgs;
+        VRTExpression* m_poExpression;
+        bool      m_bPropagateNoData;
 
         VRTDerivedRasterBandPrivateData():
             m_osLanguage("C"),
@@ -863,12 +867,15 @@ class VRTDerivedRasterBandPrivateData
             m_bPythonInitializationDone(false),
             m_bPythonInitializationSuccess(false),
             m_bExclusiveLock(false),
-            m_bFirstTime(true)
+            m_bFirstTime(true),
+            m_poExpression(NULL),
+            m_bPropagateNoData(false)
         {
         }
 
         virtual ~VRTDerivedRasterBandPrivateData()
         {
+            delete m_poExpression;
             if( m_poGDALCreateNumpyArray )
                 Py_DecRef(m_poGDALCreateNumpyArray);
             if( m_poUserFunction )
@@ -1027,6 +1034,46 @@ GDALAddDerivedBandPixelFunc( const char *pszFuncName,
     return CE_None;
 }
 
+/**
+ * This adds a typed pixel function to the global list of available pixel
+ * functions for derived bands.
+ *
+ * Contrary to GDALDerivedPixelFunc, a GDALDerivedPixelFuncTyped receives
+ * packed source buffers and writes into a packed output buffer, both with
+ * an explicit data type, so that it can use a loop specialized for those
+ * data types instead of converting each pixel.  The output type is the
+ * requested buffer type when it is Float32, Float64, CFloat32 or CFloat64,
+ * and Float64 (or CFloat64 for a complex buffer type) otherwise, the result
+ * being then converted into the requested buffer.
+ *
+ * When a derived band is read, the typed function registered under its
+ * pixel function name is tried first.  If it declines (returns FALSE), the
+ * GDALDerivedPixelFunc registered with GDALAddDerivedBandPixelFunc() under
+ * the same name is used.
+ *
+ * @param pszFuncName Name used to access pixel function
+ * @param pfnNewFunction Typed pixel function associated with name.  An
+ *  existing typed pixel function registered with the same name will be
+ *  replaced with the new one.
+ *
+ * @return CE_None, invalid (NULL) parameters are currently ignored.
+ * @since GDAL 2.3
+ */
+CPLErr CPL_STDCALL
+GDALAddDerivedBandPixelFuncTyped( const char *pszFuncName,
+                                  GDALDerivedPixelFuncTyped pfnNewFunction )
+{
+    if( pszFuncName == NULL || pszFuncName[0] == '\0' ||
+        pfnNewFunction == NULL )
+    {
+      return CE_None;
+    }
+
+    osMapPixelFunctionTyped[pszFuncName] = pfnNewFunction;
+
+    return CE_None;
+}
+
 /*! @cond Doxygen_Suppress */
 
 /**
@@ -1049,6 +1096,25 @@ VRTDerivedRasterBand::AddPixelFunction(
     return GDALAddDerivedBandPixelFunc(pszFuncName, pfnNewFunction);
 }
 
+/**
+ * This adds a typed pixel function to the global list of available pixel
+ * functions for derived bands.
+ *
+ * This is the same as the c function GDALAddDerivedBandPixelFuncTyped()
+ *
+ * @param pszFuncName Name used to access pixel function
+ * @param pfnNewFunction Typed pixel function associated with name.
+ *
+ * @return CE_None, invalid (NULL) parameters are currently ignored.
+ * @since GDAL 2.3
+ */
+CPLErr
+VRTDerivedRasterBand::AddPixelFunction(
+    const char *pszFuncName, GDALDerivedPixelFuncTyped pfnNewFunction )
+{
+    return GDALAddDerivedBandPixelFuncTyped(pszFuncName, pfnNewFunction);
+}
+
 /************************************************************************/
 /*                           GetPixelFunction()                         */
 /************************************************************************/
@@ -1079,6 +1145,37 @@ VRTDerivedRasterBand::GetPixelFunction( const char *pszFuncName )
     return oIter->second;
 }
 
+/************************************************************************/
+/*                        GetPixelFunctionTyped()                       */
+/************************************************************************/
+
+/**
+ * Get a typed pixel function previously registered using the global
+ * AddPixelFunction.
+ *
+ * @param pszFuncName The name associated with the pixel function.
+ *
+ * @return A derived band typed pixel function, or NULL if none have been
+ * registered for pszFuncName.
+ * @since GDAL 2.3
+ */
+GDALDerivedPixelFuncTyped
+VRTDerivedRasterBand::GetPixelFunctionTyped( const char *pszFuncName )
+{
+    if( pszFuncName == NULL || pszFuncName[0] == '\0' )
+    {
+        return NULL;
+    }
+
+    std::map<CPLString, GDALDerivedPixelFuncTyped>::iterator oIter =
+        osMapPixelFunctionTyped.find(pszFuncName);
+
+    if( oIter == osMapPixelFunctionTyped.end())
+        return NULL;
+
+    return oIter->second;
+}
+
 /************************************************************************/
 /*                         SetPixelFunctionName()                       */
 /************************************************************************/
@@ -1459,6 +1556,65 @@ bool VRTDerivedRasterBand::InitializePython()
     return true;
 }
 
+/************************************************************************/
+/*                        ApplyTypedPixelFunc()                         */
+/*                                                                      */
+/*      Run a GDALDerivedPixelFuncTyped on the packed source buffers.   */
+/*      Returns false if the function declined this combination of     */
+/*      data types, in which case nothing has been written.             */
+/************************************************************************/
+
+static bool ApplyTypedPixelFunc( GDALDerivedPixelFuncTyped pfnPixelFunc,
+                                 void **pBuffers, int nSources,
+                                 GDALDataType eSrcType,
+                                 void *pData, int nBufXSize, int nBufYSize,
+                                 GDALDataType eBufType,
+                                 GSpacing nPixelSpace, GSpacing nLineSpace,
+                                 CPLErr *peErr )
+{
+    GDALDataType eDstType = eBufType;
+    if( eBufType != GDT_Float32 && eBufType != GDT_Float64 &&
+        eBufType != GDT_CFloat32 && eBufType != GDT_CFloat64 )
+    {
+        eDstType = GDALDataTypeIsComplex(eBufType) ? GDT_CFloat64
+                                                   : GDT_Float64;
+    }
+    const int nDstTypeSize = GDALGetDataTypeSizeBytes(eDstType);
+    const size_t nValues = static_cast<size_t>(nBufXSize) * nBufYSize;
+
+    // Write directly into the user buffer if it is packed.
+    if( eDstType == eBufType && nPixelSpace == nDstTypeSize &&
+        nLineSpace == nPixelSpace * nBufXSize )
+    {
+        return pfnPixelFunc( pBuffers, nSources, eSrcType,
+                             pData, eDstType, nValues ) != FALSE;
+    }
+
+    GByte* pabyTmp = static_cast<GByte*>(
+        VSI_MALLOC2_VERBOSE(nDstTypeSize, nValues) );
+    if( pabyTmp == NULL )
+    {
+        *peErr = CE_Failure;
+        return true;
+    }
+    if( !pfnPixelFunc( pBuffers, nSources, eSrcType,
+                       pabyTmp, eDstType, nValues ) )
+    {
+        VSIFree(pabyTmp);
+        return false;
+    }
+    for( int iLine = 0; iLine < nBufYSize; iLine++ )
+    {
+        GDALCopyWords( pabyTmp + static_cast<size_t>(iLine) *
+                                            nBufXSize * nDstTypeSize,
+                       eDstType, nDstTypeSize,
+                       static_cast<GByte*>(pData) + nLineSpace * iLine,
+                       eBufType, static_cast<int>(nPixelSpace), nBufXSize );
+    }
+    VSIFree(pabyTmp);
+    return true;
+}
+
 /************************************************************************/
 /*                             IRasterIO()                              */
 /************************************************************************/
@@ -1534,7 +1690,9 @@ CPLErr VRTDerivedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
     const int nBufTypeSize = GDALGetDataTypeSizeBytes(eBufType);
     GDALDataType eSrcType = eSourceTransferType;
     if( eSrcType == GDT_Unknown || eSrcType >= GDT_TypeCount ) {
-        eSrcType = eBufType;
+        // Expressions are evaluated in double precision.
+        eSrcType = EQUAL(m_poPrivate->m_osLanguage, "Expression") ?
+                                                    GDT_Float64 : eBufType;
     }
     const int nSrcTypeSize = GDALGetDataTypeSizeBytes(eSrcType);
 
@@ -1582,11 +1740,14 @@ CPLErr VRTDerivedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
 
     /* ---- Get pixel function for band ---- */
     GDALDerivedPixelFunc pfnPixelFunc = NULL;
+    GDALDerivedPixelFuncTyped pfnPixelFuncTyped = NULL;
 
     if( EQUAL(m_poPrivate->m_osLanguage, "C") )
     {
         pfnPixelFunc = VRTDerivedRasterBand::GetPixelFunction(pszFuncName);
-        if( pfnPixelFunc == NULL )
+        pfnPixelFuncTyped =
+            VRTDerivedRasterBand::GetPixelFunctionTyped(pszFuncName);
+        if( pfnPixelFunc == NULL && pfnPixelFuncTyped == NULL )
         {
             CPLError( CE_Failure, CPLE_IllegalArg,
                     "VRTDerivedRasterBand::IRasterIO:"
@@ -1922,12 +2083,40 @@ CPLErr VRTDerivedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
             VSIFree(pabyTmpBuffer);
         }
     }
+    else if( eErr == CE_None && m_poPrivate->m_poExpression != NULL )
+    {
+        eErr = m_poPrivate->m_poExpression->Evaluate(
+                             pBuffers, nSources, eSrcType,
+                             pData, nBufXSize, nBufYSize, eBufType,
+                             nPixelSpace, nLineSpace,
+                             CPL_TO_BOOL(m_bNoDataValueSet), m_dfNoDataValue,
+                             m_poPrivate->m_bPropagateNoData );
+    }
+    else if( eErr == CE_None && pfnPixelFuncTyped != NULL &&
+             nBufferRadius == 0 &&
+             ApplyTypedPixelFunc( pfnPixelFuncTyped, pBuffers, nSources,
+                                  eSrcType, pData, nBufXSize, nBufYSize,
+                                  eBufType, nPixelSpace, nLineSpace, &eErr ) )
+    {
+        // Done.
+    }
     else if( eErr == CE_None && pfnPixelFunc != NULL ) {
         eErr = pfnPixelFunc( reinterpret_cast<void **>( pBuffers ), nSources,
                              pData, nBufXSize, nBufYSize,
                              eSrcType, eBufType, static_cast<int>(nPixelSpace),
                              static_cast<int>(nLineSpace) );
     }
+    else if( eErr == CE_None && pfnPixelFunc == NULL &&
+             pfnPixelFuncTyped != NULL )
+    {
+        CPLError( CE_Failure, CPLE_NotSupported,
+                  "VRTDerivedRasterBand::IRasterIO: "
+                  "Derived band pixel function '%s' does not support "
+                  "source type %s and buffer type %s.",
+                  pszFuncName, GDALGetDataTypeName(eSrcType),
+                  GDALGetDataTypeName(eBufType) );
+        eErr = CE_Failure;
+    }
 end:
     // Release buffers.
     for ( int iSource = 0; iSource < nSources; iSource++ ) {
@@ -1966,35 +2155,64 @@ CPLErr VRTDerivedRasterBand::XMLInit( CPLXMLNode *psTree,
     if( eErr != CE_None )
         return eErr;
 
-    // Read derived pixel function type.
-    SetPixelFunctionName( CPLGetXMLValue( psTree, "PixelFunctionType", NULL ) );
-    if( pszFuncName == NULL || EQUAL(pszFuncName, "") )
-    {
-        CPLError(CE_Failure, CPLE_AppDefined,
-                 "PixelFunctionType missing");
-        return CE_Failure;
-    }
-
     m_poPrivate->m_osLanguage = CPLGetXMLValue( psTree,
                                                 "PixelFunctionLanguage", "C" );
     if( !EQUAL(m_poPrivate->m_osLanguage, "C") &&
-        !EQUAL(m_poPrivate->m_osLanguage, "Python") )
+        !EQUAL(m_poPrivate->m_osLanguage, "Python") &&
+        !EQUAL(m_poPrivate->m_osLanguage, "Expression") )
     {
         CPLError(CE_Failure, CPLE_NotSupported,
                  "Unsupported PixelFunctionLanguage");
         return CE_Failure;
     }
+    const bool bIsExpression =
+        EQUAL(m_poPrivate->m_osLanguage, "Expression");
+
+    // Read derived pixel function type.
+    SetPixelFunctionName( CPLGetXMLValue( psTree, "PixelFunctionType", NULL ) );
+    if( (pszFuncName == NULL || EQUAL(pszFuncName, "")) && !bIsExpression )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "PixelFunctionType missing");
+        return CE_Failure;
+    }
 
     m_poPrivate->m_osCode =
                         CPLGetXMLValue( psTree, "PixelFunctionCode", "" );
     if( !m_poPrivate->m_osCode.empty() &&
-        !EQUAL(m_poPrivate->m_osLanguage, "Python") )
+        !EQUAL(m_poPrivate->m_osLanguage, "Python") && !bIsExpression )
     {
         CPLError(CE_Failure, CPLE_NotSupported,
-                 "PixelFunctionCode can only be used with Python");
+                 "PixelFunctionCode can only be used with Python "
+                 "or Expression");
         return CE_Failure;
     }
 
+    // The expression is compiled once, when the VRT is opened.
+    if( bIsExpression )
+    {
+        if( m_poPrivate->m_osCode.empty() )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "PixelFunctionCode missing");
+            return CE_Failure;
+        }
+        delete m_poPrivate->m_poExpression;
+        m_poPrivate->m_poExpression = new VRTExpression();
+        if( !m_poPrivate->m_poExpression->Compile(m_poPrivate->m_osCode) )
+            return CE_Failure;
+        if( m_poPrivate->m_poExpression->GetMaxSourceIndex() > nSources )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Expression '%s' references B%d, but there are only "
+                     "%d sources",
+                     m_poPrivate->m_osCode.c_str(),
+                     m_poPrivate->m_poExpression->GetMaxSourceIndex(),
+                     nSources);
+            return CE_Failure;
+        }
+    }
+
     m_poPrivate->m_nBufferRadius =
                         atoi(CPLGetXMLValue( psTree, "BufferRadius", "0" ));
     if( m_poPrivate->m_nBufferRadius < 0 )
@@ -2013,10 +2231,11 @@ CPLErr VRTDerivedRasterBand::XMLInit( CPLXMLNode *psTree,
     CPLXMLNode* psArgs = CPLGetXMLNode( psTree, "PixelFunctionArguments" );
     if( psArgs != NULL )
     {
-        if( !EQUAL(m_poPrivate->m_osLanguage, "Python") )
+        if( !EQUAL(m_poPrivate->m_osLanguage, "Python") && !bIsExpression )
         {
             CPLError(CE_Failure, CPLE_NotSupported,
-                     "PixelFunctionArguments can only be used with Python");
+                     "PixelFunctionArguments can only be used with Python "
+                     "or Expression");
             return CE_Failure;
         }
         for( CPLXMLNode* psIter = psArgs->psChild;
@@ -2028,6 +2247,19 @@ CPLErr VRTDerivedRasterBand::XMLInit( CPLXMLNode *psTree,
                 m_poPrivate->m_oFunctionArgs.push_back(
                     std::pair<CPLString,CPLString>(psIter->pszValue,
                                                    psIter->psChild->pszValue));
+                if( !bIsExpression )
+                    continue;
+                if( EQUAL(psIter->pszValue, "propagateNoData") )
+                {
+                    m_poPrivate->m_bPropagateNoData =
+                        CPLTestBool(psIter->psChild->pszValue);
+                }
+                else
+                {
+                    CPLError(CE_Warning, CPLE_NotSupported,
+                             "Unknown argument %s for an expression",
+                             psIter->pszValue);
+                }
             }
         }
     }
@@ -397,6 +397,9 @@ void GDALRegister_VRT()
 "  <on name='ROOT_PATH' type='string' description='Root path to evaluate "
 "relative paths inside the VRT. Mainly useful for inlined VRT, or in-memory "
 "VRT, where their own directory does not make sense'/>"
+"  <Option name='NUM_THREADS' type='string' description="
+"'Number of worker threads to read sources concurrently. Integer or ALL_CPUS. "
+"Defaults to the VRT_NUM_THREADS configuration option'/>"
 "</OptionList>" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
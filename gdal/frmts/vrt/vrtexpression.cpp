@@ -0,0 +1,711 @@
+/******************************************************************************
+ *
+ * Project:  Virtual GDAL Datasets
+ * Purpose:  Band math expressions for VRTDerivedRasterBand.
+ *
+ ******************************************************************************
+ * Copyright (c) 2017, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "vrtexpression.h"
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+CPL_CVSID("$Id$");
+
+/*! @cond Doxygen_Suppress */
+
+// Number of pixels evaluated at once by each instruction.
+static const int EXPR_CHUNK_SIZE = 256;
+
+// Maximum recursion depth of the parser through nested parentheses, function
+// calls and operators, so that hostile expressions cannot overflow the stack.
+static const int EXPR_MAX_NESTING = 256;
+
+typedef enum
+{
+    // Leaves
+    EOP_CONST,
+    EOP_SOURCE,
+    // Unary
+    EOP_NEG,
+    EOP_NOT,
+    EOP_ABS,
+    EOP_SQRT,
+    EOP_LOG,
+    EOP_LOG10,
+    EOP_EXP,
+    EOP_FLOOR,
+    EOP_CEIL,
+    EOP_ROUND,
+    EOP_ISNODATA,
+    // Binary
+    EOP_ADD,
+    EOP_SUB,
+    EOP_MUL,
+    EOP_DIV,
+    EOP_MOD,
+    EOP_POW,
+    EOP_EQ,
+    EOP_NE,
+    EOP_LT,
+    EOP_LE,
+    EOP_GT,
+    EOP_GE,
+    EOP_AND,
+    EOP_OR,
+    EOP_MIN,
+    EOP_MAX,
+    // Ternary
+    EOP_SELECT
+} VRTExpressionOp;
+
+typedef struct
+{
+    const char*     pszName;
+    VRTExpressionOp eOp;
+    int             nMinArgs;
+    int             nMaxArgs;
+} VRTExpressionFunc;
+
+static const VRTExpressionFunc asFunctions[] =
+{
+    { "abs", EOP_ABS, 1, 1 },
+    { "sqrt", EOP_SQRT, 1, 1 },
+    { "log", EOP_LOG, 1, 1 },
+    { "log10", EOP_LOG10, 1, 1 },
+    { "exp", EOP_EXP, 1, 1 },
+    { "floor", EOP_FLOOR, 1, 1 },
+    { "ceil", EOP_CEIL, 1, 1 },
+    { "round", EOP_ROUND, 1, 1 },
+    { "isnodata", EOP_ISNODATA, 1, 1 },
+    { "pow", EOP_POW, 2, 2 },
+    { "min", EOP_MIN, 2, 1000 },
+    { "max", EOP_MAX, 2, 1000 },
+    { "if", EOP_SELECT, 3, 3 },
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                         VRTExpressionParser                          */
+/* ==================================================================== */
+/************************************************************************/
+
+/*
+ * Recursive descent parser emitting a postfix program. Grammar, from the
+ * lowest to the highest precedence:
+ *
+ *   expr    := or [ '?' expr ':' expr ]
+ *   or      := and { '||' and }
+ *   and     := cmp { '&&' cmp }
+ *   cmp     := add { ( '==' | '!=' | '<' | '<=' | '>' | '>=' ) add }
+ *   add     := mul { ( '+' | '-' ) mul }
+ *   mul     := unary { ( '*' | '/' | '%' ) unary }
+ *   unary   := ( '-' | '+' | '!' ) unary | power
+ *   power   := primary [ '^' unary ]
+ *   primary := number | B<n> | nodata | pi | func '(' expr {',' expr} ')'
+ *            | '(' expr ')'
+ */
+
+namespace {
+
+class VRTExpressionParser
+{
+    const char* m_pszExpr;
+    const char* m_pszCur;
+    std::vector<VRTExpression::Instruction>& m_aoProgram;
+    int         m_nDepth;
+    int         m_nMaxDepth;
+    int         m_nMaxSourceIndex;
+    int         m_nNesting;
+    bool        m_bError;
+
+    void        SkipSpaces();
+    bool        Accept( const char* pszToken );
+    void        Error( const char* pszMsg );
+    void        Emit( int nOp, int nArg = 0, double dfValue = 0.0 );
+    void        EmitOp( int nOp, int nOperands );
+    bool        EnterNesting();
+
+    void        ParseExpr();
+    void        ParseOr();
+    void        ParseAnd();
+    void        ParseCmp();
+    void        ParseAdd();
+    void        ParseMul();
+    void        ParseUnary();
+    void        ParsePower();
+    void        ParsePrimary();
+
+  public:
+    VRTExpressionParser( const char* pszExpr,
+                         std::vector<VRTExpression::Instruction>& aoProgram ) :
+        m_pszExpr(pszExpr),
+        m_pszCur(pszExpr),
+        m_aoProgram(aoProgram),
+        m_nDepth(0),
+        m_nMaxDepth(0),
+        m_nMaxSourceIndex(0),
+        m_nNesting(0),
+        m_bError(false)
+    {}
+
+    bool        Parse();
+    int         GetMaxDepth() const { return m_nMaxDepth; }
+    int         GetMaxSourceIndex() const { return m_nMaxSourceIndex; }
+};
+
+void VRTExpressionParser::SkipSpaces()
+{
+    while( *m_pszCur != '\0' && isspace(static_cast<unsigned char>(*m_pszCur)) )
+        m_pszCur++;
+}
+
+bool VRTExpressionParser::Accept( const char* pszToken )
+{
+    SkipSpaces();
+    const size_t nLen = strlen(pszToken);
+    if( strncmp(m_pszCur, pszToken, nLen) != 0 )
+        return false;
+    // Do not take '<' for the start of '<=', etc.
+    if( nLen == 1 && (pszToken[0] == '<' || pszToken[0] == '>' ||
+                      pszToken[0] == '!' || pszToken[0] == '=') &&
+        m_pszCur[1] == '=' )
+        return false;
+    m_pszCur += nLen;
+    return true;
+}
+
+void VRTExpressionParser::Error( const char* pszMsg )
+{
+    if( m_bError )
+        return;
+    m_bError = true;
+    CPLError( CE_Failure, CPLE_AppDefined,
+              "Invalid expression '%s' at position %d: %s",
+              m_pszExpr, static_cast<int>(m_pszCur - m_pszExpr) + 1, pszMsg );
+}
+
+void VRTExpressionParser::Emit( int nOp, int nArg, double dfValue )
+{
+    VRTExpression::Instruction sInstr;
+    sInstr.nOp = nOp;
+    sInstr.nArg = nArg;
+    sInstr.dfValue = dfValue;
+    m_aoProgram.push_back(sInstr);
+    m_nDepth++;
+    m_nMaxDepth = std::max(m_nMaxDepth, m_nDepth);
+}
+
+// Emit an operator consuming nOperands values and pushing one.
+void VRTExpressionParser::EmitOp( int nOp, int nOperands )
+{
+    VRTExpression::Instruction sInstr;
+    sInstr.nOp = nOp;
+    sInstr.nArg = 0;
+    sInstr.dfValue = 0.0;
+    m_aoProgram.push_back(sInstr);
+    m_nDepth -= nOperands - 1;
+}
+
+bool VRTExpressionParser::EnterNesting()
+{
+    if( m_bError )
+        return false;
+    if( m_nNesting >= EXPR_MAX_NESTING )
+    {
+        Error("expression nested too deeply");
+        return false;
+    }
+    m_nNesting++;
+    return true;
+}
+
+bool VRTExpressionParser::Parse()
+{
+    ParseExpr();
+    SkipSpaces();
+    if( !m_bError && *m_pszCur != '\0' )
+        Error("unexpected character");
+    return !m_bError;
+}
+
+void VRTExpressionParser::ParseExpr()
+{
+    if( !EnterNesting() )
+        return;
+    ParseOr();
+    if( Accept("?") )
+    {
+        ParseExpr();
+        if( !Accept(":") )
+            Error("':' expected");
+        else
+        {
+            ParseExpr();
+            EmitOp(EOP_SELECT, 3);
+        }
+    }
+    m_nNesting--;
+}
+
+void VRTExpressionParser::ParseOr()
+{
+    ParseAnd();
+    while( !m_bError && Accept("||") )
+    {
+        ParseAnd();
+        EmitOp(EOP_OR, 2);
+    }
+}
+
+void VRTExpressionParser::ParseAnd()
+{
+    ParseCmp();
+    while( !m_bError && Accept("&&") )
+    {
+        ParseCmp();
+        EmitOp(EOP_AND, 2);
+    }
+}
+
+void VRTExpressionParser::ParseCmp()
+{
+    ParseAdd();
+    while( !m_bError )
+    {
+        int nOp = 0;
+        if( Accept("==") ) nOp = EOP_EQ;
+        else if( Accept("!=") ) nOp = EOP_NE;
+        else if( Accept("<=") ) nOp = EOP_LE;
+        else if( Accept(">=") ) nOp = EOP_GE;
+        else if( Accept("<") ) nOp = EOP_LT;
+        else if( Accept(">") ) nOp = EOP_GT;
+        else break;
+        ParseAdd();
+        EmitOp(nOp, 2);
+    }
+}
+
+void VRTExpressionParser::ParseAdd()
+{
+    ParseMul();
+    while( !m_bError )
+    {
+        int nOp = 0;
+        if( Accept("+") ) nOp = EOP_ADD;
+        else if( Accept("-") ) nOp = EOP_SUB;
+        else break;
+        ParseMul();
+        EmitOp(nOp, 2);
+    }
+}
+
+void VRTExpressionParser::ParseMul()
+{
+    ParseUnary();
+    while( !m_bError )
+    {
+        int nOp = 0;
+        if( Accept("*") ) nOp = EOP_MUL;
+        else if( Accept("/") ) nOp = EOP_DIV;
+        else if( Accept("%") ) nOp = EOP_MOD;
+        else break;
+        ParseUnary();
+        EmitOp(nOp, 2);
+    }
+}
+
+void VRTExpressionParser::ParseUnary()
+{
+    if( !EnterNesting() )
+        return;
+    if( Accept("-") )
+    {
+        ParseUnary();
+        EmitOp(EOP_NEG, 1);
+    }
+    else if( Accept("+") )
+    {
+        ParseUnary();
+    }
+    else if( Accept("!") )
+    {
+        ParseUnary();
+        EmitOp(EOP_NOT, 1);
+    }
+    else
+    {
+        ParsePower();
+    }
+    m_nNesting--;
+}
+
+void VRTExpressionParser::ParsePower()
+{
+    ParsePrimary();
+    if( !m_bError && Accept("^") )
+    {
+        ParseUnary();
+        EmitOp(EOP_POW, 2);
+    }
+}
+
+void VRTExpressionParser::ParsePrimary()
+{
+    if( m_bError )
+        return;
+    SkipSpaces();
+
+    if( Accept("(") )
+    {
+        ParseExpr();
+        if( !Accept(")") )
+            Error("')' expected");
+        return;
+    }
+
+    if( isdigit(static_cast<unsigned char>(*m_pszCur)) || *m_pszCur == '.' )
+    {
+        char* pszEnd = NULL;
+        const double dfValue = CPLStrtod(m_pszCur, &pszEnd);
+        if( pszEnd == m_pszCur )
+        {
+            Error("invalid number");
+            return;
+        }
+        m_pszCur = pszEnd;
+        Emit(EOP_CONST, 0, dfValue);
+        return;
+    }
+
+    if( !isalpha(static_cast<unsigned char>(*m_pszCur)) && *m_pszCur != '_' )
+    {
+        Error(*m_pszCur == '\0' ? "unexpected end of expression"
+                                : "unexpected character");
+        return;
+    }
+
+    const char* pszStart = m_pszCur;
+    while( isalnum(static_cast<unsigned char>(*m_pszCur)) || *m_pszCur == '_' )
+        m_pszCur++;
+    const CPLString osName(std::string(pszStart, m_pszCur - pszStart));
+
+    // Source reference: B1, B2, ...
+    if( (osName[0] == 'B' || osName[0] == 'b') && osName.size() > 1 &&
+        osName.find_first_not_of("0123456789", 1) == std::string::npos )
+    {
+        const int nIndex = atoi(osName.c_str() + 1);
+        if( nIndex < 1 )
+        {
+            Error("source indices start at B1");
+            return;
+        }
+        m_nMaxSourceIndex = std::max(m_nMaxSourceIndex, nIndex);
+        Emit(EOP_SOURCE, nIndex - 1);
+        return;
+    }
+    if( EQUAL(osName, "nodata") )
+    {
+        // Resolved at evaluation time.
+        Emit(EOP_CONST, -1);
+        return;
+    }
+    if( EQUAL(osName, "pi") )
+    {
+        Emit(EOP_CONST, 0, M_PI);
+        return;
+    }
+
+    for( size_t i = 0; i < CPL_ARRAYSIZE(asFunctions); i++ )
+    {
+        if( !EQUAL(osName, asFunctions[i].pszName) )
+            continue;
+        if( !Accept("(") )
+        {
+            Error("'(' expected");
+            return;
+        }
+        int nArgs = 0;
+        do
+        {
+            ParseExpr();
+            nArgs++;
+            // min() and max() with more than 2 arguments are chained.
+            if( nArgs > 2 && (asFunctions[i].eOp == EOP_MIN ||
+                              asFunctions[i].eOp == EOP_MAX) )
+                EmitOp(asFunctions[i].eOp, 2);
+        } while( !m_bError && Accept(",") );
+        if( m_bError )
+            return;
+        if( !Accept(")") )
+        {
+            Error("')' expected");
+            return;
+        }
+        if( nArgs < asFunctions[i].nMinArgs ||
+            nArgs > asFunctions[i].nMaxArgs )
+        {
+            Error(CPLSPrintf("wrong number of arguments for %s()",
+                             asFunctions[i].pszName));
+            return;
+        }
+        if( asFunctions[i].eOp == EOP_MIN || asFunctions[i].eOp == EOP_MAX )
+            EmitOp(asFunctions[i].eOp, 2);
+        else
+            EmitOp(asFunctions[i].eOp, asFunctions[i].nMaxArgs);
+        return;
+    }
+
+    m_pszCur = pszStart;
+    Error(CPLSPrintf("unknown identifier '%s'", osName.c_str()));
+}
+
+} // namespace
+
+/************************************************************************/
+/* ==================================================================== */
+/*                            VRTExpression                             */
+/* ==================================================================== */
+/************************************************************************/
+
+VRTExpression::VRTExpression() :
+    m_nMaxDepth(0),
+    m_nMaxSourceIndex(0)
+{}
+
+/************************************************************************/
+/*                              Compile()                               */
+/************************************************************************/
+
+bool VRTExpression::Compile( const char* pszExpression )
+{
+    m_osExpression = pszExpression;
+    m_aoProgram.clear();
+    m_nMaxDepth = 0;
+    m_nMaxSourceIndex = 0;
+
+    VRTExpressionParser oParser(pszExpression, m_aoProgram);
+    if( !oParser.Parse() )
+    {
+        m_aoProgram.clear();
+        return false;
+    }
+    m_nMaxDepth = oParser.GetMaxDepth();
+    m_nMaxSourceIndex = oParser.GetMaxSourceIndex();
+    return true;
+}
+
+/************************************************************************/
+/*                              IsNoData()                              */
+/************************************************************************/
+
+static inline double IsNoData( double dfVal, bool bHasNoData, double dfNoData )
+{
+    if( CPLIsNan(dfVal) )
+        return 1.0;
+    return (bHasNoData && dfVal == dfNoData) ? 1.0 : 0.0;
+}
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/*                                                                      */
+/*      papSources are packed buffers of nBufXSize * nBufYSize values   */
+/*      of type eSrcType. Each instruction of the program is applied    */
+/*      to EXPR_CHUNK_SIZE pixels at once, on a stack of chunks.        */
+/************************************************************************/
+
+CPLErr VRTExpression::Evaluate( void **papSources, int nSources,
+                                GDALDataType eSrcType,
+                                void *pData, int nBufXSize, int nBufYSize,
+                                GDALDataType eBufType,
+                                GSpacing nPixelSpace, GSpacing nLineSpace,
+                                bool bHasNoData, double dfNoData,
+                                bool bPropagateNoData ) const
+{
+    if( m_aoProgram.empty() )
+        return CE_Failure;
+    if( m_nMaxSourceIndex > nSources )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Expression '%s' references B%d, but there are only "
+                  "%d sources",
+                  m_osExpression.c_str(), m_nMaxSourceIndex, nSources );
+        return CE_Failure;
+    }
+
+    const int nSrcTypeSize = GDALGetDataTypeSizeBytes(eSrcType);
+    const double dfNoDataValue =
+        bHasNoData ? dfNoData : std::numeric_limits<double>::quiet_NaN();
+    // One extra chunk for nodata propagation.
+    std::vector<double> adfStack(
+        static_cast<size_t>(m_nMaxDepth + 1) * EXPR_CHUNK_SIZE );
+    double* const padfTmp = &adfStack[0] +
+                    static_cast<size_t>(m_nMaxDepth) * EXPR_CHUNK_SIZE;
+    const size_t nInstructions = m_aoProgram.size();
+
+    for( int iLine = 0; iLine < nBufYSize; iLine++ )
+    {
+        for( int iCol = 0; iCol < nBufXSize; iCol += EXPR_CHUNK_SIZE )
+        {
+            const int nCount = std::min(EXPR_CHUNK_SIZE, nBufXSize - iCol);
+            const size_t nOffset =
+                static_cast<size_t>(iLine) * nBufXSize + iCol;
+            int nDepth = 0;
+
+            for( size_t iInstr = 0; iInstr < nInstructions; iInstr++ )
+            {
+                const Instruction& sInstr = m_aoProgram[iInstr];
+                // Operands of an operator with n operands are the n chunks
+                // below padfTop.
+                double* const padfTop = &adfStack[0] +
+                    static_cast<size_t>(nDepth) * EXPR_CHUNK_SIZE;
+
+                switch( sInstr.nOp )
+                {
+                    case EOP_CONST:
+                    {
+                        const double dfValue =
+                            (sInstr.nArg < 0) ? dfNoDataValue : sInstr.dfValue;
+                        for( int i = 0; i < nCount; i++ )
+                            padfTop[i] = dfValue;
+                        nDepth++;
+                        break;
+                    }
+                    case EOP_SOURCE:
+                    {
+                        GDALCopyWords(
+                            static_cast<GByte*>(papSources[sInstr.nArg]) +
+                                                    nOffset * nSrcTypeSize,
+                            eSrcType, nSrcTypeSize,
+                            padfTop, GDT_Float64, sizeof(double), nCount );
+                        nDepth++;
+                        break;
+                    }
+
+#define UNARY_OP(expr) \
+    { double* const padfA = padfTop - EXPR_CHUNK_SIZE; \
+      for( int i = 0; i < nCount; i++ ) \
+      { const double a = padfA[i]; padfA[i] = (expr); } } \
+    break;
+
+                    case EOP_NEG: UNARY_OP(-a)
+                    case EOP_NOT: UNARY_OP(a == 0.0 ? 1.0 : 0.0)
+                    case EOP_ABS: UNARY_OP(fabs(a))
+                    case EOP_SQRT: UNARY_OP(sqrt(a))
+                    case EOP_LOG: UNARY_OP(log(a))
+                    case EOP_LOG10: UNARY_OP(log10(a))
+                    case EOP_EXP: UNARY_OP(exp(a))
+                    case EOP_FLOOR: UNARY_OP(floor(a))
+                    case EOP_CEIL: UNARY_OP(ceil(a))
+                    case EOP_ROUND:
+                        UNARY_OP(a >= 0.0 ? floor(a + 0.5) : ceil(a - 0.5))
+                    case EOP_ISNODATA:
+                        UNARY_OP(IsNoData(a, bHasNoData, dfNoData))
+#undef UNARY_OP
+
+#define BINARY_OP(expr) \
+    { double* const padfX = padfTop - 2 * EXPR_CHUNK_SIZE; \
+      const double* const padfY = padfTop - EXPR_CHUNK_SIZE; \
+      for( int i = 0; i < nCount; i++ ) \
+      { const double x = padfX[i]; const double y = padfY[i]; \
+        padfX[i] = (expr); } } \
+    nDepth--; \
+    break;
+
+                    case EOP_ADD: BINARY_OP(x + y)
+                    case EOP_SUB: BINARY_OP(x - y)
+                    case EOP_MUL: BINARY_OP(x * y)
+                    case EOP_DIV: BINARY_OP(x / y)
+                    case EOP_MOD: BINARY_OP(fmod(x, y))
+                    case EOP_POW: BINARY_OP(pow(x, y))
+                    case EOP_EQ: BINARY_OP(x == y ? 1.0 : 0.0)
+                    case EOP_NE: BINARY_OP(x != y ? 1.0 : 0.0)
+                    case EOP_LT: BINARY_OP(x < y ? 1.0 : 0.0)
+                    case EOP_LE: BINARY_OP(x <= y ? 1.0 : 0.0)
+                    case EOP_GT: BINARY_OP(x > y ? 1.0 : 0.0)
+                    case EOP_GE: BINARY_OP(x >= y ? 1.0 : 0.0)
+                    case EOP_AND: BINARY_OP((x != 0.0 && y != 0.0) ? 1.0 : 0.0)
+                    case EOP_OR: BINARY_OP((x != 0.0 || y != 0.0) ? 1.0 : 0.0)
+                    case EOP_MIN: BINARY_OP(y < x ? y : x)
+                    case EOP_MAX: BINARY_OP(y > x ? y : x)
+#undef BINARY_OP
+
+                    case EOP_SELECT:
+                    {
+                        double* const padfCond =
+                            padfTop - 3 * EXPR_CHUNK_SIZE;
+                        const double* const padfX =
+                            padfTop - 2 * EXPR_CHUNK_SIZE;
+                        const double* const padfY = padfTop - EXPR_CHUNK_SIZE;
+                        for( int i = 0; i < nCount; i++ )
+                        {
+                            padfCond[i] = (padfCond[i] != 0.0) ? padfX[i]
+                                                               : padfY[i];
+                        }
+                        nDepth -= 2;
+                        break;
+                    }
+
+                    default:
+                        CPLAssert(false);
+                        break;
+                }
+            }
+            CPLAssert( nDepth == 1 );
+
+            double* const padfResult = &adfStack[0];
+            if( bPropagateNoData && bHasNoData )
+            {
+                for( int iSrc = 0; iSrc < nSources; iSrc++ )
+                {
+                    GDALCopyWords(
+                        static_cast<GByte*>(papSources[iSrc]) +
+                                                nOffset * nSrcTypeSize,
+                        eSrcType, nSrcTypeSize,
+                        padfTmp, GDT_Float64, sizeof(double), nCount );
+                    for( int i = 0; i < nCount; i++ )
+                    {
+                        if( IsNoData(padfTmp[i], true, dfNoData) != 0.0 )
+                            padfResult[i] = dfNoData;
+                    }
+                }
+            }
+
+            GDALCopyWords( padfResult, GDT_Float64, sizeof(double),
+                           static_cast<GByte*>(pData) +
+                                nLineSpace * iLine + nPixelSpace * iCol,
+                           eBufType, static_cast<int>(nPixelSpace), nCount );
+        }
+    }
+
+    return CE_None;
+}
+
+/*! @endcond */
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  Virtual GDAL Datasets
+ * Purpose:  Band math expressions for VRTDerivedRasterBand.
+ *
+ ******************************************************************************
+ * Copyright (c) 2017, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef VRTEXPRESSION_H_INCLUDED
+#define VRTEXPRESSION_H_INCLUDED
+
+#ifndef DOXYGEN_SKIP
+
+#include "gdal.h"
+#include "cpl_string.h"
+
+#include <vector>
+
+/************************************************************************/
+/*                            VRTExpression                             */
+/*                                                                      */
+/*      An arithmetic expression over the sources of a derived band     */
+/*      (B1, B2, ...), compiled into a stack program that is evaluated  */
+/*      on chunks of pixels at a time.                                  */
+/************************************************************************/
+
+class VRTExpression
+{
+  public:
+    typedef struct
+    {
+        int    nOp;
+        int    nArg;
+        double dfValue;
+    } Instruction;
+
+  private:
+    CPLString                 m_osExpression;
+    std::vector<Instruction>  m_aoProgram;
+    int                       m_nMaxDepth;
+    int                       m_nMaxSourceIndex;
+
+  public:
+                VRTExpression();
+
+    bool        Compile( const char* pszExpression );
+    const CPLString& GetExpression() const { return m_osExpression; }
+    int         GetMaxSourceIndex() const { return m_nMaxSourceIndex; }
+
+    CPLErr      Evaluate( void **papSources, int nSources,
+                          GDALDataType eSrcType,
+                          void *pData, int nBufXSize, int nBufYSize,
+                          GDALDataType eBufType,
+                          GSpacing nPixelSpace, GSpacing nLineSpace,
+                          bool bHasNoData, double dfNoData,
+                          bool bPropagateNoData ) const;
+};
+
+#endif /* #ifndef DOXYGEN_SKIP */
+
+#endif /* ndef VRTEXPRESSION_H_INCLUDED */
@@ -29,9 +29,15 @@
 
 #include "cpl_minixml.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "ogr_geometry.h"
 
 #include "vrtdataset.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
 CPL_CVSID("$Id$");
 
 /*! @cond Doxygen_Suppress */
@@ -49,6 +55,8 @@ CPL_CVSID("$Id$");
 VRTSourcedRasterBand::VRTSourcedRasterBand( GDALDataset *poDSIn, int nBandIn ) :
     m_nRecursionCounter(0),
     m_papszSourceList(NULL),
+    m_hSourceIndex(NULL),
+    m_nIndexedSources(0),
     nSources(0),
     papoSources(NULL),
     bSkipBufferInitialization(FALSE)
@@ -68,6 +76,8 @@ VRTSourcedRasterBand::VRTSourcedRasterBand( GDALDataType eType,
                                             int nXSize, int nYSize ) :
     m_nRecursionCounter(0),
     m_papszSourceList(NULL),
+    m_hSourceIndex(NULL),
+    m_nIndexedSources(0),
     nSources(0),
     papoSources(NULL),
     bSkipBufferInitialization(FALSE)
@@ -86,6 +96,8 @@ VRTSourcedRasterBand::VRTSourcedRasterBand( GDALDataset *poDSIn, int nBandIn,
                                             int nXSize, int nYSize ) :
     m_nRecursionCounter(0),
     m_papszSourceList(NULL),
+    m_hSourceIndex(NULL),
+    m_nIndexedSources(0),
     nSources(0),
     papoSources(NULL),
     bSkipBufferInitialization(FALSE)
@@ -107,6 +119,121 @@ VRTSourcedRasterBand::~VRTSourcedRasterBand()
 {
     CloseDependentDatasets();
     CSLDestroy(m_papszSourceList);
+    InvalidateSourceIndex();
+}
+
+/************************************************************************/
+/*                       InvalidateSourceIndex()                        */
+/************************************************************************/
+
+void VRTSourcedRasterBand::InvalidateSourceIndex()
+{
+    if( m_hSourceIndex != NULL )
+    {
+        CPLQuadTreeDestroy( m_hSourceIndex );
+        m_hSourceIndex = NULL;
+    }
+    m_nIndexedSources = 0;
+    m_anUnindexedSources.clear();
+}
+
+/************************************************************************/
+/*                          BuildSourceIndex()                          */
+/*                                                                      */
+/*      Index the destination windows of the simple sources. Other      */
+/*      sources, and simple sources without a destination window,       */
+/*      may cover any request and are always visited.                   */
+/************************************************************************/
+
+void VRTSourcedRasterBand::BuildSourceIndex()
+{
+    InvalidateSourceIndex();
+
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = 0;
+    sGlobalBounds.miny = 0;
+    sGlobalBounds.maxx = nRasterXSize;
+    sGlobalBounds.maxy = nRasterYSize;
+    m_hSourceIndex = CPLQuadTreeCreate( &sGlobalBounds, NULL );
+
+    for( int iSource = 0; iSource < nSources; iSource++ )
+    {
+        if( papoSources[iSource]->IsSimpleSource() )
+        {
+            VRTSimpleSource* poSS =
+                reinterpret_cast<VRTSimpleSource*>( papoSources[iSource] );
+            const bool bDstWinSet =
+                poSS->m_dfDstXOff != -1 || poSS->m_dfDstXSize != -1 ||
+                poSS->m_dfDstYOff != -1 || poSS->m_dfDstYSize != -1;
+            // Also catches NaN values.
+            if( bDstWinSet &&
+                poSS->m_dfDstXSize >= 0 && poSS->m_dfDstYSize >= 0 &&
+                !CPLIsNan(poSS->m_dfDstXOff) && !CPLIsNan(poSS->m_dfDstYOff) )
+            {
+                CPLRectObj sBounds;
+                sBounds.minx = poSS->m_dfDstXOff;
+                sBounds.miny = poSS->m_dfDstYOff;
+                sBounds.maxx = poSS->m_dfDstXOff + poSS->m_dfDstXSize;
+                sBounds.maxy = poSS->m_dfDstYOff + poSS->m_dfDstYSize;
+                CPLQuadTreeInsertWithBounds(
+                    m_hSourceIndex,
+                    reinterpret_cast<void*>(static_cast<GUIntptr_t>(iSource)),
+                    &sBounds );
+                continue;
+            }
+        }
+        m_anUnindexedSources.push_back( iSource );
+    }
+
+    m_nIndexedSources = nSources;
+}
+
+/************************************************************************/
+/*                       GetSourcesIntersecting()                       */
+/*                                                                      */
+/*      Return the indices, in increasing order, of the sources that    */
+/*      may contribute to the passed window. Sources must still check   */
+/*      themselves the window they are requested.                       */
+/************************************************************************/
+
+void VRTSourcedRasterBand::GetSourcesIntersecting( int nXOff, int nYOff,
+                                                   int nXSize, int nYSize,
+                                                   std::vector<int>& anSources )
+{
+    anSources.clear();
+
+    // Below that number of sources, looping over all of them is cheap.
+    if( nSources < 32 )
+    {
+        for( int iSource = 0; iSource < nSources; iSource++ )
+            anSources.push_back( iSource );
+        return;
+    }
+
+    if( m_hSourceIndex == NULL || m_nIndexedSources != nSources )
+        BuildSourceIndex();
+
+    CPLRectObj sAoi;
+    sAoi.minx = nXOff;
+    sAoi.miny = nYOff;
+    sAoi.maxx = static_cast<double>(nXOff) + nXSize;
+    sAoi.maxy = static_cast<double>(nYOff) + nYSize;
+    int nFeatureCount = 0;
+    void** pahFeatures =
+        CPLQuadTreeSearch( m_hSourceIndex, &sAoi, &nFeatureCount );
+
+    anSources.reserve( nFeatureCount + m_anUnindexedSources.size() );
+    for( int i = 0; i < nFeatureCount; i++ )
+    {
+        anSources.push_back( static_cast<int>(
+            reinterpret_cast<GUIntptr_t>(pahFeatures[i])) );
+    }
+    CPLFree( pahFeatures );
+    anSources.insert( anSources.end(), m_anUnindexedSources.begin(),
+                      m_anUnindexedSources.end() );
+
+    // Sources must be composited in their order.
+    std::sort( anSources.begin(), anSources.end() );
 }
 
 /************************************************************************/
@@ -166,8 +293,11 @@ CPLErr VRTSourcedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
         psExtraArg->eResampleAlg != GRIORA_NearestNeighbour &&
         m_bNoDataValueSet )
     {
-        for( int i = 0; i < nSources; i++ )
+        std::vector<int> anSources;
+        GetSourcesIntersecting( nXOff, nYOff, nXSize, nYSize, anSources );
+        for( size_t iCandidate = 0; iCandidate < anSources.size(); iCandidate++ )
         {
+            const int i = anSources[iCandidate];
             bool bFallbackToBase = false;
             if( !papoSources[i]->IsSimpleSource() )
             {
@@ -264,37 +394,339 @@ CPLErr VRTSourcedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
 
     m_nRecursionCounter++;
 
+/* -------------------------------------------------------------------- */
+/*      Overlay each source in turn over top this.                      */
+/* -------------------------------------------------------------------- */
+    std::vector<int> anSources;
+    GetSourcesIntersecting( nXOff, nYOff, nXSize, nYSize, anSources );
+
+    const CPLErr eErr = ReadSources( anSources, nXOff, nYOff, nXSize, nYSize,
+                                     pData, nBufXSize, nBufYSize, eBufType,
+                                     0, NULL, nPixelSpace, nLineSpace, 0,
+                                     psExtraArg );
+
+    m_nRecursionCounter--;
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                          VRTSourceReadJob                            */
+/************************************************************************/
+
+typedef struct
+{
+    VRTSource           *poSource;
+    int                  nXOff;
+    int                  nYOff;
+    int                  nXSize;
+    int                  nYSize;
+    void                *pData;
+    int                  nBufXSize;
+    int                  nBufYSize;
+    GDALDataType         eBufType;
+    int                  nBandCount;
+    int                 *panBandMap;
+    GSpacing             nPixelSpace;
+    GSpacing             nLineSpace;
+    GSpacing             nBandSpace;
+    GDALRasterIOExtraArg sExtraArg;
+    CPLErr               eErr;
+} VRTSourceReadJob;
+
+static void VRTReadSource( void* pUserData )
+{
+    VRTSourceReadJob* psJob = static_cast<VRTSourceReadJob *>(pUserData);
+
+    if( psJob->nBandCount > 0 )
+    {
+        psJob->eErr =
+            reinterpret_cast<VRTSimpleSource *>( psJob->poSource )->
+                DatasetRasterIO( psJob->nXOff, psJob->nYOff,
+                                 psJob->nXSize, psJob->nYSize,
+                                 psJob->pData,
+                                 psJob->nBufXSize, psJob->nBufYSize,
+                                 psJob->eBufType,
+                                 psJob->nBandCount, psJob->panBandMap,
+                                 psJob->nPixelSpace, psJob->nLineSpace,
+                                 psJob->nBandSpace,
+                                 &psJob->sExtraArg );
+    }
+    else
+    {
+        psJob->eErr =
+            psJob->poSource->RasterIO( psJob->nXOff, psJob->nYOff,
+                                       psJob->nXSize, psJob->nYSize,
+                                       psJob->pData,
+                                       psJob->nBufXSize, psJob->nBufYSize,
+                                       psJob->eBufType,
+                                       psJob->nPixelSpace, psJob->nLineSpace,
+                                       &psJob->sExtraArg );
+    }
+}
+
+/************************************************************************/
+/*                      VRTSourceCanRunConcurrently()                   */
+/*                                                                      */
+/*      Return the dataset of a source that can be read by a worker     */
+/*      thread, or NULL if it must be read by the calling thread.       */
+/************************************************************************/
+
+static GDALDataset* VRTSourceCanRunConcurrently( VRTSource* poSource )
+{
+    if( !poSource->IsSimpleSource() )
+        return NULL;
+    GDALRasterBand* poSrcBand =
+        reinterpret_cast<VRTSimpleSource *>( poSource )->GetBand();
+    if( poSrcBand == NULL )
+        return NULL;
+    GDALDataset* poSrcDS = poSrcBand->GetDataset();
+    if( poSrcDS == NULL )
+        return NULL;
+
+    // Nested VRTs may resolve to the same pooled datasets as other sources,
+    // so keep them on the calling thread.
+    const char* pszDesc = poSrcDS->GetDescription();
+    if( STARTS_WITH_CI(pszDesc, "<VRTDataset") ||
+        EQUAL(CPLGetExtension(pszDesc), "vrt") )
+        return NULL;
+
+    return poSrcDS;
+}
+
+/************************************************************************/
+/*                            ReadSources()                             */
+/*                                                                      */
+/*      Read the given sources, in order, into the output buffer. If    */
+/*      the dataset has a thread pool (NUM_THREADS open option or       */
+/*      VRT_NUM_THREADS), consecutive sources that write to disjoint    */
+/*      parts of the buffer and come from different datasets are read  */
+/*      concurrently. A nBandCount > 0 means dataset-level RasterIO()   */
+/*      of VRTSimpleSource.                                             */
+/************************************************************************/
+
+CPLErr VRTSourcedRasterBand::ReadSources( const std::vector<int>& anSources,
+                                          int nXOff, int nYOff,
+                                          int nXSize, int nYSize,
+                                          void *pData,
+                                          int nBufXSize, int nBufYSize,
+                                          GDALDataType eBufType,
+                                          int nBandCount, int *panBandMap,
+                                          GSpacing nPixelSpace,
+                                          GSpacing nLineSpace,
+                                          GSpacing nBandSpace,
+                                          GDALRasterIOExtraArg* psExtraArg )
+{
     GDALProgressFunc const pfnProgressGlobal = psExtraArg->pfnProgress;
     void * const pProgressDataGlobal = psExtraArg->pProgressData;
+    const int nCandidates = static_cast<int>(anSources.size());
+
+    CPLWorkerThreadPool* poThreadPool = NULL;
+    if( nCandidates > 1 && poDS != NULL )
+        poThreadPool = static_cast<VRTDataset *>( poDS )->GetThreadPool();
+
+    CPLErr eErr = CE_None;
 
 /* -------------------------------------------------------------------- */
-/*      Overlay each source in turn over top this.                      */
+/*      Sequential read.                                                */
 /* -------------------------------------------------------------------- */
-    CPLErr eErr = CE_None;
-    for( int iSource = 0; eErr == CE_None && iSource < nSources; iSource++ )
+    if( poThreadPool == NULL )
     {
-        psExtraArg->pfnProgress = GDALScaledProgress;
-        psExtraArg->pProgressData =
-            GDALCreateScaledProgress( 1.0 * iSource / nSources,
-                                      1.0 * (iSource + 1) / nSources,
-                                      pfnProgressGlobal,
-                                      pProgressDataGlobal );
-        if( psExtraArg->pProgressData == NULL )
-            psExtraArg->pfnProgress = NULL;
-
-        eErr =
-            papoSources[iSource]->RasterIO( nXOff, nYOff, nXSize, nYSize,
-                                            pData, nBufXSize, nBufYSize,
-                                            eBufType, nPixelSpace, nLineSpace,
-                                            psExtraArg);
-
-        GDALDestroyScaledProgress( psExtraArg->pProgressData );
+        for( int iCandidate = 0; eErr == CE_None && iCandidate < nCandidates;
+             iCandidate++ )
+        {
+            const int iSource = anSources[iCandidate];
+            psExtraArg->pfnProgress = GDALScaledProgress;
+            psExtraArg->pProgressData =
+                GDALCreateScaledProgress( 1.0 * iCandidate / nCandidates,
+                                          1.0 * (iCandidate + 1) / nCandidates,
+                                          pfnProgressGlobal,
+                                          pProgressDataGlobal );
+            if( psExtraArg->pProgressData == NULL )
+                psExtraArg->pfnProgress = NULL;
+
+            VRTSourceReadJob sJob;
+            sJob.poSource = papoSources[iSource];
+            sJob.nXOff = nXOff;
+            sJob.nYOff = nYOff;
+            sJob.nXSize = nXSize;
+            sJob.nYSize = nYSize;
+            sJob.pData = pData;
+            sJob.nBufXSize = nBufXSize;
+            sJob.nBufYSize = nBufYSize;
+            sJob.eBufType = eBufType;
+            sJob.nBandCount = nBandCount;
+            sJob.panBandMap = panBandMap;
+            sJob.nPixelSpace = nPixelSpace;
+            sJob.nLineSpace = nLineSpace;
+            sJob.nBandSpace = nBandSpace;
+            sJob.sExtraArg = *psExtraArg;
+            sJob.eErr = CE_None;
+            VRTReadSource( &sJob );
+            eErr = sJob.eErr;
+
+            GDALDestroyScaledProgress( psExtraArg->pProgressData );
+        }
+
+        psExtraArg->pfnProgress = pfnProgressGlobal;
+        psExtraArg->pProgressData = pProgressDataGlobal;
+
+        return eErr;
     }
 
-    psExtraArg->pfnProgress = pfnProgressGlobal;
-    psExtraArg->pProgressData = pProgressDataGlobal;
+/* -------------------------------------------------------------------- */
+/*      Concurrent read. Sources are gathered, in order, into batches   */
+/*      whose members do not overlap in the output buffer and do not    */
+/*      share a source dataset, so the result is identical to the      */
+/*      sequential one. Each batch is run on the thread pool.           */
+/* -------------------------------------------------------------------- */
+    std::vector<VRTSourceReadJob> asJobs;
+    asJobs.reserve( nCandidates );
+    std::vector<int> anBatchWindows;
+    std::set<CPLString> oBatchDatasets;
+    int nDone = 0;
+
+    for( int iCandidate = 0;
+         eErr == CE_None && iCandidate <= nCandidates;
+         iCandidate++ )
+    {
+        VRTSource* poSource = NULL;
+        GDALDataset* poSrcDS = NULL;
+        CPLString osKey;
+        int nOutXOff = 0;
+        int nOutYOff = 0;
+        int nOutXSize = 0;
+        int nOutYSize = 0;
+        bool bFlush = (iCandidate == nCandidates);
+
+        if( !bFlush )
+        {
+            poSource = papoSources[anSources[iCandidate]];
+            poSrcDS = VRTSourceCanRunConcurrently( poSource );
+            if( poSrcDS != NULL )
+            {
+                double dfReqXOff = 0.0;
+                double dfReqYOff = 0.0;
+                double dfReqXSize = 0.0;
+                double dfReqYSize = 0.0;
+                int nReqXOff = 0;
+                int nReqYOff = 0;
+                int nReqXSize = 0;
+                int nReqYSize = 0;
+                if( !reinterpret_cast<VRTSimpleSource *>( poSource )->
+                        GetSrcDstWindow( nXOff, nYOff, nXSize, nYSize,
+                                         nBufXSize, nBufYSize,
+                                         &dfReqXOff, &dfReqYOff,
+                                         &dfReqXSize, &dfReqYSize,
+                                         &nReqXOff, &nReqYOff,
+                                         &nReqXSize, &nReqYSize,
+                                         &nOutXOff, &nOutYOff,
+                                         &nOutXSize, &nOutYSize ) )
+                {
+                    // Nothing to read.
+                    nDone++;
+                    continue;
+                }
 
-    m_nRecursionCounter--;
+                osKey = poSrcDS->GetDescription();
+                if( osKey.empty() )
+                    osKey.Printf( "%p", poSrcDS );
+
+                if( oBatchDatasets.find(osKey) != oBatchDatasets.end() )
+                    bFlush = true;
+                for( size_t i = 0;
+                     !bFlush && i < anBatchWindows.size(); i += 4 )
+                {
+                    if( nOutXOff < anBatchWindows[i] + anBatchWindows[i+2] &&
+                        anBatchWindows[i] < nOutXOff + nOutXSize &&
+                        nOutYOff < anBatchWindows[i+1] + anBatchWindows[i+3] &&
+                        anBatchWindows[i+1] < nOutYOff + nOutYSize )
+                    {
+                        bFlush = true;
+                    }
+                }
+            }
+            else
+            {
+                bFlush = true;
+            }
+        }
+
+        if( bFlush && !asJobs.empty() )
+        {
+            for( size_t i = 0; i < asJobs.size(); i++ )
+                poThreadPool->SubmitJob( VRTReadSource, &asJobs[i] );
+            poThreadPool->WaitCompletion();
+
+            for( size_t i = 0; i < asJobs.size(); i++ )
+            {
+                if( asJobs[i].eErr != CE_None )
+                    eErr = asJobs[i].eErr;
+            }
+            nDone += static_cast<int>(asJobs.size());
+            asJobs.clear();
+            anBatchWindows.clear();
+            oBatchDatasets.clear();
+
+            if( eErr == CE_None && pfnProgressGlobal != NULL &&
+                !pfnProgressGlobal( 1.0 * nDone / nCandidates, "",
+                                    pProgressDataGlobal ) )
+            {
+                CPLError( CE_Failure, CPLE_UserInterrupt,
+                          "User terminated" );
+                eErr = CE_Failure;
+            }
+        }
+
+        if( poSource == NULL || eErr != CE_None )
+            continue;
+
+        VRTSourceReadJob sJob;
+        sJob.poSource = poSource;
+        sJob.nXOff = nXOff;
+        sJob.nYOff = nYOff;
+        sJob.nXSize = nXSize;
+        sJob.nYSize = nYSize;
+        sJob.pData = pData;
+        sJob.nBufXSize = nBufXSize;
+        sJob.nBufYSize = nBufYSize;
+        sJob.eBufType = eBufType;
+        sJob.nBandCount = nBandCount;
+        sJob.panBandMap = panBandMap;
+        sJob.nPixelSpace = nPixelSpace;
+        sJob.nLineSpace = nLineSpace;
+        sJob.nBandSpace = nBandSpace;
+        sJob.sExtraArg = *psExtraArg;
+        sJob.eErr = CE_None;
+
+        if( poSrcDS == NULL )
+        {
+            // Read on the calling thread, with its share of the progress.
+            sJob.sExtraArg.pfnProgress = GDALScaledProgress;
+            sJob.sExtraArg.pProgressData =
+                GDALCreateScaledProgress( 1.0 * nDone / nCandidates,
+                                          1.0 * (nDone + 1) / nCandidates,
+                                          pfnProgressGlobal,
+                                          pProgressDataGlobal );
+            if( sJob.sExtraArg.pProgressData == NULL )
+                sJob.sExtraArg.pfnProgress = NULL;
+            VRTReadSource( &sJob );
+            GDALDestroyScaledProgress( sJob.sExtraArg.pProgressData );
+            eErr = sJob.eErr;
+            nDone++;
+        }
+        else
+        {
+            sJob.sExtraArg.pfnProgress = NULL;
+            sJob.sExtraArg.pProgressData = NULL;
+            asJobs.push_back( sJob );
+            anBatchWindows.push_back( nOutXOff );
+            anBatchWindows.push_back( nOutYOff );
+            anBatchWindows.push_back( nOutXSize );
+            anBatchWindows.push_back( nOutYSize );
+            oBatchDatasets.insert( osKey );
+        }
+    }
 
     return eErr;
 }
@@ -337,8 +769,11 @@ int  VRTSourcedRasterBand::IGetDataCoverageStatus( int nXOff,
     poLR->addPoint( nXOff, nYOff );
     poPolyNonCoveredBySources->addRingDirectly(poLR);
 
-    for( int iSource = 0; iSource < nSources; iSource++ )
+    std::vector<int> anSources;
+    GetSourcesIntersecting( nXOff, nYOff, nXSize, nYSize, anSources );
+    for( size_t iCandidate = 0; iCandidate < anSources.size(); iCandidate++ )
     {
+        const int iSource = anSources[iCandidate];
         if( !papoSources[iSource]->IsSimpleSource() )
         {
             delete poPolyNonCoveredBySources;
@@ -881,6 +1316,8 @@ CPLErr VRTSourcedRasterBand::AddSource( VRTSource *poNewSource )
         CPLRealloc( papoSources, sizeof(void*) * nSources ) );
     papoSources[nSources-1] = poNewSource;
 
+    InvalidateSourceIndex();
+
     reinterpret_cast<VRTDataset *>( poDS )->SetNeedsFlush();
 
     if( poNewSource->IsSimpleSource() )
@@ -1570,6 +2007,7 @@ CPLErr VRTSourcedRasterBand::SetMetadataItem( const char *pszName,
         {
             delete papoSources[iSource];
             papoSources[iSource] = poSource;
+            InvalidateSourceIndex();
             reinterpret_cast<VRTDataset *>( poDS )->SetNeedsFlush();
             return CE_None;
         }
@@ -1601,6 +2039,7 @@ CPLErr VRTSourcedRasterBand::SetMetadata( char **papszNewMD, const char *pszDoma
             CPLFree( papoSources );
             papoSources = NULL;
             nSources = 0;
+            InvalidateSourceIndex();
         }
 
         for( int i = 0; i < CSLCount(papszNewMD); i++ )
@@ -1661,6 +2100,7 @@ int VRTSourcedRasterBand::CloseDependentDatasets()
     CPLFree( papoSources );
     papoSources = NULL;
     nSources = 0;
+    InvalidateSourceIndex();
 
     return TRUE;
 }
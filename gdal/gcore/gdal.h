@@ -722,6 +722,20 @@ typedef CPLErr
                         GDALDataType eSrcType, GDALDataType eBufType,
                         int nPixelSpace, int nLineSpace);
 
+/** Type of functions to pass to GDALAddDerivedBandPixelFuncTyped.
+ *
+ * papSources are nSources packed arrays of nValues values of type eSrcType,
+ * and pDst a packed array of nValues values of type eDstType.
+ * The function must return FALSE, without writing pDst, if it does not handle
+ * this combination of data types (or this number of sources), in which case
+ * the GDALDerivedPixelFunc registered with the same name, if any, is used.
+ * @since GDAL 2.3 */
+typedef int
+(*GDALDerivedPixelFuncTyped)(const void * const *papSources, int nSources,
+                             GDALDataType eSrcType,
+                             void *pDst, GDALDataType eDstType,
+                             size_t nValues);
+
 GDALDataType CPL_DLL CPL_STDCALL GDALGetRasterDataType( GDALRasterBandH );
 void CPL_DLL CPL_STDCALL
 GDALGetBlockSize( GDALRasterBandH, int * pnXSize, int * pnYSize );
@@ -845,6 +859,9 @@ CPLErr CPL_DLL CPL_STDCALL GDALSetDefaultRAT( GDALRasterBandH,
                                               GDALRasterAttributeTableH );
 CPLErr CPL_DLL CPL_STDCALL GDALAddDerivedBandPixelFunc( const char *pszName,
                                     GDALDerivedPixelFunc pfnPixelFunc );
+CPLErr CPL_DLL CPL_STDCALL GDALAddDerivedBandPixelFuncTyped(
+                                    const char *pszName,
+                                    GDALDerivedPixelFuncTyped pfnPixelFunc );
 
 GDALRasterBandH CPL_DLL CPL_STDCALL GDALGetMaskBand( GDALRasterBandH hBand );
 int CPL_DLL CPL_STDCALL GDALGetMaskFlags( GDALRasterBandH hBand );
@@ -47,19 +47,42 @@ CPL_CVSID("$Id$");
 static bool bCacheMaxInitialized = false;
 // Will later be overridden by the default 5% if GDAL_CACHEMAX not defined.
 static GIntBig nCacheMax = 40 * 1024 * 1024;
-static volatile GIntBig nCacheUsed = 0;
 
-static GDALRasterBlock *poOldest = NULL;  // Tail.
-static GDALRasterBlock *poNewest = NULL;  // Head.
+/* -------------------------------------------------------------------- */
+/*      The LRU list of cached blocks and the accounting of the memory  */
+/*      they use is split into one or several shards, each protected    */
+/*      by its own lock. A block goes to the shard selected by hashing  */
+/*      its band pointer. With a single shard (the default), we have    */
+/*      an exact global LRU. With several shards, the LRU order is      */
+/*      only maintained within each shard, but threads working on       */
+/*      different bands do not contend on the same lock. The cache      */
+/*      maximum is then a soft global limit over the sum of shards.     */
+/* -------------------------------------------------------------------- */
+
+#define MAX_LRU_SHARDS 64
+
+typedef struct
+{
+#if 0
+    CPLMutex        *hLock;
+#else
+    CPLLock         *hLock;
+#endif
+    GDALRasterBlock *poOldest;  // Tail.
+    GDALRasterBlock *poNewest;  // Head.
+    volatile GIntBig nCacheUsed;
+} GDALRasterBlockLRU;
+
+static GDALRasterBlockLRU asLRU[MAX_LRU_SHARDS];
+static int nLRUShards = 1;
+static bool bLRUShardsInitialized = false;
 
 #if 0
-static CPLMutex *hRBLock = NULL;
-#define INITIALIZE_LOCK CPLMutexHolderD( &hRBLock )
-#define TAKE_LOCK       CPLMutexHolderOptionalLockD( hRBLock )
-#define DESTROY_LOCK    CPLDestroyMutex( hRBLock )
+#define INITIALIZE_LOCK(psLRU)  CPLMutexHolderD( &((psLRU)->hLock) )
+#define TAKE_LOCK(psLRU)        CPLMutexHolderOptionalLockD( (psLRU)->hLock )
+#define DESTROY_LOCK(psLRU)     CPLDestroyMutex( (psLRU)->hLock )
 #else
 
-static CPLLock* hRBLock = NULL;
 static bool bDebugContention = false;
 static bool bSleepsForBockCacheDebug = false;
 static CPLLockType GetLockType()
@@ -89,13 +112,97 @@ static CPLLockType GetLockType()
     return (CPLLockType) nLockType;
 }
 
-#define INITIALIZE_LOCK         CPLLockHolderD( &hRBLock, GetLockType() ); \
-                                CPLLockSetDebugPerf(hRBLock, bDebugContention)
-#define TAKE_LOCK               CPLLockHolderOptionalLockD( hRBLock )
-#define DESTROY_LOCK            CPLDestroyLock( hRBLock )
+#define INITIALIZE_LOCK(psLRU)  CPLLockHolderD( &((psLRU)->hLock), \
+                                                GetLockType() ); \
+                                CPLLockSetDebugPerf((psLRU)->hLock, \
+                                                    bDebugContention)
+#define TAKE_LOCK(psLRU)        CPLLockHolderOptionalLockD( (psLRU)->hLock )
+#define DESTROY_LOCK(psLRU)     CPLDestroyLock( (psLRU)->hLock )
 
 #endif
 
+/************************************************************************/
+/*                        InitializeLRUShards()                         */
+/************************************************************************/
+
+// Must be called before any block is inserted in a LRU list, since the
+// number of shards cannot change afterwards.
+static void InitializeLRUShards()
+{
+    if( bLRUShardsInitialized )
+        return;
+
+    // GDAL_RB_LRU_SHARDS=ALL_CPUS or an integer value. Default is 1,
+    // that is an exact global LRU.
+    const char* pszShards = CPLGetConfigOption("GDAL_RB_LRU_SHARDS", "1");
+    int nShards = EQUAL(pszShards, "ALL_CPUS") ? CPLGetNumCPUs()
+                                                : atoi(pszShards);
+    if( nShards < 1 )
+        nShards = 1;
+    else if( nShards > MAX_LRU_SHARDS )
+        nShards = MAX_LRU_SHARDS;
+
+    for( int i = 0; i < nShards; i++ )
+    {
+        INITIALIZE_LOCK(&asLRU[i]);
+    }
+    if( nShards > 1 )
+        CPLDebug("GDAL", "Using %d shards for the block cache LRU", nShards);
+    nLRUShards = nShards;
+    bLRUShardsInitialized = true;
+}
+
+/************************************************************************/
+/*                               GetLRU()                               */
+/************************************************************************/
+
+static GDALRasterBlockLRU* GetLRU( const GDALRasterBand* poBand )
+{
+    if( nLRUShards == 1 )
+        return &asLRU[0];
+    // The low order bits of the pointer are not significant due to the
+    // alignment of allocations.
+    size_t nHash = reinterpret_cast<size_t>(poBand) >> 4;
+    nHash ^= nHash >> 7;
+    return &asLRU[nHash % static_cast<size_t>(nLRUShards)];
+}
+
+/************************************************************************/
+/*                           GetCacheUsed()                             */
+/************************************************************************/
+
+// Shards other than the one we have locked (if any) are read without
+// taking their lock, so the result may be slightly inaccurate.
+static GIntBig GetCacheUsed()
+{
+    GIntBig nUsed = asLRU[0].nCacheUsed;
+    for( int i = 1; i < nLRUShards; i++ )
+        nUsed += asLRU[i].nCacheUsed;
+    return nUsed;
+}
+
+/************************************************************************/
+/*                           GetVictimLRU()                             */
+/************************************************************************/
+
+// Select the shard from which blocks must be evicted to make room for a
+// block of psLRU: psLRU itself if it holds more than its share of the
+// cache, otherwise the largest shard.
+static GDALRasterBlockLRU* GetVictimLRU( GDALRasterBlockLRU* psLRU,
+                                         GIntBig nCurCacheMax )
+{
+    if( nLRUShards == 1 ||
+        psLRU->nCacheUsed > nCurCacheMax / nLRUShards )
+        return psLRU;
+    GDALRasterBlockLRU* psVictim = psLRU;
+    for( int i = 0; i < nLRUShards; i++ )
+    {
+        if( asLRU[i].nCacheUsed > psVictim->nCacheUsed )
+            psVictim = &asLRU[i];
+    }
+    return psVictim;
+}
+
 //#define ENABLE_DEBUG
 
 /************************************************************************/
@@ -151,9 +258,7 @@ void CPL_STDCALL GDALSetCacheMax64( GIntBig nNewSizeInBytes )
     }
 #endif
 
-    {
-        INITIALIZE_LOCK;
-    }
+    InitializeLRUShards();
     bCacheMaxInitialized = true;
     nCacheMax = nNewSizeInBytes;
 
@@ -161,13 +266,13 @@ void CPL_STDCALL GDALSetCacheMax64( GIntBig nNewSizeInBytes )
 /*      Flush blocks till we are under the new limit or till we         */
 /*      can't seem to flush anymore.                                    */
 /* -------------------------------------------------------------------- */
-    while( nCacheUsed > nCacheMax )
+    while( GetCacheUsed() > nCacheMax )
     {
-        const GIntBig nOldCacheUsed = nCacheUsed;
+        const GIntBig nOldCacheUsed = GetCacheUsed();
 
         GDALFlushCacheBlock();
 
-        if( nCacheUsed == nOldCacheUsed )
+        if( GetCacheUsed() == nOldCacheUsed )
             break;
     }
 }
@@ -237,9 +342,7 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
 {
     if( !bCacheMaxInitialized )
     {
-        {
-            INITIALIZE_LOCK;
-        }
+        InitializeLRUShards();
         bSleepsForBockCacheDebug = CPLTestBool(
             CPLGetConfigOption("GDAL_DEBUG_BLOCK_CACHE", "NO"));
 
@@ -321,6 +424,7 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
 
 int CPL_STDCALL GDALGetCacheUsed()
 {
+    const GIntBig nCacheUsed = GetCacheUsed();
     if (nCacheUsed > INT_MAX)
     {
         static bool bHasWarned = false;
@@ -349,7 +453,7 @@ int CPL_STDCALL GDALGetCacheUsed()
  * @since GDAL 1.8.0
  */
 
-GIntBig CPL_STDCALL GDALGetCacheUsed64() { return nCacheUsed; }
+GIntBig CPL_STDCALL GDALGetCacheUsed64() { return GetCacheUsed(); }
 
 /************************************************************************/
 /*                        GDALFlushCacheBlock()                         */
@@ -388,6 +492,13 @@ int CPL_STDCALL GDALFlushCacheBlock()
  * a least recently used (LRU) list and an upper cache limit (see
  * GDALSetCacheMax()) under which the cache size is normally kept.
  *
+ * When many threads access different bands concurrently, the LRU list can be
+ * split into several shards, each with its own lock, by setting the
+ * GDAL_RB_LRU_SHARDS configuration option to the number of shards (up to 64)
+ * or to ALL_CPUS, before the first use of the cache. The LRU order is then
+ * only approximate, and the cache limit is a soft global limit. The default
+ * value of 1 keeps a single exact LRU list.
+ *
  * Some blocks in the cache may be modified relative to the state on disk
  * (they are marked "Dirty") and must be flushed to disk before they can
  * be discarded.  Other (Clean) blocks may just be discarded if their memory
@@ -428,11 +539,22 @@ int CPL_STDCALL GDALFlushCacheBlock()
 int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
 
 {
-    GDALRasterBlock *poTarget;
+    GDALRasterBlock *poTarget = NULL;
 
+    InitializeLRUShards();
+
+    // With several shards, start from a different shard at each call, so
+    // that successive calls spread the evictions.
+    static volatile int nNextShard = 0;
+    const int iFirstShard = nLRUShards == 1 ? 0 :
+        static_cast<int>(static_cast<unsigned>(CPLAtomicInc(&nNextShard)) %
+                         static_cast<unsigned>(nLRUShards));
+    for( int iIter = 0; iIter < nLRUShards && poTarget == NULL; iIter++ )
     {
-        INITIALIZE_LOCK;
-        poTarget = poOldest;
+        GDALRasterBlockLRU* psLRU =
+            &asLRU[(iFirstShard + iIter) % nLRUShards];
+        TAKE_LOCK(psLRU);
+        poTarget = psLRU->poOldest;
 
         while( poTarget != NULL )
         {
@@ -446,7 +568,7 @@ int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
         }
 
         if( poTarget == NULL )
-            return FALSE;
+            continue;
         if( bSleepsForBockCacheDebug )
             CPLSleep(CPLAtof(
                 CPLGetConfigOption(
@@ -456,6 +578,9 @@ int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
         poTarget->GetBand()->UnreferenceBlock(poTarget);
     }
 
+    if( poTarget == NULL )
+        return FALSE;
+
     if( bSleepsForBockCacheDebug )
         CPLSleep(CPLAtof(
             CPLGetConfigOption("GDAL_RB_FLUSHBLOCK_SLEEP_AFTER_RB_LOCK", "0")));
@@ -647,19 +772,21 @@ void GDALRasterBlock::Detach()
 {
     if( bMustDetach )
     {
-        TAKE_LOCK;
+        TAKE_LOCK(GetLRU(poBand));
         Detach_unlocked();
     }
 }
 
 void GDALRasterBlock::Detach_unlocked()
 {
-    if( poOldest == this )
-        poOldest = poPrevious;
+    GDALRasterBlockLRU* psLRU = GetLRU(poBand);
 
-    if( poNewest == this )
+    if( psLRU->poOldest == this )
+        psLRU->poOldest = poPrevious;
+
+    if( psLRU->poNewest == this )
     {
-        poNewest = poNext;
+        psLRU->poNewest = poNext;
     }
 
     if( poPrevious != NULL )
@@ -673,7 +800,7 @@ void GDALRasterBlock::Detach_unlocked()
     bMustDetach = false;
 
     if( pData )
-        nCacheUsed -= GetBlockSize();
+        psLRU->nCacheUsed -= GetBlockSize();
 
 #ifdef ENABLE_DEBUG
     Verify();
@@ -693,27 +820,32 @@ void GDALRasterBlock::Detach_unlocked()
 void GDALRasterBlock::Verify()
 
 {
-    TAKE_LOCK;
-
-    CPLAssert( (poNewest == NULL && poOldest == NULL)
-               || (poNewest != NULL && poOldest != NULL) );
-
-    if( poNewest != NULL )
+    for( int i = 0; i < nLRUShards; i++ )
     {
-        CPLAssert( poNewest->poPrevious == NULL );
-        CPLAssert( poOldest->poNext == NULL );
+        GDALRasterBlockLRU* psLRU = &asLRU[i];
+        TAKE_LOCK(psLRU);
 
-        GDALRasterBlock* poLast = NULL;
-        for( GDALRasterBlock *poBlock = poNewest;
-             poBlock != NULL;
-             poBlock = poBlock->poNext )
+        CPLAssert( (psLRU->poNewest == NULL && psLRU->poOldest == NULL)
+                   || (psLRU->poNewest != NULL && psLRU->poOldest != NULL) );
+
+        if( psLRU->poNewest != NULL )
         {
-            CPLAssert( poBlock->poPrevious == poLast );
+            CPLAssert( psLRU->poNewest->poPrevious == NULL );
+            CPLAssert( psLRU->poOldest->poNext == NULL );
 
-            poLast = poBlock;
-        }
+            GDALRasterBlock* poLast = NULL;
+            for( GDALRasterBlock *poBlock = psLRU->poNewest;
+                 poBlock != NULL;
+                 poBlock = poBlock->poNext )
+            {
+                CPLAssert( poBlock->poPrevious == poLast );
+                CPLAssert( GetLRU(poBlock->poBand) == psLRU );
+
+                poLast = poBlock;
+            }
 
-        CPLAssert( poOldest == poLast );
+            CPLAssert( psLRU->poOldest == poLast );
+        }
     }
 }
 
@@ -724,8 +856,8 @@ void GDALRasterBlock::Verify() {}
 #ifdef notdef
 void GDALRasterBlock::CheckNonOrphanedBlocks( GDALRasterBand* poBand )
 {
-    TAKE_LOCK;
-    for( GDALRasterBlock *poBlock = poNewest;
+    TAKE_LOCK(GetLRU(poBand));
+    for( GDALRasterBlock *poBlock = GetLRU(poBand)->poNewest;
                           poBlock != NULL;
                           poBlock = poBlock->poNext )
     {
@@ -798,24 +930,28 @@ CPLErr GDALRasterBlock::Write()
 void GDALRasterBlock::Touch()
 
 {
+    GDALRasterBlockLRU* psLRU = GetLRU(poBand);
+
     // Can be safely tested outside the lock
-    if( poNewest == this )
+    if( psLRU->poNewest == this )
         return;
 
-    TAKE_LOCK;
+    TAKE_LOCK(psLRU);
     Touch_unlocked();
 }
 
 void GDALRasterBlock::Touch_unlocked()
 
 {
+    GDALRasterBlockLRU* psLRU = GetLRU(poBand);
+
     // Could happen even if tested in Touch() before taking the lock
     // Scenario would be :
     // 0. this is the second block (the one pointed by poNewest->poNext)
     // 1. Thread 1 calls Touch() and poNewest != this at that point
     // 2. Thread 2 detaches poNewest
     // 3. Thread 1 arrives here
-    if( poNewest == this )
+    if( psLRU->poNewest == this )
         return;
 
     // In theory, we should not try to touch a block that has been detached.
@@ -823,13 +959,13 @@ void GDALRasterBlock::Touch_unlocked()
     if( !bMustDetach )
     {
         if( pData )
-            nCacheUsed += GetBlockSize();
+            psLRU->nCacheUsed += GetBlockSize();
 
         bMustDetach = true;
     }
 
-    if( poOldest == this )
-        poOldest = this->poPrevious;
+    if( psLRU->poOldest == this )
+        psLRU->poOldest = this->poPrevious;
 
     if( poPrevious != NULL )
         poPrevious->poNext = poNext;
@@ -838,19 +974,19 @@ void GDALRasterBlock::Touch_unlocked()
         poNext->poPrevious = poPrevious;
 
     poPrevious = NULL;
-    poNext = poNewest;
+    poNext = psLRU->poNewest;
 
-    if( poNewest != NULL )
+    if( psLRU->poNewest != NULL )
     {
-        CPLAssert( poNewest->poPrevious == NULL );
-        poNewest->poPrevious = this;
+        CPLAssert( psLRU->poNewest->poPrevious == NULL );
+        psLRU->poNewest->poPrevious = this;
     }
-    poNewest = this;
+    psLRU->poNewest = this;
 
-    if( poOldest == NULL )
+    if( psLRU->poOldest == NULL )
     {
         CPLAssert( poPrevious == NULL && poNext == NULL );
-        poOldest = this;
+        psLRU->poOldest = this;
     }
 #ifdef ENABLE_DEBUG
     Verify();
@@ -879,30 +1015,50 @@ CPLErr GDALRasterBlock::Internalize()
 
     void        *pNewData = NULL;
 
-    // This call will initialize the hRBLock mutex. Other call places can
-    // only be called if we have go through there.
+    // This call will initialize the LRU shard mutexes. Other call places
+    // can only be called if we have go through there.
     const GIntBig nCurCacheMax = GDALGetCacheMax64();
 
+    GDALRasterBlockLRU* const psLRU = GetLRU(poBand);
+
     // No risk of overflow as it is checked in GDALRasterBand::InitBlockInfo().
     const int nSizeInBytes = GetBlockSize();
 
 /* -------------------------------------------------------------------- */
 /*      Flush old blocks if we are nearing our memory limit.            */
 /* -------------------------------------------------------------------- */
-    bool bFirstIter = true;
+    bool bAccounted = false;
     bool bLoopAgain = false;
     do
     {
         bLoopAgain = false;
         GDALRasterBlock* apoBlocksToFree[64] = { NULL };
         int nBlocksToFree = 0;
+
+        // When the LRU is sharded, we may have to evict blocks from another
+        // shard than ours. Never hold two shard locks at the same time.
+        GDALRasterBlockLRU* psVictimLRU = psLRU;
+        if( nLRUShards > 1 )
+        {
+            if( !bAccounted )
+            {
+                TAKE_LOCK(psLRU);
+                psLRU->nCacheUsed += nSizeInBytes;
+                bAccounted = true;
+            }
+            psVictimLRU = GetVictimLRU(psLRU, nCurCacheMax);
+        }
+
         {
-            TAKE_LOCK;
+            TAKE_LOCK(psVictimLRU);
 
-            if( bFirstIter )
-                nCacheUsed += nSizeInBytes;
-            GDALRasterBlock *poTarget = poOldest;
-            while( nCacheUsed > nCurCacheMax )
+            if( !bAccounted )
+            {
+                psLRU->nCacheUsed += nSizeInBytes;
+                bAccounted = true;
+            }
+            GDALRasterBlock *poTarget = psVictimLRU->poOldest;
+            while( GetCacheUsed() > nCurCacheMax )
             {
                 while( poTarget != NULL )
                 {
@@ -931,12 +1087,12 @@ CPLErr GDALRasterBlock::Internalize()
                         // Only free one dirty block at a time so that
                         // other dirty blocks of other bands with the same
                         // coordinates can be found with TryGetLockedBlock()
-                        bLoopAgain = nCacheUsed > nCurCacheMax;
+                        bLoopAgain = GetCacheUsed() > nCurCacheMax;
                         break;
                     }
                     if( nBlocksToFree == 64 )
                     {
-                        bLoopAgain = ( nCacheUsed > nCurCacheMax );
+                        bLoopAgain = ( GetCacheUsed() > nCurCacheMax );
                         break;
                     }
 
@@ -951,11 +1107,15 @@ CPLErr GDALRasterBlock::Internalize()
         /* ------------------------------------------------------------------ */
         /*      Add this block to the list.                                   */
         /* ------------------------------------------------------------------ */
-            if( !bLoopAgain )
+            if( !bLoopAgain && psVictimLRU == psLRU )
                 Touch_unlocked();
         }
 
-        bFirstIter = false;
+        if( !bLoopAgain && psVictimLRU != psLRU )
+        {
+            TAKE_LOCK(psLRU);
+            Touch_unlocked();
+        }
 
         // Now free blocks we have detached and removed from their band.
         for( int i = 0; i < nBlocksToFree; ++i)
@@ -1042,9 +1202,12 @@ void GDALRasterBlock::MarkClean() { bDirty = false; }
 /*! @cond Doxygen_Suppress */
 void GDALRasterBlock::DestroyRBMutex()
 {
-    if( hRBLock != NULL )
-        DESTROY_LOCK;
-    hRBLock = NULL;
+    for( int i = 0; i < MAX_LRU_SHARDS; i++ )
+    {
+        if( asLRU[i].hLock != NULL )
+            DESTROY_LOCK(&asLRU[i]);
+        asLRU[i].hLock = NULL;
+    }
 }
 /*! @endcond */
 
@@ -1085,7 +1248,7 @@ int GDALRasterBlock::TakeLock()
         DropLock();
 
         // wait for the block having been unreferenced
-        TAKE_LOCK;
+        TAKE_LOCK(GetLRU(poBand));
 
         return FALSE;
     }
@@ -1121,7 +1284,7 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 #endif
 
     // Wait for the block for having been unreferenced.
-    TAKE_LOCK;
+    TAKE_LOCK(GetLRU(poBand));
 
     return FALSE;
 }
@@ -1130,14 +1293,17 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 void GDALRasterBlock::DumpAll()
 {
     int iBlock = 0;
-    for( GDALRasterBlock *poBlock = poNewest;
-         poBlock != NULL;
-         poBlock = poBlock->poNext )
+    for( int i = 0; i < nLRUShards; i++ )
     {
-        printf("Block %d\n", iBlock);/*ok*/
-        poBlock->DumpBlock();
-        printf("\n");/*ok*/
-        iBlock++;
+        for( GDALRasterBlock *poBlock = asLRU[i].poNewest;
+             poBlock != NULL;
+             poBlock = poBlock->poNext )
+        {
+            printf("Block %d\n", iBlock);/*ok*/
+            poBlock->DumpBlock();
+            printf("\n");/*ok*/
+            iBlock++;
+        }
     }
 }
 
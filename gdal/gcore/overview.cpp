@@ -35,13 +35,16 @@
 #include <cstdlib>
 
 #include <algorithm>
+#include <deque>
 #include <limits>
 #include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_progress.h"
+#include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 // TODO(schwehr): Fix warning: Software emulation of SSE2.
 // #include "gdalsse_priv.h"
@@ -2518,6 +2521,467 @@ GDALDataType GDALGetOvrWorkDataType( const char* pszResampling,
     return GDT_Float32;
 }
 
+namespace {
+
+/************************************************************************/
+/*                       GDALOverviewBufferBand                         */
+/*                                                                      */
+/*      Stand-in for an overview band that captures, in memory, the     */
+/*      window written by a resampling function.  This enables the      */
+/*      resampling to run in a worker thread, whereas the actual write  */
+/*      into the overview band is done later by the calling thread.     */
+/************************************************************************/
+
+class GDALOverviewBufferBand : public GDALRasterBand
+{
+    GDALRasterBand *poTargetBand;
+    int             nWinXOff;
+    int             nWinYOff;
+    int             nWinXSize;
+    int             nWinYSize;
+    GByte          *pabyBuffer;
+
+  protected:
+    virtual CPLErr IReadBlock( int, int, void * ) override;
+    virtual CPLErr IRasterIO( GDALRWFlag, int, int, int, int,
+                              void *, int, int, GDALDataType,
+                              GSpacing, GSpacing,
+                              GDALRasterIOExtraArg* psExtraArg ) override;
+
+  public:
+                    GDALOverviewBufferBand( GDALRasterBand* poTargetBandIn,
+                                            int nXOff, int nYOff,
+                                            int nXSize, int nYSize );
+    virtual        ~GDALOverviewBufferBand();
+
+    bool            IsValid() const
+        { return pabyBuffer != NULL || nWinXSize == 0 || nWinYSize == 0; }
+    CPLErr          WriteToTarget();
+};
+
+/************************************************************************/
+/*                      GDALOverviewBufferBand()                        */
+/************************************************************************/
+
+GDALOverviewBufferBand::GDALOverviewBufferBand(
+    GDALRasterBand* poTargetBandIn, int nXOff, int nYOff,
+    int nXSize, int nYSize ) :
+    // Cached I/O must never be forced, since IRasterIO() is what
+    // captures the writes.
+    GDALRasterBand(FALSE),
+    poTargetBand(poTargetBandIn),
+    nWinXOff(nXOff),
+    nWinYOff(nYOff),
+    nWinXSize(std::max(0, nXSize)),
+    nWinYSize(std::max(0, nYSize)),
+    pabyBuffer(NULL)
+{
+    nRasterXSize = poTargetBand->GetXSize();
+    nRasterYSize = poTargetBand->GetYSize();
+    eDataType = poTargetBand->GetRasterDataType();
+    nBlockXSize = nRasterXSize;
+    nBlockYSize = 1;
+
+    // The convolution based resampling functions use NBITS to clamp values.
+    const char* pszNBITS =
+        poTargetBand->GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
+    if( pszNBITS != NULL )
+        SetMetadataItem("NBITS", pszNBITS, "IMAGE_STRUCTURE");
+
+    if( nWinXSize > 0 && nWinYSize > 0 )
+    {
+        pabyBuffer = static_cast<GByte*>(
+            VSI_CALLOC_VERBOSE( static_cast<size_t>(nWinXSize) * nWinYSize,
+                                GDALGetDataTypeSizeBytes(eDataType) ) );
+    }
+}
+
+/************************************************************************/
+/*                     ~GDALOverviewBufferBand()                        */
+/************************************************************************/
+
+GDALOverviewBufferBand::~GDALOverviewBufferBand()
+{
+    VSIFree(pabyBuffer);
+}
+
+/************************************************************************/
+/*                             IReadBlock()                             */
+/************************************************************************/
+
+CPLErr GDALOverviewBufferBand::IReadBlock( int, int, void * )
+{
+    CPLAssert(false);
+    return CE_Failure;
+}
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr GDALOverviewBufferBand::IRasterIO( GDALRWFlag eRWFlag,
+                                          int nXOff, int nYOff,
+                                          int nXSize, int nYSize,
+                                          void * pData,
+                                          int nBufXSize, int nBufYSize,
+                                          GDALDataType eBufType,
+                                          GSpacing nPixelSpace,
+                                          GSpacing nLineSpace,
+                                          GDALRasterIOExtraArg* /*psExtraArg*/ )
+{
+    if( eRWFlag != GF_Write || nXSize != nBufXSize || nYSize != nBufYSize ||
+        nXOff < nWinXOff || nXOff + nXSize > nWinXOff + nWinXSize ||
+        nYOff < nWinYOff || nYOff + nYSize > nWinYOff + nWinYSize )
+    {
+        CPLError( CE_Failure, CPLE_NotSupported,
+                  "GDALOverviewBufferBand::IRasterIO(): unexpected request" );
+        return CE_Failure;
+    }
+
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
+    for( int iY = 0; iY < nYSize; ++iY )
+    {
+        GDALCopyWords(
+            static_cast<GByte*>(pData) + iY * nLineSpace,
+            eBufType, static_cast<int>(nPixelSpace),
+            pabyBuffer +
+                (static_cast<size_t>(nYOff + iY - nWinYOff) * nWinXSize +
+                 nXOff - nWinXOff) * nDTSize,
+            eDataType, nDTSize,
+            nXSize );
+    }
+    return CE_None;
+}
+
+/************************************************************************/
+/*                           WriteToTarget()                            */
+/************************************************************************/
+
+CPLErr GDALOverviewBufferBand::WriteToTarget()
+{
+    if( pabyBuffer == NULL )
+        return CE_None;
+    return poTargetBand->RasterIO( GF_Write,
+                                   nWinXOff, nWinYOff, nWinXSize, nWinYSize,
+                                   pabyBuffer, nWinXSize, nWinYSize,
+                                   eDataType, 0, 0, NULL );
+}
+
+/************************************************************************/
+/*                         GDALOverviewJob                              */
+/*                                                                      */
+/*      Resampling work done on a chunk of source data that has         */
+/*      already been read.  A job owns its source buffers and the       */
+/*      GDALOverviewBufferBand where the result of each of its tasks    */
+/*      goes.                                                           */
+/************************************************************************/
+
+struct GDALOverviewResampleTask
+{
+    GDALResampleFunction    pfnResampleFn;  // NULL for complex data.
+    double                  dfXRatioDstToSrc;
+    double                  dfYRatioDstToSrc;
+    GDALDataType            eWrkDataType;
+    void                   *pChunk;
+    GByte                  *pabyChunkNoDataMask;
+    int                     nSrcWidth;
+    int                     nSrcHeight;
+    int                     nChunkXOff;
+    int                     nChunkXSize;
+    int                     nChunkYOff;
+    int                     nChunkYSize;
+    int                     nDstXOff;
+    int                     nDstXOff2;
+    int                     nDstYOff;
+    int                     nDstYOff2;
+    GDALOverviewBufferBand *poDstBand;
+    const char             *pszResampling;
+    int                     bHasNoData;
+    float                   fNoDataValue;
+    GDALColorTable         *poColorTable;
+    GDALDataType            eSrcDataType;
+};
+
+// Error or warning emitted by a job in a worker thread, to be emitted
+// again by the calling thread.
+struct GDALOverviewJobError
+{
+    CPLErr      eErrClass;
+    CPLErrorNum nErrNo;
+    CPLString   osMsg;
+};
+
+class GDALOverviewJobQueue;
+
+struct GDALOverviewJob
+{
+    GDALOverviewJobQueue                 *poQueue;
+    std::vector<void*>                    apBuffers;
+    std::vector<GDALOverviewResampleTask> asTasks;
+    CPLErr                                eErr;
+    std::vector<GDALOverviewJobError>     asErrors;
+    bool                                  bFinished;
+
+    GDALOverviewJob() : poQueue(NULL), eErr(CE_None), bFinished(false) {}
+    ~GDALOverviewJob()
+    {
+        for( size_t i = 0; i < apBuffers.size(); ++i )
+            VSIFree(apBuffers[i]);
+        for( size_t i = 0; i < asTasks.size(); ++i )
+            delete asTasks[i].poDstBand;
+    }
+
+    void Run();
+};
+
+/************************************************************************/
+/*                        GDALOverviewJobQueue                          */
+/*                                                                      */
+/*      Runs GDALOverviewJob on a pool of worker threads, while the     */
+/*      calling thread goes on reading the next source chunks.  The     */
+/*      results are written to the overview bands by the calling        */
+/*      thread, in submission order.                                    */
+/************************************************************************/
+
+class GDALOverviewJobQueue
+{
+    CPLWorkerThreadPool          *poPool;
+    CPLMutex                     *hMutex;
+    CPLCond                      *hCond;
+    std::deque<GDALOverviewJob*>  apoJobs;
+    size_t                        nMaxPendingJobs;
+
+    static void  ProcessJobFunc( void* pData );
+    static void CPL_STDCALL JobErrorHandler( CPLErr eErrClass,
+                                             CPLErrorNum nErrNo,
+                                             const char* pszMsg );
+    CPLErr       CollectOldestJob( bool bWrite );
+
+                 GDALOverviewJobQueue();
+
+  public:
+                ~GDALOverviewJobQueue();
+
+    static GDALOverviewJobQueue* Create();
+
+    CPLErr       Submit( GDALOverviewJob* psJob );
+    CPLErr       WaitAll( CPLErr eErr );
+};
+
+/************************************************************************/
+/*                        GDALOverviewJob::Run()                        */
+/************************************************************************/
+
+void GDALOverviewJob::Run()
+{
+    for( size_t i = 0; i < asTasks.size() && eErr == CE_None; ++i )
+    {
+        const GDALOverviewResampleTask& sTask = asTasks[i];
+        if( !sTask.poDstBand->IsValid() )
+        {
+            eErr = CE_Failure;
+        }
+        else if( sTask.pfnResampleFn != NULL )
+        {
+            eErr = sTask.pfnResampleFn(
+                sTask.dfXRatioDstToSrc, sTask.dfYRatioDstToSrc,
+                0.0, 0.0,
+                sTask.eWrkDataType,
+                sTask.pChunk,
+                sTask.pabyChunkNoDataMask,
+                sTask.nChunkXOff, sTask.nChunkXSize,
+                sTask.nChunkYOff, sTask.nChunkYSize,
+                sTask.nDstXOff, sTask.nDstXOff2,
+                sTask.nDstYOff, sTask.nDstYOff2,
+                sTask.poDstBand, sTask.pszResampling,
+                sTask.bHasNoData, sTask.fNoDataValue, sTask.poColorTable,
+                sTask.eSrcDataType );
+        }
+        else
+        {
+            eErr = GDALResampleChunkC32R(
+                sTask.nSrcWidth, sTask.nSrcHeight,
+                static_cast<float*>(sTask.pChunk),
+                sTask.nChunkYOff, sTask.nChunkYSize,
+                sTask.nDstYOff, sTask.nDstYOff2,
+                sTask.poDstBand, sTask.pszResampling );
+        }
+    }
+}
+
+/************************************************************************/
+/*                       GDALOverviewJobQueue()                         */
+/************************************************************************/
+
+GDALOverviewJobQueue::GDALOverviewJobQueue() :
+    poPool(NULL),
+    hMutex(NULL),
+    hCond(NULL),
+    nMaxPendingJobs(0)
+{}
+
+/************************************************************************/
+/*                      ~GDALOverviewJobQueue()                         */
+/************************************************************************/
+
+GDALOverviewJobQueue::~GDALOverviewJobQueue()
+{
+    WaitAll(CE_Failure);
+    delete poPool;
+    if( hCond )
+        CPLDestroyCond(hCond);
+    if( hMutex )
+        CPLDestroyMutex(hMutex);
+}
+
+/************************************************************************/
+/*                              Create()                                */
+/*                                                                      */
+/*      Returns NULL if overviews must be computed by the calling       */
+/*      thread only, that is to say if GDAL_NUM_THREADS is not set to   */
+/*      ALL_CPUS or to a value greater than 1.                          */
+/************************************************************************/
+
+GDALOverviewJobQueue* GDALOverviewJobQueue::Create()
+{
+    const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", NULL);
+    if( pszThreads == NULL )
+        return NULL;
+    int nThreads = EQUAL(pszThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                   atoi(pszThreads);
+    if( nThreads > 128 )
+        nThreads = 128;
+    if( nThreads <= 1 )
+        return NULL;
+
+    GDALOverviewJobQueue* poQueue = new GDALOverviewJobQueue();
+    poQueue->poPool = new CPLWorkerThreadPool();
+    if( !poQueue->poPool->Setup(nThreads, NULL, NULL) )
+    {
+        delete poQueue;
+        return NULL;
+    }
+    poQueue->hMutex = CPLCreateMutex();
+    CPLReleaseMutex(poQueue->hMutex);
+    poQueue->hCond = CPLCreateCond();
+    // Allow twice as many jobs in flight as there are threads, so that all
+    // workers keep busy while the calling thread does I/O.
+    poQueue->nMaxPendingJobs = 2 * static_cast<size_t>(nThreads);
+    CPLDebug("GDAL", "Using %d threads to compute overviews", nThreads);
+    return poQueue;
+}
+
+/************************************************************************/
+/*                           ProcessJobFunc()                           */
+/************************************************************************/
+
+void GDALOverviewJobQueue::ProcessJobFunc( void* pData )
+{
+    GDALOverviewJob* psJob = static_cast<GDALOverviewJob*>(pData);
+
+    // Errors would otherwise end up in the error state of the worker
+    // thread, so keep them for CollectOldestJob().
+    CPLPushErrorHandlerEx(JobErrorHandler, &psJob->asErrors);
+    CPLSetCurrentErrorHandlerCatchDebug(FALSE);
+    psJob->Run();
+    CPLPopErrorHandler();
+
+    GDALOverviewJobQueue* poQueue = psJob->poQueue;
+    CPLAcquireMutex(poQueue->hMutex, 1000.0);
+    psJob->bFinished = true;
+    CPLCondBroadcast(poQueue->hCond);
+    CPLReleaseMutex(poQueue->hMutex);
+}
+
+/************************************************************************/
+/*                          JobErrorHandler()                           */
+/************************************************************************/
+
+void CPL_STDCALL GDALOverviewJobQueue::JobErrorHandler( CPLErr eErrClass,
+                                                        CPLErrorNum nErrNo,
+                                                        const char* pszMsg )
+{
+    std::vector<GDALOverviewJobError>* pasErrors =
+        static_cast<std::vector<GDALOverviewJobError>*>(
+            CPLGetErrorHandlerUserData());
+    GDALOverviewJobError sError;
+    sError.eErrClass = eErrClass;
+    sError.nErrNo = nErrNo;
+    sError.osMsg = pszMsg;
+    pasErrors->push_back(sError);
+}
+
+/************************************************************************/
+/*                          CollectOldestJob()                          */
+/************************************************************************/
+
+CPLErr GDALOverviewJobQueue::CollectOldestJob( bool bWrite )
+{
+    GDALOverviewJob* psJob = apoJobs.front();
+    apoJobs.pop_front();
+
+    CPLAcquireMutex(hMutex, 1000.0);
+    while( !psJob->bFinished )
+        CPLCondWait(hCond, hMutex);
+    CPLReleaseMutex(hMutex);
+
+    for( size_t i = 0; i < psJob->asErrors.size(); ++i )
+    {
+        CPLError( psJob->asErrors[i].eErrClass, psJob->asErrors[i].nErrNo,
+                  "%s", psJob->asErrors[i].osMsg.c_str() );
+    }
+
+    CPLErr eErr = psJob->eErr;
+    for( size_t i = 0; bWrite && eErr == CE_None &&
+                       i < psJob->asTasks.size(); ++i )
+    {
+        eErr = psJob->asTasks[i].poDstBand->WriteToTarget();
+    }
+    delete psJob;
+    return eErr;
+}
+
+/************************************************************************/
+/*                               Submit()                               */
+/************************************************************************/
+
+CPLErr GDALOverviewJobQueue::Submit( GDALOverviewJob* psJob )
+{
+    CPLErr eErr = CE_None;
+    while( apoJobs.size() >= nMaxPendingJobs && eErr == CE_None )
+        eErr = CollectOldestJob(true);
+    if( eErr != CE_None )
+    {
+        delete psJob;
+        return eErr;
+    }
+
+    psJob->poQueue = this;
+    apoJobs.push_back(psJob);
+    poPool->SubmitJob(ProcessJobFunc, psJob);
+    return CE_None;
+}
+
+/************************************************************************/
+/*                              WaitAll()                               */
+/*                                                                      */
+/*      Waits for all submitted jobs and writes their results if eErr    */
+/*      is CE_None.  Returns the resulting error status.                */
+/************************************************************************/
+
+CPLErr GDALOverviewJobQueue::WaitAll( CPLErr eErr )
+{
+    while( !apoJobs.empty() )
+    {
+        const CPLErr eJobErr = CollectOldestJob(eErr == CE_None);
+        if( eErr == CE_None )
+            eErr = eJobErr;
+    }
+    return eErr;
+}
+
+}  // namespace
+
 /************************************************************************/
 /*                      GDALRegenerateOverviews()                       */
 /************************************************************************/
@@ -2723,6 +3187,12 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
     const float fNoDataValue =
         static_cast<float>( poSrcBand->GetNoDataValue(&bHasNoData) );
 
+/* -------------------------------------------------------------------- */
+/*      If GDAL_NUM_THREADS is set, resample the chunks in worker       */
+/*      threads.  Each chunk then needs its own buffers.                */
+/* -------------------------------------------------------------------- */
+    GDALOverviewJobQueue* poJobQueue = GDALOverviewJobQueue::Create();
+
 /* -------------------------------------------------------------------- */
 /*      Loop over image operating on chunks.                            */
 /* -------------------------------------------------------------------- */
@@ -2740,6 +3210,23 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
             eErr = CE_Failure;
         }
 
+        if( pChunk == NULL )
+        {
+            pChunk = VSI_MALLOC3_VERBOSE(
+                GDALGetDataTypeSizeBytes(eType), nMaxChunkYSizeQueried,
+                nWidth );
+            if( bUseNoDataMask )
+            {
+                pabyChunkNodataMask = static_cast<GByte*>(
+                    VSI_MALLOC2_VERBOSE( nMaxChunkYSizeQueried, nWidth ) );
+            }
+            if( pChunk == NULL ||
+                (bUseNoDataMask && pabyChunkNodataMask == NULL) )
+            {
+                eErr = CE_Failure;
+            }
+        }
+
         if( nFullResYChunk + nChunkYOff > nHeight )
             nFullResYChunk = nHeight - nChunkYOff;
 
@@ -2767,7 +3254,11 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
                 0, 0, NULL );
 
         // Special case to promote 1bit data to 8bit 0/255 values.
-        if( EQUAL(pszResampling, "AVERAGE_BIT2GRAYSCALE") )
+        if( eErr != CE_None )
+        {
+            // Nothing to do.
+        }
+        else if( EQUAL(pszResampling, "AVERAGE_BIT2GRAYSCALE") )
         {
             if( eType == GDT_Float32 )
             {
@@ -2840,6 +3331,15 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
             }
         }
 
+        GDALOverviewJob* psJob = NULL;
+        if( poJobQueue != NULL && eErr == CE_None )
+        {
+            psJob = new GDALOverviewJob();
+            psJob->apBuffers.push_back(pChunk);
+            if( pabyChunkNodataMask != NULL )
+                psJob->apBuffers.push_back(pabyChunkNodataMask);
+        }
+
         for( int iOverview = 0;
              iOverview < nOverviewCount && eErr == CE_None;
              ++iOverview )
@@ -2869,9 +3369,39 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
                       "nDstYOff=%d, nDstYOff2=%d", nDstYOff, nDstYOff2 );
 #endif
 
-            if( eType == GDT_Byte ||
-                eType == GDT_UInt16 ||
-                eType == GDT_Float32 )
+            const bool bComplex = !(eType == GDT_Byte ||
+                                    eType == GDT_UInt16 ||
+                                    eType == GDT_Float32);
+            if( psJob != NULL )
+            {
+                GDALOverviewResampleTask sTask;
+                sTask.pfnResampleFn = bComplex ? NULL : pfnResampleFn;
+                sTask.dfXRatioDstToSrc = dfXRatioDstToSrc;
+                sTask.dfYRatioDstToSrc = dfYRatioDstToSrc;
+                sTask.eWrkDataType = eType;
+                sTask.pChunk = pChunk;
+                sTask.pabyChunkNoDataMask = pabyChunkNodataMask;
+                sTask.nSrcWidth = nWidth;
+                sTask.nSrcHeight = nHeight;
+                sTask.nChunkXOff = 0;
+                sTask.nChunkXSize = nWidth;
+                sTask.nChunkYOff = nChunkYOffQueried;
+                sTask.nChunkYSize = nChunkYSizeQueried;
+                sTask.nDstXOff = 0;
+                sTask.nDstXOff2 = nDstWidth;
+                sTask.nDstYOff = nDstYOff;
+                sTask.nDstYOff2 = nDstYOff2;
+                sTask.poDstBand = new GDALOverviewBufferBand(
+                    papoOvrBands[iOverview],
+                    0, nDstYOff, nDstWidth, nDstYOff2 - nDstYOff );
+                sTask.pszResampling = pszResampling;
+                sTask.bHasNoData = bHasNoData;
+                sTask.fNoDataValue = fNoDataValue;
+                sTask.poColorTable = poColorTable;
+                sTask.eSrcDataType = poSrcBand->GetRasterDataType();
+                psJob->asTasks.push_back(sTask);
+            }
+            else if( !bComplex )
                 eErr = pfnResampleFn(
                     dfXRatioDstToSrc, dfYRatioDstToSrc,
                     0.0, 0.0,
@@ -2893,6 +3423,23 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
                     nDstYOff, nDstYOff2,
                     papoOvrBands[iOverview], pszResampling);
         }
+
+        if( psJob != NULL )
+        {
+            // The job now owns the chunk buffers.
+            pChunk = NULL;
+            pabyChunkNodataMask = NULL;
+            if( eErr == CE_None )
+                eErr = poJobQueue->Submit(psJob);
+            else
+                delete psJob;
+        }
+    }
+
+    if( poJobQueue != NULL )
+    {
+        eErr = poJobQueue->WaitAll(eErr);
+        delete poJobQueue;
     }
 
     VSIFree( pChunk );
@@ -2926,6 +3473,47 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
     return eErr;
 }
 
+/************************************************************************/
+/*                    GDALAllocateOverviewChunks()                      */
+/************************************************************************/
+
+static bool GDALAllocateOverviewChunks( int nBands, void** papaChunk,
+                                        GByte** ppabyChunkNoDataMask,
+                                        int nChunkXSize, int nChunkYSize,
+                                        GDALDataType eWrkDataType )
+{
+    for( int iBand = 0; iBand < nBands; ++iBand )
+    {
+        papaChunk[iBand] = VSI_MALLOC3_VERBOSE(
+            nChunkXSize, nChunkYSize,
+            GDALGetDataTypeSizeBytes(eWrkDataType) );
+        if( papaChunk[iBand] == NULL )
+        {
+            while ( --iBand >= 0)
+            {
+                CPLFree(papaChunk[iBand]);
+                papaChunk[iBand] = NULL;
+            }
+            return false;
+        }
+    }
+    if( ppabyChunkNoDataMask != NULL )
+    {
+        *ppabyChunkNoDataMask = static_cast<GByte *>(
+            VSI_MALLOC2_VERBOSE( nChunkXSize, nChunkYSize ) );
+        if( *ppabyChunkNoDataMask == NULL )
+        {
+            for( int iBand = 0; iBand < nBands; ++iBand )
+            {
+                CPLFree(papaChunk[iBand]);
+                papaChunk[iBand] = NULL;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
 /************************************************************************/
 /*            GDALRegenerateOverviewsMultiBand()                        */
 /************************************************************************/
@@ -3110,6 +3698,10 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
             papoSrcBands[iBand]->GetNoDataValue(&pabHasNoData[iBand]) );
     }
 
+    // If GDAL_NUM_THREADS is set, resample the blocks in worker threads.
+    // Each block then needs its own buffers.
+    GDALOverviewJobQueue* poJobQueue = GDALOverviewJobQueue::Create();
+
     // Second pass to do the real job.
     double dfCurPixelCount = 0;
     CPLErr eErr = CE_None;
@@ -3158,46 +3750,27 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
             nFullResYChunk + 2 * nKernelRadius * nOvrFactor;
 
         void** papaChunk = static_cast<void **>(
-            VSI_MALLOC_VERBOSE(nBands * sizeof(void*)) );
+            VSI_CALLOC_VERBOSE(nBands, sizeof(void*)) );
         if( papaChunk == NULL )
         {
+            delete poJobQueue;
             CPLFree(pabHasNoData);
             CPLFree(pafNoDataValue);
             return CE_Failure;
         }
         GByte* pabyChunkNoDataMask = NULL;
-        for( int iBand = 0; iBand < nBands; ++iBand )
+        if( !GDALAllocateOverviewChunks( nBands, papaChunk,
+                                         bUseNoDataMask ?
+                                            &pabyChunkNoDataMask : NULL,
+                                         nFullResXChunkQueried,
+                                         nFullResYChunkQueried,
+                                         eWrkDataType ) )
         {
-            papaChunk[iBand] = VSI_MALLOC3_VERBOSE(
-                nFullResXChunkQueried,
-                nFullResYChunkQueried,
-                GDALGetDataTypeSizeBytes(eWrkDataType) );
-            if( papaChunk[iBand] == NULL )
-            {
-                while ( --iBand >= 0)
-                    CPLFree(papaChunk[iBand]);
-                CPLFree(papaChunk);
-                CPLFree(pabHasNoData);
-                CPLFree(pafNoDataValue);
-                return CE_Failure;
-            }
-        }
-        if( bUseNoDataMask )
-        {
-            pabyChunkNoDataMask = static_cast<GByte *>(
-                VSI_MALLOC2_VERBOSE( nFullResXChunkQueried,
-                                     nFullResYChunkQueried ) );
-            if( pabyChunkNoDataMask == NULL )
-            {
-                for( int iBand = 0; iBand < nBands; ++iBand )
-                {
-                    CPLFree(papaChunk[iBand]);
-                }
-                CPLFree(papaChunk);
-                CPLFree(pabHasNoData);
-                CPLFree(pafNoDataValue);
-                return CE_Failure;
-            }
+            delete poJobQueue;
+            CPLFree(papaChunk);
+            CPLFree(pabHasNoData);
+            CPLFree(pafNoDataValue);
+            return CE_Failure;
         }
 
         int nDstYOff = 0;
@@ -3282,6 +3855,17 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
                     nDstXOff, nDstYOff, nDstXCount, nDstYCount );
 #endif
 
+                if( papaChunk[0] == NULL &&
+                    !GDALAllocateOverviewChunks( nBands, papaChunk,
+                                                 bUseNoDataMask ?
+                                                    &pabyChunkNoDataMask : NULL,
+                                                 nFullResXChunkQueried,
+                                                 nFullResYChunkQueried,
+                                                 eWrkDataType ) )
+                {
+                    eErr = CE_Failure;
+                }
+
                 // Read the source buffers for all the bands.
                 for( int iBand = 0; iBand < nBands && eErr == CE_None; ++iBand )
                 {
@@ -3315,8 +3899,55 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
                         GDT_Byte, 0, 0, NULL );
                 }
 
-                // Compute the resulting overview block.
-                for( int iBand = 0; iBand < nBands && eErr == CE_None; ++iBand )
+                // Compute the resulting overview block, possibly
+                // deferring it to a worker thread.
+                if( poJobQueue != NULL && eErr == CE_None )
+                {
+                    GDALOverviewJob* psJob = new GDALOverviewJob();
+                    for( int iBand = 0; iBand < nBands; ++iBand )
+                    {
+                        GDALOverviewResampleTask sTask;
+                        sTask.pfnResampleFn = pfnResampleFn;
+                        sTask.dfXRatioDstToSrc = dfXRatioDstToSrc;
+                        sTask.dfYRatioDstToSrc = dfYRatioDstToSrc;
+                        sTask.eWrkDataType = eWrkDataType;
+                        sTask.pChunk = papaChunk[iBand];
+                        sTask.pabyChunkNoDataMask = pabyChunkNoDataMask;
+                        sTask.nSrcWidth = nSrcWidth;
+                        sTask.nSrcHeight = nSrcHeight;
+                        sTask.nChunkXOff = nChunkXOffQueried;
+                        sTask.nChunkXSize = nChunkXSizeQueried;
+                        sTask.nChunkYOff = nChunkYOffQueried;
+                        sTask.nChunkYSize = nChunkYSizeQueried;
+                        sTask.nDstXOff = nDstXOff;
+                        sTask.nDstXOff2 = nDstXOff + nDstXCount;
+                        sTask.nDstYOff = nDstYOff;
+                        sTask.nDstYOff2 = nDstYOff + nDstYCount;
+                        sTask.poDstBand = new GDALOverviewBufferBand(
+                            papapoOverviewBands[iBand][iOverview],
+                            nDstXOff, nDstYOff, nDstXCount, nDstYCount );
+                        sTask.pszResampling = pszResampling;
+                        sTask.bHasNoData = pabHasNoData[iBand];
+                        sTask.fNoDataValue = pafNoDataValue[iBand];
+                        sTask.poColorTable = NULL;
+                        sTask.eSrcDataType = eDataType;
+                        psJob->asTasks.push_back(sTask);
+
+                        // The job now owns the chunk buffers.
+                        psJob->apBuffers.push_back(papaChunk[iBand]);
+                        papaChunk[iBand] = NULL;
+                    }
+                    if( pabyChunkNoDataMask != NULL )
+                    {
+                        psJob->apBuffers.push_back(pabyChunkNoDataMask);
+                        pabyChunkNoDataMask = NULL;
+                    }
+                    eErr = poJobQueue->Submit(psJob);
+                }
+
+                for( int iBand = 0;
+                     iBand < nBands && eErr == CE_None && poJobQueue == NULL;
+                     ++iBand )
                 {
                     eErr = pfnResampleFn(
                         dfXRatioDstToSrc, dfYRatioDstToSrc,
@@ -3340,6 +3971,11 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
             dfCurPixelCount += static_cast<double>(nYCount) * nSrcWidth;
         }
 
+        // The next overview level may be computed from this one, so all
+        // its blocks must have been written.
+        if( poJobQueue != NULL )
+            eErr = poJobQueue->WaitAll(eErr);
+
         // Flush the data to overviews.
         for( int iBand = 0; iBand < nBands; ++iBand )
         {
@@ -3350,6 +3986,7 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
         CPLFree(pabyChunkNoDataMask);
     }
 
+    delete poJobQueue;
     CPLFree(pabHasNoData);
     CPLFree(pafNoDataValue);
 
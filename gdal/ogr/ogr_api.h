@@ -109,6 +109,7 @@ int    CPL_DLL OGR_G_Is3D( OGRGeometryH );
 int    CPL_DLL OGR_G_IsMeasured( OGRGeometryH );
 void   CPL_DLL OGR_G_Set3D( OGRGeometryH, int );
 void   CPL_DLL OGR_G_SetMeasured( OGRGeometryH, int );
+void   CPL_DLL OGR_G_SetGEOSCacheEnabled( OGRGeometryH, int, int );
 OGRGeometryH CPL_DLL OGR_G_Clone( OGRGeometryH ) CPL_WARN_UNUSED_RESULT;
 void   CPL_DLL OGR_G_GetEnvelope( OGRGeometryH, OGREnvelope * );
 void   CPL_DLL OGR_G_GetEnvelope3D( OGRGeometryH, OGREnvelope3D * );
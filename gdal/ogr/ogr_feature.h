@@ -471,6 +471,76 @@ class CPL_DLL OGRFeature
     CPL_DISALLOW_COPY_ASSIGN(OGRFeature)
 };
 
+/************************************************************************/
+/*                           OGRFeatureBatch                            */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+class OGRFeatureBatchPrivate;
+//! @endcond
+
+/**
+ * A batch of features stored column by column.
+ *
+ * Filled by OGRLayer::GetNextFeatureBatch(). Each attribute field is stored
+ * as one contiguous column buffer with a validity bitmap, and each geometry
+ * field as concatenated ISO WKB (little endian) blobs with offsets.
+ *
+ * @since GDAL 2.3
+ */
+
+class CPL_DLL OGRFeatureBatch
+{
+  private:
+    OGRFeatureBatchPrivate *m_poPrivate;
+
+  public:
+                        OGRFeatureBatch();
+                       ~OGRFeatureBatch();
+
+    void                Reset( OGRFeatureDefn *poDefn );
+    OGRFeatureDefn     *GetDefnRef();
+
+    int                 GetFeatureCount() const;
+    const GIntBig      *GetFIDs() const;
+
+    const GByte        *GetFieldValidity( int iField ) const;
+    const void         *GetFieldValues( int iField ) const;
+    const size_t       *GetFieldOffsets( int iField ) const;
+    bool                IsFieldSet( int iFeature, int iField ) const;
+
+    const GByte        *GetGeomFieldValidity( int iGeomField ) const;
+    const GByte        *GetGeomFieldWkb( int iGeomField ) const;
+    const size_t       *GetGeomFieldOffsets( int iGeomField ) const;
+
+    int                 AppendFeature( GIntBig nFID );
+    void                SetFieldInteger( int iField, int nValue );
+    void                SetFieldInteger64( int iField, GIntBig nValue );
+    void                SetFieldDouble( int iField, double dfValue );
+    void                SetFieldString( int iField, const char *pszValue,
+                                        size_t nLen );
+    void                SetFieldBinary( int iField, const GByte *pabyData,
+                                        size_t nLen );
+    void                SetFieldRaw( int iField, const OGRField *psField );
+    void                SetGeomFieldWkb( int iGeomField, const GByte *pabyWkb,
+                                         size_t nLen );
+    OGRErr              SetGeomField( int iGeomField,
+                                      const OGRGeometry *poGeom );
+    OGRErr              SetGeomFieldFromParts( int iGeomField,
+                                               OGRwkbGeometryType eType,
+                                               int nParts,
+                                               const int *panPartStart,
+                                               int nPoints,
+                                               const double *padfX,
+                                               const double *padfY,
+                                               const double *padfZ,
+                                               const double *padfM );
+    OGRErr              AddFeature( OGRFeature *poFeature );
+
+  private:
+    CPL_DISALLOW_COPY_ASSIGN(OGRFeatureBatch)
+};
+
 /************************************************************************/
 /*                           OGRFeatureQuery                            */
 /************************************************************************/
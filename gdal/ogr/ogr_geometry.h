@@ -115,10 +115,18 @@ typedef OGRMultiPolygon* (*OGRPolyhedralSurfaceCastToMultiPolygon)(OGRPolyhedral
  *
  */
 
+//! @cond Doxygen_Suppress
+class OGRGEOSCache;
+//! @endcond
+
 class CPL_DLL OGRGeometry
 {
   private:
     OGRSpatialReference * poSRS;                // may be NULL
+//! @cond Doxygen_Suppress
+    friend class OGRGEOSCache;
+    OGRGEOSCache *m_poGEOSCache;                // may be NULL
+//! @endcond
 
   protected:
 //! @cond Doxygen_Suppress
@@ -216,6 +224,10 @@ class CPL_DLL OGRGeometry
     static void freeGEOSContext( GEOSContextHandle_t hGEOSCtxt );
     virtual GEOSGeom exportToGEOS( GEOSContextHandle_t hGEOSCtxt )
         const CPL_WARN_UNUSED_RESULT;
+    void    setGEOSCacheEnabled( OGRBoolean bEnable,
+                                 OGRBoolean bPrepared = FALSE );
+    /*! Returns whether setGEOSCacheEnabled() enabled the GEOS cache. */
+    OGRBoolean isGEOSCacheEnabled() const { return m_poGEOSCache != NULL; }
     virtual OGRBoolean hasCurveGeometry(int bLookForNonLinear = FALSE) const;
     virtual OGRGeometry* getCurveGeometry(
         const char* const* papszOptions = NULL ) const CPL_WARN_UNUSED_RESULT;
@@ -31,8 +31,14 @@
 #include "ogr_spatialref.h"
 
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 
+#include <algorithm>
+#include <list>
+#include <map>
+#include <vector>
+
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
@@ -109,8 +115,12 @@ static bool      bProjLocaleSafe = false;
 /*                         OCTCleanupProjMutex()                        */
 /************************************************************************/
 
+static void OCTCacheClear();
+
 void OCTCleanupProjMutex()
 {
+    OCTCacheClear();
+
     if( hPROJMutex != NULL )
     {
         CPLDestroyMutex(hPROJMutex);
@@ -118,6 +128,534 @@ void OCTCleanupProjMutex()
     }
 }
 
+/************************************************************************/
+/*                     Cache of transformation setups                   */
+/*                                                                      */
+/*      Creating a transformation requires exporting both SRS to        */
+/*      PROJ.4 strings, and initializing the corresponding PROJ.4       */
+/*      objects. Both are cached, in a process-wide LRU cache keyed by  */
+/*      the WKT of the source and target SRS. A projPJ object, and the  */
+/*      projCtx it is attached to, can only be used by one thread at a  */
+/*      time, so each transformation object takes exclusive ownership   */
+/*      of a set of them, and gives it back to the cache on             */
+/*      destruction so that it can be reused by the next                */
+/*      transformation between the same SRS.                            */
+/************************************************************************/
+
+typedef struct
+{
+    projCtx     pjctx;
+    projPJ      psPJSource;
+    projPJ      psPJTarget;
+} OCTProjHandles;
+
+typedef struct
+{
+    CPLString   osKey;
+    CPLString   osSrcProj4Defn;
+    CPLString   osDstProj4Defn;
+    std::vector<OCTProjHandles> aoIdleHandles;
+} OCTCacheEntry;
+
+typedef std::list<OCTCacheEntry> OCTCacheList;
+
+static CPLMutex *hCTCacheMutex = NULL;
+// Most recently used first.
+static OCTCacheList *poCTCacheList = NULL;
+static std::map<CPLString, OCTCacheList::iterator> *poCTCacheMap = NULL;
+
+// Maximum number of idle PROJ.4 objects kept for each cache entry.
+static const size_t MAX_IDLE_HANDLES_PER_ENTRY = 16;
+
+static int OCTGetCacheSize()
+{
+    return atoi(CPLGetConfigOption("OGR_CT_CACHE_SIZE", "64"));
+}
+
+static void OCTFreeProjHandles( const std::vector<OCTProjHandles>& aoHandles )
+{
+    for( size_t i = 0; i < aoHandles.size(); i++ )
+    {
+        const OCTProjHandles& sHandles = aoHandles[i];
+        if( sHandles.pjctx != NULL )
+        {
+            pfn_pj_free( sHandles.psPJSource );
+            pfn_pj_free( sHandles.psPJTarget );
+            pfn_pj_ctx_free( sHandles.pjctx );
+        }
+        else
+        {
+            CPLMutexHolderD( &hPROJMutex );
+            pfn_pj_free( sHandles.psPJSource );
+            pfn_pj_free( sHandles.psPJTarget );
+        }
+    }
+}
+
+/************************************************************************/
+/*                           OCTCacheLookup()                           */
+/*                                                                      */
+/*      Returns the PROJ.4 definitions cached for osKey, and, if one    */
+/*      is available, a set of initialized PROJ.4 objects that the      */
+/*      caller then owns.                                               */
+/************************************************************************/
+
+static bool OCTCacheLookup( const CPLString& osKey,
+                            CPLString& osSrcProj4Defn,
+                            CPLString& osDstProj4Defn,
+                            OCTProjHandles* psHandles )
+{
+    psHandles->pjctx = NULL;
+    psHandles->psPJSource = NULL;
+    psHandles->psPJTarget = NULL;
+
+    CPLMutexHolderD( &hCTCacheMutex );
+    if( poCTCacheMap == NULL )
+        return false;
+    std::map<CPLString, OCTCacheList::iterator>::iterator oIter =
+        poCTCacheMap->find(osKey);
+    if( oIter == poCTCacheMap->end() )
+        return false;
+
+    OCTCacheList::iterator oEntry = oIter->second;
+    poCTCacheList->splice(poCTCacheList->begin(), *poCTCacheList, oEntry);
+    osSrcProj4Defn = oEntry->osSrcProj4Defn;
+    osDstProj4Defn = oEntry->osDstProj4Defn;
+    if( !oEntry->aoIdleHandles.empty() )
+    {
+        *psHandles = oEntry->aoIdleHandles.back();
+        oEntry->aoIdleHandles.pop_back();
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                           OCTCacheInsert()                           */
+/************************************************************************/
+
+static void OCTCacheInsert( const CPLString& osKey,
+                            const CPLString& osSrcProj4Defn,
+                            const CPLString& osDstProj4Defn )
+{
+    const int nCacheSize = OCTGetCacheSize();
+    if( nCacheSize <= 0 )
+        return;
+
+    std::vector<OCTProjHandles> aoHandlesToFree;
+    {
+        CPLMutexHolderD( &hCTCacheMutex );
+        if( poCTCacheMap == NULL )
+        {
+            poCTCacheList = new OCTCacheList();
+            poCTCacheMap = new std::map<CPLString, OCTCacheList::iterator>();
+        }
+        if( poCTCacheMap->find(osKey) != poCTCacheMap->end() )
+            return;
+
+        OCTCacheEntry sEntry;
+        sEntry.osKey = osKey;
+        sEntry.osSrcProj4Defn = osSrcProj4Defn;
+        sEntry.osDstProj4Defn = osDstProj4Defn;
+        poCTCacheList->push_front(sEntry);
+        (*poCTCacheMap)[osKey] = poCTCacheList->begin();
+
+        while( poCTCacheMap->size() > static_cast<size_t>(nCacheSize) )
+        {
+            OCTCacheEntry& sLast = poCTCacheList->back();
+            aoHandlesToFree.insert(aoHandlesToFree.end(),
+                                   sLast.aoIdleHandles.begin(),
+                                   sLast.aoIdleHandles.end());
+            poCTCacheMap->erase(sLast.osKey);
+            poCTCacheList->pop_back();
+        }
+    }
+
+    // Done without holding hCTCacheMutex, since freeing may require to
+    // take hPROJMutex.
+    OCTFreeProjHandles(aoHandlesToFree);
+}
+
+/************************************************************************/
+/*                          OCTCacheRelease()                           */
+/*                                                                      */
+/*      Gives back PROJ.4 objects to the cache. Returns false if they   */
+/*      could not be kept, in which case they must be freed by the      */
+/*      caller.                                                         */
+/************************************************************************/
+
+static bool OCTCacheRelease( const CPLString& osKey,
+                             const OCTProjHandles& sHandles )
+{
+    CPLMutexHolderD( &hCTCacheMutex );
+    if( poCTCacheMap == NULL )
+        return false;
+    std::map<CPLString, OCTCacheList::iterator>::iterator oIter =
+        poCTCacheMap->find(osKey);
+    if( oIter == poCTCacheMap->end() ||
+        oIter->second->aoIdleHandles.size() >= MAX_IDLE_HANDLES_PER_ENTRY )
+        return false;
+    oIter->second->aoIdleHandles.push_back(sHandles);
+    return true;
+}
+
+/************************************************************************/
+/*                           OCTCacheClear()                            */
+/************************************************************************/
+
+static void OCTCacheClear()
+{
+    std::vector<OCTProjHandles> aoHandlesToFree;
+    {
+        CPLMutexHolderD( &hCTCacheMutex );
+        if( poCTCacheList != NULL )
+        {
+            for( OCTCacheList::iterator oIter = poCTCacheList->begin();
+                 oIter != poCTCacheList->end(); ++oIter )
+            {
+                aoHandlesToFree.insert(aoHandlesToFree.end(),
+                                       oIter->aoIdleHandles.begin(),
+                                       oIter->aoIdleHandles.end());
+            }
+        }
+        delete poCTCacheList;
+        poCTCacheList = NULL;
+        delete poCTCacheMap;
+        poCTCacheMap = NULL;
+    }
+    OCTFreeProjHandles(aoHandlesToFree);
+
+    if( hCTCacheMutex != NULL )
+    {
+        CPLDestroyMutex(hCTCacheMutex);
+        hCTCacheMutex = NULL;
+    }
+}
+
+/************************************************************************/
+/*                Native implementation of common cases                 */
+/*                                                                      */
+/*      Transformations between geographic coordinates and Web          */
+/*      Mercator, and between geographic coordinates and UTM on the     */
+/*      same datum, are done without PROJ.4. They work on radians,      */
+/*      like pj_transform().                                            */
+/************************************************************************/
+
+typedef enum
+{
+    OCT_FAST_PATH_NONE,
+    OCT_FAST_PATH_WEBMERCATOR_TO_GEOG,
+    OCT_FAST_PATH_GEOG_TO_WEBMERCATOR,
+    OCT_FAST_PATH_GEOG_TO_UTM,
+    OCT_FAST_PATH_UTM_TO_GEOG
+} OCTFastPath;
+
+// Transverse Mercator on an ellipsoid, with the series of the tmerc
+// projection of PROJ.4 (J.P. Snyder, "Map Projections - A Working Manual",
+// USGS Professional Paper 1395, 1987), which its utm projection uses, so
+// that results are the same as with PROJ.4. The latitude of origin is 0.
+typedef struct
+{
+    double dfLon0;
+    double dfFalseEasting;
+    double dfFalseNorthing;
+    double dfA;
+    double dfK0;
+    double dfEs;
+    double dfEsp;
+    // Coefficients of the meridian distance, as pj_enfn() of PROJ.4.
+    double adfEn[5];
+} OCTTransverseMercator;
+
+static const char szWebMercatorProj4[] =
+    "+proj=merc +a=6378137 +b=6378137 +lat_ts=0.0 +lon_0=0.0 "
+    "+x_0=0.0 +y_0=0 +k=1.0 +units=m +no_defs";
+static const char szWGS84LongLatProj4[] = "+proj=longlat +ellps=WGS84 +no_defs";
+
+static const double WEB_MERCATOR_RADIUS = 6378137.0;
+
+// Same validity checks as pj_fwd() of PROJ.4.
+static const double LAT_EPSILON = 1e-12;
+static const double MAX_LONG_RADIANS = 10.0;
+
+// Longitude in [-PI, PI], like adjlon() of PROJ.4.
+static double OCTAdjustLong( double dfLong )
+{
+    if( fabs(dfLong) <= M_PI )
+        return dfLong;
+    dfLong += M_PI;
+    dfLong -= 2 * M_PI * floor(dfLong / (2 * M_PI));
+    return dfLong - M_PI;
+}
+
+/************************************************************************/
+/*                      OCTInitTransverseMercator()                     */
+/************************************************************************/
+
+static void OCTInitTransverseMercator( OCTTransverseMercator* psTM,
+                                       double dfA, double dfInvFlattening,
+                                       double dfLon0, double dfK0,
+                                       double dfFalseEasting,
+                                       double dfFalseNorthing )
+{
+    const double f = 1.0 / dfInvFlattening;
+    const double es = f * (2.0 - f);
+
+    psTM->dfLon0 = dfLon0;
+    psTM->dfFalseEasting = dfFalseEasting;
+    psTM->dfFalseNorthing = dfFalseNorthing;
+    psTM->dfA = dfA;
+    psTM->dfK0 = dfK0;
+    psTM->dfEs = es;
+    psTM->dfEsp = es / (1.0 - es);
+
+    const double es2 = es * es;
+    const double es3 = es2 * es;
+    psTM->adfEn[0] = 1.0 - es * (0.25 + es * (0.046875 +
+                                 es * (0.01953125 + es * 0.01068115234375)));
+    psTM->adfEn[1] = es * (0.75 - es * (0.046875 +
+                                 es * (0.01953125 + es * 0.01068115234375)));
+    psTM->adfEn[2] = es2 * (0.46875 - es * (0.01302083333333333333 +
+                                            es * 0.00712076822916666666));
+    psTM->adfEn[3] = es3 * (0.36458333333333333333 -
+                            es * 0.00569661458333333333);
+    psTM->adfEn[4] = es3 * es * 0.3076171875;
+}
+
+/************************************************************************/
+/*                        OCTMeridianDistance()                         */
+/*                                                                      */
+/*      Distance along the meridian from the equator, on the unit       */
+/*      ellipsoid, like pj_mlfn() of PROJ.4.                            */
+/************************************************************************/
+
+static double OCTMeridianDistance( const double* padfEn, double dfPhi,
+                                   double dfSinPhi, double dfCosPhi )
+{
+    const double dfCS = dfCosPhi * dfSinPhi;
+    const double dfS2 = dfSinPhi * dfSinPhi;
+    return padfEn[0] * dfPhi - dfCS * (padfEn[1] + dfS2 * (padfEn[2] +
+                                       dfS2 * (padfEn[3] + dfS2 * padfEn[4])));
+}
+
+/************************************************************************/
+/*                       OCTGetUTMFastPathParams()                      */
+/*                                                                      */
+/*      Checks if pszGeogProj4 and pszUTMProj4 are a geographic and a   */
+/*      UTM coordinate system on the same datum, with an ellipsoid we   */
+/*      know about.                                                     */
+/************************************************************************/
+
+static bool OCTGetUTMFastPathParams( const char* pszGeogProj4,
+                                     const char* pszUTMProj4,
+                                     OCTTransverseMercator* psTM )
+{
+    const char* const pszGeogPrefix = "+proj=longlat ";
+    const char* const pszUTMPrefix = "+proj=utm +zone=";
+    if( !STARTS_WITH(pszGeogProj4, pszGeogPrefix) ||
+        !STARTS_WITH(pszUTMProj4, pszUTMPrefix) )
+        return false;
+
+    // Datum definition, e.g. "+datum=WGS84 "
+    CPLString osDatum(pszGeogProj4 + strlen(pszGeogPrefix));
+    const size_t nPos = osDatum.find("+no_defs");
+    if( nPos == std::string::npos || nPos + strlen("+no_defs") !=
+                                                osDatum.size() )
+        return false;
+    osDatum.resize(nPos);
+
+    double dfA = 0.0;
+    double dfInvFlattening = 0.0;
+    if( osDatum == "+datum=WGS84 " || osDatum == "+ellps=WGS84 " ||
+        osDatum == "+ellps=WGS84 +towgs84=0,0,0,0,0,0,0 " )
+    {
+        dfA = 6378137.0;
+        dfInvFlattening = 298.257223563;
+    }
+    else if( osDatum == "+ellps=GRS80 " ||
+             osDatum == "+ellps=GRS80 +towgs84=0,0,0,0,0,0,0 " )
+    {
+        dfA = 6378137.0;
+        dfInvFlattening = 298.257222101;
+    }
+    else
+    {
+        return false;
+    }
+
+    const int nZone = atoi(pszUTMProj4 + strlen(pszUTMPrefix));
+    if( nZone < 1 || nZone > 60 )
+        return false;
+    bool bSouth = false;
+    if( strcmp(pszUTMProj4,
+               CPLSPrintf("+proj=utm +zone=%d %s+units=m +no_defs",
+                          nZone, osDatum.c_str())) != 0 )
+    {
+        if( strcmp(pszUTMProj4,
+                   CPLSPrintf("+proj=utm +zone=%d +south %s+units=m +no_defs",
+                              nZone, osDatum.c_str())) != 0 )
+            return false;
+        bSouth = true;
+    }
+
+    OCTInitTransverseMercator( psTM, dfA, dfInvFlattening,
+                               (6.0 * nZone - 183.0) * M_PI / 180.0,
+                               0.9996, 500000.0, bSouth ? 10000000.0 : 0.0 );
+    return true;
+}
+
+/************************************************************************/
+/*                        OCTGeogToWebMercator()                        */
+/************************************************************************/
+
+static void OCTGeogToWebMercator( int nCount, double* x, double* y )
+{
+    for( int i = 0; i < nCount; i++ )
+    {
+        if( x[i] == HUGE_VAL || y[i] == HUGE_VAL )
+            continue;
+        // Mercator is not defined at the poles.
+        if( fabs(y[i]) >= M_PI / 2 - 1e-10 ||
+            fabs(x[i]) > MAX_LONG_RADIANS )
+        {
+            x[i] = HUGE_VAL;
+            y[i] = HUGE_VAL;
+            continue;
+        }
+        x[i] = WEB_MERCATOR_RADIUS * OCTAdjustLong(x[i]);
+        y[i] = WEB_MERCATOR_RADIUS * log(tan(M_PI / 4 + 0.5 * y[i]));
+    }
+}
+
+/************************************************************************/
+/*                      OCTGeogToTransverseMercator()                   */
+/*                                                                      */
+/*      Same as pj_fwd() with the e_forward() function of PROJ.4 tmerc. */
+/************************************************************************/
+
+static void OCTGeogToTransverseMercator( const OCTTransverseMercator* psTM,
+                                         int nCount, double* x, double* y )
+{
+    const double es = psTM->dfEs;
+    const double esp = psTM->dfEsp;
+    const double k0 = psTM->dfK0;
+    for( int i = 0; i < nCount; i++ )
+    {
+        if( x[i] == HUGE_VAL || y[i] == HUGE_VAL )
+            continue;
+        const double lam = OCTAdjustLong(x[i] - psTM->dfLon0);
+        if( fabs(y[i]) > M_PI / 2 + LAT_EPSILON ||
+            fabs(x[i]) > MAX_LONG_RADIANS || fabs(lam) > M_PI / 2 )
+        {
+            x[i] = HUGE_VAL;
+            y[i] = HUGE_VAL;
+            continue;
+        }
+        const double phi = std::max(-M_PI / 2, std::min(M_PI / 2, y[i]));
+
+        const double sinphi = sin(phi);
+        const double cosphi = cos(phi);
+        double t = fabs(cosphi) > 1e-10 ? sinphi / cosphi : 0.0;
+        t *= t;
+        double al = cosphi * lam;
+        const double als = al * al;
+        al /= sqrt(1.0 - es * sinphi * sinphi);
+        const double n = esp * cosphi * cosphi;
+
+        const double dfX = k0 * al * (1.0 +
+            als / 6.0 * (1.0 - t + n +
+            als / 20.0 * (5.0 + t * (t - 18.0) + n * (14.0 - 58.0 * t) +
+            als / 42.0 * (61.0 + t * (t * (179.0 - t) - 479.0)))));
+        const double dfY = k0 * (
+            OCTMeridianDistance(psTM->adfEn, phi, sinphi, cosphi) +
+            sinphi * al * lam / 2.0 * (1.0 +
+            als / 12.0 * (5.0 - t + n * (9.0 + 4.0 * n) +
+            als / 30.0 * (61.0 + t * (t - 58.0) + n * (270.0 - 330.0 * t) +
+            als / 56.0 * (1385.0 + t * (t * (543.0 - t) - 3111.0))))));
+
+        x[i] = psTM->dfA * dfX + psTM->dfFalseEasting;
+        y[i] = psTM->dfA * dfY + psTM->dfFalseNorthing;
+    }
+}
+
+/************************************************************************/
+/*                      OCTTransverseMercatorToGeog()                   */
+/*                                                                      */
+/*      Same as pj_inv() with the e_inverse() function of PROJ.4 tmerc. */
+/************************************************************************/
+
+static void OCTTransverseMercatorToGeog( const OCTTransverseMercator* psTM,
+                                         int nCount, double* x, double* y )
+{
+    const double es = psTM->dfEs;
+    const double esp = psTM->dfEsp;
+    const double k0 = psTM->dfK0;
+    for( int i = 0; i < nCount; i++ )
+    {
+        if( x[i] == HUGE_VAL || y[i] == HUGE_VAL )
+            continue;
+
+        const double dfX = (x[i] - psTM->dfFalseEasting) / psTM->dfA;
+        const double dfY = (y[i] - psTM->dfFalseNorthing) / psTM->dfA;
+
+        // Footpoint latitude, with the Newton iterations of pj_inv_mlfn().
+        const double dfArg = dfY / k0;
+        double phi = dfArg;
+        bool bConverged = false;
+        for( int iIter = 0; iIter < 10; iIter++ )
+        {
+            const double s = sin(phi);
+            const double t = 1.0 - es * s * s;
+            const double dphi =
+                (OCTMeridianDistance(psTM->adfEn, phi, s, cos(phi)) -
+                 dfArg) * (t * sqrt(t)) / (1.0 - es);
+            phi -= dphi;
+            if( fabs(dphi) < 1e-11 )
+            {
+                bConverged = true;
+                break;
+            }
+        }
+        if( !bConverged )
+        {
+            x[i] = HUGE_VAL;
+            y[i] = HUGE_VAL;
+            continue;
+        }
+
+        double lam = 0.0;
+        if( fabs(phi) >= M_PI / 2 )
+        {
+            phi = dfY < 0.0 ? -M_PI / 2 : M_PI / 2;
+        }
+        else
+        {
+            const double sinphi = sin(phi);
+            const double cosphi = cos(phi);
+            double t = fabs(cosphi) > 1e-10 ? sinphi / cosphi : 0.0;
+            const double n = esp * cosphi * cosphi;
+            double con = 1.0 - es * sinphi * sinphi;
+            const double d = dfX * sqrt(con) / k0;
+            con *= t;
+            t *= t;
+            const double ds = d * d;
+            phi -= (con * ds / (1.0 - es)) / 2.0 * (1.0 -
+                ds / 12.0 * (5.0 + t * (3.0 - 9.0 * n) + n * (1.0 - 4.0 * n) -
+                ds / 30.0 * (61.0 + t * (90.0 - 252.0 * n + 45.0 * t) +
+                             46.0 * n -
+                ds / 56.0 * (1385.0 + t * (3633.0 + t * (4095.0 +
+                                                         1574.0 * t))))));
+            lam = d * (1.0 -
+                ds / 6.0 * (1.0 + 2.0 * t + n -
+                ds / 20.0 * (5.0 + t * (28.0 + 24.0 * t + 8.0 * n) + 6.0 * n -
+                ds / 42.0 * (61.0 + t * (662.0 + t * (1320.0 +
+                                                      720.0 * t)))))) / cosphi;
+        }
+
+        x[i] = OCTAdjustLong(lam + psTM->dfLon0);
+        y[i] = phi;
+    }
+}
+
 /************************************************************************/
 /*                              OGRProj4CT                              */
 /************************************************************************/
@@ -139,7 +677,8 @@ class OGRProj4CT : public OGRCoordinateTransformation
     double      dfTargetWrapLong;
 
     bool        bIdentityTransform;
-    bool        bWebMercatorToWGS84;
+    OCTFastPath eFastPath;
+    OCTTransverseMercator sTM;
 
     int         nErrorCount;
 
@@ -148,6 +687,10 @@ class OGRProj4CT : public OGRCoordinateTransformation
 
     projCtx     pjctx;
 
+    // Key of the cache entry to which psPJSource and psPJTarget are given
+    // back on destruction.
+    CPLString   osCacheKey;
+
     int         InitializeNoLock( OGRSpatialReference *poSource,
                                   OGRSpatialReference *poTarget );
 
@@ -422,7 +965,17 @@ void OGRCoordinateTransformation::DestroyCT( OGRCoordinateTransformation* poCT )
  * The delete operator, or OCTDestroyCoordinateTransformation() should
  * be used to destroy transformation objects.
  *
- * The PROJ.4 library must be available at run-time.
+ * The PROJ.4 library must be available at run-time, except for the
+ * transformations between geographic coordinates on WGS84 and
+ * WebMercator, and between geographic coordinates on WGS84 or GRS80 and
+ * UTM on the same ellipsoid, that are done natively starting with GDAL 2.3
+ * (unless the OGR_CT_USE_FAST_PATHS configuration option is set to NO).
+ *
+ * Starting with GDAL 2.3, the PROJ.4 definitions and the initialized PROJ.4
+ * objects of the most recently used pairs of spatial reference systems are
+ * kept in a process-wide cache, so that creating again a transformation
+ * between the same systems is cheap. Its number of entries is set with
+ * the OGR_CT_CACHE_SIZE configuration option (64 by default, 0 to disable).
  *
  * @param poSource source spatial reference system.
  * @param poTarget target spatial reference system.
@@ -434,14 +987,10 @@ OGRCreateCoordinateTransformation( OGRSpatialReference *poSource,
                                    OGRSpatialReference *poTarget )
 
 {
-    if( pfn_pj_init == NULL && !LoadProjLibrary() )
-    {
-        CPLError( CE_Failure, CPLE_NotSupported,
-                  "Unable to load PROJ.4 library (%s), creation of "
-                  "OGRCoordinateTransformation failed.",
-                  GetProjLibraryName() );
-        return NULL;
-    }
+    // A missing PROJ.4 library is only an error if the transformation
+    // cannot be done natively, which is checked by Initialize().
+    if( pfn_pj_init == NULL )
+        LoadProjLibrary();
 
     OGRProj4CT *poCT = new OGRProj4CT();
 
@@ -469,7 +1018,17 @@ OGRCreateCoordinateTransformation( OGRSpatialReference *poSource,
  * OCTDestroyCoordinateTransformation() should
  * be used to destroy transformation objects.
  *
- * The PROJ.4 library must be available at run-time.
+ * The PROJ.4 library must be available at run-time, except for the
+ * transformations between geographic coordinates on WGS84 and
+ * WebMercator, and between geographic coordinates on WGS84 or GRS80 and
+ * UTM on the same ellipsoid, that are done natively starting with GDAL 2.3
+ * (unless the OGR_CT_USE_FAST_PATHS configuration option is set to NO).
+ *
+ * Starting with GDAL 2.3, the PROJ.4 definitions and the initialized PROJ.4
+ * objects of the most recently used pairs of spatial reference systems are
+ * kept in a process-wide cache, so that creating again a transformation
+ * between the same systems is cheap. Its number of entries is set with
+ * the OGR_CT_CACHE_SIZE configuration option (64 by default, 0 to disable).
  *
  * @param hSourceSRS source spatial reference system.
  * @param hTargetSRS target spatial reference system.
@@ -505,7 +1064,7 @@ OGRProj4CT::OGRProj4CT() :
     bTargetWrap(false),
     dfTargetWrapLong(0.0),
     bIdentityTransform(false),
-    bWebMercatorToWGS84(false),
+    eFastPath(OCT_FAST_PATH_NONE),
     nErrorCount(0),
     bCheckWithInvertProj(false),
     dfThreshold(0.0),
@@ -520,6 +1079,7 @@ OGRProj4CT::OGRProj4CT() :
     m_bEmitErrors(true),
     bNoTransform(false)
 {
+    memset(&sTM, 0, sizeof(sTM));
     if( pfn_pj_ctx_alloc != NULL )
         pjctx = pfn_pj_ctx_alloc();
 }
@@ -543,15 +1103,29 @@ OGRProj4CT::~OGRProj4CT()
             delete poSRSTarget;
     }
 
-    if( pjctx != NULL )
+    if( !osCacheKey.empty() && psPJSource != NULL && psPJTarget != NULL )
     {
-        pfn_pj_ctx_free(pjctx);
+        OCTProjHandles sHandles;
+        sHandles.pjctx = pjctx;
+        sHandles.psPJSource = psPJSource;
+        sHandles.psPJTarget = psPJTarget;
+        if( OCTCacheRelease(osCacheKey, sHandles) )
+        {
+            pjctx = NULL;
+            psPJSource = NULL;
+            psPJTarget = NULL;
+        }
+    }
 
+    if( pjctx != NULL )
+    {
         if( psPJSource != NULL )
             pfn_pj_free( psPJSource );
 
         if( psPJTarget != NULL )
             pfn_pj_free( psPJTarget );
+
+        pfn_pj_ctx_free(pjctx);
     }
     else
     {
@@ -595,6 +1169,133 @@ int OGRProj4CT::Initialize( OGRSpatialReference * poSourceIn,
     return InitializeNoLock(poSourceIn, poTargetIn);
 }
 
+/************************************************************************/
+/*                       ExportToNormalizedProj4()                      */
+/*                                                                      */
+/*      Exports the source and target SRS to PROJ.4 strings, removing   */
+/*      useless datum shift definitions when converting between WGS84   */
+/*      and WebMercator.                                                */
+/************************************************************************/
+
+static bool ExportToNormalizedProj4( OGRSpatialReference* poSRSSourceIn,
+                                     OGRSpatialReference* poSRSTargetIn,
+                                     char** ppszSrcProj4Defn,
+                                     char** ppszDstProj4Defn )
+{
+    char *pszSrcProj4Defn = NULL;
+
+    if( poSRSSourceIn->exportToProj4( &pszSrcProj4Defn ) != OGRERR_NONE )
+    {
+        CPLFree( pszSrcProj4Defn );
+        return false;
+    }
+
+    if( strlen(pszSrcProj4Defn) == 0 )
+    {
+        CPLFree( pszSrcProj4Defn );
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "No PROJ.4 translation for source SRS, coordinate "
+                  "transformation initialization has failed." );
+        return false;
+    }
+
+    char *pszDstProj4Defn = NULL;
+
+    if( poSRSTargetIn->exportToProj4( &pszDstProj4Defn ) != OGRERR_NONE )
+    {
+        CPLFree( pszSrcProj4Defn );
+        CPLFree( pszDstProj4Defn );
+        return false;
+    }
+
+    if( strlen(pszDstProj4Defn) == 0 )
+    {
+        CPLFree( pszSrcProj4Defn );
+        CPLFree( pszDstProj4Defn );
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "No PROJ.4 translation for destination SRS, coordinate "
+                  "transformation initialization has failed." );
+        return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Optimization to avoid useless nadgrids evaluation.              */
+/*      For example when converting between WGS84 and WebMercator       */
+/* -------------------------------------------------------------------- */
+    if( pszSrcProj4Defn[strlen(pszSrcProj4Defn)-1] == ' ' )
+        pszSrcProj4Defn[strlen(pszSrcProj4Defn)-1] = 0;
+    if( pszDstProj4Defn[strlen(pszDstProj4Defn)-1] == ' ' )
+        pszDstProj4Defn[strlen(pszDstProj4Defn)-1] = 0;
+    char* pszNeedle = strstr(pszSrcProj4Defn, "  ");
+    if( pszNeedle )
+        memmove(pszNeedle, pszNeedle + 1, strlen(pszNeedle + 1)+1);
+    pszNeedle = strstr(pszDstProj4Defn, "  ");
+    if( pszNeedle )
+        memmove(pszNeedle, pszNeedle + 1, strlen(pszNeedle + 1)+1);
+
+    if( (strstr(pszSrcProj4Defn, "+datum=WGS84") != NULL ||
+         strstr(pszSrcProj4Defn,
+                "+ellps=WGS84 +towgs84=0,0,0,0,0,0,0 ") != NULL) &&
+        strstr(pszDstProj4Defn, "+nadgrids=@null ") != NULL &&
+        strstr(pszDstProj4Defn, "+towgs84") == NULL )
+    {
+        char* pszDst = strstr(pszSrcProj4Defn, "+towgs84=0,0,0,0,0,0,0 ");
+        if( pszDst != NULL )
+        {
+            char *pszSrc = pszDst + strlen("+towgs84=0,0,0,0,0,0,0 ");
+            memmove(pszDst, pszSrc, strlen(pszSrc)+1);
+        }
+        else
+        {
+            memcpy(strstr(pszSrcProj4Defn, "+datum=WGS84"), "+ellps", 6);
+        }
+
+        pszDst = strstr(pszDstProj4Defn, "+nadgrids=@null ");
+        char *pszSrc = pszDst + strlen("+nadgrids=@null ");
+        memmove(pszDst, pszSrc, strlen(pszSrc)+1);
+
+        pszDst = strstr(pszDstProj4Defn, "+wktext ");
+        if( pszDst )
+        {
+            pszSrc = pszDst + strlen("+wktext ");
+            memmove(pszDst, pszSrc, strlen(pszSrc)+1);
+        }
+    }
+    else
+    if( (strstr(pszDstProj4Defn, "+datum=WGS84") != NULL ||
+         strstr(pszDstProj4Defn,
+                "+ellps=WGS84 +towgs84=0,0,0,0,0,0,0 ") != NULL) &&
+        strstr(pszSrcProj4Defn, "+nadgrids=@null ") != NULL &&
+        strstr(pszSrcProj4Defn, "+towgs84") == NULL )
+    {
+        char* pszDst = strstr(pszDstProj4Defn, "+towgs84=0,0,0,0,0,0,0 ");
+        if( pszDst != NULL)
+        {
+            char* pszSrc = pszDst + strlen("+towgs84=0,0,0,0,0,0,0 ");
+            memmove(pszDst, pszSrc, strlen(pszSrc)+1);
+        }
+        else
+        {
+            memcpy(strstr(pszDstProj4Defn, "+datum=WGS84"), "+ellps", 6);
+        }
+
+        pszDst = strstr(pszSrcProj4Defn, "+nadgrids=@null ");
+        char* pszSrc = pszDst + strlen("+nadgrids=@null ");
+        memmove(pszDst, pszSrc, strlen(pszSrc)+1);
+
+        pszDst = strstr(pszSrcProj4Defn, "+wktext ");
+        if( pszDst )
+        {
+            pszSrc = pszDst + strlen("+wktext ");
+            memmove(pszDst, pszSrc, strlen(pszSrc)+1);
+        }
+    }
+
+    *ppszSrcProj4Defn = pszSrcProj4Defn;
+    *ppszDstProj4Defn = pszDstProj4Defn;
+    return true;
+}
+
 /************************************************************************/
 /*                         InitializeNoLock()                           */
 /************************************************************************/
@@ -692,130 +1393,136 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
     // means debug output could be one "increment" late.
     static int nDebugReportCount = 0;
 
-    char *pszSrcProj4Defn = NULL;
-
-    if( poSRSSource->exportToProj4( &pszSrcProj4Defn ) != OGRERR_NONE )
+/* -------------------------------------------------------------------- */
+/*      Look for the PROJ.4 definitions, and maybe initialized PROJ.4   */
+/*      objects, in the cache.                                          */
+/* -------------------------------------------------------------------- */
+    CPLString osSrcProj4Defn;
+    CPLString osDstProj4Defn;
+    OCTProjHandles sCachedHandles;
+    sCachedHandles.pjctx = NULL;
+    sCachedHandles.psPJSource = NULL;
+    sCachedHandles.psPJTarget = NULL;
+    bool bFoundInCache = false;
+
+    CPLString osKey;
+    if( OCTGetCacheSize() > 0 )
     {
-        CPLFree( pszSrcProj4Defn );
-        return FALSE;
+        char* pszSrcWKT = NULL;
+        char* pszDstWKT = NULL;
+        if( poSRSSource->exportToWkt(&pszSrcWKT) == OGRERR_NONE &&
+            poSRSTarget->exportToWkt(&pszDstWKT) == OGRERR_NONE )
+        {
+            // Also depends on configuration options used by exportToProj4()
+            osKey.Printf("%s\n%s\n%s\n%s", pszSrcWKT, pszDstWKT,
+                CPLGetConfigOption("OSR_USE_ETMERC", ""),
+                CPLGetConfigOption("OVERRIDE_PROJ_DATUM_WITH_TOWGS84", ""));
+            bFoundInCache = OCTCacheLookup(osKey, osSrcProj4Defn,
+                                           osDstProj4Defn, &sCachedHandles);
+        }
+        CPLFree(pszSrcWKT);
+        CPLFree(pszDstWKT);
     }
 
-    if( strlen(pszSrcProj4Defn) == 0 )
+    if( !bFoundInCache )
     {
+        char *pszSrcProj4Defn = NULL;
+        char *pszDstProj4Defn = NULL;
+        if( !ExportToNormalizedProj4( poSRSSource, poSRSTarget,
+                                      &pszSrcProj4Defn, &pszDstProj4Defn ) )
+        {
+            return FALSE;
+        }
+        osSrcProj4Defn = pszSrcProj4Defn;
+        osDstProj4Defn = pszDstProj4Defn;
         CPLFree( pszSrcProj4Defn );
-        CPLError( CE_Failure, CPLE_AppDefined,
-                  "No PROJ.4 translation for source SRS, coordinate "
-                  "transformation initialization has failed." );
-        return FALSE;
+        CPLFree( pszDstProj4Defn );
+
+        if( !osKey.empty() )
+            OCTCacheInsert(osKey, osSrcProj4Defn, osDstProj4Defn);
     }
 
-    char *pszDstProj4Defn = NULL;
+/* -------------------------------------------------------------------- */
+/*      Check if the transformation can be done without PROJ.4.         */
+/* -------------------------------------------------------------------- */
+    eFastPath = OCT_FAST_PATH_NONE;
+    if( osDstProj4Defn == szWGS84LongLatProj4 &&
+        osSrcProj4Defn == szWebMercatorProj4 )
+    {
+        eFastPath = OCT_FAST_PATH_WEBMERCATOR_TO_GEOG;
+    }
+    else if( osSrcProj4Defn == szWGS84LongLatProj4 &&
+             osDstProj4Defn == szWebMercatorProj4 )
+    {
+        eFastPath = OCT_FAST_PATH_GEOG_TO_WEBMERCATOR;
+    }
+    else if( OCTGetUTMFastPathParams(osSrcProj4Defn, osDstProj4Defn, &sTM) )
+    {
+        eFastPath = OCT_FAST_PATH_GEOG_TO_UTM;
+    }
+    else if( OCTGetUTMFastPathParams(osDstProj4Defn, osSrcProj4Defn, &sTM) )
+    {
+        eFastPath = OCT_FAST_PATH_UTM_TO_GEOG;
+    }
+    if( eFastPath != OCT_FAST_PATH_NONE &&
+        !CPLTestBool(CPLGetConfigOption("OGR_CT_USE_FAST_PATHS", "YES")) )
+    {
+        eFastPath = OCT_FAST_PATH_NONE;
+    }
 
-    if( poSRSTarget->exportToProj4( &pszDstProj4Defn ) != OGRERR_NONE )
+    // The reverse transformation is done by PROJ.4 in that case.
+    if( bCheckWithInvertProj &&
+        (eFastPath == OCT_FAST_PATH_GEOG_TO_WEBMERCATOR ||
+         eFastPath == OCT_FAST_PATH_GEOG_TO_UTM ||
+         eFastPath == OCT_FAST_PATH_UTM_TO_GEOG) )
     {
-        CPLFree( pszSrcProj4Defn );
-        CPLFree( pszDstProj4Defn );
-        return FALSE;
+        eFastPath = OCT_FAST_PATH_NONE;
     }
 
-    if( strlen(pszDstProj4Defn) == 0 )
+    if( nDebugReportCount < 10 )
     {
-        CPLFree( pszSrcProj4Defn );
-        CPLFree( pszDstProj4Defn );
-        CPLError( CE_Failure, CPLE_AppDefined,
-                  "No PROJ.4 translation for destination SRS, coordinate "
-                  "transformation initialization has failed." );
-        return FALSE;
+        CPLDebug( "OGRCT", "Source: %s", osSrcProj4Defn.c_str() );
+        CPLDebug( "OGRCT", "Target: %s", osDstProj4Defn.c_str() );
+        nDebugReportCount++;
     }
 
 /* -------------------------------------------------------------------- */
-/*      Optimization to avoid useless nadgrids evaluation.              */
-/*      For example when converting between WGS84 and WebMercator       */
+/*      Establish PROJ.4 handles for source and target, or reuse        */
+/*      cached ones.                                                    */
 /* -------------------------------------------------------------------- */
-    if( pszSrcProj4Defn[strlen(pszSrcProj4Defn)-1] == ' ' )
-        pszSrcProj4Defn[strlen(pszSrcProj4Defn)-1] = 0;
-    if( pszDstProj4Defn[strlen(pszDstProj4Defn)-1] == ' ' )
-        pszDstProj4Defn[strlen(pszDstProj4Defn)-1] = 0;
-    char* pszNeedle = strstr(pszSrcProj4Defn, "  ");
-    if( pszNeedle )
-        memmove(pszNeedle, pszNeedle + 1, strlen(pszNeedle + 1)+1);
-    pszNeedle = strstr(pszDstProj4Defn, "  ");
-    if( pszNeedle )
-        memmove(pszNeedle, pszNeedle + 1, strlen(pszNeedle + 1)+1);
-
-    if( (strstr(pszSrcProj4Defn, "+datum=WGS84") != NULL ||
-         strstr(pszSrcProj4Defn,
-                "+ellps=WGS84 +towgs84=0,0,0,0,0,0,0 ") != NULL) &&
-        strstr(pszDstProj4Defn, "+nadgrids=@null ") != NULL &&
-        strstr(pszDstProj4Defn, "+towgs84") == NULL )
+    if( sCachedHandles.psPJSource != NULL )
     {
-        char* pszDst = strstr(pszSrcProj4Defn, "+towgs84=0,0,0,0,0,0,0 ");
-        if( pszDst != NULL )
+        if( eFastPath == OCT_FAST_PATH_NONE )
         {
-            char *pszSrc = pszDst + strlen("+towgs84=0,0,0,0,0,0,0 ");
-            memmove(pszDst, pszSrc, strlen(pszSrc)+1);
+            if( pjctx != NULL )
+                pfn_pj_ctx_free(pjctx);
+            pjctx = sCachedHandles.pjctx;
+            psPJSource = sCachedHandles.psPJSource;
+            psPJTarget = sCachedHandles.psPJTarget;
+            osCacheKey = osKey;
         }
         else
         {
-            memcpy(strstr(pszSrcProj4Defn, "+datum=WGS84"), "+ellps", 6);
-        }
-
-        pszDst = strstr(pszDstProj4Defn, "+nadgrids=@null ");
-        char *pszSrc = pszDst + strlen("+nadgrids=@null ");
-        memmove(pszDst, pszSrc, strlen(pszSrc)+1);
-
-        pszDst = strstr(pszDstProj4Defn, "+wktext ");
-        if( pszDst )
-        {
-            pszSrc = pszDst + strlen("+wktext ");
-            memmove(pszDst, pszSrc, strlen(pszSrc)+1);
+            std::vector<OCTProjHandles> aoHandles;
+            aoHandles.push_back(sCachedHandles);
+            OCTFreeProjHandles(aoHandles);
         }
     }
-    else
-    if( (strstr(pszDstProj4Defn, "+datum=WGS84") != NULL ||
-         strstr(pszDstProj4Defn,
-                "+ellps=WGS84 +towgs84=0,0,0,0,0,0,0 ") != NULL) &&
-        strstr(pszSrcProj4Defn, "+nadgrids=@null ") != NULL &&
-        strstr(pszSrcProj4Defn, "+towgs84") == NULL )
+    else if( eFastPath == OCT_FAST_PATH_NONE )
     {
-        char* pszDst = strstr(pszDstProj4Defn, "+towgs84=0,0,0,0,0,0,0 ");
-        if( pszDst != NULL)
+        if( pfn_pj_init_plus == NULL )
         {
-            char* pszSrc = pszDst + strlen("+towgs84=0,0,0,0,0,0,0 ");
-            memmove(pszDst, pszSrc, strlen(pszSrc)+1);
-        }
-        else
-        {
-            memcpy(strstr(pszDstProj4Defn, "+datum=WGS84"), "+ellps", 6);
-        }
-
-        pszDst = strstr(pszSrcProj4Defn, "+nadgrids=@null ");
-        char* pszSrc = pszDst + strlen("+nadgrids=@null ");
-        memmove(pszDst, pszSrc, strlen(pszSrc)+1);
-
-        pszDst = strstr(pszSrcProj4Defn, "+wktext ");
-        if( pszDst )
-        {
-            pszSrc = pszDst + strlen("+wktext ");
-            memmove(pszDst, pszSrc, strlen(pszSrc)+1);
+            CPLError( CE_Failure, CPLE_NotSupported,
+                      "Unable to load PROJ.4 library (%s), creation of "
+                      "OGRCoordinateTransformation failed.",
+                      GetProjLibraryName() );
+            return FALSE;
         }
-        bWebMercatorToWGS84 =
-            strcmp(pszDstProj4Defn,
-                   "+proj=longlat +ellps=WGS84 +no_defs") == 0 &&
-            strcmp(pszSrcProj4Defn,
-                   "+proj=merc +a=6378137 +b=6378137 +lat_ts=0.0 +lon_0=0.0 "
-                   "+x_0=0.0 +y_0=0 +k=1.0 +units=m +no_defs") == 0;
-    }
 
-/* -------------------------------------------------------------------- */
-/*      Establish PROJ.4 handle for source if projection.               */
-/* -------------------------------------------------------------------- */
-    if( !bWebMercatorToWGS84 )
-    {
         if( pjctx )
-            psPJSource = pfn_pj_init_plus_ctx( pjctx, pszSrcProj4Defn );
+            psPJSource = pfn_pj_init_plus_ctx( pjctx, osSrcProj4Defn );
         else
-            psPJSource = pfn_pj_init_plus( pszSrcProj4Defn );
+            psPJSource = pfn_pj_init_plus( osSrcProj4Defn );
 
         if( psPJSource == NULL )
         {
@@ -827,7 +1534,8 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
                 CPLMutexHolderD(&hPROJMutex);
                 CPLError( CE_Failure, CPLE_NotSupported,
                           "Failed to initialize PROJ.4 with `%s'.\n%s",
-                          pszSrcProj4Defn, pfn_pj_strerrno(l_pj_errno) );
+                          osSrcProj4Defn.c_str(),
+                          pfn_pj_strerrno(l_pj_errno) );
             }
             else if( pfn_pj_get_errno_ref != NULL
                 && pfn_pj_strerrno != NULL )
@@ -836,58 +1544,38 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
 
                 CPLError( CE_Failure, CPLE_NotSupported,
                           "Failed to initialize PROJ.4 with `%s'.\n%s",
-                          pszSrcProj4Defn, pfn_pj_strerrno(*p_pj_errno) );
+                          osSrcProj4Defn.c_str(),
+                          pfn_pj_strerrno(*p_pj_errno) );
             }
             else
             {
                 CPLError( CE_Failure, CPLE_NotSupported,
                           "Failed to initialize PROJ.4 with `%s'.",
-                          pszSrcProj4Defn );
+                          osSrcProj4Defn.c_str() );
             }
+            return FALSE;
         }
-    }
-
-    if( nDebugReportCount < 10 )
-        CPLDebug( "OGRCT", "Source: %s", pszSrcProj4Defn );
 
-    if( !bWebMercatorToWGS84 && psPJSource == NULL )
-    {
-        CPLFree( pszSrcProj4Defn );
-        CPLFree( pszDstProj4Defn );
-        return FALSE;
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Establish PROJ.4 handle for target if projection.               */
-/* -------------------------------------------------------------------- */
-    if( !bWebMercatorToWGS84 )
-    {
         if( pjctx )
-            psPJTarget = pfn_pj_init_plus_ctx( pjctx, pszDstProj4Defn );
+            psPJTarget = pfn_pj_init_plus_ctx( pjctx, osDstProj4Defn );
         else
-            psPJTarget = pfn_pj_init_plus( pszDstProj4Defn );
+            psPJTarget = pfn_pj_init_plus( osDstProj4Defn );
 
         if( psPJTarget == NULL )
+        {
             CPLError( CE_Failure, CPLE_NotSupported,
                       "Failed to initialize PROJ.4 with `%s'.",
-                      pszDstProj4Defn );
-    }
-    if( nDebugReportCount < 10 )
-    {
-        CPLDebug( "OGRCT", "Target: %s", pszDstProj4Defn );
-        nDebugReportCount++;
-    }
+                      osDstProj4Defn.c_str() );
+            return FALSE;
+        }
 
-    if( !bWebMercatorToWGS84 && psPJTarget == NULL )
-    {
-        CPLFree( pszSrcProj4Defn );
-        CPLFree( pszDstProj4Defn );
-        return FALSE;
+        if( bFoundInCache || !osKey.empty() )
+            osCacheKey = osKey;
     }
 
     // Determine if we really have a transformation to do at the proj.4 level
     // (but we may have a unit transformation to do)
-    bIdentityTransform = strcmp(pszSrcProj4Defn, pszDstProj4Defn) == 0;
+    bIdentityTransform = osSrcProj4Defn == osDstProj4Defn;
 
     // Determine if we can skip the transformation completely.
     // Assume that source and target units are defined with at least
@@ -896,9 +1584,6 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
                     bTargetLatLong && !bTargetWrap &&
                     fabs(dfSourceToRadians * dfTargetFromRadians - 1.0) < 1E-9;
 
-    CPLFree( pszSrcProj4Defn );
-    CPLFree( pszDstProj4Defn );
-
     return TRUE;
 }
 
@@ -1048,7 +1733,7 @@ int OGRProj4CT::TransformEx( int nCount, double *x, double *y, double *z,
 /*      Optimized transform from WebMercator to WGS84                   */
 /* -------------------------------------------------------------------- */
     bool bTransformDone = false;
-    if( bWebMercatorToWGS84 )
+    if( eFastPath == OCT_FAST_PATH_WEBMERCATOR_TO_GEOG )
     {
         static const double REVERSE_SPHERE_RADIUS = 1.0 / 6378137.0;
 
@@ -1111,6 +1796,24 @@ int OGRProj4CT::TransformEx( int nCount, double *x, double *y, double *z,
 
         bTransformDone = true;
     }
+/* -------------------------------------------------------------------- */
+/*      Other transforms that do not need PROJ.4.                       */
+/* -------------------------------------------------------------------- */
+    else if( eFastPath == OCT_FAST_PATH_GEOG_TO_WEBMERCATOR )
+    {
+        OCTGeogToWebMercator(nCount, x, y);
+        bTransformDone = true;
+    }
+    else if( eFastPath == OCT_FAST_PATH_GEOG_TO_UTM )
+    {
+        OCTGeogToTransverseMercator(&sTM, nCount, x, y);
+        bTransformDone = true;
+    }
+    else if( eFastPath == OCT_FAST_PATH_UTM_TO_GEOG )
+    {
+        OCTTransverseMercatorToGeog(&sTM, nCount, x, y);
+        bTransformDone = true;
+    }
     else if( bIdentityTransform )
     {
         bTransformDone = true;
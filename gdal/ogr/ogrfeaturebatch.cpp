@@ -0,0 +1,931 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  The OGRFeatureBatch class, a column oriented set of features.
+ *
+ ******************************************************************************
+ * Copyright (c) 2017, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "ogr_feature.h"
+
+#include <cstring>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "ogr_core.h"
+
+CPL_CVSID("$Id$");
+
+//! @cond Doxygen_Suppress
+
+/************************************************************************/
+/*                        OGRFeatureBatchColumn                         */
+/************************************************************************/
+
+struct OGRFeatureBatchColumn
+{
+    // Attribute type for attribute columns, OFTBinary for geometry columns.
+    OGRFieldType        eType;
+
+    // Bit i (LSB first) set if feature i has a value.
+    std::vector<GByte>  abyValidity;
+
+    // Fixed width values, or concatenated variable length values.
+    std::vector<GByte>  abyValues;
+
+    // nFeatureCount + 1 entries for variable length columns, empty
+    // otherwise.
+    std::vector<size_t> anOffsets;
+};
+
+/************************************************************************/
+/*                        OGRFeatureBatchPrivate                        */
+/************************************************************************/
+
+class OGRFeatureBatchPrivate
+{
+  public:
+    OGRFeatureDefn                      *poDefn;
+    int                                  nFeatureCount;
+    std::vector<GIntBig>                 anFIDs;
+    std::vector<OGRFeatureBatchColumn>   aoFields;
+    std::vector<OGRFeatureBatchColumn>   aoGeomFields;
+
+    OGRFeatureBatchPrivate() : poDefn(NULL), nFeatureCount(0) {}
+};
+
+/************************************************************************/
+/*                          GetFixedWidth()                             */
+/*                                                                      */
+/*      Size in bytes of a value of a fixed width column, or 0 for      */
+/*      variable length columns.                                        */
+/************************************************************************/
+
+static size_t GetFixedWidth( OGRFieldType eType )
+{
+    switch( eType )
+    {
+        case OFTInteger:
+            return sizeof(int);
+        case OFTInteger64:
+            return sizeof(GIntBig);
+        case OFTReal:
+            return sizeof(double);
+        case OFTDate:
+        case OFTTime:
+        case OFTDateTime:
+            return sizeof(OGRField);
+        default:
+            return 0;
+    }
+}
+
+/************************************************************************/
+/*                           GetDataPtr()                               */
+/************************************************************************/
+
+template<class T> static const T* GetDataPtr( const std::vector<T>& v )
+{
+    return v.empty() ? NULL : &v[0];
+}
+
+/************************************************************************/
+/*                           SetValid()                                 */
+/************************************************************************/
+
+static void SetValid( OGRFeatureBatchColumn& oCol, int iFeature )
+{
+    oCol.abyValidity[iFeature >> 3] |=
+        static_cast<GByte>(1 << (iFeature & 7));
+}
+
+/************************************************************************/
+/*                          AppendVarData()                             */
+/*                                                                      */
+/*      Append variable length data to the last feature of a column.    */
+/************************************************************************/
+
+static void AppendVarData( OGRFeatureBatchColumn& oCol, int iFeature,
+                           const void* pData, size_t nLen )
+{
+    if( nLen )
+    {
+        const size_t nOldSize = oCol.abyValues.size();
+        oCol.abyValues.resize( nOldSize + nLen );
+        memcpy( &oCol.abyValues[nOldSize], pData, nLen );
+    }
+    oCol.anOffsets.back() = oCol.abyValues.size();
+    SetValid( oCol, iFeature );
+}
+
+/************************************************************************/
+/*                          AppendListData()                            */
+/*                                                                      */
+/*      List columns use offsets expressed in number of elements.       */
+/************************************************************************/
+
+template<class T> static void AppendListData( OGRFeatureBatchColumn& oCol,
+                                              int iFeature,
+                                              const T* paList, int nCount )
+{
+    AppendVarData( oCol, iFeature, paList,
+                   sizeof(T) * static_cast<size_t>(nCount) );
+    oCol.anOffsets.back() = oCol.abyValues.size() / sizeof(T);
+}
+
+/************************************************************************/
+/*                        Little endian WKB writers                     */
+/************************************************************************/
+
+static GByte* WriteWkbUInt32( GByte* pabyOut, GUInt32 nVal )
+{
+    CPL_LSBPTR32(&nVal);
+    memcpy( pabyOut, &nVal, sizeof(nVal) );
+    return pabyOut + sizeof(nVal);
+}
+
+static GByte* WriteWkbHeader( GByte* pabyOut, GUInt32 nIsoType )
+{
+    pabyOut[0] = static_cast<GByte>(wkbNDR);
+    return WriteWkbUInt32( pabyOut + 1, nIsoType );
+}
+
+static GByte* WriteWkbPoints( GByte* pabyOut, int iStart, int iEnd,
+                              const double* padfX, const double* padfY,
+                              const double* padfZ, const double* padfM,
+                              bool bHasZ, bool bHasM )
+{
+    for( int i = iStart; i < iEnd; i++ )
+    {
+        double adfXYZM[4] = { padfX[i], padfY[i], 0.0, 0.0 };
+        int nDims = 2;
+        if( bHasZ )
+            adfXYZM[nDims++] = padfZ ? padfZ[i] : 0.0;
+        if( bHasM )
+            adfXYZM[nDims++] = padfM ? padfM[i] : 0.0;
+        for( int j = 0; j < nDims; j++ )
+        {
+            CPL_LSBPTR64(&adfXYZM[j]);
+        }
+        memcpy( pabyOut, adfXYZM, nDims * sizeof(double) );
+        pabyOut += nDims * sizeof(double);
+    }
+    return pabyOut;
+}
+
+//! @endcond
+
+/************************************************************************/
+/*                          OGRFeatureBatch()                           */
+/************************************************************************/
+
+/**
+ * \brief Constructor.
+ *
+ * The batch is empty and has no definition until Reset() is called, which
+ * is normally done by OGRLayer::GetNextFeatureBatch().
+ *
+ * @since GDAL 2.3
+ */
+
+OGRFeatureBatch::OGRFeatureBatch() :
+    m_poPrivate(new OGRFeatureBatchPrivate())
+{}
+
+/************************************************************************/
+/*                         ~OGRFeatureBatch()                           */
+/************************************************************************/
+
+OGRFeatureBatch::~OGRFeatureBatch()
+{
+    if( m_poPrivate->poDefn )
+        m_poPrivate->poDefn->Release();
+    delete m_poPrivate;
+}
+
+/************************************************************************/
+/*                               Reset()                                */
+/************************************************************************/
+
+/**
+ * \brief Empty the batch and set the feature definition of its columns.
+ *
+ * The column buffers keep their capacity, so reusing the same batch
+ * object for successive calls to OGRLayer::GetNextFeatureBatch() avoids
+ * reallocations.
+ *
+ * @param poDefn feature definition. Its reference count is incremented.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGRFeatureBatch::Reset( OGRFeatureDefn *poDefn )
+{
+    if( poDefn != m_poPrivate->poDefn )
+    {
+        if( poDefn )
+            poDefn->Reference();
+        if( m_poPrivate->poDefn )
+            m_poPrivate->poDefn->Release();
+        m_poPrivate->poDefn = poDefn;
+    }
+
+    const int nFieldCount = poDefn ? poDefn->GetFieldCount() : 0;
+    const int nGeomFieldCount = poDefn ? poDefn->GetGeomFieldCount() : 0;
+    m_poPrivate->nFeatureCount = 0;
+    m_poPrivate->anFIDs.clear();
+    m_poPrivate->aoFields.resize( nFieldCount );
+    m_poPrivate->aoGeomFields.resize( nGeomFieldCount );
+
+    for( int i = 0; i < nFieldCount + nGeomFieldCount; i++ )
+    {
+        OGRFeatureBatchColumn& oCol = i < nFieldCount ?
+            m_poPrivate->aoFields[i] :
+            m_poPrivate->aoGeomFields[i - nFieldCount];
+        oCol.eType = i < nFieldCount ?
+            poDefn->GetFieldDefn(i)->GetType() : OFTBinary;
+        oCol.abyValidity.clear();
+        oCol.abyValues.clear();
+        oCol.anOffsets.clear();
+        if( GetFixedWidth(oCol.eType) == 0 )
+            oCol.anOffsets.push_back(0);
+    }
+}
+
+/************************************************************************/
+/*                             GetDefnRef()                             */
+/************************************************************************/
+
+/**
+ * \brief Return the feature definition of the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+OGRFeatureDefn *OGRFeatureBatch::GetDefnRef()
+{
+    return m_poPrivate->poDefn;
+}
+
+/************************************************************************/
+/*                          GetFeatureCount()                           */
+/************************************************************************/
+
+/**
+ * \brief Return the number of features in the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+int OGRFeatureBatch::GetFeatureCount() const
+{
+    return m_poPrivate->nFeatureCount;
+}
+
+/************************************************************************/
+/*                              GetFIDs()                               */
+/************************************************************************/
+
+/**
+ * \brief Return the array of GetFeatureCount() feature ids.
+ *
+ * @since GDAL 2.3
+ */
+
+const GIntBig *OGRFeatureBatch::GetFIDs() const
+{
+    return GetDataPtr(m_poPrivate->anFIDs);
+}
+
+/************************************************************************/
+/*                         GetFieldValidity()                           */
+/************************************************************************/
+
+/**
+ * \brief Return the validity bitmap of an attribute field.
+ *
+ * Bit (i % 8) of byte (i / 8) is set when feature i has a value for the
+ * field. Fields that are ignored, unset or of a deprecated type never have
+ * their bit set.
+ *
+ * @param iField attribute field index.
+ * @return pointer to (GetFeatureCount() + 7) / 8 bytes, or NULL if the
+ * batch is empty.
+ *
+ * @since GDAL 2.3
+ */
+
+const GByte *OGRFeatureBatch::GetFieldValidity( int iField ) const
+{
+    return GetDataPtr(m_poPrivate->aoFields[iField].abyValidity);
+}
+
+/************************************************************************/
+/*                          GetFieldValues()                            */
+/************************************************************************/
+
+/**
+ * \brief Return the value buffer of an attribute field.
+ *
+ * Depending on the field type, the buffer contains:
+ * <ul>
+ * <li>OFTInteger: one int per feature.</li>
+ * <li>OFTInteger64: one GIntBig per feature.</li>
+ * <li>OFTReal: one double per feature.</li>
+ * <li>OFTDate, OFTTime, OFTDateTime: one OGRField per feature, whose
+ * Date member is valid.</li>
+ * <li>OFTString, OFTBinary: the concatenated bytes of all values, without
+ * terminating nul character, delimited by GetFieldOffsets().</li>
+ * <li>OFTIntegerList, OFTInteger64List, OFTRealList: the concatenated
+ * elements of all lists, delimited by GetFieldOffsets() expressed in
+ * number of elements.</li>
+ * <li>OFTStringList: the nul terminated strings of all lists, delimited by
+ * GetFieldOffsets() expressed in bytes.</li>
+ * </ul>
+ * Values of features whose validity bit is not set are undefined.
+ *
+ * @param iField attribute field index.
+ * @return value buffer, or NULL if it is empty.
+ *
+ * @since GDAL 2.3
+ */
+
+const void *OGRFeatureBatch::GetFieldValues( int iField ) const
+{
+    return GetDataPtr(m_poPrivate->aoFields[iField].abyValues);
+}
+
+/************************************************************************/
+/*                          GetFieldOffsets()                           */
+/************************************************************************/
+
+/**
+ * \brief Return the offsets of a variable length attribute field.
+ *
+ * Values of feature i are located between offsets i and i + 1 of
+ * GetFieldValues().
+ *
+ * @param iField attribute field index.
+ * @return array of GetFeatureCount() + 1 offsets, or NULL for fixed width
+ * field types.
+ *
+ * @since GDAL 2.3
+ */
+
+const size_t *OGRFeatureBatch::GetFieldOffsets( int iField ) const
+{
+    return GetDataPtr(m_poPrivate->aoFields[iField].anOffsets);
+}
+
+/************************************************************************/
+/*                             IsFieldSet()                             */
+/************************************************************************/
+
+/**
+ * \brief Test if an attribute field of a feature of the batch is set.
+ *
+ * @param iFeature feature index in the batch (not its FID).
+ * @param iField attribute field index.
+ *
+ * @since GDAL 2.3
+ */
+
+bool OGRFeatureBatch::IsFieldSet( int iFeature, int iField ) const
+{
+    const GByte* pabyValidity = GetFieldValidity(iField);
+    return (pabyValidity[iFeature >> 3] & (1 << (iFeature & 7))) != 0;
+}
+
+/************************************************************************/
+/*                        GetGeomFieldValidity()                        */
+/************************************************************************/
+
+/**
+ * \brief Return the validity bitmap of a geometry field.
+ *
+ * @see GetFieldValidity()
+ * @since GDAL 2.3
+ */
+
+const GByte *OGRFeatureBatch::GetGeomFieldValidity( int iGeomField ) const
+{
+    return GetDataPtr(m_poPrivate->aoGeomFields[iGeomField].abyValidity);
+}
+
+/************************************************************************/
+/*                          GetGeomFieldWkb()                           */
+/************************************************************************/
+
+/**
+ * \brief Return the concatenated ISO WKB geometries of a geometry field.
+ *
+ * Geometries are encoded in little endian (wkbNDR) byte order. The
+ * geometry of feature i is located between offsets i and i + 1 returned
+ * by GetGeomFieldOffsets().
+ *
+ * @since GDAL 2.3
+ */
+
+const GByte *OGRFeatureBatch::GetGeomFieldWkb( int iGeomField ) const
+{
+    return GetDataPtr(m_poPrivate->aoGeomFields[iGeomField].abyValues);
+}
+
+/************************************************************************/
+/*                        GetGeomFieldOffsets()                         */
+/************************************************************************/
+
+/**
+ * \brief Return the GetFeatureCount() + 1 offsets of a geometry field.
+ *
+ * @see GetGeomFieldWkb()
+ * @since GDAL 2.3
+ */
+
+const size_t *OGRFeatureBatch::GetGeomFieldOffsets( int iGeomField ) const
+{
+    return GetDataPtr(m_poPrivate->aoGeomFields[iGeomField].anOffsets);
+}
+
+/************************************************************************/
+/*                           AppendFeature()                            */
+/************************************************************************/
+
+/**
+ * \brief Append a new feature, with all fields unset, to the batch.
+ *
+ * The SetFieldXXX() and SetGeomFieldXXX() methods then apply to that
+ * feature, and each field must be set at most once. This is meant to be
+ * used by drivers implementing OGRLayer::GetNextFeatureBatch().
+ *
+ * @param nFID feature id.
+ * @return index of the new feature in the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+int OGRFeatureBatch::AppendFeature( GIntBig nFID )
+{
+    const int iFeature = m_poPrivate->nFeatureCount;
+    m_poPrivate->anFIDs.push_back(nFID);
+
+    const size_t nFieldCount = m_poPrivate->aoFields.size();
+    const size_t nGeomFieldCount = m_poPrivate->aoGeomFields.size();
+    for( size_t i = 0; i < nFieldCount + nGeomFieldCount; i++ )
+    {
+        OGRFeatureBatchColumn& oCol = i < nFieldCount ?
+            m_poPrivate->aoFields[i] :
+            m_poPrivate->aoGeomFields[i - nFieldCount];
+        if( (iFeature & 7) == 0 )
+            oCol.abyValidity.push_back(0);
+        const size_t nWidth = GetFixedWidth(oCol.eType);
+        if( nWidth )
+            oCol.abyValues.resize( oCol.abyValues.size() + nWidth );
+        else
+            oCol.anOffsets.push_back( oCol.anOffsets.back() );
+    }
+
+    m_poPrivate->nFeatureCount ++;
+    return iFeature;
+}
+
+/************************************************************************/
+/*                          SetFieldInteger()                           */
+/************************************************************************/
+
+/**
+ * \brief Set an OFTInteger field of the last appended feature.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGRFeatureBatch::SetFieldInteger( int iField, int nValue )
+{
+    OGRFeatureBatchColumn& oCol = m_poPrivate->aoFields[iField];
+    CPLAssert( oCol.eType == OFTInteger );
+    const int iFeature = m_poPrivate->nFeatureCount - 1;
+    memcpy( &oCol.abyValues[iFeature * sizeof(int)], &nValue, sizeof(int) );
+    SetValid( oCol, iFeature );
+}
+
+/************************************************************************/
+/*                         SetFieldInteger64()                          */
+/************************************************************************/
+
+/**
+ * \brief Set an OFTInteger64 field of the last appended feature.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGRFeatureBatch::SetFieldInteger64( int iField, GIntBig nValue )
+{
+    OGRFeatureBatchColumn& oCol = m_poPrivate->aoFields[iField];
+    CPLAssert( oCol.eType == OFTInteger64 );
+    const int iFeature = m_poPrivate->nFeatureCount - 1;
+    memcpy( &oCol.abyValues[iFeature * sizeof(GIntBig)], &nValue,
+            sizeof(GIntBig) );
+    SetValid( oCol, iFeature );
+}
+
+/************************************************************************/
+/*                           SetFieldDouble()                           */
+/************************************************************************/
+
+/**
+ * \brief Set an OFTReal field of the last appended feature.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGRFeatureBatch::SetFieldDouble( int iField, double dfValue )
+{
+    OGRFeatureBatchColumn& oCol = m_poPrivate->aoFields[iField];
+    CPLAssert( oCol.eType == OFTReal );
+    const int iFeature = m_poPrivate->nFeatureCount - 1;
+    memcpy( &oCol.abyValues[iFeature * sizeof(double)], &dfValue,
+            sizeof(double) );
+    SetValid( oCol, iFeature );
+}
+
+/************************************************************************/
+/*                           SetFieldString()                           */
+/************************************************************************/
+
+/**
+ * \brief Set an OFTString field of the last appended feature.
+ *
+ * @param iField attribute field index.
+ * @param pszValue string value, not necessarily nul terminated.
+ * @param nLen length of the string in bytes.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGRFeatureBatch::SetFieldString( int iField, const char *pszValue,
+                                      size_t nLen )
+{
+    OGRFeatureBatchColumn& oCol = m_poPrivate->aoFields[iField];
+    CPLAssert( oCol.eType == OFTString );
+    AppendVarData( oCol, m_poPrivate->nFeatureCount - 1, pszValue, nLen );
+}
+
+/************************************************************************/
+/*                           SetFieldBinary()                           */
+/************************************************************************/
+
+/**
+ * \brief Set an OFTBinary field of the last appended feature.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGRFeatureBatch::SetFieldBinary( int iField, const GByte *pabyData,
+                                      size_t nLen )
+{
+    OGRFeatureBatchColumn& oCol = m_poPrivate->aoFields[iField];
+    CPLAssert( oCol.eType == OFTBinary );
+    AppendVarData( oCol, m_poPrivate->nFeatureCount - 1, pabyData, nLen );
+}
+
+/************************************************************************/
+/*                            SetFieldRaw()                             */
+/************************************************************************/
+
+/**
+ * \brief Set a field of the last appended feature from an OGRField.
+ *
+ * The OGRField must be interpreted according to the field type, as for
+ * OGRFeature::SetField( int, OGRField* ). Unset OGRField values are
+ * skipped.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGRFeatureBatch::SetFieldRaw( int iField, const OGRField *psField )
+{
+    if( psField->Set.nMarker1 == OGRUnsetMarker &&
+        psField->Set.nMarker2 == OGRUnsetMarker )
+        return;
+
+    OGRFeatureBatchColumn& oCol = m_poPrivate->aoFields[iField];
+    const int iFeature = m_poPrivate->nFeatureCount - 1;
+    switch( oCol.eType )
+    {
+        case OFTInteger:
+            SetFieldInteger( iField, psField->Integer );
+            break;
+
+        case OFTInteger64:
+            SetFieldInteger64( iField, psField->Integer64 );
+            break;
+
+        case OFTReal:
+            SetFieldDouble( iField, psField->Real );
+            break;
+
+        case OFTString:
+            if( psField->String != NULL )
+                SetFieldString( iField, psField->String,
+                                strlen(psField->String) );
+            break;
+
+        case OFTBinary:
+            SetFieldBinary( iField, psField->Binary.paData,
+                            psField->Binary.nCount );
+            break;
+
+        case OFTDate:
+        case OFTTime:
+        case OFTDateTime:
+            memcpy( &oCol.abyValues[iFeature * sizeof(OGRField)], psField,
+                    sizeof(OGRField) );
+            SetValid( oCol, iFeature );
+            break;
+
+        case OFTIntegerList:
+            AppendListData( oCol, iFeature, psField->IntegerList.paList,
+                            psField->IntegerList.nCount );
+            break;
+
+        case OFTInteger64List:
+            AppendListData( oCol, iFeature, psField->Integer64List.paList,
+                            psField->Integer64List.nCount );
+            break;
+
+        case OFTRealList:
+            AppendListData( oCol, iFeature, psField->RealList.paList,
+                            psField->RealList.nCount );
+            break;
+
+        case OFTStringList:
+        {
+            for( int i = 0; i < psField->StringList.nCount; i++ )
+            {
+                const char* pszStr = psField->StringList.paList[i];
+                AppendVarData( oCol, iFeature, pszStr, strlen(pszStr) + 1 );
+            }
+            SetValid( oCol, iFeature );
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/************************************************************************/
+/*                          SetGeomFieldWkb()                           */
+/************************************************************************/
+
+/**
+ * \brief Set a geometry field of the last appended feature from ISO WKB.
+ *
+ * The caller is responsible for providing little endian ISO WKB.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGRFeatureBatch::SetGeomFieldWkb( int iGeomField, const GByte *pabyWkb,
+                                       size_t nLen )
+{
+    AppendVarData( m_poPrivate->aoGeomFields[iGeomField],
+                   m_poPrivate->nFeatureCount - 1, pabyWkb, nLen );
+}
+
+/************************************************************************/
+/*                            SetGeomField()                            */
+/************************************************************************/
+
+/**
+ * \brief Set a geometry field of the last appended feature.
+ *
+ * The geometry is exported as little endian ISO WKB. A NULL geometry
+ * leaves the field unset.
+ *
+ * @since GDAL 2.3
+ */
+
+OGRErr OGRFeatureBatch::SetGeomField( int iGeomField,
+                                      const OGRGeometry *poGeom )
+{
+    if( poGeom == NULL )
+        return OGRERR_NONE;
+
+    OGRFeatureBatchColumn& oCol = m_poPrivate->aoGeomFields[iGeomField];
+    const size_t nOldSize = oCol.abyValues.size();
+    const size_t nWkbSize = static_cast<size_t>(poGeom->WkbSize());
+    oCol.abyValues.resize( nOldSize + nWkbSize );
+    const OGRErr eErr =
+        poGeom->exportToWkb( wkbNDR,
+                             nWkbSize ? &oCol.abyValues[nOldSize] : NULL,
+                             wkbVariantIso );
+    if( eErr != OGRERR_NONE )
+    {
+        oCol.abyValues.resize( nOldSize );
+        return eErr;
+    }
+    oCol.anOffsets.back() = oCol.abyValues.size();
+    SetValid( oCol, m_poPrivate->nFeatureCount - 1 );
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                        SetGeomFieldFromParts()                       */
+/************************************************************************/
+
+/**
+ * \brief Set a geometry field of the last appended feature from coordinate
+ * arrays.
+ *
+ * This lets drivers whose native encoding is made of parts of coordinates,
+ * like shapefiles, fill the batch without building an OGRGeometry. The
+ * parts, starting at the indices of panPartStart (NULL for a single part),
+ * are the rings of a polygon, the rings of the single polygon of a
+ * multipolygon, or the members of a multilinestring. Points, multipoints
+ * and linestrings ignore them. The dimension is the one of eType, and
+ * missing Z or M arrays are written as zeroes.
+ *
+ * @param iGeomField geometry field index.
+ * @param eType wkbPoint, wkbMultiPoint, wkbLineString, wkbMultiLineString,
+ *              wkbPolygon or wkbMultiPolygon, with optional Z and M flags.
+ * @param nParts number of parts.
+ * @param panPartStart index of the first point of each part, or NULL.
+ * @param nPoints number of points.
+ * @param padfX X values.
+ * @param padfY Y values.
+ * @param padfZ Z values, or NULL.
+ * @param padfM M values, or NULL.
+ * @return OGRERR_NONE, or OGRERR_UNSUPPORTED_GEOMETRY_TYPE for other
+ * geometry types.
+ *
+ * @since GDAL 2.3
+ */
+
+OGRErr OGRFeatureBatch::SetGeomFieldFromParts( int iGeomField,
+                                               OGRwkbGeometryType eType,
+                                               int nParts,
+                                               const int *panPartStart,
+                                               int nPoints,
+                                               const double *padfX,
+                                               const double *padfY,
+                                               const double *padfZ,
+                                               const double *padfM )
+{
+    const OGRwkbGeometryType eFlatType = wkbFlatten(eType);
+    const bool bHasZ = CPL_TO_BOOL(wkbHasZ(eType));
+    const bool bHasM = CPL_TO_BOOL(wkbHasM(eType));
+    const GUInt32 nDimOffset = (bHasZ ? 1000 : 0) + (bHasM ? 2000 : 0);
+    const size_t nPointSize =
+        sizeof(double) * (2 + (bHasZ ? 1 : 0) + (bHasM ? 1 : 0));
+    if( panPartStart == NULL )
+        nParts = 1;
+
+    size_t nWkbSize = 0;
+    switch( eFlatType )
+    {
+        case wkbPoint:
+            if( nPoints < 1 )
+                return OGRERR_FAILURE;
+            nWkbSize = 5 + nPointSize;
+            break;
+        case wkbMultiPoint:
+            nWkbSize = 9 + nPoints * (5 + nPointSize);
+            break;
+        case wkbLineString:
+            nWkbSize = 9 + nPoints * nPointSize;
+            break;
+        case wkbMultiLineString:
+            nWkbSize = 9 + nParts * 9 + nPoints * nPointSize;
+            break;
+        case wkbPolygon:
+            nWkbSize = 9 + nParts * 4 + nPoints * nPointSize;
+            break;
+        case wkbMultiPolygon:
+            nWkbSize = 18 + nParts * 4 + nPoints * nPointSize;
+            break;
+        default:
+            return OGRERR_UNSUPPORTED_GEOMETRY_TYPE;
+    }
+
+    OGRFeatureBatchColumn& oCol = m_poPrivate->aoGeomFields[iGeomField];
+    const size_t nOldSize = oCol.abyValues.size();
+    oCol.abyValues.resize( nOldSize + nWkbSize );
+    GByte* pabyOut = &oCol.abyValues[nOldSize];
+
+    switch( eFlatType )
+    {
+        case wkbPoint:
+            pabyOut = WriteWkbHeader( pabyOut, wkbPoint + nDimOffset );
+            pabyOut = WriteWkbPoints( pabyOut, 0, 1, padfX, padfY,
+                                      padfZ, padfM, bHasZ, bHasM );
+            break;
+
+        case wkbMultiPoint:
+            pabyOut = WriteWkbHeader( pabyOut, wkbMultiPoint + nDimOffset );
+            pabyOut = WriteWkbUInt32( pabyOut, nPoints );
+            for( int i = 0; i < nPoints; i++ )
+            {
+                pabyOut = WriteWkbHeader( pabyOut, wkbPoint + nDimOffset );
+                pabyOut = WriteWkbPoints( pabyOut, i, i + 1, padfX, padfY,
+                                          padfZ, padfM, bHasZ, bHasM );
+            }
+            break;
+
+        case wkbLineString:
+            pabyOut = WriteWkbHeader( pabyOut, wkbLineString + nDimOffset );
+            pabyOut = WriteWkbUInt32( pabyOut, nPoints );
+            pabyOut = WriteWkbPoints( pabyOut, 0, nPoints, padfX, padfY,
+                                      padfZ, padfM, bHasZ, bHasM );
+            break;
+
+        default:
+        {
+            if( eFlatType == wkbMultiPolygon )
+            {
+                pabyOut = WriteWkbHeader( pabyOut,
+                                          wkbMultiPolygon + nDimOffset );
+                pabyOut = WriteWkbUInt32( pabyOut, 1 );
+            }
+            const bool bPolygon = eFlatType != wkbMultiLineString;
+            pabyOut = WriteWkbHeader( pabyOut,
+                (bPolygon ? wkbPolygon : wkbMultiLineString) + nDimOffset );
+            pabyOut = WriteWkbUInt32( pabyOut, nParts );
+            for( int iPart = 0; iPart < nParts; iPart++ )
+            {
+                const int iStart = panPartStart ? panPartStart[iPart] : 0;
+                const int iEnd = iPart + 1 < nParts ?
+                                        panPartStart[iPart + 1] : nPoints;
+                if( !bPolygon )
+                    pabyOut = WriteWkbHeader( pabyOut,
+                                              wkbLineString + nDimOffset );
+                pabyOut = WriteWkbUInt32( pabyOut, iEnd - iStart );
+                pabyOut = WriteWkbPoints( pabyOut, iStart, iEnd, padfX, padfY,
+                                          padfZ, padfM, bHasZ, bHasM );
+            }
+            break;
+        }
+    }
+    CPLAssert( pabyOut == &oCol.abyValues[0] + nOldSize + nWkbSize );
+
+    oCol.anOffsets.back() = oCol.abyValues.size();
+    SetValid( oCol, m_poPrivate->nFeatureCount - 1 );
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             AddFeature()                             */
+/************************************************************************/
+
+/**
+ * \brief Append the content of a feature to the batch.
+ *
+ * The feature must use the definition of the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+OGRErr OGRFeatureBatch::AddFeature( OGRFeature *poFeature )
+{
+    AppendFeature( poFeature->GetFID() );
+
+    const int nFieldCount = static_cast<int>(m_poPrivate->aoFields.size());
+    for( int iField = 0; iField < nFieldCount; iField++ )
+    {
+        if( poFeature->IsFieldSet(iField) )
+            SetFieldRaw( iField, poFeature->GetRawFieldRef(iField) );
+    }
+
+    const int nGeomFieldCount =
+        static_cast<int>(m_poPrivate->aoGeomFields.size());
+    OGRErr eErr = OGRERR_NONE;
+    for( int iGeomField = 0; iGeomField < nGeomFieldCount; iGeomField++ )
+    {
+        const OGRErr eGeomErr =
+            SetGeomField( iGeomField, poFeature->GetGeomFieldRef(iGeomField) );
+        if( eGeomErr != OGRERR_NONE )
+            eErr = eGeomErr;
+    }
+    return eErr;
+}
@@ -80,7 +80,269 @@ static void OGRGEOSWarningHandler(const char *fmt, ...)
     CPLErrorV( CE_Warning, CPLE_AppDefined, fmt, args );
     va_end(args);
 }
+/************************************************************************/
+/*                       OGRGEOSGetThreadContext()                      */
+/************************************************************************/
+
+static void OGRGEOSFreeThreadContext( void* pData )
+{
+    finishGEOS_r( static_cast<GEOSContextHandle_t>(pData) );
+}
+
+// Returns a GEOS context owned by the calling thread, created on first use
+// and destroyed when the thread terminates. Must not be freed by the caller.
+static GEOSContextHandle_t OGRGEOSGetThreadContext()
+{
+    int bMemoryError = FALSE;
+    GEOSContextHandle_t hGEOSCtxt = static_cast<GEOSContextHandle_t>(
+        CPLGetTLSEx( CTLS_OGRGEOSCONTEXT, &bMemoryError ) );
+    if( bMemoryError )
+        return NULL;
+    if( hGEOSCtxt == NULL )
+    {
+        hGEOSCtxt = initGEOS_r( OGRGEOSWarningHandler, OGRGEOSErrorHandler );
+        if( hGEOSCtxt == NULL )
+            return NULL;
+        CPLSetTLSWithFreeFuncEx( CTLS_OGRGEOSCONTEXT, hGEOSCtxt,
+                                 OGRGEOSFreeThreadContext, &bMemoryError );
+        if( bMemoryError )
+        {
+            finishGEOS_r( hGEOSCtxt );
+            return NULL;
+        }
+    }
+    return hGEOSCtxt;
+}
+#endif
+
+/************************************************************************/
+/*                             OGRGEOSCache                             */
+/************************************************************************/
+
+// GEOS representation of a geometry, kept by setGEOSCacheEnabled().
+// The ISO WKB of the geometry at the time the GEOS geometry was built is
+// kept along and compared with the current one before each use, so that
+// the cache is rebuilt after any modification of the geometry, including
+// modifications made through pointers to its parts.
+
+//! @cond Doxygen_Suppress
+class OGRGEOSCache
+{
+#ifdef HAVE_GEOS
+    bool                        bPrepare;
+    GByte                      *pabyWKB;
+    size_t                      nWKBSize;
+    GEOSGeom                    hGEOSGeom;
+    const GEOSPreparedGeometry *hPreparedGeom;
+
+    bool                        IsUpToDate( const OGRGeometry* poGeom ) const;
+    bool                        Refresh( const OGRGeometry* poGeom,
+                                         GEOSContextHandle_t hGEOSCtxt );
+    void                        Clear();
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRGEOSCache)
+
+  public:
+    explicit OGRGEOSCache( bool bPrepareIn ) :
+        bPrepare(bPrepareIn),
+        pabyWKB(NULL),
+        nWKBSize(0),
+        hGEOSGeom(NULL),
+        hPreparedGeom(NULL) {}
+    ~OGRGEOSCache() { Clear(); }
+
+    bool IsPrepared() const { return bPrepare; }
+
+    static GEOSGeom GetGEOS( const OGRGeometry* poGeom,
+                             GEOSContextHandle_t hGEOSCtxt );
+    static void     ReleaseGEOS( const OGRGeometry* poGeom,
+                                 GEOSContextHandle_t hGEOSCtxt,
+                                 GEOSGeom hGEOSGeom );
+    static const GEOSPreparedGeometry* GetPrepared(
+                                 const OGRGeometry* poGeom,
+                                 GEOSContextHandle_t hGEOSCtxt );
 #endif
+};
+
+#ifdef HAVE_GEOS
+
+/************************************************************************/
+/*                               Clear()                                */
+/************************************************************************/
+
+void OGRGEOSCache::Clear()
+{
+    if( hGEOSGeom != NULL )
+    {
+        // The objects may have been created by another thread, but GEOS
+        // contexts only carry message handlers, so any context will do.
+        GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+        if( hPreparedGeom != NULL )
+            GEOSPreparedGeom_destroy_r( hGEOSCtxt, hPreparedGeom );
+        GEOSGeom_destroy_r( hGEOSCtxt, hGEOSGeom );
+    }
+    hPreparedGeom = NULL;
+    hGEOSGeom = NULL;
+    CPLFree( pabyWKB );
+    pabyWKB = NULL;
+    nWKBSize = 0;
+}
+
+/************************************************************************/
+/*                             IsUpToDate()                             */
+/************************************************************************/
+
+bool OGRGEOSCache::IsUpToDate( const OGRGeometry* poGeom ) const
+{
+    if( hGEOSGeom == NULL ||
+        static_cast<size_t>(poGeom->WkbSize()) != nWKBSize )
+        return false;
+
+    GByte* pabyCurWKB = static_cast<GByte*>(VSI_MALLOC_VERBOSE(nWKBSize));
+    if( pabyCurWKB == NULL )
+        return false;
+    const bool bRet =
+        poGeom->exportToWkb( wkbNDR, pabyCurWKB, wkbVariantIso ) ==
+            OGRERR_NONE &&
+        memcmp( pabyCurWKB, pabyWKB, nWKBSize ) == 0;
+    VSIFree( pabyCurWKB );
+    return bRet;
+}
+
+/************************************************************************/
+/*                              Refresh()                               */
+/************************************************************************/
+
+bool OGRGEOSCache::Refresh( const OGRGeometry* poGeom,
+                            GEOSContextHandle_t hGEOSCtxt )
+{
+    if( IsUpToDate(poGeom) )
+        return true;
+
+    Clear();
+
+    const size_t nSize = static_cast<size_t>(poGeom->WkbSize());
+    pabyWKB = static_cast<GByte*>(VSI_MALLOC_VERBOSE(nSize));
+    if( pabyWKB == NULL )
+        return false;
+    if( poGeom->exportToWkb( wkbNDR, pabyWKB, wkbVariantIso ) !=
+            OGRERR_NONE )
+    {
+        Clear();
+        return false;
+    }
+    nWKBSize = nSize;
+
+    hGEOSGeom = poGeom->exportToGEOS( hGEOSCtxt );
+    if( hGEOSGeom == NULL )
+    {
+        Clear();
+        return false;
+    }
+    if( bPrepare )
+        hPreparedGeom = GEOSPrepare_r( hGEOSCtxt, hGEOSGeom );
+    return true;
+}
+
+/************************************************************************/
+/*                              GetGEOS()                               */
+/************************************************************************/
+
+// Returns the GEOS geometry of poGeom, from its cache if it is enabled.
+// To be released with ReleaseGEOS().
+GEOSGeom OGRGEOSCache::GetGEOS( const OGRGeometry* poGeom,
+                                GEOSContextHandle_t hGEOSCtxt )
+{
+    OGRGEOSCache* poCache = poGeom->m_poGEOSCache;
+    if( poCache != NULL && poCache->Refresh(poGeom, hGEOSCtxt) )
+        return poCache->hGEOSGeom;
+    return poGeom->exportToGEOS( hGEOSCtxt );
+}
+
+/************************************************************************/
+/*                            ReleaseGEOS()                             */
+/************************************************************************/
+
+void OGRGEOSCache::ReleaseGEOS( const OGRGeometry* poGeom,
+                                GEOSContextHandle_t hGEOSCtxt,
+                                GEOSGeom hGEOSGeom )
+{
+    if( hGEOSGeom == NULL )
+        return;
+    OGRGEOSCache* poCache = poGeom->m_poGEOSCache;
+    if( poCache == NULL || poCache->hGEOSGeom != hGEOSGeom )
+        GEOSGeom_destroy_r( hGEOSCtxt, hGEOSGeom );
+}
+
+/************************************************************************/
+/*                            GetPrepared()                             */
+/************************************************************************/
+
+// Returns the cached prepared geometry of poGeom, or NULL if poGeom has
+// no cache with prepared geometry enabled. Owned by the cache.
+const GEOSPreparedGeometry* OGRGEOSCache::GetPrepared(
+    const OGRGeometry* poGeom, GEOSContextHandle_t hGEOSCtxt )
+{
+    OGRGEOSCache* poCache = poGeom->m_poGEOSCache;
+    if( poCache == NULL || !poCache->bPrepare ||
+        !poCache->Refresh(poGeom, hGEOSCtxt) )
+        return NULL;
+    return poCache->hPreparedGeom;
+}
+
+/************************************************************************/
+/*                      OGRGEOSPreparedPredicate()                      */
+/************************************************************************/
+
+// GEOS >= 3.3 for prepared predicates other than intersects and contains.
+#if GEOS_VERSION_MAJOR > 3 || \
+    (GEOS_VERSION_MAJOR == 3 && GEOS_VERSION_MINOR >= 3)
+#define HAVE_GEOS_PREPARED_PREDICATES
+#endif
+
+typedef char (*OGRGEOSPreparedPredicateFunc)( GEOSContextHandle_t,
+                                              const GEOSPreparedGeometry*,
+                                              const GEOSGeometry* );
+
+static int OGRGEOSEvalPreparedPredicate(
+    GEOSContextHandle_t hGEOSCtxt, OGRGEOSPreparedPredicateFunc pfnPredicate,
+    const OGRGeometry* poPrepared, const OGRGeometry* poOther )
+{
+    const GEOSPreparedGeometry* hPreparedGeom =
+        OGRGEOSCache::GetPrepared( poPrepared, hGEOSCtxt );
+    if( hPreparedGeom == NULL )
+        return -1;
+    GEOSGeom hOtherGeosGeom = OGRGEOSCache::GetGEOS( poOther, hGEOSCtxt );
+    if( hOtherGeosGeom == NULL )
+        return -1;
+    const char chRet = pfnPredicate( hGEOSCtxt, hPreparedGeom, hOtherGeosGeom );
+    OGRGEOSCache::ReleaseGEOS( poOther, hGEOSCtxt, hOtherGeosGeom );
+    if( chRet != 0 && chRet != 1 )
+        return -1;
+    return chRet;
+}
+
+// Evaluates a predicate with the cached prepared geometry of poThis, with
+// pfnPredicate(poThis, poOther), or of poOther, with
+// pfnConversePredicate(poOther, poThis) if it is not NULL. Returns TRUE or
+// FALSE, or -1 if no prepared geometry is available or the evaluation
+// failed, in which case the caller should use the regular predicate.
+static int OGRGEOSPreparedPredicate(
+    GEOSContextHandle_t hGEOSCtxt,
+    OGRGEOSPreparedPredicateFunc pfnPredicate,
+    OGRGEOSPreparedPredicateFunc pfnConversePredicate,
+    const OGRGeometry* poThis, const OGRGeometry* poOther )
+{
+    int nRet = OGRGEOSEvalPreparedPredicate( hGEOSCtxt, pfnPredicate,
+                                             poThis, poOther );
+    if( nRet < 0 && pfnConversePredicate != NULL )
+        nRet = OGRGEOSEvalPreparedPredicate( hGEOSCtxt, pfnConversePredicate,
+                                             poOther, poThis );
+    return nRet;
+}
+
+#endif  // HAVE_GEOS
+//! @endcond
 
 /************************************************************************/
 /*                            OGRGeometry()                             */
@@ -90,6 +352,7 @@ OGRGeometry::OGRGeometry()
 
 {
     poSRS = NULL;
+    m_poGEOSCache = NULL;
     flags = 0;
 }
 
@@ -108,6 +371,7 @@ OGRGeometry::OGRGeometry()
 
 OGRGeometry::OGRGeometry( const OGRGeometry& other ) :
     poSRS(other.poSRS),
+    m_poGEOSCache(NULL),
     flags(other.flags)
 {
     if( poSRS != NULL )
@@ -123,6 +387,7 @@ OGRGeometry::~OGRGeometry()
 {
     if( poSRS != NULL )
         poSRS->Release();
+    delete m_poGEOSCache;
 }
 
 /************************************************************************/
@@ -537,9 +802,15 @@ OGRBoolean OGRGeometry::Intersects( const OGRGeometry *poOtherGeom ) const
 #else
 
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    GEOSGeom hThisGeosGeom  = exportToGEOS(hGEOSCtxt);
-    GEOSGeom hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    const int nPreparedResult =
+        OGRGEOSPreparedPredicate( hGEOSCtxt, GEOSPreparedIntersects_r,
+                                  GEOSPreparedIntersects_r, this, poOtherGeom );
+    if( nPreparedResult >= 0 )
+        return nPreparedResult;
+
+    GEOSGeom hThisGeosGeom  = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
+    GEOSGeom hOtherGeosGeom = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
 
     OGRBoolean bResult = FALSE;
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
@@ -548,9 +819,8 @@ OGRBoolean OGRGeometry::Intersects( const OGRGeometry *poOtherGeom ) const
             GEOSIntersects_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom ) != 0;
     }
 
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
+    OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 #endif  // HAVE_GEOS
@@ -2060,15 +2330,14 @@ OGRGeometry::IsValid() const
 #else
         OGRBoolean bResult = FALSE;
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-        GEOSGeom hThisGeosGeom = exportToGEOS(hGEOSCtxt);
+        GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+        GEOSGeom hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
 
         if( hThisGeosGeom != NULL  )
         {
             bResult = GEOSisValid_r( hGEOSCtxt, hThisGeosGeom );
-            GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
+            OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
         }
-        freeGEOSContext( hGEOSCtxt );
 
         return bResult;
 
@@ -2133,15 +2402,14 @@ OGRGeometry::IsSimple() const
 
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    GEOSGeom hThisGeosGeom = exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    GEOSGeom hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
 
     if( hThisGeosGeom != NULL )
     {
         bResult = GEOSisSimple_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
     }
-    freeGEOSContext( hGEOSCtxt );
 
     return bResult;
 
@@ -2204,15 +2472,14 @@ OGRGeometry::IsRing() const
 
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    GEOSGeom hThisGeosGeom = exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    GEOSGeom hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
 
     if( hThisGeosGeom != NULL )
     {
         bResult = GEOSisRing_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
     }
-    freeGEOSContext( hGEOSCtxt );
 
     return bResult;
 
@@ -3015,6 +3282,88 @@ GEOSGeom OGRGeometry::exportToGEOS(
 #endif  // HAVE_GEOS
 }
 
+/************************************************************************/
+/*                        setGEOSCacheEnabled()                         */
+/************************************************************************/
+
+/**
+ * \brief Enable or disable caching of the GEOS representation of the
+ * geometry.
+ *
+ * By default, each GEOS based method (Intersects(), Contains(),
+ * Intersection(), Buffer(), IsValid(), ...) converts the geometries it
+ * works on to GEOS and discards the conversion afterwards. When the cache
+ * is enabled, the GEOS geometry built at the first such call is kept with
+ * the geometry and reused by the following calls, for this geometry
+ * used either as the object or as the argument of the operation. If
+ * bPrepared is TRUE, a GEOS prepared geometry is also built, and used
+ * by the Intersects(), Disjoint(), Touches(), Crosses(), Within(),
+ * Contains() and Overlaps() predicates. This is mostly useful when a
+ * geometry is tested against many other geometries.
+ *
+ * The cache is checked against the current content of the geometry before
+ * each use and rebuilt if the geometry has been modified, in whatever way.
+ * That check costs a serialization of the geometry to WKB, which is still
+ * much cheaper than the conversion to GEOS. A geometry whose cache is
+ * enabled must not be used concurrently by several threads, even through
+ * const methods.
+ *
+ * The cache is not copied by clone() or the copy constructor. Without
+ * GEOS support, this method does nothing.
+ *
+ * This method is the same as the C function OGR_G_SetGEOSCacheEnabled().
+ *
+ * @param bEnable TRUE to enable the cache, FALSE to disable it and release
+ * its resources.
+ * @param bPrepared TRUE to also cache a prepared geometry. Ignored if
+ * bEnable is FALSE.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGRGeometry::setGEOSCacheEnabled( UNUSED_IF_NO_GEOS OGRBoolean bEnable,
+                                       UNUSED_IF_NO_GEOS OGRBoolean bPrepared )
+{
+#ifdef HAVE_GEOS
+    if( bEnable && m_poGEOSCache != NULL &&
+        m_poGEOSCache->IsPrepared() == CPL_TO_BOOL(bPrepared) )
+        return;
+    delete m_poGEOSCache;
+    m_poGEOSCache =
+        bEnable ? new OGRGEOSCache( CPL_TO_BOOL(bPrepared) ) : NULL;
+#endif
+}
+
+/************************************************************************/
+/*                     OGR_G_SetGEOSCacheEnabled()                      */
+/************************************************************************/
+
+/**
+ * \brief Enable or disable caching of the GEOS representation of the
+ * geometry.
+ *
+ * See OGRGeometry::setGEOSCacheEnabled() for the details.
+ *
+ * This function is the same as the C++ method
+ * OGRGeometry::setGEOSCacheEnabled().
+ *
+ * @param hGeom handle on the geometry.
+ * @param bEnable TRUE to enable the cache, FALSE to disable it.
+ * @param bPrepared TRUE to also cache a prepared geometry.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGR_G_SetGEOSCacheEnabled( OGRGeometryH hGeom, int bEnable,
+                                int bPrepared )
+
+{
+    VALIDATE_POINTER0( hGeom, "OGR_G_SetGEOSCacheEnabled" );
+
+    reinterpret_cast<OGRGeometry *>(hGeom)->
+        setGEOSCacheEnabled( bEnable, bPrepared );
+}
+
 /************************************************************************/
 /*                         hasCurveGeometry()                           */
 /************************************************************************/
@@ -3192,10 +3541,10 @@ double OGRGeometry::Distance( const OGRGeometry *poOtherGeom ) const
 
     #else
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
+        GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
         // GEOSGeom is a pointer
-        GEOSGeom hOther = poOtherGeom->exportToGEOS(hGEOSCtxt);
-        GEOSGeom hThis = exportToGEOS(hGEOSCtxt);
+        GEOSGeom hOther = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
+        GEOSGeom hThis = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
 
         int bIsErr = 0;
         double dfDistance = 0.0;
@@ -3205,9 +3554,8 @@ double OGRGeometry::Distance( const OGRGeometry *poOtherGeom ) const
             bIsErr = GEOSDistance_r( hGEOSCtxt, hThis, hOther, &dfDistance );
         }
 
-        GEOSGeom_destroy_r( hGEOSCtxt, hThis );
-        GEOSGeom_destroy_r( hGEOSCtxt, hOther );
-        freeGEOSContext( hGEOSCtxt );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThis );
+        OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOther );
 
         if ( bIsErr > 0 )
         {
@@ -3443,12 +3791,12 @@ OGRGeometry *OGRGeometry::ConvexHull() const
 
         OGRGeometry *poOGRProduct = NULL;
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-        GEOSGeom hGeosGeom = exportToGEOS(hGEOSCtxt);
+        GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+        GEOSGeom hGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
         if( hGeosGeom != NULL )
         {
             GEOSGeom hGeosHull = GEOSConvexHull_r( hGEOSCtxt, hGeosGeom );
-            GEOSGeom_destroy_r( hGEOSCtxt, hGeosGeom );
+            OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hGeosGeom );
 
             if( hGeosHull != NULL )
             {
@@ -3461,7 +3809,6 @@ OGRGeometry *OGRGeometry::ConvexHull() const
                 GEOSGeom_destroy_r( hGEOSCtxt, hGeosHull);
             }
         }
-        freeGEOSContext( hGEOSCtxt );
 
         return poOGRProduct;
 
@@ -3537,12 +3884,12 @@ OGRGeometry *OGRGeometry::Boundary() const
     GEOSGeom hGeosGeom = NULL;
     OGRGeometry *poOGRProduct = NULL;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hGeosGeom = exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    hGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
     if( hGeosGeom != NULL )
     {
         GEOSGeom hGeosProduct = GEOSBoundary_r( hGEOSCtxt, hGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hGeosGeom );
 
         if( hGeosProduct != NULL )
         {
@@ -3554,7 +3901,6 @@ OGRGeometry *OGRGeometry::Boundary() const
             GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
         }
     }
-    freeGEOSContext( hGEOSCtxt );
 
     return poOGRProduct;
 
@@ -3673,13 +4019,13 @@ OGRGeometry *OGRGeometry::Buffer( UNUSED_IF_NO_GEOS double dfDist,
     GEOSGeom hGeosGeom = NULL;
     OGRGeometry *poOGRProduct = NULL;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hGeosGeom = exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    hGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
     if( hGeosGeom != NULL )
     {
         GEOSGeom hGeosProduct =
             GEOSBuffer_r( hGEOSCtxt, hGeosGeom, dfDist, nQuadSegs );
-        GEOSGeom_destroy_r( hGEOSCtxt, hGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hGeosGeom );
 
         if( hGeosProduct != NULL )
         {
@@ -3691,7 +4037,6 @@ OGRGeometry *OGRGeometry::Buffer( UNUSED_IF_NO_GEOS double dfDist,
             GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
         }
     }
-    freeGEOSContext(hGEOSCtxt);
 
     return poOGRProduct;
 
@@ -3819,9 +4164,9 @@ OGRGeometry *OGRGeometry::Intersection(
         GEOSGeom hGeosProduct = NULL;
         OGRGeometry *poOGRProduct = NULL;
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-        hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-        hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+        GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+        hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
+        hOtherGeosGeom = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
         if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
         {
             hGeosProduct = GEOSIntersection_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
@@ -3839,9 +4184,8 @@ OGRGeometry *OGRGeometry::Intersection(
                 GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
             }
         }
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-        freeGEOSContext( hGEOSCtxt );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOtherGeosGeom );
 
         return poOGRProduct;
 
@@ -3963,9 +4307,9 @@ OGRGeometry *OGRGeometry::Union(
         GEOSGeom hGeosProduct = NULL;
         OGRGeometry *poOGRProduct = NULL;
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-        hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-        hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+        GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+        hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
+        hOtherGeosGeom = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
         if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
         {
             hGeosProduct = GEOSUnion_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
@@ -3983,9 +4327,8 @@ OGRGeometry *OGRGeometry::Union(
                 GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
             }
         }
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-        freeGEOSContext( hGEOSCtxt );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOtherGeosGeom );
 
         return poOGRProduct;
 
@@ -4057,12 +4400,12 @@ OGRGeometry *OGRGeometry::UnionCascaded() const
     GEOSGeom hThisGeosGeom = NULL;
     OGRGeometry *poOGRProduct = NULL;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
     if( hThisGeosGeom != NULL )
     {
         GEOSGeom hGeosProduct = GEOSUnionCascaded_r(hGEOSCtxt, hThisGeosGeom);
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
 
         if( hGeosProduct != NULL )
         {
@@ -4074,7 +4417,6 @@ OGRGeometry *OGRGeometry::UnionCascaded() const
             GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
         }
     }
-    freeGEOSContext( hGEOSCtxt );
 
     return poOGRProduct;
 
@@ -4188,9 +4530,9 @@ OGRGeometry *OGRGeometry::Difference(
         GEOSGeom hGeosProduct = NULL;
         OGRGeometry *poOGRProduct = NULL;
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-        hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-        hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+        GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+        hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
+        hOtherGeosGeom = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
         if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
         {
             hGeosProduct = GEOSDifference_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
@@ -4208,9 +4550,8 @@ OGRGeometry *OGRGeometry::Difference(
                 GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
             }
         }
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-        freeGEOSContext( hGEOSCtxt );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOtherGeosGeom );
 
         return poOGRProduct;
 
@@ -4318,9 +4659,9 @@ OGRGeometry::SymDifference(
     GEOSGeom hOtherGeosGeom = NULL;
     OGRGeometry *poOGRProduct = NULL;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
+    hOtherGeosGeom = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         GEOSGeom hGeosProduct =
@@ -4342,9 +4683,8 @@ OGRGeometry::SymDifference(
             GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
         }
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
+    OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOtherGeosGeom );
 
     return poOGRProduct;
 
@@ -4459,16 +4799,22 @@ OGRGeometry::Disjoint( UNUSED_IF_NO_GEOS const OGRGeometry *poOtherGeom ) const
     GEOSGeom hOtherGeosGeom = NULL;
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+#ifdef HAVE_GEOS_PREPARED_PREDICATES
+    const int nPreparedResult =
+        OGRGEOSPreparedPredicate( hGEOSCtxt, GEOSPreparedDisjoint_r,
+                                  GEOSPreparedDisjoint_r, this, poOtherGeom );
+    if( nPreparedResult >= 0 )
+        return nPreparedResult;
+#endif
+    hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
+    hOtherGeosGeom = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         bResult = GEOSDisjoint_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
+    OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 
@@ -4542,17 +4888,23 @@ OGRGeometry::Touches( UNUSED_IF_NO_GEOS const OGRGeometry *poOtherGeom ) const
     GEOSGeom hOtherGeosGeom = NULL;
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+#ifdef HAVE_GEOS_PREPARED_PREDICATES
+    const int nPreparedResult =
+        OGRGEOSPreparedPredicate( hGEOSCtxt, GEOSPreparedTouches_r,
+                                  GEOSPreparedTouches_r, this, poOtherGeom );
+    if( nPreparedResult >= 0 )
+        return nPreparedResult;
+#endif
+    hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
+    hOtherGeosGeom = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
 
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         bResult = GEOSTouches_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
+    OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 
@@ -4656,17 +5008,23 @@ OGRGeometry::Crosses( UNUSED_PARAMETER const OGRGeometry *poOtherGeom ) const
         GEOSGeom hOtherGeosGeom = NULL;
         OGRBoolean bResult = FALSE;
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-        hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-        hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+        GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+#ifdef HAVE_GEOS_PREPARED_PREDICATES
+        const int nPreparedResult =
+            OGRGEOSPreparedPredicate( hGEOSCtxt, GEOSPreparedCrosses_r,
+                                      NULL, this, poOtherGeom );
+        if( nPreparedResult >= 0 )
+            return nPreparedResult;
+#endif
+        hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
+        hOtherGeosGeom = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
 
         if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
         {
             bResult = GEOSCrosses_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
         }
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-        freeGEOSContext( hGEOSCtxt );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOtherGeosGeom );
 
         return bResult;
 
@@ -4741,16 +5099,22 @@ OGRGeometry::Within( UNUSED_IF_NO_GEOS const OGRGeometry *poOtherGeom ) const
     GEOSGeom hOtherGeosGeom = NULL;
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+#ifdef HAVE_GEOS_PREPARED_PREDICATES
+    const int nPreparedResult =
+        OGRGEOSPreparedPredicate( hGEOSCtxt, GEOSPreparedWithin_r,
+                                  GEOSPreparedContains_r, this, poOtherGeom );
+    if( nPreparedResult >= 0 )
+        return nPreparedResult;
+#endif
+    hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
+    hOtherGeosGeom = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         bResult = GEOSWithin_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
+    OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 
@@ -4824,16 +5188,22 @@ OGRGeometry::Contains( UNUSED_IF_NO_GEOS const OGRGeometry *poOtherGeom ) const
     GEOSGeom hOtherGeosGeom = NULL;
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+#ifdef HAVE_GEOS_PREPARED_PREDICATES
+    const int nPreparedResult =
+        OGRGEOSPreparedPredicate( hGEOSCtxt, GEOSPreparedContains_r,
+                                  GEOSPreparedWithin_r, this, poOtherGeom );
+    if( nPreparedResult >= 0 )
+        return nPreparedResult;
+#endif
+    hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
+    hOtherGeosGeom = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         bResult = GEOSContains_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
+    OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 
@@ -4908,16 +5278,22 @@ OGRGeometry::Overlaps( UNUSED_IF_NO_GEOS const OGRGeometry *poOtherGeom ) const
     GEOSGeom hOtherGeosGeom = NULL;
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+#ifdef HAVE_GEOS_PREPARED_PREDICATES
+    const int nPreparedResult =
+        OGRGEOSPreparedPredicate( hGEOSCtxt, GEOSPreparedOverlaps_r,
+                                  GEOSPreparedOverlaps_r, this, poOtherGeom );
+    if( nPreparedResult >= 0 )
+        return nPreparedResult;
+#endif
+    hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
+    hOtherGeosGeom = OGRGEOSCache::GetGEOS(poOtherGeom, hGEOSCtxt);
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         bResult = GEOSOverlaps_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
+    OGRGEOSCache::ReleaseGEOS( poOtherGeom, hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 
@@ -5037,17 +5413,16 @@ OGRErr OGRGeometry::Centroid( OGRPoint *poPoint ) const
 
     GEOSGeom hThisGeosGeom = NULL;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
 
     if( hThisGeosGeom != NULL )
     {
         GEOSGeom hOtherGeosGeom = GEOSGetCentroid_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
 
         if( hOtherGeosGeom == NULL )
         {
-            freeGEOSContext( hGEOSCtxt );
             return OGRERR_FAILURE;
         }
 
@@ -5058,13 +5433,11 @@ OGRErr OGRGeometry::Centroid( OGRPoint *poPoint ) const
 
         if( poCentroidGeom == NULL )
         {
-            freeGEOSContext( hGEOSCtxt );
             return OGRERR_FAILURE;
         }
         if( wkbFlatten(poCentroidGeom->getGeometryType()) != wkbPoint )
         {
             delete poCentroidGeom;
-            freeGEOSContext( hGEOSCtxt );
             return OGRERR_FAILURE;
         }
 
@@ -5077,7 +5450,6 @@ OGRErr OGRGeometry::Centroid( OGRPoint *poPoint ) const
             CPLError(CE_Fatal, CPLE_AppDefined,
                      "dynamic_cast failed.  Expected OGRPoint.");
             delete poCentroidGeom;
-            freeGEOSContext( hGEOSCtxt );
             return OGRERR_FAILURE;
         }
 
@@ -5093,12 +5465,10 @@ OGRErr OGRGeometry::Centroid( OGRPoint *poPoint ) const
 
         delete poCentroidGeom;
 
-        freeGEOSContext( hGEOSCtxt );
         return OGRERR_NONE;
     }
     else
     {
-        freeGEOSContext( hGEOSCtxt );
         return OGRERR_FAILURE;
     }
 
@@ -5190,18 +5560,17 @@ OGRGeometryH OGR_G_PointOnSurface( OGRGeometryH hGeom )
     GEOSGeom hThisGeosGeom = NULL;
     OGRGeometry* poThis = reinterpret_cast<OGRGeometry *>(hGeom);
 
-    GEOSContextHandle_t hGEOSCtxt = OGRGeometry::createGEOSContext();
-    hThisGeosGeom = poThis->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    hThisGeosGeom = OGRGEOSCache::GetGEOS(poThis, hGEOSCtxt);
 
     if( hThisGeosGeom != NULL )
     {
         GEOSGeom hOtherGeosGeom =
             GEOSPointOnSurface_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( poThis, hGEOSCtxt, hThisGeosGeom );
 
         if( hOtherGeosGeom == NULL )
         {
-            OGRGeometry::freeGEOSContext( hGEOSCtxt );
             return NULL;
         }
 
@@ -5212,13 +5581,11 @@ OGRGeometryH OGR_G_PointOnSurface( OGRGeometryH hGeom )
 
         if( poInsidePointGeom == NULL )
         {
-            OGRGeometry::freeGEOSContext( hGEOSCtxt );
             return NULL;
         }
         if( wkbFlatten(poInsidePointGeom->getGeometryType()) != wkbPoint )
         {
             delete poInsidePointGeom;
-            OGRGeometry::freeGEOSContext( hGEOSCtxt );
             return NULL;
         }
 
@@ -5226,11 +5593,9 @@ OGRGeometryH OGR_G_PointOnSurface( OGRGeometryH hGeom )
             poInsidePointGeom->
                 assignSpatialReference(poThis->getSpatialReference());
 
-        OGRGeometry::freeGEOSContext( hGEOSCtxt );
         return reinterpret_cast<OGRGeometryH>(poInsidePointGeom);
     }
 
-    OGRGeometry::freeGEOSContext( hGEOSCtxt );
     return NULL;
 #endif
 }
@@ -5299,13 +5664,13 @@ OGRGeometry *OGRGeometry::Simplify( UNUSED_IF_NO_GEOS double dTolerance ) const
 #else
     OGRGeometry *poOGRProduct = NULL;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    GEOSGeom hThisGeosGeom = exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    GEOSGeom hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
     if( hThisGeosGeom != NULL )
     {
         GEOSGeom hGeosProduct =
             GEOSSimplify_r( hGEOSCtxt, hThisGeosGeom, dTolerance );
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
         if( hGeosProduct != NULL )
         {
             poOGRProduct =
@@ -5316,7 +5681,6 @@ OGRGeometry *OGRGeometry::Simplify( UNUSED_IF_NO_GEOS double dTolerance ) const
             GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
         }
     }
-    freeGEOSContext( hGEOSCtxt );
     return poOGRProduct;
 
 #endif  // HAVE_GEOS
@@ -5387,14 +5751,14 @@ OGRGeometry *OGRGeometry::SimplifyPreserveTopology(
     GEOSGeom hThisGeosGeom = NULL;
     OGRGeometry *poOGRProduct = NULL;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
     if( hThisGeosGeom != NULL )
     {
         GEOSGeom hGeosProduct =
             GEOSTopologyPreserveSimplify_r( hGEOSCtxt, hThisGeosGeom,
                                             dTolerance );
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
         if( hGeosProduct != NULL )
         {
             poOGRProduct =
@@ -5405,7 +5769,6 @@ OGRGeometry *OGRGeometry::SimplifyPreserveTopology(
             GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
         }
     }
-    freeGEOSContext( hGEOSCtxt );
     return poOGRProduct;
 
 #endif  // HAVE_GEOS
@@ -5491,14 +5854,14 @@ OGRGeometry *OGRGeometry::DelaunayTriangulation( double dfTolerance,
     GEOSGeom hThisGeosGeom = NULL;
     OGRGeometry *poOGRProduct = NULL;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
+    hThisGeosGeom = OGRGEOSCache::GetGEOS(this, hGEOSCtxt);
     if( hThisGeosGeom != NULL )
     {
         GEOSGeom hGeosProduct =
             GEOSDelaunayTriangulation_r( hGEOSCtxt, hThisGeosGeom, dfTolerance,
                                          bOnlyEdges );
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
+        OGRGEOSCache::ReleaseGEOS( this, hGEOSCtxt, hThisGeosGeom );
         if( hGeosProduct != NULL )
         {
             poOGRProduct =
@@ -5508,7 +5871,6 @@ OGRGeometry *OGRGeometry::DelaunayTriangulation( double dfTolerance,
             GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
         }
     }
-    freeGEOSContext( hGEOSCtxt );
     return poOGRProduct;
 }
 #endif
@@ -5610,7 +5972,7 @@ OGRGeometry *OGRGeometry::Polygonize() const
     OGRGeometry *poPolygsOGRGeom = NULL;
     bool bError = false;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
+    GEOSContextHandle_t hGEOSCtxt = OGRGEOSGetThreadContext();
 
     hGeosGeomList = new GEOSGeom [iCount];
     for( int ig = 0; ig < iCount; ig++ )
@@ -5651,7 +6013,6 @@ OGRGeometry *OGRGeometry::Polygonize() const
             GEOSGeom_destroy_r( hGEOSCtxt, hGeosGeom );
     }
     delete [] hGeosGeomList;
-    freeGEOSContext( hGEOSCtxt );
 
     return poPolygsOGRGeom;
 
@@ -5820,7 +6181,7 @@ int OGRPreparedGeometryIntersects(
         return FALSE;
 
     GEOSGeom hGEOSOtherGeom =
-        poOtherGeom->exportToGEOS(poPreparedGeom->hGEOSCtxt);
+        OGRGEOSCache::GetGEOS(poOtherGeom, poPreparedGeom->hGEOSCtxt);
     if( hGEOSOtherGeom == NULL )
         return FALSE;
 
@@ -5828,7 +6189,8 @@ int OGRPreparedGeometryIntersects(
         GEOSPreparedIntersects_r(poPreparedGeom->hGEOSCtxt,
                                  poPreparedGeom->poPreparedGEOSGeom,
                                  hGEOSOtherGeom));
-    GEOSGeom_destroy_r( poPreparedGeom->hGEOSCtxt, hGEOSOtherGeom );
+    OGRGEOSCache::ReleaseGEOS( poOtherGeom, poPreparedGeom->hGEOSCtxt,
+                               hGEOSOtherGeom );
 
     return bRet;
 #else
@@ -5850,7 +6212,7 @@ int OGRPreparedGeometryContains(
         return FALSE;
 
     GEOSGeom hGEOSOtherGeom =
-        poOtherGeom->exportToGEOS(poPreparedGeom->hGEOSCtxt);
+        OGRGEOSCache::GetGEOS(poOtherGeom, poPreparedGeom->hGEOSCtxt);
     if( hGEOSOtherGeom == NULL )
         return FALSE;
 
@@ -5858,7 +6220,8 @@ int OGRPreparedGeometryContains(
         GEOSPreparedContains_r(poPreparedGeom->hGEOSCtxt,
                                poPreparedGeom->poPreparedGEOSGeom,
                                hGEOSOtherGeom));
-    GEOSGeom_destroy_r( poPreparedGeom->hGEOSCtxt, hGEOSOtherGeom );
+    OGRGEOSCache::ReleaseGEOS( poOtherGeom, poPreparedGeom->hGEOSCtxt,
+                               hGEOSOtherGeom );
 
     return bRet;
 #else
@@ -32,6 +32,7 @@
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_quad_tree.h"
 #include "cpl_string.h"
 #include "ogr_geometry.h"
 #include "ogr_api.h"
@@ -52,6 +53,7 @@
 #include <cstddef>
 
 #include <algorithm>
+#include <functional>
 #include <new>
 #include <utility>
 #include <vector>
@@ -1280,8 +1282,235 @@ static int OGRGeometryFactoryCompareByIndex(const void* p1, const void* p2)
         return 0;
 }
 
+/************************************************************************/
+/*                          OGRRingPointTester                          */
+/************************************************************************/
+
+// Point in ring and point on boundary tests against a ring that is tested
+// many times (typically the outer ring of a polygon with many holes). The
+// edges of the ring are bucketed into horizontal bands, so that a point in
+// ring test only visits the edges whose Y extent covers the band of the
+// tested point.
+
+class OGRRingPointTester
+{
+    const OGRLinearRing *poRing;
+    double               dfMinY;
+    double               dfInvBandHeight;
+    int                  nBands;
+    std::vector<int>     anBandStart;  // nBands + 1 offsets into anEdges.
+    std::vector<int>     anEdges;      // Edge k goes from point k-1 to k.
+
+    int                  GetBand( double dfY ) const;
+    bool                 BuildIndex( int nBandsIn );
+    void                 GetEdges( double dfY,
+                                   const int*& panEdges, int& nEdges ) const;
+
+  public:
+    explicit             OGRRingPointTester( const OGRLinearRing* poRingIn );
+
+    bool                 IsPointInRing( double dfX, double dfY ) const;
+    bool                 IsPointOnRingBoundary( double dfX, double dfY ) const;
+};
+
+// Below that number of points, edges are simply all visited.
+static const int N_MIN_POINTS_FOR_RING_INDEX = 32;
+
+OGRRingPointTester::OGRRingPointTester( const OGRLinearRing* poRingIn ) :
+    poRing(poRingIn),
+    dfMinY(0.0),
+    dfInvBandHeight(0.0),
+    nBands(1)
+{
+    const int nPoints = poRing->getNumPoints();
+    if( nPoints < N_MIN_POINTS_FOR_RING_INDEX )
+        return;
+
+    OGREnvelope sEnvelope;
+    poRing->getEnvelope(&sEnvelope);
+    if( !(sEnvelope.MaxY > sEnvelope.MinY) )
+        return;
+    dfMinY = sEnvelope.MinY;
+
+    // Aim at a few edges per band, but use less bands if many edges span
+    // a lot of them, so that the index remains linear in size.
+    for( int nBandsTry = nPoints / 4; nBandsTry > 1; nBandsTry /= 2 )
+    {
+        dfInvBandHeight = nBandsTry / (sEnvelope.MaxY - sEnvelope.MinY);
+        if( BuildIndex(nBandsTry) )
+            return;
+    }
+    nBands = 1;
+    anBandStart.clear();
+    anEdges.clear();
+}
+
+/************************************************************************/
+/*                              GetBand()                               */
+/************************************************************************/
+
+// Monotonic in dfY, so that a point whose Y is in the Y extent of an edge
+// always falls in one of the bands the edge has been registered in.
+int OGRRingPointTester::GetBand( double dfY ) const
+{
+    const double dfBand = (dfY - dfMinY) * dfInvBandHeight;
+    if( !(dfBand > 0) )
+        return 0;
+    if( dfBand >= nBands - 1 )
+        return nBands - 1;
+    return static_cast<int>(dfBand);
+}
+
+/************************************************************************/
+/*                             BuildIndex()                             */
+/************************************************************************/
+
+bool OGRRingPointTester::BuildIndex( int nBandsIn )
+{
+    nBands = nBandsIn;
+    const int nPoints = poRing->getNumPoints();
+    const GIntBig nMaxEntries = static_cast<GIntBig>(nPoints) * 8;
+
+    anBandStart.assign(nBands + 1, 0);
+    GIntBig nEntries = 0;
+    for( int k = 1; k < nPoints; k++ )
+    {
+        const double dfY1 = poRing->getY(k - 1);
+        const double dfY2 = poRing->getY(k);
+        const int iBand1 = GetBand(std::min(dfY1, dfY2));
+        const int iBand2 = GetBand(std::max(dfY1, dfY2));
+        nEntries += iBand2 - iBand1 + 1;
+        if( nEntries > nMaxEntries )
+            return false;
+        for( int iBand = iBand1; iBand <= iBand2; iBand++ )
+            anBandStart[iBand + 1]++;
+    }
+    for( int iBand = 0; iBand < nBands; iBand++ )
+        anBandStart[iBand + 1] += anBandStart[iBand];
+
+    anEdges.resize(static_cast<size_t>(nEntries));
+    std::vector<int> anFill(anBandStart.begin(), anBandStart.end() - 1);
+    for( int k = 1; k < nPoints; k++ )
+    {
+        const double dfY1 = poRing->getY(k - 1);
+        const double dfY2 = poRing->getY(k);
+        const int iBand1 = GetBand(std::min(dfY1, dfY2));
+        const int iBand2 = GetBand(std::max(dfY1, dfY2));
+        for( int iBand = iBand1; iBand <= iBand2; iBand++ )
+            anEdges[anFill[iBand]++] = k;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                              GetEdges()                              */
+/************************************************************************/
+
+// Return the edges to visit for a point of ordinate dfY, or NULL if all
+// edges must be visited.
+void OGRRingPointTester::GetEdges( double dfY,
+                                   const int*& panEdges, int& nEdges ) const
+{
+    if( anEdges.empty() )
+    {
+        panEdges = NULL;
+        nEdges = poRing->getNumPoints() - 1;
+        return;
+    }
+    const int iBand = GetBand(dfY);
+    panEdges = &anEdges[0] + anBandStart[iBand];
+    nEdges = anBandStart[iBand + 1] - anBandStart[iBand];
+}
+
+/************************************************************************/
+/*                           IsPointInRing()                            */
+/************************************************************************/
+
+// Same crossing number computation as OGRLinearRing::isPointInRing(), only
+// restricted to the edges that may cross the ray.
+bool OGRRingPointTester::IsPointInRing( double dfX, double dfY ) const
+{
+    if( poRing->getNumPoints() < 4 )
+        return false;
+
+    const int* panEdges = NULL;
+    int nEdges = 0;
+    GetEdges(dfY, panEdges, nEdges);
+
+    int nCrossings = 0;
+    for( int i = 0; i < nEdges; i++ )
+    {
+        const int k = panEdges ? panEdges[i] : i + 1;
+        const double x1 = poRing->getX(k) - dfX;
+        const double y1 = poRing->getY(k) - dfY;
+        const double x2 = poRing->getX(k - 1) - dfX;
+        const double y2 = poRing->getY(k - 1) - dfY;
+
+        if( ( ( y1 > 0 ) && ( y2 <= 0 ) ) || ( ( y2 > 0 ) && ( y1 <= 0 ) ) )
+        {
+            const double dfIntersection = ( x1 * y2 - x2 * y1 ) / (y2 - y1);
+            if( 0.0 < dfIntersection )
+                nCrossings++;
+        }
+    }
+
+    return (nCrossings % 2) != 0;
+}
+
+/************************************************************************/
+/*                       IsPointOnRingBoundary()                        */
+/************************************************************************/
+
+// Same test as OGRLinearRing::isPointOnRingBoundary(): the point is reported
+// as on the boundary if it is aligned with any edge, even outside of the edge
+// segment. As aligned edges may be anywhere in the ring, all edges are
+// visited.
+bool OGRRingPointTester::IsPointOnRingBoundary( double dfX, double dfY ) const
+{
+    const int nPoints = poRing->getNumPoints();
+    if( nPoints < 4 )
+        return false;
+
+    double prev_diff_x = poRing->getX(0) - dfX;
+    double prev_diff_y = poRing->getY(0) - dfY;
+
+    for( int k = 1; k < nPoints; k++ )
+    {
+        const double x1 = poRing->getX(k) - dfX;
+        const double y1 = poRing->getY(k) - dfY;
+        const double x2 = prev_diff_x;
+        const double y2 = prev_diff_y;
+
+        if( x1 * y2 - x2 * y1 == 0 && !(x1 == x2 && y1 == y2) )
+            return true;
+
+        prev_diff_x = x1;
+        prev_diff_y = y1;
+    }
+
+    return false;
+}
+
 static const int N_CRITICAL_PART_NUMBER = 100;
 
+// From that number of parts, candidate enclosing rings are looked up with
+// a quad tree on the ring envelopes.
+static const int N_MIN_PARTS_FOR_QUAD_TREE = 16;
+
+/************************************************************************/
+/*                    OGRGeometryFactoryGetRingTester()                 */
+/************************************************************************/
+
+static OGRRingPointTester* OGRGeometryFactoryGetRingTester(
+    std::vector<OGRRingPointTester*>& apoTesters,
+    const sPolyExtended* psPolyEx, int j )
+{
+    if( apoTesters[j] == NULL )
+        apoTesters[j] = new OGRRingPointTester(
+            reinterpret_cast<const OGRLinearRing*>(psPolyEx->poExteriorRing));
+    return apoTesters[j];
+}
+
 typedef enum
 {
    METHOD_NORMAL,
@@ -1616,7 +1845,9 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
           outer ring
        5) Add the top-level polygons to the multipolygon
 
-       Complexity : O(nPolygonCount^2)
+       Complexity : O(nPolygonCount^2) in the worst case, but only the
+       polygons whose envelope intersects the one of polygon i are
+       considered when there are many of them.
     */
 
     /* Compute how each polygon relate to the other ones
@@ -1654,11 +1885,43 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
 
     int nCountTopLevel = 1;
 
+    // Only the rings whose envelope intersects the one of a ring may
+    // enclose it or overlap it, so when there are many rings, get them
+    // from a quad tree in which the already processed (larger) rings are
+    // inserted as we go.
+    CPLQuadTree* hQuadTree = NULL;
+    if( !bMixedUpGeometries && nPolygonCount >= N_MIN_PARTS_FOR_QUAD_TREE )
+    {
+        OGREnvelope sGlobalEnvelope;
+        for( int i = 0; i < nPolygonCount; i++ )
+            sGlobalEnvelope.Merge(asPolyEx[i].sEnvelope);
+        CPLRectObj sGlobalBounds;
+        sGlobalBounds.minx = sGlobalEnvelope.MinX;
+        sGlobalBounds.miny = sGlobalEnvelope.MinY;
+        sGlobalBounds.maxx = sGlobalEnvelope.MaxX;
+        sGlobalBounds.maxy = sGlobalEnvelope.MaxY;
+        hQuadTree = CPLQuadTreeCreate(&sGlobalBounds, NULL);
+    }
+    std::vector<int> anCandidates;
+    std::vector<OGRRingPointTester*> apoTesters;
+    if( !bMixedUpGeometries )
+        apoTesters.resize(nPolygonCount);
+
     // STEP 2.
     for( int i = 1;
          !bMixedUpGeometries && bValidTopology && i<nPolygonCount;
          i++ )
     {
+        if( hQuadTree != NULL )
+        {
+            CPLRectObj sBounds;
+            sBounds.minx = asPolyEx[i-1].sEnvelope.MinX;
+            sBounds.miny = asPolyEx[i-1].sEnvelope.MinY;
+            sBounds.maxx = asPolyEx[i-1].sEnvelope.MaxX;
+            sBounds.maxy = asPolyEx[i-1].sEnvelope.MaxY;
+            CPLQuadTreeInsertWithBounds(hQuadTree, &asPolyEx[i-1], &sBounds);
+        }
+
         if( method == METHOD_ONLY_CCW && asPolyEx[i].bIsCW )
         {
             nCountTopLevel++;
@@ -1667,9 +1930,36 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
             continue;
         }
 
-        int j = i - 1;  // Used after for.
-        for( ; bValidTopology && j >= 0; j-- )
+        // Candidates are tried from the smallest to the largest one, that
+        // is by decreasing rank.
+        int nCandidates = i;
+        if( hQuadTree != NULL )
+        {
+            CPLRectObj sAoi;
+            sAoi.minx = asPolyEx[i].sEnvelope.MinX;
+            sAoi.miny = asPolyEx[i].sEnvelope.MinY;
+            sAoi.maxx = asPolyEx[i].sEnvelope.MaxX;
+            sAoi.maxy = asPolyEx[i].sEnvelope.MaxY;
+            int nFeatureCount = 0;
+            void** pahFeatures =
+                CPLQuadTreeSearch(hQuadTree, &sAoi, &nFeatureCount);
+            anCandidates.resize(nFeatureCount);
+            for( int k = 0; k < nFeatureCount; k++ )
+            {
+                anCandidates[k] = static_cast<int>(
+                    static_cast<sPolyExtended*>(pahFeatures[k]) - asPolyEx);
+            }
+            CPLFree(pahFeatures);
+            std::sort(anCandidates.begin(), anCandidates.end(),
+                      std::greater<int>());
+            nCandidates = nFeatureCount;
+        }
+
+        int iCandidate = 0;  // Used after for.
+        for( ; bValidTopology && iCandidate < nCandidates; iCandidate++ )
         {
+            const int j = hQuadTree != NULL ? anCandidates[iCandidate] :
+                                              i - 1 - iCandidate;
             bool b_i_inside_j = false;
 
             if( method == METHOD_ONLY_CCW && asPolyEx[j].bIsCW == FALSE )
@@ -1693,17 +1983,16 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
                     }
                     else if( asPolyEx[i].bIsPolygon &&
                              asPolyEx[j].bIsPolygon &&
-                             reinterpret_cast<OGRLinearRing*>(
-                                 asPolyEx[j].poExteriorRing)->
-                                     isPointOnRingBoundary(
-                                         &asPolyEx[i].poAPoint, FALSE) )
+                             OGRGeometryFactoryGetRingTester(
+                                 apoTesters, &asPolyEx[j], j)->
+                                     IsPointOnRingBoundary(
+                                         asPolyEx[i].poAPoint.getX(),
+                                         asPolyEx[i].poAPoint.getY()) )
                     {
                         OGRLinearRing* poLR_i =
                             reinterpret_cast<OGRLinearRing*>(
                                 asPolyEx[i].poExteriorRing);
-                        OGRLinearRing* poLR_j =
-                            reinterpret_cast<OGRLinearRing*>(
-                                asPolyEx[j].poExteriorRing);
+                        const OGRRingPointTester* poTester_j = apoTesters[j];
                         // If the point of i is on the boundary of j, we will
                         // iterate over the other points of i.
                         const int nPoints = poLR_i->getNumPoints();
@@ -1712,11 +2001,13 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
                         {
                             OGRPoint point;
                             poLR_i->getPoint(k, &point);
-                            if( poLR_j->isPointOnRingBoundary(&point, FALSE) )
+                            if( poTester_j->IsPointOnRingBoundary(
+                                    point.getX(), point.getY()) )
                             {
                                 // If it is on the boundary of j, iterate again.
                             }
-                            else if( poLR_j->isPointInRing(&point, FALSE) )
+                            else if( poTester_j->IsPointInRing(
+                                         point.getX(), point.getY()) )
                             {
                                 // If then point is strictly included in j, then
                                 // i is considered inside j.
@@ -1745,14 +2036,15 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
                                                   point2.getX()) / 2);
                                 pointMiddle.setY((point1.getY() +
                                                   point2.getY()) / 2);
-                                if( poLR_j->isPointOnRingBoundary(&pointMiddle,
-                                                                  FALSE) )
+                                if( poTester_j->IsPointOnRingBoundary(
+                                        pointMiddle.getX(), pointMiddle.getY()) )
                                 {
                                     // If it is on the boundary of j, iterate
                                     // again.
                                 }
-                                else if( poLR_j->isPointInRing(&pointMiddle,
-                                                               FALSE) )
+                                else if( poTester_j->IsPointInRing(
+                                             pointMiddle.getX(),
+                                             pointMiddle.getY()) )
                                 {
                                     // If then point is strictly included in j,
                                     // then i is considered inside j.
@@ -1772,10 +2064,10 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
                     // ring.
                     else if( asPolyEx[i].bIsPolygon &&
                              asPolyEx[j].bIsPolygon &&
-                             reinterpret_cast<OGRLinearRing*>(
-                                 asPolyEx[j].poExteriorRing)->
-                                     isPointInRing(&asPolyEx[i].poAPoint,
-                                                   FALSE) )
+                             OGRGeometryFactoryGetRingTester(
+                                 apoTesters, &asPolyEx[j], j)->IsPointInRing(
+                                 asPolyEx[i].poAPoint.getX(),
+                                 asPolyEx[i].poAPoint.getY()) )
                     {
                         b_i_inside_j = true;
                     }
@@ -1836,7 +2128,7 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
             }
         }
 
-        if( j < 0 )
+        if( iCandidate == nCandidates )
         {
             // We come here because we are not included in anything.
             // We are toplevel.
@@ -1846,6 +2138,11 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
         }
     }
 
+    if( hQuadTree != NULL )
+        CPLQuadTreeDestroy(hQuadTree);
+    for( size_t i = 0; i < apoTesters.size(); i++ )
+        delete apoTesters[i];
+
     if( pbIsValidGeometry )
         *pbIsValidGeometry = bValidTopology && !bMixedUpGeometries;
 
@@ -33,6 +33,9 @@
 #include "cpl_string.h"
 #include "ogr_api.h"
 #include "cpl_time.h"
+#include "ogr_attrind.h"
+
+#include <algorithm>
 #include <vector>
 
 //! @cond Doxygen_Suppress
@@ -52,6 +55,480 @@ class OGRGenSQLGeomFieldDefn: public OGRGeomFieldDefn
         int bForceGeomType;
 };
 
+/************************************************************************/
+/*                          OGRGenSQLJoinIndex                          */
+/*                                                                      */
+/*      In-memory hash table from the join key of the features of a     */
+/*      secondary layer to those features (or their FID if they take    */
+/*      too much memory), so that a LEFT JOIN whose condition is a      */
+/*      conjunction of equalities between a field of the primary        */
+/*      table and a field of the secondary table can be resolved        */
+/*      without re-reading the secondary layer for each primary row.    */
+/************************************************************************/
+
+// Entry of the hash table of OGRGenSQLJoinIndex.  poFeature is NULL once
+// only the FIDs are kept.
+struct OGRGenSQLJoinEntry
+{
+    CPLString   osKey;
+    OGRFeature *poFeature;
+    GIntBig     nFID;
+};
+
+static unsigned long OGRGenSQLJoinEntryHash( const void* pElt )
+{
+    return CPLHashSetHashStr(
+        static_cast<const OGRGenSQLJoinEntry*>(pElt)->osKey.c_str());
+}
+
+static int OGRGenSQLJoinEntryEqual( const void* pElt1, const void* pElt2 )
+{
+    return static_cast<const OGRGenSQLJoinEntry*>(pElt1)->osKey ==
+           static_cast<const OGRGenSQLJoinEntry*>(pElt2)->osKey;
+}
+
+static void OGRGenSQLJoinEntryFree( void* pElt )
+{
+    OGRGenSQLJoinEntry* psEntry = static_cast<OGRGenSQLJoinEntry*>(pElt);
+    delete psEntry->poFeature;
+    delete psEntry;
+}
+
+class OGRGenSQLJoinIndex
+{
+    typedef enum
+    {
+        KEY_INTEGER,
+        KEY_REAL,
+        KEY_STRING
+    } KeyType;
+
+    OGRLayer                          *poJoinLayer;
+    GIntBig                            nMaxMemory;
+    std::vector<int>                   anPrimaryFields;
+    std::vector<int>                   anSecondaryFields;
+    std::vector<KeyType>               aeKeyTypes;
+
+    bool                               bUseFIDs;
+    CPLHashSet                        *hEntries;
+
+                OGRGenSQLJoinIndex() :
+                    poJoinLayer(NULL), nMaxMemory(0), bUseFIDs(false),
+                    hEntries(CPLHashSetNew(OGRGenSQLJoinEntryHash,
+                                           OGRGenSQLJoinEntryEqual,
+                                           OGRGenSQLJoinEntryFree)) {}
+
+    bool        CollectKeyFields( swq_expr_node* poExpr,
+                                  OGRFeatureDefn* poPrimaryDefn,
+                                  int nSecondaryTable );
+    bool        BuildKey( OGRFeature* poFeature, bool bPrimary,
+                          CPLString& osKey ) const;
+    void        SwitchToFIDs();
+    static int  SwitchEntryToFID( void* pElt, void* pUserData );
+    OGRGenSQLJoinEntry *Find( const CPLString& osKey ) const;
+
+  public:
+               ~OGRGenSQLJoinIndex();
+
+    static OGRGenSQLJoinIndex* Create( swq_join_def* psJoinInfo,
+                                       OGRLayer* poPrimaryLayer,
+                                       GDALDataset* poJoinDS,
+                                       OGRLayer* poJoinLayerIn,
+                                       GIntBig nMaxMemoryIn );
+
+    bool        Build();
+    OGRFeature *GetJoinFeature( OGRFeature* poSrcFeat );
+};
+
+/************************************************************************/
+/*                        ~OGRGenSQLJoinIndex()                         */
+/************************************************************************/
+
+OGRGenSQLJoinIndex::~OGRGenSQLJoinIndex()
+{
+    CPLHashSetDestroy(hEntries);
+}
+
+/************************************************************************/
+/*                                Find()                                */
+/************************************************************************/
+
+OGRGenSQLJoinEntry *OGRGenSQLJoinIndex::Find( const CPLString& osKey ) const
+{
+    OGRGenSQLJoinEntry sEntry;
+    sEntry.osKey = osKey;
+    sEntry.poFeature = NULL;
+    sEntry.nFID = OGRNullFID;
+    return static_cast<OGRGenSQLJoinEntry*>(
+        CPLHashSetLookup(hEntries, &sEntry));
+}
+
+/************************************************************************/
+/*                          CollectKeyFields()                          */
+/*                                                                      */
+/*      Check that the join expression is made only of                  */
+/*      primary.field = secondary.field terms, possibly combined with   */
+/*      AND, with compatible field types, and collect them.             */
+/************************************************************************/
+
+bool OGRGenSQLJoinIndex::CollectKeyFields( swq_expr_node* poExpr,
+                                           OGRFeatureDefn* poPrimaryDefn,
+                                           int nSecondaryTable )
+{
+    if( poExpr->eNodeType != SNT_OPERATION )
+        return false;
+
+    if( poExpr->nOperation == SWQ_AND && poExpr->nSubExprCount == 2 )
+    {
+        return CollectKeyFields( poExpr->papoSubExpr[0], poPrimaryDefn,
+                                 nSecondaryTable ) &&
+               CollectKeyFields( poExpr->papoSubExpr[1], poPrimaryDefn,
+                                 nSecondaryTable );
+    }
+
+    if( poExpr->nOperation != SWQ_EQ || poExpr->nSubExprCount != 2 )
+        return false;
+
+    swq_expr_node* poPrimaryCol = poExpr->papoSubExpr[0];
+    swq_expr_node* poSecondaryCol = poExpr->papoSubExpr[1];
+    if( poPrimaryCol->eNodeType != SNT_COLUMN ||
+        poSecondaryCol->eNodeType != SNT_COLUMN )
+        return false;
+    if( poPrimaryCol->table_index == nSecondaryTable )
+        std::swap(poPrimaryCol, poSecondaryCol);
+    if( poPrimaryCol->table_index != 0 ||
+        poSecondaryCol->table_index != nSecondaryTable )
+        return false;
+
+    OGRFeatureDefn* poSecondaryDefn = poJoinLayer->GetLayerDefn();
+    const int iPrimaryField = poPrimaryCol->field_index;
+    const int iSecondaryField = poSecondaryCol->field_index;
+    if( iPrimaryField < 0 ||
+        iPrimaryField >= poPrimaryDefn->GetFieldCount() ||
+        iSecondaryField < 0 ||
+        iSecondaryField >= poSecondaryDefn->GetFieldCount() )
+        return false;
+
+    const OGRFieldType ePrimaryType =
+        poPrimaryDefn->GetFieldDefn(iPrimaryField)->GetType();
+    const OGRFieldType eSecondaryType =
+        poSecondaryDefn->GetFieldDefn(iSecondaryField)->GetType();
+    const bool bPrimaryIsInt =
+        ePrimaryType == OFTInteger || ePrimaryType == OFTInteger64;
+    const bool bSecondaryIsInt =
+        eSecondaryType == OFTInteger || eSecondaryType == OFTInteger64;
+
+    KeyType eKeyType;
+    if( bPrimaryIsInt && bSecondaryIsInt )
+        eKeyType = KEY_INTEGER;
+    else if( (bPrimaryIsInt || ePrimaryType == OFTReal) &&
+             (bSecondaryIsInt || eSecondaryType == OFTReal) )
+        eKeyType = KEY_REAL;
+    else if( ePrimaryType == OFTString && eSecondaryType == OFTString )
+        eKeyType = KEY_STRING;
+    else
+        return false;
+
+    anPrimaryFields.push_back(iPrimaryField);
+    anSecondaryFields.push_back(iSecondaryField);
+    aeKeyTypes.push_back(eKeyType);
+    return true;
+}
+
+/************************************************************************/
+/*                     OGRGenSQLIsPlainJoinLayer()                      */
+/*                                                                      */
+/*      Whether the attribute filters set on the layer are evaluated    */
+/*      by the generic OGR SQL engine, by scanning the layer.  Layers   */
+/*      of database drivers, which run them in their database engine    */
+/*      with their own comparison rules, support transactions or have   */
+/*      a FID column, so they are queried as before.                    */
+/************************************************************************/
+
+static bool OGRGenSQLIsPlainJoinLayer( GDALDataset* poDS, OGRLayer* poLayer )
+{
+    if( poDS->TestCapability(ODsCTransactions) ||
+        poLayer->TestCapability(OLCTransactions) ||
+        poLayer->GetFIDColumn()[0] != '\0' )
+        return false;
+
+    // The layer may also be the result of another SQL request.
+    return dynamic_cast<OGRGenSQLResultsLayer*>(poLayer) == NULL;
+}
+
+/************************************************************************/
+/*                               Create()                               */
+/*                                                                      */
+/*      Returns NULL if the join cannot, or should not, be resolved     */
+/*      with a hash table.                                              */
+/************************************************************************/
+
+OGRGenSQLJoinIndex* OGRGenSQLJoinIndex::Create( swq_join_def* psJoinInfo,
+                                                OGRLayer* poPrimaryLayer,
+                                                GDALDataset* poJoinDS,
+                                                OGRLayer* poJoinLayerIn,
+                                                GIntBig nMaxMemoryIn )
+{
+    // Reading the whole secondary layer would reset the reading of the
+    // primary layer in a self join.
+    if( poJoinLayerIn == poPrimaryLayer )
+        return NULL;
+
+    if( !OGRGenSQLIsPlainJoinLayer(poJoinDS, poJoinLayerIn) )
+        return NULL;
+
+    OGRGenSQLJoinIndex* poIndex = new OGRGenSQLJoinIndex();
+    poIndex->poJoinLayer = poJoinLayerIn;
+    poIndex->nMaxMemory = nMaxMemoryIn;
+    if( !poIndex->CollectKeyFields( psJoinInfo->poExpr,
+                                    poPrimaryLayer->GetLayerDefn(),
+                                    psJoinInfo->secondary_table ) )
+    {
+        delete poIndex;
+        return NULL;
+    }
+
+    // If the secondary layer has an attribute index on one of the join
+    // fields, the attribute filter uses it.
+    OGRLayerAttrIndex* poAttrIndex = poJoinLayerIn->GetIndex();
+    for( size_t i = 0;
+         poAttrIndex != NULL && i < poIndex->anSecondaryFields.size(); i++ )
+    {
+        if( poAttrIndex->GetFieldIndex(poIndex->anSecondaryFields[i]) != NULL )
+        {
+            delete poIndex;
+            return NULL;
+        }
+    }
+
+    return poIndex;
+}
+
+/************************************************************************/
+/*                              BuildKey()                              */
+/*                                                                      */
+/*      Returns false if one of the key fields is null (or NaN), in     */
+/*      which case the feature cannot be joined.  Two keys are equal    */
+/*      if and only if the attribute filter built by                    */
+/*      GetFilterForJoin() from the primary feature selects the         */
+/*      secondary feature.                                              */
+/************************************************************************/
+
+bool OGRGenSQLJoinIndex::BuildKey( OGRFeature* poFeature, bool bPrimary,
+                                   CPLString& osKey ) const
+{
+    const std::vector<int>& anFields =
+        bPrimary ? anPrimaryFields : anSecondaryFields;
+    osKey.clear();
+    for( size_t i = 0; i < anFields.size(); i++ )
+    {
+        const int iField = anFields[i];
+        if( !poFeature->IsFieldSet(iField) )
+            return false;
+
+        CPLString osPart;
+        switch( aeKeyTypes[i] )
+        {
+            case KEY_INTEGER:
+                osPart.Printf( CPL_FRMT_GIB,
+                               poFeature->GetFieldAsInteger64(iField) );
+                break;
+
+            case KEY_REAL:
+            {
+                double dfVal = poFeature->GetFieldAsDouble(iField);
+                if( CPLIsNan(dfVal) )
+                    return false;
+                if( bPrimary &&
+                    poFeature->GetFieldDefnRef(iField)->GetType() == OFTReal )
+                {
+                    // The filter has the value with 16 significant digits,
+                    // and cannot express infinity.
+                    if( !CPLIsFinite(dfVal) )
+                        return false;
+                    dfVal = CPLAtof(CPLSPrintf("%.16g", dfVal));
+                }
+                if( dfVal == 0.0 )
+                    dfVal = 0.0;  // -0 == 0
+                osPart.Printf( "%.17g", dfVal );
+                break;
+            }
+
+            case KEY_STRING:
+            {
+                // The generic OGR SQL engine compares strings with
+                // strcasecmp().
+                osPart = poFeature->GetFieldAsString(iField);
+                for( size_t j = 0; j < osPart.size(); j++ )
+                    osPart[j] = static_cast<char>(
+                        tolower(static_cast<unsigned char>(osPart[j])));
+                break;
+            }
+        }
+
+        // Length prefix, so that the concatenation of the parts of a
+        // multi-field key is not ambiguous.
+        osKey += CPLSPrintf("%d:", static_cast<int>(osPart.size()));
+        osKey += osPart;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                       HasPrefixEqualityRule()                        */
+/*                                                                      */
+/*      The generic OGR SQL engine compares a string ending with "+00"  */
+/*      and a string with a ':' three characters before its end on the  */
+/*      length of the shortest one, to ignore an implicit UTC timezone. */
+/*      This is the only case where its string equality is not a        */
+/*      case insensitive comparison, and it cannot be hashed.  A        */
+/*      secondary key not matching any of the two patterns compares     */
+/*      with the plain rule against any primary key.                    */
+/************************************************************************/
+
+static bool HasPrefixEqualityRule( const char* pszStr )
+{
+    const size_t nLen = strlen(pszStr);
+    return nLen > 3 && (strcmp(pszStr + nLen - 3, "+00") == 0 ||
+                        pszStr[nLen - 3] == ':');
+}
+
+/************************************************************************/
+/*                            SwitchToFIDs()                            */
+/************************************************************************/
+
+int OGRGenSQLJoinIndex::SwitchEntryToFID( void* pElt, void* /* pUserData */ )
+{
+    OGRGenSQLJoinEntry* psEntry = static_cast<OGRGenSQLJoinEntry*>(pElt);
+    delete psEntry->poFeature;
+    psEntry->poFeature = NULL;
+    return TRUE;
+}
+
+void OGRGenSQLJoinIndex::SwitchToFIDs()
+{
+    CPLHashSetForeach(hEntries, SwitchEntryToFID, NULL);
+    bUseFIDs = true;
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/*                                                                      */
+/*      Read the secondary layer once.  Returns false if the index      */
+/*      cannot be used, in which case the caller must fall back to      */
+/*      querying the secondary layer for each primary feature.          */
+/************************************************************************/
+
+bool OGRGenSQLJoinIndex::Build()
+{
+    // Above nMaxMemory, only the FIDs of the features are kept, which is not
+    // limited.
+    const bool bCanUseFIDs =
+        CPL_TO_BOOL(poJoinLayer->TestCapability(OLCRandomRead));
+    GIntBig nMemory = 0;
+    CPLString osKey;
+
+    poJoinLayer->SetAttributeFilter( NULL );
+    poJoinLayer->ResetReading();
+    OGRFeature* poFeature = NULL;
+    while( (poFeature = poJoinLayer->GetNextFeature()) != NULL )
+    {
+        for( size_t i = 0; i < anSecondaryFields.size(); i++ )
+        {
+            if( aeKeyTypes[i] == KEY_STRING &&
+                poFeature->IsFieldSet(anSecondaryFields[i]) &&
+                HasPrefixEqualityRule(
+                    poFeature->GetFieldAsString(anSecondaryFields[i])) )
+            {
+                CPLDebug( "GenSQL",
+                          "Join key of %s may be a timestamp. "
+                          "Falling back to per-feature lookups.",
+                          poJoinLayer->GetName() );
+                delete poFeature;
+                return false;
+            }
+        }
+
+        if( !BuildKey(poFeature, false, osKey) || Find(osKey) != NULL )
+        {
+            // Only the first matching feature is joined.
+            delete poFeature;
+            continue;
+        }
+
+        OGRGenSQLJoinEntry* psEntry = new OGRGenSQLJoinEntry();
+        psEntry->osKey = osKey;
+        psEntry->poFeature = NULL;
+        psEntry->nFID = poFeature->GetFID();
+        CPLHashSetInsert(hEntries, psEntry);
+
+        if( bUseFIDs )
+        {
+            delete poFeature;
+            continue;
+        }
+
+        nMemory += osKey.size() + 64 + sizeof(OGRFeature) +
+                   poFeature->GetFieldCount() * sizeof(OGRField);
+        for( int i = 0; i < poFeature->GetFieldCount(); i++ )
+        {
+            if( poFeature->IsFieldSet(i) &&
+                poFeature->GetFieldDefnRef(i)->GetType() == OFTString )
+            {
+                nMemory += strlen(poFeature->GetRawFieldRef(i)->String);
+            }
+        }
+        for( int i = 0; i < poFeature->GetGeomFieldCount(); i++ )
+        {
+            OGRGeometry* poGeom = poFeature->GetGeomFieldRef(i);
+            if( poGeom != NULL )
+                nMemory += poGeom->WkbSize();
+        }
+        psEntry->poFeature = poFeature;
+
+        if( nMemory > nMaxMemory )
+        {
+            if( !bCanUseFIDs )
+            {
+                CPLDebug( "GenSQL",
+                          "Join index on %s exceeds %d MB. "
+                          "Falling back to per-feature lookups.",
+                          poJoinLayer->GetName(),
+                          static_cast<int>(nMaxMemory / (1024 * 1024)) );
+                return false;
+            }
+            SwitchToFIDs();
+        }
+    }
+
+    CPLDebug( "GenSQL", "Join index on %s built with %d keys%s.",
+              poJoinLayer->GetName(),
+              CPLHashSetSize(hEntries),
+              bUseFIDs ? " (FIDs only)" : "" );
+    return true;
+}
+
+/************************************************************************/
+/*                           GetJoinFeature()                           */
+/*                                                                      */
+/*      Returns a new feature that the caller must free, or NULL if     */
+/*      there is no matching feature.                                   */
+/************************************************************************/
+
+OGRFeature *OGRGenSQLJoinIndex::GetJoinFeature( OGRFeature* poSrcFeat )
+{
+    CPLString osKey;
+    if( !BuildKey(poSrcFeat, true, osKey) )
+        return NULL;
+
+    OGRGenSQLJoinEntry* psEntry = Find(osKey);
+    if( psEntry == NULL )
+        return NULL;
+    if( bUseFIDs )
+        return poJoinLayer->GetFeature(psEntry->nFID);
+    return psEntry->poFeature->Clone();
+}
+
 /************************************************************************/
 /*               OGRGenSQLResultsLayerHasSpecialField()                 */
 /************************************************************************/
@@ -103,7 +580,8 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDSIn,
     poSummaryFeature(NULL),
     iFIDFieldIndex(),
     nExtraDSCount(0),
-    papoExtraDS(NULL)
+    papoExtraDS(NULL),
+    m_bJoinIndexesBuilt(false)
 {
     swq_select *psSelectInfo = (swq_select *) pSelectInfoIn;
 
@@ -112,6 +590,7 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDSIn,
 /* -------------------------------------------------------------------- */
     papoTableLayers = (OGRLayer **)
         CPLCalloc( sizeof(OGRLayer *), psSelectInfo->table_count );
+    std::vector<GDALDataset*> apoTableDS;
 
     for( int iTable = 0; iTable < psSelectInfo->table_count; iTable++ )
     {
@@ -140,6 +619,7 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDSIn,
 
         papoTableLayers[iTable] =
             poTableDS->GetLayerByName( psTableDef->table_name );
+        apoTableDS.push_back( poTableDS );
 
         CPLAssert( papoTableLayers[iTable] != NULL );
 
@@ -150,6 +630,39 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDSIn,
     poSrcLayer = papoTableLayers[0];
     SetMetadata( poSrcLayer->GetMetadata( "NATIVE_DATA" ), "NATIVE_DATA" );
 
+/* -------------------------------------------------------------------- */
+/*      Find the joins that can be resolved with a hash table.  They    */
+/*      are only built when the first feature is read.                  */
+/* -------------------------------------------------------------------- */
+    if( CPLTestBool(CPLGetConfigOption("OGR_SQL_HASH_JOIN", "YES")) )
+    {
+        // Maximum amount of memory, in MB, for the features of a secondary
+        // layer.
+        GIntBig nMaxMemory = 0;
+        const char* pszMaxMemory =
+            CPLGetConfigOption("OGR_SQL_HASH_JOIN_MAX_MEMORY", NULL);
+        if( pszMaxMemory != NULL )
+        {
+            nMaxMemory = CPLAtoGIntBig(pszMaxMemory) * 1024 * 1024;
+        }
+        else
+        {
+            nMaxMemory = CPLGetUsablePhysicalRAM() / 4;
+            if( nMaxMemory <= 0 )
+                nMaxMemory = 100 * 1024 * 1024;
+        }
+
+        m_apoJoinIndexes.resize( psSelectInfo->join_count, NULL );
+        for( int iJoin = 0; iJoin < psSelectInfo->join_count; iJoin++ )
+        {
+            swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
+            const int iTable = psJoinInfo->secondary_table;
+            m_apoJoinIndexes[iJoin] = OGRGenSQLJoinIndex::Create(
+                psJoinInfo, poSrcLayer, apoTableDS[iTable],
+                papoTableLayers[iTable], nMaxMemory );
+        }
+    }
+
 /* -------------------------------------------------------------------- */
 /*      If the user has explicitly requested a OGRSQL dialect, then    */
 /*      we should avoid to forward the where clause to the source layer */
@@ -508,6 +1021,11 @@ OGRGenSQLResultsLayer::~OGRGenSQLResultsLayer()
 /* -------------------------------------------------------------------- */
 /*      Free various datastructures.                                    */
 /* -------------------------------------------------------------------- */
+    // Must be done before closing the datasources of the joined layers,
+    // since they hold features of those layers.
+    for( size_t i = 0; i < m_apoJoinIndexes.size(); i++ )
+        delete m_apoJoinIndexes[i];
+
     CPLFree( papoTableLayers );
     papoTableLayers = NULL;
 
@@ -1261,6 +1779,24 @@ static CPLString GetFilterForJoin(swq_expr_node* poExpr, OGRFeature* poSrcFeat,
     return "";
 }
 
+/************************************************************************/
+/*                          BuildJoinIndexes()                          */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::BuildJoinIndexes()
+{
+    m_bJoinIndexesBuilt = true;
+    for( size_t iJoin = 0; iJoin < m_apoJoinIndexes.size(); iJoin++ )
+    {
+        if( m_apoJoinIndexes[iJoin] != NULL &&
+            !m_apoJoinIndexes[iJoin]->Build() )
+        {
+            delete m_apoJoinIndexes[iJoin];
+            m_apoJoinIndexes[iJoin] = NULL;
+        }
+    }
+}
+
 /************************************************************************/
 /*                          TranslateFeature()                          */
 /************************************************************************/
@@ -1294,6 +1830,16 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
 
         OGRLayer *poJoinLayer = papoTableLayers[psJoinInfo->secondary_table];
 
+        if( !m_bJoinIndexesBuilt )
+            BuildJoinIndexes();
+        if( iJoin < static_cast<int>(m_apoJoinIndexes.size()) &&
+            m_apoJoinIndexes[iJoin] != NULL )
+        {
+            apoFeatures.push_back(
+                m_apoJoinIndexes[iJoin]->GetJoinFeature(poSrcFeat) );
+            continue;
+        }
+
         osFilter = GetFilterForJoin(psJoinInfo->poExpr, poSrcFeat, poJoinLayer,
                                     psJoinInfo->secondary_table);
         //CPLDebug("OGR", "Filter = %s\n", osFilter.c_str());
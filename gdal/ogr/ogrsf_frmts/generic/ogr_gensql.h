@@ -35,6 +35,8 @@
 #include "swq.h"
 #include "cpl_hash_set.h"
 
+#include <vector>
+
 /*! @cond Doxygen_Suppress */
 
 #define GEOM_FIELD_INDEX_TO_ALL_FIELD_INDEX(poFDefn, iGeom) \
@@ -47,6 +49,8 @@
 #define ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(poFDefn, idx) \
     ((idx) - ((poFDefn)->GetFieldCount() + SPECIAL_FIELD_COUNT))
 
+class OGRGenSQLJoinIndex;
+
 /************************************************************************/
 /*                        OGRGenSQLResultsLayer                         */
 /************************************************************************/
@@ -78,6 +82,10 @@ class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
     int         nExtraDSCount;
     GDALDataset **papoExtraDS;
 
+    std::vector<OGRGenSQLJoinIndex*> m_apoJoinIndexes;
+    bool        m_bJoinIndexesBuilt;
+    void        BuildJoinIndexes();
+
     int         PrepareSummary();
 
     OGRFeature *TranslateFeature( OGRFeature * );
@@ -33,6 +33,12 @@
 #include "ogr_attrind.h"
 #include "swq.h"
 #include "ograpispy.h"
+#include "cpl_atomic_ops.h"
+#include "cpl_quad_tree.h"
+#include "cpl_worker_thread_pool.h"
+
+#include <algorithm>
+#include <vector>
 
 CPL_CVSID("$Id$");
 
@@ -549,6 +555,29 @@ OGRFeatureH OGR_L_GetNextFeature( OGRLayerH hLayer )
     return (OGRFeatureH) ((OGRLayer *)hLayer)->GetNextFeature();
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                   int nMaxFeatures )
+
+{
+    poBatch->Reset( GetLayerDefn() );
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        OGRFeature *poFeature = GetNextFeature();
+        if( poFeature == NULL )
+            break;
+
+        poBatch->AddFeature( poFeature );
+        delete poFeature;
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                       ConvertGeomsIfNecessary()                      */
 /************************************************************************/
@@ -1972,6 +2001,634 @@ static OGRGeometry* promote_to_multi(OGRGeometry* poGeom)
         return poGeom;
 }
 
+/************************************************************************/
+/*               overlay engine for layer overlay methods               */
+/*                                                                      */
+/*      The features of the method layer are read once and kept in      */
+/*      memory, indexed by a quad tree of their envelopes.  The         */
+/*      features of the input layer are read in batches whose result    */
+/*      features are computed concurrently, and then written in the     */
+/*      order of the input features so that the result does not depend */
+/*      on the number of threads.                                       */
+/************************************************************************/
+
+typedef enum
+{
+    OVERLAY_INTERSECTION,   // Intersection()
+    OVERLAY_IDENTITY,       // Identity() and first pass of Union()
+    OVERLAY_DIFFERENCE,     // Erase(), Update(), first pass of SymDifference()
+    OVERLAY_CLIP            // Clip()
+} OGRLayerOverlayOp;
+
+class OGRLayerOverlayError
+{
+  public:
+    CPLErr      type;
+    CPLErrorNum no;
+    CPLString   msg;
+
+    OGRLayerOverlayError( CPLErr eErrIn, CPLErrorNum noIn,
+                          const char* msgIn ) :
+        type(eErrIn), no(noIn), msg(msgIn) {}
+};
+
+// Result of the processing of one feature of the input layer.
+struct OGRLayerOverlayItem
+{
+    OGRFeature                       *poInput;
+    std::vector<OGRFeature*>          apoResults;
+    // Index of the method feature whose fields must be set on the result
+    // feature, or -1.
+    std::vector<int>                  anResultMethod;
+    std::vector<OGRLayerOverlayError> aoErrors;
+    bool                              bFailed;
+};
+
+struct OGRLayerOverlayContext
+{
+    OGRLayerOverlayOp    eOp;
+    OGRFeatureDefn      *poDefnResult;
+    int                 *mapInput;
+    int                 *mapMethod;
+    OGRGeometry         *pGeometryMethodFilter;
+    bool                 bSkipFailures;
+    bool                 bPromoteToMulti;
+    bool                 bUsePreparedGeometries;
+    bool                 bPretestContainment;
+    bool                 bKeepLowerDimGeom;
+
+    std::vector<OGRFeature*> apoMethod;
+    CPLQuadTree         *hMethodTree;
+
+    // One slot per thread, each with its own lazily prepared geometries
+    // of the method features.
+    int                  nSlots;
+    std::vector< std::vector<OGRPreparedGeometry*> > aapoPrepared;
+
+    // Current batch.
+    OGRLayerOverlayItem *pasItems;
+    int                  nItems;
+    volatile int         nNextItem;
+
+    OGRLayerOverlayContext() :
+        eOp(OVERLAY_INTERSECTION),
+        poDefnResult(NULL),
+        mapInput(NULL),
+        mapMethod(NULL),
+        pGeometryMethodFilter(NULL),
+        bSkipFailures(false),
+        bPromoteToMulti(false),
+        bUsePreparedGeometries(false),
+        bPretestContainment(false),
+        bKeepLowerDimGeom(false),
+        hMethodTree(NULL),
+        nSlots(1),
+        pasItems(NULL),
+        nItems(0),
+        nNextItem(0) {}
+};
+
+struct OGRLayerOverlayJob
+{
+    OGRLayerOverlayContext *psCtxt;
+    int                     iSlot;
+    bool                    bCaptureErrors;
+};
+
+/************************************************************************/
+/*                         overlay_context_init()                       */
+/************************************************************************/
+
+static
+void overlay_context_init(OGRLayerOverlayContext *psCtxt,
+                          OGRLayerOverlayOp eOp,
+                          OGRLayer *pLayerMethod,
+                          OGRFeatureDefn *poDefnResult,
+                          int *mapInput, int *mapMethod,
+                          OGRGeometry *pGeometryMethodFilter,
+                          int bKeepLowerDimGeom,
+                          char** papszOptions)
+{
+    psCtxt->eOp = eOp;
+    psCtxt->poDefnResult = poDefnResult;
+    psCtxt->mapInput = mapInput;
+    psCtxt->mapMethod = mapMethod;
+    psCtxt->pGeometryMethodFilter = pGeometryMethodFilter;
+    psCtxt->bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
+    psCtxt->bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
+    psCtxt->bUsePreparedGeometries = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_PREPARED_GEOMETRIES", "YES")) &&
+                                     OGRHasPreparedGeometrySupport();
+    psCtxt->bPretestContainment = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PRETEST_CONTAINMENT", "NO"));
+    psCtxt->bKeepLowerDimGeom = CPL_TO_BOOL(bKeepLowerDimGeom);
+
+    const char *pszNumThreads = CSLFetchNameValue(papszOptions, "NUM_THREADS");
+    if (pszNumThreads == NULL)
+        pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                        CPLGetNumCPUs() : atoi(pszNumThreads);
+    psCtxt->nSlots = std::max(1, std::min(nThreads, 128));
+
+    // load the method layer, with its current filters
+    OGREnvelope sExtent;
+    pLayerMethod->ResetReading();
+    while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
+        OGRGeometry *y_geom = y->GetGeometryRef();
+        if (!y_geom) {delete y; continue;}
+        OGREnvelope y_env;
+        y_geom->getEnvelope(&y_env);
+        sExtent.Merge(y_env);
+        psCtxt->apoMethod.push_back(y);
+    }
+
+    const int nMethod = static_cast<int>(psCtxt->apoMethod.size());
+    if (nMethod > 0) {
+        CPLRectObj sGlobalBounds;
+        sGlobalBounds.minx = sExtent.MinX;
+        sGlobalBounds.miny = sExtent.MinY;
+        sGlobalBounds.maxx = sExtent.MaxX;
+        sGlobalBounds.maxy = sExtent.MaxY;
+        psCtxt->hMethodTree = CPLQuadTreeCreate(&sGlobalBounds, NULL);
+        CPLQuadTreeSetMaxDepth(psCtxt->hMethodTree,
+                               CPLQuadTreeGetAdvisedMaxDepth(nMethod));
+        for (int i = 0; i < nMethod; i++) {
+            OGREnvelope y_env;
+            psCtxt->apoMethod[i]->GetGeometryRef()->getEnvelope(&y_env);
+            CPLRectObj sBounds;
+            sBounds.minx = y_env.MinX;
+            sBounds.miny = y_env.MinY;
+            sBounds.maxx = y_env.MaxX;
+            sBounds.maxy = y_env.MaxY;
+            CPLQuadTreeInsertWithBounds(psCtxt->hMethodTree,
+                                        &(psCtxt->apoMethod[i]), &sBounds);
+        }
+    }
+    psCtxt->aapoPrepared.resize(psCtxt->nSlots,
+        std::vector<OGRPreparedGeometry*>(nMethod,
+                                          static_cast<OGRPreparedGeometry*>(NULL)));
+}
+
+/************************************************************************/
+/*                         overlay_context_free()                       */
+/************************************************************************/
+
+static
+void overlay_context_free(OGRLayerOverlayContext *psCtxt)
+{
+    for (size_t i = 0; i < psCtxt->aapoPrepared.size(); i++)
+        for (size_t j = 0; j < psCtxt->aapoPrepared[i].size(); j++)
+            if (psCtxt->aapoPrepared[i][j])
+                OGRDestroyPreparedGeometry(psCtxt->aapoPrepared[i][j]);
+    psCtxt->aapoPrepared.clear();
+    for (size_t i = 0; i < psCtxt->apoMethod.size(); i++)
+        delete psCtxt->apoMethod[i];
+    psCtxt->apoMethod.clear();
+    if (psCtxt->hMethodTree)
+        CPLQuadTreeDestroy(psCtxt->hMethodTree);
+    psCtxt->hMethodTree = NULL;
+}
+
+/************************************************************************/
+/*                        overlay_get_candidates()                      */
+/*                                                                      */
+/*      Collect, in the order of the method layer, the method features  */
+/*      that intersect the given area, as a spatial filter set on the   */
+/*      method layer would have returned them.                          */
+/************************************************************************/
+
+static
+void overlay_get_candidates(OGRLayerOverlayContext *psCtxt, int iSlot,
+                            const OGRGeometry *poArea,
+                            std::vector<int> &anCandidates)
+{
+    anCandidates.clear();
+    if (psCtxt->hMethodTree == NULL)
+        return;
+
+    OGREnvelope sEnv;
+    poArea->getEnvelope(&sEnv);
+    CPLRectObj sAoi;
+    sAoi.minx = sEnv.MinX;
+    sAoi.miny = sEnv.MinY;
+    sAoi.maxx = sEnv.MaxX;
+    sAoi.maxy = sEnv.MaxY;
+    int nCount = 0;
+    void **pahHits = CPLQuadTreeSearch(psCtxt->hMethodTree, &sAoi, &nCount);
+    for (int i = 0; i < nCount; i++)
+        anCandidates.push_back(static_cast<int>(
+            static_cast<OGRFeature**>(pahHits[i]) - &(psCtxt->apoMethod[0])));
+    CPLFree(pahHits);
+    std::sort(anCandidates.begin(), anCandidates.end());
+
+    size_t nKept = 0;
+    for (size_t i = 0; i < anCandidates.size(); i++) {
+        const int iMethod = anCandidates[i];
+        OGRGeometry *y_geom = psCtxt->apoMethod[iMethod]->GetGeometryRef();
+        OGRPreparedGeometry *y_prepared_geom = NULL;
+        if (psCtxt->bUsePreparedGeometries) {
+            y_prepared_geom = psCtxt->aapoPrepared[iSlot][iMethod];
+            if (!y_prepared_geom) {
+                y_prepared_geom = OGRCreatePreparedGeometry(y_geom);
+                psCtxt->aapoPrepared[iSlot][iMethod] = y_prepared_geom;
+            }
+        }
+        const bool bIntersects = y_prepared_geom ?
+            CPL_TO_BOOL(OGRPreparedGeometryIntersects(y_prepared_geom, poArea)) :
+            CPL_TO_BOOL(poArea->Intersects(y_geom));
+        if (bIntersects)
+            anCandidates[nKept++] = iMethod;
+    }
+    anCandidates.resize(nKept);
+}
+
+/************************************************************************/
+/*                       overlay_process_feature()                      */
+/*                                                                      */
+/*      Compute the result features of one input feature.  This runs    */
+/*      in worker threads: the shared method features are only read,    */
+/*      and their fields are copied later by the writing thread.        */
+/************************************************************************/
+
+static
+void overlay_add_result(OGRLayerOverlayContext *psCtxt,
+                        OGRLayerOverlayItem *psItem,
+                        OGRGeometry *poGeom, int iMethod)
+{
+    OGRFeature *z = new OGRFeature(psCtxt->poDefnResult);
+    z->SetFieldsFrom(psItem->poInput, psCtxt->mapInput);
+    if (psCtxt->bPromoteToMulti)
+        poGeom = promote_to_multi(poGeom);
+    z->SetGeometryDirectly(poGeom);
+    psItem->apoResults.push_back(z);
+    psItem->anResultMethod.push_back(iMethod);
+}
+
+static
+void overlay_process_feature(OGRLayerOverlayContext *psCtxt, int iSlot,
+                             OGRLayerOverlayItem *psItem)
+{
+    OGRFeature *x = psItem->poInput;
+    OGRGeometry *x_geom = x->GetGeometryRef();
+    const bool bSkipFailures = psCtxt->bSkipFailures;
+    if (!x_geom) return;
+    // x_geom is only used by this thread, against every candidate
+    x_geom->setGEOSCacheEnabled(TRUE);
+
+    // the area where the method features are looked for, as in set_filter_from()
+    CPLErrorReset();
+    OGRGeometry *poArea = x_geom;
+    OGRGeometry *poAreaOwned = NULL;
+    if (psCtxt->pGeometryMethodFilter) {
+        if (!x_geom->Intersects(psCtxt->pGeometryMethodFilter))
+            x_geom = NULL;
+        else {
+            poAreaOwned = x_geom->Intersection(psCtxt->pGeometryMethodFilter);
+            if (!poAreaOwned) x_geom = NULL;
+            poArea = poAreaOwned;
+        }
+    }
+    if (CPLGetLastErrorType() != CE_None) {
+        if (!bSkipFailures) {
+            psItem->bFailed = true;
+            delete poAreaOwned;
+            return;
+        }
+        CPLErrorReset();
+    }
+    if (!x_geom) {
+        delete poAreaOwned;
+        return;
+    }
+
+    std::vector<int> anCandidates;
+    overlay_get_candidates(psCtxt, iSlot, poArea, anCandidates);
+    delete poAreaOwned;
+
+    switch (psCtxt->eOp) {
+    case OVERLAY_INTERSECTION:
+    {
+        OGRPreparedGeometry* x_prepared_geom = NULL;
+        if (psCtxt->bUsePreparedGeometries && psCtxt->bPretestContainment) {
+            x_prepared_geom = OGRCreatePreparedGeometry(x_geom);
+            if (!x_prepared_geom) {
+                psItem->bFailed = true;
+                return;
+            }
+        }
+        for (size_t i = 0; i < anCandidates.size(); i++) {
+            const int iMethod = anCandidates[i];
+            OGRGeometry *y_geom = psCtxt->apoMethod[iMethod]->GetGeometryRef();
+            OGRGeometry *z_geom = NULL;
+
+            if (x_prepared_geom) {
+                CPLErrorReset();
+                if (OGRPreparedGeometryContains(x_prepared_geom, y_geom) &&
+                    CPLGetLastErrorType() == CE_None)
+                    z_geom = y_geom->clone();
+                if (CPLGetLastErrorType() != CE_None) {
+                    if (!bSkipFailures) {
+                        psItem->bFailed = true;
+                        break;
+                    }
+                    CPLErrorReset();
+                    continue;
+                }
+            }
+            if (!z_geom) {
+                CPLErrorReset();
+                z_geom = x_geom->Intersection(y_geom);
+                if (CPLGetLastErrorType() != CE_None || z_geom == NULL) {
+                    delete z_geom;
+                    if (!bSkipFailures) {
+                        psItem->bFailed = true;
+                        break;
+                    }
+                    CPLErrorReset();
+                    continue;
+                }
+                if (z_geom->IsEmpty() ||
+                    (!psCtxt->bKeepLowerDimGeom &&
+                     (x_geom->getDimension() == y_geom->getDimension() &&
+                      z_geom->getDimension() < x_geom->getDimension())))
+                {
+                    delete z_geom;
+                    continue;
+                }
+            }
+            overlay_add_result(psCtxt, psItem, z_geom, iMethod);
+        }
+        OGRDestroyPreparedGeometry(x_prepared_geom);
+        break;
+    }
+
+    case OVERLAY_IDENTITY:
+    {
+        OGRGeometry *x_geom_diff = x_geom->clone(); // this will be the geometry of the result feature
+        for (size_t i = 0; i < anCandidates.size(); i++) {
+            const int iMethod = anCandidates[i];
+            OGRGeometry *y_geom = psCtxt->apoMethod[iMethod]->GetGeometryRef();
+
+            CPLErrorReset();
+            OGRGeometry *poIntersection = x_geom->Intersection(y_geom);
+            if (CPLGetLastErrorType() != CE_None || poIntersection == NULL) {
+                delete poIntersection;
+                if (!bSkipFailures) {
+                    psItem->bFailed = true;
+                    break;
+                }
+                CPLErrorReset();
+                continue;
+            }
+            if (poIntersection->IsEmpty() ||
+                (!psCtxt->bKeepLowerDimGeom &&
+                 (x_geom->getDimension() == y_geom->getDimension() &&
+                  poIntersection->getDimension() < x_geom->getDimension())))
+            {
+                delete poIntersection;
+                continue;
+            }
+
+            CPLErrorReset();
+            OGRGeometry *x_geom_diff_new = x_geom_diff->Difference(y_geom);
+            if (CPLGetLastErrorType() != CE_None || x_geom_diff_new == NULL) {
+                delete x_geom_diff_new;
+                if (!bSkipFailures) {
+                    delete poIntersection;
+                    psItem->bFailed = true;
+                    break;
+                }
+                CPLErrorReset();
+            } else {
+                delete x_geom_diff;
+                x_geom_diff = x_geom_diff_new;
+            }
+            overlay_add_result(psCtxt, psItem, poIntersection, iMethod);
+        }
+        if (psItem->bFailed || x_geom_diff->IsEmpty())
+            delete x_geom_diff;
+        else
+            overlay_add_result(psCtxt, psItem, x_geom_diff, -1);
+        break;
+    }
+
+    case OVERLAY_DIFFERENCE:
+    {
+        OGRGeometry *geom = x_geom->clone(); // this will be the geometry of the result feature
+        // incrementally erase y from geom
+        for (size_t i = 0; i < anCandidates.size(); i++) {
+            OGRGeometry *y_geom = psCtxt->apoMethod[anCandidates[i]]->GetGeometryRef();
+            CPLErrorReset();
+            OGRGeometry *geom_new = geom->Difference(y_geom);
+            if (CPLGetLastErrorType() != CE_None || geom_new == NULL) {
+                delete geom_new;
+                if (!bSkipFailures) {
+                    psItem->bFailed = true;
+                    break;
+                }
+                CPLErrorReset();
+            } else {
+                delete geom;
+                geom = geom_new;
+                if (geom->IsEmpty())
+                    break;
+            }
+        }
+        if (psItem->bFailed || geom->IsEmpty())
+            delete geom;
+        else
+            overlay_add_result(psCtxt, psItem, geom, -1);
+        break;
+    }
+
+    case OVERLAY_CLIP:
+    {
+        OGRGeometry *geom = NULL; // union of the method features
+        for (size_t i = 0; i < anCandidates.size(); i++) {
+            OGRGeometry *y_geom = psCtxt->apoMethod[anCandidates[i]]->GetGeometryRef();
+            if (!geom) {
+                geom = y_geom->clone();
+                continue;
+            }
+            CPLErrorReset();
+            OGRGeometry *geom_new = geom->Union(y_geom);
+            if (CPLGetLastErrorType() != CE_None || geom_new == NULL) {
+                delete geom_new;
+                if (!bSkipFailures) {
+                    psItem->bFailed = true;
+                    break;
+                }
+                CPLErrorReset();
+            } else {
+                delete geom;
+                geom = geom_new;
+            }
+        }
+        if (geom && !psItem->bFailed) {
+            CPLErrorReset();
+            OGRGeometry* poIntersection = x_geom->Intersection(geom);
+            if (CPLGetLastErrorType() != CE_None || poIntersection == NULL) {
+                delete poIntersection;
+                if (!bSkipFailures)
+                    psItem->bFailed = true;
+                else
+                    CPLErrorReset();
+            }
+            else if (!poIntersection->IsEmpty())
+                overlay_add_result(psCtxt, psItem, poIntersection, -1);
+            else
+                delete poIntersection;
+        }
+        delete geom;
+        break;
+    }
+    }
+}
+
+/************************************************************************/
+/*                            overlay_job()                             */
+/************************************************************************/
+
+static void CPL_STDCALL overlay_error_handler(CPLErr eErr, CPLErrorNum no,
+                                             const char* msg)
+{
+    std::vector<OGRLayerOverlayError>* paoErrors =
+        static_cast<std::vector<OGRLayerOverlayError> *>(
+            CPLGetErrorHandlerUserData());
+    paoErrors->push_back(OGRLayerOverlayError(eErr, no, msg));
+}
+
+static
+void overlay_job(void *pData)
+{
+    OGRLayerOverlayJob *psJob = static_cast<OGRLayerOverlayJob*>(pData);
+    OGRLayerOverlayContext *psCtxt = psJob->psCtxt;
+    while (true) {
+        const int i = CPLAtomicInc(&(psCtxt->nNextItem)) - 1;
+        if (i >= psCtxt->nItems)
+            break;
+        OGRLayerOverlayItem *psItem = psCtxt->pasItems + i;
+        // errors are emitted by the writing thread, in order
+        if (psJob->bCaptureErrors) {
+            CPLPushErrorHandlerEx(overlay_error_handler, &(psItem->aoErrors));
+            CPLSetCurrentErrorHandlerCatchDebug(FALSE);
+        }
+        overlay_process_feature(psCtxt, psJob->iSlot, psItem);
+        if (psJob->bCaptureErrors)
+            CPLPopErrorHandler();
+    }
+}
+
+/************************************************************************/
+/*                         overlay_input_layer()                        */
+/*                                                                      */
+/*      Process all features of the input layer and write the result    */
+/*      features.  Stops, as the sequential algorithm would, at the     */
+/*      first failure unless SKIP_FAILURES is set.                      */
+/************************************************************************/
+
+static
+OGRErr overlay_input_layer(OGRLayerOverlayContext *psCtxt,
+                           OGRLayer *pLayerInput,
+                           OGRLayer *pLayerResult,
+                           double *pdfProgressCounter,
+                           double progress_max,
+                           double progress_ticker,
+                           GDALProgressFunc pfnProgress,
+                           void * pProgressArg)
+{
+    OGRErr ret = OGRERR_NONE;
+    CPLWorkerThreadPool *poPool = NULL;
+    int nSlots = psCtxt->nSlots;
+    if (nSlots > 1) {
+        poPool = new CPLWorkerThreadPool();
+        if (!poPool->Setup(nSlots, NULL, NULL)) {
+            delete poPool;
+            poPool = NULL;
+            nSlots = 1;
+        }
+    }
+    // In the sequential case, process one feature at a time so that
+    // errors are emitted as they happen.
+    const size_t nBatchSize = poPool ? 64 * nSlots : 1;
+    std::vector<OGRLayerOverlayJob> asJobs(nSlots);
+    for (int i = 0; i < nSlots; i++) {
+        asJobs[i].psCtxt = psCtxt;
+        asJobs[i].iSlot = i;
+        asJobs[i].bCaptureErrors = poPool != NULL;
+    }
+
+    std::vector<OGRLayerOverlayItem> asItems;
+    bool bEOF = false;
+    pLayerInput->ResetReading();
+    while (!bEOF && ret == OGRERR_NONE) {
+        asItems.clear();
+        while (asItems.size() < nBatchSize) {
+            OGRFeature *x = pLayerInput->GetNextFeature();
+            if (!x) {
+                bEOF = true;
+                break;
+            }
+            asItems.push_back(OGRLayerOverlayItem());
+            asItems.back().poInput = x;
+            asItems.back().bFailed = false;
+        }
+        if (asItems.empty())
+            break;
+
+        psCtxt->pasItems = &asItems[0];
+        psCtxt->nItems = static_cast<int>(asItems.size());
+        psCtxt->nNextItem = 0;
+        if (poPool) {
+            for (int i = 0; i < nSlots; i++)
+                poPool->SubmitJob(overlay_job, &asJobs[i]);
+            poPool->WaitCompletion();
+        } else {
+            overlay_job(&asJobs[0]);
+        }
+
+        for (size_t i = 0; i < asItems.size(); i++) {
+            OGRLayerOverlayItem &sItem = asItems[i];
+            if (ret == OGRERR_NONE && pfnProgress) {
+                double p = *pdfProgressCounter/progress_max;
+                if (p > progress_ticker) {
+                    if (!pfnProgress(p, "", pProgressArg)) {
+                        CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+                        ret = OGRERR_FAILURE;
+                    }
+                }
+                *pdfProgressCounter += 1.0;
+            }
+            if (ret == OGRERR_NONE) {
+                for (size_t j = 0; j < sItem.aoErrors.size(); j++)
+                    CPLError(sItem.aoErrors[j].type, sItem.aoErrors[j].no,
+                             "%s", sItem.aoErrors[j].msg.c_str());
+                if (!sItem.aoErrors.empty() && !sItem.bFailed)
+                    CPLErrorReset();
+            }
+            for (size_t j = 0; j < sItem.apoResults.size(); j++) {
+                OGRFeature *z = sItem.apoResults[j];
+                if (ret == OGRERR_NONE) {
+                    if (sItem.anResultMethod[j] >= 0)
+                        z->SetFieldsFrom(psCtxt->apoMethod[sItem.anResultMethod[j]],
+                                         psCtxt->mapMethod);
+                    ret = pLayerResult->CreateFeature(z);
+                    if (ret != OGRERR_NONE && psCtxt->bSkipFailures) {
+                        CPLErrorReset();
+                        ret = OGRERR_NONE;
+                    }
+                }
+                delete z;
+            }
+            if (ret == OGRERR_NONE && sItem.bFailed)
+                ret = OGRERR_FAILURE;
+            delete sItem.poInput;
+        }
+    }
+    psCtxt->pasItems = NULL;
+    psCtxt->nItems = 0;
+    delete poPool;
+    return ret;
+}
+
 /************************************************************************/
 /*                          Intersection()                              */
 /************************************************************************/
@@ -1990,8 +2647,9 @@ static OGRGeometry* promote_to_multi(OGRGeometry* poGeom)
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -2017,6 +2675,11 @@ static OGRGeometry* promote_to_multi(OGRGeometry* poGeom)
  *     result features with lower dimension geometry that would
  *     otherwise be added to the result layer. The default is to add
  *     but only if the result layer has an unknown geometry type.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This method is the same as the C function OGR_L_Intersection().
@@ -2055,16 +2718,10 @@ OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod,
     OGRGeometry *pGeometryMethodFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
-    OGREnvelope sEnvelopeMethod;
-    GBool bEnvelopeSet;
+    OGRLayerOverlayContext sOverlay;
     double progress_max = (double) GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
-    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
-    int bUsePreparedGeometries = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_PREPARED_GEOMETRIES", "YES"));
-    if (bUsePreparedGeometries) bUsePreparedGeometries = OGRHasPreparedGeometrySupport();
-    int bPretestContainment = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PRETEST_CONTAINMENT", "NO"));
     int bKeepLowerDimGeom = CPLTestBool(CSLFetchNameValueDef(papszOptions, "KEEP_LOWER_DIMENSION_GEOMETRIES", "YES"));
 
     // check for GEOS
@@ -2082,7 +2739,6 @@ OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod,
     ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 1, papszOptions);
     if (ret != OGRERR_NONE) goto done;
     poDefnResult = pLayerResult->GetLayerDefn();
-    bEnvelopeSet = pLayerMethod->GetExtent(&sEnvelopeMethod, 1) == OGRERR_NONE;
     if (bKeepLowerDimGeom) {
         // require that the result layer is of geom type unknown
         if (pLayerResult->GetGeomType() != wkbUnknown) {
@@ -2091,154 +2747,14 @@ OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod,
         }
     }
 
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
-
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
-
-        // is it worth to proceed?
-        if (bEnvelopeSet) {
-            OGRGeometry *x_geom = x->GetGeometryRef();
-            if (x_geom) {
-                OGREnvelope x_env;
-                x_geom->getEnvelope(&x_env);
-                if (x_env.MaxX < sEnvelopeMethod.MinX
-                    || x_env.MaxY < sEnvelopeMethod.MinY
-                    || sEnvelopeMethod.MaxX < x_env.MinX
-                    || sEnvelopeMethod.MaxY < x_env.MinY) {
-                    delete x;
-                    continue;
-                }
-            } else {
-                delete x;
-                continue;
-            }
-        }
-
-        // set up the filter for method layer
-        CPLErrorReset();
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (CPLGetLastErrorType() != CE_None) {
-            if (!bSkipFailures) {
-                ret = OGRERR_FAILURE;
-                delete x;
-                goto done;
-            } else {
-                CPLErrorReset();
-                ret = OGRERR_NONE;
-            }
-        }
-        if (!x_geom) {
-            delete x;
-            continue;
-        }
-
-        OGRPreparedGeometry* x_prepared_geom = NULL;
-        if (bUsePreparedGeometries) {
-            x_prepared_geom = OGRCreatePreparedGeometry(x_geom);
-            if (!x_prepared_geom) {
-                delete x;
-                goto done;
-            }
-        }
-
-        pLayerMethod->ResetReading();
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            OGRGeometry *z_geom = NULL;
-
-            if (x_prepared_geom) {
-                CPLErrorReset();
-                ret = OGRERR_NONE;
-                if (bPretestContainment && OGRPreparedGeometryContains(x_prepared_geom, y_geom))
-                {
-                    if (CPLGetLastErrorType() == CE_None)
-                        z_geom = y_geom->clone();
-                }
-                else if (!(OGRPreparedGeometryIntersects(x_prepared_geom, y_geom)))
-                {
-                    if (CPLGetLastErrorType() == CE_None) {
-                        delete y;
-                        continue;
-                    }
-                }
-                if (CPLGetLastErrorType() != CE_None) {
-                    delete y;
-                    if (!bSkipFailures) {
-                        ret = OGRERR_FAILURE;
-                        OGRDestroyPreparedGeometry(x_prepared_geom);
-                        delete x;
-                        goto done;
-                    } else {
-                        CPLErrorReset();
-                        ret = OGRERR_NONE;
-                        continue;
-                    }
-                }
-            }
-            if (!z_geom) {
-                CPLErrorReset();
-                z_geom = x_geom->Intersection(y_geom);
-                if (CPLGetLastErrorType() != CE_None || z_geom == NULL) {
-                    delete z_geom;
-                    delete y;
-                    if (!bSkipFailures) {
-                        ret = OGRERR_FAILURE;
-                        OGRDestroyPreparedGeometry(x_prepared_geom);
-                        delete x;
-                        goto done;
-                    } else {
-                        CPLErrorReset();
-                        ret = OGRERR_NONE;
-                        continue;
-                    }
-                }
-                if (z_geom->IsEmpty() ||
-                    (!bKeepLowerDimGeom &&
-                     (x_geom->getDimension() == y_geom->getDimension() &&
-                      z_geom->getDimension() < x_geom->getDimension())))
-                {
-                    delete z_geom;
-                    delete y;
-                    continue;
-                }
-            }
-            OGRFeature *z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapInput);
-            z->SetFieldsFrom(y, mapMethod);
-            if (bPromoteToMulti)
-                z_geom = promote_to_multi(z_geom);
-            z->SetGeometryDirectly(z_geom);
-            delete y;
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    OGRDestroyPreparedGeometry(x_prepared_geom);
-                    delete x;
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-
-        OGRDestroyPreparedGeometry(x_prepared_geom);
-        delete x;
-    }
+    overlay_context_init(&sOverlay, OVERLAY_INTERSECTION, pLayerMethod, poDefnResult,
+                         mapInput, mapMethod, pGeometryMethodFilter, bKeepLowerDimGeom,
+                         papszOptions);
+    ret = overlay_input_layer(&sOverlay, this, pLayerResult,
+                              &progress_counter, progress_max, progress_ticker,
+                              pfnProgress, pProgressArg);
+    overlay_context_free(&sOverlay);
+    if (ret != OGRERR_NONE) goto done;
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
@@ -2271,8 +2787,9 @@ done:
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -2298,6 +2815,11 @@ done:
  *     result features with lower dimension geometry that would
  *     otherwise be added to the result layer. The default is to add
  *     but only if the result layer has an unknown geometry type.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Intersection().
@@ -2361,8 +2883,9 @@ OGRErr OGR_L_Intersection( OGRLayerH pLayerInput,
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -2384,6 +2907,11 @@ OGRErr OGR_L_Intersection( OGRLayerH pLayerInput,
  *     result features with lower dimension geometry that would
  *     otherwise be added to the result layer. The default is to add
  *     but only if the result layer has an unknown geometry type.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This method is the same as the C function OGR_L_Union().
@@ -2423,13 +2951,12 @@ OGRErr OGRLayer::Union( OGRLayer *pLayerMethod,
     OGRGeometry *pGeometryInputFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
+    OGRLayerOverlayContext sOverlay;
     double progress_max = (double) GetFeatureCount(0) + (double) pLayerMethod->GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
     int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
     int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
-    int bUsePreparedGeometries = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_PREPARED_GEOMETRIES", "YES"));
-    if (bUsePreparedGeometries) bUsePreparedGeometries = OGRHasPreparedGeometrySupport();
     int bKeepLowerDimGeom = CPLTestBool(CSLFetchNameValueDef(papszOptions, "KEEP_LOWER_DIMENSION_GEOMETRIES", "YES"));
 
     // check for GEOS
@@ -2458,175 +2985,14 @@ OGRErr OGRLayer::Union( OGRLayer *pLayerMethod,
     }
 
     // add features based on input layer
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
-
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
-
-        // set up the filter on method layer
-        CPLErrorReset();
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (CPLGetLastErrorType() != CE_None) {
-            if (!bSkipFailures) {
-                ret = OGRERR_FAILURE;
-                delete x;
-                goto done;
-            } else {
-                CPLErrorReset();
-                ret = OGRERR_NONE;
-            }
-        }
-        if (!x_geom) {
-            delete x;
-            continue;
-        }
-
-        OGRPreparedGeometry* x_prepared_geom = NULL;
-        if (bUsePreparedGeometries) {
-            x_prepared_geom = OGRCreatePreparedGeometry(x_geom);
-            if (!x_prepared_geom) {
-                delete x;
-                goto done;
-            }
-        }
-
-        OGRGeometry *x_geom_diff = x_geom->clone(); // this will be the geometry of the result feature
-        pLayerMethod->ResetReading();
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-
-            CPLErrorReset();
-            if (x_prepared_geom && !(OGRPreparedGeometryIntersects(x_prepared_geom, y_geom))) {
-                if (CPLGetLastErrorType() == CE_None) {
-                    delete y;
-                    continue;
-                }
-            }
-            if (CPLGetLastErrorType() != CE_None) {
-                if (!bSkipFailures) {
-                    ret = OGRERR_FAILURE;
-                    delete y;
-                    delete x;
-                    OGRDestroyPreparedGeometry(x_prepared_geom);
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-
-            CPLErrorReset();
-            OGRGeometry *poIntersection = x_geom->Intersection(y_geom);
-            if (CPLGetLastErrorType() != CE_None || poIntersection == NULL) {
-                delete poIntersection;
-                delete y;
-                if (!bSkipFailures) {
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    OGRDestroyPreparedGeometry(x_prepared_geom);
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                    continue;
-                }
-            }
-            if( poIntersection->IsEmpty() ||
-                (!bKeepLowerDimGeom &&
-                 (x_geom->getDimension() == y_geom->getDimension() &&
-                  poIntersection->getDimension() < x_geom->getDimension())) )
-            {
-                delete poIntersection;
-                delete y;
-            }
-            else
-            {
-                OGRFeature *z = new OGRFeature(poDefnResult);
-                z->SetFieldsFrom(x, mapInput);
-                z->SetFieldsFrom(y, mapMethod);
-                if( bPromoteToMulti )
-                    poIntersection = promote_to_multi(poIntersection);
-                z->SetGeometryDirectly(poIntersection);
-
-                if (x_geom_diff) {
-                    CPLErrorReset();
-                    OGRGeometry *x_geom_diff_new = x_geom_diff->Difference(y_geom);
-                    if (CPLGetLastErrorType() != CE_None || x_geom_diff_new == NULL) {
-                        delete x_geom_diff_new;
-                        if (!bSkipFailures) {
-                            ret = OGRERR_FAILURE;
-                            delete y;
-                            delete z;
-                            delete x;
-                            delete x_geom_diff;
-                            OGRDestroyPreparedGeometry(x_prepared_geom);
-                            goto done;
-                        } else {
-                            CPLErrorReset();
-                        }
-                    } else {
-                        delete x_geom_diff;
-                        x_geom_diff = x_geom_diff_new;
-                    }
-                }
-
-                delete y;
-                ret = pLayerResult->CreateFeature(z);
-                delete z;
-                if (ret != OGRERR_NONE) {
-                    if (!bSkipFailures) {
-                        delete x;
-                        if (x_geom_diff)
-                            delete x_geom_diff;
-                        OGRDestroyPreparedGeometry(x_prepared_geom);
-                        goto done;
-                    } else {
-                        CPLErrorReset();
-                        ret = OGRERR_NONE;
-                    }
-                }
-            }
-        }
-
-        OGRDestroyPreparedGeometry(x_prepared_geom);
-
-        if( x_geom_diff == NULL || x_geom_diff->IsEmpty() )
-        {
-            delete x_geom_diff;
-            delete x;
-        }
-        else
-        {
-            OGRFeature *z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapInput);
-            if( bPromoteToMulti )
-                x_geom_diff = promote_to_multi(x_geom_diff);
-            z->SetGeometryDirectly(x_geom_diff);
-            delete x;
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
+    overlay_context_init(&sOverlay, OVERLAY_IDENTITY, pLayerMethod, poDefnResult,
+                         mapInput, mapMethod, pGeometryMethodFilter, bKeepLowerDimGeom,
+                         papszOptions);
+    ret = overlay_input_layer(&sOverlay, this, pLayerResult,
+                              &progress_counter, progress_max, progress_ticker,
+                              pfnProgress, pProgressArg);
+    overlay_context_free(&sOverlay);
+    if (ret != OGRERR_NONE) goto done;
 
     // restore filter on method layer and add features based on it
     pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
@@ -2755,8 +3121,9 @@ done:
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -2778,6 +3145,11 @@ done:
  *     result features with lower dimension geometry that would
  *     otherwise be added to the result layer. The default is to add
  *     but only if the result layer has an unknown geometry type.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Union().
@@ -2841,8 +3213,9 @@ OGRErr OGR_L_Union( OGRLayerH pLayerInput,
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -2857,6 +3230,11 @@ OGRErr OGR_L_Union( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This method is the same as the C function OGR_L_SymDifference().
@@ -2896,6 +3274,7 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
     OGRGeometry *pGeometryInputFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
+    OGRLayerOverlayContext sOverlay;
     double progress_max = (double) GetFeatureCount(0) + (double) pLayerMethod->GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
@@ -2921,8 +3300,19 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
     poDefnResult = pLayerResult->GetLayerDefn();
 
     // add features based on input layer
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
+    overlay_context_init(&sOverlay, OVERLAY_DIFFERENCE, pLayerMethod, poDefnResult,
+                         mapInput, mapMethod, pGeometryMethodFilter, FALSE,
+                         papszOptions);
+    ret = overlay_input_layer(&sOverlay, this, pLayerResult,
+                              &progress_counter, progress_max, progress_ticker,
+                              pfnProgress, pProgressArg);
+    overlay_context_free(&sOverlay);
+    if (ret != OGRERR_NONE) goto done;
+
+    // restore filter on method layer and add features based on it
+    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
+    pLayerMethod->ResetReading();
+    while (OGRFeature *x = pLayerMethod->GetNextFeature()) {
 
         if (pfnProgress) {
             double p = progress_counter/progress_max;
@@ -2937,9 +3327,9 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
             progress_counter += 1.0;
         }
 
-        // set up the filter on method layer
+        // set up the filter on input layer
         CPLErrorReset();
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
+        OGRGeometry *x_geom = set_filter_from(this, pGeometryInputFilter, x);
         if (CPLGetLastErrorType() != CE_None) {
             if (!bSkipFailures) {
                 ret = OGRERR_FAILURE;
@@ -2956,8 +3346,8 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
         }
 
         OGRGeometry *geom = x_geom->clone(); // this will be the geometry of the result feature
-        pLayerMethod->ResetReading();
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
+        ResetReading();
+        while (OGRFeature *y = GetNextFeature()) {
             OGRGeometry *y_geom = y->GetGeometryRef();
             if (!y_geom) {delete y; continue;}
             if (geom) {
@@ -2981,103 +3371,13 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
                 }
             }
             delete y;
-            if (geom && geom->IsEmpty()) break;
+            if (geom == NULL || geom->IsEmpty()) break;
         }
 
         OGRFeature *z = NULL;
         if (geom && !geom->IsEmpty()) {
             z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapInput);
-            if( bPromoteToMulti )
-                geom = promote_to_multi(geom);
-            z->SetGeometryDirectly(geom);
-        } else {
-            if (geom) delete geom;
-        }
-        delete x;
-        if (z) {
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
-
-    // restore filter on method layer and add features based on it
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
-    pLayerMethod->ResetReading();
-    while (OGRFeature *x = pLayerMethod->GetNextFeature()) {
-
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
-
-        // set up the filter on input layer
-        CPLErrorReset();
-        OGRGeometry *x_geom = set_filter_from(this, pGeometryInputFilter, x);
-        if (CPLGetLastErrorType() != CE_None) {
-            if (!bSkipFailures) {
-                ret = OGRERR_FAILURE;
-                delete x;
-                goto done;
-            } else {
-                CPLErrorReset();
-                ret = OGRERR_NONE;
-            }
-        }
-        if (!x_geom) {
-            delete x;
-            continue;
-        }
-
-        OGRGeometry *geom = x_geom->clone(); // this will be the geometry of the result feature
-        ResetReading();
-        while (OGRFeature *y = GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            if (geom) {
-                CPLErrorReset();
-                OGRGeometry *geom_new = geom->Difference(y_geom);
-                if (CPLGetLastErrorType() != CE_None || geom_new == NULL) {
-                    delete geom_new;
-                    if (!bSkipFailures) {
-                        ret = OGRERR_FAILURE;
-                        delete geom;
-                        delete y;
-                        delete x;
-                        goto done;
-                    } else {
-                        CPLErrorReset();
-                        ret = OGRERR_NONE;
-                    }
-                } else {
-                    delete geom;
-                    geom = geom_new;
-                }
-            }
-            delete y;
-            if (geom == NULL || geom->IsEmpty()) break;
-        }
-
-        OGRFeature *z = NULL;
-        if (geom && !geom->IsEmpty()) {
-            z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapMethod);
+            z->SetFieldsFrom(x, mapMethod);
             if( bPromoteToMulti )
                 geom = promote_to_multi(geom);
             z->SetGeometryDirectly(geom);
@@ -3135,8 +3435,9 @@ done:
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3151,6 +3452,11 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::SymDifference().
@@ -3212,8 +3518,9 @@ OGRErr OGR_L_SymDifference( OGRLayerH pLayerInput,
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3235,6 +3542,11 @@ OGRErr OGR_L_SymDifference( OGRLayerH pLayerInput,
  *     result features with lower dimension geometry that would
  *     otherwise be added to the result layer. The default is to add
  *     but only if the result layer has an unknown geometry type.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This method is the same as the C function OGR_L_Identity().
@@ -3273,13 +3585,10 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
     OGRGeometry *pGeometryMethodFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
+    OGRLayerOverlayContext sOverlay;
     double progress_max = (double) GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
-    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
-    int bUsePreparedGeometries = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_PREPARED_GEOMETRIES", "YES"));
-    if (bUsePreparedGeometries) bUsePreparedGeometries = OGRHasPreparedGeometrySupport();
     int bKeepLowerDimGeom = CPLTestBool(CSLFetchNameValueDef(papszOptions, "KEEP_LOWER_DIMENSION_GEOMETRIES", "YES"));
 
     // check for GEOS
@@ -3306,171 +3615,14 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
     poDefnResult = pLayerResult->GetLayerDefn();
 
     // split the features in input layer to the result layer
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
-
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
-
-        // set up the filter on method layer
-        CPLErrorReset();
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (CPLGetLastErrorType() != CE_None) {
-            if (!bSkipFailures) {
-                ret = OGRERR_FAILURE;
-                delete x;
-                goto done;
-            } else {
-                CPLErrorReset();
-                ret = OGRERR_NONE;
-            }
-        }
-        if (!x_geom) {
-            delete x;
-            continue;
-        }
-
-        OGRPreparedGeometry* x_prepared_geom = NULL;
-        if (bUsePreparedGeometries) {
-            x_prepared_geom = OGRCreatePreparedGeometry(x_geom);
-            if (!x_prepared_geom) {
-                delete x;
-                goto done;
-            }
-        }
-
-        OGRGeometry *x_geom_diff = x_geom->clone(); // this will be the geometry of the result feature
-        pLayerMethod->ResetReading();
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-
-            CPLErrorReset();
-            if (x_prepared_geom && !(OGRPreparedGeometryIntersects(x_prepared_geom, y_geom))) {
-                if (CPLGetLastErrorType() == CE_None) {
-                    delete y;
-                    continue;
-                }
-            }
-            if (CPLGetLastErrorType() != CE_None) {
-                if (!bSkipFailures) {
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    delete x_geom_diff;
-                    OGRDestroyPreparedGeometry(x_prepared_geom);
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-
-            CPLErrorReset();
-            OGRGeometry* poIntersection = x_geom->Intersection(y_geom);
-            if (CPLGetLastErrorType() != CE_None || poIntersection == NULL) {
-                delete poIntersection;
-                delete y;
-                if (!bSkipFailures) {
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    delete x_geom_diff;
-                    OGRDestroyPreparedGeometry(x_prepared_geom);
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-            else if( poIntersection->IsEmpty() ||
-                     (!bKeepLowerDimGeom &&
-                      (x_geom->getDimension() == y_geom->getDimension() &&
-                       poIntersection->getDimension() < x_geom->getDimension())) )
-            {
-                delete poIntersection;
-                delete y;
-            }
-            else
-            {
-                OGRFeature *z = new OGRFeature(poDefnResult);
-                z->SetFieldsFrom(x, mapInput);
-                z->SetFieldsFrom(y, mapMethod);
-                if( bPromoteToMulti )
-                    poIntersection = promote_to_multi(poIntersection);
-                z->SetGeometryDirectly(poIntersection);
-                if (x_geom_diff) {
-                    CPLErrorReset();
-                    OGRGeometry *x_geom_diff_new = x_geom_diff->Difference(y_geom);
-                    if (CPLGetLastErrorType() != CE_None || x_geom_diff_new == NULL) {
-                        if (!bSkipFailures) {
-                            ret = OGRERR_FAILURE;
-                            delete z;
-                            delete y;
-                            delete x;
-                            delete x_geom_diff;
-                            OGRDestroyPreparedGeometry(x_prepared_geom);
-                            goto done;
-                        } else {
-                            CPLErrorReset();
-                        }
-                    } else {
-                        delete x_geom_diff;
-                        x_geom_diff = x_geom_diff_new;
-                    }
-                }
-                delete y;
-                ret = pLayerResult->CreateFeature(z);
-                delete z;
-                if (ret != OGRERR_NONE) {
-                    if (!bSkipFailures) {
-                        delete x;
-                        delete x_geom_diff;
-                        OGRDestroyPreparedGeometry(x_prepared_geom);
-                        goto done;
-                    } else {
-                        CPLErrorReset();
-                        ret = OGRERR_NONE;
-                    }
-                }
-            }
-        }
-
-        OGRDestroyPreparedGeometry(x_prepared_geom);
-
-        if( x_geom_diff == NULL || x_geom_diff->IsEmpty() )
-        {
-            delete x_geom_diff;
-            delete x;
-        }
-        else
-        {
-            OGRFeature *z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapInput);
-            if( bPromoteToMulti )
-                x_geom_diff = promote_to_multi(x_geom_diff);
-            z->SetGeometryDirectly(x_geom_diff);
-            delete x;
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
+    overlay_context_init(&sOverlay, OVERLAY_IDENTITY, pLayerMethod, poDefnResult,
+                         mapInput, mapMethod, pGeometryMethodFilter, bKeepLowerDimGeom,
+                         papszOptions);
+    ret = overlay_input_layer(&sOverlay, this, pLayerResult,
+                              &progress_counter, progress_max, progress_ticker,
+                              pfnProgress, pProgressArg);
+    overlay_context_free(&sOverlay);
+    if (ret != OGRERR_NONE) goto done;
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
@@ -3504,8 +3656,9 @@ done:
  * layer, then the attribute in the result feature will get the value
  * from the feature of the method layer (even if it is undefined).
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3527,6 +3680,11 @@ done:
  *     result features with lower dimension geometry that would
  *     otherwise be added to the result layer. The default is to add
  *     but only if the result layer has an unknown geometry type.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Identity().
@@ -3590,8 +3748,9 @@ OGRErr OGR_L_Identity( OGRLayerH pLayerInput,
  * the attribute in the result feature the originates from the method
  * layer will get the value from the feature of the method layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3606,6 +3765,11 @@ OGRErr OGR_L_Identity( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This method is the same as the C function OGR_L_Update().
@@ -3644,11 +3808,11 @@ OGRErr OGRLayer::Update( OGRLayer *pLayerMethod,
     OGRGeometry *pGeometryMethodFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
+    OGRLayerOverlayContext sOverlay;
     double progress_max = (double) GetFeatureCount(0) + (double) pLayerMethod->GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
     int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
@@ -3667,93 +3831,14 @@ OGRErr OGRLayer::Update( OGRLayer *pLayerMethod,
     poDefnResult = pLayerResult->GetLayerDefn();
 
     // add clipped features from the input layer
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
-
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
-
-        // set up the filter on method layer
-        CPLErrorReset();
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (CPLGetLastErrorType() != CE_None) {
-            if (!bSkipFailures) {
-                ret = OGRERR_FAILURE;
-                delete x;
-                goto done;
-            } else {
-                CPLErrorReset();
-                ret = OGRERR_NONE;
-            }
-        }
-        if (!x_geom) {
-            delete x;
-            continue;
-        }
-
-        OGRGeometry *x_geom_diff = x_geom->clone(); //this will be the geometry of a result feature
-        pLayerMethod->ResetReading();
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            if (x_geom_diff) {
-                CPLErrorReset();
-                OGRGeometry *x_geom_diff_new = x_geom_diff->Difference(y_geom);
-                if (CPLGetLastErrorType() != CE_None || x_geom_diff_new == NULL) {
-                    delete x_geom_diff_new;
-                    if (!bSkipFailures) {
-                        ret = OGRERR_FAILURE;
-                        delete y;
-                        delete x;
-                        delete x_geom_diff;
-                        goto done;
-                    } else {
-                        CPLErrorReset();
-                        ret = OGRERR_NONE;
-                    }
-                } else {
-                    delete x_geom_diff;
-                    x_geom_diff = x_geom_diff_new;
-                }
-            }
-            delete y;
-        }
-
-        if( x_geom_diff == NULL || x_geom_diff->IsEmpty() )
-        {
-            delete x_geom_diff;
-            delete x;
-        }
-        else
-        {
-            OGRFeature *z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapInput);
-            if( bPromoteToMulti )
-                x_geom_diff = promote_to_multi(x_geom_diff);
-            z->SetGeometryDirectly(x_geom_diff);
-            delete x;
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-    }
+    overlay_context_init(&sOverlay, OVERLAY_DIFFERENCE, pLayerMethod, poDefnResult,
+                         mapInput, mapMethod, pGeometryMethodFilter, FALSE,
+                         papszOptions);
+    ret = overlay_input_layer(&sOverlay, this, pLayerResult,
+                              &progress_counter, progress_max, progress_ticker,
+                              pfnProgress, pProgressArg);
+    overlay_context_free(&sOverlay);
+    if (ret != OGRERR_NONE) goto done;
 
     // restore the original filter and add features from the update layer
     pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
@@ -3825,8 +3910,9 @@ done:
  * the attribute in the result feature the originates from the method
  * layer will get the value from the feature of the method layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3841,6 +3927,11 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Update().
@@ -3897,8 +3988,9 @@ OGRErr OGR_L_Update( OGRLayerH pLayerInput,
  * schema of the result layer can be set by the user or, if it is
  * empty, is initialized to contain all fields in the input layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -3913,6 +4005,11 @@ OGRErr OGR_L_Update( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This method is the same as the C function OGR_L_Clip().
@@ -3949,11 +4046,10 @@ OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
     OGRFeatureDefn *poDefnResult = NULL;
     OGRGeometry *pGeometryMethodFilter = NULL;
     int *mapInput = NULL;
+    OGRLayerOverlayContext sOverlay;
     double progress_max = (double) GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
-    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
@@ -3968,111 +4064,14 @@ OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
     if (ret != OGRERR_NONE) goto done;
 
     poDefnResult = pLayerResult->GetLayerDefn();
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
-
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
-
-        // set up the filter on method layer
-        CPLErrorReset();
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (CPLGetLastErrorType() != CE_None) {
-            if (!bSkipFailures) {
-                ret = OGRERR_FAILURE;
-                delete x;
-                goto done;
-            } else {
-                CPLErrorReset();
-                ret = OGRERR_NONE;
-            }
-        }
-        if (!x_geom) {
-            delete x;
-            continue;
-        }
-
-        OGRGeometry *geom = NULL; // this will be the geometry of the result feature
-        pLayerMethod->ResetReading();
-        // incrementally add area from y to geom
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            if (!geom) {
-                geom = y_geom->clone();
-            } else {
-                CPLErrorReset();
-                OGRGeometry *geom_new = geom->Union(y_geom);
-                if (CPLGetLastErrorType() != CE_None || geom_new == NULL) {
-                    delete geom_new;
-                    if (!bSkipFailures) {
-                        ret = OGRERR_FAILURE;
-                        delete y;
-                        delete x;
-                        delete geom;
-                        goto done;
-                    } else {
-                        CPLErrorReset();
-                        ret = OGRERR_NONE;
-                    }
-                } else {
-                    delete geom;
-                    geom = geom_new;
-                }
-            }
-            delete y;
-        }
-
-        // possibly add a new feature with area x intersection sum of y
-        if (geom) {
-            CPLErrorReset();
-            OGRGeometry* poIntersection = x_geom->Intersection(geom);
-            if (CPLGetLastErrorType() != CE_None || poIntersection == NULL) {
-                delete poIntersection;
-                if (!bSkipFailures) {
-                    ret = OGRERR_FAILURE;
-                    delete geom;
-                    delete x;
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-            else if( !poIntersection->IsEmpty() )
-            {
-                OGRFeature *z = new OGRFeature(poDefnResult);
-                z->SetFieldsFrom(x, mapInput);
-                if( bPromoteToMulti )
-                    poIntersection = promote_to_multi(poIntersection);
-                z->SetGeometryDirectly(poIntersection);
-                ret = pLayerResult->CreateFeature(z);
-                delete z;
-                if (ret != OGRERR_NONE) {
-                    if (!bSkipFailures) {
-                        goto done;
-                    } else {
-                        CPLErrorReset();
-                        ret = OGRERR_NONE;
-                    }
-                }
-            }
-            else
-                delete poIntersection;
-            delete geom;
-        }
-        delete x;
-    }
+    overlay_context_init(&sOverlay, OVERLAY_CLIP, pLayerMethod, poDefnResult,
+                         mapInput, NULL, pGeometryMethodFilter, FALSE,
+                         papszOptions);
+    ret = overlay_input_layer(&sOverlay, this, pLayerResult,
+                              &progress_counter, progress_max, progress_ticker,
+                              pfnProgress, pProgressArg);
+    overlay_context_free(&sOverlay);
+    if (ret != OGRERR_NONE) goto done;
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
@@ -4100,8 +4099,9 @@ done:
  * schema of the result layer can be set by the user or, if it is
  * empty, is initialized to contain all fields in the input layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -4116,6 +4116,11 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Clip().
@@ -4172,8 +4177,9 @@ OGRErr OGR_L_Clip( OGRLayerH pLayerInput,
  * it is empty, is initialized to contain all fields in the input
  * layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -4188,6 +4194,11 @@ OGRErr OGR_L_Clip( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This method is the same as the C function OGR_L_Erase().
@@ -4224,11 +4235,10 @@ OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
     OGRFeatureDefn *poDefnResult = NULL;
     OGRGeometry *pGeometryMethodFilter = NULL;
     int *mapInput = NULL;
+    OGRLayerOverlayContext sOverlay;
     double progress_max = (double) GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
-    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
@@ -4244,96 +4254,14 @@ OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
     if (ret != OGRERR_NONE) goto done;
     poDefnResult = pLayerResult->GetLayerDefn();
 
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
-
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
-
-        // set up the filter on the method layer
-        CPLErrorReset();
-        OGRGeometry *x_geom = set_filter_from(pLayerMethod, pGeometryMethodFilter, x);
-        if (CPLGetLastErrorType() != CE_None) {
-            if (!bSkipFailures) {
-                ret = OGRERR_FAILURE;
-                delete x;
-                goto done;
-            } else {
-                CPLErrorReset();
-                ret = OGRERR_NONE;
-            }
-        }
-        if (!x_geom) {
-            delete x;
-            continue;
-        }
-
-        OGRGeometry *geom = x_geom->clone(); // this will be the geometry of the result feature
-        pLayerMethod->ResetReading();
-        // incrementally erase y from geom
-        while (OGRFeature *y = pLayerMethod->GetNextFeature()) {
-            OGRGeometry *y_geom = y->GetGeometryRef();
-            if (!y_geom) {delete y; continue;}
-            CPLErrorReset();
-            OGRGeometry *geom_new = geom->Difference(y_geom);
-            if (CPLGetLastErrorType() != CE_None || geom_new == NULL) {
-                delete geom_new;
-                if (!bSkipFailures) {
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    delete y;
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            } else {
-                delete geom;
-                geom = geom_new;
-                if (geom->IsEmpty())
-                {
-                    delete y;
-                    break;
-                }
-            }
-            delete y;
-        }
-
-        // add a new feature if there is remaining area
-        if (!geom->IsEmpty()) {
-            OGRFeature *z = new OGRFeature(poDefnResult);
-            z->SetFieldsFrom(x, mapInput);
-            if( bPromoteToMulti )
-                geom = promote_to_multi(geom);
-            z->SetGeometryDirectly(geom);
-            ret = pLayerResult->CreateFeature(z);
-            delete z;
-            if (ret != OGRERR_NONE) {
-                if (!bSkipFailures) {
-                    delete x;
-                    goto done;
-                } else {
-                    CPLErrorReset();
-                    ret = OGRERR_NONE;
-                }
-            }
-        }
-        else
-        {
-            delete geom;
-        }
-        delete x;
-    }
+    overlay_context_init(&sOverlay, OVERLAY_DIFFERENCE, pLayerMethod, poDefnResult,
+                         mapInput, NULL, pGeometryMethodFilter, FALSE,
+                         papszOptions);
+    ret = overlay_input_layer(&sOverlay, this, pLayerResult,
+                              &progress_counter, progress_max, progress_ticker,
+                              pfnProgress, pProgressArg);
+    overlay_context_free(&sOverlay);
+    if (ret != OGRERR_NONE) goto done;
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
@@ -4361,8 +4289,9 @@ done:
  * it is empty, is initialized to contain all fields in the input
  * layer.
  *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
+ * \note The features of the method layer are read once and kept in
+ * memory (GDAL &gt;= 2.3), so the method layer should preferably be the
+ * smaller one.
  *
  * \note This method relies on GEOS support. Do not use unless the
  * GEOS support is compiled in.
@@ -4377,6 +4306,11 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>NUM_THREADS=number or ALL_CPUS. (GDAL &gt;= 2.3) Number of threads
+ *     used to process the features of the input layer. Defaults to
+ *     the value of the GDAL_NUM_THREADS configuration option, or 1.
+ *     The result features are written in the same order whatever the
+ *     number of threads.
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Erase().
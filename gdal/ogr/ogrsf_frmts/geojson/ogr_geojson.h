@@ -41,6 +41,7 @@
 #include "ogrgeojsonwriter.h"
 
 class OGRGeoJSONDataSource;
+class OGRGeoJSONReader;
 
 /************************************************************************/
 /*                           OGRGeoJSONLayer                            */
@@ -67,6 +68,13 @@ class OGRGeoJSONLayer : public OGRMemLayer
     virtual int         TestCapability( const char * pszCap ) override;
 
     virtual OGRErr      SyncToDisk() override;
+
+    virtual void        ResetReading() override;
+    virtual OGRFeature* GetNextFeature() override;
+    virtual OGRErr      SetNextByIndex( GIntBig nIndex ) override;
+    virtual OGRFeature* GetFeature( GIntBig nFID ) override;
+    virtual GIntBig     GetFeatureCount( int bForce ) override;
+
     //
     // OGRGeoJSONLayer Interface
     //
@@ -74,11 +82,18 @@ class OGRGeoJSONLayer : public OGRMemLayer
     void AddFeature( OGRFeature* poFeature );
     void DetectGeometryType();
 
+    // Streaming mode: features are read from the file by poReader, that
+    // the layer takes ownership of, instead of being stored in memory.
+    void SetStreamingReader( OGRGeoJSONReader* poReader,
+                             GIntBig nTotalFeatureCount );
+
   private:
     OGRGeoJSONDataSource* poDS_;
     CPLString sFIDColumn_;
     bool bUpdated_;
     bool bOriginalIdModified_;
+    OGRGeoJSONReader* poStreamingReader_;
+    GIntBig nTotalFeatureCount_;
 };
 
 /************************************************************************/
@@ -212,8 +227,11 @@ class OGRGeoJSONDataSource : public OGRDataSource
     //
     void Clear();
     int ReadFromFile( GDALOpenInfo* poOpenInfo );
+    int ReadFromFileStreaming( GDALOpenInfo* poOpenInfo );
     int ReadFromService( const char* pszSource );
     void LoadLayers(char** papszOpenOptions);
+    void ConfigureReader( OGRGeoJSONReader& oReader,
+                          char** papszOpenOptions );
 };
 
 #endif  // OGR_GEOJSON_H_INCLUDED
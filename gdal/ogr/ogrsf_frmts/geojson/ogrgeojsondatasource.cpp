@@ -95,6 +95,8 @@ int OGRGeoJSONDataSource::Open( GDALOpenInfo* poOpenInfo,
     }
     else if( eGeoJSONSourceFile == nSrcType )
     {
+        if( ReadFromFileStreaming( poOpenInfo ) )
+            return TRUE;
         if( !ReadFromFile( poOpenInfo ) )
             return FALSE;
     }
@@ -543,6 +545,66 @@ int OGRGeoJSONDataSource::ReadFromFile( GDALOpenInfo* poOpenInfo )
     return TRUE;
 }
 
+/************************************************************************/
+/*                       ReadFromFileStreaming()                        */
+/*                                                                      */
+/*      Large FeatureCollection files opened in read-only mode are      */
+/*      read in streaming mode: a first pass establishes the layer      */
+/*      definition, and features are then read from the file on        */
+/*      demand, instead of loading the whole file and all its features  */
+/*      in memory.                                                      */
+/************************************************************************/
+
+int OGRGeoJSONDataSource::ReadFromFileStreaming( GDALOpenInfo* poOpenInfo )
+{
+    if( poOpenInfo->eAccess != GA_ReadOnly || poOpenInfo->fpL == NULL ||
+        poOpenInfo->pabyHeader == NULL )
+        return FALSE;
+
+    // In MB.
+    const double dfMinSize =
+        CPLAtof(CPLGetConfigOption("OGR_GEOJSON_STREAMING_MIN_SIZE", "100"));
+    if( VSIFSeekL(poOpenInfo->fpL, 0, SEEK_END) != 0 )
+        return FALSE;
+    const vsi_l_offset nFileSize = VSIFTellL(poOpenInfo->fpL);
+    if( VSIFSeekL(poOpenInfo->fpL, 0, SEEK_SET) != 0 ||
+        static_cast<double>(nFileSize) < dfMinSize * 1024 * 1024 )
+        return FALSE;
+
+    // Leave the formats derived from GeoJSON to the regular code path.
+    const char* pszHeader =
+        reinterpret_cast<const char*>(poOpenInfo->pabyHeader);
+    if( strstr(pszHeader, "loadGeoJSON(") != NULL ||
+        strstr(pszHeader, "jsonp(") != NULL ||
+        strstr(pszHeader, "esriGeometry") != NULL ||
+        strstr(pszHeader, "esriFieldType") != NULL ||
+        strstr(pszHeader, "\"Topology\"") != NULL )
+    {
+        return FALSE;
+    }
+
+    pszName_ = CPLStrdup( poOpenInfo->pszFilename );
+    SetDescription( poOpenInfo->pszFilename );
+
+    OGRGeoJSONReader* poReader = new OGRGeoJSONReader();
+    ConfigureReader( *poReader, poOpenInfo->papszOpenOptions );
+    if( !poReader->FirstPassReadLayer( this, poOpenInfo->fpL ) )
+    {
+        CPLDebug( "GeoJSON", "Cannot read %s in streaming mode",
+                  poOpenInfo->pszFilename );
+        delete poReader;
+        CPLFree( pszName_ );
+        pszName_ = NULL;
+        VSIFSeekL( poOpenInfo->fpL, 0, SEEK_SET );
+        return FALSE;
+    }
+
+    // Now owned by the reader, that is owned by the layer.
+    poOpenInfo->fpL = NULL;
+
+    return TRUE;
+}
+
 /************************************************************************/
 /*                           ReadFromService()                          */
 /************************************************************************/
@@ -706,31 +768,7 @@ void OGRGeoJSONDataSource::LoadLayers(char** papszOpenOptionsIn)
 /*      Configure GeoJSON format translator.                            */
 /* -------------------------------------------------------------------- */
     OGRGeoJSONReader reader;
-
-    if( eGeometryAsCollection == flTransGeom_ )
-    {
-        reader.SetPreserveGeometryType( false );
-        CPLDebug( "GeoJSON", "Geometry as OGRGeometryCollection type." );
-    }
-
-    if( eAttributesSkip == flTransAttrs_ )
-    {
-        reader.SetSkipAttributes( true );
-        CPLDebug( "GeoJSON", "Skip all attributes." );
-    }
-
-    reader.SetFlattenNestedAttributes(
-        CPLFetchBool(papszOpenOptionsIn, "FLATTEN_NESTED_ATTRIBUTES", false),
-        CSLFetchNameValueDef(papszOpenOptionsIn,
-                             "NESTED_ATTRIBUTE_SEPARATOR", "_")[0]);
-
-    const bool bDefaultNativeData = bUpdatable_;
-    reader.SetStoreNativeData(
-        CPLFetchBool(papszOpenOptionsIn, "NATIVE_DATA", bDefaultNativeData));
-
-    reader.SetArrayAsString(
-        CPLTestBool(CSLFetchNameValueDef(papszOpenOptionsIn, "ARRAY_AS_STRING",
-                CPLGetConfigOption("OGR_GEOJSON_ARRAY_AS_STRING", "NO"))));
+    ConfigureReader( reader, papszOpenOptionsIn );
 
 /* -------------------------------------------------------------------- */
 /*      Parse GeoJSON and build valid OGRLayer instance.                */
@@ -765,6 +803,39 @@ void OGRGeoJSONDataSource::LoadLayers(char** papszOpenOptionsIn)
     return;
 }
 
+/************************************************************************/
+/*                          ConfigureReader()                           */
+/************************************************************************/
+
+void OGRGeoJSONDataSource::ConfigureReader( OGRGeoJSONReader& reader,
+                                            char** papszOpenOptionsIn )
+{
+    if( eGeometryAsCollection == flTransGeom_ )
+    {
+        reader.SetPreserveGeometryType( false );
+        CPLDebug( "GeoJSON", "Geometry as OGRGeometryCollection type." );
+    }
+
+    if( eAttributesSkip == flTransAttrs_ )
+    {
+        reader.SetSkipAttributes( true );
+        CPLDebug( "GeoJSON", "Skip all attributes." );
+    }
+
+    reader.SetFlattenNestedAttributes(
+        CPLFetchBool(papszOpenOptionsIn, "FLATTEN_NESTED_ATTRIBUTES", false),
+        CSLFetchNameValueDef(papszOpenOptionsIn,
+                             "NESTED_ATTRIBUTE_SEPARATOR", "_")[0]);
+
+    const bool bDefaultNativeData = bUpdatable_;
+    reader.SetStoreNativeData(
+        CPLFetchBool(papszOpenOptionsIn, "NATIVE_DATA", bDefaultNativeData));
+
+    reader.SetArrayAsString(
+        CPLTestBool(CSLFetchNameValueDef(papszOpenOptionsIn, "ARRAY_AS_STRING",
+                CPLGetConfigOption("OGR_GEOJSON_ARRAY_AS_STRING", "NO"))));
+}
+
 /************************************************************************/
 /*                            AddLayer()                                */
 /************************************************************************/
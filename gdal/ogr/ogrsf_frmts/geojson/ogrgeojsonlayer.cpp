@@ -46,6 +46,7 @@
 #endif  // !DEBUG_VERBOSE
 
 #include "ogr_geojson.h"
+#include "ogrgeojsonreader.h"
 
 // Remove annoying warnings Microsoft Visual C++:
 //   'class': assignment operator could not be generated.
@@ -75,7 +76,9 @@ OGRGeoJSONLayer::OGRGeoJSONLayer( const char* pszName,
     OGRMemLayer( pszName, poSRSIn, eGType),
     poDS_(poDS),
     bUpdated_(false),
-    bOriginalIdModified_(false)
+    bOriginalIdModified_(false),
+    poStreamingReader_(NULL),
+    nTotalFeatureCount_(0)
 {
     SetAdvertizeUTF8(true);
     SetUpdatable( poDS->IsUpdatable() );
@@ -85,7 +88,22 @@ OGRGeoJSONLayer::OGRGeoJSONLayer( const char* pszName,
 /*                          ~OGRGeoJSONLayer                            */
 /************************************************************************/
 
-OGRGeoJSONLayer::~OGRGeoJSONLayer() {}
+OGRGeoJSONLayer::~OGRGeoJSONLayer()
+{
+    delete poStreamingReader_;
+}
+
+/************************************************************************/
+/*                         SetStreamingReader()                         */
+/************************************************************************/
+
+void OGRGeoJSONLayer::SetStreamingReader( OGRGeoJSONReader* poReader,
+                                          GIntBig nTotalFeatureCount )
+{
+    delete poStreamingReader_;
+    poStreamingReader_ = poReader;
+    nTotalFeatureCount_ = nTotalFeatureCount;
+}
 
 /************************************************************************/
 /*                           GetFIDColumn                               */
@@ -114,9 +132,92 @@ int OGRGeoJSONLayer::TestCapability( const char * pszCap )
 {
     if( EQUAL(pszCap, OLCCurveGeometries) )
         return FALSE;
+    if( poStreamingReader_ != NULL )
+    {
+        if( EQUAL(pszCap, OLCFastFeatureCount) )
+            return m_poFilterGeom == NULL && m_poAttrQuery == NULL;
+        if( EQUAL(pszCap, OLCRandomRead) ||
+            EQUAL(pszCap, OLCFastSetNextByIndex) ||
+            EQUAL(pszCap, OLCFastSpatialFilter) ||
+            EQUAL(pszCap, OLCFastGetExtent) )
+            return FALSE;
+    }
     return OGRMemLayer::TestCapability(pszCap);
 }
 
+/************************************************************************/
+/*                           ResetReading()                             */
+/************************************************************************/
+
+void OGRGeoJSONLayer::ResetReading()
+{
+    if( poStreamingReader_ != NULL )
+        poStreamingReader_->ResetReading();
+    else
+        OGRMemLayer::ResetReading();
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONLayer::GetNextFeature()
+{
+    if( poStreamingReader_ == NULL )
+        return OGRMemLayer::GetNextFeature();
+
+    while( true )
+    {
+        OGRFeature* poFeature = poStreamingReader_->GetNextFeature(this);
+        if( poFeature == NULL )
+            return NULL;
+        if( (m_poFilterGeom == NULL ||
+             FilterGeometry(poFeature->GetGeometryRef())) &&
+            (m_poAttrQuery == NULL || m_poAttrQuery->Evaluate(poFeature)) )
+        {
+            return poFeature;
+        }
+        delete poFeature;
+    }
+}
+
+/************************************************************************/
+/*                           SetNextByIndex()                           */
+/************************************************************************/
+
+OGRErr OGRGeoJSONLayer::SetNextByIndex( GIntBig nIndex )
+{
+    if( poStreamingReader_ != NULL )
+        return OGRLayer::SetNextByIndex(nIndex);
+    return OGRMemLayer::SetNextByIndex(nIndex);
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONLayer::GetFeature( GIntBig nFID )
+{
+    if( poStreamingReader_ != NULL )
+        return OGRLayer::GetFeature(nFID);
+    return OGRMemLayer::GetFeature(nFID);
+}
+
+/************************************************************************/
+/*                          GetFeatureCount()                           */
+/************************************************************************/
+
+GIntBig OGRGeoJSONLayer::GetFeatureCount( int bForce )
+{
+    if( poStreamingReader_ != NULL )
+    {
+        if( m_poFilterGeom == NULL && m_poAttrQuery == NULL )
+            return nTotalFeatureCount_;
+        return OGRLayer::GetFeatureCount(bForce);
+    }
+    return OGRMemLayer::GetFeatureCount(bForce);
+}
+
 /************************************************************************/
 /*                           SyncToDisk()                               */
 /************************************************************************/
@@ -188,7 +289,9 @@ void OGRGeoJSONLayer::AddFeature( OGRFeature* poFeature )
 
 void OGRGeoJSONLayer::DetectGeometryType()
 {
-    if( GetLayerDefn()->GetGeomType() != wkbUnknown )
+    // In streaming mode, this has been done when scanning the file.
+    if( poStreamingReader_ != NULL ||
+        GetLayerDefn()->GetGeomType() != wkbUnknown )
         return;
 
     ResetReading();
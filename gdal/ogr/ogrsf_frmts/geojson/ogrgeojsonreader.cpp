@@ -35,6 +35,334 @@
 
 CPL_CVSID("$Id$");
 
+// Size of the blocks read from the file in streaming mode.
+static const size_t STREAMING_BUFFER_SIZE = 65536;
+
+/************************************************************************/
+/*                       OGRGeoJSONStreamingParser                      */
+/*                                                                      */
+/*      Incremental scanner of a FeatureCollection: it tracks the       */
+/*      structure of the top-level object, character per character,     */
+/*      and hands the text of each element of the "features" array to  */
+/*      json-c, so that only one feature at a time is held as a         */
+/*      json_object tree. The other top-level members are collected in  */
+/*      a root object, without "features".                             */
+/************************************************************************/
+
+class OGRGeoJSONStreamingParser
+{
+  public:
+    explicit OGRGeoJSONStreamingParser( bool bStoreRootMembers );
+    ~OGRGeoJSONStreamingParser();
+
+    bool Parse( const char* pabyData, size_t nLength, bool bFinished );
+
+    bool IsFeatureCollection() const;
+    json_object* StealRootObject();
+    json_object* GetNextFeature();
+
+  private:
+    enum State
+    {
+        STATE_START,
+        STATE_ROOT_EXPECT_KEY,
+        STATE_ROOT_KEY,
+        STATE_ROOT_EXPECT_COLON,
+        STATE_ROOT_EXPECT_VALUE,
+        STATE_ROOT_VALUE,
+        STATE_ROOT_EXPECT_COMMA_OR_END,
+        STATE_FEATURES_EXPECT_ELEMENT,
+        STATE_FEATURE,
+        STATE_END,
+        STATE_ERROR
+    };
+
+    bool                      bStoreRootMembers_;
+    State                     eState_;
+    CPLString                 osKey_;
+    CPLString                 osValue_;
+    int                       nValueDepth_;
+    bool                      bInString_;
+    bool                      bEscape_;
+    bool                      bAfterComma_;
+    bool                      bFoundFeatures_;
+    json_object*              poRootObj_;
+    std::vector<json_object*> apoFeatures_;
+    size_t                    iNextFeature_;
+
+    bool EndValue();
+
+    OGRGeoJSONStreamingParser( const OGRGeoJSONStreamingParser& );
+    OGRGeoJSONStreamingParser& operator=( const OGRGeoJSONStreamingParser& );
+};
+
+OGRGeoJSONStreamingParser::OGRGeoJSONStreamingParser(
+                                            bool bStoreRootMembers ) :
+    bStoreRootMembers_(bStoreRootMembers),
+    eState_(STATE_START),
+    nValueDepth_(0),
+    bInString_(false),
+    bEscape_(false),
+    bAfterComma_(false),
+    bFoundFeatures_(false),
+    poRootObj_(json_object_new_object()),
+    iNextFeature_(0)
+{}
+
+OGRGeoJSONStreamingParser::~OGRGeoJSONStreamingParser()
+{
+    json_object_put(poRootObj_);
+    for( size_t i = iNextFeature_; i < apoFeatures_.size(); i++ )
+        json_object_put(apoFeatures_[i]);
+}
+
+/************************************************************************/
+/*                         IsFeatureCollection()                        */
+/************************************************************************/
+
+bool OGRGeoJSONStreamingParser::IsFeatureCollection() const
+{
+    return eState_ == STATE_END && bFoundFeatures_ &&
+           (!bStoreRootMembers_ ||
+            OGRGeoJSONGetType(poRootObj_) ==
+                                    GeoJSONObject::eFeatureCollection);
+}
+
+/************************************************************************/
+/*                           StealRootObject()                          */
+/************************************************************************/
+
+json_object* OGRGeoJSONStreamingParser::StealRootObject()
+{
+    json_object* poRet = poRootObj_;
+    poRootObj_ = NULL;
+    return poRet;
+}
+
+/************************************************************************/
+/*                            GetNextFeature()                          */
+/*                                                                      */
+/*      Returns the next feature parsed so far, to be released by the   */
+/*      caller, or NULL if more data must be provided.                  */
+/************************************************************************/
+
+json_object* OGRGeoJSONStreamingParser::GetNextFeature()
+{
+    if( iNextFeature_ == apoFeatures_.size() )
+    {
+        apoFeatures_.clear();
+        iNextFeature_ = 0;
+        return NULL;
+    }
+    return apoFeatures_[iNextFeature_++];
+}
+
+/************************************************************************/
+/*                              EndValue()                              */
+/************************************************************************/
+
+bool OGRGeoJSONStreamingParser::EndValue()
+{
+    if( eState_ == STATE_ROOT_VALUE && !bStoreRootMembers_ )
+        return true;
+
+    json_object* poObj = NULL;
+    if( !OGRJSonParse(osValue_, &poObj, false) )
+        return false;
+    osValue_.clear();
+
+    if( eState_ == STATE_ROOT_VALUE )
+    {
+        json_object_object_add(poRootObj_, osKey_, poObj);
+    }
+    else if( poObj != NULL )
+    {
+        apoFeatures_.push_back(poObj);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                                Parse()                               */
+/*                                                                      */
+/*      Consumes the next nLength bytes of the file. Returns false if   */
+/*      the content is not a well-formed JSON object.                   */
+/************************************************************************/
+
+bool OGRGeoJSONStreamingParser::Parse( const char* pabyData, size_t nLength,
+                                       bool bFinished )
+{
+    size_t nValueStart = 0;
+    for( size_t i = 0; i < nLength && eState_ != STATE_ERROR; i++ )
+    {
+        const char ch = pabyData[i];
+        const bool bIsSpace =
+            ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+
+        switch( eState_ )
+        {
+            case STATE_START:
+                if( ch == '{' )
+                    eState_ = STATE_ROOT_EXPECT_KEY;
+                else if( !bIsSpace )
+                    eState_ = STATE_ERROR;
+                break;
+
+            case STATE_ROOT_EXPECT_KEY:
+                if( ch == '"' )
+                {
+                    osKey_.clear();
+                    bEscape_ = false;
+                    eState_ = STATE_ROOT_KEY;
+                }
+                else if( ch == '}' && !bAfterComma_ )
+                    eState_ = STATE_END;
+                else if( !bIsSpace )
+                    eState_ = STATE_ERROR;
+                break;
+
+            case STATE_ROOT_KEY:
+                if( bEscape_ )
+                    bEscape_ = false;
+                else if( ch == '\\' )
+                    bEscape_ = true;
+                else if( ch == '"' )
+                {
+                    eState_ = STATE_ROOT_EXPECT_COLON;
+                    break;
+                }
+                osKey_ += ch;
+                break;
+
+            case STATE_ROOT_EXPECT_COLON:
+                if( ch == ':' )
+                    eState_ = STATE_ROOT_EXPECT_VALUE;
+                else if( !bIsSpace )
+                    eState_ = STATE_ERROR;
+                break;
+
+            case STATE_ROOT_EXPECT_VALUE:
+                if( bIsSpace )
+                    break;
+                if( ch == '[' && EQUAL(osKey_, "features") )
+                {
+                    bFoundFeatures_ = true;
+                    bAfterComma_ = false;
+                    eState_ = STATE_FEATURES_EXPECT_ELEMENT;
+                    break;
+                }
+                eState_ = STATE_ROOT_VALUE;
+                nValueStart = i;
+                nValueDepth_ = 0;
+                bInString_ = false;
+                bEscape_ = false;
+                i--;  // Reprocess the character as part of the value.
+                break;
+
+            case STATE_FEATURES_EXPECT_ELEMENT:
+                if( bIsSpace )
+                    break;
+                if( ch == ']' && !bAfterComma_ )
+                {
+                    eState_ = STATE_ROOT_EXPECT_COMMA_OR_END;
+                    break;
+                }
+                eState_ = STATE_FEATURE;
+                nValueStart = i;
+                nValueDepth_ = 0;
+                bInString_ = false;
+                bEscape_ = false;
+                i--;  // Reprocess the character as part of the value.
+                break;
+
+            case STATE_ROOT_VALUE:
+            case STATE_FEATURE:
+            {
+                if( bInString_ )
+                {
+                    if( bEscape_ )
+                        bEscape_ = false;
+                    else if( ch == '\\' )
+                        bEscape_ = true;
+                    else if( ch == '"' )
+                        bInString_ = false;
+                    break;
+                }
+                if( ch == '"' )
+                {
+                    bInString_ = true;
+                    break;
+                }
+                if( ch == '{' || ch == '[' )
+                {
+                    nValueDepth_++;
+                    break;
+                }
+                const char chEnd = eState_ == STATE_FEATURE ? ']' : '}';
+                if( nValueDepth_ > 0 )
+                {
+                    if( ch == '}' || ch == ']' )
+                        nValueDepth_--;
+                    break;
+                }
+                if( ch != ',' && ch != chEnd )
+                {
+                    if( ch == '}' || ch == ']' )
+                        eState_ = STATE_ERROR;
+                    break;
+                }
+
+                // End of the value.
+                if( eState_ == STATE_FEATURE || bStoreRootMembers_ )
+                    osValue_.append(pabyData + nValueStart, i - nValueStart);
+                if( !EndValue() )
+                {
+                    eState_ = STATE_ERROR;
+                    break;
+                }
+                bAfterComma_ = ch == ',';
+                if( eState_ == STATE_FEATURE )
+                    eState_ = bAfterComma_ ? STATE_FEATURES_EXPECT_ELEMENT :
+                                             STATE_ROOT_EXPECT_COMMA_OR_END;
+                else
+                    eState_ = bAfterComma_ ? STATE_ROOT_EXPECT_KEY : STATE_END;
+                break;
+            }
+
+            case STATE_ROOT_EXPECT_COMMA_OR_END:
+                if( ch == ',' )
+                {
+                    bAfterComma_ = true;
+                    eState_ = STATE_ROOT_EXPECT_KEY;
+                }
+                else if( ch == '}' )
+                    eState_ = STATE_END;
+                else if( !bIsSpace )
+                    eState_ = STATE_ERROR;
+                break;
+
+            case STATE_END:
+                // Trailing content is ignored, as json-c does.
+                return true;
+
+            case STATE_ERROR:
+                break;
+        }
+    }
+
+    if( eState_ == STATE_ERROR )
+        return false;
+
+    // Save the part of the value in this chunk.
+    if( eState_ == STATE_FEATURE ||
+        (eState_ == STATE_ROOT_VALUE && bStoreRootMembers_) )
+    {
+        osValue_.append(pabyData + nValueStart, nLength - nValueStart);
+    }
+
+    return !bFinished || eState_ == STATE_END;
+}
+
 /************************************************************************/
 /*                           OGRGeoJSONReader                           */
 /************************************************************************/
@@ -52,7 +380,15 @@ OGRGeoJSONReader::OGRGeoJSONReader() :
     bFoundRev(false),
     bFoundTypeFeature(false),
     bIsGeocouchSpatiallistFormat(false),
-    bFoundFeatureId(false)
+    bFoundFeatureId(false),
+    fp_(NULL),
+    poStreamingParser_(NULL),
+    bStreamingEOF_(false),
+    nStreamingFeatureIdx_(0),
+    nStreamingReportedCount_(0),
+    bOriginalIdModified_(false),
+    nUsedFIDRangeStart_(0),
+    nUsedFIDRangeEnd_(0)
 {}
 
 /************************************************************************/
@@ -67,6 +403,10 @@ OGRGeoJSONReader::~OGRGeoJSONReader()
     }
 
     poGJObject_ = NULL;
+
+    delete poStreamingParser_;
+    if( fp_ != NULL )
+        VSIFCloseL(fp_);
 }
 
 /************************************************************************/
@@ -110,6 +450,34 @@ void OGRGeoJSONReader::ReadLayers( OGRGeoJSONDataSource* poDS )
     ReadLayer(poDS, NULL, poGJObject_);
 }
 
+/************************************************************************/
+/*                       OGRGeoJSONGetLayerName()                       */
+/************************************************************************/
+
+static const char* OGRGeoJSONGetLayerName( OGRGeoJSONDataSource* poDS,
+                                           json_object* poObj,
+                                           GeoJSONObject::Type objType )
+{
+    if( GeoJSONObject::eFeatureCollection == objType )
+    {
+        json_object* poName = CPL_json_object_object_get(poObj, "name");
+        if( poName != NULL &&
+            json_object_get_type(poName) == json_type_string )
+        {
+            return json_object_get_string(poName);
+        }
+    }
+
+    const char* pszDesc = poDS->GetDescription();
+    if( strchr(pszDesc, '?') == NULL &&
+        strchr(pszDesc, '{') == NULL )
+    {
+        return CPLGetBasename(pszDesc);
+    }
+
+    return OGRGeoJSONLayer::DefaultName;
+}
+
 /************************************************************************/
 /*                           ReadLayer                                  */
 /************************************************************************/
@@ -160,28 +528,7 @@ void OGRGeoJSONReader::ReadLayer( OGRGeoJSONDataSource* poDS,
 
     // Figure out layer name
     if( pszName == NULL )
-    {
-        if( GeoJSONObject::eFeatureCollection == objType )
-        {
-            json_object* poName = CPL_json_object_object_get(poObj, "name");
-            if( poName != NULL &&
-                json_object_get_type(poName) == json_type_string )
-            {
-                pszName = json_object_get_string(poName);
-            }
-        }
-        if( pszName == NULL )
-        {
-            const char* pszDesc = poDS->GetDescription();
-            if( strchr(pszDesc, '?') == NULL &&
-                strchr(pszDesc, '{') == NULL )
-            {
-                pszName = CPLGetBasename(pszDesc);
-            }
-        }
-        if( pszName == NULL )
-            pszName = OGRGeoJSONLayer::DefaultName;
-    }
+        pszName = OGRGeoJSONGetLayerName( poDS, poObj, objType );
 
     OGRGeoJSONLayer* poLayer =
       new OGRGeoJSONLayer( pszName, poSRS,
@@ -489,6 +836,17 @@ bool OGRGeoJSONReader::GenerateLayerDefn( OGRGeoJSONLayer* poLayer,
         }
     }
 
+    FinalizeLayerDefn( poLayer );
+
+    return bSuccess;
+}
+
+/************************************************************************/
+/*                         FinalizeLayerDefn()                          */
+/************************************************************************/
+
+void OGRGeoJSONReader::FinalizeLayerDefn( OGRGeoJSONLayer* poLayer )
+{
 /* -------------------------------------------------------------------- */
 /*      Validate and add FID column if necessary.                       */
 /* -------------------------------------------------------------------- */
@@ -509,8 +867,6 @@ bool OGRGeoJSONReader::GenerateLayerDefn( OGRGeoJSONLayer* poLayer,
             }
         }
     }
-
-    return bSuccess;
 }
 
 /************************************************************************/
@@ -1251,47 +1607,371 @@ OGRGeoJSONReader::ReadFeatureCollection( OGRGeoJSONLayer* poLayer,
         }
     }
 
-    // Collect top objects except 'type' and the 'features' array.
     if( bStoreNativeData_ )
+        StoreLayerNativeData( poLayer, poObj );
+}
+
+/************************************************************************/
+/*                        StoreLayerNativeData()                        */
+/************************************************************************/
+
+void OGRGeoJSONReader::StoreLayerNativeData( OGRGeoJSONLayer* poLayer,
+                                             json_object* poObj )
+{
+    // Collect top objects except 'type' and the 'features' array.
+    json_object_iter it;
+    it.key = NULL;
+    it.val = NULL;
+    it.entry = NULL;
+    CPLString osNativeData;
+    json_object_object_foreachC(poObj, it)
     {
-        json_object_iter it;
-        it.key = NULL;
-        it.val = NULL;
-        it.entry = NULL;
-        CPLString osNativeData;
-        json_object_object_foreachC(poObj, it)
+        if( strcmp(it.key, "type") == 0 ||
+            strcmp(it.key, "features") == 0 )
         {
-            if( strcmp(it.key, "type") == 0 ||
-                strcmp(it.key, "features") == 0 )
+            continue;
+        }
+        if( osNativeData.empty() )
+            osNativeData = "{ ";
+        else
+            osNativeData += ", ";
+        json_object* poKey = json_object_new_string(it.key);
+        osNativeData += json_object_to_json_string(poKey);
+        json_object_put(poKey);
+        osNativeData += ": ";
+        osNativeData += json_object_to_json_string(it.val);
+    }
+    if( osNativeData.empty() )
+    {
+        osNativeData = "{ ";
+    }
+    osNativeData += " }";
+
+    osNativeData = "NATIVE_DATA=" + osNativeData;
+
+    char *apszMetadata[3] = {
+        const_cast<char *>(osNativeData.c_str()),
+        const_cast<char *>("NATIVE_MEDIA_TYPE=application/vnd.geo+json"),
+        NULL
+    };
+
+    poLayer->SetMetadata( apszMetadata, "NATIVE_DATA" );
+}
+
+/************************************************************************/
+/*                         FirstPassReadLayer()                         */
+/*                                                                      */
+/*      Scans a FeatureCollection from fp to establish the layer        */
+/*      schema, geometry type and feature count, without keeping the    */
+/*      features in memory. On success, the layer created takes        */
+/*      ownership of this reader and of fp, and will read its features  */
+/*      from the file. Returns false if the content cannot be read in   */
+/*      streaming mode (not a FeatureCollection, invalid JSON, ...).    */
+/************************************************************************/
+
+bool OGRGeoJSONReader::FirstPassReadLayer( OGRGeoJSONDataSource* poDS,
+                                           VSILFILE* fp )
+{
+    if( VSIFSeekL(fp, 0, SEEK_SET) != 0 )
+        return false;
+
+    // Collects the schema, before the layer name and SRS are known.
+    OGRGeoJSONLayer* poSchemaLayer =
+        new OGRGeoJSONLayer( OGRGeoJSONLayer::DefaultName, NULL,
+                             OGRGeoJSONLayer::DefaultGeometryType, poDS );
+
+    OGRGeoJSONStreamingParser oParser(true);
+    abyBuffer_.resize(STREAMING_BUFFER_SIZE);
+    bool bFirstBlock = true;
+    bool bOK = true;
+    GIntBig nFeatureCount = 0;
+    bool bFID64 = false;
+    bool bFirstGeometry = true;
+    bool bMixedGeometryTypes = false;
+    OGRwkbGeometryType eLayerGeomType = OGRGeoJSONLayer::DefaultGeometryType;
+    while( bOK )
+    {
+        const size_t nRead = VSIFReadL(&abyBuffer_[0], 1, abyBuffer_.size(),
+                                       fp);
+        const bool bFinished = nRead < abyBuffer_.size();
+        size_t nSkip = 0;
+        if( bFirstBlock )
+        {
+            // Skip UTF-8 BOM (#5630).
+            if( nRead >= 3 && memcmp(&abyBuffer_[0], "\xEF\xBB\xBF", 3) == 0 )
+                nSkip = 3;
+            bFirstBlock = false;
+        }
+        bOK = oParser.Parse(&abyBuffer_[nSkip], nRead - nSkip, bFinished);
+
+        json_object* poObj = NULL;
+        while( (poObj = oParser.GetNextFeature()) != NULL )
+        {
+            nFeatureCount++;
+
+            if( !bAttributesSkip_ &&
+                !GenerateFeatureDefn( poSchemaLayer, poObj ) )
             {
-                continue;
+                CPLDebug( "GeoJSON", "Create feature schema failure." );
             }
-            if( osNativeData.empty() )
-                osNativeData = "{ ";
-            else
-                osNativeData += ", ";
-            json_object* poKey = json_object_new_string(it.key);
-            osNativeData += json_object_to_json_string(poKey);
-            json_object_put(poKey);
-            osNativeData += ": ";
-            osNativeData += json_object_to_json_string(it.val);
+
+            json_object* poObjId = OGRGeoJSONFindMemberByName(poObj, "id");
+            if( poObjId == NULL )
+            {
+                json_object* poObjProps =
+                    OGRGeoJSONFindMemberByName(poObj, "properties");
+                if( poObjProps != NULL &&
+                    json_object_get_type(poObjProps) == json_type_object )
+                {
+                    poObjId = CPL_json_object_object_get(poObjProps, "id");
+                }
+            }
+            if( poObjId != NULL &&
+                json_object_get_type(poObjId) == json_type_int &&
+                !CPL_INT64_FITS_ON_INT32(json_object_get_int64(poObjId)) )
+            {
+                bFID64 = true;
+            }
+
+            // Same logic as OGRGeoJSONLayer::DetectGeometryType().
+            json_object* poObjGeom =
+                OGRGeoJSONFindMemberByName(poObj, "geometry");
+            if( !bMixedGeometryTypes && poObjGeom != NULL )
+            {
+                // Errors on invalid geometries are reported when the
+                // features are actually read.
+                CPLPushErrorHandler(CPLQuietErrorHandler);
+                OGRGeometry* poGeometry = ReadGeometry( poObjGeom );
+                CPLPopErrorHandler();
+                if( poGeometry != NULL )
+                {
+                    const OGRwkbGeometryType eGeomType =
+                        poGeometry->getGeometryType();
+                    if( bFirstGeometry )
+                    {
+                        eLayerGeomType = eGeomType;
+                        bFirstGeometry = false;
+                    }
+                    else if( eGeomType != eLayerGeomType )
+                    {
+                        CPLDebug( "GeoJSON",
+                            "Detected layer of mixed-geometry type features." );
+                        eLayerGeomType = OGRGeoJSONLayer::DefaultGeometryType;
+                        bMixedGeometryTypes = true;
+                    }
+                    delete poGeometry;
+                }
+            }
+
+            json_object_put(poObj);
         }
-        if( osNativeData.empty() )
+
+        if( bFinished )
+            break;
+    }
+
+    if( !bOK || !oParser.IsFeatureCollection() )
+    {
+        delete poSchemaLayer;
+        return false;
+    }
+
+    if( poGJObject_ != NULL )
+        json_object_put(poGJObject_);
+    poGJObject_ = oParser.StealRootObject();
+
+/* -------------------------------------------------------------------- */
+/*      Create the layer, as ReadLayer() does.                          */
+/* -------------------------------------------------------------------- */
+    OGRSpatialReference* poSRS = OGRGeoJSONReadSpatialReference( poGJObject_ );
+    if( poSRS == NULL )
+    {
+        // If there is none defined, we use 4326.
+        poSRS = new OGRSpatialReference();
+        if( OGRERR_NONE != poSRS->importFromEPSG( 4326 ) )
         {
-            osNativeData = "{ ";
+            delete poSRS;
+            poSRS = NULL;
         }
-        osNativeData += " }";
+    }
+
+    OGRGeoJSONLayer* poLayer =
+        new OGRGeoJSONLayer( OGRGeoJSONGetLayerName(poDS, poGJObject_,
+                                                    GeoJSONObject::
+                                                        eFeatureCollection),
+                             poSRS, eLayerGeomType, poDS );
+    if( poSRS != NULL )
+        poSRS->Release();
+
+    OGRFeatureDefn* poSchemaDefn = poSchemaLayer->GetLayerDefn();
+    for( int i = 0; i < poSchemaDefn->GetFieldCount(); i++ )
+        poLayer->GetLayerDefn()->AddFieldDefn(poSchemaDefn->GetFieldDefn(i));
+    delete poSchemaLayer;
+
+    if( !bAttributesSkip_ )
+        FinalizeLayerDefn( poLayer );
+
+    json_object* poDescription =
+        CPL_json_object_object_get(poGJObject_, "description");
+    if( poDescription != NULL &&
+        json_object_get_type(poDescription) == json_type_string )
+    {
+        poLayer->SetMetadataItem("DESCRIPTION",
+                                 json_object_get_string(poDescription));
+    }
+
+    if( bStoreNativeData_ )
+        StoreLayerNativeData( poLayer, poGJObject_ );
+
+    if( bFID64 || !CPL_INT64_FITS_ON_INT32(nFeatureCount) )
+        poLayer->SetMetadataItem(OLMD_FID64, "YES");
 
-        osNativeData = "NATIVE_DATA=" + osNativeData;
+    fp_ = fp;
+    poLayer->SetStreamingReader( this, nFeatureCount );
+    poDS->AddLayer( poLayer );
 
-        char *apszMetadata[3] = {
-            const_cast<char *>(osNativeData.c_str()),
-            const_cast<char *>("NATIVE_MEDIA_TYPE=application/vnd.geo+json"),
-            NULL
-        };
+    return true;
+}
+
+/************************************************************************/
+/*                            ResetReading()                            */
+/************************************************************************/
 
-        poLayer->SetMetadata( apszMetadata, "NATIVE_DATA" );
+void OGRGeoJSONReader::ResetReading()
+{
+    CPLAssert( fp_ != NULL );
+
+    delete poStreamingParser_;
+    poStreamingParser_ = NULL;
+    bStreamingEOF_ = false;
+    nStreamingFeatureIdx_ = 0;
+    nUsedFIDRangeStart_ = 0;
+    nUsedFIDRangeEnd_ = 0;
+    oSetOtherUsedFIDs_.clear();
+}
+
+/************************************************************************/
+/*                              IsFIDUsed()                             */
+/************************************************************************/
+
+bool OGRGeoJSONReader::IsFIDUsed( GIntBig nFID ) const
+{
+    return (nFID >= nUsedFIDRangeStart_ && nFID < nUsedFIDRangeEnd_) ||
+           oSetOtherUsedFIDs_.find(nFID) != oSetOtherUsedFIDs_.end();
+}
+
+/************************************************************************/
+/*                             SetFIDUsed()                             */
+/************************************************************************/
+
+void OGRGeoJSONReader::SetFIDUsed( GIntBig nFID )
+{
+    if( nUsedFIDRangeStart_ == nUsedFIDRangeEnd_ )
+    {
+        nUsedFIDRangeStart_ = nFID;
+        nUsedFIDRangeEnd_ = nFID + 1;
     }
+    else if( nFID == nUsedFIDRangeEnd_ )
+    {
+        nUsedFIDRangeEnd_++;
+        // Merge the FIDs that follow the range.
+        std::set<GIntBig>::iterator oIter;
+        while( (oIter = oSetOtherUsedFIDs_.find(nUsedFIDRangeEnd_)) !=
+                                                    oSetOtherUsedFIDs_.end() )
+        {
+            oSetOtherUsedFIDs_.erase(oIter);
+            nUsedFIDRangeEnd_++;
+        }
+    }
+    else
+    {
+        oSetOtherUsedFIDs_.insert(nFID);
+    }
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/*                                                                      */
+/*      Reads the next feature from the file, in streaming mode. FIDs   */
+/*      are assigned the same way as OGRGeoJSONLayer::AddFeature()      */
+/*      does.                                                           */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONReader::GetNextFeature( OGRGeoJSONLayer* poLayer )
+{
+    CPLAssert( fp_ != NULL );
+
+    if( poStreamingParser_ == NULL )
+    {
+        if( VSIFSeekL(fp_, 0, SEEK_SET) != 0 )
+            return NULL;
+        poStreamingParser_ = new OGRGeoJSONStreamingParser(false);
+        bStreamingEOF_ = false;
+        // Skip UTF-8 BOM (#5630).
+        GByte abyBOM[3] = { 0, 0, 0 };
+        if( VSIFReadL(abyBOM, 1, 3, fp_) != 3 ||
+            memcmp(abyBOM, "\xEF\xBB\xBF", 3) != 0 )
+        {
+            VSIFSeekL(fp_, 0, SEEK_SET);
+        }
+    }
+
+    json_object* poObj = NULL;
+    while( (poObj = poStreamingParser_->GetNextFeature()) == NULL )
+    {
+        if( bStreamingEOF_ )
+            return NULL;
+        const size_t nRead = VSIFReadL(&abyBuffer_[0], 1, abyBuffer_.size(),
+                                       fp_);
+        bStreamingEOF_ = nRead < abyBuffer_.size();
+        if( !poStreamingParser_->Parse(&abyBuffer_[0], nRead,
+                                       bStreamingEOF_) )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "GeoJSON parsing error in %s",
+                      poLayer->GetName() );
+            bStreamingEOF_ = true;
+        }
+    }
+
+    // As in the in-memory mode, errors on a feature, such as an invalid
+    // geometry, are only reported the first time it is read.
+    const bool bQuiet = nStreamingFeatureIdx_ < nStreamingReportedCount_;
+    if( bQuiet )
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+    OGRFeature* poFeature = ReadFeature( poLayer, poObj );
+    if( bQuiet )
+        CPLPopErrorHandler();
+    json_object_put(poObj);
+
+    GIntBig nFID = poFeature->GetFID();
+    if( nFID >= 0 && IsFIDUsed(nFID) )
+    {
+        if( !bOriginalIdModified_ )
+        {
+            CPLError(
+                CE_Warning, CPLE_AppDefined,
+                "Several features with id = " CPL_FRMT_GIB " have been "
+                "found. Altering it to be unique. This warning will not "
+                "be emitted for this layer",
+                nFID );
+            bOriginalIdModified_ = true;
+        }
+        nFID = -1;
+    }
+    if( nFID < 0 )
+    {
+        nFID = nStreamingFeatureIdx_;
+        while( IsFIDUsed(nFID) )
+            nFID++;
+    }
+    SetFIDUsed(nFID);
+    poFeature->SetFID(nFID);
+    nStreamingFeatureIdx_++;
+    if( nStreamingFeatureIdx_ > nStreamingReportedCount_ )
+        nStreamingReportedCount_ = nStreamingFeatureIdx_;
+
+    return poFeature;
 }
 
 /************************************************************************/
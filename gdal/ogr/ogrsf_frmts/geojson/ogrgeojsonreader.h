@@ -37,6 +37,7 @@
 #include "ogr_json_header.h"
 
 #include <set>
+#include <vector>
 
 /************************************************************************/
 /*                         FORWARD DECLARATIONS                         */
@@ -55,6 +56,7 @@ class OGRGeometryCollection;
 class OGRFeature;
 class OGRGeoJSONLayer;
 class OGRSpatialReference;
+class OGRGeoJSONStreamingParser;
 
 /************************************************************************/
 /*                           GeoJSONObject                              */
@@ -107,6 +109,10 @@ class OGRGeoJSONReader
                     const char* pszName,
                     json_object* poObj );
 
+    bool FirstPassReadLayer( OGRGeoJSONDataSource* poDS, VSILFILE* fp );
+    void ResetReading();
+    OGRFeature* GetNextFeature( OGRGeoJSONLayer* poLayer );
+
     json_object* GetJSonObject() { return poGJObject_; }
 
   private:
@@ -129,6 +135,22 @@ class OGRGeoJSONReader
     bool bIsGeocouchSpatiallistFormat;
     bool bFoundFeatureId;
 
+    // Streaming mode.
+    VSILFILE* fp_;
+    OGRGeoJSONStreamingParser* poStreamingParser_;
+    std::vector<char> abyBuffer_;
+    bool bStreamingEOF_;
+    GIntBig nStreamingFeatureIdx_;
+    // Number of features whose errors have already been reported, so
+    // that they are not reported again on the next passes.
+    GIntBig nStreamingReportedCount_;
+    bool bOriginalIdModified_;
+    // FIDs already returned since the last ResetReading(): a range, that
+    // is enough for most files, plus the ones outside of it.
+    GIntBig nUsedFIDRangeStart_;
+    GIntBig nUsedFIDRangeEnd_;
+    std::set<GIntBig> oSetOtherUsedFIDs_;
+
     //
     // Copy operations not supported.
     //
@@ -140,12 +162,17 @@ class OGRGeoJSONReader
     //
     bool GenerateLayerDefn( OGRGeoJSONLayer* poLayer, json_object* poGJObject );
     bool GenerateFeatureDefn( OGRGeoJSONLayer* poLayer, json_object* poObj );
+    void FinalizeLayerDefn( OGRGeoJSONLayer* poLayer );
+    void StoreLayerNativeData( OGRGeoJSONLayer* poLayer, json_object* poObj );
     static bool AddFeature( OGRGeoJSONLayer* poLayer, OGRGeometry* poGeometry );
     static bool AddFeature( OGRGeoJSONLayer* poLayer, OGRFeature* poFeature );
 
     OGRGeometry* ReadGeometry( json_object* poObj );
     OGRFeature* ReadFeature( OGRGeoJSONLayer* poLayer, json_object* poObj );
     void ReadFeatureCollection( OGRGeoJSONLayer* poLayer, json_object* poObj );
+
+    bool IsFIDUsed( GIntBig nFID ) const;
+    void SetFIDUsed( GIntBig nFID );
 };
 
 void OGRGeoJSONReaderSetField( OGRLayer* poLayer,
@@ -267,6 +267,7 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
 
     sqlite3_stmt        *m_poQueryStatement;
     bool                 bDoStep;
+    bool                 m_bBatchEOF;
 
     char                *m_pszFidColumn;
 
@@ -281,6 +282,8 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
                                            sqlite3_stmt *hStmt );
 
     OGRFeature*         TranslateFeature(sqlite3_stmt* hStmt);
+    void                TranslateFeatureToBatch(sqlite3_stmt* hStmt,
+                                                OGRFeatureBatch* poBatch);
 
   public:
 
@@ -290,6 +293,8 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
     /* OGR API methods */
 
     OGRFeature*         GetNextFeature() override;
+    int                 GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures ) override;
     const char*         GetFIDColumn() override;
     void                ResetReading() override;
     int                 TestCapability( const char * ) override;
@@ -300,6 +305,21 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
                                          OGRGeometry* /*poFilterGeom*/) override { return ""; }
 };
 
+/************************************************************************/
+/*                        GPKGRTreeEntry                                */
+/************************************************************************/
+
+// Bounding box of a feature inserted while the creation of the spatial index
+// is deferred.
+typedef struct
+{
+    GIntBig     nId;
+    double      dfMinX;
+    double      dfMaxX;
+    double      dfMinY;
+    double      dfMaxY;
+} GPKGRTreeEntry;
+
 /************************************************************************/
 /*                        OGRGeoPackageTableLayer                       */
 /************************************************************************/
@@ -318,6 +338,11 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
     bool                        m_bInsertStatementWithFID;
     sqlite3_stmt*               m_poInsertStatement;
     bool                        m_bDeferredSpatialIndexCreation;
+    // Bounding boxes of the features created while the spatial index
+    // creation is deferred, used to bulk load it. Only valid as long as
+    // features have only been appended to a new table.
+    bool                        m_bRTreeEntriesValid;
+    std::vector<GPKGRTreeEntry> m_aoRTreeEntries;
     // m_bHasSpatialIndex cannot be bool.  -1 is unset.
     int                         m_bHasSpatialIndex;
     bool                        m_bDropRTreeTable;
@@ -343,6 +368,10 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
                                       const CPLString& osFieldListForSelect);
     bool                IsTable();
 
+    void                InvalidateRTreeEntries();
+    OGRErr              PopulateRTreeFromEntries(const char* pszT,
+                                                 const char* pszC);
+
     public:
                         OGRGeoPackageTableLayer( GDALGeoPackageDataset *poDS,
                                             const char * pszTableName );
@@ -369,6 +398,8 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
     OGRErr              SetAttributeFilter( const char *pszQuery ) override;
     OGRErr              SyncToDisk() override;
     OGRFeature*         GetNextFeature() override;
+    int                 GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures ) override;
     OGRFeature*         GetFeature(GIntBig nFID) override;
     OGRErr              StartTransaction() override;
     OGRErr              CommitTransaction() override;
@@ -388,7 +419,8 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
                                                const char* pszIdentifier,
                                                const char* pszDescription );
     void                SetDeferredSpatialIndexCreation( bool bFlag )
-                                { m_bDeferredSpatialIndexCreation = bFlag; }
+                                { m_bDeferredSpatialIndexCreation = bFlag;
+                                  m_bRTreeEntriesValid = bFlag; }
     void                SetASpatialVariant( GPKGASpatialVariant eASPatialVariant )
                                 { m_eASPatialVariant = eASPatialVariant; }
 
@@ -460,6 +492,10 @@ class OGRGeoPackageSelectLayer CPL_FINAL : public OGRGeoPackageLayer, public IOG
     virtual void        ResetReading() override;
 
     virtual OGRFeature *GetNextFeature() override;
+    // GetNextFeature() goes through the SQL select behaviour.
+    virtual int         GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures ) override
+                { return OGRLayer::GetNextFeatureBatch(poBatch, nMaxFeatures); }
     virtual GIntBig     GetFeatureCount( int ) override;
 
     virtual void        SetSpatialFilter( OGRGeometry * poGeom ) override { SetSpatialFilter(0, poGeom); }
@@ -43,6 +43,7 @@ OGRGeoPackageLayer::OGRGeoPackageLayer(GDALGeoPackageDataset *poDS) :
     iNextShapeId(0),
     m_poQueryStatement(NULL),
     bDoStep(true),
+    m_bBatchEOF(false),
     m_pszFidColumn(NULL),
     iFIDCol(-1),
     iGeomCol(-1),
@@ -76,6 +77,7 @@ void OGRGeoPackageLayer::ResetReading()
 {
     ClearStatement();
     iNextShapeId = 0;
+    m_bBatchEOF = false;
 }
 
 /************************************************************************/
@@ -273,6 +275,216 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
     return poFeature;
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRGeoPackageLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures )
+
+{
+    // Filters evaluated on the OGR side need OGRFeature objects.
+    if( m_poFilterGeom != NULL || m_poAttrQuery != NULL )
+        return OGRLayer::GetNextFeatureBatch( poBatch, nMaxFeatures );
+
+    poBatch->Reset( m_poFeatureDefn );
+
+    // The end of the layer was reached by the previous batch: report it
+    // with an empty batch, as GetNextFeature() returns NULL, instead of
+    // restarting from the first feature.
+    if( m_bBatchEOF )
+    {
+        m_bBatchEOF = false;
+        return 0;
+    }
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        if( m_poQueryStatement == NULL )
+        {
+            ResetStatement();
+            if (m_poQueryStatement == NULL)
+                break;
+        }
+
+        if( bDoStep )
+        {
+            int rc = sqlite3_step( m_poQueryStatement );
+            if( rc != SQLITE_ROW )
+            {
+                if ( rc != SQLITE_DONE )
+                {
+                    sqlite3_reset(m_poQueryStatement);
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                            "In GetNextFeatureBatch(): sqlite3_step() : %s",
+                            sqlite3_errmsg(m_poDS->GetDB()) );
+                }
+
+                ClearStatement();
+                m_bBatchEOF = poBatch->GetFeatureCount() > 0;
+                break;
+            }
+        }
+        else
+        {
+            bDoStep = true;
+        }
+
+        TranslateFeatureToBatch( m_poQueryStatement, poBatch );
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
+/************************************************************************/
+/*                      TranslateFeatureToBatch()                       */
+/*                                                                      */
+/*      Same as TranslateFeature(), but append the current result       */
+/*      directly to a feature batch.                                    */
+/************************************************************************/
+
+void OGRGeoPackageLayer::TranslateFeatureToBatch( sqlite3_stmt* hStmt,
+                                                  OGRFeatureBatch* poBatch )
+
+{
+    poBatch->AppendFeature( iFIDCol >= 0 ?
+                            sqlite3_column_int64( hStmt, iFIDCol ) :
+                            iNextShapeId );
+
+    iNextShapeId++;
+
+    m_nFeaturesRead++;
+
+/* -------------------------------------------------------------------- */
+/*      Process Geometry if we have a column.                           */
+/* -------------------------------------------------------------------- */
+    if( iGeomCol >= 0 &&
+        sqlite3_column_type(hStmt, iGeomCol) != SQLITE_NULL &&
+        !m_poFeatureDefn->GetGeomFieldDefn(0)->IsIgnored() )
+    {
+        const int iGpkgSize = sqlite3_column_bytes(hStmt, iGeomCol);
+        // coverity[tainted_data_return]
+        const GByte *pabyGpkg =
+            static_cast<const GByte*>(sqlite3_column_blob(hStmt, iGeomCol));
+
+        // Little endian ISO WKB can be copied without being parsed.
+        GPkgHeader oHeader;
+        bool bCopied = false;
+        if( GPkgHeaderFromWKB(pabyGpkg, iGpkgSize, &oHeader) == OGRERR_NONE &&
+            !oHeader.bExtended &&
+            static_cast<size_t>(iGpkgSize) >= oHeader.szHeader + 5 &&
+            pabyGpkg[oHeader.szHeader] == wkbNDR )
+        {
+            GUInt32 nGeomType = 0;
+            memcpy(&nGeomType, pabyGpkg + oHeader.szHeader + 1, 4);
+            CPL_LSBPTR32(&nGeomType);
+            if( nGeomType / 1000 <= 3 && nGeomType % 1000 >= wkbPoint &&
+                nGeomType % 1000 <= wkbTriangle )
+            {
+                poBatch->SetGeomFieldWkb( 0, pabyGpkg + oHeader.szHeader,
+                                          iGpkgSize - oHeader.szHeader );
+                bCopied = true;
+            }
+        }
+
+        if( !bCopied )
+        {
+            OGRGeometry *poGeom =
+                GPkgGeometryToOGR(pabyGpkg, iGpkgSize, NULL);
+            if ( ! poGeom )
+            {
+                // Try also spatialite geometry blobs
+                if( OGRSQLiteLayer::ImportSpatiaLiteGeometry( pabyGpkg, iGpkgSize,
+                                                              &poGeom ) != OGRERR_NONE )
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined, "Unable to read geometry");
+                }
+            }
+            poBatch->SetGeomField( 0, poGeom );
+            delete poGeom;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      set the fields.                                                 */
+/* -------------------------------------------------------------------- */
+    for( int iField = 0; iField < m_poFeatureDefn->GetFieldCount(); iField++ )
+    {
+        OGRFieldDefn *poFieldDefn = m_poFeatureDefn->GetFieldDefn( iField );
+        if ( poFieldDefn->IsIgnored() )
+            continue;
+
+        const int iRawField = panFieldOrdinals[iField];
+
+        if( sqlite3_column_type( hStmt, iRawField ) == SQLITE_NULL )
+            continue;
+
+        switch( poFieldDefn->GetType() )
+        {
+            case OFTInteger:
+                poBatch->SetFieldInteger( iField,
+                    sqlite3_column_int( hStmt, iRawField ) );
+                break;
+
+            case OFTInteger64:
+                poBatch->SetFieldInteger64( iField,
+                    sqlite3_column_int64( hStmt, iRawField ) );
+                break;
+
+            case OFTReal:
+                poBatch->SetFieldDouble( iField,
+                    sqlite3_column_double( hStmt, iRawField ) );
+                break;
+
+            case OFTBinary:
+            {
+                const int nBytes = sqlite3_column_bytes( hStmt, iRawField );
+                // coverity[tainted_data_return]
+                const GByte* pabyData = reinterpret_cast<const GByte*>(
+                    sqlite3_column_blob( hStmt, iRawField ) );
+                poBatch->SetFieldBinary( iField, pabyData, nBytes );
+                break;
+            }
+
+            case OFTDate:
+            {
+                const char* pszTxt = (const char*)sqlite3_column_text( hStmt, iRawField );
+                int nYear, nMonth, nDay;
+                if( sscanf(pszTxt, "%d-%d-%d", &nYear, &nMonth, &nDay) == 3 )
+                {
+                    OGRField sField;
+                    memset(&sField, 0, sizeof(sField));
+                    sField.Date.Year = static_cast<GInt16>(nYear);
+                    sField.Date.Month = static_cast<GByte>(nMonth);
+                    sField.Date.Day = static_cast<GByte>(nDay);
+                    poBatch->SetFieldRaw( iField, &sField );
+                }
+                break;
+            }
+
+            case OFTDateTime:
+            {
+                const char* pszTxt = (const char*)sqlite3_column_text( hStmt, iRawField );
+                OGRField sField;
+                if( OGRParseXMLDateTime(pszTxt, &sField) )
+                    poBatch->SetFieldRaw( iField, &sField );
+                break;
+            }
+
+            case OFTString:
+            {
+                const char* pszTxt = (const char *) sqlite3_column_text( hStmt, iRawField );
+                poBatch->SetFieldString( iField, pszTxt,
+                    sqlite3_column_bytes( hStmt, iRawField ) );
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+}
+
 /************************************************************************/
 /*                      GetFIDColumn()                                  */
 /************************************************************************/
@@ -32,6 +32,9 @@
 #include "cpl_time.h"
 #include "ogr_p.h"
 
+#include <algorithm>
+#include <utility>
+
 CPL_CVSID("$Id$");
 
 static const char UNSUPPORTED_OP_READ_ONLY[] =
@@ -926,6 +929,7 @@ OGRGeoPackageTableLayer::OGRGeoPackageTableLayer(
     m_bInsertStatementWithFID(false),
     m_poInsertStatement(NULL),
     m_bDeferredSpatialIndexCreation(false),
+    m_bRTreeEntriesValid(false),
     m_bHasSpatialIndex(-1),
     m_bDropRTreeTable(false),
     m_bPreservePrecision(true),
@@ -1295,9 +1299,11 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
     }
 
     /* Update the layer extents with this new object */
+    OGREnvelope oEnv;
+    const bool bHasGeom = IsGeomFieldSet(poFeature) &&
+                          !poFeature->GetGeomFieldRef(0)->IsEmpty();
     if( IsGeomFieldSet(poFeature) )
     {
-        OGREnvelope oEnv;
         poFeature->GetGeomFieldRef(0)->getEnvelope(&oEnv);
         UpdateExtent(&oEnv);
     }
@@ -1306,6 +1312,33 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
     GIntBig nFID = sqlite3_last_insert_rowid(m_poDS->GetDB());
     if( nFID )
     {
+        /* Remember the bounding box for the bulk load of the spatial index */
+        if( bHasGeom && m_bDeferredSpatialIndexCreation &&
+            m_bRTreeEntriesValid )
+        {
+            // Each entry is about 40 bytes: give up on the bulk load
+            // rather than using more than a quarter of the RAM.
+            const GIntBig nMaxEntries = CPLGetUsablePhysicalRAM() / 4 /
+                                        static_cast<GIntBig>(sizeof(GPKGRTreeEntry));
+            if( nMaxEntries > 0 &&
+                static_cast<GIntBig>(m_aoRTreeEntries.size()) >= nMaxEntries )
+            {
+                CPLDebug("GPKG", "Too many features to bulk load the "
+                         "spatial index of %s in memory", m_pszTableName);
+                InvalidateRTreeEntries();
+            }
+            else
+            {
+                GPKGRTreeEntry sEntry;
+                sEntry.nId = nFID;
+                sEntry.dfMinX = oEnv.MinX;
+                sEntry.dfMaxX = oEnv.MaxX;
+                sEntry.dfMinY = oEnv.MinY;
+                sEntry.dfMaxY = oEnv.MaxY;
+                m_aoRTreeEntries.push_back(sEntry);
+            }
+        }
+
         poFeature->SetFID(nFID);
         if( m_iFIDAsRegularColumnIndex >= 0 )
             poFeature->SetField( m_iFIDAsRegularColumnIndex, nFID );
@@ -1358,6 +1391,9 @@ OGRErr OGRGeoPackageTableLayer::ISetFeature( OGRFeature *poFeature )
     if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
         return OGRERR_FAILURE;
 
+    /* The recorded bounding boxes might no longer match the table */
+    InvalidateRTreeEntries();
+
     /* Old version of SQLite have issues with some of the spatial index triggers */
 #if SQLITE_VERSION_NUMBER < 3007008
     if( HasSpatialIndex() )
@@ -1560,6 +1596,26 @@ OGRFeature* OGRGeoPackageTableLayer::GetNextFeature()
     return poFeature;
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRGeoPackageTableLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                                  int nMaxFeatures )
+{
+    if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
+    {
+        poBatch->Reset( m_poFeatureDefn );
+        return 0;
+    }
+
+    CreateSpatialIndexIfNecessary();
+
+    // The column of m_iFIDAsRegularColumnIndex is the FID column, so
+    // the batch gets its values without further processing.
+    return OGRGeoPackageLayer::GetNextFeatureBatch( poBatch, nMaxFeatures );
+}
+
 /************************************************************************/
 /*                        GetFeature()                                  */
 /************************************************************************/
@@ -1640,6 +1696,9 @@ OGRErr OGRGeoPackageTableLayer::DeleteFeature(GIntBig nFID)
     if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
         return OGRERR_FAILURE;
 
+    /* The recorded bounding boxes might no longer match the table */
+    InvalidateRTreeEntries();
+
     /* Clear out any existing query */
     ResetReading();
 
@@ -1853,6 +1912,131 @@ void OGRGeoPackageTableLayer::CreateSpatialIndexIfNecessary()
     }
 }
 
+/************************************************************************/
+/*                       InvalidateRTreeEntries()                       */
+/************************************************************************/
+
+void OGRGeoPackageTableLayer::InvalidateRTreeEntries()
+{
+    m_bRTreeEntriesValid = false;
+    std::vector<GPKGRTreeEntry>().swap(m_aoRTreeEntries);
+}
+
+/************************************************************************/
+/*                           GPKGHilbertCode()                          */
+/************************************************************************/
+
+/* Position of (nX, nY) along a Hilbert curve filling a 65536x65536 grid */
+static GUIntBig GPKGHilbertCode( GUInt32 nX, GUInt32 nY )
+{
+    const GUInt32 nN = 65536;
+    GUIntBig nCode = 0;
+    for( GUInt32 nS = nN / 2; nS > 0; nS /= 2 )
+    {
+        const GUInt32 nRX = (nX & nS) ? 1 : 0;
+        const GUInt32 nRY = (nY & nS) ? 1 : 0;
+        nCode += static_cast<GUIntBig>(nS) * nS * ((3 * nRX) ^ nRY);
+        if( nRY == 0 )
+        {
+            if( nRX == 1 )
+            {
+                nX = nN - 1 - nX;
+                nY = nN - 1 - nY;
+            }
+            const GUInt32 nTmp = nX;
+            nX = nY;
+            nY = nTmp;
+        }
+    }
+    return nCode;
+}
+
+/************************************************************************/
+/*                      PopulateRTreeFromEntries()                      */
+/************************************************************************/
+
+/* Bulk load the RTree from the bounding boxes recorded by ICreateFeature(), */
+/* which avoids parsing back every geometry of the table. Inserting them in */
+/* Hilbert order of their centers makes the insertions hit the same nodes */
+/* and results in a better packed tree. */
+OGRErr OGRGeoPackageTableLayer::PopulateRTreeFromEntries(const char* pszT,
+                                                         const char* pszC)
+{
+    const size_t nEntries = m_aoRTreeEntries.size();
+    if( nEntries == 0 )
+        return OGRERR_NONE;
+
+    CPLDebug("GPKG", "Bulk loading " CPL_FRMT_GUIB " entries in the spatial "
+             "index of %s", static_cast<GUIntBig>(nEntries), pszT);
+
+    OGREnvelope sExtent;
+    for( size_t i = 0; i < nEntries; i++ )
+    {
+        const GPKGRTreeEntry& sEntry = m_aoRTreeEntries[i];
+        sExtent.Merge(sEntry.dfMinX, sEntry.dfMinY);
+        sExtent.Merge(sEntry.dfMaxX, sEntry.dfMaxY);
+    }
+    const double dfScaleX = (sExtent.MaxX > sExtent.MinX) ?
+                        65535.0 / (sExtent.MaxX - sExtent.MinX) : 0.0;
+    const double dfScaleY = (sExtent.MaxY > sExtent.MinY) ?
+                        65535.0 / (sExtent.MaxY - sExtent.MinY) : 0.0;
+
+    std::vector< std::pair<GUIntBig, size_t> > aoOrder;
+    aoOrder.reserve(nEntries);
+    for( size_t i = 0; i < nEntries; i++ )
+    {
+        const GPKGRTreeEntry& sEntry = m_aoRTreeEntries[i];
+        const double dfX =
+            ((sEntry.dfMinX + sEntry.dfMaxX) / 2 - sExtent.MinX) * dfScaleX;
+        const double dfY =
+            ((sEntry.dfMinY + sEntry.dfMaxY) / 2 - sExtent.MinY) * dfScaleY;
+        const GUInt32 nX = static_cast<GUInt32>(
+            std::max(0.0, std::min(65535.0, dfX)));
+        const GUInt32 nY = static_cast<GUInt32>(
+            std::max(0.0, std::min(65535.0, dfY)));
+        aoOrder.push_back(std::pair<GUIntBig, size_t>(
+                                            GPKGHilbertCode(nX, nY), i));
+    }
+    std::sort(aoOrder.begin(), aoOrder.end());
+
+    char* pszSQL = sqlite3_mprintf(
+        "INSERT OR REPLACE INTO \"rtree_%w_%w\" VALUES (?, ?, ?, ?, ?)",
+        pszT, pszC);
+    sqlite3_stmt* hStmt = NULL;
+    int rc = sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hStmt, NULL);
+    sqlite3_free(pszSQL);
+    if( rc != SQLITE_OK )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "failed to prepare SQL: %s",
+                 sqlite3_errmsg(m_poDS->GetDB()));
+        return OGRERR_FAILURE;
+    }
+
+    OGRErr eErr = OGRERR_NONE;
+    for( size_t i = 0; i < nEntries; i++ )
+    {
+        const GPKGRTreeEntry& sEntry = m_aoRTreeEntries[aoOrder[i].second];
+        sqlite3_bind_int64(hStmt, 1, sEntry.nId);
+        sqlite3_bind_double(hStmt, 2, sEntry.dfMinX);
+        sqlite3_bind_double(hStmt, 3, sEntry.dfMaxX);
+        sqlite3_bind_double(hStmt, 4, sEntry.dfMinY);
+        sqlite3_bind_double(hStmt, 5, sEntry.dfMaxY);
+        rc = sqlite3_step(hStmt);
+        sqlite3_reset(hStmt);
+        if( rc != SQLITE_DONE )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "failed to insert in spatial index: %s",
+                     sqlite3_errmsg(m_poDS->GetDB()));
+            eErr = OGRERR_FAILURE;
+            break;
+        }
+    }
+    sqlite3_finalize(hStmt);
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                       CreateSpatialIndex()                           */
 /************************************************************************/
@@ -1921,12 +2105,21 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
     m_bDropRTreeTable = false;
 
     /* Populate the RTree */
-    pszSQL = sqlite3_mprintf(
+    if( m_bRTreeEntriesValid )
+    {
+        err = PopulateRTreeFromEntries(pszT, pszC);
+    }
+    else
+    {
+        pszSQL = sqlite3_mprintf(
                  "INSERT OR REPLACE INTO \"rtree_%w_%w\" "
-                 "SELECT \"%w\", st_minx(\"%w\"), st_maxx(\"%w\"), st_miny(\"%w\"), st_maxy(\"%w\") FROM \"%w\"",
-                 pszT, pszC, pszI, pszC, pszC, pszC, pszC, pszT );
-    err = SQLCommand(m_poDS->GetDB(), pszSQL);
-    sqlite3_free(pszSQL);
+                 "SELECT \"%w\", st_minx(\"%w\"), st_maxx(\"%w\"), st_miny(\"%w\"), st_maxy(\"%w\") FROM \"%w\" "
+                 "WHERE \"%w\" NOT NULL AND NOT ST_IsEmpty(\"%w\")",
+                 pszT, pszC, pszI, pszC, pszC, pszC, pszC, pszT, pszC, pszC );
+        err = SQLCommand(m_poDS->GetDB(), pszSQL);
+        sqlite3_free(pszSQL);
+    }
+    InvalidateRTreeEntries();
     if( err != OGRERR_NONE )
     {
         m_poDS->SoftRollbackTransaction();
@@ -31,9 +31,12 @@
 #ifndef OGRMEM_H_INCLUDED
 #define OGRMEM_H_INCLUDED
 
+#include "cpl_quad_tree.h"
 #include "ogrsf_frmts.h"
 
 #include <map>
+#include <set>
+#include <vector>
 
 /************************************************************************/
 /*                             OGRMemLayer                              */
@@ -41,9 +44,12 @@
 class OGRMemDataSource;
 
 class IOGRMemLayerFeatureIterator;
+class OGRMemLayerAttrIndex;
 
 class OGRMemLayer : public OGRLayer
 {
+    friend class OGRMemLayerAttrIndex;
+
     typedef std::map<GIntBig, OGRFeature*>           FeatureMap;
     typedef std::map<GIntBig, OGRFeature*>::iterator FeatureIterator;
 
@@ -66,6 +72,34 @@ class OGRMemLayer : public OGRLayer
 
     bool                m_bUpdated;
 
+    // Optional spatial index, built lazily on the first spatially filtered
+    // read and then maintained as features are added/updated/deleted.
+    // The bounds of the indexed features are kept by FID, as they were
+    // inserted. Features outside of the extent of the quad tree and
+    // features without geometry are kept aside.
+    bool                m_bSpatialIndexEnabled;
+    CPLQuadTree        *m_hSpatialIndex;
+    int                 m_iSpatialIndexGeomField;
+    CPLRectObj          m_sSpatialIndexExtent;
+    std::map<GIntBig, CPLRectObj> m_oMapSpatialIndexBounds;
+    std::set<GIntBig>   m_oSetSpatialIndexOutOfExtent;
+    std::set<GIntBig>   m_oSetSpatialIndexNoGeometry;
+
+    // Sorted list of the FIDs that may match the current filters, when
+    // the spatial and/or attribute indexes can be used.
+    bool                m_bCandidatesValid;
+    bool                m_bUseCandidates;
+    std::vector<GIntBig> m_anCandidateFIDs;
+    size_t              m_iNextCandidate;
+    GIntBig             m_nLastCandidateFID;
+
+    void                BuildSpatialIndex();
+    void                DropSpatialIndex();
+    void                IndexFeature( OGRFeature *poFeature );
+    void                UnindexFeature( OGRFeature *poFeature );
+    bool                ComputeCandidates();
+    OGRFeature         *GetFeatureRef( GIntBig nFID );
+
     // Only use it in the lifetime of a function where the list of features
     // doesn't change.
     IOGRMemLayerFeatureIterator* GetIterator();
@@ -105,6 +139,7 @@ class OGRMemLayer : public OGRLayer
         { m_bUpdatable = bUpdatableIn; }
     void                SetAdvertizeUTF8( bool bAdvertizeUTF8In )
         { m_bAdvertizeUTF8 = bAdvertizeUTF8In; }
+    void                SetSpatialIndexEnabled( bool bEnabled );
 
     bool                HasBeenUpdated() const { return m_bUpdated; }
     void                SetUpdated(bool bUpdated) { m_bUpdated = bUpdated; }
@@ -76,6 +76,9 @@ OGRMemDataSource::ICreateLayer( const char * pszLayerName,
     if( CPLFetchBool(papszOptions, "ADVERTIZE_UTF8", false) )
         poLayer->SetAdvertizeUTF8(true);
 
+    if( CPLFetchBool(papszOptions, "SPATIAL_INDEX", false) )
+        poLayer->SetSpatialIndexEnabled(true);
+
 /* -------------------------------------------------------------------- */
 /*      Add layer to data source layer list.                            */
 /* -------------------------------------------------------------------- */
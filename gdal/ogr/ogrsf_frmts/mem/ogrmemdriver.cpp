@@ -103,6 +103,8 @@ void RegisterOGRMEM()
         "<LayerCreationOptionList>"
         "  <Option name='ADVERTIZE_UTF8' type='boolean' description='Whether "
         "the layer will contain UTF-8 strings' default='NO'/>"
+        "  <Option name='SPATIAL_INDEX' type='boolean' description='Whether "
+        "to maintain a spatial index on the layer' default='NO'/>"
         "</LayerCreationOptionList>" );
 
     OGRSFDriverRegistrar::GetRegistrar()->RegisterDriver( poDriver );
@@ -28,10 +28,12 @@
  ****************************************************************************/
 
 #include "cpl_conv.h"
+#include "ogr_attrind.h"
 #include "ogr_mem.h"
 #include "ogr_p.h"
 
 #include <algorithm>
+#include <iterator>
 
 CPL_CVSID("$Id$");
 
@@ -47,6 +49,76 @@ class IOGRMemLayerFeatureIterator
         virtual OGRFeature* Next() = 0;
 };
 
+/************************************************************************/
+/*                            OGRMemAttrIndex                           */
+/*                                                                      */
+/*      In-memory index of the values of one field. For each value,     */
+/*      the sorted list of the FIDs of the features that have it.      */
+/************************************************************************/
+
+class OGRMemAttrIndex : public OGRAttrIndex
+{
+    typedef std::vector<GIntBig> FIDList;
+
+    OGRFieldType                   m_eType;
+    std::map<GIntBig, FIDList>     m_oMapInteger;
+    std::map<double, FIDList>      m_oMapReal;
+    std::map<CPLString, FIDList>   m_oMapString;
+
+    FIDList    *GetFIDList( const OGRField *psKey, bool bCreate );
+    void        RemoveKey( const OGRField *psKey );
+
+  public:
+    int         m_iField;
+
+                OGRMemAttrIndex( int iField, OGRFieldType eType ) :
+                    m_eType(eType), m_iField(iField) {}
+
+    static bool IsSupportedType( OGRFieldType eType );
+
+    GIntBig     GetFirstMatch( OGRField *psKey ) override;
+    GIntBig    *GetAllMatches( OGRField *psKey ) override;
+    GIntBig    *GetAllMatches( OGRField *psKey, GIntBig* panFIDList,
+                               int* nFIDCount, int* nLength ) override;
+
+    OGRErr      AddEntry( OGRField *psKey, GIntBig nFID ) override;
+    OGRErr      RemoveEntry( OGRField *psKey, GIntBig nFID ) override;
+
+    OGRErr      Clear() override;
+};
+
+/************************************************************************/
+/*                          OGRMemLayerAttrIndex                        */
+/************************************************************************/
+
+class OGRMemLayerAttrIndex : public OGRLayerAttrIndex
+{
+    OGRMemLayer                    *m_poMemLayer;
+    std::vector<OGRMemAttrIndex*>   m_apoIndexes;
+
+  public:
+    explicit    OGRMemLayerAttrIndex( OGRMemLayer *poLayerIn );
+    virtual    ~OGRMemLayerAttrIndex();
+
+    OGRErr      Initialize( const char *pszIndexPath, OGRLayer * ) override;
+    OGRErr      CreateIndex( int iField ) override;
+    OGRErr      DropIndex( int iField ) override;
+    OGRErr      IndexAllFeatures( int iField = -1 ) override;
+
+    OGRErr      AddToIndex( OGRFeature *poFeature, int iField = -1 ) override;
+    OGRErr      RemoveFromIndex( OGRFeature *poFeature ) override;
+
+    OGRAttrIndex *GetFieldIndex( int iField ) override;
+
+    bool        HasIndexes() const { return !m_apoIndexes.empty(); }
+    void        FieldDeleted( int iField );
+    void        FieldsReordered( const int *panMap, int nFieldCount );
+    void        FieldTypeChanged( int iField );
+
+  private:
+    CPL_DISALLOW_COPY_ASSIGN(OGRMemLayerAttrIndex)
+};
+
 /************************************************************************/
 /*                            OGRMemLayer()                             */
 /************************************************************************/
@@ -62,10 +134,24 @@ OGRMemLayer::OGRMemLayer( const char * pszName, OGRSpatialReference *poSRSIn,
     m_iNextCreateFID(0),
     m_bUpdatable(true),
     m_bAdvertizeUTF8(false),
-    m_bUpdated(false)
+    m_bUpdated(false),
+    m_bSpatialIndexEnabled(false),
+    m_hSpatialIndex(NULL),
+    m_iSpatialIndexGeomField(0),
+    m_bCandidatesValid(false),
+    m_bUseCandidates(true),
+    m_iNextCandidate(0),
+    m_nLastCandidateFID(-1)
 {
     m_poFeatureDefn->Reference();
 
+    m_sSpatialIndexExtent.minx = 0.0;
+    m_sSpatialIndexExtent.miny = 0.0;
+    m_sSpatialIndexExtent.maxx = 0.0;
+    m_sSpatialIndexExtent.maxy = 0.0;
+
+    m_poAttrIndex = new OGRMemLayerAttrIndex(this);
+
     SetDescription( m_poFeatureDefn->GetName() );
     m_poFeatureDefn->SetGeomType( eReqType );
 
@@ -112,6 +198,8 @@ OGRMemLayer::~OGRMemLayer()
         }
     }
 
+    DropSpatialIndex();
+
     if( m_poFeatureDefn )
         m_poFeatureDefn->Release();
 }
@@ -125,6 +213,12 @@ void OGRMemLayer::ResetReading()
 {
     m_iNextReadFID = 0;
     m_oMapFeaturesIter = m_oMapFeatures.begin();
+
+    m_bCandidatesValid = false;
+    m_bUseCandidates = true;
+    m_anCandidateFIDs.clear();
+    m_iNextCandidate = 0;
+    m_nLastCandidateFID = -1;
 }
 
 /************************************************************************/
@@ -134,6 +228,45 @@ void OGRMemLayer::ResetReading()
 OGRFeature *OGRMemLayer::GetNextFeature()
 
 {
+/* -------------------------------------------------------------------- */
+/*      If the spatial index and/or attribute indexes can be used,      */
+/*      only visit the features they return.                            */
+/* -------------------------------------------------------------------- */
+    if( m_bUseCandidates && !m_bCandidatesValid && !ComputeCandidates() )
+    {
+        m_bUseCandidates = false;
+
+        // The indexes can no longer be used in the middle of an
+        // iteration: resume the sequential scan after the last feature
+        // visited.
+        if( m_nLastCandidateFID >= 0 )
+        {
+            m_iNextReadFID = m_nLastCandidateFID + 1;
+            m_oMapFeaturesIter =
+                m_oMapFeatures.upper_bound(m_nLastCandidateFID);
+        }
+    }
+
+    while( m_bUseCandidates )
+    {
+        if( m_iNextCandidate >= m_anCandidateFIDs.size() )
+            return NULL;
+
+        m_nLastCandidateFID = m_anCandidateFIDs[m_iNextCandidate++];
+        OGRFeature *poFeature = GetFeatureRef(m_nLastCandidateFID);
+        if( poFeature == NULL )
+            continue;
+
+        if( (m_poFilterGeom == NULL
+             || FilterGeometry( poFeature->GetGeomFieldRef(m_iGeomFieldFilter) ) )
+            && (m_poAttrQuery == NULL
+                || m_poAttrQuery->Evaluate( poFeature ) ) )
+        {
+            m_nFeaturesRead++;
+            return poFeature->Clone();
+        }
+    }
+
     while( true )
     {
         OGRFeature *poFeature = NULL;
@@ -186,28 +319,36 @@ OGRErr OGRMemLayer::SetNextByIndex( GIntBig nIndex )
 }
 
 /************************************************************************/
-/*                             GetFeature()                             */
+/*                           GetFeatureRef()                            */
 /************************************************************************/
 
-OGRFeature *OGRMemLayer::GetFeature( GIntBig nFeatureId )
+OGRFeature *OGRMemLayer::GetFeatureRef( GIntBig nFeatureId )
 
 {
     if( nFeatureId < 0 )
         return NULL;
 
-    OGRFeature* poFeature = NULL;
     if( m_papoFeatures != NULL )
     {
         if( nFeatureId >= m_nMaxFeatureCount )
             return NULL;
-        poFeature = m_papoFeatures[nFeatureId];
-    }
-    else
-    {
-        FeatureIterator oIter = m_oMapFeatures.find(nFeatureId);
-        if( oIter != m_oMapFeatures.end() )
-            poFeature = oIter->second;
+        return m_papoFeatures[nFeatureId];
     }
+
+    FeatureIterator oIter = m_oMapFeatures.find(nFeatureId);
+    if( oIter != m_oMapFeatures.end() )
+        return oIter->second;
+    return NULL;
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/************************************************************************/
+
+OGRFeature *OGRMemLayer::GetFeature( GIntBig nFeatureId )
+
+{
+    OGRFeature* poFeature = GetFeatureRef(nFeatureId);
     if( poFeature == NULL )
         return NULL;
 
@@ -332,6 +473,7 @@ OGRErr OGRMemLayer::ISetFeature( OGRFeature *poFeature )
 
         if( m_papoFeatures[nFID] != NULL )
         {
+            UnindexFeature( m_papoFeatures[nFID] );
             delete m_papoFeatures[nFID];
             m_papoFeatures[nFID] = NULL;
         }
@@ -347,6 +489,7 @@ OGRErr OGRMemLayer::ISetFeature( OGRFeature *poFeature )
         FeatureIterator oIter = m_oMapFeatures.find(nFID);
         if( oIter != m_oMapFeatures.end() )
         {
+            UnindexFeature( oIter->second );
             delete oIter->second;
             oIter->second = poFeatureCloned;
         }
@@ -377,6 +520,8 @@ OGRErr OGRMemLayer::ISetFeature( OGRFeature *poFeature )
         }
     }
 
+    IndexFeature( poFeatureCloned );
+
     m_bUpdated = true;
 
     return OGRERR_NONE;
@@ -440,6 +585,7 @@ OGRErr OGRMemLayer::DeleteFeature( GIntBig nFID )
         {
             return OGRERR_FAILURE;
         }
+        UnindexFeature( m_papoFeatures[nFID] );
         delete m_papoFeatures[nFID];
         m_papoFeatures[nFID] = NULL;
     }
@@ -450,6 +596,7 @@ OGRErr OGRMemLayer::DeleteFeature( GIntBig nFID )
         {
             return OGRERR_FAILURE;
         }
+        UnindexFeature( oIter->second );
         delete oIter->second;
         m_oMapFeatures.erase(oIter);
     }
@@ -498,7 +645,7 @@ int OGRMemLayer::TestCapability( const char * pszCap )
         return m_poFilterGeom == NULL && m_poAttrQuery == NULL;
 
     else if( EQUAL(pszCap,OLCFastSpatialFilter) )
-        return FALSE;
+        return m_bSpatialIndexEnabled;
 
     else if( EQUAL(pszCap,OLCDeleteFeature) )
         return m_bUpdatable;
@@ -624,6 +771,8 @@ OGRErr OGRMemLayer::DeleteField( int iField )
     }
     delete poIter;
 
+    static_cast<OGRMemLayerAttrIndex *>(m_poAttrIndex)->FieldDeleted(iField);
+
     m_bUpdated = true;
 
     return m_poFeatureDefn->DeleteFieldDefn( iField );
@@ -658,6 +807,9 @@ OGRErr OGRMemLayer::ReorderFields( int* panMap )
     }
     delete poIter;
 
+    static_cast<OGRMemLayerAttrIndex *>(m_poAttrIndex)->FieldsReordered(
+        panMap, m_poFeatureDefn->GetFieldCount() );
+
     m_bUpdated = true;
 
     return m_poFeatureDefn->ReorderFieldDefns( panMap );
@@ -792,6 +944,9 @@ OGRErr OGRMemLayer::AlterFieldDefn( int iField, OGRFieldDefn* poNewFieldDefn,
         poFieldDefn->SetSubType(OFSTNone);
         poFieldDefn->SetType(poNewFieldDefn->GetType());
         poFieldDefn->SetSubType(poNewFieldDefn->GetSubType());
+
+        static_cast<OGRMemLayerAttrIndex *>(m_poAttrIndex)->
+            FieldTypeChanged(iField);
     }
 
     if( nFlagsIn & ALTER_NAME_FLAG )
@@ -939,3 +1094,751 @@ IOGRMemLayerFeatureIterator* OGRMemLayer::GetIterator()
 
     return new OGRMemLayerIteratorMap(m_oMapFeatures);
 }
+
+/************************************************************************/
+/*                       SetSpatialIndexEnabled()                       */
+/************************************************************************/
+
+void OGRMemLayer::SetSpatialIndexEnabled( bool bEnabled )
+{
+    m_bSpatialIndexEnabled = bEnabled;
+    if( !bEnabled )
+        DropSpatialIndex();
+    m_bCandidatesValid = false;
+}
+
+/************************************************************************/
+/*                          DropSpatialIndex()                          */
+/************************************************************************/
+
+void OGRMemLayer::DropSpatialIndex()
+{
+    if( m_hSpatialIndex != NULL )
+    {
+        CPLQuadTreeDestroy(m_hSpatialIndex);
+        m_hSpatialIndex = NULL;
+    }
+    m_oMapSpatialIndexBounds.clear();
+    m_oSetSpatialIndexOutOfExtent.clear();
+    m_oSetSpatialIndexNoGeometry.clear();
+}
+
+/************************************************************************/
+/*                         BuildSpatialIndex()                          */
+/*                                                                      */
+/*      Build the quad tree over the extent of the current features     */
+/*      of the geometry field on which the spatial filter is set.       */
+/************************************************************************/
+
+void OGRMemLayer::BuildSpatialIndex()
+{
+    DropSpatialIndex();
+
+    m_iSpatialIndexGeomField = m_iGeomFieldFilter;
+
+    OGREnvelope sExtent;
+    bool bHasExtent = false;
+    IOGRMemLayerFeatureIterator* poIter = GetIterator();
+    OGRFeature* poFeature = NULL;
+    while( (poFeature = poIter->Next()) != NULL )
+    {
+        OGRGeometry* poGeom =
+            poFeature->GetGeomFieldRef(m_iSpatialIndexGeomField);
+        if( poGeom == NULL || poGeom->IsEmpty() )
+            continue;
+        OGREnvelope sEnvelope;
+        poGeom->getEnvelope(&sEnvelope);
+        sExtent.Merge(sEnvelope);
+        bHasExtent = true;
+    }
+    delete poIter;
+
+    if( bHasExtent )
+    {
+        m_sSpatialIndexExtent.minx = sExtent.MinX;
+        m_sSpatialIndexExtent.miny = sExtent.MinY;
+        m_sSpatialIndexExtent.maxx = sExtent.MaxX;
+        m_sSpatialIndexExtent.maxy = sExtent.MaxY;
+    }
+    else
+    {
+        m_sSpatialIndexExtent.minx = 0.0;
+        m_sSpatialIndexExtent.miny = 0.0;
+        m_sSpatialIndexExtent.maxx = 0.0;
+        m_sSpatialIndexExtent.maxy = 0.0;
+    }
+    m_hSpatialIndex = CPLQuadTreeCreate(&m_sSpatialIndexExtent, NULL);
+
+    poIter = GetIterator();
+    while( (poFeature = poIter->Next()) != NULL )
+        IndexFeature(poFeature);
+    delete poIter;
+
+    CPLDebug( "Mem", "Spatial index of layer '%s' built on "
+              CPL_FRMT_GIB " features.",
+              m_poFeatureDefn->GetName(),
+              static_cast<GIntBig>(m_oMapSpatialIndexBounds.size()) );
+}
+
+/************************************************************************/
+/*                            IndexFeature()                            */
+/*                                                                      */
+/*      Add a feature newly stored in the layer to the indexes.         */
+/************************************************************************/
+
+void OGRMemLayer::IndexFeature( OGRFeature *poFeature )
+{
+    m_bCandidatesValid = false;
+
+    OGRMemLayerAttrIndex* poAttrIndex =
+        static_cast<OGRMemLayerAttrIndex *>(m_poAttrIndex);
+    if( poAttrIndex->HasIndexes() )
+        poAttrIndex->AddToIndex(poFeature);
+
+    if( m_hSpatialIndex == NULL )
+        return;
+
+    const GIntBig nFID = poFeature->GetFID();
+    OGRGeometry* poGeom = poFeature->GetGeomFieldRef(m_iSpatialIndexGeomField);
+    if( poGeom == NULL || poGeom->IsEmpty() )
+    {
+        // Those are accepted by FilterGeometry(), or may be, so they are
+        // always candidates.
+        m_oSetSpatialIndexNoGeometry.insert(nFID);
+        return;
+    }
+
+    OGREnvelope sEnvelope;
+    poGeom->getEnvelope(&sEnvelope);
+    CPLRectObj sBounds;
+    sBounds.minx = sEnvelope.MinX;
+    sBounds.miny = sEnvelope.MinY;
+    sBounds.maxx = sEnvelope.MaxX;
+    sBounds.maxy = sEnvelope.MaxY;
+    m_oMapSpatialIndexBounds[nFID] = sBounds;
+
+    // The quad tree does not visit its root node when the area of interest
+    // is outside of its extent, so features outside of the extent the quad
+    // tree has been built for are kept aside. When there are too many of
+    // them, drop the index so that it is rebuilt on the new extent by the
+    // next query.
+    if( sBounds.minx < m_sSpatialIndexExtent.minx ||
+        sBounds.miny < m_sSpatialIndexExtent.miny ||
+        sBounds.maxx > m_sSpatialIndexExtent.maxx ||
+        sBounds.maxy > m_sSpatialIndexExtent.maxy )
+    {
+        m_oSetSpatialIndexOutOfExtent.insert(nFID);
+        if( m_oSetSpatialIndexOutOfExtent.size() > 1000 &&
+            m_oSetSpatialIndexOutOfExtent.size() >
+                m_oMapSpatialIndexBounds.size() / 4 )
+        {
+            DropSpatialIndex();
+        }
+        return;
+    }
+
+    CPLQuadTreeInsertWithBounds(m_hSpatialIndex, poFeature, &sBounds);
+}
+
+/************************************************************************/
+/*                           UnindexFeature()                           */
+/*                                                                      */
+/*      Remove a feature from the indexes before it is destroyed.       */
+/************************************************************************/
+
+void OGRMemLayer::UnindexFeature( OGRFeature *poFeature )
+{
+    m_bCandidatesValid = false;
+
+    OGRMemLayerAttrIndex* poAttrIndex =
+        static_cast<OGRMemLayerAttrIndex *>(m_poAttrIndex);
+    if( poAttrIndex->HasIndexes() )
+        poAttrIndex->RemoveFromIndex(poFeature);
+
+    if( m_hSpatialIndex == NULL )
+        return;
+
+    const GIntBig nFID = poFeature->GetFID();
+    if( m_oSetSpatialIndexNoGeometry.erase(nFID) )
+        return;
+
+    std::map<GIntBig, CPLRectObj>::iterator oIter =
+        m_oMapSpatialIndexBounds.find(nFID);
+    if( oIter == m_oMapSpatialIndexBounds.end() ||
+        (!m_oSetSpatialIndexOutOfExtent.erase(nFID) &&
+         !CPLQuadTreeRemove(m_hSpatialIndex, poFeature, &oIter->second)) )
+    {
+        // Should not happen, but a stale index would silently miss
+        // features: drop it so that it is rebuilt by the next query.
+        CPLDebug( "Mem", "Feature " CPL_FRMT_GIB " of layer '%s' not found "
+                  "in the spatial index. Dropping it.",
+                  nFID, m_poFeatureDefn->GetName() );
+        DropSpatialIndex();
+        return;
+    }
+    m_oMapSpatialIndexBounds.erase(oIter);
+}
+
+/************************************************************************/
+/*                         ComputeCandidates()                          */
+/*                                                                      */
+/*      Compute the sorted list of FIDs of the features that may        */
+/*      match the spatial and attribute filters, using the indexes.     */
+/*      Returns false if no index can be used for the current           */
+/*      filters.                                                        */
+/************************************************************************/
+
+bool OGRMemLayer::ComputeCandidates()
+{
+    const bool bUseSpatialIndex =
+        m_poFilterGeom != NULL && m_bSpatialIndexEnabled;
+    const bool bUseAttrIndex =
+        m_poAttrQuery != NULL &&
+        static_cast<OGRMemLayerAttrIndex *>(m_poAttrIndex)->HasIndexes() &&
+        m_poAttrQuery->CanUseIndex(this);
+    if( !bUseSpatialIndex && !bUseAttrIndex )
+        return false;
+
+    std::vector<GIntBig> anFIDs;
+
+    if( bUseSpatialIndex )
+    {
+        if( m_hSpatialIndex == NULL ||
+            m_iSpatialIndexGeomField != m_iGeomFieldFilter )
+        {
+            BuildSpatialIndex();
+        }
+
+        CPLRectObj sAoi;
+        sAoi.minx = m_sFilterEnvelope.MinX;
+        sAoi.miny = m_sFilterEnvelope.MinY;
+        sAoi.maxx = m_sFilterEnvelope.MaxX;
+        sAoi.maxy = m_sFilterEnvelope.MaxY;
+        int nCount = 0;
+        void** pahFeatures = CPLQuadTreeSearch(m_hSpatialIndex, &sAoi, &nCount);
+        anFIDs.reserve(nCount);
+        for( int i = 0; i < nCount; i++ )
+        {
+            anFIDs.push_back(
+                static_cast<OGRFeature *>(pahFeatures[i])->GetFID() );
+        }
+        CPLFree(pahFeatures);
+
+        for( std::set<GIntBig>::const_iterator oIter =
+                 m_oSetSpatialIndexOutOfExtent.begin();
+             oIter != m_oSetSpatialIndexOutOfExtent.end(); ++oIter )
+        {
+            const CPLRectObj& sBounds = m_oMapSpatialIndexBounds[*oIter];
+            if( sBounds.minx <= sAoi.maxx && sBounds.maxx >= sAoi.minx &&
+                sBounds.miny <= sAoi.maxy && sBounds.maxy >= sAoi.miny )
+            {
+                anFIDs.push_back(*oIter);
+            }
+        }
+        anFIDs.insert(anFIDs.end(), m_oSetSpatialIndexNoGeometry.begin(),
+                      m_oSetSpatialIndexNoGeometry.end());
+        std::sort(anFIDs.begin(), anFIDs.end());
+    }
+
+    if( bUseAttrIndex )
+    {
+        OGRErr eErr = OGRERR_NONE;
+        GIntBig* panFIDs = m_poAttrQuery->EvaluateAgainstIndices(this, &eErr);
+        if( panFIDs == NULL )
+        {
+            if( !bUseSpatialIndex )
+                return false;
+        }
+        else
+        {
+            std::vector<GIntBig> anAttrFIDs;
+            for( int i = 0; panFIDs[i] != OGRNullFID; i++ )
+                anAttrFIDs.push_back(panFIDs[i]);
+            CPLFree(panFIDs);
+            std::sort(anAttrFIDs.begin(), anAttrFIDs.end());
+
+            if( bUseSpatialIndex )
+            {
+                std::vector<GIntBig> anIntersection;
+                std::set_intersection(anFIDs.begin(), anFIDs.end(),
+                                      anAttrFIDs.begin(), anAttrFIDs.end(),
+                                      std::back_inserter(anIntersection));
+                anFIDs.swap(anIntersection);
+            }
+            else
+            {
+                anFIDs.swap(anAttrFIDs);
+            }
+        }
+    }
+
+    anFIDs.erase(std::unique(anFIDs.begin(), anFIDs.end()), anFIDs.end());
+
+    // When the list is recomputed while iterating, because the layer has
+    // been modified, skip the features already visited.
+    m_iNextCandidate = static_cast<size_t>(
+        std::upper_bound(anFIDs.begin(), anFIDs.end(), m_nLastCandidateFID) -
+        anFIDs.begin());
+    m_anCandidateFIDs.swap(anFIDs);
+    m_bCandidatesValid = true;
+
+    return true;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                            OGRMemAttrIndex                           */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                          IsSupportedType()                           */
+/************************************************************************/
+
+bool OGRMemAttrIndex::IsSupportedType( OGRFieldType eType )
+{
+    return eType == OFTInteger || eType == OFTInteger64 ||
+           eType == OFTReal || eType == OFTString;
+}
+
+/************************************************************************/
+/*                             GetFIDList()                             */
+/************************************************************************/
+
+OGRMemAttrIndex::FIDList *OGRMemAttrIndex::GetFIDList( const OGRField *psKey,
+                                                       bool bCreate )
+{
+    switch( m_eType )
+    {
+        case OFTInteger:
+        case OFTInteger64:
+        {
+            const GIntBig nKey = m_eType == OFTInteger ?
+                psKey->Integer : psKey->Integer64;
+            if( bCreate )
+                return &m_oMapInteger[nKey];
+            std::map<GIntBig, FIDList>::iterator oIter =
+                m_oMapInteger.find(nKey);
+            return oIter != m_oMapInteger.end() ? &oIter->second : NULL;
+        }
+
+        case OFTReal:
+        {
+            // NaN never compares equal to anything.
+            if( CPLIsNan(psKey->Real) )
+                return NULL;
+            if( bCreate )
+                return &m_oMapReal[psKey->Real];
+            std::map<double, FIDList>::iterator oIter =
+                m_oMapReal.find(psKey->Real);
+            return oIter != m_oMapReal.end() ? &oIter->second : NULL;
+        }
+
+        case OFTString:
+        {
+            if( psKey->String == NULL )
+                return NULL;
+            // OGR SQL compares strings in a case insensitive way, and
+            // ignores a "+00" timezone suffix when comparing timestamps.
+            CPLString osKey(psKey->String);
+            osKey.toupper();
+            if( osKey.size() > 3 &&
+                osKey.compare(osKey.size() - 3, 3, "+00") == 0 )
+            {
+                osKey.resize(osKey.size() - 3);
+            }
+            if( bCreate )
+                return &m_oMapString[osKey];
+            std::map<CPLString, FIDList>::iterator oIter =
+                m_oMapString.find(osKey);
+            return oIter != m_oMapString.end() ? &oIter->second : NULL;
+        }
+
+        default:
+            return NULL;
+    }
+}
+
+/************************************************************************/
+/*                             RemoveKey()                              */
+/************************************************************************/
+
+void OGRMemAttrIndex::RemoveKey( const OGRField *psKey )
+{
+    switch( m_eType )
+    {
+        case OFTInteger:
+            m_oMapInteger.erase(psKey->Integer);
+            break;
+        case OFTInteger64:
+            m_oMapInteger.erase(psKey->Integer64);
+            break;
+        case OFTReal:
+            m_oMapReal.erase(psKey->Real);
+            break;
+        case OFTString:
+        {
+            CPLString osKey(psKey->String);
+            osKey.toupper();
+            if( osKey.size() > 3 &&
+                osKey.compare(osKey.size() - 3, 3, "+00") == 0 )
+            {
+                osKey.resize(osKey.size() - 3);
+            }
+            m_oMapString.erase(osKey);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/************************************************************************/
+/*                           GetFirstMatch()                            */
+/************************************************************************/
+
+GIntBig OGRMemAttrIndex::GetFirstMatch( OGRField *psKey )
+{
+    FIDList* panList = GetFIDList(psKey, false);
+    if( panList == NULL || panList->empty() )
+        return OGRNullFID;
+    return (*panList)[0];
+}
+
+/************************************************************************/
+/*                           GetAllMatches()                            */
+/************************************************************************/
+
+GIntBig *OGRMemAttrIndex::GetAllMatches( OGRField *psKey,
+                                         GIntBig* panFIDList,
+                                         int* nFIDCount, int* nLength )
+{
+    if( panFIDList == NULL )
+    {
+        panFIDList = static_cast<GIntBig *>(CPLMalloc(sizeof(GIntBig) * 2));
+        *nFIDCount = 0;
+        *nLength = 2;
+    }
+
+    FIDList* panList = GetFIDList(psKey, false);
+    if( panList != NULL )
+    {
+        const int nNewCount = *nFIDCount + static_cast<int>(panList->size());
+        if( nNewCount >= *nLength )
+        {
+            *nLength = nNewCount + 1;
+            panFIDList = static_cast<GIntBig *>(
+                CPLRealloc(panFIDList, sizeof(GIntBig) * (*nLength)));
+        }
+        for( size_t i = 0; i < panList->size(); i++ )
+            panFIDList[(*nFIDCount)++] = (*panList)[i];
+    }
+
+    panFIDList[*nFIDCount] = OGRNullFID;
+
+    return panFIDList;
+}
+
+GIntBig *OGRMemAttrIndex::GetAllMatches( OGRField *psKey )
+{
+    int nFIDCount = 0;
+    int nLength = 0;
+    return GetAllMatches( psKey, NULL, &nFIDCount, &nLength );
+}
+
+/************************************************************************/
+/*                              AddEntry()                              */
+/************************************************************************/
+
+OGRErr OGRMemAttrIndex::AddEntry( OGRField *psKey, GIntBig nFID )
+{
+    FIDList* panList = GetFIDList(psKey, true);
+    if( panList == NULL )
+        return OGRERR_NONE;
+
+    // FIDs are most often inserted in increasing order.
+    if( panList->empty() || panList->back() < nFID )
+    {
+        panList->push_back(nFID);
+        return OGRERR_NONE;
+    }
+    FIDList::iterator oIter =
+        std::lower_bound(panList->begin(), panList->end(), nFID);
+    if( *oIter != nFID )
+        panList->insert(oIter, nFID);
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                            RemoveEntry()                             */
+/************************************************************************/
+
+OGRErr OGRMemAttrIndex::RemoveEntry( OGRField *psKey, GIntBig nFID )
+{
+    FIDList* panList = GetFIDList(psKey, false);
+    if( panList == NULL )
+        return OGRERR_NONE;
+
+    FIDList::iterator oIter =
+        std::lower_bound(panList->begin(), panList->end(), nFID);
+    if( oIter != panList->end() && *oIter == nFID )
+    {
+        panList->erase(oIter);
+        if( panList->empty() )
+            RemoveKey(psKey);
+    }
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                               Clear()                                */
+/************************************************************************/
+
+OGRErr OGRMemAttrIndex::Clear()
+{
+    m_oMapInteger.clear();
+    m_oMapReal.clear();
+    m_oMapString.clear();
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                         OGRMemLayerAttrIndex                         */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                        OGRMemLayerAttrIndex()                        */
+/************************************************************************/
+
+OGRMemLayerAttrIndex::OGRMemLayerAttrIndex( OGRMemLayer *poLayerIn ) :
+    m_poMemLayer(poLayerIn)
+{
+    poLayer = poLayerIn;
+}
+
+/************************************************************************/
+/*                       ~OGRMemLayerAttrIndex()                        */
+/************************************************************************/
+
+OGRMemLayerAttrIndex::~OGRMemLayerAttrIndex()
+{
+    for( size_t i = 0; i < m_apoIndexes.size(); i++ )
+        delete m_apoIndexes[i];
+}
+
+/************************************************************************/
+/*                             Initialize()                             */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::Initialize( const char * /* pszIndexPath */,
+                                         OGRLayer * /* poLayer */ )
+{
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                           GetFieldIndex()                            */
+/************************************************************************/
+
+OGRAttrIndex *OGRMemLayerAttrIndex::GetFieldIndex( int iField )
+{
+    for( size_t i = 0; i < m_apoIndexes.size(); i++ )
+    {
+        if( m_apoIndexes[i]->m_iField == iField )
+            return m_apoIndexes[i];
+    }
+    return NULL;
+}
+
+/************************************************************************/
+/*                            CreateIndex()                             */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::CreateIndex( int iField )
+{
+    OGRFeatureDefn* poDefn = m_poMemLayer->GetLayerDefn();
+    if( iField < 0 || iField >= poDefn->GetFieldCount() )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined, "Invalid field index" );
+        return OGRERR_FAILURE;
+    }
+
+    OGRFieldDefn* poFieldDefn = poDefn->GetFieldDefn(iField);
+    if( GetFieldIndex(iField) != NULL )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Field %s is already indexed.",
+                  poFieldDefn->GetNameRef() );
+        return OGRERR_FAILURE;
+    }
+
+    if( !OGRMemAttrIndex::IsSupportedType(poFieldDefn->GetType()) )
+    {
+        CPLError( CE_Failure, CPLE_NotSupported,
+                  "Indexing field %s of type %s is not supported.",
+                  poFieldDefn->GetNameRef(),
+                  OGRFieldDefn::GetFieldTypeName(poFieldDefn->GetType()) );
+        return OGRERR_FAILURE;
+    }
+
+    m_apoIndexes.push_back(
+        new OGRMemAttrIndex(iField, poFieldDefn->GetType()) );
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             DropIndex()                              */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::DropIndex( int iField )
+{
+    for( size_t i = 0; i < m_apoIndexes.size(); i++ )
+    {
+        if( m_apoIndexes[i]->m_iField == iField )
+        {
+            delete m_apoIndexes[i];
+            m_apoIndexes.erase(m_apoIndexes.begin() + i);
+            return OGRERR_NONE;
+        }
+    }
+
+    CPLError( CE_Failure, CPLE_AppDefined,
+              "DROP INDEX on field (%d) that doesn't have an index.",
+              iField );
+    return OGRERR_FAILURE;
+}
+
+/************************************************************************/
+/*                          IndexAllFeatures()                          */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::IndexAllFeatures( int iField )
+{
+    // Iterate over the stored features rather than with GetNextFeature()
+    // so that the filters of the layer do not get in the way.
+    IOGRMemLayerFeatureIterator* poIter = m_poMemLayer->GetIterator();
+    OGRFeature* poFeature = NULL;
+    OGRErr eErr = OGRERR_NONE;
+    while( eErr == OGRERR_NONE && (poFeature = poIter->Next()) != NULL )
+        eErr = AddToIndex(poFeature, iField);
+    delete poIter;
+
+    m_poMemLayer->m_bCandidatesValid = false;
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                             AddToIndex()                             */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::AddToIndex( OGRFeature *poFeature,
+                                         int iTargetField )
+{
+    if( poFeature->GetFID() == OGRNullFID )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Attempt to index feature with no FID." );
+        return OGRERR_FAILURE;
+    }
+
+    for( size_t i = 0; i < m_apoIndexes.size(); i++ )
+    {
+        const int iField = m_apoIndexes[i]->m_iField;
+        if( iTargetField != -1 && iTargetField != iField )
+            continue;
+
+        if( !poFeature->IsFieldSet( iField ) )
+            continue;
+
+        m_apoIndexes[i]->AddEntry( poFeature->GetRawFieldRef( iField ),
+                                   poFeature->GetFID() );
+    }
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          RemoveFromIndex()                           */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::RemoveFromIndex( OGRFeature *poFeature )
+{
+    for( size_t i = 0; i < m_apoIndexes.size(); i++ )
+    {
+        const int iField = m_apoIndexes[i]->m_iField;
+        if( !poFeature->IsFieldSet( iField ) )
+            continue;
+
+        m_apoIndexes[i]->RemoveEntry( poFeature->GetRawFieldRef( iField ),
+                                      poFeature->GetFID() );
+    }
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                            FieldDeleted()                            */
+/************************************************************************/
+
+void OGRMemLayerAttrIndex::FieldDeleted( int iField )
+{
+    for( size_t i = 0; i < m_apoIndexes.size(); )
+    {
+        if( m_apoIndexes[i]->m_iField == iField )
+        {
+            delete m_apoIndexes[i];
+            m_apoIndexes.erase(m_apoIndexes.begin() + i);
+            continue;
+        }
+        if( m_apoIndexes[i]->m_iField > iField )
+            m_apoIndexes[i]->m_iField--;
+        i++;
+    }
+}
+
+/************************************************************************/
+/*                          FieldsReordered()                           */
+/************************************************************************/
+
+void OGRMemLayerAttrIndex::FieldsReordered( const int *panMap,
+                                            int nFieldCount )
+{
+    // panMap[iNewField] is the old index of the field now at iNewField.
+    for( size_t i = 0; i < m_apoIndexes.size(); i++ )
+    {
+        for( int iNewField = 0; iNewField < nFieldCount; iNewField++ )
+        {
+            if( panMap[iNewField] == m_apoIndexes[i]->m_iField )
+            {
+                m_apoIndexes[i]->m_iField = iNewField;
+                break;
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                          FieldTypeChanged()                          */
+/*                                                                      */
+/*      Rebuild the index of a field whose type has been altered, or    */
+/*      drop it if the new type cannot be indexed.                      */
+/************************************************************************/
+
+void OGRMemLayerAttrIndex::FieldTypeChanged( int iField )
+{
+    if( GetFieldIndex(iField) == NULL )
+        return;
+
+    DropIndex(iField);
+
+    const OGRFieldType eType =
+        m_poMemLayer->GetLayerDefn()->GetFieldDefn(iField)->GetType();
+    if( OGRMemAttrIndex::IsSupportedType(eType) &&
+        CreateIndex(iField) == OGRERR_NONE )
+    {
+        IndexAllFeatures(iField);
+    }
+}
@@ -2111,12 +2111,29 @@ class FileGDBOGRGeometryConverterImpl CPL_FINAL : public FileGDBOGRGeometryConve
                   bool bHasZ, bool bHasM,
                   GByte*& pabyCur, GByte* pabyEnd );
 
+        // Coordinate arrays reused by AppendToFeatureBatch()
+        std::vector<int>                 anPartStart;
+        std::vector<double>              adfX;
+        std::vector<double>              adfY;
+        std::vector<double>              adfZ;
+        std::vector<double>              adfM;
+
+        bool                        ReadPartsCoordinates( GByte*& pabyCur,
+                                                          GByte* pabyEnd,
+                                                          GUInt32 nPoints,
+                                                          GUInt32 nParts,
+                                                          bool bHasZ,
+                                                          bool& bHasM );
+
     public:
        explicit                         FileGDBOGRGeometryConverterImpl(
                                             const FileGDBGeomField* poGeomField);
        virtual                         ~FileGDBOGRGeometryConverterImpl();
 
        virtual OGRGeometry*             GetAsGeometry(const OGRField* psField) override;
+       virtual bool                     AppendToFeatureBatch(const OGRField* psField,
+                                                             bool bPromoteToMulti,
+                                                             OGRFeatureBatch* poBatch) override;
 };
 
 /************************************************************************/
@@ -3167,6 +3184,216 @@ OGRGeometry* FileGDBOGRGeometryConverterImpl::GetAsGeometry(const OGRField* psFi
     return NULL;
 }
 
+/************************************************************************/
+/*                        ReadPartsCoordinates()                        */
+/*                                                                      */
+/*      Decode the coordinates of nParts parts (or of a single part if  */
+/*      nParts == 0) into adfX, adfY, adfZ and adfM. bHasM is reset if  */
+/*      the M array is absent, as in GetAsGeometry().                   */
+/************************************************************************/
+
+bool FileGDBOGRGeometryConverterImpl::ReadPartsCoordinates( GByte*& pabyCur,
+                                                            GByte* pabyEnd,
+                                                            GUInt32 nPoints,
+                                                            GUInt32 nParts,
+                                                            bool bHasZ,
+                                                            bool& bHasM )
+{
+    const GUInt32 nPartCount = nParts ? nParts : 1;
+    anPartStart.resize(nPartCount);
+    GUInt32 nStart = 0;
+    for( GUInt32 i = 0; i < nPartCount; i++ )
+    {
+        anPartStart[i] = static_cast<int>(nStart);
+        nStart += nParts ? panPointCount[i] : nPoints;
+    }
+
+    // The deltas run over all parts, so each array is read in one go.
+    adfX.resize(nPoints);
+    adfY.resize(nPoints);
+    GIntBig dx = 0;
+    GIntBig dy = 0;
+    XYArraySetter xySetter(&adfX[0], &adfY[0]);
+    if( !ReadXYArray<XYArraySetter>(xySetter, pabyCur, pabyEnd,
+                                    nPoints, dx, dy) )
+        return false;
+
+    if( bHasZ )
+    {
+        adfZ.resize(nPoints);
+        GIntBig dz = 0;
+        FileGDBArraySetter zSetter(&adfZ[0]);
+        if( !ReadZArray<FileGDBArraySetter>(zSetter, pabyCur, pabyEnd,
+                                            nPoints, dz) )
+            return false;
+    }
+
+    if( bHasM )
+    {
+        adfM.resize(nPoints);
+        GIntBig dm = 0;
+        for( GUInt32 i = 0; i < nPartCount; i++ )
+        {
+            const GUInt32 nPartPoints = nParts ? panPointCount[i] : nPoints;
+            // See GetAsGeometry() for the tolerance to absent M arrays.
+            if( pabyCur + nPartPoints > pabyEnd )
+            {
+                bHasM = false;
+                break;
+            }
+            FileGDBArraySetter mSetter(&adfM[0] + anPartStart[i]);
+            if( !ReadMArray<FileGDBArraySetter>(mSetter, pabyCur, pabyEnd,
+                                                nPartPoints, dm) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                        AppendToFeatureBatch()                        */
+/*                                                                      */
+/*      Write the geometry straight into the last feature of a batch,   */
+/*      with the same result as GetAsGeometry(). Returns false for      */
+/*      geometries that need an OGRGeometry to be built: multi-ring     */
+/*      polygons, whose rings are assigned to outer rings by            */
+/*      organizePolygons(), curves, multipatches and empty geometries.  */
+/************************************************************************/
+
+bool FileGDBOGRGeometryConverterImpl::AppendToFeatureBatch(
+                                                const OGRField* psField,
+                                                bool bPromoteToMulti,
+                                                OGRFeatureBatch* poBatch )
+{
+    // Decoding errors leave the geometry unset, as GetAsGeometry()
+    // returning NULL would.
+    const bool errorRetValue = true;
+    GByte* pabyCur = psField->Binary.paData;
+    GByte* pabyEnd = pabyCur + psField->Binary.nCount;
+    GUInt32 nGeomType, nPoints, nParts, nCurves;
+    OGRwkbGeometryType eType = wkbUnknown;
+
+    ReadVarUInt32NoCheck(pabyCur, nGeomType);
+
+    bool bHasZ = (nGeomType & EXT_SHAPE_Z_FLAG) != 0;
+    bool bHasM = (nGeomType & EXT_SHAPE_M_FLAG) != 0;
+    const GUInt32 nBaseType = nGeomType & 0xff;
+    switch( nBaseType )
+    {
+        case SHPT_NULL:
+            return true;
+
+        case SHPT_POINTZ:
+        case SHPT_POINTZM:
+        case SHPT_POINT:
+        case SHPT_POINTM:
+        case SHPT_GENERALPOINT:
+        {
+            if( nBaseType == SHPT_POINTZ || nBaseType == SHPT_POINTZM )
+                bHasZ = true;
+            if( nGeomType == SHPT_POINTM || nGeomType == SHPT_POINTZM )
+                bHasM = true;
+
+            GUIntBig x, y, z = 0, m = 0;
+            ReadVarUInt64NoCheck(pabyCur, x);
+            ReadVarUInt64NoCheck(pabyCur, y);
+            if( bHasZ )
+                ReadVarUInt64NoCheck(pabyCur, z);
+            if( bHasM )
+                ReadVarUInt64NoCheck(pabyCur, m);
+
+            const double dfX =
+                (x - 1) / poGeomField->GetXYScale() + poGeomField->GetXOrigin();
+            const double dfY =
+                (y - 1) / poGeomField->GetXYScale() + poGeomField->GetYOrigin();
+            const double dfZ =
+                (z - 1) / poGeomField->GetZScale() + poGeomField->GetZOrigin();
+            const double dfM =
+                (m - 1) / poGeomField->GetMScale() + poGeomField->GetMOrigin();
+            poBatch->SetGeomFieldFromParts(
+                0, OGR_GT_SetModifier(wkbPoint, bHasZ, bHasM),
+                1, NULL, 1, &dfX, &dfY, &dfZ, &dfM );
+            return true;
+        }
+
+        case SHPT_MULTIPOINTZM:
+        case SHPT_MULTIPOINTZ:
+        case SHPT_MULTIPOINT:
+        case SHPT_MULTIPOINTM:
+        {
+            if( nBaseType == SHPT_MULTIPOINTZ || nBaseType == SHPT_MULTIPOINTZM )
+                bHasZ = true;
+            if( nGeomType == SHPT_MULTIPOINTM || nGeomType == SHPT_MULTIPOINTZM )
+                bHasM = true;
+
+            returnErrorIf(!ReadVarUInt32(pabyCur, pabyEnd, nPoints) );
+            if( nPoints == 0 )
+                return false;
+            returnErrorIf(!SkipVarUInt(pabyCur, pabyEnd, 4) );
+            nParts = 0;
+            eType = wkbMultiPoint;
+            break;
+        }
+
+        case SHPT_ARCZ:
+        case SHPT_ARCZM:
+        case SHPT_ARC:
+        case SHPT_ARCM:
+        case SHPT_GENERALPOLYLINE:
+        {
+            if( nBaseType == SHPT_ARCZ || nBaseType == SHPT_ARCZM )
+                bHasZ = true;
+            if( nGeomType == SHPT_ARCM || nGeomType == SHPT_ARCZM )
+                bHasM = true;
+
+            returnErrorIf(!ReadPartDefs(pabyCur, pabyEnd, nPoints, nParts, nCurves,
+                              (nGeomType & EXT_SHAPE_CURVE_FLAG) != 0,
+                              false) );
+            if( nPoints == 0 || nParts == 0 || nCurves != 0 )
+                return false;
+            eType = (nParts > 1 || bPromoteToMulti) ? wkbMultiLineString :
+                                                      wkbLineString;
+            break;
+        }
+
+        case SHPT_POLYGONZ:
+        case SHPT_POLYGONZM:
+        case SHPT_POLYGON:
+        case SHPT_POLYGONM:
+        case SHPT_GENERALPOLYGON:
+        {
+            if( nBaseType == SHPT_POLYGONZ || nBaseType == SHPT_POLYGONZM )
+                bHasZ = true;
+            if( nGeomType == SHPT_POLYGONM || nGeomType == SHPT_POLYGONZM )
+                bHasM = true;
+
+            returnErrorIf(!ReadPartDefs(pabyCur, pabyEnd, nPoints, nParts, nCurves,
+                              (nGeomType & EXT_SHAPE_CURVE_FLAG) != 0,
+                              false) );
+            if( nPoints == 0 || nParts != 1 || nCurves != 0 )
+                return false;
+            eType = bPromoteToMulti ? wkbMultiPolygon : wkbPolygon;
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    if( !ReadPartsCoordinates(pabyCur, pabyEnd, nPoints, nParts, bHasZ, bHasM) )
+        return true;
+
+    poBatch->SetGeomFieldFromParts( 0, OGR_GT_SetModifier(eType, bHasZ, bHasM),
+                                    static_cast<int>(anPartStart.size()),
+                                    &anPartStart[0],
+                                    static_cast<int>(nPoints),
+                                    &adfX[0], &adfY[0],
+                                    bHasZ ? &adfZ[0] : NULL,
+                                    bHasM ? &adfM[0] : NULL );
+    return true;
+}
+
 /************************************************************************/
 /*                           BuildConverter()                           */
 /************************************************************************/
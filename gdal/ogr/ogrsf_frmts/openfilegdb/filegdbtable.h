@@ -32,6 +32,7 @@
 
 #include "ogr_core.h"
 #include "cpl_vsi.h"
+#include "ogr_feature.h"
 #include "ogr_geometry.h"
 
 #include <string>
@@ -383,6 +384,9 @@ class FileGDBOGRGeometryConverter
        virtual                            ~FileGDBOGRGeometryConverter() {}
 
        virtual OGRGeometry*                GetAsGeometry(const OGRField* psField) = 0;
+       virtual bool                        AppendToFeatureBatch(const OGRField* psField,
+                                                                bool bPromoteToMulti,
+                                                                OGRFeatureBatch* poBatch) = 0;
 
        static FileGDBOGRGeometryConverter* BuildConverter(const FileGDBGeomField* poGeomField);
        static OGRwkbGeometryType           GetGeometryTypeFromESRI(const char* pszESRIGeometyrType);
@@ -75,6 +75,7 @@ class OGROpenFileGDBLayer : public OGRLayer
     int               BuildLayerDefinition();
     int               BuildGeometryColumnGDBv10();
     OGRFeature       *GetCurrentFeature();
+    void              AppendCurrentFeatureToBatch( OGRFeatureBatch* poBatch );
 
     FileGDBOGRGeometryConverter* m_poGeomConverter;
 
@@ -127,6 +128,8 @@ public:
 
   virtual void        ResetReading() override;
   virtual OGRFeature* GetNextFeature() override;
+  virtual int         GetNextFeatureBatch( OGRFeatureBatch* poBatch,
+                                           int nMaxFeatures ) override;
   virtual OGRFeature* GetFeature( GIntBig nFeatureId ) override;
   virtual OGRErr      SetNextByIndex( GIntBig nIndex ) override;
 
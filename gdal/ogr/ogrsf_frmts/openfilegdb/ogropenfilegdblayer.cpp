@@ -1300,6 +1300,34 @@ OGRErr OGROpenFileGDBLayer::SetAttributeFilter( const char* pszFilter )
     return eErr;
 }
 
+/***********************************************************************/
+/*                       PromoteToMultiGeometry()                      */
+/*                                                                     */
+/*      FileGDB polygon and line layers are always multi-geometries.   */
+/***********************************************************************/
+
+static OGRGeometry* PromoteToMultiGeometry( OGRGeometry* poGeom )
+{
+    OGRwkbGeometryType eFlattenType = wkbFlatten(poGeom->getGeometryType());
+    if( eFlattenType == wkbPolygon )
+        poGeom = OGRGeometryFactory::forceToMultiPolygon(poGeom);
+    else if( eFlattenType == wkbCurvePolygon)
+    {
+        OGRMultiSurface* poMS = new OGRMultiSurface();
+        poMS->addGeometryDirectly( poGeom );
+        poGeom = poMS;
+    }
+    else if( eFlattenType == wkbLineString )
+        poGeom = OGRGeometryFactory::forceToMultiLineString(poGeom);
+    else if (eFlattenType == wkbCompoundCurve)
+    {
+        OGRMultiCurve* poMC = new OGRMultiCurve();
+        poMC->addGeometryDirectly( poGeom );
+        poGeom = poMC;
+    }
+    return poGeom;
+}
+
 /***********************************************************************/
 /*                         GetCurrentFeature()                         */
 /***********************************************************************/
@@ -1351,23 +1379,7 @@ OGRFeature* OGROpenFileGDBLayer::GetCurrentFeature()
                 OGRGeometry* poGeom = m_poGeomConverter->GetAsGeometry(psField);
                 if( poGeom != NULL )
                 {
-                    OGRwkbGeometryType eFlattenType = wkbFlatten(poGeom->getGeometryType());
-                    if( eFlattenType == wkbPolygon )
-                        poGeom = OGRGeometryFactory::forceToMultiPolygon(poGeom);
-                    else if( eFlattenType == wkbCurvePolygon)
-                    {
-                        OGRMultiSurface* poMS = new OGRMultiSurface();
-                        poMS->addGeometryDirectly( poGeom );
-                        poGeom = poMS;
-                    }
-                    else if( eFlattenType == wkbLineString )
-                        poGeom = OGRGeometryFactory::forceToMultiLineString(poGeom);
-                    else if (eFlattenType == wkbCompoundCurve)
-                    {
-                        OGRMultiCurve* poMC = new OGRMultiCurve();
-                        poMC->addGeometryDirectly( poGeom );
-                        poGeom = poMC;
-                    }
+                    poGeom = PromoteToMultiGeometry(poGeom);
 
                     poGeom->assignSpatialReference(
                         m_poFeatureDefn->GetGeomFieldDefn(0)->GetSpatialRef() );
@@ -1509,6 +1521,112 @@ OGRFeature* OGROpenFileGDBLayer::GetNextFeature()
     }
 }
 
+/***********************************************************************/
+/*                    AppendCurrentFeatureToBatch()                    */
+/*                                                                     */
+/*      Same as GetCurrentFeature() without spatial filter, but        */
+/*      append the current row directly to a feature batch.            */
+/***********************************************************************/
+
+void OGROpenFileGDBLayer::AppendCurrentFeatureToBatch( OGRFeatureBatch* poBatch )
+{
+    poBatch->AppendFeature( m_poLyrTable->GetCurRow() + 1 );
+
+    int iOGRIdx = 0;
+    for(int iGDBIdx=0;iGDBIdx<m_poLyrTable->GetFieldCount();iGDBIdx++)
+    {
+        if( iGDBIdx == m_iGeomFieldIdx )
+        {
+            if( m_poFeatureDefn->GetGeomFieldDefn(0)->IsIgnored() )
+                continue;
+
+            const OGRField* psField = m_poLyrTable->GetFieldValue(iGDBIdx);
+            if( psField != NULL &&
+                !m_poGeomConverter->AppendToFeatureBatch(psField, true,
+                                                         poBatch) )
+            {
+                OGRGeometry* poGeom = m_poGeomConverter->GetAsGeometry(psField);
+                if( poGeom != NULL )
+                {
+                    poGeom = PromoteToMultiGeometry(poGeom);
+                    poBatch->SetGeomField( 0, poGeom );
+                    delete poGeom;
+                }
+            }
+        }
+        else
+        {
+            if( !m_poFeatureDefn->GetFieldDefn(iOGRIdx)->IsIgnored() )
+            {
+                const OGRField* psField = m_poLyrTable->GetFieldValue(iGDBIdx);
+                if( psField != NULL )
+                {
+                    if( iGDBIdx == m_iFieldToReadAsBinary )
+                    {
+                        const char* pszVal =
+                            (const char*) psField->Binary.paData;
+                        poBatch->SetFieldString(iOGRIdx, pszVal,
+                                                strlen(pszVal));
+                    }
+                    else
+                        poBatch->SetFieldRaw(iOGRIdx, psField);
+                }
+            }
+            iOGRIdx ++;
+        }
+    }
+
+    if( m_poLyrTable->HasDeletedFeaturesListed() )
+    {
+        poBatch->SetFieldInteger(m_poFeatureDefn->GetFieldCount() - 1,
+                                 m_poLyrTable->IsCurRowDeleted());
+    }
+}
+
+/***********************************************************************/
+/*                       GetNextFeatureBatch()                         */
+/***********************************************************************/
+
+int OGROpenFileGDBLayer::GetNextFeatureBatch( OGRFeatureBatch* poBatch,
+                                              int nMaxFeatures )
+{
+    // Filtered reads use the logic of GetNextFeature().
+    if( m_poFilterGeom != NULL || m_poAttrQuery != NULL ||
+        m_nFilteredFeatureCount >= 0 || m_poIterator != NULL )
+    {
+        return OGRLayer::GetNextFeatureBatch(poBatch, nMaxFeatures);
+    }
+
+    if( !BuildLayerDefinition() )
+    {
+        poBatch->Reset(NULL);
+        return 0;
+    }
+
+    poBatch->Reset(m_poFeatureDefn);
+    if( m_bEOF )
+        return 0;
+
+    // Geometries are not inserted in the spatial index being built.
+    if( m_eSpatialIndexState == SPI_IN_BUILDING )
+        m_eSpatialIndexState = SPI_INVALID;
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures &&
+           m_iCurFeat < m_poLyrTable->GetTotalRecordCount() )
+    {
+        m_iCurFeat = m_poLyrTable->GetAndSelectNextNonEmptyRow(m_iCurFeat);
+        if( m_iCurFeat < 0 )
+        {
+            m_bEOF = TRUE;
+            break;
+        }
+        m_iCurFeat ++;
+        AppendCurrentFeatureToBatch(poBatch);
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /***********************************************************************/
 /*                          GetFeature()                               */
 /***********************************************************************/
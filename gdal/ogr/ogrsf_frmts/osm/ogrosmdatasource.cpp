@@ -2767,6 +2767,17 @@ int OGROSMDataSource::Open( const char * pszFilename,
     if( psParser == NULL )
         return FALSE;
 
+    const char* pszNumThreads = CSLFetchNameValueDef(
+        papszOpenOptionsIn, "NUM_THREADS",
+        CPLGetConfigOption("GDAL_NUM_THREADS", "1"));
+    const int nNumThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                                CPLGetNumCPUs() : atoi(pszNumThreads);
+    if( nNumThreads > 1 )
+    {
+        CPLDebug("OSM", "Using %d threads to decode PBF blobs", nNumThreads);
+        OSM_SetNumThreads(psParser, nNumThreads);
+    }
+
     if( CPLFetchBool(papszOpenOptionsIn, "INTERLEAVED_READING", false) )
         bInterleavedReading = TRUE;
 
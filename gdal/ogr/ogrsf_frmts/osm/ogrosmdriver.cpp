@@ -115,6 +115,7 @@ void RegisterOGROSM()
 "  <Option name='COMPRESS_NODES' type='boolean' description='Whether to compress nodes in temporary DB.' default='NO'/>"
 "  <Option name='MAX_TMPFILE_SIZE' type='int' description='Maximum size in MB of in-memory temporary file. If it exceeds that value, it will go to disk' default='100'/>"
 "  <Option name='INTERLEAVED_READING' type='boolean' description='Whether to enable interleaved reading.' default='NO'/>"
+"  <Option name='NUM_THREADS' type='string' description='Number of worker threads to decode PBF files. Can be set to ALL_CPUS' default='1'/>"
 "</OpenOptionList>" );
 
     poDriver->pfnOpen = OGROSMDriverOpen;
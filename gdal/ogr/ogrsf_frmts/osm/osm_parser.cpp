@@ -30,14 +30,18 @@
 #include "gpb.h"
 
 #include "cpl_conv.h"
+#include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 
 #ifdef HAVE_EXPAT
 #include "ogr_expat.h"
 #endif
 
 #include <algorithm>
+#include <new>
+#include <vector>
 
 CPL_CVSID("$Id$");
 
@@ -62,6 +66,8 @@ static void INIT_INFO( OSMInfo *sInfo )
     sInfo->pszUserSID = NULL;
 }
 
+struct OSMPBFJob;
+
 /************************************************************************/
 /*                            _OSMContext                               */
 /************************************************************************/
@@ -133,6 +139,19 @@ struct _OSMContext
     NotifyRelationFunc  pfnNotifyRelation;
     NotifyBoundsFunc    pfnNotifyBounds;
     void               *user_data;
+
+    /* Multi-threaded decoding of PBF blobs. The jobs form a ring buffer */
+    /* whose slots are delivered in file order. */
+    int                  nPBFThreads;
+    CPLWorkerThreadPool *poWTP;
+    OSMPBFJob           *pasJobs;
+    int                  nJobs;
+    int                  iFirstJob;
+    int                  nJobsInFlight;
+    bool                 bNoMoreBlobs;
+    OSMRetCode           eLastBlobRet;
+    CPLMutex            *hJobMutex;
+    CPLCond             *hJobCond;
 };
 
 /************************************************************************/
@@ -1606,6 +1625,521 @@ end_error:
     return false;
 }
 
+/************************************************************************/
+/*                            PBF_ReadBlob()                            */
+/************************************************************************/
+
+/* Read the next blob header and blob of the file into *ppabyBlob, which */
+/* is grown as needed. */
+static OSMRetCode PBF_ReadBlob( OSMContext* psCtxt,
+                                GByte** ppabyBlob,
+                                unsigned int* pnBlobSizeAllocated,
+                                unsigned int* pnBlobSize,
+                                BlobType* peType,
+                                GUIntBig* pnBytesRead )
+{
+    bool nRet = false;
+    GByte abyHeaderSize[4];
+    unsigned int nBlobSize = 0;
+    BlobType eType;
+
+    *pnBytesRead = 0;
+
+    if( VSIFReadL(abyHeaderSize, 4, 1, psCtxt->fp) != 1 )
+    {
+        return OSM_EOF;
+    }
+    const unsigned int nHeaderSize =
+        (abyHeaderSize[0] << 24) | (abyHeaderSize[1] << 16) |
+        (abyHeaderSize[2] << 8) | abyHeaderSize[3];
+
+    *pnBytesRead += 4;
+
+    /* printf("nHeaderSize = %d\n", nHeaderSize); */
+    if( nHeaderSize > 64 * 1024 )
+        GOTO_END_ERROR;
+    if( VSIFReadL(*ppabyBlob, 1, nHeaderSize, psCtxt->fp) != nHeaderSize )
+        GOTO_END_ERROR;
+
+    *pnBytesRead += nHeaderSize;
+
+    memset(*ppabyBlob + nHeaderSize, 0, EXTRA_BYTES);
+    nRet = ReadBlobHeader(*ppabyBlob, *ppabyBlob + nHeaderSize,
+                          &nBlobSize, &eType);
+    if( !nRet || eType == BLOB_UNKNOWN )
+        GOTO_END_ERROR;
+
+    if( nBlobSize > 64*1024*1024 )
+        GOTO_END_ERROR;
+    if( nBlobSize > *pnBlobSizeAllocated )
+    {
+        *pnBlobSizeAllocated =
+            std::max(*pnBlobSizeAllocated * 2, nBlobSize);
+        GByte* pabyBlobNew = static_cast<GByte *>(
+            VSI_REALLOC_VERBOSE(*ppabyBlob,
+                                *pnBlobSizeAllocated + EXTRA_BYTES));
+        if( pabyBlobNew == NULL )
+            GOTO_END_ERROR;
+        *ppabyBlob = pabyBlobNew;
+    }
+    if( VSIFReadL(*ppabyBlob, 1, nBlobSize, psCtxt->fp) != nBlobSize )
+        GOTO_END_ERROR;
+
+    *pnBytesRead += nBlobSize;
+
+    memset(*ppabyBlob + nBlobSize, 0, EXTRA_BYTES);
+
+    *pnBlobSize = nBlobSize;
+    *peType = eType;
+    return OSM_OK;
+
+end_error:
+
+    return OSM_ERROR;
+}
+
+/************************************************************************/
+/*                              OSMPBFJob                               */
+/************************************************************************/
+
+typedef enum
+{
+    PBF_EVENT_NODES,
+    PBF_EVENT_WAY,
+    PBF_EVENT_RELATION,
+    PBF_EVENT_BOUNDS
+} OSMPBFEventType;
+
+typedef struct
+{
+    OSMPBFEventType eType;
+    size_t          nFirst;
+    unsigned int    nCount;
+} OSMPBFEvent;
+
+/* A blob decoded by a worker thread. The notifications of the decoding */
+/* context are recorded, with copies of the objects, so that they can be */
+/* replayed on the caller thread in file order. Tags, node references and */
+/* members are stored in notification order, and the strings they point */
+/* to remain in the buffers of the decoding context. */
+struct OSMPBFJob
+{
+    OSMContext              *psMainCtxt;
+    OSMContext              *psCtxt;
+    unsigned int             nBlobSize;
+    BlobType                 eType;
+    GUIntBig                 nBytesRead;
+    bool                     bDone;
+    bool                     bOK;
+
+    std::vector<OSMPBFEvent> aoEvents;
+    std::vector<OSMNode>     asNodes;
+    std::vector<OSMWay>      asWays;
+    std::vector<OSMRelation> asRelations;
+    std::vector<OSMTag>      asTags;
+    std::vector<GIntBig>     anNodeRefs;
+    std::vector<OSMMember>   asMembers;
+    double                   adfBounds[4];
+
+    OSMPBFJob() : psMainCtxt(NULL), psCtxt(NULL), nBlobSize(0),
+                  eType(BLOB_UNKNOWN), nBytesRead(0), bDone(true), bOK(true)
+    {
+        adfBounds[0] = adfBounds[1] = adfBounds[2] = adfBounds[3] = 0.0;
+    }
+
+    void Clear()
+    {
+        aoEvents.clear();
+        asNodes.clear();
+        asWays.clear();
+        asRelations.clear();
+        asTags.clear();
+        anNodeRefs.clear();
+        asMembers.clear();
+    }
+};
+
+/************************************************************************/
+/*                          PBF_RecordNodes()                           */
+/************************************************************************/
+
+static void PBF_RecordNodes( unsigned int nNodes, OSMNode* pasNodes,
+                             OSMContext* /* psCtxt */, void* user_data )
+{
+    OSMPBFJob* psJob = static_cast<OSMPBFJob *>(user_data);
+    OSMPBFEvent sEvent;
+    sEvent.eType = PBF_EVENT_NODES;
+    sEvent.nFirst = psJob->asNodes.size();
+    sEvent.nCount = nNodes;
+    for( unsigned int i = 0; i < nNodes; i++ )
+    {
+        psJob->asNodes.push_back(pasNodes[i]);
+        psJob->asTags.insert(psJob->asTags.end(), pasNodes[i].pasTags,
+                             pasNodes[i].pasTags + pasNodes[i].nTags);
+    }
+    psJob->aoEvents.push_back(sEvent);
+}
+
+/************************************************************************/
+/*                           PBF_RecordWay()                            */
+/************************************************************************/
+
+static void PBF_RecordWay( OSMWay* psWay, OSMContext* /* psCtxt */,
+                           void* user_data )
+{
+    OSMPBFJob* psJob = static_cast<OSMPBFJob *>(user_data);
+    OSMPBFEvent sEvent;
+    sEvent.eType = PBF_EVENT_WAY;
+    sEvent.nFirst = psJob->asWays.size();
+    sEvent.nCount = 1;
+    psJob->asWays.push_back(*psWay);
+    psJob->asTags.insert(psJob->asTags.end(), psWay->pasTags,
+                         psWay->pasTags + psWay->nTags);
+    psJob->anNodeRefs.insert(psJob->anNodeRefs.end(), psWay->panNodeRefs,
+                             psWay->panNodeRefs + psWay->nRefs);
+    psJob->aoEvents.push_back(sEvent);
+}
+
+/************************************************************************/
+/*                         PBF_RecordRelation()                         */
+/************************************************************************/
+
+static void PBF_RecordRelation( OSMRelation* psRelation,
+                                OSMContext* /* psCtxt */, void* user_data )
+{
+    OSMPBFJob* psJob = static_cast<OSMPBFJob *>(user_data);
+    OSMPBFEvent sEvent;
+    sEvent.eType = PBF_EVENT_RELATION;
+    sEvent.nFirst = psJob->asRelations.size();
+    sEvent.nCount = 1;
+    psJob->asRelations.push_back(*psRelation);
+    psJob->asTags.insert(psJob->asTags.end(), psRelation->pasTags,
+                         psRelation->pasTags + psRelation->nTags);
+    psJob->asMembers.insert(psJob->asMembers.end(), psRelation->pasMembers,
+                            psRelation->pasMembers + psRelation->nMembers);
+    psJob->aoEvents.push_back(sEvent);
+}
+
+/************************************************************************/
+/*                          PBF_RecordBounds()                          */
+/************************************************************************/
+
+static void PBF_RecordBounds( double dfXMin, double dfYMin,
+                              double dfXMax, double dfYMax,
+                              OSMContext* /* psCtxt */, void* user_data )
+{
+    OSMPBFJob* psJob = static_cast<OSMPBFJob *>(user_data);
+    OSMPBFEvent sEvent;
+    sEvent.eType = PBF_EVENT_BOUNDS;
+    sEvent.nFirst = 0;
+    sEvent.nCount = 1;
+    psJob->adfBounds[0] = dfXMin;
+    psJob->adfBounds[1] = dfYMin;
+    psJob->adfBounds[2] = dfXMax;
+    psJob->adfBounds[3] = dfYMax;
+    psJob->aoEvents.push_back(sEvent);
+}
+
+/************************************************************************/
+/*                           PBF_DecodeJob()                            */
+/************************************************************************/
+
+static void PBF_DecodeJob( void* pData )
+{
+    OSMPBFJob* psJob = static_cast<OSMPBFJob *>(pData);
+    OSMContext* psCtxt = psJob->psCtxt;
+    bool bOK = false;
+    try
+    {
+        bOK = ReadBlob(psCtxt->pabyBlob, psJob->nBlobSize, psJob->eType,
+                       psCtxt);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Out of memory while decoding PBF blob");
+    }
+
+    OSMContext* psMainCtxt = psJob->psMainCtxt;
+    CPLAcquireMutex(psMainCtxt->hJobMutex, 1000.0);
+    psJob->bOK = bOK;
+    psJob->bDone = true;
+    CPLCondBroadcast(psMainCtxt->hJobCond);
+    CPLReleaseMutex(psMainCtxt->hJobMutex);
+}
+
+/************************************************************************/
+/*                           PBF_DeliverJob()                           */
+/************************************************************************/
+
+/* Replay on the caller thread the notifications recorded by a job */
+static void PBF_DeliverJob( OSMContext* psCtxt, OSMPBFJob* psJob )
+{
+    OSMTag* pasTags = psJob->asTags.empty() ? NULL : &psJob->asTags[0];
+    GIntBig* panNodeRefs =
+        psJob->anNodeRefs.empty() ? NULL : &psJob->anNodeRefs[0];
+    OSMMember* pasMembers =
+        psJob->asMembers.empty() ? NULL : &psJob->asMembers[0];
+
+    for( size_t iEvent = 0; iEvent < psJob->aoEvents.size(); iEvent++ )
+    {
+        const OSMPBFEvent& sEvent = psJob->aoEvents[iEvent];
+        switch( sEvent.eType )
+        {
+            case PBF_EVENT_NODES:
+            {
+                OSMNode* pasNodes = &psJob->asNodes[sEvent.nFirst];
+                for( unsigned int i = 0; i < sEvent.nCount; i++ )
+                {
+                    pasNodes[i].pasTags = pasTags;
+                    pasTags += pasNodes[i].nTags;
+                }
+                psCtxt->pfnNotifyNodes(sEvent.nCount, pasNodes,
+                                       psCtxt, psCtxt->user_data);
+                break;
+            }
+
+            case PBF_EVENT_WAY:
+            {
+                OSMWay* psWay = &psJob->asWays[sEvent.nFirst];
+                psWay->pasTags = pasTags;
+                pasTags += psWay->nTags;
+                psWay->panNodeRefs = panNodeRefs;
+                panNodeRefs += psWay->nRefs;
+                psCtxt->pfnNotifyWay(psWay, psCtxt, psCtxt->user_data);
+                break;
+            }
+
+            case PBF_EVENT_RELATION:
+            {
+                OSMRelation* psRelation = &psJob->asRelations[sEvent.nFirst];
+                psRelation->pasTags = pasTags;
+                pasTags += psRelation->nTags;
+                psRelation->pasMembers = pasMembers;
+                pasMembers += psRelation->nMembers;
+                psCtxt->pfnNotifyRelation(psRelation, psCtxt,
+                                          psCtxt->user_data);
+                break;
+            }
+
+            case PBF_EVENT_BOUNDS:
+            {
+                psCtxt->pfnNotifyBounds(psJob->adfBounds[0],
+                                        psJob->adfBounds[1],
+                                        psJob->adfBounds[2],
+                                        psJob->adfBounds[3],
+                                        psCtxt, psCtxt->user_data);
+                break;
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                       PBF_FreeDecodingContext()                      */
+/************************************************************************/
+
+static void PBF_FreeDecodingContext( OSMContext* psCtxt )
+{
+    if( psCtxt == NULL )
+        return;
+    VSIFree(psCtxt->pabyBlob);
+    VSIFree(psCtxt->pabyUncompressed);
+    VSIFree(psCtxt->panStrOff);
+    VSIFree(psCtxt->pasNodes);
+    VSIFree(psCtxt->pasTags);
+    VSIFree(psCtxt->pasMembers);
+    VSIFree(psCtxt->panNodeRefs);
+    VSIFree(psCtxt);
+}
+
+/************************************************************************/
+/*                           PBF_WaitJobs()                             */
+/************************************************************************/
+
+/* Wait for the jobs in flight and forget about them */
+static void PBF_WaitJobs( OSMContext* psCtxt )
+{
+    if( psCtxt->poWTP == NULL )
+        return;
+    psCtxt->poWTP->WaitCompletion();
+    for( int i = 0; i < psCtxt->nJobs; i++ )
+        psCtxt->pasJobs[i].Clear();
+    psCtxt->iFirstJob = 0;
+    psCtxt->nJobsInFlight = 0;
+    psCtxt->bNoMoreBlobs = false;
+    psCtxt->eLastBlobRet = OSM_OK;
+}
+
+/************************************************************************/
+/*                          PBF_SetupThreads()                          */
+/************************************************************************/
+
+static bool PBF_SetupThreads( OSMContext* psCtxt )
+{
+    psCtxt->poWTP = new CPLWorkerThreadPool();
+    if( !psCtxt->poWTP->Setup(psCtxt->nPBFThreads, NULL, NULL) )
+    {
+        delete psCtxt->poWTP;
+        psCtxt->poWTP = NULL;
+        return false;
+    }
+
+    // Two blobs per thread so that reading the next blobs and replaying
+    // the decoded ones can overlap with decoding.
+    psCtxt->nJobs = 2 * psCtxt->nPBFThreads;
+    psCtxt->pasJobs = new OSMPBFJob[psCtxt->nJobs];
+    for( int i = 0; i < psCtxt->nJobs; i++ )
+    {
+        OSMContext* psJobCtxt = static_cast<OSMContext *>(
+            VSI_CALLOC_VERBOSE(1, sizeof(OSMContext)));
+        if( psJobCtxt == NULL )
+            return false;
+        psJobCtxt->bPBF = true;
+        psJobCtxt->pfnNotifyNodes = PBF_RecordNodes;
+        psJobCtxt->pfnNotifyWay = PBF_RecordWay;
+        psJobCtxt->pfnNotifyRelation = PBF_RecordRelation;
+        psJobCtxt->pfnNotifyBounds = PBF_RecordBounds;
+        psJobCtxt->user_data = &psCtxt->pasJobs[i];
+        psJobCtxt->nBlobSizeAllocated = 64 * 1024 + EXTRA_BYTES;
+        psJobCtxt->pabyBlob = static_cast<GByte *>(
+            VSI_MALLOC_VERBOSE(psJobCtxt->nBlobSizeAllocated));
+        psCtxt->pasJobs[i].psMainCtxt = psCtxt;
+        psCtxt->pasJobs[i].psCtxt = psJobCtxt;
+        if( psJobCtxt->pabyBlob == NULL )
+            return false;
+    }
+
+    psCtxt->hJobMutex = CPLCreateMutex();
+    CPLReleaseMutex(psCtxt->hJobMutex);
+    psCtxt->hJobCond = CPLCreateCond();
+    return psCtxt->hJobCond != NULL;
+}
+
+/************************************************************************/
+/*                         PBF_ReleaseThreads()                         */
+/************************************************************************/
+
+static void PBF_ReleaseThreads( OSMContext* psCtxt )
+{
+    if( psCtxt->poWTP )
+        psCtxt->poWTP->WaitCompletion();
+    delete psCtxt->poWTP;
+    psCtxt->poWTP = NULL;
+    for( int i = 0; i < psCtxt->nJobs; i++ )
+        PBF_FreeDecodingContext(psCtxt->pasJobs[i].psCtxt);
+    delete[] psCtxt->pasJobs;
+    psCtxt->pasJobs = NULL;
+    psCtxt->nJobs = 0;
+    if( psCtxt->hJobCond )
+        CPLDestroyCond(psCtxt->hJobCond);
+    psCtxt->hJobCond = NULL;
+    if( psCtxt->hJobMutex )
+        CPLDestroyMutex(psCtxt->hJobMutex);
+    psCtxt->hJobMutex = NULL;
+}
+
+/************************************************************************/
+/*                        PBF_ProcessBlockMT()                          */
+/************************************************************************/
+
+/* The caller thread reads the blobs in file order and submits them to */
+/* the worker threads, which inflate and decode them. The decoded blobs */
+/* are then delivered one per call, in file order, so that the */
+/* notification callbacks see exactly the same sequence as with */
+/* single-threaded decoding. */
+static OSMRetCode PBF_ProcessBlockMT( OSMContext* psCtxt )
+{
+    /* Keep all the job slots busy */
+    while( !psCtxt->bNoMoreBlobs &&
+           psCtxt->nJobsInFlight < psCtxt->nJobs )
+    {
+        OSMPBFJob* psJob = &psCtxt->pasJobs[
+            (psCtxt->iFirstJob + psCtxt->nJobsInFlight) % psCtxt->nJobs];
+        psJob->Clear();
+        OSMRetCode eRet = PBF_ReadBlob(psCtxt,
+                                       &psJob->psCtxt->pabyBlob,
+                                       &psJob->psCtxt->nBlobSizeAllocated,
+                                       &psJob->nBlobSize, &psJob->eType,
+                                       &psJob->nBytesRead);
+        if( eRet != OSM_OK )
+        {
+            psCtxt->nBytesRead += psJob->nBytesRead;
+            psCtxt->bNoMoreBlobs = true;
+            psCtxt->eLastBlobRet = eRet;
+            break;
+        }
+        psJob->bDone = false;
+        psCtxt->nJobsInFlight++;
+        psCtxt->poWTP->SubmitJob(PBF_DecodeJob, psJob);
+    }
+
+    if( psCtxt->nJobsInFlight == 0 )
+        return psCtxt->eLastBlobRet;
+
+    /* Wait for the oldest blob */
+    OSMPBFJob* psJob = &psCtxt->pasJobs[psCtxt->iFirstJob];
+    CPLAcquireMutex(psCtxt->hJobMutex, 1000.0);
+    while( !psJob->bDone )
+        CPLCondWait(psCtxt->hJobCond, psCtxt->hJobMutex);
+    CPLReleaseMutex(psCtxt->hJobMutex);
+
+    psCtxt->iFirstJob = (psCtxt->iFirstJob + 1) % psCtxt->nJobs;
+    psCtxt->nJobsInFlight--;
+    psCtxt->nBytesRead += psJob->nBytesRead;
+
+    if( !psJob->bOK )
+    {
+        psCtxt->poWTP->WaitCompletion();
+        psCtxt->nJobsInFlight = 0;
+        psCtxt->bNoMoreBlobs = true;
+        psCtxt->eLastBlobRet = OSM_ERROR;
+        return OSM_ERROR;
+    }
+
+    PBF_DeliverJob(psCtxt, psJob);
+    psJob->Clear();
+
+    return OSM_OK;
+}
+
+/************************************************************************/
+/*                          PBF_ProcessBlock()                          */
+/************************************************************************/
+
+static OSMRetCode PBF_ProcessBlock(OSMContext* psCtxt)
+{
+    if( psCtxt->nPBFThreads > 1 )
+    {
+        if( psCtxt->poWTP == NULL && !PBF_SetupThreads(psCtxt) )
+        {
+            CPLDebug("OSM", "Cannot setup worker threads. "
+                     "Decoding PBF blobs in the calling thread");
+            PBF_ReleaseThreads(psCtxt);
+            psCtxt->nPBFThreads = 1;
+        }
+        else
+        {
+            return PBF_ProcessBlockMT(psCtxt);
+        }
+    }
+
+    unsigned int nBlobSize = 0;
+    BlobType eType = BLOB_UNKNOWN;
+    GUIntBig nBytesRead = 0;
+    OSMRetCode eRet = PBF_ReadBlob(psCtxt, &psCtxt->pabyBlob,
+                                   &psCtxt->nBlobSizeAllocated,
+                                   &nBlobSize, &eType, &nBytesRead);
+    psCtxt->nBytesRead += nBytesRead;
+    if( eRet != OSM_OK )
+        return eRet;
+
+    if( !ReadBlob(psCtxt->pabyBlob, nBlobSize, eType, psCtxt) )
+        return OSM_ERROR;
+
+    return OSM_OK;
+}
+
 /************************************************************************/
 /*                        EmptyNotifyNodesFunc()                        */
 /************************************************************************/
@@ -2242,6 +2776,7 @@ OSMContext* OSM_Open( const char* pszFilename,
     }
     memset(psCtxt, 0, sizeof(OSMContext));
     psCtxt->bPBF = bPBF;
+    psCtxt->nPBFThreads = 1;
     psCtxt->fp = fp;
     psCtxt->pfnNotifyNodes = pfnNotifyNodes;
     if( pfnNotifyNodes == NULL )
@@ -2335,6 +2870,8 @@ void OSM_Close(OSMContext* psCtxt)
     }
 #endif
 
+    PBF_ReleaseThreads(psCtxt);
+
     VSIFree(psCtxt->pabyBlob);
     VSIFree(psCtxt->pabyUncompressed);
     VSIFree(psCtxt->panStrOff);
@@ -2352,6 +2889,8 @@ void OSM_Close(OSMContext* psCtxt)
 
 void OSM_ResetReading( OSMContext* psCtxt )
 {
+    PBF_WaitJobs(psCtxt);
+
     VSIFSeekL(psCtxt->fp, 0, SEEK_SET);
 
     psCtxt->nBytesRead = 0;
@@ -2384,72 +2923,6 @@ void OSM_ResetReading( OSMContext* psCtxt )
 /*                          OSM_ProcessBlock()                          */
 /************************************************************************/
 
-static OSMRetCode PBF_ProcessBlock(OSMContext* psCtxt)
-{
-    bool nRet = false;
-    GByte abyHeaderSize[4];
-    unsigned int nBlobSize = 0;
-    BlobType eType;
-
-    if( VSIFReadL(abyHeaderSize, 4, 1, psCtxt->fp) != 1 )
-    {
-        return OSM_EOF;
-    }
-    const unsigned int nHeaderSize =
-        (abyHeaderSize[0] << 24) | (abyHeaderSize[1] << 16) |
-        (abyHeaderSize[2] << 8) | abyHeaderSize[3];
-
-    psCtxt->nBytesRead += 4;
-
-    /* printf("nHeaderSize = %d\n", nHeaderSize); */
-    if( nHeaderSize > 64 * 1024 )
-        GOTO_END_ERROR;
-    if( VSIFReadL(psCtxt->pabyBlob, 1, nHeaderSize, psCtxt->fp) != nHeaderSize )
-        GOTO_END_ERROR;
-
-    psCtxt->nBytesRead += nHeaderSize;
-
-    memset(psCtxt->pabyBlob + nHeaderSize, 0, EXTRA_BYTES);
-    nRet = ReadBlobHeader(psCtxt->pabyBlob, psCtxt->pabyBlob + nHeaderSize,
-                          &nBlobSize, &eType);
-    if( !nRet || eType == BLOB_UNKNOWN )
-        GOTO_END_ERROR;
-
-    if( nBlobSize > 64*1024*1024 )
-        GOTO_END_ERROR;
-    if( nBlobSize > psCtxt->nBlobSizeAllocated )
-    {
-        psCtxt->nBlobSizeAllocated =
-            std::max(psCtxt->nBlobSizeAllocated * 2, nBlobSize);
-        GByte* pabyBlobNew = static_cast<GByte *>(
-            VSI_REALLOC_VERBOSE(psCtxt->pabyBlob,
-                                psCtxt->nBlobSizeAllocated + EXTRA_BYTES));
-        if( pabyBlobNew == NULL )
-            GOTO_END_ERROR;
-        psCtxt->pabyBlob = pabyBlobNew;
-    }
-    if( VSIFReadL(psCtxt->pabyBlob, 1, nBlobSize, psCtxt->fp) != nBlobSize )
-        GOTO_END_ERROR;
-
-    psCtxt->nBytesRead += nBlobSize;
-
-    memset(psCtxt->pabyBlob + nBlobSize, 0, EXTRA_BYTES);
-    nRet = ReadBlob(psCtxt->pabyBlob, nBlobSize, eType,
-                    psCtxt);
-    if( !nRet )
-        GOTO_END_ERROR;
-
-    return OSM_OK;
-
-end_error:
-
-    return OSM_ERROR;
-}
-
-/************************************************************************/
-/*                          OSM_ProcessBlock()                          */
-/************************************************************************/
-
 OSMRetCode OSM_ProcessBlock( OSMContext* psCtxt )
 {
 #ifdef HAVE_EXPAT
@@ -2462,6 +2935,17 @@ OSMRetCode OSM_ProcessBlock( OSMContext* psCtxt )
 #endif
 }
 
+/************************************************************************/
+/*                         OSM_SetNumThreads()                          */
+/************************************************************************/
+
+void OSM_SetNumThreads( OSMContext* psCtxt, int nThreads )
+{
+    if( !psCtxt->bPBF || psCtxt->poWTP != NULL )
+        return;
+    psCtxt->nPBFThreads = std::max(1, std::min(nThreads, 128));
+}
+
 /************************************************************************/
 /*                          OSM_GetBytesRead()                          */
 /************************************************************************/
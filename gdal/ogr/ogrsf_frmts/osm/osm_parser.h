@@ -122,6 +122,9 @@ OSMContext* OSM_Open( const char* pszFilename,
 
 GUIntBig OSM_GetBytesRead( OSMContext* psOSMContext );
 
+/* Number of worker threads used to inflate and decode PBF blobs */
+void OSM_SetNumThreads( OSMContext* psOSMContext, int nThreads );
+
 void OSM_ResetReading( OSMContext* psOSMContext );
 
 OSMRetCode OSM_ProcessBlock( OSMContext* psOSMContext );
@@ -50,6 +50,10 @@
 OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                                OGRFeatureDefn * poDefn, int iShape,
                                SHPObject *psShape, const char *pszSHPEncoding );
+OGRErr SHPReadOGRFeatureBatch( SHPHandle hSHP, DBFHandle hDBF,
+                               OGRFeatureDefn * poDefn, int iShape,
+                               const char *pszSHPEncoding,
+                               OGRFeatureBatch *poBatch );
 OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape );
 OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
                                        SHPHandle hSHP, DBFHandle hDBF,
@@ -207,6 +211,8 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
 
     void                ResetReading() override;
     OGRFeature *        GetNextFeature() override;
+    int                 GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures ) override;
     virtual OGRErr      SetNextByIndex( GIntBig nIndex ) override;
 
     OGRFeature         *GetFeature( GIntBig nFeatureId ) override;
@@ -870,6 +870,50 @@ OGRFeature *OGRShapeLayer::GetNextFeature()
     }
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRShapeLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                        int nMaxFeatures )
+
+{
+    // Filtered reads go through OGRFeature objects, as in GetNextFeature().
+    if( m_poAttrQuery != NULL || m_poFilterGeom != NULL )
+        return OGRLayer::GetNextFeatureBatch( poBatch, nMaxFeatures );
+
+    poBatch->Reset( poFeatureDefn );
+
+    if( !TouchLayer() )
+        return 0;
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures &&
+           iNextShapeId < nTotalShapeCount )
+    {
+        if( hDBF )
+        {
+            if( DBFIsRecordDeleted( hDBF, iNextShapeId ) )
+            {
+                iNextShapeId++;
+                continue;
+            }
+            if( VSIFEofL(VSI_SHP_GetVSIL(hDBF->fp)) )
+                break;  // I/O error.
+        }
+
+        const int iShape = iNextShapeId;
+        iNextShapeId++;
+
+        if( SHPReadOGRFeatureBatch( hSHP, hDBF, poFeatureDefn, iShape,
+                                    osEncoding, poBatch ) == OGRERR_NONE )
+        {
+            m_nFeaturesRead++;
+        }
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                             GetFeature()                             */
 /************************************************************************/
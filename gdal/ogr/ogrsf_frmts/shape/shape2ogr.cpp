@@ -1174,6 +1174,64 @@ OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
     return poDefn;
 }
 
+/************************************************************************/
+/*                     SHPSetOGRGeometryDimension()                     */
+/*                                                                      */
+/*      Set/unset the Z and M flags of a geometry read from the         */
+/*      shapefile to match the layer geometry type.                     */
+/************************************************************************/
+
+static void SHPSetOGRGeometryDimension( OGRGeometry* poGeometry,
+                                        OGRwkbGeometryType eMyGeomType )
+{
+    if( eMyGeomType == wkbUnknown )
+        return;
+
+    OGRwkbGeometryType eGeomInType = poGeometry->getGeometryType();
+    if( wkbHasZ(eMyGeomType) && !wkbHasZ(eGeomInType) )
+    {
+        poGeometry->set3D(TRUE);
+    }
+    else if( !wkbHasZ(eMyGeomType) && wkbHasZ(eGeomInType) )
+    {
+        poGeometry->set3D(FALSE);
+    }
+    if( wkbHasM(eMyGeomType) && !wkbHasM(eGeomInType) )
+    {
+        poGeometry->setMeasured(TRUE);
+    }
+    else if( !wkbHasM(eMyGeomType) && wkbHasM(eGeomInType) )
+    {
+        poGeometry->setMeasured(FALSE);
+    }
+}
+
+/************************************************************************/
+/*                          SHPParseDBFDate()                           */
+/*                                                                      */
+/*      Parse a DBF date, either as YYYYMMDD or MM/DD/YYYY.             */
+/************************************************************************/
+
+static void SHPParseDBFDate( const char* pszDateValue, OGRField* psField )
+{
+    memset( psField, 0, sizeof(OGRField) );
+
+    if( strlen(pszDateValue) >= 10 &&
+        pszDateValue[2] == '/' && pszDateValue[5] == '/' )
+    {
+        psField->Date.Month = static_cast<GByte>(atoi(pszDateValue + 0));
+        psField->Date.Day   = static_cast<GByte>(atoi(pszDateValue + 3));
+        psField->Date.Year  = static_cast<GInt16>(atoi(pszDateValue + 6));
+    }
+    else
+    {
+        const int nFullDate = atoi(pszDateValue);
+        psField->Date.Year = static_cast<GInt16>(nFullDate / 10000);
+        psField->Date.Month = static_cast<GByte>((nFullDate / 100) % 100);
+        psField->Date.Day = static_cast<GByte>(nFullDate % 100);
+    }
+}
+
 /************************************************************************/
 /*                         SHPReadOGRFeature()                          */
 /************************************************************************/
@@ -1226,31 +1284,9 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
 
             if( poGeometry )
             {
-                // Set/unset flags.
-                const OGRwkbGeometryType eMyGeomType =
-                    poFeature->GetDefnRef()->GetGeomFieldDefn(0)->GetType();
-
-                if( eMyGeomType != wkbUnknown )
-                {
-                    OGRwkbGeometryType eGeomInType =
-                        poGeometry->getGeometryType();
-                    if( wkbHasZ(eMyGeomType) && !wkbHasZ(eGeomInType) )
-                    {
-                        poGeometry->set3D(TRUE);
-                    }
-                    else if( !wkbHasZ(eMyGeomType) && wkbHasZ(eGeomInType) )
-                    {
-                        poGeometry->set3D(FALSE);
-                    }
-                    if( wkbHasM(eMyGeomType) && !wkbHasM(eGeomInType) )
-                    {
-                        poGeometry->setMeasured(TRUE);
-                    }
-                    else if( !wkbHasM(eMyGeomType) && wkbHasM(eGeomInType) )
-                    {
-                        poGeometry->setMeasured(FALSE);
-                    }
-                }
+                SHPSetOGRGeometryDimension(
+                    poGeometry,
+                    poFeature->GetDefnRef()->GetGeomFieldDefn(0)->GetType() );
             }
 
             poFeature->SetGeometryDirectly( poGeometry );
@@ -1318,36 +1354,239 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                   continue;
 
               OGRField sFld;
-              memset( &sFld, 0, sizeof(sFld) );
+              SHPParseDBFDate( pszDateValue, &sFld );
+              poFeature->SetField( iField, &sFld );
+          }
+          break;
+
+          default:
+            CPLAssert( false );
+        }
+    }
+
+    if( poFeature != NULL )
+        poFeature->SetFID( iShape );
+
+    return poFeature;
+}
+
+/************************************************************************/
+/*                       SHPAppendObjectToBatch()                       */
+/*                                                                      */
+/*      Write the geometry of a shape straight into the last feature    */
+/*      of a batch, with the same result as SHPReadOGRObject()          */
+/*      followed by SHPSetOGRGeometryDimension(). Returns false for     */
+/*      shapes that need an OGRGeometry to be built.                    */
+/************************************************************************/
+
+static bool SHPAppendObjectToBatch( SHPObject *psShape,
+                                    OGRwkbGeometryType eLayerGeomType,
+                                    OGRFeatureBatch *poBatch )
+{
+    const int nSHPType = psShape->nSHPType;
+    OGRwkbGeometryType eType = wkbUnknown;
+    bool bHasZ = false;
+    bool bHasM = false;
+    switch( nSHPType )
+    {
+        case SHPT_NULL:
+            return true;
+
+        case SHPT_POINT:
+        case SHPT_POINTM:
+        case SHPT_POINTZ:
+            if( psShape->nVertices < 1 )
+                return false;
+            eType = wkbPoint;
+            bHasZ = nSHPType == SHPT_POINTZ;
+            bHasM = nSHPType == SHPT_POINTM ||
+                    (bHasZ && psShape->bMeasureIsUsed);
+            break;
+
+        case SHPT_MULTIPOINT:
+        case SHPT_MULTIPOINTM:
+        case SHPT_MULTIPOINTZ:
+            if( psShape->nVertices == 0 )
+                return true;
+            eType = wkbMultiPoint;
+            bHasZ = nSHPType == SHPT_MULTIPOINTZ;
+            bHasM = nSHPType == SHPT_MULTIPOINTM ||
+                    (bHasZ && psShape->padfM != NULL);
+            break;
+
+        case SHPT_ARC:
+        case SHPT_ARCM:
+        case SHPT_ARCZ:
+        case SHPT_POLYGON:
+        case SHPT_POLYGONM:
+        case SHPT_POLYGONZ:
+        {
+            const bool bPolygon = nSHPType == SHPT_POLYGON ||
+                                  nSHPType == SHPT_POLYGONM ||
+                                  nSHPType == SHPT_POLYGONZ;
+            if( psShape->nParts == 0 )
+                return true;
+            if( psShape->nVertices == 0 || (bPolygon && psShape->nParts > 1) )
+                return false;
+            eType = bPolygon ? wkbPolygon :
+                    psShape->nParts == 1 ? wkbLineString : wkbMultiLineString;
+            bHasZ = nSHPType == SHPT_ARCZ || nSHPType == SHPT_POLYGONZ;
+            bHasM = nSHPType != SHPT_ARC && nSHPType != SHPT_POLYGON &&
+                    psShape->padfM != NULL;
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    // Dimensions forced by the layer geometry type are filled with zeroes.
+    const bool bNativeZ = bHasZ;
+    const bool bNativeM = bHasM;
+    if( eLayerGeomType != wkbUnknown )
+    {
+        bHasZ = CPL_TO_BOOL(wkbHasZ(eLayerGeomType));
+        bHasM = CPL_TO_BOOL(wkbHasM(eLayerGeomType));
+    }
+    eType = OGR_GT_SetModifier( eType, bHasZ, bHasM );
+
+    poBatch->SetGeomFieldFromParts( 0, eType,
+                                    psShape->nParts, psShape->panPartStart,
+                                    psShape->nVertices,
+                                    psShape->padfX, psShape->padfY,
+                                    bNativeZ ? psShape->padfZ : NULL,
+                                    bNativeM ? psShape->padfM : NULL );
+    return true;
+}
+
+/************************************************************************/
+/*                       SHPReadOGRFeatureBatch()                       */
+/*                                                                      */
+/*      Append a shape and its attributes to a feature batch, without   */
+/*      going through an OGRFeature.                                    */
+/************************************************************************/
+
+OGRErr SHPReadOGRFeatureBatch( SHPHandle hSHP, DBFHandle hDBF,
+                               OGRFeatureDefn * poDefn, int iShape,
+                               const char *pszSHPEncoding,
+                               OGRFeatureBatch *poBatch )
+
+{
+    if( iShape < 0
+        || (hSHP != NULL && iShape >= hSHP->nRecords)
+        || (hDBF != NULL && iShape >= hDBF->nRecords) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Attempt to read shape with feature id (%d) out of available"
+                  " range.", iShape );
+        return OGRERR_FAILURE;
+    }
+
+    poBatch->AppendFeature( iShape );
+
+    OGRErr eErr = OGRERR_NONE;
+    if( hSHP != NULL && !poDefn->IsGeometryIgnored() )
+    {
+        const OGRwkbGeometryType eLayerGeomType =
+            poDefn->GetGeomFieldDefn(0)->GetType();
+        SHPObject *psShape = SHPReadObject( hSHP, iShape );
+        if( psShape != NULL &&
+            !SHPAppendObjectToBatch( psShape, eLayerGeomType, poBatch ) )
+        {
+            // Multi-ring polygons need their rings to be assigned to
+            // outer rings by organizePolygons(), and multipatches to be
+            // triangulated, so they still go through an OGRGeometry.
+            OGRGeometry* poGeometry =
+                SHPReadOGRObject( hSHP, iShape, psShape );
+            if( poGeometry )
+            {
+                SHPSetOGRGeometryDimension( poGeometry, eLayerGeomType );
+                eErr = poBatch->SetGeomField( 0, poGeometry );
+                delete poGeometry;
+            }
+        }
+        else
+        {
+            SHPDestroyObject( psShape );
+        }
+    }
 
-              if( strlen(pszDateValue) >= 10 &&
-                  pszDateValue[2] == '/' && pszDateValue[5] == '/' )
+    for( int iField = 0;
+         hDBF != NULL && iField < poDefn->GetFieldCount();
+         iField++ )
+    {
+        OGRFieldDefn * const poFieldDefn = poDefn->GetFieldDefn(iField);
+        if( poFieldDefn->IsIgnored() )
+            continue;
+
+        const OGRFieldType eType = poFieldDefn->GetType();
+        if( eType != OFTString && DBFIsAttributeNULL( hDBF, iShape, iField ) )
+            continue;
+
+        const char * const pszFieldVal =
+            DBFReadStringAttribute( hDBF, iShape, iField );
+        if( pszFieldVal == NULL )
+            continue;
+
+        switch( eType )
+        {
+          case OFTString:
+          {
+              if( pszFieldVal[0] == '\0' )
+                  break;
+              if( pszSHPEncoding[0] != '\0' )
               {
-                  sFld.Date.Month = static_cast<GByte>(atoi(pszDateValue + 0));
-                  sFld.Date.Day   = static_cast<GByte>(atoi(pszDateValue + 3));
-                  sFld.Date.Year  = static_cast<GInt16>(atoi(pszDateValue + 6));
+                  char * const pszUTF8Field =
+                      CPLRecode( pszFieldVal, pszSHPEncoding, CPL_ENC_UTF8);
+                  poBatch->SetFieldString( iField, pszUTF8Field,
+                                           strlen(pszUTF8Field) );
+                  CPLFree( pszUTF8Field );
               }
               else
               {
-                  const int nFullDate = atoi(pszDateValue);
-                  sFld.Date.Year = static_cast<GInt16>(nFullDate / 10000);
-                  sFld.Date.Month = static_cast<GByte>((nFullDate / 100) % 100);
-                  sFld.Date.Day = static_cast<GByte>(nFullDate % 100);
+                  poBatch->SetFieldString( iField, pszFieldVal,
+                                           strlen(pszFieldVal) );
               }
+              break;
+          }
 
-              poFeature->SetField( iField, &sFld );
+          // Numeric values are parsed like OGRFeature::SetField() does,
+          // but without the warnings for incompletely parsed values.
+          case OFTInteger:
+          {
+              const long nVal = strtol( pszFieldVal, NULL, 10 );
+              poBatch->SetFieldInteger( iField,
+                  nVal > INT_MAX ? INT_MAX :
+                  nVal < INT_MIN ? INT_MIN : static_cast<int>(nVal) );
+              break;
+          }
+
+          case OFTInteger64:
+              poBatch->SetFieldInteger64( iField,
+                                          CPLAtoGIntBig( pszFieldVal ) );
+              break;
+
+          case OFTReal:
+              poBatch->SetFieldDouble( iField, CPLStrtod( pszFieldVal, NULL ) );
+              break;
+
+          case OFTDate:
+          {
+              // See SHPReadOGRFeature() for empty dates.
+              if( pszFieldVal[0] == '\0' )
+                  break;
+              OGRField sFld;
+              SHPParseDBFDate( pszFieldVal, &sFld );
+              poBatch->SetFieldRaw( iField, &sFld );
+              break;
           }
-          break;
 
           default:
             CPLAssert( false );
         }
     }
 
-    if( poFeature != NULL )
-        poFeature->SetFID( iShape );
-
-    return poFeature;
+    return eErr;
 }
 
 /************************************************************************/
@@ -205,7 +205,7 @@ class CPL_DLL CPLLockHolder
 #define CTLS_ERRORCONTEXT                5         /* cpl_error.cpp */
 #define CTLS_GDALDATASET_REC_PROTECT_MAP 6        /* gdaldataset.cpp */
 #define CTLS_PATHBUF                     7         /* cpl_path.cpp */
-#define CTLS_UNUSED3                     8
+#define CTLS_OGRGEOSCONTEXT              8         /* ogrgeometry.cpp */
 #define CTLS_UNUSED4                     9
 #define CTLS_CPLSPRINTF                 10         /* cpl_string.h */
 #define CTLS_RESPONSIBLEPID             11         /* gdaldataset.cpp */
@@ -214,6 +214,7 @@ class CPL_DLL CPLLockHolder
 #define CTLS_CONFIGOPTIONS              14         /* cpl_conv.cpp */
 #define CTLS_FINDFILE                   15         /* cpl_findfile.cpp */
 #define CTLS_VSIERRORCONTEXT            16         /* cpl_vsi_error.cpp */
+#define CTLS_WARPCHUNKCONTEXT           17         /* gdalwarpoperation.cpp */
 
 #define CTLS_MAX                        32
 
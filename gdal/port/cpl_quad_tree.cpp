@@ -301,6 +301,92 @@ void CPLQuadTreeInsertWithBounds(CPLQuadTree *hQuadTree,
     CPLQuadTreeAddFeatureInternal(hQuadTree, hFeature, psBounds);
 }
 
+/************************************************************************/
+/*                      CPLQuadTreeNodeRemove()                         */
+/************************************************************************/
+
+static bool CPLQuadTreeNodeRemove( CPLQuadTree *hQuadTree,
+                                   QuadTreeNode *psNode,
+                                   void* hFeature,
+                                   const CPLRectObj* pRect )
+{
+    for( int i = 0; i < psNode->nFeatures; i++ )
+    {
+        if( psNode->pahFeatures[i] != hFeature )
+            continue;
+
+        // Order of the features of a node does not matter: move the last
+        // one in the slot of the removed one.
+        psNode->nFeatures--;
+        psNode->pahFeatures[i] = psNode->pahFeatures[psNode->nFeatures];
+        if( psNode->pasBounds != NULL )
+            psNode->pasBounds[i] = psNode->pasBounds[psNode->nFeatures];
+        if( psNode->nFeatures == 0 )
+        {
+            CPLFree(psNode->pahFeatures);
+            CPLFree(psNode->pasBounds);
+            psNode->pahFeatures = NULL;
+            psNode->pasBounds = NULL;
+        }
+        return true;
+    }
+
+    // The feature has been inserted in a subnode containing its bounds.
+    for( int i = 0; i < psNode->nNumSubNodes; i++ )
+    {
+        if( CPL_RectContained(pRect, &psNode->apSubNode[i]->rect) &&
+            CPLQuadTreeNodeRemove(hQuadTree, psNode->apSubNode[i],
+                                  hFeature, pRect) )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/************************************************************************/
+/*                         CPLQuadTreeRemove()                          */
+/************************************************************************/
+
+/**
+ * Remove a feature from a quadtree.
+ *
+ * @param hQuadTree the quad tree
+ * @param hFeature the feature to remove
+ * @param psBounds bounds of the feature, as they were when it was inserted
+ *                 (NULL if the quad tree has been created with a
+ *                 pfnGetBounds function)
+ *
+ * @return TRUE if the feature has been found and removed
+ *
+ * @since GDAL 2.3
+ */
+int CPLQuadTreeRemove( CPLQuadTree *hQuadTree,
+                       void* hFeature,
+                       const CPLRectObj* psBounds )
+{
+    CPLRectObj bounds;
+    if( psBounds == NULL )
+    {
+        if( hQuadTree->pfnGetBounds == NULL )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "hQuadTree->pfnGetBounds == NULL");
+            return FALSE;
+        }
+        hQuadTree->pfnGetBounds(hFeature, &bounds);
+        psBounds = &bounds;
+    }
+
+    if( !CPLQuadTreeNodeRemove(hQuadTree, hQuadTree->psRoot,
+                               hFeature, psBounds) )
+        return FALSE;
+
+    hQuadTree->nFeatures--;
+    return TRUE;
+}
+
 /************************************************************************/
 /*                    CPLQuadTreeNodeDestroy()                          */
 /************************************************************************/
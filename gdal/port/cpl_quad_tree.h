@@ -85,6 +85,9 @@ void        CPL_DLL   CPLQuadTreeInsert(CPLQuadTree *hQuadtree,
 void        CPL_DLL   CPLQuadTreeInsertWithBounds(CPLQuadTree *hQuadtree,
                                                   void* hFeature,
                                                   const CPLRectObj* psBounds);
+int         CPL_DLL   CPLQuadTreeRemove(CPLQuadTree *hQuadtree,
+                                        void* hFeature,
+                                        const CPLRectObj* psBounds);
 
 void        CPL_DLL **CPLQuadTreeSearch(const CPLQuadTree *hQuadtree,
                                         const CPLRectObj* pAoi,
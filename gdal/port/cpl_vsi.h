@@ -317,6 +317,8 @@ void CPL_DLL VSIInstallSparseFileHandler(void);
 void VSIInstallTarFileHandler(void); /* No reason to export that */
 void CPL_DLL VSIInstallCryptFileHandler(void);
 void CPL_DLL VSISetCryptKey(const GByte* pabyKey, int nKeySize);
+void CPL_DLL VSICurlGetCacheStatistics( GIntBig* pnHits, GIntBig* pnMisses,
+                                        GIntBig* pnCachedBytes );
 /*! @cond Doxygen_Suppress */
 void CPL_DLL VSICleanupFileManager(void);
 /*! @endcond */
@@ -39,6 +39,7 @@
 #include "cpl_time.h"
 #include "cpl_vsi.h"
 #include "cpl_vsi_virtual.h"
+#include "cpl_worker_thread_pool.h"
 #include "cpl_http.h"
 
 CPL_CVSID("$Id$");
@@ -76,6 +77,21 @@ int VSICurlUninstallReadCbk( VSILFILE* /* fp */ )
     return FALSE;
 }
 
+/************************************************************************/
+/*                     VSICurlGetCacheStatistics()                      */
+/************************************************************************/
+
+void VSICurlGetCacheStatistics( GIntBig* pnHits, GIntBig* pnMisses,
+                                GIntBig* pnCachedBytes )
+{
+    if( pnHits )
+        *pnHits = 0;
+    if( pnMisses )
+        *pnMisses = 0;
+    if( pnCachedBytes )
+        *pnCachedBytes = 0;
+}
+
 #else
 
 //! @cond Doxygen_Suppress
@@ -85,12 +101,16 @@ int VSICurlUninstallReadCbk( VSILFILE* /* fp */ )
 
 void VSICurlSetOptions(CURL* hCurlHandle, const char* pszURL);
 
+#include <limits>
 #include <map>
 
 #define ENABLE_DEBUG 1
 
-static const int N_MAX_REGIONS = 1000;
 static const int DOWNLOAD_CHUNK_SIZE = 16384;
+// Default size, in bytes, of the region cache shared by all handlers.
+static const size_t DEFAULT_REGION_CACHE_SIZE = 16384000;
+// Maximum number of blocks that the sequential read heuristics request.
+static const int N_MAX_READAHEAD_BLOCKS = 128;
 
 namespace {
 
@@ -130,12 +150,16 @@ typedef struct
     char**          papszFileList; /* only file name without path */
 } CachedDirList;
 
-typedef struct
+typedef struct _CachedRegion
 {
     unsigned long   pszURLHash;
     vsi_l_offset    nFileOffsetStart;
     size_t          nSize;
     char           *pData;
+
+    // Neighbours in the LRU list of VSICurlRegionCache.
+    struct _CachedRegion *psPrev;
+    struct _CachedRegion *psNext;
 } CachedRegion;
 
 typedef struct
@@ -160,6 +184,276 @@ typedef struct
     bool                bInterrupted;
 } WriteFuncStruct;
 
+/************************************************************************/
+/*                         VSICurlRegionCache                           */
+/************************************************************************/
+
+// Least recently used cache of the downloaded regions, shared by all the
+// /vsicurl/ based file system handlers of the process. Its size is bounded
+// by the CPL_VSIL_CURL_CACHE_SIZE configuration option (in bytes). All
+// methods must be called with hRegionCacheMutex held, and the regions they
+// return may be freed as soon as it is released.
+class VSICurlRegionCache
+{
+    CPLHashSet     *hSet;
+    CachedRegion   *psMostRecent;
+    CachedRegion   *psLeastRecent;
+    size_t          nCachedBytes;
+    size_t          nMaxCachedBytes;
+    GIntBig         nHits;
+    GIntBig         nMisses;
+
+    void            RemoveFromList( CachedRegion* psRegion );
+    void            InsertInFrontOfList( CachedRegion* psRegion );
+    void            UpdateMaxCachedBytes();
+
+  public:
+                    VSICurlRegionCache();
+                   ~VSICurlRegionCache();
+
+    size_t          GetMaxCachedBytes()
+                        { UpdateMaxCachedBytes(); return nMaxCachedBytes; }
+
+    const CachedRegion* Get( unsigned long nURLHash,
+                             vsi_l_offset nFileOffsetStart );
+    void            CountAccess( bool bHit );
+    void            Add( unsigned long nURLHash,
+                         vsi_l_offset nFileOffsetStart,
+                         size_t nSize,
+                         const char *pData,
+                         CachedRegion** ppsRegion );
+
+    void            GetStatistics( GIntBig* pnHits, GIntBig* pnMisses,
+                                   GIntBig* pnCachedBytes ) const;
+};
+
+static CPLMutex *hRegionCacheMutex = NULL;
+static VSICurlRegionCache *poRegionCache = NULL;
+static int nRegionCacheRefCount = 0;
+
+/************************************************************************/
+/*                        VSICurlRegionHash()                           */
+/************************************************************************/
+
+static unsigned long VSICurlRegionHash( const void* elt )
+{
+    const CachedRegion* psRegion = static_cast<const CachedRegion *>(elt);
+    return psRegion->pszURLHash ^
+           (static_cast<unsigned long>(
+                psRegion->nFileOffsetStart / DOWNLOAD_CHUNK_SIZE) *
+            2654435761UL);
+}
+
+/************************************************************************/
+/*                        VSICurlRegionEqual()                          */
+/************************************************************************/
+
+static int VSICurlRegionEqual( const void* elt1, const void* elt2 )
+{
+    const CachedRegion* psRegion1 = static_cast<const CachedRegion *>(elt1);
+    const CachedRegion* psRegion2 = static_cast<const CachedRegion *>(elt2);
+    return psRegion1->pszURLHash == psRegion2->pszURLHash &&
+           psRegion1->nFileOffsetStart == psRegion2->nFileOffsetStart;
+}
+
+/************************************************************************/
+/*                        VSICurlRegionCache()                          */
+/************************************************************************/
+
+VSICurlRegionCache::VSICurlRegionCache() :
+    hSet(CPLHashSetNew(VSICurlRegionHash, VSICurlRegionEqual, NULL)),
+    psMostRecent(NULL),
+    psLeastRecent(NULL),
+    nCachedBytes(0),
+    nMaxCachedBytes(DEFAULT_REGION_CACHE_SIZE),
+    nHits(0),
+    nMisses(0)
+{
+    UpdateMaxCachedBytes();
+}
+
+/************************************************************************/
+/*                       UpdateMaxCachedBytes()                         */
+/************************************************************************/
+
+// The CPL_VSIL_CURL_CACHE_SIZE configuration option is read again before
+// the cache grows, so that it can be changed after the handlers have been
+// installed.
+void VSICurlRegionCache::UpdateMaxCachedBytes()
+{
+    nMaxCachedBytes = DEFAULT_REGION_CACHE_SIZE;
+    const char* pszCacheSize =
+        CPLGetConfigOption("CPL_VSIL_CURL_CACHE_SIZE", NULL);
+    if( pszCacheSize != NULL )
+    {
+        const GUIntBig nCacheSize =
+            CPLScanUIntBig(pszCacheSize,
+                           static_cast<int>(strlen(pszCacheSize)));
+        // Keep room for at least a few regions.
+        const size_t nMinCacheSize =
+            4 * (sizeof(CachedRegion) + DOWNLOAD_CHUNK_SIZE);
+        if( nCacheSize < nMinCacheSize )
+            nMaxCachedBytes = nMinCacheSize;
+        else if( nCacheSize > static_cast<GUIntBig>(
+                                    std::numeric_limits<size_t>::max()) )
+            nMaxCachedBytes = std::numeric_limits<size_t>::max();
+        else
+            nMaxCachedBytes = static_cast<size_t>(nCacheSize);
+    }
+}
+
+/************************************************************************/
+/*                       ~VSICurlRegionCache()                          */
+/************************************************************************/
+
+VSICurlRegionCache::~VSICurlRegionCache()
+{
+    if( nHits + nMisses > 0 )
+    {
+        CPLDebug("VSICURL", "Region cache: " CPL_FRMT_GIB " hits, "
+                 CPL_FRMT_GIB " misses",
+                 nHits, nMisses);
+    }
+
+    CachedRegion* psRegion = psMostRecent;
+    while( psRegion != NULL )
+    {
+        CachedRegion* psNext = psRegion->psNext;
+        CPLFree(psRegion->pData);
+        CPLFree(psRegion);
+        psRegion = psNext;
+    }
+    CPLHashSetDestroy(hSet);
+}
+
+/************************************************************************/
+/*                          RemoveFromList()                            */
+/************************************************************************/
+
+void VSICurlRegionCache::RemoveFromList( CachedRegion* psRegion )
+{
+    if( psRegion->psPrev )
+        psRegion->psPrev->psNext = psRegion->psNext;
+    else
+        psMostRecent = psRegion->psNext;
+    if( psRegion->psNext )
+        psRegion->psNext->psPrev = psRegion->psPrev;
+    else
+        psLeastRecent = psRegion->psPrev;
+    psRegion->psPrev = NULL;
+    psRegion->psNext = NULL;
+}
+
+/************************************************************************/
+/*                        InsertInFrontOfList()                         */
+/************************************************************************/
+
+void VSICurlRegionCache::InsertInFrontOfList( CachedRegion* psRegion )
+{
+    psRegion->psPrev = NULL;
+    psRegion->psNext = psMostRecent;
+    if( psMostRecent )
+        psMostRecent->psPrev = psRegion;
+    else
+        psLeastRecent = psRegion;
+    psMostRecent = psRegion;
+}
+
+/************************************************************************/
+/*                                Get()                                 */
+/************************************************************************/
+
+const CachedRegion*
+VSICurlRegionCache::Get( unsigned long nURLHash,
+                         vsi_l_offset nFileOffsetStart )
+{
+    CachedRegion sKey;
+    sKey.pszURLHash = nURLHash;
+    sKey.nFileOffsetStart = nFileOffsetStart;
+
+    CachedRegion* psRegion =
+        static_cast<CachedRegion *>(CPLHashSetLookup(hSet, &sKey));
+    if( psRegion != NULL && psRegion != psMostRecent )
+    {
+        RemoveFromList(psRegion);
+        InsertInFrontOfList(psRegion);
+    }
+    return psRegion;
+}
+
+/************************************************************************/
+/*                            CountAccess()                             */
+/************************************************************************/
+
+void VSICurlRegionCache::CountAccess( bool bHit )
+{
+    if( bHit )
+        nHits++;
+    else
+        nMisses++;
+}
+
+/************************************************************************/
+/*                                Add()                                 */
+/************************************************************************/
+
+// Insert a region, evicting the least recently used ones if needed. If the
+// region is already cached, for example because it has been downloaded by
+// another handle meanwhile, the existing one is kept. *ppsRegion is set to
+// a newly allocated region, or NULL in that case.
+void VSICurlRegionCache::Add( unsigned long nURLHash,
+                              vsi_l_offset nFileOffsetStart,
+                              size_t nSize,
+                              const char *pData,
+                              CachedRegion** ppsRegion )
+{
+    *ppsRegion = NULL;
+    if( Get(nURLHash, nFileOffsetStart) != NULL )
+        return;
+
+    UpdateMaxCachedBytes();
+    const size_t nRegionBytes = sizeof(CachedRegion) + nSize;
+    while( psLeastRecent != NULL &&
+           nCachedBytes + nRegionBytes > nMaxCachedBytes )
+    {
+        CachedRegion* psEvicted = psLeastRecent;
+        RemoveFromList(psEvicted);
+        CPLHashSetRemoveDeferRehash(hSet, psEvicted);
+        nCachedBytes -= sizeof(CachedRegion) + psEvicted->nSize;
+        CPLFree(psEvicted->pData);
+        CPLFree(psEvicted);
+    }
+
+    CachedRegion* psRegion =
+        static_cast<CachedRegion *>(CPLMalloc(sizeof(CachedRegion)));
+    psRegion->pszURLHash = nURLHash;
+    psRegion->nFileOffsetStart = nFileOffsetStart;
+    psRegion->nSize = nSize;
+    psRegion->pData = nSize ? static_cast<char *>(CPLMalloc(nSize)) : NULL;
+    if( nSize )
+        memcpy(psRegion->pData, pData, nSize);
+
+    CPLHashSetInsert(hSet, psRegion);
+    InsertInFrontOfList(psRegion);
+    nCachedBytes += nRegionBytes;
+    *ppsRegion = psRegion;
+}
+
+/************************************************************************/
+/*                           GetStatistics()                            */
+/************************************************************************/
+
+void VSICurlRegionCache::GetStatistics( GIntBig* pnHits, GIntBig* pnMisses,
+                                        GIntBig* pnCachedBytes ) const
+{
+    if( pnHits )
+        *pnHits = nHits;
+    if( pnMisses )
+        *pnMisses = nMisses;
+    if( pnCachedBytes )
+        *pnCachedBytes = static_cast<GIntBig>(nCachedBytes);
+}
+
 static const char* VSICurlGetCacheFileName()
 {
     return "gdal_vsicurl_cache.bin";
@@ -249,9 +543,6 @@ class VSICurlHandle;
 
 class VSICurlFilesystemHandler : public VSIFilesystemHandler
 {
-    CachedRegion  **papsRegions;
-    int             nRegions;
-
     std::map<CPLString, CachedFileProp*>   cacheFileSize;
     std::map<CPLString, CachedDirList*>        cacheDirList;
 
@@ -303,8 +594,18 @@ public:
                                       bool* pbGotFileList );
             void     InvalidateDirContent( const char *pszDirname );
 
-    const CachedRegion* GetRegion( const char* pszURL,
-                                   vsi_l_offset nFileOffsetStart );
+    const CachedRegion* FindRegion( const char* pszURL,
+                                    vsi_l_offset nFileOffsetStart,
+                                    bool bCountAccess );
+    bool                IsRegionCached( const char* pszURL,
+                                        vsi_l_offset nFileOffsetStart );
+    bool                CopyRegion( const char* pszURL,
+                                    vsi_l_offset nOffset,
+                                    void* pBuffer, size_t nMaxSize,
+                                    bool bCountAccess,
+                                    size_t* pnCopied,
+                                    size_t* pnRegionSize );
+    int                 GetMaxBlocksToDownload();
 
     void                AddRegion( const char* pszURL,
                                    vsi_l_offset nFileOffsetStart,
@@ -1341,10 +1642,17 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
 #endif
 
     vsi_l_offset iterOffset = curOffset;
+    // Number of times a downloaded region has been evicted by other threads
+    // before it could be read.
+    int nEvictedRetries = 0;
     while( nBufferRequestSize )
     {
-        const CachedRegion* psRegion = poFS->GetRegion(pszURL, iterOffset);
-        if( psRegion == NULL )
+        size_t nCopied = 0;
+        size_t nRegionSize = 0;
+        bool bCached =
+            poFS->CopyRegion(pszURL, iterOffset, pBuffer, nBufferRequestSize,
+                             true, &nCopied, &nRegionSize);
+        if( !bCached )
         {
             const vsi_l_offset nOffsetToDownload =
                 (iterOffset / DOWNLOAD_CHUNK_SIZE) * DOWNLOAD_CHUNK_SIZE;
@@ -1355,8 +1663,10 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
                 // heuristic that we will read the file sequentially, so
                 // we double the requested size to decrease the number of
                 // client/server roundtrips.
-                if( nBlocksToDownload < 100 )
-                    nBlocksToDownload *= 2;
+                if( nBlocksToDownload < N_MAX_READAHEAD_BLOCKS )
+                    nBlocksToDownload =
+                        std::min(2 * nBlocksToDownload,
+                                 N_MAX_READAHEAD_BLOCKS);
             }
             else
             {
@@ -1380,17 +1690,19 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
             // Avoid reading already cached data.
             for( int i = 1; i < nBlocksToDownload; i++ )
             {
-                if( poFS->GetRegion(
+                if( poFS->IsRegionCached(
                         pszURL,
-                        nOffsetToDownload + i * DOWNLOAD_CHUNK_SIZE) != NULL )
+                        nOffsetToDownload + i * DOWNLOAD_CHUNK_SIZE) )
                 {
                     nBlocksToDownload = i;
                     break;
                 }
             }
 
-            if( nBlocksToDownload > N_MAX_REGIONS )
-                nBlocksToDownload = N_MAX_REGIONS;
+            // The rest of a large request is downloaded by next iterations.
+            const int nMaxBlocksToDownload = poFS->GetMaxBlocksToDownload();
+            if( nBlocksToDownload > nMaxBlocksToDownload )
+                nBlocksToDownload = nMaxBlocksToDownload;
 
             if( DownloadRegion(nOffsetToDownload, nBlocksToDownload) == false )
             {
@@ -1398,24 +1710,25 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
                     bEOF = true;
                 return 0;
             }
-            psRegion = poFS->GetRegion(pszURL, iterOffset);
+            bCached =
+                poFS->CopyRegion(pszURL, iterOffset, pBuffer,
+                                 nBufferRequestSize, false,
+                                 &nCopied, &nRegionSize);
+            if( !bCached && nEvictedRetries < 3 )
+            {
+                nEvictedRetries++;
+                continue;
+            }
         }
-        if( psRegion == NULL || psRegion->pData == NULL )
+        if( !bCached || nRegionSize == 0 )
         {
             bEOF = true;
             return 0;
         }
-        const int nToCopy = static_cast<int>(
-            std::min(static_cast<vsi_l_offset>(nBufferRequestSize),
-                     psRegion->nSize -
-                     (iterOffset - psRegion->nFileOffsetStart)));
-        memcpy(pBuffer,
-               psRegion->pData + iterOffset - psRegion->nFileOffsetStart,
-               nToCopy);
-        pBuffer = static_cast<char *>(pBuffer) + nToCopy;
-        iterOffset += nToCopy;
-        nBufferRequestSize -= nToCopy;
-        if( psRegion->nSize != static_cast<size_t>(DOWNLOAD_CHUNK_SIZE) &&
+        pBuffer = static_cast<char *>(pBuffer) + nCopied;
+        iterOffset += nCopied;
+        nBufferRequestSize -= nCopied;
+        if( nRegionSize != static_cast<size_t>(DOWNLOAD_CHUNK_SIZE) &&
             nBufferRequestSize != 0 )
         {
             break;
@@ -1858,10 +2171,12 @@ int       VSICurlHandle::Close()
 VSICurlFilesystemHandler::VSICurlFilesystemHandler()
 {
     hMutex = NULL;
-    papsRegions = NULL;
-    nRegions = 0;
     bUseCacheDisk =
         CPLTestBool(CPLGetConfigOption("CPL_VSIL_CURL_USE_CACHE", "NO"));
+
+    CPLMutexHolder oHolder( &hRegionCacheMutex );
+    if( nRegionCacheRefCount++ == 0 )
+        poRegionCache = new VSICurlRegionCache();
 }
 
 /************************************************************************/
@@ -1870,12 +2185,14 @@ VSICurlFilesystemHandler::VSICurlFilesystemHandler()
 
 VSICurlFilesystemHandler::~VSICurlFilesystemHandler()
 {
-    for( int i=0; i < nRegions; i++ )
     {
-        CPLFree(papsRegions[i]->pData);
-        CPLFree(papsRegions[i]);
+        CPLMutexHolder oHolder( &hRegionCacheMutex );
+        if( --nRegionCacheRefCount == 0 )
+        {
+            delete poRegionCache;
+            poRegionCache = NULL;
+        }
     }
-    CPLFree(papsRegions);
 
     std::map<CPLString, CachedFileProp*>::const_iterator iterCacheFileSize;
 
@@ -1958,6 +2275,8 @@ CURL* VSICurlFilesystemHandler::GetCurlHandleFor(CPLString osURL)
 /*                   GetRegionFromCacheDisk()                           */
 /************************************************************************/
 
+// Must be called with hRegionCacheMutex held, as FindRegion().
+
 const CachedRegion*
 VSICurlFilesystemHandler::GetRegionFromCacheDisk(const char* pszURL,
                                                  vsi_l_offset nFileOffsetStart)
@@ -2003,7 +2322,7 @@ VSICurlFilesystemHandler::GetRegionFromCacheDisk(const char* pszURL,
                     AddRegion(pszURL, nFileOffsetStart, 0, NULL);
                 }
                 CPL_IGNORE_RET_VAL(VSIFCloseL(fp));
-                return GetRegion(pszURL, nFileOffsetStart);
+                return poRegionCache->Get(pszURLHash, nFileOffsetStart);
             }
             else
             {
@@ -2077,34 +2396,79 @@ void VSICurlFilesystemHandler::AddRegionToCacheDisk(CachedRegion* psRegion)
 }
 
 /************************************************************************/
-/*                          GetRegion()                                 */
+/*                            FindRegion()                              */
 /************************************************************************/
 
+// Look up the region containing nFileOffsetStart in the shared cache, and
+// then in the disk cache. Must be called with hRegionCacheMutex held: the
+// returned region may be evicted, and freed, by any other thread as soon as
+// the mutex is released.
 const CachedRegion*
-VSICurlFilesystemHandler::GetRegion( const char* pszURL,
-                                     vsi_l_offset nFileOffsetStart )
+VSICurlFilesystemHandler::FindRegion( const char* pszURL,
+                                      vsi_l_offset nFileOffsetStart,
+                                      bool bCountAccess )
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     const unsigned long pszURLHash = CPLHashSetHashStr(pszURL);
 
     nFileOffsetStart =
         (nFileOffsetStart / DOWNLOAD_CHUNK_SIZE) * DOWNLOAD_CHUNK_SIZE;
 
-    for( int i = 0; i < nRegions; i++ )
+    const CachedRegion* psRegion =
+        poRegionCache->Get(pszURLHash, nFileOffsetStart);
+    if( psRegion == NULL && bUseCacheDisk )
+        psRegion = GetRegionFromCacheDisk(pszURL, nFileOffsetStart);
+    if( bCountAccess )
+        poRegionCache->CountAccess(psRegion != NULL);
+    return psRegion;
+}
+
+/************************************************************************/
+/*                          IsRegionCached()                            */
+/************************************************************************/
+
+bool VSICurlFilesystemHandler::IsRegionCached( const char* pszURL,
+                                               vsi_l_offset nFileOffsetStart )
+{
+    CPLMutexHolder oHolder( &hRegionCacheMutex );
+
+    return FindRegion(pszURL, nFileOffsetStart, false) != NULL;
+}
+
+/************************************************************************/
+/*                            CopyRegion()                              */
+/************************************************************************/
+
+// Copy up to nMaxSize bytes from nOffset, within the cached region that
+// contains it, while the region cannot be evicted. Returns false if the
+// region is not cached. Otherwise *pnRegionSize is set to the size of the
+// region, which is 0 past the end of the file.
+bool VSICurlFilesystemHandler::CopyRegion( const char* pszURL,
+                                           vsi_l_offset nOffset,
+                                           void* pBuffer, size_t nMaxSize,
+                                           bool bCountAccess,
+                                           size_t* pnCopied,
+                                           size_t* pnRegionSize )
+{
+    CPLMutexHolder oHolder( &hRegionCacheMutex );
+
+    *pnCopied = 0;
+    *pnRegionSize = 0;
+    const CachedRegion* psRegion = FindRegion(pszURL, nOffset, bCountAccess);
+    if( psRegion == NULL )
+        return false;
+    if( psRegion->pData == NULL )
+        return true;
+
+    *pnRegionSize = psRegion->nSize;
+    const vsi_l_offset nOffsetInRegion = nOffset - psRegion->nFileOffsetStart;
+    if( nOffsetInRegion < psRegion->nSize )
     {
-        CachedRegion* psRegion = papsRegions[i];
-        if( psRegion->pszURLHash == pszURLHash &&
-            nFileOffsetStart == psRegion->nFileOffsetStart )
-        {
-            memmove(papsRegions + 1, papsRegions, i * sizeof(CachedRegion*));
-            papsRegions[0] = psRegion;
-            return psRegion;
-        }
+        *pnCopied = static_cast<size_t>(
+            std::min(static_cast<vsi_l_offset>(nMaxSize),
+                     psRegion->nSize - nOffsetInRegion));
+        memcpy(pBuffer, psRegion->pData + nOffsetInRegion, *pnCopied);
     }
-    if( bUseCacheDisk )
-        return GetRegionFromCacheDisk(pszURL, nFileOffsetStart);
-    return NULL;
+    return true;
 }
 
 /************************************************************************/
@@ -2116,44 +2480,34 @@ void VSICurlFilesystemHandler::AddRegion( const char* pszURL,
                                           size_t nSize,
                                           const char *pData )
 {
-    CPLMutexHolder oHolder( &hMutex );
+    CPLMutexHolder oHolder( &hRegionCacheMutex );
 
     const unsigned long pszURLHash = CPLHashSetHashStr(pszURL);
 
     CachedRegion* psRegion = NULL;
-    if( nRegions == N_MAX_REGIONS )
-    {
-        psRegion = papsRegions[N_MAX_REGIONS-1];
-        memmove(papsRegions + 1,
-                papsRegions,
-                (N_MAX_REGIONS-1) * sizeof(CachedRegion*));
-        papsRegions[0] = psRegion;
-        CPLFree(psRegion->pData);
-    }
-    else
-    {
-        papsRegions = static_cast<CachedRegion **>(
-            CPLRealloc(papsRegions, (nRegions + 1) * sizeof(CachedRegion*)));
-        if( nRegions )
-            memmove(papsRegions + 1,
-                    papsRegions,
-                    nRegions * sizeof(CachedRegion*));
-        nRegions++;
-        psRegion = static_cast<CachedRegion *>(CPLMalloc(sizeof(CachedRegion)));
-        papsRegions[0] = psRegion;
-    }
+    poRegionCache->Add(pszURLHash, nFileOffsetStart, nSize, pData, &psRegion);
 
-    psRegion->pszURLHash = pszURLHash;
-    psRegion->nFileOffsetStart = nFileOffsetStart;
-    psRegion->nSize = nSize;
-    psRegion->pData = nSize ? static_cast<char *>(CPLMalloc(nSize)) : NULL;
-    if( nSize )
-        memcpy(psRegion->pData, pData, nSize);
-
-    if( bUseCacheDisk )
+    if( psRegion != NULL && bUseCacheDisk )
         AddRegionToCacheDisk(psRegion);
 }
 
+/************************************************************************/
+/*                      GetMaxBlocksToDownload()                        */
+/************************************************************************/
+
+// Regions downloaded by a single request must not take more than a quarter
+// of the shared cache, so that they are not evicted before being read.
+int VSICurlFilesystemHandler::GetMaxBlocksToDownload()
+{
+    CPLMutexHolder oHolder( &hRegionCacheMutex );
+
+    const size_t nMaxBlocks = poRegionCache->GetMaxCachedBytes() / 4 /
+                              (sizeof(CachedRegion) + DOWNLOAD_CHUNK_SIZE);
+    return static_cast<int>(
+        std::max(static_cast<size_t>(1),
+                 std::min(nMaxBlocks, static_cast<size_t>(INT_MAX))));
+}
+
 /************************************************************************/
 /*                         GetCachedFileProp()                          */
 /************************************************************************/
@@ -3494,6 +3848,31 @@ class VSIS3Handle CPL_FINAL : public VSICurlHandle
 /*                            VSIS3WriteHandle                          */
 /************************************************************************/
 
+/************************************************************************/
+/*                         VSIS3UploadPartJob                           */
+/************************************************************************/
+
+// Upload of one part of a multipart upload. The curl handle is fully set up
+// by the thread that owns the VSIS3WriteHandle, so that only the transfer
+// itself, and its retries, may happen in a worker thread.
+struct VSIS3UploadPartJob
+{
+    int                 nPartNumber;
+    GByte              *pabyBuffer;
+    int                 nBufferSize;
+    int                 nBufferOffReadCallback;
+    CURL               *hCurlHandle;
+    struct curl_slist  *psHeaders;
+    int                 nMaxRetry;
+    double              dfRetryDelay;
+    int                 nRetryCount;
+    long                nResponseCode;
+    WriteFuncStruct     sWriteFuncData;
+    WriteFuncStruct     sWriteFuncHeaderData;
+    CPLMutex          **phMutex;
+    bool                bDone;
+};
+
 class VSIS3WriteHandle CPL_FINAL : public VSIVirtualHandle
 {
     VSIS3FSHandler     *m_poFS;
@@ -3512,10 +3891,22 @@ class VSIS3WriteHandle CPL_FINAL : public VSIVirtualHandle
     int                 m_nOffsetInXML;
     bool                m_bError;
 
+    // Concurrent part uploads.
+    int                 m_nMaxConcurrentUploads;
+    int                 m_nMaxRetry;
+    double              m_dfRetryDelay;
+    CPLWorkerThreadPool *m_poUploadPool;
+    CPLMutex           *m_hUploadMutex;
+    std::vector<VSIS3UploadPartJob*> m_apoUploadJobs;
+    std::vector<GByte*> m_apabyFreeBuffers;
+
     static size_t       ReadCallBackBuffer( char *buffer, size_t size,
                                             size_t nitems, void *instream );
     bool                InitiateMultipartUpload();
     bool                UploadPart();
+    VSIS3UploadPartJob *CreateUploadPartJob();
+    bool                FinishUploadPart( VSIS3UploadPartJob* psJob );
+    bool                CollectUploadParts( int nMaxRunningJobs );
     static size_t       ReadCallBackXML( char *buffer, size_t size,
                                          size_t nitems, void *instream );
     bool                CompleteMultipart();
@@ -3555,7 +3946,9 @@ VSIS3WriteHandle::VSIS3WriteHandle( VSIS3FSHandler* poFS,
         m_bClosed(false),
         m_nPartNumber(0),
         m_nOffsetInXML(0),
-        m_bError(false)
+        m_bError(false),
+        m_poUploadPool(NULL),
+        m_hUploadMutex(NULL)
 {
     const int nChunkSizeMB = atoi(CPLGetConfigOption("VSIS3_CHUNK_SIZE", "50"));
     if( nChunkSizeMB <= 0 || nChunkSizeMB > 1000 )
@@ -3568,6 +3961,11 @@ VSIS3WriteHandle::VSIS3WriteHandle( VSIS3FSHandler* poFS,
         CPLError(CE_Failure, CPLE_AppDefined,
                  "Cannot allocate working buffer for /vsis3");
     }
+
+    m_nMaxConcurrentUploads = std::max(1, std::min(64,
+        atoi(CPLGetConfigOption("VSIS3_MAX_CONCURRENT_UPLOADS", "4"))));
+    m_nMaxRetry = atoi(CPLGetConfigOption("GDAL_HTTP_MAX_RETRY", "0"));
+    m_dfRetryDelay = CPLAtof(CPLGetConfigOption("GDAL_HTTP_RETRY_DELAY", "30"));
 }
 
 /************************************************************************/
@@ -3577,8 +3975,13 @@ VSIS3WriteHandle::VSIS3WriteHandle( VSIS3FSHandler* poFS,
 VSIS3WriteHandle::~VSIS3WriteHandle()
 {
     Close();
+    delete m_poUploadPool;
+    if( m_hUploadMutex )
+        CPLDestroyMutex(m_hUploadMutex);
     delete m_poS3HandleHelper;
     CPLFree(m_pabyBuffer);
+    for( size_t i = 0; i < m_apabyFreeBuffers.size(); i++ )
+        CPLFree(m_apabyFreeBuffers[i]);
 }
 
 /************************************************************************/
@@ -3728,27 +4131,86 @@ size_t VSIS3WriteHandle::ReadCallBackBuffer( char *buffer, size_t size,
 }
 
 /************************************************************************/
-/*                           UploadPart()                               */
+/*                       ReadCallBackUploadPart()                       */
 /************************************************************************/
 
-bool VSIS3WriteHandle::UploadPart()
+static size_t ReadCallBackUploadPart( char *buffer, size_t size,
+                                      size_t nitems, void *instream )
 {
-    ++m_nPartNumber;
-    if( m_nPartNumber > 10000 )
+    VSIS3UploadPartJob* psJob = static_cast<VSIS3UploadPartJob *>(instream);
+    const int nSizeMax = static_cast<int>(size * nitems);
+    const int nSizeToWrite =
+        std::min(nSizeMax,
+                 psJob->nBufferSize - psJob->nBufferOffReadCallback);
+    memcpy(buffer, psJob->pabyBuffer + psJob->nBufferOffReadCallback,
+           nSizeToWrite);
+    psJob->nBufferOffReadCallback += nSizeToWrite;
+    return nSizeToWrite;
+}
+
+/************************************************************************/
+/*                        VSIS3UploadPartJobFunc()                      */
+/************************************************************************/
+
+// Run the PUT of a part, retrying it on errors that are likely to be
+// transient. May be called from a worker thread, so no error is emitted
+// here.
+static void VSIS3UploadPartJobFunc( void* pData )
+{
+    VSIS3UploadPartJob* psJob = static_cast<VSIS3UploadPartJob *>(pData);
+
+    while( true )
     {
-        m_bError = true;
-        CPLError(
-            CE_Failure, CPLE_AppDefined,
-            "10000 parts have been uploaded for %s failed. "
-            "This is the maximum. "
-            "Increase VSIS3_CHUNK_SIZE to a higher value (e.g. 500 for 500 MB)",
-            m_osFilename.c_str());
-        return false;
+        psJob->nBufferOffReadCallback = 0;
+        CPLFree(psJob->sWriteFuncData.pBuffer);
+        CPLFree(psJob->sWriteFuncHeaderData.pBuffer);
+        VSICURLInitWriteFuncStruct(&psJob->sWriteFuncData, NULL, NULL, NULL);
+        VSICURLInitWriteFuncStruct(&psJob->sWriteFuncHeaderData,
+                                   NULL, NULL, NULL);
+
+        curl_easy_perform(psJob->hCurlHandle);
+
+        psJob->nResponseCode = 0;
+        curl_easy_getinfo(psJob->hCurlHandle, CURLINFO_HTTP_CODE,
+                          &psJob->nResponseCode);
+
+        // Same as CPLHTTPFetch(), plus 500 that S3 documents as to be
+        // retried.
+        const bool bRetriable = psJob->nResponseCode == 500 ||
+                                psJob->nResponseCode == 502 ||
+                                psJob->nResponseCode == 503 ||
+                                psJob->nResponseCode == 504;
+        if( !bRetriable || psJob->nRetryCount >= psJob->nMaxRetry )
+            break;
+        psJob->nRetryCount++;
+        CPLSleep(psJob->dfRetryDelay);
     }
 
-    bool bSuccess = true;
+    CPLMutexHolderD(psJob->phMutex);
+    psJob->bDone = true;
+}
+
+/************************************************************************/
+/*                        CreateUploadPartJob()                         */
+/************************************************************************/
+
+// Set up the upload of the current buffer as part m_nPartNumber.
+VSIS3UploadPartJob* VSIS3WriteHandle::CreateUploadPartJob()
+{
+    VSIS3UploadPartJob* psJob = new VSIS3UploadPartJob;
+    psJob->nPartNumber = m_nPartNumber;
+    psJob->pabyBuffer = m_pabyBuffer;
+    psJob->nBufferSize = m_nBufferOff;
+    psJob->nBufferOffReadCallback = 0;
+    psJob->nMaxRetry = m_nMaxRetry;
+    psJob->dfRetryDelay = m_dfRetryDelay;
+    psJob->nRetryCount = 0;
+    psJob->nResponseCode = 0;
+    VSICURLInitWriteFuncStruct(&psJob->sWriteFuncData, NULL, NULL, NULL);
+    VSICURLInitWriteFuncStruct(&psJob->sWriteFuncHeaderData, NULL, NULL, NULL);
+    psJob->phMutex = &m_hUploadMutex;
+    psJob->bDone = false;
 
-    m_nBufferOffReadCallback = 0;
     CURL* hCurlHandle = curl_easy_init();
     m_poS3HandleHelper->AddQueryParameter("partNumber",
                                           CPLSPrintf("%d", m_nPartNumber));
@@ -3757,47 +4219,62 @@ bool VSIS3WriteHandle::UploadPart()
                      m_poS3HandleHelper->GetURL().c_str());
     CPLHTTPSetOptions(hCurlHandle, NULL);
     curl_easy_setopt(hCurlHandle, CURLOPT_UPLOAD, 1L);
-    curl_easy_setopt(hCurlHandle, CURLOPT_READFUNCTION, ReadCallBackBuffer);
-    curl_easy_setopt(hCurlHandle, CURLOPT_READDATA, this);
+    curl_easy_setopt(hCurlHandle, CURLOPT_READFUNCTION,
+                     ReadCallBackUploadPart);
+    curl_easy_setopt(hCurlHandle, CURLOPT_READDATA, psJob);
     curl_easy_setopt(hCurlHandle, CURLOPT_INFILESIZE, m_nBufferOff);
 
-    struct curl_slist* headers =
+    psJob->psHeaders =
         m_poS3HandleHelper->GetCurlHeaders("PUT",
                                            m_pabyBuffer,
                                            m_nBufferOff);
-    curl_easy_setopt(hCurlHandle, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(hCurlHandle, CURLOPT_HTTPHEADER, psJob->psHeaders);
 
     m_poS3HandleHelper->ResetQueryParameters();
 
-    WriteFuncStruct sWriteFuncData;
-    VSICURLInitWriteFuncStruct(&sWriteFuncData, NULL, NULL, NULL);
-    curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA, &sWriteFuncData);
+    curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA, &psJob->sWriteFuncData);
     curl_easy_setopt(hCurlHandle, CURLOPT_WRITEFUNCTION,
                      VSICurlHandleWriteFunc);
-
-    WriteFuncStruct sWriteFuncHeaderData;
-    VSICURLInitWriteFuncStruct(&sWriteFuncHeaderData, NULL, NULL, NULL);
-    curl_easy_setopt(hCurlHandle, CURLOPT_HEADERDATA, &sWriteFuncHeaderData);
+    curl_easy_setopt(hCurlHandle, CURLOPT_HEADERDATA,
+                     &psJob->sWriteFuncHeaderData);
     curl_easy_setopt(hCurlHandle, CURLOPT_HEADERFUNCTION,
                      VSICurlHandleWriteFunc);
 
-    curl_easy_perform(hCurlHandle);
+    psJob->hCurlHandle = hCurlHandle;
+    return psJob;
+}
 
-    curl_slist_free_all(headers);
+/************************************************************************/
+/*                          FinishUploadPart()                          */
+/************************************************************************/
 
-    long response_code = 0;
-    curl_easy_getinfo(hCurlHandle, CURLINFO_HTTP_CODE, &response_code);
-    if( response_code != 200 || sWriteFuncHeaderData.pBuffer == NULL )
+// Record the ETag of an uploaded part, or report its failure, and release
+// the resources of the job, except its buffer.
+bool VSIS3WriteHandle::FinishUploadPart( VSIS3UploadPartJob* psJob )
+{
+    bool bSuccess = true;
+
+    if( psJob->nRetryCount > 0 )
+    {
+        CPLDebug("S3", "UploadPart(%d) of %s was retried %d time(s)",
+                 psJob->nPartNumber, m_osFilename.c_str(),
+                 psJob->nRetryCount);
+    }
+
+    if( psJob->nResponseCode != 200 ||
+        psJob->sWriteFuncHeaderData.pBuffer == NULL )
     {
         CPLDebug("S3", "%s",
-                 sWriteFuncData.pBuffer ? sWriteFuncData.pBuffer : "(null)");
+                 psJob->sWriteFuncData.pBuffer
+                 ? psJob->sWriteFuncData.pBuffer : "(null)");
         CPLError(CE_Failure, CPLE_AppDefined, "UploadPart(%d) of %s failed",
-                    m_nPartNumber, m_osFilename.c_str());
+                    psJob->nPartNumber, m_osFilename.c_str());
         bSuccess = false;
     }
     else
     {
-        const char* pszEtag = strstr(sWriteFuncHeaderData.pBuffer, "ETag: ");
+        const char* pszEtag =
+            strstr(psJob->sWriteFuncHeaderData.pBuffer, "ETag: ");
         if( pszEtag != NULL )
         {
             CPLString osEtag = pszEtag + strlen("ETag: ");
@@ -3805,26 +4282,146 @@ bool VSIS3WriteHandle::UploadPart()
             if( nPos != std::string::npos )
                 osEtag.resize(nPos);
             CPLDebug("S3", "Etag for part %d is %s",
-                     m_nPartNumber, osEtag.c_str());
-            m_aosEtags.push_back(osEtag);
+                     psJob->nPartNumber, osEtag.c_str());
+            // Parts may complete out of order.
+            if( m_aosEtags.size() < static_cast<size_t>(psJob->nPartNumber) )
+                m_aosEtags.resize(psJob->nPartNumber);
+            m_aosEtags[psJob->nPartNumber - 1] = osEtag;
         }
         else
         {
             CPLError(CE_Failure, CPLE_AppDefined,
                      "UploadPart(%d) of %s (uploadId = %s) failed",
-                     m_nPartNumber, m_osFilename.c_str(), m_osUploadID.c_str());
+                     psJob->nPartNumber, m_osFilename.c_str(),
+                     m_osUploadID.c_str());
             bSuccess = false;
         }
     }
 
-    CPLFree(sWriteFuncData.pBuffer);
-    CPLFree(sWriteFuncHeaderData.pBuffer);
+    CPLFree(psJob->sWriteFuncData.pBuffer);
+    CPLFree(psJob->sWriteFuncHeaderData.pBuffer);
+    curl_slist_free_all(psJob->psHeaders);
+    curl_easy_cleanup(psJob->hCurlHandle);
 
-    curl_easy_cleanup(hCurlHandle);
+    return bSuccess;
+}
 
+/************************************************************************/
+/*                         CollectUploadParts()                         */
+/************************************************************************/
+
+// Wait until at most nMaxRunningJobs part uploads are running, and finish
+// the completed ones, recycling their buffers.
+bool VSIS3WriteHandle::CollectUploadParts( int nMaxRunningJobs )
+{
+    bool bSuccess = true;
+    while( true )
+    {
+        std::vector<VSIS3UploadPartJob*> apoDoneJobs;
+        {
+            CPLMutexHolderD(&m_hUploadMutex);
+            size_t j = 0;
+            for( size_t i = 0; i < m_apoUploadJobs.size(); i++ )
+            {
+                if( m_apoUploadJobs[i]->bDone )
+                    apoDoneJobs.push_back(m_apoUploadJobs[i]);
+                else
+                    m_apoUploadJobs[j++] = m_apoUploadJobs[i];
+            }
+            m_apoUploadJobs.resize(j);
+        }
+
+        for( size_t i = 0; i < apoDoneJobs.size(); i++ )
+        {
+            if( !FinishUploadPart(apoDoneJobs[i]) )
+                bSuccess = false;
+            m_apabyFreeBuffers.push_back(apoDoneJobs[i]->pabyBuffer);
+            delete apoDoneJobs[i];
+        }
+
+        if( static_cast<int>(m_apoUploadJobs.size()) <= nMaxRunningJobs )
+            break;
+        m_poUploadPool->WaitCompletion(nMaxRunningJobs);
+    }
     return bSuccess;
 }
 
+/************************************************************************/
+/*                           UploadPart()                               */
+/************************************************************************/
+
+// Upload the current buffer as the next part. When several uploads may run
+// concurrently, the buffer is handed over to a worker thread and replaced
+// by a free one, and errors may only be reported by a later call.
+bool VSIS3WriteHandle::UploadPart()
+{
+    ++m_nPartNumber;
+    if( m_nPartNumber > 10000 )
+    {
+        m_bError = true;
+        CPLError(
+            CE_Failure, CPLE_AppDefined,
+            "10000 parts have been uploaded for %s failed. "
+            "This is the maximum. "
+            "Increase VSIS3_CHUNK_SIZE to a higher value (e.g. 500 for 500 MB)",
+            m_osFilename.c_str());
+        return false;
+    }
+
+    if( m_nMaxConcurrentUploads > 1 && m_poUploadPool == NULL )
+    {
+        m_poUploadPool = new (std::nothrow) CPLWorkerThreadPool();
+        if( m_poUploadPool == NULL ||
+            !m_poUploadPool->Setup(m_nMaxConcurrentUploads, NULL, NULL) )
+        {
+            delete m_poUploadPool;
+            m_poUploadPool = NULL;
+            m_nMaxConcurrentUploads = 1;
+        }
+    }
+
+    if( m_poUploadPool == NULL )
+    {
+        VSIS3UploadPartJob* psJob = CreateUploadPartJob();
+        VSIS3UploadPartJobFunc(psJob);
+        const bool bSuccess = FinishUploadPart(psJob);
+        delete psJob;
+        return bSuccess;
+    }
+
+    // Bound the number of buffers in flight.
+    bool bSuccess = CollectUploadParts(m_nMaxConcurrentUploads - 1);
+    if( !bSuccess )
+        return false;
+
+    GByte* pabyNextBuffer = NULL;
+    if( !m_apabyFreeBuffers.empty() )
+    {
+        pabyNextBuffer = m_apabyFreeBuffers.back();
+        m_apabyFreeBuffers.pop_back();
+    }
+    else
+    {
+        pabyNextBuffer = static_cast<GByte *>(VSIMalloc(m_nBufferSize));
+        if( pabyNextBuffer == NULL )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate working buffer for /vsis3");
+            return false;
+        }
+    }
+
+    VSIS3UploadPartJob* psJob = CreateUploadPartJob();
+    {
+        CPLMutexHolderD(&m_hUploadMutex);
+        m_apoUploadJobs.push_back(psJob);
+    }
+    m_poUploadPool->SubmitJob(VSIS3UploadPartJobFunc, psJob);
+    m_pabyBuffer = pabyNextBuffer;
+
+    return true;
+}
+
 /************************************************************************/
 /*                               Write()                                */
 /************************************************************************/
@@ -4103,13 +4700,17 @@ int VSIS3WriteHandle::Close()
         }
         else
         {
-            if( m_bError )
+            bool bUploadError = false;
+            if( !m_bError && m_nBufferOff > 0 && !UploadPart() )
+                bUploadError = true;
+            if( m_poUploadPool != NULL && !CollectUploadParts(0) )
+                bUploadError = true;
+
+            if( m_bError || bUploadError )
             {
-                if( !AbortMultipart() )
+                if( !AbortMultipart() || bUploadError )
                     nRet = -1;
             }
-            else if( m_nBufferOff > 0 && !UploadPart() )
-                nRet = -1;
             else if( !CompleteMultipart() )
                 nRet = -1;
         }
@@ -4580,6 +5181,12 @@ void VSICurlSetOptions( CURL* hCurlHandle, const char* pszURL )
  * reading it will progressively increase the chunk size up to 2 MB to improve
  * download performance.
  *
+ * Starting with GDAL 2.3, the downloaded blocks are kept in a least recently
+ * used cache shared by all the /vsicurl/ and /vsis3/ files opened in the
+ * process, instead of a cache per file system. Its size defaults to 16 MB, and
+ * can be set in bytes with the CPL_VSIL_CURL_CACHE_SIZE configuration option.
+ * Hit and miss counts can be queried with VSICurlGetCacheStatistics().
+ *
  * The GDAL_HTTP_PROXY, GDAL_HTTP_PROXYUSERPWD and GDAL_PROXY_AUTH configuration
  * options can be used to define a proxy server. The syntax to use is the one of
  * Curl CURLOPT_PROXY, CURLOPT_PROXYUSERPWD and CURLOPT_PROXYAUTH options.
@@ -4673,6 +5280,14 @@ void VSIInstallCurlFileHandler( void )
  * files smaller than the chunk size, a simple PUT request is used instead of
  * the multipart upload API.
  *
+ * Starting with GDAL 2.3, the parts of a multipart upload are sent by several
+ * threads, while the next part is filled. The number of parts uploaded at the
+ * same time is set with the VSIS3_MAX_CONCURRENT_UPLOADS config option
+ * (defaults to 4, 1 to upload them sequentially). Up to that number plus one
+ * chunks are then kept in memory. A failed part upload is retried according to
+ * the GDAL_HTTP_MAX_RETRY and GDAL_HTTP_RETRY_DELAY config options. Its error
+ * may be reported by a later VSIFWriteL() call or by VSIFCloseL().
+ *
  * VSIStatL() will return the size in st_size member.
  *
  * @since GDAL 2.1
@@ -4682,4 +5297,46 @@ void VSIInstallS3FileHandler( void )
     VSIFileManager::InstallHandler( "/vsis3/", new VSIS3FSHandler );
 }
 
+/************************************************************************/
+/*                     VSICurlGetCacheStatistics()                      */
+/************************************************************************/
+
+/**
+ * \brief Return statistics on the region cache of /vsicurl/ and /vsis3/.
+ *
+ * The regions (16 KB blocks) downloaded by /vsicurl/ and /vsis3/ handles are
+ * kept in a least recently used cache shared by all the handles of the
+ * process. Its size defaults to 16 MB, and can be set in bytes with the
+ * CPL_VSIL_CURL_CACHE_SIZE configuration option, which is taken into account
+ * when new regions are added.
+ *
+ * A hit is counted when a read finds its region in the cache, or in the disk
+ * cache enabled by CPL_VSIL_CURL_USE_CACHE, and a miss when the region has to
+ * be downloaded.
+ *
+ * @param pnHits pointer to the number of hits, or NULL.
+ * @param pnMisses pointer to the number of misses, or NULL.
+ * @param pnCachedBytes pointer to the memory currently used by the cache, or
+ * NULL.
+ *
+ * @since GDAL 2.3
+ */
+void VSICurlGetCacheStatistics( GIntBig* pnHits, GIntBig* pnMisses,
+                                GIntBig* pnCachedBytes )
+{
+    CPLMutexHolder oHolder( &hRegionCacheMutex );
+
+    if( poRegionCache != NULL )
+    {
+        poRegionCache->GetStatistics(pnHits, pnMisses, pnCachedBytes);
+        return;
+    }
+    if( pnHits )
+        *pnHits = 0;
+    if( pnMisses )
+        *pnMisses = 0;
+    if( pnCachedBytes )
+        *pnCachedBytes = 0;
+}
+
 #endif /* HAVE_CURL */
@@ -41,7 +41,7 @@ gdal_proximity.py srcfile dstfile [-srcband n] [-dstband n]
                   [-ot Byte/Int16/Int32/Float32/etc]
                   [-values n,n,n] [-distunits PIXEL/GEO]
                   [-maxdist n] [-nodata n] [-use_input_nodata YES/NO]
-                  [-fixed-buf-val n] [-q] """)
+                  [-fixed-buf-val n] [-distmethod APPROX/EXACT] [-q] """)
     sys.exit(1)
 
 # =============================================================================
@@ -92,6 +92,10 @@ while i < len(argv):
         i = i + 1
         options.append( 'DISTUNITS=' + argv[i] )
 
+    elif arg == '-distmethod':
+        i = i + 1
+        options.append( 'DISTMETHOD=' + argv[i] )
+
     elif arg == '-nodata':
         i = i + 1
         options.append( 'NODATA=' + argv[i] )